@@ -60,13 +60,14 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 		{
 
 		public:
-			KernelBase(const AlgorithmBase* algo, int t) :
+			KernelBase(const AlgorithmBase* algo, int t, double openingAngle) :
 			  ref_cnt(0),
 			  algo_(algo),
 			  numprocessors_(Parallel::NumCores()),
 			  barrier_("BSV KernelBase Barrier", numprocessors_),
 			  typeOut(t),
-			  matOut(0)
+			  matOut(0),
+			  openingAngle_(openingAngle)
 			{
 			}
 			
@@ -106,6 +107,11 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 			DenseMatrix *matOut;
 			MatrixHandle matOutHandle;
 
+			//! treecode opening angle, 0 sums all sources directly
+			double openingAngle_;
+			//! sources grouped for the treecode, only built for a positive opening angle
+			std::unique_ptr<BiotSavartTreecode> tree_;
+
 			bool PreIntegration( FieldHandle& mesh, FieldHandle& coil )
 			{
 					this->vmesh = mesh->vmesh();
@@ -176,7 +182,7 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 		{
 			public:
 			
-				PieceWiseKernel(const AlgorithmBase* algo, int t ) : KernelBase(algo,t)
+				PieceWiseKernel(const AlgorithmBase* algo, int t, double openingAngle) : KernelBase(algo,t,openingAngle)
 				{
 					//we keep last calculated step
 					//however if segments lenght varies,
@@ -224,6 +230,11 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 						coilNodes.push_back(Vector(enode2));
 					}
 
+					if(openingAngle_ > 0.0)
+					{
+						BuildTreecode();
+					}
+
 					//! Start the multi threaded
 					Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 					
@@ -252,6 +263,54 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 
 				//! keep nodes on the coil cached
 				std::vector<Vector> coilNodes;
+
+				//! collect the curve elements of all segments as treecode sources,
+				//! discretized in the same way as in ParallelKernel
+				void BuildTreecode()
+				{
+					std::vector<Point> positions;
+					std::vector<Vector> strengths;
+					double current = 1.0;
+					double prevSegLen = 123456789.12345678;
+					int nips = 0;
+
+					for( size_t iC0 = 0, iC1 = 1, iCV = 0;
+						iC0 < coilNodes.size();
+						iC0+=2, iC1+=2, iCV++)
+					{
+						vcoilField->get_value(current,iCV);
+						current = current == 0.0 ? 1.0 : current;
+
+						Vector coilNodeThis = current >= 0.0 ? coilNodes[iC0] : coilNodes[iC1];
+						Vector coilNodeNext = current >= 0.0 ? coilNodes[iC1] : coilNodes[iC0];
+
+						double newSegLen = (coilNodeNext - coilNodeThis).length();
+						if(extstep > 0)
+						{
+							nips = newSegLen / extstep;
+						}
+						else if( Abs(prevSegLen - newSegLen ) > 0.00000001 )
+						{
+							prevSegLen = newSegLen;
+							nips = AdjustNumberOfIntegrationPoints(newSegLen);
+						}
+
+						if( nips < 3 )
+						{
+							algo_->warning("integration step too big");
+						}
+
+						for(int iip = 0; iip < nips - 1; iip++)
+						{
+							Vector v0 = Interpolate( coilNodeThis, coilNodeNext, static_cast<double>(iip) / static_cast<double>(nips) );
+							Vector v1 = Interpolate( coilNodeThis, coilNodeNext, static_cast<double>(iip+1) / static_cast<double>(nips) );
+							positions.push_back( Point((v0 + v1) / 2) );
+							strengths.push_back( 1.0e-7 * Abs(current) * (v1 - v0) );
+						}
+					}
+
+					tree_.reset(new BiotSavartTreecode(positions, strengths, openingAngle_));
+				}
 				
 				//! execute in parallel
 				void ParallelKernel(int proc_num)
@@ -292,6 +351,12 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 							// result
 							Vector F;
 
+							if(tree_)
+							{
+								//! Biot-Savart Magnetic Field or Magnetic Vector Potential Field
+								F = typeOut == 1 ? tree_->cross_field(modelNode) : tree_->potential(modelNode);
+							}
+							else
 							for( size_t iC0 = 0, iC1 =1, iCV = 0; 
 								iC0 < coilNodes.size(); 
 								iC0+=2, iC1+=2, iCV++)
@@ -454,7 +519,7 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 		{
 			public:
 			
-				VolumetricKernel(const AlgorithmBase* algo, int t) : KernelBase(algo,t)
+				VolumetricKernel(const AlgorithmBase* algo, int t, double openingAngle) : KernelBase(algo,t,openingAngle)
 				{
 				}
 				
@@ -478,6 +543,21 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 					
 					vmesh->synchronize(Mesh::NODES_E | Mesh::EDGES_E);					
 
+					//! the treecode only knows the kernel of the vector potential
+					if(openingAngle_ > 0.0 && typeOut == 2)
+					{
+						std::vector<Point> positions(coilSize);
+						std::vector<Vector> strengths(coilSize);
+						Vector current;
+						for(VMesh::Elem::index_type iC = 0; iC < coilSize; iC++)
+						{
+							vcoilField->get_value(current,iC);
+							vcoilField->get_center(positions[iC], iC);
+							strengths[iC] = current * ( vcoil->get_volume(iC) / (4.0 * M_PI) );
+						}
+						tree_.reset(new BiotSavartTreecode(positions, strengths, openingAngle_));
+					}
+
 					//! Start the multi threaded
 					Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 					
@@ -516,6 +596,12 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 							
 							double Rl;
 
+							if(tree_)
+							{
+								//! Biot-Savart Magnetic Vector Potential Field
+								F = tree_->potential(modelNode);
+							}
+							else
 							for(VMesh::Elem::index_type  iC = 0; iC < coilSize; iC++)
 							{
 								vcoilField->get_value(current,iC);
@@ -582,7 +668,7 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 		{
 			public:
 			
-				DipolesKernel(const AlgorithmBase* algo, int t) : KernelBase(algo,t)
+				DipolesKernel(const AlgorithmBase* algo, int t, double openingAngle) : KernelBase(algo,t,openingAngle)
 				{
 				}
 				
@@ -605,7 +691,22 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 					
 					//needed?
 					vmesh->synchronize(Mesh::NODES_E | Mesh::EDGES_E);
-										
+
+					//! the treecode only knows the kernel of the vector potential
+					if(openingAngle_ > 0.0 && typeOut == 2)
+					{
+						std::vector<Point> positions(coilSize);
+						std::vector<Vector> strengths(coilSize);
+						Vector dipoleMoment;
+						for(VMesh::Elem::index_type iC = 0; iC < coilSize; iC++)
+						{
+							vcoilField->get_value(dipoleMoment,iC);
+							vcoilField->get_center(positions[iC], iC);
+							//! m x (x - y) = -m x (y - x)
+							strengths[iC] = -1.0e-7 * dipoleMoment;
+						}
+						tree_.reset(new BiotSavartTreecode(positions, strengths, openingAngle_));
+					}
 
 					//! Start the multi threaded
 					Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
@@ -644,6 +745,12 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 							
 							double Rl;
 
+							if(tree_)
+							{
+								//! Biot-Savart Magnetic Vector Potential Field
+								F = tree_->cross_field(modelNode);
+							}
+							else
 							for(VMesh::Elem::index_type  iC = 0; iC < coilSize; iC++)
 							{
 								vcoilField->get_value(dipoleMoment,iC);
@@ -722,11 +829,13 @@ bool BiotSavartSolverAlgorithm::run(FieldHandle mesh, FieldHandle coil, MatrixHa
    return (false);
   }
 	  
+  const double openingAngle = get(Parameters::TreecodeOpeningAngle).toDouble();
+
   if( coil->vmesh()->is_curvemesh() )
   {
     if(coil->vfield()->is_constantdata() && coil->vfield()->is_scalar())
     {
-      auto pwk = std::unique_ptr<KernelBase>(new PieceWiseKernel(this, outtype));
+      auto pwk = std::unique_ptr<KernelBase>(new PieceWiseKernel(this, outtype, openingAngle));
       //pwk->SetIntegrationStep(this->istep);
       if( !pwk->Integrate(mesh,coil,outdata) )
       {
@@ -744,7 +853,7 @@ bool BiotSavartSolverAlgorithm::run(FieldHandle mesh, FieldHandle coil, MatrixHa
   {
    if((coil->vfield()->is_lineardata() || coil->vfield()->is_constantdata() ) && coil->vfield()->is_vector())
    {
-    auto dp = std::unique_ptr<KernelBase>(new DipolesKernel(this, outtype));
+    auto dp = std::unique_ptr<KernelBase>(new DipolesKernel(this, outtype, openingAngle));
     if( !dp->Integrate(mesh,coil,outdata) )
       {
        error("Aborted during integration");
@@ -761,7 +870,7 @@ bool BiotSavartSolverAlgorithm::run(FieldHandle mesh, FieldHandle coil, MatrixHa
   {
    if(  coil->vfield()->is_constantdata() && coil->vfield()->is_vector() )
    {
-   auto vp = std::unique_ptr<KernelBase>(new VolumetricKernel(this, outtype));
+   auto vp = std::unique_ptr<KernelBase>(new VolumetricKernel(this, outtype, openingAngle));
    if( !vp->Integrate(mesh,coil,outdata) )
       {
        error("Aborted during integration");
@@ -0,0 +1,232 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/BrainStimulator/BiotSavartTreecode.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+
+ALGORITHM_PARAMETER_DEF(BrainStimulator, TreecodeOpeningAngle);
+
+/// q x r / |r|^3 and its expansion about a box center
+struct BiotSavartTreecode::CrossKernel
+{
+  static Vector direct(const Vector& q, const Vector& r, double r2)
+  {
+    return Cross(q, r) / (r2 * std::sqrt(r2));
+  }
+
+  static Vector expand(const TreeNode& n, const Vector& r, double r2)
+  {
+    const double inv_r = 1.0 / std::sqrt(r2);
+    const double inv_r3 = inv_r * inv_r * inv_r;
+    const Vector mr = n.moment_[0] * r[0] + n.moment_[1] * r[1] + n.moment_[2] * r[2];
+    return (Cross(n.charge_, r) - n.curl_) * inv_r3 + Cross(mr, r) * (3.0 * inv_r3 * inv_r * inv_r);
+  }
+};
+
+/// q / |r| and its expansion about a box center
+struct BiotSavartTreecode::PotentialKernel
+{
+  static Vector direct(const Vector& q, const Vector&, double r2)
+  {
+    return q / std::sqrt(r2);
+  }
+
+  static Vector expand(const TreeNode& n, const Vector& r, double r2)
+  {
+    const double inv_r = 1.0 / std::sqrt(r2);
+    const Vector mr = n.moment_[0] * r[0] + n.moment_[1] * r[1] + n.moment_[2] * r[2];
+    return n.charge_ * inv_r + mr * (inv_r * inv_r * inv_r);
+  }
+};
+
+BiotSavartTreecode::BiotSavartTreecode(const std::vector<Point>& positions,
+                                       const std::vector<Vector>& strengths,
+                                       double opening_angle, size_type leaf_size) :
+  opening_angle2_(opening_angle * opening_angle),
+  leaf_size_(std::max<size_type>(leaf_size, 1)),
+  positions_(positions),
+  strengths_(strengths)
+{
+  const size_type num_sources = static_cast<size_type>(positions_.size());
+  index_.resize(num_sources);
+  for (index_type i = 0; i < num_sources; i++) index_[i] = i;
+
+  if (num_sources == 0) return;
+
+  nodes_.reserve(2 * (num_sources / leaf_size_) + 1);
+  build(0, num_sources);
+
+  // Move the sources into tree order, so leaves read contiguous memory
+  std::vector<Point> tree_positions(num_sources);
+  std::vector<Vector> tree_strengths(num_sources);
+  for (index_type i = 0; i < num_sources; i++)
+  {
+    tree_positions[i] = positions_[index_[i]];
+    tree_strengths[i] = strengths_[index_[i]];
+  }
+  positions_.swap(tree_positions);
+  strengths_.swap(tree_strengths);
+
+  order_.resize(num_sources);
+  for (index_type i = 0; i < num_sources; i++) order_[index_[i]] = i;
+}
+
+index_type
+BiotSavartTreecode::build(index_type begin, index_type end)
+{
+  Point bmin = positions_[index_[begin]];
+  Point bmax = bmin;
+  for (index_type i = begin + 1; i < end; i++)
+  {
+    bmin = Min(bmin, positions_[index_[i]]);
+    bmax = Max(bmax, positions_[index_[i]]);
+  }
+
+  const index_type node = static_cast<index_type>(nodes_.size());
+  nodes_.push_back(TreeNode());
+  {
+    TreeNode& n = nodes_[node];
+    n.center_ = Point(0.5 * (Vector(bmin) + Vector(bmax)));
+    n.radius_ = 0.5 * (bmax - bmin).length();
+    n.begin_ = begin;
+    n.end_ = end;
+    n.second_ = -1;
+    n.charge_ = Vector(0, 0, 0);
+    n.curl_ = Vector(0, 0, 0);
+    for (int k = 0; k < 3; k++) n.moment_[k] = Vector(0, 0, 0);
+  }
+
+  if (end - begin <= leaf_size_)
+  {
+    TreeNode& n = nodes_[node];
+    for (index_type i = begin; i < end; i++)
+    {
+      const Vector& q = strengths_[index_[i]];
+      const Vector d = positions_[index_[i]] - n.center_;
+      n.charge_ += q;
+      n.curl_ += Cross(q, d);
+      for (int k = 0; k < 3; k++) n.moment_[k] += q * d[k];
+    }
+    return node;
+  }
+
+  const Vector extent = bmax - bmin;
+  int axis = 0;
+  if (extent[1] > extent[axis]) axis = 1;
+  if (extent[2] > extent[axis]) axis = 2;
+
+  const index_type mid = begin + (end - begin) / 2;
+  std::nth_element(index_.begin() + begin, index_.begin() + mid, index_.begin() + end,
+    [this, axis](index_type a, index_type b) { return positions_[a][axis] < positions_[b][axis]; });
+
+  build(begin, mid);
+  const index_type second = build(mid, end);
+
+  // Shift the moments of both children to the center of this box
+  TreeNode& n = nodes_[node];
+  n.second_ = second;
+  const index_type children[2] = { node + 1, second };
+  for (int c = 0; c < 2; c++)
+  {
+    const TreeNode& child = nodes_[children[c]];
+    const Vector shift = child.center_ - n.center_;
+    n.charge_ += child.charge_;
+    n.curl_ += child.curl_ + Cross(child.charge_, shift);
+    for (int k = 0; k < 3; k++) n.moment_[k] += child.moment_[k] + child.charge_ * shift[k];
+  }
+  return node;
+}
+
+template <class KERNEL>
+Vector
+BiotSavartTreecode::evaluate(const Point& p, index_type exclude) const
+{
+  Vector result(0, 0, 0);
+  if (nodes_.empty()) return result;
+
+  const index_type skip = (exclude >= 0 && exclude < num_sources()) ? order_[exclude] : -1;
+
+  // The tree is split at the median, so its depth stays far below this
+  index_type stack[128];
+  int top = 0;
+  stack[top++] = 0;
+
+  while (top > 0)
+  {
+    const TreeNode& n = nodes_[stack[--top]];
+    const Vector r = p - n.center_;
+    const double r2 = r.length2();
+
+    if (n.radius_ * n.radius_ < opening_angle2_ * r2)
+    {
+      result += KERNEL::expand(n, r, r2);
+      if (skip >= n.begin_ && skip < n.end_)
+      {
+        // The expansion includes the excluded source, take it out again
+        const Vector rs = p - positions_[skip];
+        const double rs2 = rs.length2();
+        if (rs2 > 0.0) result -= KERNEL::direct(strengths_[skip], rs, rs2);
+      }
+    }
+    else if (n.second_ < 0)
+    {
+      for (index_type i = n.begin_; i < n.end_; i++)
+      {
+        const Vector ri = p - positions_[i];
+        const double ri2 = ri.length2();
+        if (ri2 > 0.0 && i != skip)
+          result += KERNEL::direct(strengths_[i], ri, ri2);
+      }
+    }
+    else
+    {
+      const index_type node = static_cast<index_type>(&n - &nodes_[0]);
+      stack[top++] = n.second_;
+      stack[top++] = node + 1;
+    }
+  }
+  return result;
+}
+
+Vector
+BiotSavartTreecode::cross_field(const Point& p, index_type exclude) const
+{
+  return evaluate<CrossKernel>(p, exclude);
+}
+
+Vector
+BiotSavartTreecode::potential(const Point& p, index_type exclude) const
+{
+  return evaluate<PotentialKernel>(p, exclude);
+}
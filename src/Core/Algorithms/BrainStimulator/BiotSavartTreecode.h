@@ -0,0 +1,111 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+///@file BiotSavartTreecode.h
+///@brief Treecode for the sums over sources in the magnetic field solvers.
+///
+///@details
+///  The sources are sorted into a binary tree of boxes. Seen from far enough
+///  away, the sources of a box are replaced by the first two terms of their
+///  multipole expansion about the box center. The opening angle sets what
+///  counts as far: a box of radius s is expanded at distance r when
+///  s < angle * r. The error of an expanded box falls off like angle^2, and
+///  an angle of 0 sums every source directly.
+
+#ifndef CORE_ALGORITHMS_BRAINSTIMULATOR_BIOTSAVARTTREECODE_H
+#define CORE_ALGORITHMS_BRAINSTIMULATOR_BIOTSAVARTTREECODE_H 1
+
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <vector>
+#include <Core/Algorithms/BrainStimulator/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace BrainStimulator {
+
+  /// Opening angle of the treecode, 0 sums all sources directly.
+  ALGORITHM_PARAMETER_DECL(TreecodeOpeningAngle);
+
+  class SCISHARE BiotSavartTreecode
+  {
+  public:
+    /// Source i sits at positions[i] and has the vector strength strengths[i].
+    BiotSavartTreecode(const std::vector<Geometry::Point>& positions,
+                       const std::vector<Geometry::Vector>& strengths,
+                       double opening_angle, size_type leaf_size = 16);
+
+    /// Sum over the sources of q_i x (p - x_i) / |p - x_i|^3, the kernel of
+    /// the Biot-Savart law and of the field of current dipoles.
+    /// The source with the original index exclude is left out of the sum, as
+    /// is any source that coincides with p.
+    Geometry::Vector cross_field(const Geometry::Point& p, index_type exclude = -1) const;
+
+    /// Sum over the sources of q_i / |p - x_i|, the kernel of the magnetic
+    /// vector potential.
+    Geometry::Vector potential(const Geometry::Point& p, index_type exclude = -1) const;
+
+    size_type num_sources() const { return static_cast<size_type>(positions_.size()); }
+
+  private:
+    struct TreeNode
+    {
+      Geometry::Point  center_;
+      double           radius_;     ///< Distance from center_ to the furthest corner of the box
+      Geometry::Vector charge_;     ///< Sum of q_i
+      Geometry::Vector curl_;       ///< Sum of q_i x d_i, with d_i = x_i - center_
+      Geometry::Vector moment_[3];  ///< Sum of q_i * d_i[k] for every axis k
+      index_type begin_;            ///< Sources begin_ to end_ in tree order are inside the box
+      index_type end_;
+      /// Index of the second child, the first one directly follows its
+      /// parent. -1 for leaves.
+      index_type second_;
+    };
+
+    struct CrossKernel;
+    struct PotentialKernel;
+
+    index_type build(index_type begin, index_type end);
+    template <class KERNEL>
+    Geometry::Vector evaluate(const Geometry::Point& p, index_type exclude) const;
+
+    double opening_angle2_;
+    size_type leaf_size_;
+    std::vector<TreeNode> nodes_;
+    std::vector<Geometry::Point>  positions_;  ///< Sources in tree order
+    std::vector<Geometry::Vector> strengths_;
+    std::vector<index_type>       index_;      ///< Original index of every source in tree order
+    std::vector<index_type>       order_;      ///< Tree order position of every original index
+  };
+
+}}}}
+
+#endif
@@ -210,7 +210,7 @@ boost::tuple<DenseMatrixHandle, DenseMatrixHandle, DenseMatrixHandle, DenseMatri
 
  VMesh*  mesh_vmesh = mesh->vmesh();
  VMesh::size_type mesh_num_nodes = mesh_vmesh->num_nodes();
- mesh_vmesh->synchronize(Mesh::NODE_LOCATE_E);
+ mesh_vmesh->synchronize(Mesh::FIND_CLOSEST_NODE_E|Mesh::NODE_LOCATE_TREE_E);
  DenseMatrixHandle lhs_knows, elc_elem, elc_elem_typ, elc_elem_def, elc_con_imp;
  std::vector<double> electrode_sponge_areas;
  index_type refnode_number = get(Parameters::refnode).toInt();
@@ -254,14 +254,19 @@ boost::tuple<DenseMatrixHandle, DenseMatrixHandle, DenseMatrixHandle, DenseMatri
   FieldHandle point_electrodes = CreateField(fieldinfo);  
   VMesh* point_electrodes_mesh = point_electrodes->vmesh();
   
+  std::vector<Point> elc_points, closest;
+  std::vector<double> distances;
+  std::vector<VMesh::Node::index_type> closest_ind;
   for(VMesh::Node::index_type l=0; l<mesh_elc_tri_surf->num_nodes(); l++)
   {
-   Point p,q; 
+   Point p;
    mesh_elc_tri_surf->get_center(p,l);
-   double distance=-1;
-   VMesh::Node::index_type ind;
-   mesh_vmesh->find_closest_node(distance,q,ind,p);
-   point_electrodes_mesh->add_point(q);
+   elc_points.push_back(p);
+  }
+  mesh_vmesh->mfind_closest_node(distances,closest,closest_ind,elc_points);
+  for(size_t l=0; l<closest.size(); l++)
+  {
+   point_electrodes_mesh->add_point(closest[l]);
    fvalues.push_back(0);
    electrode_sponge_areas.push_back(std::numeric_limits<double>::quiet_NaN());
   } 
@@ -822,20 +827,26 @@ DenseMatrixHandle SetupTDCSAlgorithm::create_rhs(FieldHandle mesh, FieldHandle e
   
   VMesh* mesh_elc_tri_surf = elc_tri_surf->vmesh();
   mesh_elc_tri_surf->synchronize(Mesh::NODE_LOCATE_E); 
-  vmesh->synchronize(Mesh::NODE_LOCATE_E); 
+  vmesh->synchronize(Mesh::FIND_CLOSEST_NODE_E|Mesh::NODE_LOCATE_TREE_E); 
   for(VMesh::Node::index_type l=0; l<vmesh->num_nodes(); l++)
   {
     (*output)(l,0)=0;
   }
   double min_dis = get(Parameters::pointdistancebound).toDouble();
+  std::vector<Point> elc_points, closest;
+  std::vector<double> distances;
+  std::vector<VMesh::Node::index_type> closest_ind;
   for(VMesh::Node::index_type l=0; l<mesh_elc_tri_surf->num_nodes(); l++)
   {
-   Point p,q; 
+   Point p;
    mesh_elc_tri_surf->get_center(p,l);
-   double distance=-1;
-   VMesh::Node::index_type ind;
-   vmesh->find_closest_node(distance,q,ind,p);
-   (*output)(ind,0)=elcs_wanted[l].toDouble()/1000.0;
+   elc_points.push_back(p);
+  }
+  vmesh->mfind_closest_node(distances,closest,closest_ind,elc_points);
+  for(size_t l=0; l<closest_ind.size(); l++)
+  {
+   const double distance = distances[l];
+   (*output)(closest_ind[l],0)=elcs_wanted[l].toDouble()/1000.0;
    if(min_dis<distance)
    {
      std::ostringstream ostr4;
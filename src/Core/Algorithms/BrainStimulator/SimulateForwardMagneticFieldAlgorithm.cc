@@ -60,6 +60,11 @@ AlgorithmInputName SimulateForwardMagneticFieldAlgo::DetectorLocations("Detector
 AlgorithmOutputName SimulateForwardMagneticFieldAlgo::MagneticField("MagneticField");
 AlgorithmOutputName SimulateForwardMagneticFieldAlgo::MagneticFieldMagnitudes("MagneticFieldMagnitudes");
 
+SimulateForwardMagneticFieldAlgo::SimulateForwardMagneticFieldAlgo()
+{
+  addParameter(Parameters::TreecodeOpeningAngle, 0.0);
+}
+
 class CalcFMField
 {
   public:
@@ -78,6 +83,7 @@ class CalcFMField
     void interpolate(int proc, Point p);
     void set_up_cell_cache();
     void calc_parallel(int proc);
+    void set_up_treecodes(double opening_angle);
 
     const AlgorithmBase* algo_;
     int np_;
@@ -93,6 +99,10 @@ class CalcFMField
 
     std::vector<per_cell_cache>  cell_cache_;
 
+    // Only built for a positive opening angle, otherwise all sums are direct
+    boost::shared_ptr<BiotSavartTreecode> cell_tree_;
+    boost::shared_ptr<BiotSavartTreecode> dipole_tree_;
+
     VField* efld_; // Electric Field
     VField* ctfld_; // Conductivity Field
     VField* dipfld_; // Dipole Field
@@ -186,6 +196,28 @@ void CalcFMField::set_up_cell_cache()
   }
 }
 
+void CalcFMField::set_up_treecodes(double opening_angle)
+{
+  std::vector<Point> positions(cell_cache_.size());
+  std::vector<Vector> strengths(cell_cache_.size());
+  for (size_t idx = 0; idx < cell_cache_.size(); idx++)
+  {
+    positions[idx] = cell_cache_[idx].center_;
+    strengths[idx] = cell_cache_[idx].cur_density_ * cell_cache_[idx].volume_;
+  }
+  cell_tree_.reset(new BiotSavartTreecode(positions, strengths, opening_angle));
+
+  VMesh::size_type num_dipoles = dipmsh_->num_nodes();
+  positions.resize(num_dipoles);
+  strengths.resize(num_dipoles);
+  for (VMesh::Node::index_type idx = 0; idx < num_dipoles; idx++)
+  {
+    dipmsh_->get_center(positions[idx], idx);
+    dipfld_->value(strengths[idx], idx);
+  }
+  dipole_tree_.reset(new BiotSavartTreecode(positions, strengths, opening_angle));
+}
+
 void CalcFMField::calc_parallel(int proc)
 {
 
@@ -211,26 +243,36 @@ void CalcFMField::calc_parallel(int proc)
 
     detmsh_->get_center(pt, idx);
 
-    // init the interp val to 0
-    interp_value_[proc] = Vector(0,0,0);
-    interpolate(proc, pt);
-
-    mag_field = interp_value_[proc];
-
     Vector normal;
     detfld_->get_value(normal,idx);
 
-    // iterate over the dipoles.
-    for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+    if (cell_tree_)
+    {
+      // same sums as below, with far away groups of sources expanded
+      VMesh::Elem::index_type inside_cell = 0;
+      index_type exclude = emsh_->locate(inside_cell, pt) ? index_type(inside_cell) : -1;
+      mag_field = cell_tree_->cross_field(pt, exclude) + dipole_tree_->cross_field(pt);
+    }
+    else
     {
-      dipmsh_->get_center(pt2, dip_idx);
-      dipfld_->value(P,dip_idx);
+      // init the interp val to 0
+      interp_value_[proc] = Vector(0,0,0);
+      interpolate(proc, pt);
 
-      Vector radius = pt - pt2; // detector - source
-      Vector valuePXR = Cross(P, radius);
-      double length = radius.length();
+      mag_field = interp_value_[proc];
+
+      // iterate over the dipoles.
+      for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+      {
+        dipmsh_->get_center(pt2, dip_idx);
+        dipfld_->value(P,dip_idx);
+
+        Vector radius = pt - pt2; // detector - source
+        Vector valuePXR = Cross(P, radius);
+        double length = radius.length();
 
-      mag_field += valuePXR / (length * length * length);
+        mag_field += valuePXR / (length * length * length);
+      }
     }
 
     mag_field *= one_over_4_pi;
@@ -303,6 +345,13 @@ boost::tuple<FieldHandle,FieldHandle> CalcFMField::calc_forward_magnetic_field(F
   // cache per cell calculations that are used over and over again.
   set_up_cell_cache();
 
+  const double opening_angle = algo_->get(Parameters::TreecodeOpeningAngle).toDouble();
+  if (opening_angle > 0.0)
+  {
+    emsh_->synchronize(Mesh::ELEM_LOCATE_E);
+    set_up_treecodes(opening_angle);
+  }
+
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   // do the parallel work.
   Thread::parallel(this, &CalcFMField::calc_parallel, np_, mod);
@@ -0,0 +1,172 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/BrainStimulator/BiotSavartTreecode.h>
+#include <boost/random.hpp>
+#include <chrono>
+#include <iostream>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+
+namespace
+{
+  void randomSources(int n, std::vector<Point>& positions, std::vector<Vector>& strengths)
+  {
+    boost::mt19937 rng(42);
+    boost::uniform_real<double> range(-1.0, 1.0);
+    boost::variate_generator<boost::mt19937&, boost::uniform_real<double> > uniform(rng, range);
+
+    positions.resize(n);
+    strengths.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+      positions[i] = Point(uniform(), uniform(), uniform());
+      strengths[i] = Vector(uniform(), uniform(), uniform());
+    }
+  }
+
+  Vector directCrossField(const std::vector<Point>& positions, const std::vector<Vector>& strengths, const Point& p, index_type exclude = -1)
+  {
+    Vector sum(0, 0, 0);
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+      if (static_cast<index_type>(i) == exclude) continue;
+      Vector r = p - positions[i];
+      double l = r.length();
+      sum += Cross(strengths[i], r) / (l * l * l);
+    }
+    return sum;
+  }
+
+  Vector directPotential(const std::vector<Point>& positions, const std::vector<Vector>& strengths, const Point& p)
+  {
+    Vector sum(0, 0, 0);
+    for (size_t i = 0; i < positions.size(); i++)
+      sum += strengths[i] / (p - positions[i]).length();
+    return sum;
+  }
+
+  std::vector<Point> detectors()
+  {
+    std::vector<Point> points;
+    for (int i = 0; i < 5; i++)
+      for (int j = 0; j < 5; j++)
+        points.push_back(Point(-1.5 + 0.75 * i, -1.5 + 0.75 * j, 1.8));
+    return points;
+  }
+}
+
+TEST(BiotSavartTreecodeTests, ZeroOpeningAngleIsDirectSum)
+{
+  std::vector<Point> positions;
+  std::vector<Vector> strengths;
+  randomSources(2000, positions, strengths);
+
+  BiotSavartTreecode tree(positions, strengths, 0.0);
+  ASSERT_EQ(2000, tree.num_sources());
+
+  for (const auto& p : detectors())
+  {
+    Vector expectedB = directCrossField(positions, strengths, p);
+    Vector expectedA = directPotential(positions, strengths, p);
+    Vector b = tree.cross_field(p);
+    Vector a = tree.potential(p);
+    EXPECT_NEAR(0.0, (b - expectedB).length(), 1e-10 * expectedB.length());
+    EXPECT_NEAR(0.0, (a - expectedA).length(), 1e-10 * expectedA.length());
+  }
+}
+
+TEST(BiotSavartTreecodeTests, ExpansionConvergesWithOpeningAngle)
+{
+  std::vector<Point> positions;
+  std::vector<Vector> strengths;
+  randomSources(5000, positions, strengths);
+
+  double previous = 1.0;
+  for (double angle : { 0.7, 0.5, 0.3 })
+  {
+    BiotSavartTreecode tree(positions, strengths, angle);
+    double error = 0.0, norm = 0.0;
+    for (const auto& p : detectors())
+    {
+      Vector expected = directCrossField(positions, strengths, p);
+      error += (tree.cross_field(p) - expected).length2();
+      norm += expected.length2();
+    }
+    double relative = std::sqrt(error / norm);
+    // the first neglected term of the expansion is of order angle^2
+    EXPECT_LT(relative, 0.5 * angle * angle);
+    EXPECT_LT(relative, previous);
+    previous = relative;
+  }
+}
+
+TEST(BiotSavartTreecodeTests, ExcludedSourceIsLeftOut)
+{
+  std::vector<Point> positions;
+  std::vector<Vector> strengths;
+  randomSources(1000, positions, strengths);
+
+  BiotSavartTreecode tree(positions, strengths, 0.0);
+  Point p(0.1, 0.2, 0.3);
+  for (index_type exclude : { 0, 17, 999 })
+  {
+    Vector expected = directCrossField(positions, strengths, p, exclude);
+    EXPECT_NEAR(0.0, (tree.cross_field(p, exclude) - expected).length(), 1e-10 * expected.length());
+  }
+}
+
+TEST(BiotSavartTreecodeTests, DISABLED_TreecodeVersusDirectSumBenchmark)
+{
+  std::vector<Point> positions;
+  std::vector<Vector> strengths;
+  randomSources(200000, positions, strengths);
+  std::vector<Point> points;
+  for (int i = 0; i < 2000; i++)
+    points.push_back(Point(-1.5 + 0.0015 * i, 0.5, 1.8));
+
+  auto start = std::chrono::high_resolution_clock::now();
+  Vector direct(0, 0, 0);
+  for (const auto& p : points)
+    direct += directCrossField(positions, strengths, p);
+  auto directTime = std::chrono::high_resolution_clock::now() - start;
+
+  start = std::chrono::high_resolution_clock::now();
+  BiotSavartTreecode tree(positions, strengths, 0.5);
+  Vector treecode(0, 0, 0);
+  for (const auto& p : points)
+    treecode += tree.cross_field(p);
+  auto treeTime = std::chrono::high_resolution_clock::now() - start;
+
+  std::cout << "direct sum: " << std::chrono::duration_cast<std::chrono::milliseconds>(directTime).count() << " ms, "
+    << "treecode (including build): " << std::chrono::duration_cast<std::chrono::milliseconds>(treeTime).count() << " ms" << std::endl;
+  EXPECT_NEAR(0.0, (treecode - direct).length(), 0.1 * direct.length());
+}
@@ -0,0 +1,139 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <algorithm>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // Distance from every value location of output to object, one search each.
+  void checkAgainstClosestElem(FieldHandle output, FieldHandle object, double maxError)
+  {
+    VMesh* omesh = output->vmesh();
+    VField* ofield = output->vfield();
+    VMesh* objmesh = object->vmesh();
+    objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+
+    // Spacing of the value locations, bounds the error beyond the band
+    VMesh::dimension_type dims;
+    omesh->get_dimensions(dims);
+    Point p0, p1;
+    omesh->get_center(p0, VMesh::Node::index_type(0));
+    omesh->get_center(p1, VMesh::Node::index_type(1));
+    const double h = (p1 - p0).length();
+    // find_closest_elem reports points on the surface with a small offset
+    const double tolerance = 1e-5;
+
+    for (VMesh::index_type idx = 0; idx < ofield->num_values(); ++idx)
+    {
+      Point p, r;
+      if (ofield->basis_order() == 0) omesh->get_center(p, VMesh::Elem::index_type(idx));
+      else omesh->get_center(p, VMesh::Node::index_type(idx));
+      double exact;
+      VMesh::Elem::index_type elem;
+      ASSERT_TRUE(objmesh->find_closest_elem(exact, r, elem, p));
+
+      double val;
+      ofield->get_value(val, idx);
+      EXPECT_GE(val, exact - tolerance);
+      EXPECT_LE(val, exact + maxError + tolerance);
+      // Within a voxel diagonal of the surface the distance is exact
+      if (exact < 1.5 * h) EXPECT_NEAR(exact, val, tolerance);
+    }
+  }
+}
+
+TEST(CalculateDistanceFieldAlgoTests, LatVolLinearMatchesClosestElemSearch)
+{
+  FieldHandle latvol = CreateEmptyLatVol(25, 25, 25, DOUBLE_E, Point(-1, -1, -1), Point(2, 2, 2));
+  FieldHandle object = TetrahedronTriSurfLinearBasis(DOUBLE_E);
+
+  CalculateDistanceFieldAlgo algo;
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(latvol, object, output));
+  ASSERT_EQ(1, output->vfield()->basis_order());
+
+  const double h = 3.0 / 24;
+  checkAgainstClosestElem(output, object, 1.5 * 3 * h);
+}
+
+TEST(CalculateDistanceFieldAlgoTests, LatVolConstantMatchesClosestElemSearch)
+{
+  FieldHandle latvol = CreateEmptyLatVol(21, 17, 19, DOUBLE_E, Point(-1.5, -1.5, -1), Point(1.5, 1.5, 1));
+  FieldHandle object = TetrahedronTriSurfLinearBasis(DOUBLE_E);
+
+  CalculateDistanceFieldAlgo algo;
+  algo.setOption(Parameters::BasisType, "constant");
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(latvol, object, output));
+  ASSERT_EQ(0, output->vfield()->basis_order());
+
+  checkAgainstClosestElem(output, object, 1.5 * (3.0 / 20 + 3.0 / 16 + 2.0 / 18));
+}
+
+TEST(CalculateDistanceFieldAlgoTests, ObjectOutsideLatVolUsesExactSearch)
+{
+  FieldHandle latvol = CreateEmptyLatVol(8, 8, 8, DOUBLE_E, Point(-3, -3, -3), Point(-2, -2, -2));
+  FieldHandle object = TetrahedronTriSurfLinearBasis(DOUBLE_E);
+
+  CalculateDistanceFieldAlgo algo;
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(latvol, object, output));
+
+  checkAgainstClosestElem(output, object, 0.0);
+}
+
+TEST(CalculateDistanceFieldAlgoTests, LatVolTruncatesDistance)
+{
+  FieldHandle latvol = CreateEmptyLatVol(13, 13, 13, DOUBLE_E, Point(-1, -1, -1), Point(2, 2, 2));
+  FieldHandle object = TetrahedronTriSurfLinearBasis(DOUBLE_E);
+
+  CalculateDistanceFieldAlgo algo;
+  algo.set(Parameters::Truncate, true);
+  algo.set(Parameters::TruncateDistance, 0.4);
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(latvol, object, output));
+
+  std::vector<double> values;
+  output->vfield()->get_values(values);
+  for (size_t k = 0; k < values.size(); ++k) EXPECT_LE(values[k], 0.4);
+  EXPECT_DOUBLE_EQ(0.4, *std::max_element(values.begin(), values.end()));
+}
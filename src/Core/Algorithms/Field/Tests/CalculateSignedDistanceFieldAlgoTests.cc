@@ -0,0 +1,110 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateSignedDistanceField.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // Octahedron |x|+|y|+|z| = r with outward facing triangles
+  FieldHandle octahedron(double r)
+  {
+    FieldInformation fi(TRISURFMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+    mesh->add_point(Point(r, 0, 0));
+    mesh->add_point(Point(-r, 0, 0));
+    mesh->add_point(Point(0, r, 0));
+    mesh->add_point(Point(0, -r, 0));
+    mesh->add_point(Point(0, 0, r));
+    mesh->add_point(Point(0, 0, -r));
+    for (int sx = 0; sx < 2; ++sx)
+      for (int sy = 0; sy < 2; ++sy)
+        for (int sz = 0; sz < 2; ++sz)
+        {
+          VMesh::Node::array_type face(3);
+          face[0] = sx; face[1] = 2 + sy; face[2] = 4 + sz;
+          // Every mirror flips the winding
+          if ((sx + sy + sz) % 2 == 1) std::swap(face[1], face[2]);
+          mesh->add_elem(face);
+        }
+    field->vfield()->resize_values();
+    return field;
+  }
+}
+
+TEST(CalculateSignedDistanceFieldAlgoTests, LatVolMatchesClosestElemSearchWithSign)
+{
+  const double r = 0.8;
+  FieldHandle latvol = CreateEmptyLatVol(21, 21, 21, DOUBLE_E, Point(-1, -1, -1), Point(1, 1, 1));
+  FieldHandle object = octahedron(r);
+
+  CalculateSignedDistanceFieldAlgo algo;
+  FieldHandle output;
+  ASSERT_TRUE(algo.run(latvol, object, output));
+
+  VMesh* omesh = output->vmesh();
+  VField* ofield = output->vfield();
+  VMesh* objmesh = object->vmesh();
+  const double h = 0.1;
+  const double tolerance = 1e-5;
+
+  for (VMesh::Node::index_type idx = 0; idx < ofield->num_values(); ++idx)
+  {
+    Point p, c;
+    omesh->get_center(p, idx);
+    double exact;
+    VMesh::Elem::index_type elem;
+    ASSERT_TRUE(objmesh->find_closest_elem(exact, c, elem, p));
+
+    double val;
+    ofield->get_value(val, idx);
+    EXPECT_GE(std::abs(val), exact - tolerance);
+    EXPECT_LE(std::abs(val), exact + 1.5 * 3 * h + tolerance);
+    if (exact < 1.5 * h) EXPECT_NEAR(exact, std::abs(val), tolerance);
+
+    const double l1 = std::abs(p.x()) + std::abs(p.y()) + std::abs(p.z());
+    if (l1 < r - tolerance) EXPECT_LT(val, 0.0);
+    if (l1 > r + tolerance) EXPECT_GT(val, 0.0);
+  }
+}
@@ -40,6 +40,11 @@ last change: 04/21/2015
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 #include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/HexMC.h>
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/ParallelHexMC.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <array>
+#include <chrono>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -101,3 +106,104 @@ TEST(ExtractSimpleIsoSurfaceAlgoTest, ExtractSimpleIsoSurf_LatVol_DataOnNodes)
   EXPECT_EQ(output->vmesh()->num_elems(),3);
   EXPECT_EQ(output->vfield()->num_values(),5);
 }
+
+namespace
+{
+  // Distance to the origin on the nodes of a n^3 LatVol over [-1,1]^3
+  FieldHandle sphereLatVol(size_type n)
+  {
+    FieldHandle field = CreateEmptyLatVol(n, n, n, DOUBLE_E, Point(-1, -1, -1), Point(1, 1, 1));
+    VMesh* mesh = field->vmesh();
+    VField* vfield = field->vfield();
+    for (VMesh::Node::index_type idx = 0; idx < mesh->num_nodes(); ++idx)
+    {
+      Point p;
+      mesh->get_center(p, idx);
+      vfield->set_value(Vector(p).length(), idx);
+    }
+    return field;
+  }
+
+  FieldHandle extractWithHexMC(FieldHandle input, double iso)
+  {
+    HexMC tesselator(input);
+    tesselator.reset(0, true, false, false);
+    for (VMesh::Elem::index_type idx = 0; idx < input->vmesh()->num_elems(); ++idx)
+      tesselator.extract(idx, iso);
+    return tesselator.get_field(iso);
+  }
+
+  typedef std::array<std::array<double, 3>, 3> Triangle;
+
+  // Triangles by corner coordinates, so node order does not matter
+  std::vector<Triangle> sortedTriangles(FieldHandle field)
+  {
+    VMesh* mesh = field->vmesh();
+    std::vector<Triangle> triangles;
+    VMesh::Node::array_type nodes;
+    for (VMesh::Elem::index_type idx = 0; idx < mesh->num_elems(); ++idx)
+    {
+      mesh->get_nodes(nodes, idx);
+      Triangle corners;
+      for (int k = 0; k < 3; ++k)
+      {
+        Point p;
+        mesh->get_center(p, nodes[k]);
+        corners[k] = {{ p.x(), p.y(), p.z() }};
+      }
+      // Start at the smallest corner and keep the winding
+      std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end()), corners.end());
+      triangles.push_back(corners);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+  }
+}
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, ParallelHexMCMatchesHexMC)
+{
+  FieldHandle input = sphereLatVol(24);
+  ASSERT_TRUE(ParallelHexMC::supports(input));
+
+  for (double iso : { 0.3, 0.75, 1.2 })
+  {
+    FieldHandle expected = extractWithHexMC(input, iso);
+    ParallelHexMC tesselator(input);
+    FieldHandle actual = tesselator.extract(iso);
+
+    ASSERT_EQ(expected->vmesh()->num_nodes(), actual->vmesh()->num_nodes());
+    ASSERT_EQ(expected->vmesh()->num_elems(), actual->vmesh()->num_elems());
+    EXPECT_EQ(actual->vmesh()->num_nodes(), actual->vfield()->num_values());
+    EXPECT_GT(actual->vmesh()->num_elems(), 0);
+
+    auto expectedTriangles = sortedTriangles(expected);
+    auto actualTriangles = sortedTriangles(actual);
+    for (size_t t = 0; t < expectedTriangles.size(); ++t)
+      for (int k = 0; k < 3; ++k)
+        for (int d = 0; d < 3; ++d)
+          EXPECT_DOUBLE_EQ(expectedTriangles[t][k][d], actualTriangles[t][k][d]);
+  }
+}
+
+TEST(ExtractSimpleIsoSurfaceAlgoTest, DISABLED_ParallelHexMCVersusHexMCBenchmark)
+{
+  FieldHandle input = sphereLatVol(256);
+  double seconds[2];
+  for (int parallel = 0; parallel < 2; ++parallel)
+  {
+    auto start = std::chrono::steady_clock::now();
+    FieldHandle output;
+    if (parallel)
+    {
+      ParallelHexMC tesselator(input);
+      output = tesselator.extract(0.5);
+    }
+    else
+    {
+      output = extractWithHexMC(input, 0.5);
+    }
+    const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    seconds[parallel] = time.count();
+  }
+  std::cout << "HexMC: " << seconds[0] << " s  ParallelHexMC: " << seconds[1] << " s" << std::endl;
+}
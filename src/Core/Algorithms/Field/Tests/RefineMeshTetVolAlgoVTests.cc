@@ -0,0 +1,174 @@
+/*
+For more information, please see: http://software.sci.utah.edu
+
+The MIT License
+
+Copyright (c) 2015 Scientific Computing and Imaging Institute,
+University of Utah.
+
+License for the specific language governing rights and limitations under
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/RefineMesh/RefineMeshTetVolAlgoV.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  // n^3 cells of the unit cube, each cut into six tets around its diagonal,
+  // with a nonlinear value on the nodes
+  FieldHandle tetCube(int n)
+  {
+    FieldInformation fi(TETVOLMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+    auto node = [n](int i, int j, int k) { return static_cast<VMesh::index_type>(i + (n + 1) * (j + (n + 1) * k)); };
+
+    for (int k = 0; k <= n; ++k)
+      for (int j = 0; j <= n; ++j)
+        for (int i = 0; i <= n; ++i)
+          mesh->add_point(Point(double(i) / n, double(j) / n, double(k) / n));
+
+    static const int axes[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+    VMesh::Node::array_type nodes(4);
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+          for (const auto& order : axes)
+          {
+            int c[3] = { i, j, k };
+            nodes[0] = node(c[0], c[1], c[2]);
+            for (int s = 0; s < 2; ++s)
+            {
+              ++c[order[s]];
+              nodes[s + 1] = node(c[0], c[1], c[2]);
+            }
+            nodes[3] = node(i + 1, j + 1, k + 1);
+            mesh->add_elem(nodes);
+          }
+
+    VField* vfield = field->vfield();
+    vfield->resize_values();
+    Point p;
+    for (VMesh::index_type idx = 0; idx < mesh->num_nodes(); ++idx)
+    {
+      mesh->get_point(p, VMesh::Node::index_type(idx));
+      vfield->set_value(p.x() * p.y() + p.z() * p.z() - 0.3 * p.x(), idx);
+    }
+    return field;
+  }
+
+  // Position and value of every element corner, in element order. Unlike the
+  // node list this does not depend on how the new nodes are numbered.
+  std::vector<double> elementCorners(FieldHandle field)
+  {
+    VMesh* mesh = field->vmesh();
+    VField* vfield = field->vfield();
+    std::vector<double> corners;
+    VMesh::Node::array_type nodes;
+    Point p;
+    double value;
+    for (VMesh::index_type idx = 0; idx < mesh->num_elems(); ++idx)
+    {
+      mesh->get_nodes(nodes, VMesh::Elem::index_type(idx));
+      for (const auto& n : nodes)
+      {
+        mesh->get_point(p, n);
+        vfield->get_value(value, n);
+        corners.insert(corners.end(), { p.x(), p.y(), p.z(), value });
+      }
+    }
+    return corners;
+  }
+
+  // Reference values printed by the serial refinement this algorithm
+  // replaced, on the same fields.
+  struct Fingerprint
+  {
+    VMesh::size_type nodes, elems;
+    double weighted, values;
+  };
+
+  void expectMatches(const Fingerprint& expected, FieldHandle refined)
+  {
+    EXPECT_EQ(expected.nodes, refined->vmesh()->num_nodes());
+    EXPECT_EQ(expected.elems, refined->vmesh()->num_elems());
+
+    const std::vector<double> corners = elementCorners(refined);
+    double weighted = 0, values = 0;
+    for (size_t i = 0; i < corners.size(); ++i)
+    {
+      weighted += (1 + i % 13) * corners[i];
+      if (i % 4 == 3) values += corners[i];
+    }
+    EXPECT_NEAR(expected.weighted, weighted, 1e-9 * std::fabs(expected.weighted));
+    EXPECT_NEAR(expected.values, values, 1e-9 * std::fabs(expected.values));
+  }
+
+  FieldHandle refine(FieldHandle input, const std::string& select, double isoval)
+  {
+    RefineMeshTetVolAlgoV algo;
+    FieldHandle output;
+    EXPECT_TRUE(algo.runImpl(input, output, select, isoval));
+    return output;
+  }
+
+  struct CoreLimit
+  {
+    explicit CoreLimit(unsigned int max) { Parallel::SetMaximumCores(max); }
+    ~CoreLimit() { Parallel::SetMaximumCores(0); }
+  };
+}
+
+TEST(RefineMeshTetVolAlgoVTests, UniformRefinementMatchesSerialRefinement)
+{
+  auto input = tetCube(6);
+  auto refined = refine(input, "all", 0);
+  ASSERT_TRUE(refined != nullptr);
+  EXPECT_EQ(8 * input->vmesh()->num_elems(), refined->vmesh()->num_elems());
+  expectMatches({ 2197, 10368, 563268.99999999953, 18259.200000000528 }, refined);
+
+  CoreLimit serial(1);
+  EXPECT_EQ(elementCorners(refined), elementCorners(refine(input, "all", 0)));
+}
+
+TEST(RefineMeshTetVolAlgoVTests, IsovalueRefinementMatchesSerialRefinement)
+{
+  auto input = tetCube(6);
+  auto refined = refine(input, "greaterthan", 0.8);
+  ASSERT_TRUE(refined != nullptr);
+  EXPECT_LT(input->vmesh()->num_elems(), refined->vmesh()->num_elems());
+  EXPECT_GT(8 * input->vmesh()->num_elems(), refined->vmesh()->num_elems());
+  expectMatches({ 820, 3402, 244987.19444444243, 10068.180555555517 }, refined);
+
+  CoreLimit serial(1);
+  EXPECT_EQ(elementCorners(refined), elementCorners(refine(input, "greaterthan", 0.8)));
+}
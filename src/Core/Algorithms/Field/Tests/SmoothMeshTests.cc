@@ -0,0 +1,353 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/SmoothMesh/MeshSmoother.h>
+#include <Core/Algorithms/Legacy/Fields/SmoothMesh/FairMesh.h>
+#include <Core/Algorithms/Legacy/Fields/FieldData/SmoothVecFieldMedianAlgo.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // n x n grid of nodes over a bumpy height field, two triangles per cell
+  FieldHandle bumpyTriSurf(int n, data_info_type type)
+  {
+    FieldInformation fi(TRISURFMESH_E, CONSTANTDATA_E, type);
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < n; ++i)
+        mesh->add_point(Point(i + 0.2 * std::sin(3.0 * j), j + 0.2 * std::cos(2.0 * i), 0.5 * std::sin(1.3 * i + 0.7 * j)));
+
+    for (int j = 0; j + 1 < n; ++j)
+    {
+      for (int i = 0; i + 1 < n; ++i)
+      {
+        const VMesh::index_type a = j * n + i, b = a + 1, c = a + n, d = c + 1;
+        VMesh::Node::array_type lower(3), upper(3);
+        lower[0] = a; lower[1] = b; lower[2] = d;
+        upper[0] = a; upper[1] = d; upper[2] = c;
+        mesh->add_elem(lower);
+        mesh->add_elem(upper);
+      }
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  std::vector<Point> points(FieldHandle field)
+  {
+    VMesh* mesh = field->vmesh();
+    const Point* p = mesh->get_points_pointer();
+    return std::vector<Point>(p, p + mesh->num_nodes());
+  }
+
+  template <class ARRAY>
+  void expectRow(const MeshGraph& graph, VMesh::index_type idx, const ARRAY& expected)
+  {
+    ASSERT_EQ(static_cast<VMesh::size_type>(expected.size()), graph.degree(idx));
+    for (size_t k = 0; k < expected.size(); ++k)
+      EXPECT_EQ(static_cast<VMesh::index_type>(expected[k]), graph.begin(idx)[k]);
+  }
+
+  void expectGraphsMatchMesh(VMesh* mesh)
+  {
+    const MeshGraph nodes = MeshGraph::node_neighbors(mesh);
+    ASSERT_EQ(mesh->num_nodes(), nodes.size());
+    VMesh::Node::array_type nodeNeighbors;
+    for (VMesh::Node::index_type idx = 0; idx < mesh->num_nodes(); ++idx)
+    {
+      mesh->get_neighbors(nodeNeighbors, idx);
+      expectRow(nodes, idx, nodeNeighbors);
+    }
+
+    const MeshGraph elems = MeshGraph::elem_neighbors(mesh);
+    ASSERT_EQ(mesh->num_elems(), elems.size());
+    VMesh::Elem::array_type elemNeighbors;
+    for (VMesh::Elem::index_type idx = 0; idx < mesh->num_elems(); ++idx)
+    {
+      mesh->get_neighbors(elemNeighbors, idx);
+      expectRow(elems, idx, elemNeighbors);
+    }
+  }
+
+  // The serial FairMesh loops MeshSmoother replaced, kept as the reference.
+  std::vector<Point> serialFairMesh(FieldHandle input, const std::string& method, int iterations, double lambda, double filterCutoff)
+  {
+    FieldHandle field(input->deep_clone());
+    VMesh* mesh = field->vmesh();
+    const VMesh::size_type num_nodes = mesh->num_nodes();
+    const int num_iter = 2 * iterations;
+    const double mu = 1.0 / (filterCutoff - 1.0 / lambda);
+    Point* point = mesh->get_points_pointer();
+    std::vector<Vector> disp(num_nodes);
+
+    if (method == "fast")
+    {
+      std::vector<VMesh::Node::array_type> neighborhoods(num_nodes);
+      mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+      for (VMesh::Node::index_type idx = 0; idx < num_nodes; idx++)
+        mesh->get_neighbors(neighborhoods[idx], idx);
+
+      for (int it = 0; it < num_iter; it++)
+      {
+        for (VMesh::index_type idx = 0; idx < num_nodes; idx++)
+        {
+          const Point p0 = point[idx];
+          Vector d(0.0, 0.0, 0.0);
+          const VMesh::Node::array_type& neighbors = neighborhoods[idx];
+          const double w = 1.0 / neighbors.size();
+          for (size_t j = 0; j < neighbors.size(); j++)
+            d += w * (point[neighbors[j]] - p0);
+          disp[idx] = d;
+        }
+        for (VMesh::index_type idx = 0; idx < num_nodes; idx++)
+          point[idx] = point[idx] + ((it % 2 == 0) ? lambda : mu) * disp[idx];
+      }
+    }
+    else
+    {
+      std::vector<std::vector<std::pair<VMesh::index_type, VMesh::index_type> > > neighborhoods(num_nodes);
+      mesh->synchronize(Mesh::NODE_NEIGHBORS_E | Mesh::EPSILON_E);
+      VMesh::Elem::array_type elems;
+      VMesh::Node::array_type nodes;
+      for (VMesh::Node::index_type idx = 0; idx < num_nodes; idx++)
+      {
+        mesh->get_elems(elems, idx);
+        for (size_t j = 0; j < elems.size(); j++)
+        {
+          mesh->get_nodes(nodes, elems[j]);
+          nodes.push_back(nodes[0]);
+          for (size_t k = 1; k < nodes.size(); k++)
+          {
+            if (nodes[k-1] != idx && nodes[k] != idx)
+              neighborhoods[idx].push_back(std::make_pair(VMesh::index_type(nodes[k-1]), VMesh::index_type(nodes[k])));
+          }
+        }
+      }
+
+      const double epsilon = mesh->get_epsilon();
+      for (int it = 0; it < num_iter; it++)
+      {
+        for (VMesh::index_type idx = 0; idx < num_nodes; idx++)
+        {
+          const Point p0 = point[idx];
+          Vector d(0.0, 0.0, 0.0);
+          const auto& neighborhood = neighborhoods[idx];
+          if (neighborhood.empty()) continue;
+          double totw = 0.0;
+          for (size_t j = 0; j < neighborhood.size(); j++)
+          {
+            const Point p1 = point[neighborhood[j].first];
+            const Point p2 = point[neighborhood[j].second];
+            const Vector e1 = p2 - p0;
+            const Vector e2 = p1 - p0;
+            const Vector p12 = p1 - p2;
+            const double e = Dot(p12, p12);
+            if (e > 0.0)
+            {
+              const double dot = Dot(p1 - p0, p12) / e;
+              const Point p3 = p1 - dot * p12;
+              double A = (p1 - p3).length();
+              const double B = (p0 - p3).length();
+              double C = (p2 - p3).length();
+              if (B >= 10 * epsilon)
+              {
+                if (dot < 0.0) A = -A;
+                if (dot > 1.0) C = -C;
+                totw += (A + C) / B;
+                d += (A / B) * e1 + (C / B) * e2;
+              }
+            }
+          }
+          if (totw != 0.0) disp[idx] = d * (1.0 / totw);
+        }
+        for (VMesh::index_type idx = 0; idx < num_nodes; idx++)
+          point[idx] = point[idx] + ((it % 2 == 0) ? lambda : mu) * disp[idx];
+      }
+    }
+    return points(field);
+  }
+
+  // The serial SmoothVecFieldMedian loop, kept as the reference.
+  std::vector<Vector> serialMedian(FieldHandle input)
+  {
+    VField* ifield = input->vfield();
+    VMesh* imesh = input->vmesh();
+    imesh->synchronize(Mesh::ELEM_NEIGHBORS_E);
+    std::vector<Vector> result(ifield->num_values());
+    Vector v0, v1;
+
+    for (VMesh::Elem::index_type idx = 0; idx < ifield->num_values(); idx++)
+    {
+      VMesh::Elem::array_type nci, ncitot, Nlist, nci2, nci3;
+      imesh->get_neighbors(nci, idx);
+      ncitot.push_back(idx);
+      for (size_t t = 0; t < nci.size(); t++)
+      {
+        ncitot.push_back(nci[t]);
+        imesh->get_neighbors(nci2, nci[t]);
+        ncitot.insert(ncitot.end(), nci2.begin(), nci2.end());
+        for (size_t t2 = 0; t2 < nci2.size(); t2++)
+        {
+          imesh->get_neighbors(nci3, nci2[t2]);
+          ncitot.insert(ncitot.end(), nci3.begin(), nci3.end());
+        }
+      }
+      for (size_t p1 = 0; p1 < ncitot.size(); p1++)
+      {
+        if (std::find(Nlist.begin(), Nlist.end(), ncitot[p1]) == Nlist.end())
+          Nlist.push_back(ncitot[p1]);
+      }
+
+      std::vector<double> angles, original;
+      ifield->get_value(v0, idx);
+      for (size_t q = 0; q < Nlist.size(); q++)
+      {
+        ifield->get_value(v1, Nlist[q]);
+        const double angle = v0.length() * v1.length() == 0 ? 0 : Dot(v0, v1) / (v0.length() * v1.length());
+        angles.push_back(angle);
+        original.push_back(angle);
+      }
+      std::sort(angles.begin(), angles.end());
+      const size_t middle = (angles.size() + 1) / 2;
+      size_t myloc = 0;
+      for (size_t k = 0; k < original.size(); k++)
+      {
+        if (original[k] == angles[middle])
+        {
+          myloc = k;
+          break;
+        }
+      }
+      ifield->get_value(result[idx], Nlist[myloc]);
+    }
+    return result;
+  }
+}
+
+TEST(MeshGraphTests, MatchesNeighborsOfTetMesh)
+{
+  FieldHandle field = CubeTetVolLinearBasis(DOUBLE_E);
+  expectGraphsMatchMesh(field->vmesh());
+}
+
+TEST(MeshGraphTests, MatchesNeighborsOfTriMesh)
+{
+  FieldHandle field = bumpyTriSurf(6, DOUBLE_E);
+  expectGraphsMatchMesh(field->vmesh());
+}
+
+TEST(MeshGraphTests, OppositeEdgesSkipTheCenterNode)
+{
+  FieldHandle field = bumpyTriSurf(5, DOUBLE_E);
+  VMesh* mesh = field->vmesh();
+  const MeshGraph edges = MeshGraph::opposite_edges(mesh);
+  ASSERT_EQ(mesh->num_nodes(), edges.size());
+
+  VMesh::Elem::array_type elems;
+  VMesh::Node::array_type nodes;
+  for (VMesh::Node::index_type idx = 0; idx < mesh->num_nodes(); ++idx)
+  {
+    // one opposite edge per surrounding triangle
+    mesh->get_elems(elems, idx);
+    ASSERT_EQ(static_cast<VMesh::size_type>(2 * elems.size()), edges.degree(idx));
+    for (size_t j = 0; j < elems.size(); ++j)
+    {
+      mesh->get_nodes(nodes, elems[j]);
+      const VMesh::index_type* pair = edges.begin(idx) + 2 * j;
+      EXPECT_NE(idx, pair[0]);
+      EXPECT_NE(idx, pair[1]);
+      EXPECT_NE(std::find(nodes.begin(), nodes.end(), pair[0]), nodes.end());
+      EXPECT_NE(std::find(nodes.begin(), nodes.end(), pair[1]), nodes.end());
+    }
+  }
+}
+
+class FairMeshMatchesSerialLoop : public ::testing::TestWithParam<std::string>
+{
+};
+
+TEST_P(FairMeshMatchesSerialLoop, ForEachMethod)
+{
+  FieldHandle input = bumpyTriSurf(8, DOUBLE_E);
+  FairMeshAlgo algo;
+  algo.setOption(Parameters::FairMeshMethod, GetParam());
+  algo.set(Parameters::NumIterations, 10);
+
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(input, output));
+  auto expected = serialFairMesh(input, GetParam(), 10, algo.get(Parameters::Lambda).toDouble(), algo.get(Parameters::FilterCutoff).toDouble());
+  auto actual = points(output);
+
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i)
+    EXPECT_LT((expected[i] - actual[i]).length(), 1e-10) << "node " << i;
+
+  // the input is left alone
+  EXPECT_NE(points(input)[9], actual[9]);
+}
+
+INSTANTIATE_TEST_CASE_P(
+  FairMeshMethods,
+  FairMeshMatchesSerialLoop,
+  ::testing::Values("fast", "desbrun")
+  );
+
+TEST(SmoothVecFieldMedianTests, MatchesSerialLoop)
+{
+  FieldHandle input = bumpyTriSurf(7, VECTOR_E);
+  VField* ifield = input->vfield();
+  for (VMesh::index_type idx = 0; idx < ifield->num_values(); ++idx)
+    ifield->set_value(Vector(std::sin(1.7 * idx), std::cos(0.9 * idx), std::sin(0.3 * idx + 1.0)), idx);
+
+  SmoothVecFieldMedianAlgo algo;
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(input, output));
+
+  auto expected = serialMedian(input);
+  VField* ofield = output->vfield();
+  ASSERT_EQ(static_cast<VMesh::size_type>(expected.size()), ofield->num_values());
+  Vector v;
+  for (VMesh::index_type idx = 0; idx < ofield->num_values(); ++idx)
+  {
+    ofield->get_value(v, idx);
+    EXPECT_EQ(expected[idx], v) << "element " << idx;
+  }
+}
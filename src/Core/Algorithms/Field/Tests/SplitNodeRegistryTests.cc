@@ -0,0 +1,90 @@
+/*
+For more information, please see: http://software.sci.utah.edu
+
+The MIT License
+
+Copyright (c) 2015 Scientific Computing and Imaging Institute,
+University of Utah.
+
+License for the specific language governing rights and limitations under
+Permission is hereby granted, free of charge, to any person obtaining a
+copy of this software and associated documentation files (the "Software"),
+to deal in the Software without restriction, including without limitation
+the rights to use, copy, modify, merge, publish, distribute, sublicense,
+and/or sell copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included
+in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Legacy/Fields/RefineMesh/SplitNodeRegistry.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+TEST(SplitNodeRegistryTests, SharedKeysGetOneNode)
+{
+  typedef SplitNodeRegistry registry;
+  registry nodes;
+  EXPECT_EQ(7, nodes.allocate({ 4, 0, 3 }));
+
+  nodes.set(nodes.first_slot(0) + 0, registry::node(2));
+  nodes.set(nodes.first_slot(0) + 1, registry::edge(3, 1));
+  nodes.set(nodes.first_slot(0) + 2, registry::face(4, 1, 3));
+  nodes.set(nodes.first_slot(2) + 0, registry::edge(1, 3));
+  nodes.set(nodes.first_slot(2) + 1, registry::node(2));
+  nodes.set(nodes.first_slot(2) + 2, registry::face(3, 4, 1));
+  nodes.number(5);
+
+  ASSERT_EQ(3, nodes.size());
+  // Nodes follow key order: edge 1-3, face 1-3-4, node 2.
+  EXPECT_EQ(2, registry::arity(nodes.key(0)));
+  EXPECT_EQ(3, registry::arity(nodes.key(1)));
+  EXPECT_EQ(1, registry::arity(nodes.key(2)));
+
+  EXPECT_EQ(2, nodes[nodes.first_slot(0) + 0]);
+  EXPECT_EQ(0, nodes[nodes.first_slot(0) + 1]);
+  EXPECT_EQ(1, nodes[nodes.first_slot(0) + 2]);
+  EXPECT_EQ(-1, nodes[nodes.first_slot(0) + 3]);
+  EXPECT_EQ(0, nodes[nodes.first_slot(2) + 0]);
+  EXPECT_EQ(2, nodes[nodes.first_slot(2) + 1]);
+  EXPECT_EQ(1, nodes[nodes.first_slot(2) + 2]);
+}
+
+TEST(SplitNodeRegistryTests, LargeTableMatchesSerialNumbering)
+{
+  typedef SplitNodeRegistry registry;
+  const VMesh::size_type num_elems = 20000;
+  const VMesh::size_type num_nodes = 5000;
+
+  registry nodes;
+  nodes.allocate(std::vector<VMesh::size_type>(num_elems, 2));
+  for (VMesh::index_type e = 0; e < num_elems; e++)
+  {
+    nodes.set(nodes.first_slot(e), registry::edge(e % num_nodes, (e * 7 + 1) % num_nodes));
+    if (e % 3 == 0) nodes.set(nodes.first_slot(e) + 1, registry::node(e % num_nodes));
+  }
+  nodes.number(num_nodes);
+
+  for (VMesh::index_type n = 1; n < nodes.size(); n++)
+    EXPECT_TRUE(nodes.key(n - 1) < nodes.key(n));
+  for (VMesh::index_type e = 0; e < num_elems; e++)
+  {
+    const VMesh::index_type n = nodes[nodes.first_slot(e)];
+    ASSERT_GE(n, 0);
+    EXPECT_TRUE(nodes.key(n).same_key(registry::edge(e % num_nodes, (e * 7 + 1) % num_nodes)));
+    EXPECT_EQ(e % 3 == 0 ? 0 : -1, std::min<VMesh::index_type>(0, nodes[nodes.first_slot(e) + 1]));
+  }
+}
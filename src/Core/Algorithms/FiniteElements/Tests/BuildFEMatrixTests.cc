@@ -214,3 +214,120 @@ TEST(BuildFEMatrixAlgorithmTests, DISABLED_TestMeshSize1e6)
 
   EXPECT_TRUE(compare_with_tolerance(*expectedOutput("1e6.mat"), *output));
 }
+
+namespace FEInputData
+{
+  // Regular grid of n^3 cubes, each split into six positively oriented tets.
+  // The element data indexes a two entry conductivity table.
+  FieldHandle tetGrid(int n)
+  {
+    FieldInformation fi(TETVOLMESH_E, CONSTANTDATA_E, INT_E);
+    auto field = CreateField(fi);
+    auto mesh = field->vmesh();
+
+    auto node = [n](int i, int j, int k) { return VMesh::Node::index_type((k*(n+1) + j)*(n+1) + i); };
+    for (int k = 0; k <= n; ++k)
+      for (int j = 0; j <= n; ++j)
+        for (int i = 0; i <= n; ++i)
+          mesh->add_point(Point(i, j, k));
+
+    const int paths[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+          for (const auto& path : paths)
+          {
+            int c[3] = { i, j, k };
+            VMesh::Node::array_type nodes(4);
+            nodes[0] = node(c[0], c[1], c[2]);
+            for (int s = 0; s < 3; ++s)
+            {
+              c[path[s]]++;
+              nodes[s+1] = node(c[0], c[1], c[2]);
+            }
+            Point p[4];
+            for (int s = 0; s < 4; ++s)
+              mesh->get_center(p[s], nodes[s]);
+            if (Dot(Cross(p[1] - p[0], p[2] - p[0]), p[3] - p[0]) < 0)
+              std::swap(nodes[2], nodes[3]);
+            mesh->add_elem(nodes);
+          }
+
+    field->vfield()->resize_values();
+    for (VMesh::Elem::index_type e = 0; e < mesh->num_elems(); ++e)
+      field->vfield()->set_value(static_cast<int>(e % 2), e);
+    return field;
+  }
+
+  DenseMatrixHandle conductivities(double a, double b)
+  {
+    auto table = boost::make_shared<DenseMatrix>(2, 1);
+    (*table) << a, b;
+    return table;
+  }
+
+  SparseRowMatrixHandle buildStiffness(BuildFEMatrixAlgo& algo, FieldHandle mesh, DenseMatrixHandle ctable)
+  {
+    auto out = algo.run(withInputData((Variables::InputField, mesh)(BuildFEMatrixAlgo::Conductivity_Table, ctable)));
+    return out.get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  }
+}
+
+TEST(BuildFEMatrixAlgorithmTests, StiffnessOfTetGridIsSymmetricWithZeroRowSums)
+{
+  using namespace FEInputData;
+  auto mesh = tetGrid(4);
+
+  BuildFEMatrixAlgo algo;
+  auto stiffness = buildStiffness(algo, mesh, conductivities(1.0, 2.0));
+  ASSERT_THAT(stiffness, NotNull());
+  EXPECT_EQ(125, stiffness->nrows());
+
+  SparseRowMatrix::EigenBase transpose = stiffness->transpose();
+  EXPECT_TRUE(transpose.isApprox(*stiffness));
+
+  Eigen::VectorXd ones = Eigen::VectorXd::Ones(stiffness->ncols());
+  EXPECT_LT((*stiffness * ones).norm(), 1e-10);
+}
+
+TEST(BuildFEMatrixAlgorithmTests, NewConductivitiesReuseTheStructure)
+{
+  using namespace FEInputData;
+  auto mesh = tetGrid(5);
+
+  BuildFEMatrixAlgo algo;
+  auto first = buildStiffness(algo, mesh, conductivities(1.0, 2.0));
+  auto second = buildStiffness(algo, mesh, conductivities(0.25, 4.0));
+  ASSERT_THAT(first, NotNull());
+  ASSERT_THAT(second, NotNull());
+
+  // A fresh algorithm has to map out the structure again
+  BuildFEMatrixAlgo fresh;
+  auto expected = buildStiffness(fresh, mesh, conductivities(0.25, 4.0));
+
+  ASSERT_EQ(expected->nonZeros(), second->nonZeros());
+  EXPECT_TRUE(std::equal(expected->outerIndexPtr(), expected->outerIndexPtr() + expected->rows() + 1, second->outerIndexPtr()));
+  EXPECT_TRUE(std::equal(expected->innerIndexPtr(), expected->innerIndexPtr() + expected->nonZeros(), second->innerIndexPtr()));
+  EXPECT_TRUE(expected->isApprox(*second));
+  EXPECT_FALSE(first->isApprox(*second));
+
+  // Linear in the conductivities
+  auto scaled = buildStiffness(algo, mesh, conductivities(0.5, 8.0));
+  EXPECT_TRUE(scaled->isApprox(2.0 * *second));
+}
+
+TEST(BuildFEMatrixAlgorithmTests, NewMeshRebuildsTheStructure)
+{
+  using namespace FEInputData;
+  BuildFEMatrixAlgo algo;
+
+  auto small = buildStiffness(algo, tetGrid(2), conductivities(1.0, 1.0));
+  auto large = buildStiffness(algo, tetGrid(3), conductivities(1.0, 1.0));
+  ASSERT_THAT(small, NotNull());
+  ASSERT_THAT(large, NotNull());
+  EXPECT_EQ(27, small->nrows());
+  EXPECT_EQ(64, large->nrows());
+
+  BuildFEMatrixAlgo fresh;
+  EXPECT_TRUE(buildStiffness(fresh, tetGrid(3), conductivities(1.0, 1.0))->isApprox(*large));
+}
@@ -28,6 +28,7 @@
 
 #include <Core/Algorithms/Legacy/Fields/ClipMesh/ClipMeshByIsovalue.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/MarchingCubes.h>
+#include <Core/Algorithms/Legacy/Fields/RefineMesh/SplitNodeRegistry.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
@@ -35,6 +36,7 @@
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/SparseRowMatrixFromMap.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Thread/Parallel.h>
 #include <boost/unordered_map.hpp>
 
 #include <algorithm>
@@ -46,6 +48,7 @@ using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Thread;
 
 int tet_permute_table[15][4] = {
   { 0, 0, 0, 0 }, // 0x0
@@ -146,431 +149,224 @@ class ClipMeshByIsovalueAlgoTet {
 
   public:
     bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const;
-
-  private:
-    VMesh::Node::index_type
-    edge_lookup(VField::index_type u0, VField::index_type u1, double d0,
-          const Point &p, detail::edge_hash_type &edgemap,
-          VMesh *clipped) const;
-
-    VMesh::Node::index_type
-    face_lookup(VField::index_type u0, VField::index_type u1, VField::index_type u2,
-          double d1, double d2,
-          const Point &p, detail::face_hash_type &facemap,
-          VMesh *clipped) const;
-
  };
 
-VMesh::Node::index_type ClipMeshByIsovalueAlgoTet::edge_lookup(VField::index_type u0, VField::index_type u1, double d0, const Point &p, detail::edge_hash_type &edgemap, VMesh *clipped) const
+namespace
 {
-  using namespace detail;
-  edgepair_t np;
-  if (u0 < u1)  { np.first = u0; np.second = u1; np.dfirst = d0; }
-  else { np.first = u1; np.second = u0; np.dfirst = 1.0 - d0; }
-
-  auto loc = edgemap.find(np);
-
-  if (loc == edgemap.end())
-  {
-    const VMesh::Node::index_type nodeindex = clipped->add_point(p);
-    edgemap[np] = nodeindex;
-    return nodeindex;
-  }
-  else
-  {
-   return loc->second;
-  }
-}
-
-VMesh::Node::index_type ClipMeshByIsovalueAlgoTet::face_lookup(VField::index_type u0, VField::index_type u1, VField::index_type u2, double d1, double d2, const Point &p, detail::face_hash_type &facemap, VMesh *clipped) const
-{
-  using namespace detail;
-  facetriple_t nt;
-  if (u0 < u1)
-  {
-    if (u2 < u0)
-    {
-      nt.first = u2; nt.second = u0; nt.third = u1;
-      nt.dsecond = 1.0 - d1 - d2; nt.dthird = d1;
-    }
-    else if (u2 < u1)
-    {
-      nt.first = u0; nt.second = u2; nt.third = u1;
-      nt.dsecond = d2; nt.dthird = d1;
-    }
-    else
-    {
-      nt.first = u0; nt.second = u1; nt.third = u2;
-      nt.dsecond = d1; nt.dthird = d2;
-    }
-  }
-  else
+  // Split node slots of a clipped tet and the tets built from them, indexed
+  // by the clipping case: 0 all inside, 1 one node inside, 2 one node
+  // outside and 3 two nodes on either side. The slot layouts are described
+  // in ClipMeshByIsovalueAlgoTet::run.
+  const int tet_clip_slots[4] = { 4, 4, 9, 8 };
+  const int tet_clip_tets[4] = { 1, 1, 7, 5 };
+
+  const int tet_clip_whole[1][4] = { { 0, 1, 2, 3 } };
+  const int tet_clip_three[7][4] = {
+    { 0, 3, 8, 6 }, { 1, 4, 6, 7 }, { 2, 5, 7, 8 }, { 0, 6, 8, 7 },
+    { 0, 8, 2, 7 }, { 0, 6, 7, 1 }, { 0, 1, 7, 2 } };
+  const int tet_clip_two[5][4] = {
+    { 7, 2, 0, 4 }, { 1, 5, 3, 7 }, { 1, 3, 6, 7 }, { 0, 7, 6, 2 },
+    { 0, 1, 6, 7 } };
+
+  int tet_clip_case(int inside)
   {
-    if (u2 > u0)
-    {
-      nt.first = u1; nt.second = u0; nt.third = u2;
-      nt.dsecond = 1.0 - d1 - d2; nt.dthird = d2;
-    }
-    else if (u2 > u1)
-    {
-      nt.first = u1; nt.second = u2; nt.third = u0;
-      nt.dsecond = d2; nt.dthird = 1.0 - d1 - d2;
-    }
-    else
-    {
-      nt.first = u2; nt.second = u1; nt.third = u0;
-      nt.dsecond = d1; nt.dthird = 1.0 - d1 - d2;
-    }
-  }
-  const face_hash_type::iterator loc = facemap.find(nt);
-  if (loc == facemap.end())
-  {
-    const VMesh::Node::index_type nodeindex = clipped->add_point(p);
-    facemap[nt] = nodeindex;
-    return nodeindex;
-  }
-  else
-  {
-    return (*loc).second;
+    if (inside == 0) return -1;
+    if (inside == 0xf) return 0;
+    if (inside == 0x8 || inside == 0x4 || inside == 0x2 || inside == 0x1) return 1;
+    if (inside == 0x7 || inside == 0xb || inside == 0xd || inside == 0xe) return 2;
+    return 3;
   }
 }
 
 bool ClipMeshByIsovalueAlgoTet::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle &mapping) const
 {
+  typedef SplitNodeRegistry registry;
+
   VField* field = input->vfield();
   VMesh*  mesh  = input->vmesh();
   VMesh*  clipped = output->vmesh();
 
-  using namespace detail;
-  node_hash_type nodemap;
-  edge_hash_type edgemap;
-  face_hash_type facemap;
+  const double isoval = algo->get(ClipMeshByIsovalueAlgo::ScalarIsoValue).toDouble();
 
-  VMesh::Node::array_type onodes(4);
-  std::vector<double> v(4);
-  std::vector<Point> p(4);
+  const bool lte = !algo->get(ClipMeshByIsovalueAlgo::LessThanIsoValue).toBool();
 
-  double isoval = algo->get(ClipMeshByIsovalueAlgo::ScalarIsoValue).toDouble();
+  const VMesh::size_type num_elems = mesh->num_elems();
+  const VMesh::size_type num_nodes = mesh->num_nodes();
 
-  bool lte = !algo->get(ClipMeshByIsovalueAlgo::LessThanIsoValue).toBool();
+  std::vector<double> values;
+  field->get_values(values);
 
-  VMesh::size_type num_elems = mesh->num_elems();
+  // Classify all elements and count the split node slots and output tets
+  // each of them needs.
+  std::vector<unsigned char> inside(num_elems);
+  std::vector<VMesh::size_type> num_slots(num_elems);
+  std::vector<VMesh::size_type> num_tets(num_elems);
 
-  for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
+  Parallel::ForRange(0, num_elems, [&](size_t begin, size_t end)
   {
-    mesh->get_nodes(onodes, idx);
-
-      // Get the values and compute an inside/outside mask.
-    VField::index_type inside = 0;
-    mesh->get_centers(p, onodes);
-    field->get_values(v,onodes);
-    for (size_t i = 0; i < onodes.size(); i++)
+    VMesh::Node::array_type onodes(4);
+    for (VMesh::Elem::index_type idx = begin; idx < static_cast<VMesh::index_type>(end); idx++)
     {
-      inside = inside << 1;
-      if (v[i] > isoval)
+      mesh->get_nodes(onodes, idx);
+      int mask = 0;
+      for (size_t i = 0; i < onodes.size(); i++)
       {
-        inside |= 1;
+        mask = mask << 1;
+        if (values[onodes[i]] > isoval) mask |= 1;
       }
 
-    }
-
       // Invert the mask if we are doing less than.
-    if (lte) { inside = ~inside & 0xf; }
+      if (lte) { mask = ~mask & 0xf; }
 
-    if (inside == 0)
-    {
-        // Discard outside elements.
+      inside[idx] = static_cast<unsigned char>(mask);
+      const int c = tet_clip_case(mask);
+      num_slots[idx] = (c < 0) ? 0 : tet_clip_slots[c];
+      num_tets[idx] = (c < 0) ? 0 : tet_clip_tets[c];
     }
-    else if (inside == 0xf)
+  });
+
+  // Every element records the source node, edge and face it needs in
+  // every slot. Slot layouts per case, with perm the permutation that
+  // brings the case to its canonical orientation:
+  //  whole:   the four nodes
+  //  one in:  node perm0, edges perm0-perm1, perm0-perm2, perm0-perm3
+  //  one out: nodes perm1..perm3, edges perm0-perm1, perm0-perm2,
+  //           perm0-perm3, faces (perm0,perm1,perm2), (perm0,perm2,perm3),
+  //           (perm0,perm3,perm1)
+  //  two:     nodes perm2, perm3, edges perm0-perm2, perm0-perm3,
+  //           perm1-perm2, perm1-perm3, faces (perm0,perm2,perm3),
+  //           (perm1,perm2,perm3)
+  registry nodes;
+  nodes.allocate(num_slots);
+
+  Parallel::ForRange(0, num_elems, [&](size_t begin, size_t end)
+  {
+    VMesh::Node::array_type onodes(4);
+    for (VMesh::Elem::index_type idx = begin; idx < static_cast<VMesh::index_type>(end); idx++)
     {
-        // Add this element to the new mesh.
-      VMesh::Node::array_type nnodes(onodes.size());
-      for (size_t i = 0; i<onodes.size(); i++)
-      {
-        if (nodemap.find((VField::index_type)onodes[i]) == nodemap.end())
-        {
-          const VMesh::Node::index_type nodeindex = clipped->add_point(p[i]);
-          nodemap[(VField::index_type)onodes[i]] = nodeindex;
-          nnodes[i] = nodeindex;
-        }
-        else
-        {
-          nnodes[i] = nodemap[(VField::index_type)onodes[i]];
-        }
-      }
+      const int c = tet_clip_case(inside[idx]);
+      if (c < 0) continue;
 
-      clipped->add_elem(nnodes);
-    }
-    else if (inside == 0x8 || inside == 0x4 || inside == 0x2 || inside == 0x1)
-    {
-        // Lop off 3 points and add resulting tet to the new mesh.
-      const int *perm = tet_permute_table[inside];
-      VMesh::Node::array_type nnodes(4);
+      mesh->get_nodes(onodes, idx);
+      const int *perm = tet_permute_table[inside[idx]];
+      VMesh::index_type n[4];
+      for (size_t i = 0; i < 4; i++) n[i] = onodes[perm[i]];
 
-      if (nodemap.find((VField::index_type)onodes[perm[0]]) == nodemap.end())
+      const VMesh::index_type s = nodes.first_slot(idx);
+      if (c == 0)
       {
-        const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[0]]);
-        nodemap[(VField::index_type)onodes[perm[0]]] = nodeindex;
-        nnodes[0] = nodeindex;
+        for (size_t i = 0; i < 4; i++) nodes.set(s+i, registry::node(onodes[i]));
+      }
+      else if (c == 1)
+      {
+        nodes.set(s+0, registry::node(n[0]));
+        nodes.set(s+1, registry::edge(n[0], n[1]));
+        nodes.set(s+2, registry::edge(n[0], n[2]));
+        nodes.set(s+3, registry::edge(n[0], n[3]));
+      }
+      else if (c == 2)
+      {
+        nodes.set(s+0, registry::node(n[1]));
+        nodes.set(s+1, registry::node(n[2]));
+        nodes.set(s+2, registry::node(n[3]));
+        nodes.set(s+3, registry::edge(n[0], n[1]));
+        nodes.set(s+4, registry::edge(n[0], n[2]));
+        nodes.set(s+5, registry::edge(n[0], n[3]));
+        nodes.set(s+6, registry::face(n[0], n[1], n[2]));
+        nodes.set(s+7, registry::face(n[0], n[2], n[3]));
+        nodes.set(s+8, registry::face(n[0], n[3], n[1]));
       }
       else
       {
-        nnodes[0] = nodemap[(VField::index_type)onodes[perm[0]]];
+        nodes.set(s+0, registry::node(n[2]));
+        nodes.set(s+1, registry::node(n[3]));
+        nodes.set(s+2, registry::edge(n[0], n[2]));
+        nodes.set(s+3, registry::edge(n[0], n[3]));
+        nodes.set(s+4, registry::edge(n[1], n[2]));
+        nodes.set(s+5, registry::edge(n[1], n[3]));
+        nodes.set(s+6, registry::face(n[0], n[2], n[3]));
+        nodes.set(s+7, registry::face(n[1], n[2], n[3]));
       }
+    }
+  });
 
-      const double imv = isoval - v[perm[0]];
-      const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
-      const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
-      const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
-      const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
-      const double dl3 = imv / (v[perm[3]] - v[perm[0]]);
-      const Point l3 = Interpolate(p[perm[0]], p[perm[3]], dl3);
-
-
-      nnodes[1] = edge_lookup((VField::index_type)onodes[perm[0]],
-                              (VField::index_type)onodes[perm[1]],
-                              dl1, l1, edgemap, clipped);
+  nodes.number(num_nodes);
 
-      nnodes[2] = edge_lookup((VField::index_type)onodes[perm[0]],
-                              (VField::index_type)onodes[perm[2]],
-                              dl2, l2, edgemap, clipped);
+  // Place the new nodes. Edge break points are interpolated linearly, face
+  // break points sit halfway between the break points of the two cut edges
+  // of the face, i.e. the edges leaving the node on the other side of the
+  // isovalue from the remaining two.
+  auto edge_point = [&](VMesh::index_type a, VMesh::index_type b)
+  {
+    Point pa, pb;
+    mesh->get_center(pa, VMesh::Node::index_type(a));
+    mesh->get_center(pb, VMesh::Node::index_type(b));
+    return Interpolate(pa, pb, (isoval - values[a]) / (values[b] - values[a]));
+  };
 
-      nnodes[3] = edge_lookup((VField::index_type)onodes[perm[0]],
-                              (VField::index_type)onodes[perm[3]],
-                              dl3, l3, edgemap, clipped);
+  clipped->resize_nodes(nodes.size());
+  VField* ofield = output->vfield();
+  ofield->resize_values();
+  CopyProperties(*input, *output);
 
-      clipped->add_elem(nnodes);
-    }
-    else if (inside == 0x7 || inside == 0xb || inside == 0xd || inside == 0xe)
+  Parallel::ForRange(0, nodes.size(), [&](size_t begin, size_t end)
+  {
+    for (VMesh::Node::index_type idx = begin; idx < static_cast<VMesh::index_type>(end); idx++)
     {
-        // Lop off 1 point, break up the resulting quads and add the
-        // resulting tets to the mesh.
-      const int *perm = tet_permute_table[inside];
-      VMesh::Node::array_type nnodes(4);
-
-      VMesh::Node::index_type inodes[9];
-      for (size_t i = 1; i < 4; i++)
+      const registry::key_type& key = nodes.key(idx);
+      const VMesh::index_type* n = key.nodes;
+      Point p;
+      switch (registry::arity(key))
       {
-        if (nodemap.find((VField::index_type)onodes[perm[i]]) == nodemap.end())
-        {
-          const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[i]]);
-          nodemap[(VField::index_type)onodes[perm[i]]] = nodeindex;
-          inodes[i-1] = nodeindex;
-        }
-        else
+        case 1:
+          mesh->get_center(p, VMesh::Node::index_type(n[0]));
+          clipped->set_point(p, idx);
+          ofield->copy_value(field, n[0], idx);
+          break;
+        case 2:
+          clipped->set_point(edge_point(n[0], n[1]), idx);
+          ofield->set_value(isoval, idx);
+          break;
+        default:
         {
-          inodes[i-1] = nodemap[(VField::index_type)onodes[perm[i]]];
+          const bool s0 = values[n[0]] > isoval;
+          const bool s1 = values[n[1]] > isoval;
+          const bool s2 = values[n[2]] > isoval;
+          const int lone = (s0 == s1) ? 2 : ((s0 == s2) ? 1 : 0);
+          const Point e1 = edge_point(n[lone], n[(lone+1)%3]);
+          const Point e2 = edge_point(n[lone], n[(lone+2)%3]);
+          // Assumes linear interpolation across the faces (which seems
+          // safe, this is what we used to cut with.)
+          clipped->set_point(Interpolate(e1, e2, 0.5), idx);
+          ofield->set_value(isoval, idx);
         }
       }
+    }
+  });
 
-      const double imv = isoval - v[perm[0]];
-      const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
-      const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
-      const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
-      const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
-      const double dl3 = imv / (v[perm[3]] - v[perm[0]]);
-      const Point l3 = Interpolate(p[perm[0]], p[perm[3]], dl3);
-
-
-      inodes[3] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[1]],
-                              dl1, l1, edgemap, clipped);
-
-      inodes[4] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              dl2, l2, edgemap, clipped);
-
-      inodes[5] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[3]],
-                              dl3, l3, edgemap, clipped);
-
-      const Point c1 = Interpolate(l1, l2, 0.5);
-      const Point c2 = Interpolate(l2, l3, 0.5);
-      const Point c3 = Interpolate(l3, l1, 0.5);
-
-      inodes[6] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[2]],
-                              dl1*0.5, dl2*0.5,
-                              c1, facemap, clipped);
-      inodes[7] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              (index_type)onodes[perm[3]],
-                              dl2*0.5, dl3*0.5,
-                              c2, facemap, clipped);
-      inodes[8] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[3]],
-                              (index_type)onodes[perm[1]],
-                              dl3*0.5, dl1*0.5,
-                              c3, facemap, clipped);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[3];
-      nnodes[2] = inodes[8];
-      nnodes[3] = inodes[6];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[1];
-      nnodes[1] = inodes[4];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[2];
-      nnodes[1] = inodes[5];
-      nnodes[2] = inodes[7];
-      nnodes[3] = inodes[8];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[6];
-      nnodes[2] = inodes[8];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[8];
-      nnodes[2] = inodes[2];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[6];
-      nnodes[2] = inodes[7];
-      nnodes[3] = inodes[1];
-      clipped->add_elem(nnodes);
+  // Build the tets, every element writes to its own range so the element
+  // order matches the serial clipper.
+  const VMesh::size_type total_tets = registry::exclusive_scan(num_tets);
+  clipped->resize_elems(total_tets);
 
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[1];
-      nnodes[2] = inodes[7];
-      nnodes[3] = inodes[2];
-      clipped->add_elem(nnodes);
-    }
-    else// if (inside == 0x3 || inside == 0x5 || inside == 0x6 ||
-          //     inside == 0x9 || inside == 0xa || inside == 0xc)
+  Parallel::ForRange(0, num_elems, [&](size_t begin, size_t end)
+  {
+    VMesh::Node::array_type nnodes(4);
+    for (VMesh::Elem::index_type idx = begin; idx < static_cast<VMesh::index_type>(end); idx++)
     {
-        // Lop off two points, break the resulting quads, then add the
-        // new tets to the mesh.
-      const int *perm = tet_permute_table[inside];
-      VMesh::Node::array_type nnodes(4);
+      const int c = tet_clip_case(inside[idx]);
+      if (c < 0) continue;
 
-      VMesh::Node::index_type inodes[8];
-      for (size_t i = 2; i < 4; i++)
+      const int (*tets)[4] = (c == 0 || c == 1) ? tet_clip_whole :
+                             ((c == 2) ? tet_clip_three : tet_clip_two);
+      const VMesh::index_type s = nodes.first_slot(idx);
+      for (int t = 0; t < tet_clip_tets[c]; t++)
       {
-        if (nodemap.find((VField::index_type)onodes[perm[i]]) == nodemap.end())
-        {
-          const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[i]]);
-          nodemap[(VField::index_type)onodes[perm[i]]] = nodeindex;
-          inodes[i-2] = nodeindex;
-        }
-        else
-        {
-          inodes[i-2] = nodemap[(VField::index_type)onodes[perm[i]]];
-        }
+        for (size_t i = 0; i < 4; i++) nnodes[i] = nodes[s + tets[t][i]];
+        clipped->set_nodes(nnodes, VMesh::Elem::index_type(num_tets[idx] + t));
       }
-      const double imv0 = isoval - v[perm[0]];
-      const double dl02 = imv0 / (v[perm[2]] - v[perm[0]]);
-      const Point l02 = Interpolate(p[perm[0]], p[perm[2]], dl02);
-      const double dl03 = imv0 / (v[perm[3]] - v[perm[0]]);
-      const Point l03 = Interpolate(p[perm[0]], p[perm[3]], dl03);
-
-      const double imv1 = isoval - v[perm[1]];
-      const double dl12 = imv1 / (v[perm[2]] - v[perm[1]]);
-      const Point l12 = Interpolate(p[perm[1]], p[perm[2]], dl12);
-      const double dl13 = imv1 / (v[perm[3]] - v[perm[1]]);
-      const Point l13 = Interpolate(p[perm[1]], p[perm[3]], dl13);
-
-
-      inodes[2] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              dl02, l02, edgemap, clipped);
-      inodes[3] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[3]],
-                              dl03, l03, edgemap, clipped);
-      inodes[4] = edge_lookup((index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[2]],
-                              dl12, l12, edgemap, clipped);
-      inodes[5] = edge_lookup((index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[3]],
-                              dl13, l13, edgemap, clipped);
-
-      const Point c1 = Interpolate(l02, l03, 0.5);
-      const Point c2 = Interpolate(l12, l13, 0.5);
-
-      inodes[6] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              (index_type)onodes[perm[3]],
-                              dl02*0.5,
-                              dl03*0.5,
-                              c1, facemap, clipped);
-      inodes[7] = face_lookup((index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[2]],
-                              (index_type)onodes[perm[3]],
-                              dl12*0.5,
-                              dl13*0.5,
-                              c2, facemap, clipped);
-
-      nnodes[0] = inodes[7];
-      nnodes[1] = inodes[2];
-      nnodes[2] = inodes[0];
-      nnodes[3] = inodes[4];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[1];
-      nnodes[1] = inodes[5];
-      nnodes[2] = inodes[3];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[1];
-      nnodes[1] = inodes[3];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[7];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[2];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[1];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
     }
-  }
-
-  VField* ofield = output->vfield();
-  ofield->resize_values();
-  CopyProperties(*input, *output);
-
-    // Add the data values from the old field to the new field.
-  node_hash_type::iterator nmitr = nodemap.begin();
-  while (nmitr != nodemap.end())
-  {
-    ofield->copy_value(field,((*nmitr).first),((*nmitr).second));
-    ++nmitr;
-  }
-
-    // Put the isovalue at the edge break points.
-  edge_hash_type::iterator emitr = edgemap.begin();
-  while (emitr != edgemap.end())
-  {
-    ofield->set_value(isoval,((*emitr).second));
-    ++emitr;
-  }
-
-    // Put the isovalue at the face break points.  Assumes linear
-    // interpolation across the faces (which seems safe, this is what we
-    // used to cut with.)
-  face_hash_type::iterator fmitr = facemap.begin();
-  while (fmitr != facemap.end())
-  {
-    ofield->set_value(isoval,((*fmitr).second));
-    ++fmitr;
-  }
+  });
 
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   if (algo->get_bool("build_mapping"))
@@ -579,73 +375,49 @@ bool ClipMeshByIsovalueAlgoTet::run(const AlgorithmBase* algo, FieldHandle input
     const size_type nrows = clipped->num_nodes();
     const size_type ncols = mesh->num_nodes();
 
-    std::vector<index_type> cctmp(nrows*3);
-    std::vector<double> dtmp(nrows*3);
     SparseRowMatrix::Builder sparseBuilder;
     const SparseRowMatrix::Rows& rr = sparseBuilder.allocate_rows(nrows + 1);
 
-    for (index_type i = 0; i < nrows * 3; i++)
-    {
-      cctmp[i] = -1;
-    }
-
-    size_type nnz = 0;
-
-      // Add the data values from the old field to the new field.
-    nmitr = nodemap.begin();
-    while (nmitr != nodemap.end())
-    {
-      cctmp[(*nmitr).second * 3] = (*nmitr).first;
-      dtmp[(*nmitr).second * 3 + 0] = 1.0;
-      nnz++;
-      ++nmitr;
-    }
-
-      // Insert the double hits into cc.
-      // Put the isovalue at the edge break points.
-    emitr = edgemap.begin();
-    while (emitr != edgemap.end())
-    {
-      cctmp[(*emitr).second * 3 + 0] = (*emitr).first.first;
-      cctmp[(*emitr).second * 3 + 1] = (*emitr).first.second;
-      dtmp[(*emitr).second * 3 + 0] = 1.0 - (*emitr).first.dfirst;
-      dtmp[(*emitr).second * 3 + 1] = (*emitr).first.dfirst;
-      nnz+=2;
-      ++emitr;
-    }
-
-      // Insert the double hits into cc.
-      // Put the isovalue at the edge break points.
-    fmitr = facemap.begin();
-    while (fmitr != facemap.end())
+    rr[0] = 0;
+    for (index_type i = 0; i < nrows; i++)
     {
-      cctmp[(*fmitr).second * 3 + 0] = (*fmitr).first.first;
-      cctmp[(*fmitr).second * 3 + 1] = (*fmitr).first.second;
-      cctmp[(*fmitr).second * 3 + 2] = (*fmitr).first.third;
-      dtmp[(*fmitr).second * 3 + 0] =
-          1.0 - (*fmitr).first.dsecond - (*fmitr).first.dthird;;
-      dtmp[(*fmitr).second * 3 + 1] = (*fmitr).first.dsecond;
-      dtmp[(*fmitr).second * 3 + 2] = (*fmitr).first.dthird;
-      nnz+=3;
-
-      ++fmitr;
+      rr[i + 1] = rr[i] + registry::arity(nodes.key(i));
     }
+    const size_type nnz = rr[nrows];
 
     const SparseRowMatrix::Columns& cc = sparseBuilder.allocate_columns(nnz);
     const SparseRowMatrix::Storage& d = sparseBuilder.allocate_data(nnz);
 
-    index_type j;
-    index_type counter = 0;
-    rr[0] = 0;
-    for (j = 0; j < nrows*3; j++)
+    // Edge break points weigh their end nodes by the interpolation
+    // parameter, face break points average the two edge break points.
+    for (index_type i = 0; i < nrows; i++)
     {
-      if (j%3 == 0) { rr[j/3 + 1] = rr[j/3]; }
-      if (cctmp[j] != -1)
+      const index_type* n = nodes.key(i).nodes;
+      double w[3] = { 1.0, 0.0, 0.0 };
+      const int a = registry::arity(nodes.key(i));
+      if (a == 2)
       {
-        cc[counter] = cctmp[j];
-        d[counter] = dtmp[j];
-        rr[j/3 + 1]++;
-        counter++;
+        w[1] = (isoval - values[n[0]]) / (values[n[1]] - values[n[0]]);
+        w[0] = 1.0 - w[1];
+      }
+      else if (a == 3)
+      {
+        const bool s0 = values[n[0]] > isoval;
+        const bool s1 = values[n[1]] > isoval;
+        const bool s2 = values[n[2]] > isoval;
+        const int lone = (s0 == s1) ? 2 : ((s0 == s2) ? 1 : 0);
+        w[lone] = 1.0;
+        for (int k = 1; k < 3; k++)
+        {
+          const int o = (lone + k) % 3;
+          w[o] = 0.5 * (isoval - values[n[lone]]) / (values[n[o]] - values[n[lone]]);
+          w[lone] -= w[o];
+        }
+      }
+      for (int k = 0; k < a; k++)
+      {
+        cc[rr[i] + k] = n[k];
+        d[rr[i] + k] = w[k];
       }
     }
     mapping = new SparseRowMatrix(nrows, ncols, sparseBuilder.build(), nnz);
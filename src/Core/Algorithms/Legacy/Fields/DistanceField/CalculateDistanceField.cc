@@ -27,6 +27,7 @@
 */
 
 #include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/RegularGridDistanceTransform.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
@@ -396,7 +397,7 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (true);
   }
 
-  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::ELEM_LOCATE_TREE_E);
 
   if (ofield->basis_order() > 2)
   {
@@ -404,6 +405,20 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (false);
   }
 
+  // Regular grids get a distance transform instead of a search per voxel
+  RegularGridDistanceTransform edt(imesh,objmesh,ofield->basis_order(),this);
+  std::vector<double> values;
+  if (edt.run(values))
+  {
+    if (get(Parameters::Truncate).toBool())
+    {
+      const double max = get(Parameters::TruncateDistance).toDouble();
+      for (size_t k = 0; k < values.size(); ++k) values[k] = std::min(max, values[k]);
+    }
+    ofield->set_values(values);
+    return (true);
+  }
+
   detail::CalculateDistanceFieldP palgo(imesh,objmesh,ofield,this);
   auto task_i = [&palgo,this](int i) { palgo.parallel(i, Parallel::NumCores()); };
   Parallel::RunTasks(task_i, Parallel::NumCores());
@@ -481,7 +496,7 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (true);
   }
 
-  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::ELEM_LOCATE_TREE_E);
 
   if (distance->basis_order() > 2)
   {
@@ -27,6 +27,7 @@
 */
 
 #include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateSignedDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/RegularGridDistanceTransform.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
@@ -42,6 +43,69 @@ using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 
+namespace
+{
+  Vector face_normal(VMesh* objmesh, VMesh::Elem::index_type fidx)
+  {
+    VMesh::Node::array_type nodes;
+    Point n0,n1,n2;
+    objmesh->get_nodes(nodes,fidx);
+    objmesh->get_center(n0,nodes[0]);
+    objmesh->get_center(n1,nodes[1]);
+    objmesh->get_center(n2,nodes[2]);
+    return (Cross(Vector(n1-n0),Vector(n2-n1)));
+  }
+
+  /// Same side test as CalculateSignedDistanceFieldP: the normal of the
+  /// closest face decides, or that of the face across the nearest edge when
+  /// p lies in the plane of the closest face.
+  bool on_negative_side(VMesh* objmesh, double epsilon, const Point& p,
+                        const Point& closest, VMesh::Elem::index_type fidx)
+  {
+    Vector k = Vector(p-closest);
+    if (k.length2() == 0.0) return (false);
+    k.normalize();
+
+    double angle = Dot(face_normal(objmesh,fidx),k);
+    if (angle < -epsilon) return (true);
+    if (angle > epsilon) return (false);
+
+    VMesh::Node::array_type nodes;
+    VMesh::DElem::array_type delems;
+    objmesh->get_delems(delems,fidx);
+    double mindist = DBL_MAX;
+    size_t edgeidx = 0;
+    for (size_t r=0; r<delems.size(); r++)
+    {
+      Point p1, p2;
+      objmesh->get_nodes(nodes,delems[r]);
+      objmesh->get_center(p1,nodes[0]);
+      objmesh->get_center(p2,nodes[1]);
+
+      double dist;
+      if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
+      {
+        dist = Vector(p-p2).length2();
+      }
+      else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
+      {
+        dist = Vector(p-p1).length2();
+      }
+      else
+      {
+        Vector v1 = Vector(p1-p2);
+        Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
+        dist = Dot(v,v);
+      }
+      if (dist < mindist) { mindist = dist; edgeidx = r; }
+    }
+
+    VMesh::Elem::index_type fidx_n;
+    if (delems.empty() || !objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx])) return (angle < 0.0);
+    return (Dot(face_normal(objmesh,fidx_n),k) < 0.0);
+  }
+}
+
 class CalculateSignedDistanceFieldP : public Interruptible
 {
   public:
@@ -718,7 +782,31 @@ CalculateSignedDistanceFieldAlgo::run(FieldHandle input, FieldHandle object, Fie
     return (true);
   }
 
-  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::EDGES_E);
+  objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::ELEM_LOCATE_TREE_E|Mesh::EDGES_E);
+
+  // Regular grids get a distance transform instead of a search per voxel,
+  // the side is tested in the band around the surface and flooded outwards
+  RegularGridDistanceTransform edt(imesh,objmesh,ofield->basis_order(),this);
+  std::vector<double> values;
+  if (edt.run(values))
+  {
+    const std::vector<VMesh::index_type>& band = edt.band();
+    const std::vector<Point>& closest = edt.band_closest();
+    const std::vector<VMesh::Elem::index_type>& elems = edt.band_elems();
+    const double epsilon = objmesh->get_epsilon();
+
+    std::vector<char> negative(band.size());
+    Parallel::ForRange(0, band.size(), [&](size_t begin, size_t end)
+    {
+      for (size_t b = begin; b < end; ++b)
+        negative[b] = on_negative_side(objmesh, epsilon, edt.sample(band[b]), closest[b], elems[b]);
+    });
+
+    edt.propagate_sign(values, negative);
+    ofield->set_values(values);
+    return (true);
+  }
+
   CalculateSignedDistanceFieldP palgo(imesh, objmesh, ofield, this);
   const int numThreads = Parallel::NumCores();
   auto task_i = [&palgo,numThreads,this](int i) { palgo.parallel(i, numThreads); };
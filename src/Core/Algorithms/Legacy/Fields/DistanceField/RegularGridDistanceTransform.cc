@@ -0,0 +1,327 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/Legacy/Fields/DistanceField/RegularGridDistanceTransform.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Utility;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+RegularGridDistanceTransform::RegularGridDistanceTransform(VMesh* imesh, VMesh* objmesh, int basis_order, const ProgressReporter* pr) :
+  imesh_(imesh), objmesh_(objmesh), basis_order_(basis_order), pr_(pr),
+  num_samples_(0), radius_(0.0)
+{
+  n_[0] = n_[1] = n_[2] = 0;
+}
+
+bool
+RegularGridDistanceTransform::run(std::vector<double>& distance)
+{
+  if (!setup()) return (false);
+
+  // Exact distances for the band around the object
+  mark_band();
+  if (band_.empty()) return (false);
+
+  std::vector<Point> points(band_.size());
+  for (size_t b = 0; b < band_.size(); ++b) points[b] = sample(band_[b]);
+
+  std::vector<double> dist;
+  std::vector<VMesh::coords_type> coords;
+  objmesh_->mfind_closest_elem(dist, closest_, coords, elems_, points);
+  if (pr_) pr_->update_progress_max(1, 5);
+
+  // Samples within a voxel diagonal of the object seed the transform
+  std::vector<double>& f = distance;
+  f.assign(num_samples_, DBL_MAX);
+  std::vector<VMesh::index_type> feature(num_samples_, -1);
+  bool seeded = false;
+  for (size_t b = 0; b < band_.size(); ++b)
+  {
+    if (elems_[b] < 0) return (false);
+    if (dist[b] <= radius_)
+    {
+      f[band_[b]] = 0.0;
+      feature[band_[b]] = static_cast<VMesh::index_type>(b);
+      seeded = true;
+    }
+  }
+  if (!seeded) return (false);
+
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    transform_axis(axis, f, feature);
+    if (pr_) pr_->update_progress_max(axis + 2, 5);
+  }
+
+  Parallel::ForRange(0, num_samples_, [&](size_t begin, size_t end)
+  {
+    for (size_t idx = begin; idx < end; ++idx)
+    {
+      f[idx] = (sample(idx) - closest_[feature[idx]]).length();
+    }
+  });
+
+  for (size_t b = 0; b < band_.size(); ++b) f[band_[b]] = dist[b];
+
+  return (true);
+}
+
+void
+RegularGridDistanceTransform::propagate_sign(std::vector<double>& distance, const std::vector<char>& negative) const
+{
+  // Breadth first over the face neighbors, starting from the whole band
+  std::vector<signed char> side(num_samples_, -1);
+  std::vector<VMesh::index_type> queue;
+  queue.reserve(num_samples_);
+  for (size_t b = 0; b < band_.size(); ++b)
+  {
+    side[band_[b]] = negative[b];
+    queue.push_back(band_[b]);
+  }
+
+  const VMesh::index_type stride[3] = { 1, n_[0], n_[0] * n_[1] };
+  for (size_t q = 0; q < queue.size(); ++q)
+  {
+    if ((q & 0xFFFF) == 0) checkForInterruption();
+    const VMesh::index_type idx = queue[q];
+    const VMesh::index_type ijk[3] = { idx % n_[0], (idx / n_[0]) % n_[1], idx / (n_[0] * n_[1]) };
+    for (int d = 0; d < 3; ++d)
+    {
+      if (ijk[d] > 0 && side[idx - stride[d]] < 0)
+      {
+        side[idx - stride[d]] = side[idx];
+        queue.push_back(idx - stride[d]);
+      }
+      if (ijk[d] < n_[d] - 1 && side[idx + stride[d]] < 0)
+      {
+        side[idx + stride[d]] = side[idx];
+        queue.push_back(idx + stride[d]);
+      }
+    }
+  }
+
+  Parallel::ForRange(0, num_samples_, [&](size_t begin, size_t end)
+  {
+    for (size_t idx = begin; idx < end; ++idx)
+      if (side[idx] == 1) distance[idx] = -distance[idx];
+  });
+}
+
+bool
+RegularGridDistanceTransform::setup()
+{
+  // ImageMesh samples a plane, an object off that plane does not seed it
+  if (!imesh_->is_latvolmesh()) return (false);
+  if (objmesh_->num_elems() == 0) return (false);
+
+  VMesh::dimension_type dims;
+  if (basis_order_ == 0) imesh_->get_elem_dimensions(dims);
+  else if (basis_order_ == 1) imesh_->get_dimensions(dims);
+  else return (false);
+
+  if (dims.size() != 3) return (false);
+  for (int d = 0; d < 3; ++d)
+  {
+    if (dims[d] < 2) return (false);
+    n_[d] = dims[d];
+  }
+  num_samples_ = n_[0] * n_[1] * n_[2];
+
+  // The samples form a lattice origin_ + i*axis_[0] + j*axis_[1] + k*axis_[2]
+  origin_ = center(0);
+  axis_[0] = center(1) - origin_;
+  axis_[1] = center(n_[0]) - origin_;
+  axis_[2] = center(n_[0] * n_[1]) - origin_;
+
+  // The separable transform needs orthogonal axes, a sheared grid is searched
+  for (int d = 0; d < 3; ++d)
+  {
+    const Vector& a = axis_[d];
+    const Vector& b = axis_[(d + 1) % 3];
+    if (std::abs(Dot(a, b)) > 1e-8 * a.length() * b.length()) return (false);
+  }
+
+  const double det = Dot(axis_[0], Cross(axis_[1], axis_[2]));
+  if (det == 0.0) return (false);
+  inverse_[0] = Cross(axis_[1], axis_[2]) / det;
+  inverse_[1] = Cross(axis_[2], axis_[0]) / det;
+  inverse_[2] = Cross(axis_[0], axis_[1]) / det;
+  radius_ = axis_[0].length() + axis_[1].length() + axis_[2].length();
+
+  // A closest point outside the lattice may not have a seed near it
+  VMesh::Node::iterator it, eit;
+  objmesh_->begin(it);
+  objmesh_->end(eit);
+  for (; it != eit; ++it)
+  {
+    Point p;
+    objmesh_->get_center(p, *it);
+    const Vector v = p - origin_;
+    for (int d = 0; d < 3; ++d)
+    {
+      const double c = Dot(inverse_[d], v);
+      if (c < -0.5 || c > n_[d] - 0.5) return (false);
+    }
+  }
+  return (true);
+}
+
+/// Every sample within radius_ of an element lies in the element's
+/// bounding box grown by radius_, so marking those boxes covers the band.
+void
+RegularGridDistanceTransform::mark_band()
+{
+  std::vector<char> mark(num_samples_, 0);
+  double grow[3];
+  for (int d = 0; d < 3; ++d) grow[d] = radius_ * inverse_[d].length();
+
+  VMesh::Node::array_type nodes;
+  VMesh::Elem::iterator it, eit;
+  objmesh_->begin(it);
+  objmesh_->end(eit);
+  for (; it != eit; ++it)
+  {
+    checkForInterruption();
+    objmesh_->get_nodes(nodes, *it);
+    double lo[3] = { DBL_MAX, DBL_MAX, DBL_MAX };
+    double hi[3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+    for (size_t r = 0; r < nodes.size(); ++r)
+    {
+      Point p;
+      objmesh_->get_center(p, nodes[r]);
+      const Vector v = p - origin_;
+      for (int d = 0; d < 3; ++d)
+      {
+        const double c = Dot(inverse_[d], v);
+        lo[d] = std::min(lo[d], c);
+        hi[d] = std::max(hi[d], c);
+      }
+    }
+
+    VMesh::index_type b[3], e[3];
+    for (int d = 0; d < 3; ++d)
+    {
+      b[d] = std::max<VMesh::index_type>(0, static_cast<VMesh::index_type>(std::floor(lo[d] - grow[d])));
+      e[d] = std::min<VMesh::index_type>(n_[d] - 1, static_cast<VMesh::index_type>(std::ceil(hi[d] + grow[d])));
+    }
+    for (VMesh::index_type k = b[2]; k <= e[2]; ++k)
+      for (VMesh::index_type j = b[1]; j <= e[1]; ++j)
+        for (VMesh::index_type i = b[0]; i <= e[0]; ++i)
+          mark[i + n_[0] * (j + n_[1] * k)] = 1;
+  }
+
+  band_.clear();
+  for (VMesh::index_type idx = 0; idx < num_samples_; ++idx)
+    if (mark[idx]) band_.push_back(idx);
+}
+
+/// One pass of the separable transform: every line along axis becomes
+/// the lower envelope of the parabolas rooted at its finite entries.
+void
+RegularGridDistanceTransform::transform_axis(int axis, std::vector<double>& f, std::vector<VMesh::index_type>& feature)
+{
+  const VMesh::index_type stride = (axis == 0) ? 1 : ((axis == 1) ? n_[0] : n_[0] * n_[1]);
+  const VMesh::size_type len = n_[axis];
+  const VMesh::size_type num_lines = num_samples_ / len;
+  const double w = axis_[axis].length2();
+
+  Parallel::ForRange(0, num_lines, [&](size_t begin, size_t end)
+  {
+    std::vector<double> g(len), z(len + 1);
+    std::vector<VMesh::index_type> ft(len), v(len);
+    for (size_t line = begin; line < end; ++line)
+    {
+      checkForInterruption();
+      // Index of the first sample on this line
+      VMesh::index_type first;
+      if (axis == 0) first = line * n_[0];
+      else if (axis == 1) first = (line % n_[0]) + (line / n_[0]) * n_[0] * n_[1];
+      else first = line;
+
+      for (VMesh::index_type q = 0; q < len; ++q)
+      {
+        g[q] = f[first + q * stride];
+        ft[q] = feature[first + q * stride];
+      }
+
+      VMesh::index_type k = -1;
+      for (VMesh::index_type q = 0; q < len; ++q)
+      {
+        if (g[q] == DBL_MAX) continue;
+        double s = 0.0;
+        while (k >= 0)
+        {
+          const VMesh::index_type r = v[k];
+          s = ((g[q] + w * q * q) - (g[r] + w * r * r)) / (2.0 * w * (q - r));
+          if (s > z[k]) break;
+          --k;
+        }
+        ++k;
+        v[k] = q;
+        z[k] = (k == 0) ? -DBL_MAX : s;
+        z[k + 1] = DBL_MAX;
+      }
+      if (k < 0) continue;
+
+      VMesh::index_type j = 0;
+      for (VMesh::index_type q = 0; q < len; ++q)
+      {
+        while (z[j + 1] < q) ++j;
+        const VMesh::index_type r = v[j];
+        f[first + q * stride] = w * (q - r) * (q - r) + g[r];
+        feature[first + q * stride] = ft[r];
+      }
+    }
+  });
+}
+
+Point
+RegularGridDistanceTransform::center(VMesh::index_type idx) const
+{
+  Point p;
+  if (basis_order_ == 0) imesh_->get_center(p, VMesh::Elem::index_type(idx));
+  else imesh_->get_center(p, VMesh::Node::index_type(idx));
+  return (p);
+}
+
+Point
+RegularGridDistanceTransform::sample(VMesh::index_type idx) const
+{
+  const VMesh::index_type i = idx % n_[0];
+  const VMesh::index_type j = (idx / n_[0]) % n_[1];
+  const VMesh::index_type k = idx / (n_[0] * n_[1]);
+  return (origin_ + axis_[0] * static_cast<double>(i) +
+          axis_[1] * static_cast<double>(j) + axis_[2] * static_cast<double>(k));
+}
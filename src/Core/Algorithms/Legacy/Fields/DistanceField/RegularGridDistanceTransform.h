@@ -0,0 +1,104 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_REGULARGRIDDISTANCETRANSFORM_H
+#define CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_REGULARGRIDDISTANCETRANSFORM_H 1
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Thread/Interruptible.h>
+#include <Core/Utils/ProgressReporter.h>
+#include <vector>
+
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+        /// Distance from every sample of a LatVolMesh to an object mesh in time
+        /// linear in the number of samples. Samples close to the object get
+        /// their exact distance from find_closest_elem. These seed a separable
+        /// exact Euclidean distance transform (Felzenszwalb and Huttenlocher)
+        /// that carries the nearest seed along, and every other sample gets the
+        /// distance to that seed's closest point on the object. That is exact in
+        /// the band; beyond it the distance is never too small and at most one
+        /// and a half voxel diagonals too large.
+        class SCISHARE RegularGridDistanceTransform : public Core::Thread::Interruptible
+        {
+        public:
+          /// basis_order selects the samples: 0 for cell centers, 1 for nodes.
+          RegularGridDistanceTransform(VMesh* imesh, VMesh* objmesh, int basis_order, const Utility::ProgressReporter* pr);
+
+          /// Fills distance with one unsigned value per sample. Returns false
+          /// if the destination or object does not fit this method, the caller
+          /// then computes every value with find_closest_elem.
+          bool run(std::vector<double>& distance);
+
+          /// Samples that got their exact distance, in increasing order, with
+          /// the closest point and element on the object for each.
+          const std::vector<VMesh::index_type>& band() const { return band_; }
+          const std::vector<Geometry::Point>& band_closest() const { return closest_; }
+          const std::vector<VMesh::Elem::index_type>& band_elems() const { return elems_; }
+
+          /// Negates distance for the samples on the negative side of the
+          /// object. negative holds the side of every band sample; the other
+          /// samples take the side of the band samples they connect to, which
+          /// is unambiguous as the object cannot pass between two of them.
+          void propagate_sign(std::vector<double>& distance, const std::vector<char>& negative) const;
+
+          Geometry::Point sample(VMesh::index_type idx) const;
+
+        private:
+          bool setup();
+          void mark_band();
+          void transform_axis(int axis, std::vector<double>& f, std::vector<VMesh::index_type>& feature);
+          Geometry::Point center(VMesh::index_type idx) const;
+
+          VMesh*  imesh_;
+          VMesh*  objmesh_;
+          int     basis_order_;
+          const Utility::ProgressReporter* pr_;
+
+          VMesh::size_type n_[3];
+          VMesh::size_type num_samples_;
+          Geometry::Point  origin_;
+          Geometry::Vector axis_[3];
+          Geometry::Vector inverse_[3];   ///< Rows of the inverse of the lattice axes
+          double radius_;                 ///< Sum of the axis lengths, bounds a voxel diagonal
+
+          std::vector<VMesh::index_type> band_;
+          std::vector<Geometry::Point> closest_;
+          std::vector<VMesh::Elem::index_type> elems_;
+        };
+
+      }}}}
+
+#endif
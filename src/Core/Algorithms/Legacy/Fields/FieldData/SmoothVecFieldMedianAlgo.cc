@@ -27,6 +27,7 @@
 */
 
 #include <Core/Algorithms/Legacy/Fields/FieldData/SmoothVecFieldMedianAlgo.h>
+#include <Core/Algorithms/Legacy/Fields/SmoothMesh/MeshSmoother.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
@@ -34,15 +35,19 @@
 //#include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/Math/MiscMath.h>
+#include <Core/Thread/Parallel.h>
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 
+#include <algorithm>
+
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 
 bool SmoothVecFieldMedianAlgo::runImpl(FieldHandle input, FieldHandle& output) const
 {
@@ -87,109 +92,92 @@ bool SmoothVecFieldMedianAlgo::runImpl(FieldHandle input, FieldHandle& output) c
 
   if (ifield->is_vector())
   {
-    Vector v0, v1, v2, v3;
-
-    int myloc = 0;
-    bool not_on_list = false;
     auto num_values = ifield->num_values();
 
-    imesh->synchronize(Mesh::ELEM_NEIGHBORS_E);
+    // The element neighbors are extracted once; every element then gathers
+    // its neighborhood independently.
+    const MeshGraph neighbors = MeshGraph::elem_neighbors(imesh);
 
-    int cnt = 0;
-
-    for (VMesh::Elem::index_type idx = 0; idx < num_values; idx++)
+    // Elements are smoothed in parallel within blocks; progress is reported
+    // from this thread after every block.
+    const VMesh::size_type progressBlock = 4096;
+    for (VMesh::index_type first = 0; first < num_values; first += progressBlock)
     {
-      //calculate neighborhoods
-      VMesh::Elem::array_type nci, ncitot, Nlist;
-      VMesh::Elem::array_type nci2;
-      imesh->get_neighbors(nci, idx);
-
-      ncitot.push_back(idx);
-
-      for (size_t t = 0; t < nci.size(); t++)
+      const VMesh::index_type last = std::min<VMesh::index_type>(first + progressBlock, num_values);
+      Parallel::ForRange(first, last, [&](size_t begin, size_t end)
       {
-        ncitot.push_back(nci[t]);
-        imesh->get_neighbors(nci2, nci[t]);
+        Vector v0, v1, v2;
+        VMesh::Elem::array_type ncitot, Nlist;
+        std::vector<double> angles, original;
 
-        for (size_t L = 0; L < nci2.size(); L++)
+        for (VMesh::Elem::index_type idx = begin; idx < static_cast<VMesh::index_type>(end); idx++)
         {
-          ncitot.push_back(nci2[L]);
-        }
+          //calculate neighborhoods
+          ncitot.clear();
+          Nlist.clear();
+          ncitot.push_back(idx);
 
-        for (size_t t2 = 0; t2 < nci2.size(); t2++)
-        {
-          VMesh::Elem::array_type nci3;
+          for (auto t = neighbors.begin(idx); t != neighbors.end(idx); ++t)
+          {
+            ncitot.push_back(*t);
+            ncitot.insert(ncitot.end(), neighbors.begin(*t), neighbors.end(*t));
 
-          imesh->get_neighbors(nci3, nci2[t2]);
-          for (size_t L = 0; L < nci3.size(); L++)
+            for (auto t2 = neighbors.begin(*t); t2 != neighbors.end(*t); ++t2)
+            {
+              ncitot.insert(ncitot.end(), neighbors.begin(*t2), neighbors.end(*t2));
+            }
+          }
+
+          for (size_t p1 = 0; p1 < ncitot.size(); p1++)
           {
-            ncitot.push_back(nci3[L]);
+            if (std::find(Nlist.begin(), Nlist.end(), ncitot[p1]) == Nlist.end())
+            {
+              Nlist.push_back(ncitot[p1]);
+            }
           }
-        }
-      }
 
-      not_on_list = false;
-      for (size_t p1 = 0; p1 < ncitot.size(); p1++)
-      {
-        not_on_list = false;
-        for (size_t p2 = 0; p2 < Nlist.size(); p2++)
-        {
-          if (ncitot[p1] == Nlist[p2])
+          angles.clear();
+          original.clear();
+          ifield->get_value(v0, idx);
+          for (size_t q = 0; q < Nlist.size(); q++)
           {
-            not_on_list = true;
+            auto a = Nlist[q];
+            ifield->get_value(v1, a);
+            if (v0.length()*v1.length() == 0)
+            {
+              angles.push_back(0);
+              original.push_back(0);
+            }
+            else
+            {
+              auto gdot = Dot(v0, v1);
+              auto m1 = v0.length();
+              auto m2 = v1.length();
+              auto angle = (gdot / (m1*m2));
+              angles.push_back(angle);
+              original.push_back(angle);
+            }
           }
 
-        }
-        if (!not_on_list)
-        {
-          Nlist.push_back(ncitot[p1]);
-        }
-      }
+          std::sort(angles.begin(), angles.end());
+          auto middle = std::min((angles.size() + 1) / 2, angles.size() - 1);
+          size_t myloc = 0;
+          for (size_t k = 0; k < original.size(); k++)
+          {
+            if (original[k] == angles[middle])
+            {
+              myloc = k;
+              break;
+            }
+          }
 
-      std::vector<double> angles, original;
-      ifield->get_value(v0, idx);
-      for (size_t q = 0; q < Nlist.size(); q++)
-      {
-        auto a = Nlist[q];
-        ifield->get_value(v1, a);
-        if (v0.length()*v1.length() == 0)
-        {
-          angles.push_back(0);
-          original.push_back(0);
-        }
-        else
-        {
-          auto gdot = Dot(v0, v1);
-          auto m1 = v0.length();
-          auto m2 = v1.length();
-          auto angle = (gdot / (m1*m2));
-          angles.push_back(angle);
-          original.push_back(angle);
-        }
-      }
+          auto b = Nlist[myloc];
+          ifield->get_value(v2, b);
 
-      sort(angles.begin(), angles.end());
-      auto middle = (int)((angles.size() + 1) / 2);
-      for (size_t k = 0; k < original.size(); k++)
-      {
-        if (original[k] == angles[middle])
-        {
-          myloc = k;
-          k = original.size();
+          ofield->set_value(v2, idx);
         }
-      }
-
-      auto b = Nlist[myloc];
-      ifield->get_value(v2, b);
-
-      ofield->set_value(v2, idx);
-
-      cnt++;
-      if (cnt == 200)
-      {
-        cnt = 0;
-        update_progress_max(idx, num_values);
-      }
+      });
+      update_progress_max(last, num_values);
     }
   }
   return (true);
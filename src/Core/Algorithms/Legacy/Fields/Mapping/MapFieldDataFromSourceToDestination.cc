@@ -516,19 +516,19 @@ MapFieldDataFromSourceToDestinationAlgo::runImpl(FieldHandle source, FieldHandle
 
   if (method == "closestdata")
   {
-    if (sbasis_order == 0) smesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
-    else smesh->synchronize(Mesh::FIND_CLOSEST_NODE_E);
+    if (sbasis_order == 0) smesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::ELEM_LOCATE_TREE_E);
+    else smesh->synchronize(Mesh::FIND_CLOSEST_NODE_E|Mesh::NODE_LOCATE_TREE_E);
   }
   else if(method == "singledestination")
   {
-    if (dbasis_order == 0) dmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
-    else dmesh->synchronize(Mesh::FIND_CLOSEST_NODE_E);
+    if (dbasis_order == 0) dmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::ELEM_LOCATE_TREE_E);
+    else dmesh->synchronize(Mesh::FIND_CLOSEST_NODE_E|Mesh::NODE_LOCATE_TREE_E);
   }
   else if (method == "interpolateddata")
   {
     if (smesh->num_elems() > 0)
     {
-      smesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+      smesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::ELEM_LOCATE_TREE_E);
     }
     else
     {
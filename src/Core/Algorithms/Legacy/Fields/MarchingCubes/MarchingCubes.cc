@@ -40,6 +40,7 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/HexMC.h>
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/ParallelHexMC.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/UHexMC.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/PrismMC.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/TetMC.h>
@@ -289,7 +290,20 @@ bool MarchingCubesAlgo::run(FieldHandle input, const std::vector<double>& isoval
   }
   else if (fi.is_hex_element())
   {
-    if (fi.is_structuredmesh())
+    if (fi.is_structuredmesh() && ParallelHexMC::supports(input) &&
+        get(build_field).toBool() && !get(build_geometry).toBool() &&
+        !get(build_node_interpolant).toBool() && !get(build_elem_interpolant).toBool())
+    {
+      // Without interpolants the surface can be built in parallel
+      ParallelHexMC tesselator(input, this);
+      std::vector<FieldHandle> fields;
+      for (size_t j=0; j<isovalues.size(); j++)
+        fields.push_back(tesselator.extract(isovalues[j]));
+
+      AppendFieldsAlgorithm append_fields;
+      success = append_fields.run(fields,field);
+    }
+    else if (fi.is_structuredmesh())
     {
       MarchingCubesAlgoP<HexMC> algo(input,isovalues);
       success = algo.run(this,field,node_interpolant,elem_interpolant);
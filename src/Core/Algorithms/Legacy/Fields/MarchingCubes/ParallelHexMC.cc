@@ -0,0 +1,312 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/ParallelHexMC.h>
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/mcube2.h>
+
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <Core/Math/MiscMath.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Utility;
+
+namespace
+{
+  /// The cells around an edge leaving a node along x, y and z, as offsets
+  /// to the cell index of the node and the edge number within that cell.
+  const int adjacent_cells[3][4][4] = {
+    { { 0, 0, 0, 0 }, { 0,-1, 0, 2 }, { 0, 0,-1, 4 }, { 0,-1,-1, 6 } },
+    { { 0, 0, 0, 3 }, {-1, 0, 0, 1 }, { 0, 0,-1, 7 }, {-1, 0,-1, 5 } },
+    { { 0, 0, 0, 8 }, {-1, 0, 0, 9 }, { 0,-1, 0,10 }, {-1,-1, 0,11 } } };
+
+  /// For every edge of a cell: the offset in i of the node it leaves, which
+  /// of the rows (j,k), (j+1,k), (j,k+1), (j+1,k+1) that node is on, and the
+  /// axis of the edge.
+  const int cell_edges[12][3] = {
+    { 0, 0, 0 }, { 1, 0, 1 }, { 0, 1, 0 }, { 0, 0, 1 },
+    { 0, 2, 0 }, { 1, 2, 1 }, { 0, 3, 0 }, { 0, 2, 1 },
+    { 0, 0, 2 }, { 1, 0, 2 }, { 0, 1, 2 }, { 1, 1, 2 } };
+
+  inline int num_cut(unsigned char mask)
+  {
+    return ((mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1));
+  }
+
+  inline int num_triangles(unsigned char code)
+  {
+    const int* vertex = triCases[code].edges;
+    int v = 0;
+    while (vertex[v] != -1) v++;
+    return (v / 3);
+  }
+
+  template <class T>
+  void exclusive_prefix_sum(std::vector<T>& counts)
+  {
+    T sum = 0;
+    for (size_t k = 0; k < counts.size(); k++)
+    {
+      const T count = counts[k];
+      counts[k] = sum;
+      sum += count;
+    }
+  }
+}
+
+ParallelHexMC::ParallelHexMC(FieldHandle field, const ProgressReporter* pr) :
+  field_handle_(field),
+  field_(field->vfield()),
+  mesh_(field->vmesh()),
+  pr_(pr),
+  ni_(0), nj_(0), nk_(0)
+{
+  VMesh::dimension_type dims;
+  mesh_->get_dimensions(dims);
+  if (dims.size() == 3)
+  {
+    ni_ = dims[0]; nj_ = dims[1]; nk_ = dims[2];
+  }
+}
+
+bool ParallelHexMC::supports(FieldHandle field)
+{
+  if (!field) return (false);
+  VField* vfield = field->vfield();
+  VMesh* vmesh = field->vmesh();
+  if (!vfield->is_lineardata() || !vfield->is_scalar()) return (false);
+  if (!(vmesh->is_latvolmesh() || vmesh->is_structhexvolmesh())) return (false);
+
+  VMesh::dimension_type dims;
+  vmesh->get_dimensions(dims);
+  return (dims.size() == 3 && dims[0] > 1 && dims[1] > 1 && dims[2] > 1);
+}
+
+FieldHandle ParallelHexMC::extract(double iso)
+{
+  classify(iso);
+  if (pr_) pr_->update_progress_max(1, 4);
+  number_edges();
+  if (pr_) pr_->update_progress_max(2, 4);
+
+  FieldInformation fi("TriSurfMesh",1,"double");
+  FieldHandle trisurf_handle = CreateField(fi);
+  VMesh* trisurf = trisurf_handle->vmesh();
+  trisurf->resize_nodes(row_vertex_.back());
+  trisurf->resize_elems(layer_triangle_.back());
+
+  add_vertices(iso, trisurf);
+  if (pr_) pr_->update_progress_max(3, 4);
+  add_triangles(trisurf);
+
+  trisurf_handle->vfield()->resize_values();
+  trisurf_handle->vfield()->set_all_values(iso);
+  return (trisurf_handle);
+}
+
+void ParallelHexMC::classify(double iso)
+{
+  code_.assign((ni_ - 1) * (nj_ - 1) * (nk_ - 1), 0);
+  layer_triangle_.assign(nk_, 0);
+
+  const VMesh::size_type layer_size = ni_ * nj_;
+  Parallel::ForRange(0, nk_ - 1, [&](size_t begin, size_t end)
+  {
+    std::vector<double> lo(layer_size), hi(layer_size);
+    for (VMesh::index_type k = begin; k < static_cast<VMesh::index_type>(end); k++)
+    {
+      checkForInterruption();
+      field_->get_values(&lo[0], layer_size, node(0, 0, k));
+      field_->get_values(&hi[0], layer_size, node(0, 0, k + 1));
+
+      VMesh::index_type triangles = 0;
+      double value[8];
+      for (VMesh::index_type j = 0; j < nj_ - 1; j++)
+      {
+        for (VMesh::index_type i = 0; i < ni_ - 1; i++)
+        {
+          const VMesh::index_type n0 = i + ni_ * j;
+          const VMesh::index_type n3 = n0 + ni_;
+          value[0] = lo[n0]; value[1] = lo[n0 + 1]; value[2] = lo[n3 + 1]; value[3] = lo[n3];
+          value[4] = hi[n0]; value[5] = hi[n0 + 1]; value[6] = hi[n3 + 1]; value[7] = hi[n3];
+
+          int code = 0;
+          int v = 7;
+          for (; v >= 0; v--)
+          {
+            // skip anything with a NaN
+            if (IsNan(value[v])) break;
+            code = code*2 + (value[v] < iso);
+          }
+          if (v >= 0 || code == 255) code = 0;
+
+          code_[cell(i, j, k)] = static_cast<unsigned char>(code);
+          if (code) triangles += num_triangles(code);
+        }
+      }
+      layer_triangle_[k] = triangles;
+    }
+  });
+
+  exclusive_prefix_sum(layer_triangle_);
+}
+
+void ParallelHexMC::number_edges()
+{
+  cut_.assign(ni_ * nj_ * nk_, 0);
+  row_vertex_.assign(nj_ * nk_ + 1, 0);
+
+  Parallel::ForRange(0, nk_, [&](size_t begin, size_t end)
+  {
+    for (VMesh::index_type k = begin; k < static_cast<VMesh::index_type>(end); k++)
+    {
+      checkForInterruption();
+      for (VMesh::index_type j = 0; j < nj_; j++)
+      {
+        VMesh::index_type vertices = 0;
+        for (VMesh::index_type i = 0; i < ni_; i++)
+        {
+          unsigned char mask = 0;
+          for (int a = 0; a < 3; a++)
+          {
+            for (int c = 0; c < 4; c++)
+            {
+              const int* adj = adjacent_cells[a][c];
+              const VMesh::index_type ci = i + adj[0], cj = j + adj[1], ck = k + adj[2];
+              if (ci < 0 || cj < 0 || ck < 0 || ci >= ni_ - 1 || cj >= nj_ - 1 || ck >= nk_ - 1) continue;
+
+              // The cell cuts the edge if its end points are on either side
+              const int code = code_[cell(ci, cj, ck)];
+              if (code && ((code >> edge_tab[adj[3]][0]) & 1) != ((code >> edge_tab[adj[3]][1]) & 1))
+              {
+                mask |= (1 << a);
+                break;
+              }
+            }
+          }
+          cut_[node(i, j, k)] = mask;
+          vertices += num_cut(mask);
+        }
+        row_vertex_[j + nj_ * k] = vertices;
+      }
+    }
+  });
+
+  exclusive_prefix_sum(row_vertex_);
+}
+
+void ParallelHexMC::add_vertices(double iso, VMesh* trisurf)
+{
+  const VMesh::index_type stride[3] = { 1, ni_, ni_ * nj_ };
+
+  Parallel::ForRange(0, nk_, [&](size_t begin, size_t end)
+  {
+    for (VMesh::index_type k = begin; k < static_cast<VMesh::index_type>(end); k++)
+    {
+      checkForInterruption();
+      for (VMesh::index_type j = 0; j < nj_; j++)
+      {
+        VMesh::index_type vertex = row_vertex_[j + nj_ * k];
+        for (VMesh::index_type i = 0; i < ni_; i++)
+        {
+          const VMesh::index_type n0 = node(i, j, k);
+          const unsigned char mask = cut_[n0];
+          if (!mask) continue;
+
+          double v0, v1;
+          Point p0, p1;
+          field_->get_value(v0, n0);
+          mesh_->get_center(p0, VMesh::Node::index_type(n0));
+          for (int a = 0; a < 3; a++)
+          {
+            if (!(mask & (1 << a))) continue;
+            const VMesh::index_type n1 = n0 + stride[a];
+            field_->get_value(v1, n1);
+            mesh_->get_center(p1, VMesh::Node::index_type(n1));
+            const double d = (v0 - iso) / (v0 - v1);
+            trisurf->set_point(Interpolate(p0, p1, d), VMesh::Node::index_type(vertex++));
+          }
+        }
+      }
+    }
+  });
+}
+
+void ParallelHexMC::add_triangles(VMesh* trisurf)
+{
+  Parallel::ForRange(0, nk_ - 1, [&](size_t begin, size_t end)
+  {
+    VMesh::Node::array_type nodes(3);
+    VMesh::index_type surf_node[12];
+    for (VMesh::index_type k = begin; k < static_cast<VMesh::index_type>(end); k++)
+    {
+      checkForInterruption();
+      VMesh::index_type triangle = layer_triangle_[k];
+      for (VMesh::index_type j = 0; j < nj_ - 1; j++)
+      {
+        // First vertex on the nodes at i of the four rows around the cells
+        const VMesh::index_type row[4] = { node(0, j, k), node(0, j + 1, k), node(0, j, k + 1), node(0, j + 1, k + 1) };
+        VMesh::index_type first[4] = {
+          row_vertex_[j + nj_ * k], row_vertex_[j + 1 + nj_ * k],
+          row_vertex_[j + nj_ * (k + 1)], row_vertex_[j + 1 + nj_ * (k + 1)] };
+
+        for (VMesh::index_type i = 0; i < ni_ - 1; i++)
+        {
+          const int code = code_[cell(i, j, k)];
+          if (code)
+          {
+            const int* vertex = triCases[code].edges;
+            for (int v = 0; vertex[v] != -1; v++)
+            {
+              const int e = vertex[v];
+              const int* edge = cell_edges[e];
+              const int r = edge[1];
+              VMesh::index_type base = first[r];
+              if (edge[0]) base += num_cut(cut_[row[r] + i]);
+              const unsigned char mask = cut_[row[r] + i + edge[0]];
+              surf_node[e] = base + num_cut(mask & ((1 << edge[2]) - 1));
+            }
+
+            for (int v = 0; vertex[v] != -1; v += 3)
+            {
+              nodes[0] = surf_node[vertex[v]];
+              nodes[1] = surf_node[vertex[v + 1]];
+              nodes[2] = surf_node[vertex[v + 2]];
+              trisurf->set_nodes(nodes, VMesh::Elem::index_type(triangle++));
+            }
+          }
+
+          for (int r = 0; r < 4; r++) first[r] += num_cut(cut_[row[r] + i]);
+        }
+      }
+    }
+  });
+}
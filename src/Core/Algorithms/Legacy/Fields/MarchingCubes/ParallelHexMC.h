@@ -0,0 +1,99 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+ *  ParallelHexMC.h
+ *
+ *   SCI Institute
+ *   University of Utah
+ *
+ */
+
+#ifndef CORE_ALGORITHMS_LEGACY_FIELDS_MARCHINGCUBES_PARALLELHEXMC_H
+#define CORE_ALGORITHMS_LEGACY_FIELDS_MARCHINGCUBES_PARALLELHEXMC_H 1
+
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Thread/Interruptible.h>
+#include <Core/Utils/ProgressReporter.h>
+#include <vector>
+
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+
+/// Isosurface extraction for node data on LatVol and StructHexVol meshes
+/// that runs over k layers in parallel without an edge hash. A first pass
+/// stores the case of every cell, a second marks the cut edges of every
+/// node and numbers them by prefix sums over the node rows, so each cut
+/// edge has a global vertex index. Vertices and triangles are then written
+/// in parallel straight into a TriSurfMesh sized up front. The surface is
+/// the one HexMC builds, up to the order of nodes and elements.
+class SCISHARE ParallelHexMC : public Core::Thread::Interruptible
+{
+  public:
+    ParallelHexMC(FieldHandle field, const Core::Utility::ProgressReporter* pr = 0);
+
+    /// Whether field has node data on a mesh with implicit ijk topology
+    static bool supports(FieldHandle field);
+
+    /// TriSurfMesh with linear data set to iso
+    FieldHandle extract(double iso);
+
+  private:
+    void classify(double iso);
+    void number_edges();
+    void add_vertices(double iso, VMesh* trisurf);
+    void add_triangles(VMesh* trisurf);
+
+    VMesh::index_type node(VMesh::index_type i, VMesh::index_type j, VMesh::index_type k) const
+      { return (i + ni_ * (j + nj_ * k)); }
+    VMesh::index_type cell(VMesh::index_type i, VMesh::index_type j, VMesh::index_type k) const
+      { return (i + (ni_ - 1) * (j + (nj_ - 1) * k)); }
+
+    FieldHandle field_handle_;
+    VField*     field_;
+    VMesh*      mesh_;
+    const Core::Utility::ProgressReporter* pr_;
+
+    VMesh::size_type ni_, nj_, nk_;
+
+    /// Marching cubes case per cell, 0 for cells without triangles
+    std::vector<unsigned char> code_;
+    /// Bit a set when the edge along axis a leaving a node is cut
+    std::vector<unsigned char> cut_;
+    /// Index of the first vertex on every node row (j,k), and the total
+    std::vector<VMesh::index_type> row_vertex_;
+    /// Index of the first triangle in every cell layer, and the total
+    std::vector<VMesh::index_type> layer_triangle_;
+};
+
+} // namespace SCIRun
+
+#endif
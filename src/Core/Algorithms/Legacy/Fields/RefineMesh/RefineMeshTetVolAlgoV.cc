@@ -29,6 +29,7 @@
 
 #include <Core/Algorithms/Legacy/Fields/RefineMesh/RefineMesh.h>
 #include <Core/Algorithms/Legacy/Fields/RefineMesh/RefineMeshTetVolAlgoV.h> 
+#include <Core/Algorithms/Legacy/Fields/RefineMesh/SplitNodeRegistry.h>
 
 #include <Core/Datatypes/Legacy/Field/VMesh.h> 
 #include <Core/Datatypes/Legacy/Field/VField.h>
@@ -38,6 +39,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Thread/Parallel.h>
 
 //STL classes needed
 //#include <sci_hash_map.h>
@@ -52,6 +54,7 @@ using namespace SCIRun::Core::Algorithms::Fields;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Core::Thread;
 
 RefineMeshTetVolAlgoV::RefineMeshTetVolAlgoV()
 {
@@ -80,9 +83,7 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
   VField* rfield  = output->vfield();
 
   VMesh::Node::array_type onodes(4);
-  
-  mesh->synchronize(Mesh::EDGES_E);
-  
+
   VMesh::size_type num_nodes = mesh->num_nodes();
   VMesh::size_type num_elems = mesh->num_elems();
   std::vector<bool> values(num_nodes,false);
@@ -179,174 +180,192 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
     for (size_t j=0;j<values.size();j++) values[j] = true;
   }
   
-  // Copy all of the nodes from mesh to refined.  They won't change,
-  // we only add nodes.
-  
-  VMesh::Node::iterator bni, eni;
-  mesh->begin(bni); mesh->end(eni);
-  while (bni != eni)
-  {
-    Point p;
-    mesh->get_point(p, *bni);
-    refined->add_point(p);
-    ++bni;
-  }
+  // Number the new nodes on the edges that have at least one selected node,
+  // every element records its six edges in the TetVolMesh edge order. The
+  // new nodes follow the nodes of the input mesh, which won't change.
 
-  std::vector<VMesh::index_type> enodes(mesh->num_edges(),0);
+  static const int tet_edges[6][2] = { {0,1}, {1,2}, {2,0}, {0,3}, {1,3}, {2,3} };
 
-  VMesh::Node::array_type nodes(2);
-  Point p0, p1,p2, p3, p;
-  VMesh::Edge::iterator be, ee;
-  mesh->begin(be); mesh->end(ee);
+  SplitNodeRegistry enodes;
+  enodes.allocate(std::vector<VMesh::size_type>(num_elems, 6));
 
-  // add all additional nodes we need
-  while (be != ee)
+  Parallel::ForRange(0, num_elems, [&](size_t begin, size_t end)
   {
-    mesh->get_nodes(nodes,*be);
-    if ((values[nodes[0]] == true) || (values[nodes[1]] == true))
+    VMesh::Node::array_type nodes(4);
+    for (VMesh::Elem::index_type idx = begin; idx < static_cast<VMesh::index_type>(end); idx++)
     {
-      mesh->get_center(p0,nodes[0]);
-      mesh->get_center(p1,nodes[1]);
-    
-      p = (p0 + p1).asPoint()*0.5;
-    
-      enodes[*be] = refined->add_point(p);
-      if(field->basis_order() == 1)
+      mesh->get_nodes(nodes, idx);
+      const VMesh::index_type s = enodes.first_slot(idx);
+      for (int k = 0; k < 6; k++)
       {
-        ivalues.push_back(0.5*(ivalues[nodes[0]]+ivalues[nodes[1]]));
+        const VMesh::index_type a = nodes[tet_edges[k][0]];
+        const VMesh::index_type b = nodes[tet_edges[k][1]];
+        if (values[a] || values[b])
+          enodes.set(s+k, SplitNodeRegistry::edge(a, b));
       }
     }
-    ++be;
-  }
+  });
 
+  enodes.number(num_nodes);
 
-  VMesh::Edge::array_type oedges(6);
-  VMesh::Node::array_type nnodes(4);
+  const VMesh::size_type num_enodes = enodes.size();
+  refined->resize_nodes(num_nodes + num_enodes);
+  if (field->basis_order() == 1) ivalues.resize(num_nodes + num_enodes);
 
-  VMesh::Elem::iterator bi, ei;
-  mesh->begin(bi); mesh->end(ei);
-
-  unsigned int cnt = 0;
-  unsigned int loopcnt = 0;
+  Parallel::ForRange(0, num_nodes + num_enodes, [&](size_t begin, size_t end)
+  {
+    Point p0, p1;
+    for (VMesh::Node::index_type idx = begin; idx < static_cast<VMesh::index_type>(end); idx++)
+    {
+      if (idx < num_nodes)
+      {
+        mesh->get_point(p0, idx);
+        refined->set_point(p0, idx);
+        continue;
+      }
 
-  VMesh::Elem::size_type sz; mesh->size(sz);
+      const SplitNodeRegistry::key_type& key = enodes.key(idx - num_nodes);
+      mesh->get_center(p0, VMesh::Node::index_type(key.nodes[0]));
+      mesh->get_center(p1, VMesh::Node::index_type(key.nodes[1]));
+      refined->set_point((p0 + p1).asPoint()*0.5, idx);
+      if (field->basis_order() == 1)
+      {
+        ivalues[idx] = 0.5*(ivalues[key.nodes[0]]+ivalues[key.nodes[1]]);
+      }
+    }
+  });
+
+  // Split the elements in fixed chunks, each with its own list of new
+  // elements, which are appended in chunk order so the output is the same
+  // as when refining serially.
+  const size_t chunk_size = 1024;
+  const size_t num_chunks = (num_elems + chunk_size - 1) / chunk_size;
+  std::vector<std::vector<VMesh::index_type> > chunk_tets(num_chunks);
+  std::vector<std::vector<VMesh::index_type> > chunk_source(num_chunks);
+
+  auto refine_elem = [&](VMesh::Elem::index_type elem,
+                         std::vector<VMesh::index_type>& tets,
+                         std::vector<VMesh::index_type>& source)
+  {
+    auto add_tet = [&](const VMesh::Node::array_type& n)
+    {
+      tets.insert(tets.end(), n.begin(), n.end());
+      source.push_back(elem);
+    };
 
+    VMesh::Node::array_type onodes(4);
+    VMesh::Node::array_type nnodes(4);
+    mesh->get_nodes(onodes, elem);
 
-  while (bi != ei)
-  {
-			cnt++; if (cnt == 100) { loopcnt +=cnt; cnt = 0;}// algo->update_progress(loopcnt,sz);  }
-    mesh->get_nodes(onodes, *bi);
-    mesh->get_edges(oedges, *bi);
+    VMesh::index_type ie[6];
+    const VMesh::index_type s = enodes.first_slot(elem);
+    for (int k = 0; k < 6; k++)
+    {
+      const VMesh::index_type n = enodes[s+k];
+      ie[k] = (n < 0) ? 0 : num_nodes + n;
+    }
 
     VMesh::index_type i0 = onodes[0];
     VMesh::index_type i1 = onodes[1];
     VMesh::index_type i2 = onodes[2];
     VMesh::index_type i3 = onodes[3];
-    VMesh::index_type i4 = enodes[oedges[0]];
-    VMesh::index_type i5 = enodes[oedges[1]];
-    VMesh::index_type i6 = enodes[oedges[2]];
-    VMesh::index_type i7 = enodes[oedges[3]];
-    VMesh::index_type i8 = enodes[oedges[4]];
-    VMesh::index_type i9 = enodes[oedges[5]];
+    VMesh::index_type i4 = ie[0];
+    VMesh::index_type i5 = ie[1];
+    VMesh::index_type i6 = ie[2];
+    VMesh::index_type i7 = ie[3];
+    VMesh::index_type i8 = ie[4];
+    VMesh::index_type i9 = ie[5];
 
     if (i4==0 && i5 == 0 && i6 == 0 && i7==0 && i8 == 0 && i9 == 0)
     {
-      refined->add_elem(onodes);
-      if(field->basis_order() == 0) evalues.push_back(ivalues[*bi]);
+      add_tet(onodes);
     }
     else if (i4 > 0 && i5 > 0 && i6 > 0 && i7 > 0 && i8 > 0 && i9 > 0)
     {
       nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i5; nnodes[3] = i8;
-      refined->add_elem(nnodes);
+      add_tet(nnodes);
       nnodes[0] =i4; nnodes[1] = i8; nnodes[2] = i5; nnodes[3] = i7;
-      refined->add_elem(nnodes);
+      add_tet(nnodes);
       nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i5; nnodes[3] = i9;
-      refined->add_elem(nnodes);
+      add_tet(nnodes);
       nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i5; nnodes[3] = i7;
-      refined->add_elem(nnodes);
+      add_tet(nnodes);
       nnodes[0] =i6; nnodes[1] = i7; nnodes[2] = i5; nnodes[3] = i9;
-      refined->add_elem(nnodes);
+      add_tet(nnodes);
       nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-      refined->add_elem(nnodes);
+      add_tet(nnodes);
       nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i3;
-      refined->add_elem(nnodes);
+      add_tet(nnodes);
       nnodes[0] =i6; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i9;
-      refined->add_elem(nnodes);
-      if(field->basis_order() == 0) evalues.insert(evalues.end(),8,ivalues[*bi]);
+      add_tet(nnodes);
     }
     else if (i5 == 0 && i8 == 0 && i9 == 0)
     {
       if ( i1 < i2 && i2 <i3)
       { //Checked orientation
         nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);
       }
       else if (i1 < i3 && i3 < i2)
       { // checked orientation
         nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i1; nnodes[2] = i6; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);      
       }
       else if (i2< i1 && i1 < i3)
       { // checked orientation
         nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i1;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
-        refined->add_elem(nnodes);            
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);            
       }
       else if (i2 < i3 && i3 < i1)
       { // checked orientation
         nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i3; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i1;
-        refined->add_elem(nnodes);                  
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                  
       }
       else if (i3 < i1 && i1 < i2)
       { // checked orientation
         nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i1; nnodes[1] = i6; nnodes[2] = i4; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i1; nnodes[1] = i2; nnodes[2] = i6; nnodes[3] = i3;
-        refined->add_elem(nnodes);                        
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                        
       }
       else
       { // checked orientation
         nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i6; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i3;
-        refined->add_elem(nnodes);                              
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                              
       }
     }
     else if (i4 == 0 && i7 == 0 && i8 == 0)
@@ -354,74 +373,68 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
       if ( i0 < i1 && i1 <i3)
       { //Checked orientation
         nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i0; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);
       }
       else if (i0 < i3 && i3 < i1)
       { // checked orientation
         nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i0; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i0; nnodes[2] = i5; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);      
       }
       else if (i1< i0 && i0 < i3)
       { // checked orientation
         nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
-        refined->add_elem(nnodes);            
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);            
       }
       else if (i1 < i3 && i3 < i0)
       { // checked orientation
         nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i3; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);                  
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                  
       }
       else if (i3 < i0 && i0 < i1)
       { // checked orientation
         nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i0; nnodes[1] = i5; nnodes[2] = i6; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i0; nnodes[1] = i1; nnodes[2] = i5; nnodes[3] = i3;
-        refined->add_elem(nnodes);                        
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                        
       }
       else
       { // checked orientation
         nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i5; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i3;
-        refined->add_elem(nnodes);                              
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                              
       }
     }
     else if (i6 == 0 && i9 == 0 && i7 == 0)
@@ -429,74 +442,68 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
       if ( i2 < i0 && i0 <i3)
       { //Checked orientation
         nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i2; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);
       }
       else if (i2 < i3 && i3 < i0)
       { // checked orientation
         nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i2; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i4; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);      
       }
       else if (i0< i2 && i2 < i3)
       { // checked orientation
         nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i2;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
-        refined->add_elem(nnodes);            
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);            
       }
       else if (i0 < i3 && i3 < i2)
       { // checked orientation
         nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i3; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i2;
-        refined->add_elem(nnodes);                  
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                  
       }
       else if (i3 < i2 && i2 < i0)
       { // checked orientation
         nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i2; nnodes[1] = i4; nnodes[2] = i5; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i2; nnodes[1] = i0; nnodes[2] = i4; nnodes[3] = i3;
-        refined->add_elem(nnodes);                        
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                        
       }
       else
       { // checked orientation
         nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i4; nnodes[3] = i3;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i3;
-        refined->add_elem(nnodes);                              
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                              
       }
     }
     else if (i5 == 0 && i6 == 0 && i4 == 0)
@@ -504,74 +511,68 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
       if ( i2 < i1 && i1 <i0)
       { //Checked orientation
         nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i2; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);
       }
       else if (i2 < i0 && i0 < i1)
       { // checked orientation
         nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i2; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i8; nnodes[3] = i0;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);      
       }
       else if (i1< i2 && i2 < i0)
       { // checked orientation
         nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i2;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);            
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);            
       }
       else if (i1 < i0 && i0 < i2)
       { // checked orientation
         nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i0; nnodes[1] = i9; nnodes[2] = i1; nnodes[3] = i2;
-        refined->add_elem(nnodes);                  
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                  
       }
       else if (i0 < i2 && i2 < i1)
       { // checked orientation
         nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i8; nnodes[2] = i7; nnodes[3] = i0;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i2; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i0;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i2; nnodes[1] = i1; nnodes[2] = i8; nnodes[3] = i0;
-        refined->add_elem(nnodes);                        
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                        
       }
       else
       { // checked orientation
         nnodes[0] =i3; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i8; nnodes[2] = i7; nnodes[3] = i0;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i1; nnodes[2] = i8; nnodes[3] = i0;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i2; nnodes[2] = i1; nnodes[3] = i0;
-        refined->add_elem(nnodes);                              
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),4,ivalues[*bi]);
+        add_tet(nnodes);                              
       }
     }
     else if (i8 == 0)
@@ -579,38 +580,36 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
       if (i1 < i3)
       {
         nnodes[0] =i2; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i6;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i1; nnodes[2] = i3; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i5; nnodes[2] = i1; nnodes[3] = i4;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i4;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i9; nnodes[1] = i4; nnodes[2] = i1; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i7; nnodes[2] = i6; nnodes[3] = i0;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);
       }
       else
       {
         nnodes[0] =i2; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i6;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i3; nnodes[1] = i5; nnodes[2] = i1; nnodes[3] = i4;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i3; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i5; nnodes[2] = i3; nnodes[3] = i7;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i9; nnodes[1] = i5; nnodes[2] = i7; nnodes[3] = i6;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i7; nnodes[2] = i6; nnodes[3] = i4;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i7; nnodes[3] = i0;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);      
       }
     }
     else if (i9 == 0)
@@ -618,38 +617,36 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
       if (i2 < i3)
       {
         nnodes[0] =i0; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i4;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i2; nnodes[2] = i3; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i6; nnodes[2] = i2; nnodes[3] = i5;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i5;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i7; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i8; nnodes[2] = i4; nnodes[3] = i1;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);
       }
       else
       {
         nnodes[0] =i0; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i4;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i3; nnodes[1] = i6; nnodes[2] = i2; nnodes[3] = i5;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i3; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i6; nnodes[2] = i3; nnodes[3] = i8;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i7; nnodes[1] = i6; nnodes[2] = i8; nnodes[3] = i4;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i8; nnodes[2] = i4; nnodes[3] = i5;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i8; nnodes[3] = i1;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);      
       }
     }
     else if (i7 == 0)
@@ -657,38 +654,36 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
       if (i0 < i3)
       {
         nnodes[0] =i1; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i5;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i0; nnodes[2] = i3; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i4; nnodes[2] = i0; nnodes[3] = i6;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i6;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i8; nnodes[1] = i6; nnodes[2] = i0; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i9; nnodes[2] = i5; nnodes[3] = i2;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);
       }
       else
       {
         nnodes[0] =i1; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i5;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i3; nnodes[1] = i4; nnodes[2] = i0; nnodes[3] = i6;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i3; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i4; nnodes[2] = i3; nnodes[3] = i9;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i8; nnodes[1] = i4; nnodes[2] = i9; nnodes[3] = i5;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i9; nnodes[2] = i5; nnodes[3] = i6;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i9; nnodes[3] = i2;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);      
       }
     }
     else if (i6 == 0)
@@ -696,38 +691,36 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
       if (i2 < i0)
       {
         nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i2; nnodes[2] = i0; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i8; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i4; nnodes[1] = i9; nnodes[2] = i2; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i9; nnodes[2] = i8; nnodes[3] = i4;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i7; nnodes[2] = i8; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);
       }
       else
       {
         nnodes[0] =i1; nnodes[1] = i5; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i0; nnodes[1] = i5; nnodes[2] = i2; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i0; nnodes[1] = i5; nnodes[2] = i9; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i0; nnodes[3] = i7;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i4; nnodes[1] = i5; nnodes[2] = i7; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i7; nnodes[2] = i8; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i7; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);      
       }
     }
     else if (i5 == 0)
@@ -735,38 +728,36 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
       if (i1 < i2)
       {
         nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i1; nnodes[2] = i2; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i1; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i7; nnodes[2] = i4; nnodes[3] = i8;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i6; nnodes[1] = i8; nnodes[2] = i1; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i8; nnodes[2] = i7; nnodes[3] = i6;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i9; nnodes[2] = i7; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);
       }
       else
       {
         nnodes[0] =i0; nnodes[1] = i4; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i2; nnodes[1] = i4; nnodes[2] = i1; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i2; nnodes[1] = i4; nnodes[2] = i8; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i2; nnodes[3] = i9;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i6; nnodes[1] = i4; nnodes[2] = i9; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i4; nnodes[1] = i9; nnodes[2] = i7; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);      
       }
     }
     else if (i4 == 0)
@@ -774,42 +765,74 @@ RefineMeshTetVolAlgoV::runImpl(FieldHandle input, FieldHandle& output,
       if (i0 < i1)
       {
         nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i0; nnodes[2] = i1; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i0; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i9; nnodes[2] = i6; nnodes[3] = i7;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i5; nnodes[1] = i7; nnodes[2] = i0; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i8; nnodes[1] = i7; nnodes[2] = i9; nnodes[3] = i5;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i7; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i3;
-        refined->add_elem(nnodes);
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);
       }
       else
       {
         nnodes[0] =i2; nnodes[1] = i6; nnodes[2] = i5; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i1; nnodes[1] = i6; nnodes[2] = i0; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i1; nnodes[1] = i6; nnodes[2] = i7; nnodes[3] = i8;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i1; nnodes[3] = i8;
-        refined->add_elem(nnodes);                              
+        add_tet(nnodes);                              
         nnodes[0] =i5; nnodes[1] = i6; nnodes[2] = i8; nnodes[3] = i9;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i6; nnodes[1] = i8; nnodes[2] = i9; nnodes[3] = i7;
-        refined->add_elem(nnodes);
+        add_tet(nnodes);
         nnodes[0] =i9; nnodes[1] = i7; nnodes[2] = i8; nnodes[3] = i3;
-        refined->add_elem(nnodes);      
-        if(field->basis_order() == 0) evalues.insert(evalues.end(),7,ivalues[*bi]);
+        add_tet(nnodes);      
       }
     }
-    ++bi;
-  }
+  };
+
+  Parallel::ForRange(0, num_chunks, [&](size_t begin, size_t end)
+  {
+    for (size_t c = begin; c < end; c++)
+    {
+      const VMesh::index_type last = std::min<VMesh::index_type>(num_elems, (c + 1) * chunk_size);
+      for (VMesh::Elem::index_type idx = c * chunk_size; idx < last; idx++)
+        refine_elem(idx, chunk_tets[c], chunk_source[c]);
+    }
+  }, 1);
+
+  std::vector<VMesh::size_type> chunk_offsets(num_chunks);
+  for (size_t c = 0; c < num_chunks; c++)
+    chunk_offsets[c] = static_cast<VMesh::size_type>(chunk_source[c].size());
+  const VMesh::size_type num_tets = SplitNodeRegistry::exclusive_scan(chunk_offsets);
+
+  refined->resize_elems(num_tets);
+  if (field->basis_order() == 0) evalues.resize(num_tets);
+
+  Parallel::ForRange(0, num_chunks, [&](size_t begin, size_t end)
+  {
+    VMesh::Node::array_type nnodes(4);
+    for (size_t c = begin; c < end; c++)
+    {
+      const std::vector<VMesh::index_type>& tets = chunk_tets[c];
+      const std::vector<VMesh::index_type>& source = chunk_source[c];
+      for (size_t t = 0; t < source.size(); t++)
+      {
+        const VMesh::Elem::index_type idx(chunk_offsets[c] + t);
+        for (size_t k = 0; k < 4; k++) nnodes[k] = tets[4*t + k];
+        refined->set_nodes(nnodes, idx);
+        if (field->basis_order() == 0) evalues[idx] = ivalues[source[t]];
+      }
+    }
+  }, 1);
 
   rfield->resize_values();
   if (rfield->basis_order() == 0) rfield->set_values(evalues);
@@ -0,0 +1,145 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   */
+
+#include <Core/Algorithms/Legacy/Fields/RefineMesh/SplitNodeRegistry.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Thread;
+
+SplitNodeRegistry::key_type
+SplitNodeRegistry::none()
+{
+  key_type key;
+  key.nodes[0] = key.nodes[1] = key.nodes[2] = -1;
+  key.code = -1;
+  return key;
+}
+
+SplitNodeRegistry::key_type
+SplitNodeRegistry::node(VMesh::index_type n)
+{
+  key_type key = none();
+  key.nodes[0] = n;
+  return key;
+}
+
+SplitNodeRegistry::key_type
+SplitNodeRegistry::edge(VMesh::index_type a, VMesh::index_type b)
+{
+  key_type key = none();
+  key.nodes[0] = std::min(a, b);
+  key.nodes[1] = std::max(a, b);
+  return key;
+}
+
+SplitNodeRegistry::key_type
+SplitNodeRegistry::face(VMesh::index_type a, VMesh::index_type b, VMesh::index_type c)
+{
+  key_type key = none();
+  if (a > b) std::swap(a, b);
+  if (b > c) std::swap(b, c);
+  if (a > b) std::swap(a, b);
+  key.nodes[0] = a;
+  key.nodes[1] = b;
+  key.nodes[2] = c;
+  return key;
+}
+
+int
+SplitNodeRegistry::arity(const key_type& key)
+{
+  int n = 0;
+  while (n < 3 && key.nodes[n] >= 0) n++;
+  return n;
+}
+
+VMesh::size_type
+SplitNodeRegistry::exclusive_scan(std::vector<VMesh::size_type>& counts)
+{
+  VMesh::size_type total = 0;
+  for (size_t i = 0; i < counts.size(); ++i)
+  {
+    const VMesh::size_type count = counts[i];
+    counts[i] = total;
+    total += count;
+  }
+  return total;
+}
+
+VMesh::size_type
+SplitNodeRegistry::allocate(const std::vector<VMesh::size_type>& slots_per_element)
+{
+  offsets_.assign(slots_per_element.begin(), slots_per_element.end());
+  offsets_.push_back(0);
+  const VMesh::size_type total = exclusive_scan(offsets_);
+  offsets_.back() = total;
+
+  slots_.resize(total);
+  const key_type unset = none();
+  Parallel::ForRange(0, total, [&](size_t begin, size_t end)
+  {
+    std::fill(slots_.begin() + begin, slots_.begin() + end, unset);
+  });
+  nodes_.clear();
+  keys_.clear();
+  return total;
+}
+
+void
+SplitNodeRegistry::number(VMesh::size_type num_source_nodes)
+{
+  const size_t total = slots_.size();
+  Parallel::ForRange(0, total, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+      slots_[i].code = static_cast<index_type>(i);
+  });
+
+  // Unset slots are dropped by the sort as their first node is negative.
+  std::vector<index_type> runs;
+  MeshTableBuilder::sort_unique(slots_, num_source_nodes, runs);
+
+  const size_t num_keys = runs.size() - 1;
+  nodes_.assign(total, -1);
+  keys_.resize(num_keys);
+  Parallel::ForRange(0, num_keys, [&](size_t begin, size_t end)
+  {
+    for (size_t r = begin; r < end; ++r)
+    {
+      keys_[r] = slots_[runs[r]];
+      for (index_type i = runs[r]; i < runs[r + 1]; ++i)
+        nodes_[slots_[i].code] = static_cast<VMesh::index_type>(r);
+    }
+  });
+
+  std::vector<key_type>().swap(slots_);
+}
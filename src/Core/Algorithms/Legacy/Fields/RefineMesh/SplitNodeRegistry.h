@@ -0,0 +1,100 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   */
+
+#ifndef CORE_ALGORITHMS_FIELDS_REFINEMESH_SPLITNODEREGISTRY_H
+#define CORE_ALGORITHMS_FIELDS_REFINEMESH_SPLITNODEREGISTRY_H 1
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTableBuilder.h>
+#include <vector>
+
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun{
+  namespace Core{
+    namespace Algorithms{
+      namespace Fields{
+
+        /// Numbers the nodes created when elements are split: kept nodes of
+        /// the source mesh, points on cut edges and points on cut faces.
+        /// It replaces the per-edge hash map lookups of the serial clipping
+        /// and refinement loops.
+        ///
+        /// Every element owns a fixed range of key slots, sized up front by
+        /// allocate(). Elements fill their slots in parallel, number() sorts
+        /// the keys and assigns one node per distinct key, and elements then
+        /// read the node of every slot back, also in parallel. Nodes are
+        /// numbered in key order, so the result does not depend on the
+        /// number of threads.
+        class SCISHARE SplitNodeRegistry
+        {
+          public:
+            typedef MeshTableEntry<3> key_type;
+
+            /// Slots left unset (or set to none()) are not numbered.
+            static key_type none();
+            static key_type node(VMesh::index_type n);
+            static key_type edge(VMesh::index_type a, VMesh::index_type b);
+            static key_type face(VMesh::index_type a, VMesh::index_type b, VMesh::index_type c);
+
+            /// Number of source nodes in the key, 0 for none()
+            static int arity(const key_type& key);
+
+            /// Sizes the slots from the per-element slot counts, and
+            /// returns the total number of slots.
+            VMesh::size_type allocate(const std::vector<VMesh::size_type>& slots_per_element);
+
+            VMesh::index_type first_slot(VMesh::index_type elem) const { return offsets_[elem]; }
+            void set(VMesh::index_type slot, const key_type& key) { slots_[slot] = key; }
+
+            /// Assigns the nodes, num_source_nodes bounds the node indices
+            /// used in the keys.
+            void number(VMesh::size_type num_source_nodes);
+
+            /// Node of a slot, -1 if it was not set
+            VMesh::index_type operator[](VMesh::index_type slot) const { return nodes_[slot]; }
+
+            VMesh::size_type size() const { return static_cast<VMesh::size_type>(keys_.size()); }
+            const key_type& key(VMesh::index_type node) const { return keys_[node]; }
+
+            /// Turns counts into offsets in place, and returns the total
+            static VMesh::size_type exclusive_scan(std::vector<VMesh::size_type>& counts);
+
+          private:
+            std::vector<VMesh::index_type> offsets_;
+            std::vector<key_type> slots_;
+            std::vector<VMesh::index_type> nodes_;
+            std::vector<key_type> keys_;
+        };
+
+      }
+    }
+  }
+}
+
+#endif
@@ -27,6 +27,7 @@
 
 
 #include <Core/Algorithms/Legacy/Fields/SmoothMesh/FairMesh.h>
+#include <Core/Algorithms/Legacy/Fields/SmoothMesh/MeshSmoother.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
@@ -88,163 +89,37 @@ bool FairMeshAlgo::runImpl(FieldHandle input,FieldHandle& output) const
   VMesh::size_type num_nodes = mesh->num_nodes();
   mesh->unsynchronize(Mesh::NORMALS_E);
 
+  // The neighborhoods are extracted once, every iteration is a parallel
+  // sweep over them.
+  MeshGraph neighborhoods;
+  double epsilon = 0.0;
   if (method == "fast")
   {
     // Fast neighborhoods
-    std::vector<VMesh::Node::array_type > neighborhoods(num_nodes);
-    mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
-
-    for (VMesh::Node::index_type idx=0; idx<num_nodes; idx++)
-    {
-      mesh->get_neighbors(neighborhoods[idx],idx);
-    }
-
-    std::vector<Vector> disp(num_nodes);
-    Point*  point = mesh->get_points_pointer();
-    Point p0;
-    for (int it = 0; it<num_iter; it++)
-    {
-      for (VMesh::index_type idx=0; idx<num_nodes;idx++)
-      {
-        p0 = point[idx];
-        Vector d(0.0,0.0,0.0);
-        VMesh::Node::array_type &neighbors = neighborhoods[idx];
-        double w = 1.0/(neighbors.size());
-        for (size_t j=0; j<neighbors.size(); j++)
-        {
-          d += w* (point[neighbors[j]]-p0);
-        }
-        disp[idx] = d;
-      }
-
-      if (it % 2 == 0)
-      {
-        for (VMesh::Node::index_type idx=0; idx<num_nodes;idx++)
-          point[idx] = point[idx]+ lambda*disp[idx];
-      }  
-      else
-      {
-        for (VMesh::Node::index_type idx=0; idx<num_nodes;idx++)
-          point[idx] = point[idx]+  mu*disp[idx];      
-      }
-      update_progress_max(it,num_iter);
-    }
+    neighborhoods = MeshGraph::node_neighbors(mesh);
   }
   else
   {
     // desbrun method
-    std::vector<std::vector<std::pair<VMesh::index_type,VMesh::index_type> > > neighborhoods(num_nodes);
-    mesh->synchronize(Mesh::NODE_NEIGHBORS_E|Mesh::EPSILON_E);
-
-    VMesh::Elem::array_type elems;
-    VMesh::Node::array_type nodes;
-
-    for (VMesh::Node::index_type idx=0; idx<num_nodes; idx++)
-    {
-      std::vector<std::pair<VMesh::index_type,VMesh::index_type> > &neighborhood = neighborhoods[idx];
-      mesh->get_elems(elems,idx);
-      for (size_t j = 0; j<elems.size(); j++)
-      {
-        mesh->get_nodes(nodes,elems[j]);
-        // make it circular
-        nodes.push_back(nodes[0]);
- 
-        for (size_t k=1;k < nodes.size();k++)
-        {
-          // get all edges that are not connected to the node itself
-          if(nodes[k-1] != idx && nodes[k] != idx)
-          {
-            neighborhood.push_back(std::pair<VMesh::index_type,VMesh::index_type>(nodes[k-1],nodes[k]));
-          }
-        }
-      }
-    }
-    
-    std::vector<Vector> disp(num_nodes);
-    Point*  point = mesh->get_points_pointer();
-    Point p0;
+    mesh->synchronize(Mesh::EPSILON_E);
+    neighborhoods = MeshGraph::opposite_edges(mesh);
+    epsilon = mesh->get_epsilon();
+  }
 
-    double epsilon = mesh->get_epsilon();
+  Point* point = mesh->get_points_pointer();
+  MeshSmoother smoother(point, num_nodes);
 
-    for (int it = 0; it<num_iter; it++)
-    {
-    
-      for (VMesh::index_type idx=0; idx<num_nodes;idx++)
-      {
-        // Center location of this node
-        p0 = point[idx];
-        Vector d(0.0,0.0,0.0);
-        
-        // neighborhood points
-        Point p1, p2, p3;
-        Vector p12;
-        
-        // get local neighborhood pairs
-        const std::vector<std::pair<VMesh::index_type,VMesh::index_type> > &neighborhood = neighborhoods[idx];
-        
-        // if no neighborhood continue
-        if (neighborhood.empty()) continue;
-  
-        // total weight
-        double totw = 0.0;
-    
-        for (size_t j = 0; j < neighborhood.size(); j++) 
-        {
-          p1 = point[neighborhood[j].first];
-          p2 = point[neighborhood[j].second];
+  for (int it = 0; it<num_iter; it++)
+  {
+    if (method == "fast") smoother.umbrella(neighborhoods);
+    else smoother.curvature_flow(neighborhoods, epsilon);
 
-          // vectors pointing to the two neighbor nodes
-          Vector e1 = p2-p0;
-          Vector e2 = p1-p0;
-          
-          // Get vector between neighbors
-          p12 = p1-p2;
-          
-          // Squared distance between neighbors
-          double e = Dot(p12,p12);
-          
-          if (e > 0.0)
-          {
-            double dot = Dot(p1-p0,p12)/e;
-            p3 = p1 - dot*p12;
-            
-            double A = (p1-p3).length();
-            double B = (p0-p3).length();
-            double C = (p2-p3).length();
-            
-            // if B approaches zero, we have a flat
-            // triangle, hence we need to bounce back the node 
-            // towards the other side. Hence ignoring these
-            // directions
-            if (B >= 10*epsilon)
-            {
-              if (dot < 0.0) A = -A;
-              if (dot > 1.0) C = -C;
-              totw += (A+C)/B;
-         
-              d += (A/B)*e1 + (C/B)*e2;
-            }
-          }
-        }
+    smoother.displace((it % 2 == 0) ? lambda : mu);
+    update_progress_max(it,num_iter);
+  }
 
-        /// set the displacement vector for this node.
-        if (totw != 0.0) disp[idx] = d * (1.0 / totw);
-      }
+  smoother.get_points(point);
 
-      if (it % 2 == 0)
-      {
-        for (VMesh::Node::index_type idx=0; idx<num_nodes;idx++)
-          point[idx] = point[idx]+ lambda*disp[idx];
-      }  
-      else
-      {
-        for (VMesh::Node::index_type idx=0; idx<num_nodes;idx++)
-          point[idx] = point[idx]+  mu*disp[idx];      
-      }
-      update_progress_max(it,num_iter);
-    }
-  }
-  
   return (true);
 } 
 
@@ -0,0 +1,255 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/Legacy/Fields/SmoothMesh/MeshSmoother.h>
+#include <Core/Thread/Parallel.h>
+
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+template <class FILL>
+MeshGraph
+MeshGraph::build(VMesh::size_type size, FILL fill)
+{
+  // Gather every row once to size it and once more to copy it, so the rows
+  // never need to be kept in memory at the same time.
+  MeshGraph graph;
+  graph.offsets_.assign(size + 1, 0);
+  Parallel::ForRange(0, size, [&](size_t begin, size_t end)
+  {
+    std::vector<VMesh::index_type> row;
+    for (size_t i = begin; i < end; ++i)
+    {
+      fill(static_cast<VMesh::index_type>(i), row);
+      graph.offsets_[i + 1] = static_cast<VMesh::index_type>(row.size());
+    }
+  });
+
+  for (VMesh::size_type i = 0; i < size; ++i)
+    graph.offsets_[i + 1] += graph.offsets_[i];
+
+  graph.adjacency_.resize(graph.offsets_[size] + 1);
+  Parallel::ForRange(0, size, [&](size_t begin, size_t end)
+  {
+    std::vector<VMesh::index_type> row;
+    for (size_t i = begin; i < end; ++i)
+    {
+      fill(static_cast<VMesh::index_type>(i), row);
+      std::copy(row.begin(), row.end(), graph.adjacency_.begin() + graph.offsets_[i]);
+    }
+  });
+  return graph;
+}
+
+MeshGraph
+MeshGraph::node_neighbors(VMesh* mesh)
+{
+  mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+  return build(mesh->num_nodes(), [mesh](VMesh::index_type idx, std::vector<VMesh::index_type>& row)
+  {
+    VMesh::Node::array_type neighbors;
+    mesh->get_neighbors(neighbors, VMesh::Node::index_type(idx));
+    row.assign(neighbors.begin(), neighbors.end());
+  });
+}
+
+MeshGraph
+MeshGraph::elem_neighbors(VMesh* mesh)
+{
+  mesh->synchronize(Mesh::ELEM_NEIGHBORS_E);
+  return build(mesh->num_elems(), [mesh](VMesh::index_type idx, std::vector<VMesh::index_type>& row)
+  {
+    VMesh::Elem::array_type neighbors;
+    mesh->get_neighbors(neighbors, VMesh::Elem::index_type(idx));
+    row.assign(neighbors.begin(), neighbors.end());
+  });
+}
+
+MeshGraph
+MeshGraph::opposite_edges(VMesh* mesh)
+{
+  mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+  return build(mesh->num_nodes(), [mesh](VMesh::index_type idx, std::vector<VMesh::index_type>& row)
+  {
+    VMesh::Elem::array_type elems;
+    VMesh::Node::array_type nodes;
+    row.clear();
+    mesh->get_elems(elems, VMesh::Node::index_type(idx));
+    for (size_t j = 0; j < elems.size(); j++)
+    {
+      mesh->get_nodes(nodes, elems[j]);
+      // make it circular
+      nodes.push_back(nodes[0]);
+      for (size_t k = 1; k < nodes.size(); k++)
+      {
+        // get all edges that are not connected to the node itself
+        if (nodes[k-1] != idx && nodes[k] != idx)
+        {
+          row.push_back(nodes[k-1]);
+          row.push_back(nodes[k]);
+        }
+      }
+    }
+  });
+}
+
+
+MeshSmoother::MeshSmoother(const Point* points, VMesh::size_type num_nodes) :
+  num_nodes_(num_nodes),
+  x_(num_nodes), y_(num_nodes), z_(num_nodes),
+  dx_(num_nodes, 0.0), dy_(num_nodes, 0.0), dz_(num_nodes, 0.0)
+{
+  Parallel::ForRange(0, num_nodes_, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      x_[i] = points[i].x(); y_[i] = points[i].y(); z_[i] = points[i].z();
+    }
+  });
+}
+
+void
+MeshSmoother::get_points(Point* points) const
+{
+  Parallel::ForRange(0, num_nodes_, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+      points[i] = Point(x_[i], y_[i], z_[i]);
+  });
+}
+
+void
+MeshSmoother::umbrella(const MeshGraph& neighbors)
+{
+  const double* x = &x_[0];
+  const double* y = &y_[0];
+  const double* z = &z_[0];
+
+  Parallel::ForRange(0, num_nodes_, [&](size_t begin, size_t end)
+  {
+    for (VMesh::index_type i = begin; i < static_cast<VMesh::index_type>(end); ++i)
+    {
+      const VMesh::index_type* n = neighbors.begin(i);
+      const VMesh::size_type deg = neighbors.degree(i);
+      double sx = 0.0, sy = 0.0, sz = 0.0;
+      for (VMesh::size_type j = 0; j < deg; ++j)
+      {
+        sx += x[n[j]];
+        sy += y[n[j]];
+        sz += z[n[j]];
+      }
+      if (deg == 0)
+      {
+        dx_[i] = dy_[i] = dz_[i] = 0.0;
+        continue;
+      }
+      const double w = 1.0 / deg;
+      dx_[i] = w * sx - x[i];
+      dy_[i] = w * sy - y[i];
+      dz_[i] = w * sz - z[i];
+    }
+  });
+}
+
+void
+MeshSmoother::curvature_flow(const MeshGraph& opposite_edges, double epsilon)
+{
+  Parallel::ForRange(0, num_nodes_, [&](size_t begin, size_t end)
+  {
+    for (VMesh::index_type i = begin; i < static_cast<VMesh::index_type>(end); ++i)
+    {
+      const VMesh::index_type* e = opposite_edges.begin(i);
+      const VMesh::size_type num_pairs = opposite_edges.degree(i) / 2;
+
+      // if no neighborhood continue
+      if (num_pairs == 0) continue;
+
+      const Point p0(x_[i], y_[i], z_[i]);
+      Vector d(0.0, 0.0, 0.0);
+      double totw = 0.0;
+
+      for (VMesh::size_type j = 0; j < num_pairs; ++j)
+      {
+        const Point p1(x_[e[2*j]], y_[e[2*j]], z_[e[2*j]]);
+        const Point p2(x_[e[2*j+1]], y_[e[2*j+1]], z_[e[2*j+1]]);
+
+        // vectors pointing to the two neighbor nodes
+        const Vector e1 = p2 - p0;
+        const Vector e2 = p1 - p0;
+
+        // Squared distance between neighbors
+        const Vector p12 = p1 - p2;
+        const double l = Dot(p12, p12);
+        if (l <= 0.0) continue;
+
+        const double dot = Dot(p1 - p0, p12) / l;
+        const Point p3 = p1 - dot * p12;
+
+        double A = (p1 - p3).length();
+        const double B = (p0 - p3).length();
+        double C = (p2 - p3).length();
+
+        // if B approaches zero, we have a flat triangle, hence we need to
+        // bounce back the node towards the other side. Hence ignoring these
+        // directions
+        if (B >= 10 * epsilon)
+        {
+          if (dot < 0.0) A = -A;
+          if (dot > 1.0) C = -C;
+          totw += (A + C) / B;
+          d += (A / B) * e1 + (C / B) * e2;
+        }
+      }
+
+      if (totw != 0.0)
+      {
+        dx_[i] = d.x() / totw;
+        dy_[i] = d.y() / totw;
+        dz_[i] = d.z() / totw;
+      }
+    }
+  });
+}
+
+void
+MeshSmoother::displace(double factor)
+{
+  Parallel::ForRange(0, num_nodes_, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      x_[i] += factor * dx_[i];
+      y_[i] += factor * dy_[i];
+      z_[i] += factor * dz_[i];
+    }
+  });
+}
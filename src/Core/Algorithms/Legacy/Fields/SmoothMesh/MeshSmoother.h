@@ -0,0 +1,105 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORITHMS_FIELDS_SMOOTHMESH_MESHSMOOTHER_H
+#define CORE_ALGORITHMS_FIELDS_SMOOTHMESH_MESHSMOOTHER_H 1
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <vector>
+
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+        /// Adjacency of the nodes or elements of a mesh in compressed row
+        /// form. It is extracted once, in parallel, so iterative filters
+        /// do not have to query the virtual VMesh interface every sweep.
+        class SCISHARE MeshGraph
+        {
+          public:
+            /// Nodes sharing an element with every node
+            static MeshGraph node_neighbors(VMesh* mesh);
+            /// Elements sharing a face (or an edge on surfaces) with every element
+            static MeshGraph elem_neighbors(VMesh* mesh);
+            /// For every node of a surface, the edges of its surrounding
+            /// elements that do not touch it, stored as pairs of nodes.
+            static MeshGraph opposite_edges(VMesh* mesh);
+
+            VMesh::size_type size() const { return static_cast<VMesh::size_type>(offsets_.size()) - 1; }
+            VMesh::size_type degree(VMesh::index_type i) const { return offsets_[i+1] - offsets_[i]; }
+            const VMesh::index_type* begin(VMesh::index_type i) const { return &adjacency_[0] + offsets_[i]; }
+            const VMesh::index_type* end(VMesh::index_type i) const { return &adjacency_[0] + offsets_[i+1]; }
+
+          private:
+            template <class FILL>
+            static MeshGraph build(VMesh::size_type size, FILL fill);
+
+            std::vector<VMesh::index_type> offsets_;
+            std::vector<VMesh::index_type> adjacency_;
+        };
+
+        /// Iterative smoothing of node positions. The coordinates are kept
+        /// as separate x, y and z arrays and every sweep is a Jacobi
+        /// update: displacements are computed from the current positions
+        /// for all nodes in parallel, then applied in a second pass.
+        class SCISHARE MeshSmoother
+        {
+          public:
+            MeshSmoother(const Geometry::Point* points, VMesh::size_type num_nodes);
+
+            /// Umbrella operator: displacement towards the average of the
+            /// neighbors in the graph.
+            void umbrella(const MeshGraph& neighbors);
+
+            /// Desbrun et al. curvature flow weights, from the graph built
+            /// by MeshGraph::opposite_edges. Nodes without usable weights
+            /// keep their previous displacement.
+            void curvature_flow(const MeshGraph& opposite_edges, double epsilon);
+
+            /// Adds factor times the displacement to the positions. The
+            /// Taubin lambda|mu filter alternates a positive and a negative
+            /// factor.
+            void displace(double factor);
+
+            void get_points(Geometry::Point* points) const;
+
+          private:
+            VMesh::size_type num_nodes_;
+            std::vector<double> x_, y_, z_;
+            std::vector<double> dx_, dy_, dz_;
+        };
+
+      }
+    }
+  }
+}
+
+#endif
@@ -42,11 +42,11 @@ DEALINGS IN THE SOFTWARE.
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Logging/Log.h>
+#include <Core/Logging/Trace.h>
 
 #include <string>
 #include <vector>
 #include <algorithm>
-#include <boost/shared_array.hpp>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Geometry;
@@ -66,14 +66,46 @@ namespace SCIRun {
         template <typename T>
         using matrix_pointer_type = boost::shared_ptr<matrix_type<T>>;
 
+// Symbolic part of the stiffness matrix. It only depends on the mesh, so it is
+// kept between runs and a change of conductivities only redoes the numeric pass.
+class FEMatrixStructure
+{
+public:
+  bool matches(VMesh* mesh, index_type global_dimension, index_type local_dimension) const
+  {
+    return generation_ == mesh->generation() &&
+      num_elems_ == static_cast<size_type>(mesh->num_elems()) &&
+      global_dimension_ == global_dimension &&
+      local_dimension_ == local_dimension;
+  }
+
+  int generation_ = -1;
+  size_type num_elems_ = 0;
+  index_type global_dimension_ = 0;
+  index_type local_dimension_ = 0;
+
+  // CSR row pointers and column indices
+  std::vector<index_type> rows_;
+  std::vector<index_type> columns_;
+
+  // For every row, where each entry of the local stiffness rows computed for
+  // that row ends up, as an offset from the start of the row. The entries are
+  // listed in the order the numeric pass visits the elements, so it can add
+  // them without searching the row.
+  std::vector<index_type> slot_rows_;
+  std::vector<unsigned int> slots_;
+};
+
 template <typename T>
 class BuildFEMatrixAlgoImpl
 {
 public:
-  explicit BuildFEMatrixAlgoImpl(const AlgorithmBase* algo) : algo_(algo) {}
+  BuildFEMatrixAlgoImpl(const AlgorithmBase* algo, boost::shared_ptr<FEMatrixStructure>& structure) :
+    algo_(algo), structure_(structure) {}
   bool run(FieldHandle input, Datatypes::DenseMatrixHandle ctable, matrix_pointer_type<T>& output) const;
 private:
   const AlgorithmBase* algo_;
+  boost::shared_ptr<FEMatrixStructure>& structure_;
   mutable int generation_ = 0;
   mutable std::vector<std::vector<T>> basis_values_;
   mutable matrix_pointer_type<T> basis_fematrix_;
@@ -84,10 +116,11 @@ template <typename T>
 class FEMBuilder
 {
 public:
-  explicit FEMBuilder(const AlgorithmBase* algo) :
+  FEMBuilder(const AlgorithmBase* algo, boost::shared_ptr<FEMatrixStructure>& structure) :
     algo_(algo), numprocessors_(Parallel::NumCores()),
     barrier_("FEMBuilder Barrier", numprocessors_),
     mesh_(nullptr), field_(nullptr),
+    structure_(structure), reuse_structure_(false),
     domain_dimension(0), local_dimension_nodes(0),
     local_dimension_add_nodes(0),
     local_dimension_derivatives(0),
@@ -115,9 +148,11 @@ private:
 
   std::vector<bool> success_;
 
-  boost::shared_array<index_type> rows_;
-  boost::shared_array<index_type> allcols_;
+  boost::shared_ptr<FEMatrixStructure>& structure_;
+  bool reuse_structure_;
+  // Per thread offsets into the column and slot arrays
   std::vector<index_type> colidx_;
+  std::vector<index_type> slotidx_;
 
   index_type domain_dimension;
 
@@ -138,12 +173,21 @@ private:
   // Entry point for the parallel version
   void parallel(int proc);
 
-  void add_lcl_gbl(index_type row, const std::vector<index_type> &cols, const std::vector<T> &lcl_a)
+  // Adds a line of a local stiffness matrix through the slots of the row
+  void add_lcl_gbl(T* row_values, const unsigned int*& slots, const std::vector<T> &lcl_a)
   {
     for (size_t i = 0; i < lcl_a.size(); i++)
-      fematrix_->coeffRef(row, cols[i]) += lcl_a[i];
+      row_values[*slots++] += lcl_a[i];
   }
 
+  // Degrees of freedom of the elements around a row, local_dimension entries
+  // per element, and the element/local row pairs that belong to the row
+  void collect_row(index_type i, VMesh::Elem::array_type& ca,
+                   std::vector<index_type>& elem_dofs,
+                   std::vector<std::pair<size_t, size_t>>& lines);
+
+  bool build_structure(int proc_num, index_type start_gd, index_type end_gd);
+
   void create_numerical_integration(std::vector<VMesh::coords_type>& p,
                                     std::vector<double>& w,
                                     std::vector<std::vector<double>>& d);
@@ -669,122 +713,128 @@ FEMBuilder<T>::setup()
     algo_->error("Mesh size < 0");
     success_[0] = false;
   }
-  LOG_DEBUG("Allocating buffer for nonzero row indices of size: {}", global_dimension+1);
-  rows_.reset(new index_type[global_dimension+1]);
+  reuse_structure_ = structure_ && structure_->matches(mesh_, global_dimension, local_dimension);
+  if (!reuse_structure_)
+  {
+    LOG_DEBUG("Allocating buffer for nonzero row indices of size: {}", global_dimension+1);
+    structure_ = boost::make_shared<FEMatrixStructure>();
+    structure_->rows_.resize(global_dimension+1);
+    structure_->slot_rows_.resize(global_dimension+1);
+  }
 
   colidx_.resize(numprocessors_+1);
+  slotidx_.resize(numprocessors_+1);
   return true;
 }
 
-// -- callback routine to execute in parallel
 template <typename T>
 void
-FEMBuilder<T>::parallel(int proc_num)
+FEMBuilder<T>::collect_row(index_type i, VMesh::Elem::array_type& ca,
+                           std::vector<index_type>& elem_dofs,
+                           std::vector<std::pair<size_t, size_t>>& lines)
 {
-  success_[proc_num] = true;
+  VMesh::Node::array_type na;
+  VMesh::Edge::array_type ea;
 
-  if (proc_num == 0)
+  if (i < global_dimension_nodes)
   {
-    try
-    {
-      success_[proc_num] = setup();
-    }
-    catch (...)
-    {
-      algo_->error("BuildFEMatrix could not setup FE Stiffness computation");
-      success_[proc_num] = false;
-    }
+    /// get neighboring cells for node
+    mesh_->get_elems(ca, VMesh::Node::index_type(i));
+  }
+  else if (i < global_dimension_nodes+global_dimension_add_nodes)
+  {
+    /// check for additional nodes at edges
+    /// get neighboring cells for node
+    VMesh::Edge::index_type ii(i-global_dimension_nodes);
+    mesh_->get_elems(ca,ii);
+  }
+  else
+  {
+    // There is some functionality implemented for higher order basis functions,
+    // but it seems not to be accessible, entirely implemented nor validated.
+    algo_->warning("BuildFEMatrix only supports linear basis functions.");
+    ca.clear();
   }
 
-  barrier_.wait();
-
-  // In case one of the threads fails, we should have them fail all
-  for (int q = 0; q < numprocessors_; q++)
+  elem_dofs.clear();
+  lines.clear();
+  for (size_t j = 0; j < ca.size(); j++)
   {
-    if (!success_[q])
+    /// get neighboring nodes
+    mesh_->get_nodes(na, ca[j]);
+    for (size_t k = 0; k < na.size(); k++)
     {
-      std::ostringstream oss;
-      oss << "FEMBuilder::setup failed in thread " << q;
-      algo_->error(oss.str());
-      return;
+      elem_dofs.push_back(static_cast<index_type>(na[k]));
+      if (na[k] == i)
+        lines.emplace_back(j, k);
     }
+
+    /// check for additional nodes at edges
+    if (global_dimension_add_nodes)
+    {
+      /// get neighboring edges
+      mesh_->get_edges(ea, ca[j]);
+      for (size_t k = 0; k < ea.size(); k++)
+      {
+        const index_type dof = global_dimension + ea[k];
+        elem_dofs.push_back(dof);
+        if (dof == i)
+          lines.emplace_back(j, k+na.size());
+      }
+    }
+
+    ASSERT(static_cast<index_type>(elem_dofs.size()) == static_cast<index_type>(j+1)*local_dimension);
   }
+}
 
-  /// distributing dofs among processors
-  const index_type start_gd = (global_dimension * proc_num)/numprocessors_;
-  const index_type end_gd  = (global_dimension * (proc_num+1))/numprocessors_;
+/// Symbolic pass: row pointers, column indices and slot maps for the rows
+/// [start_gd, end_gd). Each thread maps out its own rows, after which the
+/// pieces are copied into place in parallel.
+template <typename T>
+bool
+FEMBuilder<T>::build_structure(int proc_num, index_type start_gd, index_type end_gd)
+{
+  SCIRUN_TRACE_SCOPE("fem", "structure");
+  auto& structure = *structure_;
 
-  /// creating sparse matrix structure
   std::vector<index_type> mycols;
+  std::vector<unsigned int> myslots;
 
   VMesh::Elem::array_type ca;
-  VMesh::Node::array_type na;
-  VMesh::Edge::array_type ea;
+  std::vector<index_type> elem_dofs;
   std::vector<index_type> neib_dofs;
+  std::vector<std::pair<size_t, size_t>> lines;
 
-  /// loop over system dofs for this thread
   int cnt = 0;
-  size_type size_gd = end_gd-start_gd;
-  auto updateFrequency = 2*size_gd / 100;
+  const size_type size_gd = end_gd-start_gd;
+  const auto updateFrequency = 2*size_gd / 100;
   try
   {
-    mycols.reserve((end_gd - start_gd)*local_dimension*8);  //<! rough estimate
+    mycols.reserve(size_gd*local_dimension*8);  //<! rough estimate
+    myslots.reserve(size_gd*local_dimension*8);
 
-    for (VMesh::Node::index_type i = start_gd; i<end_gd; ++i)
+    for (index_type i = start_gd; i<end_gd; ++i)
     {
-      rows_[i] = mycols.size();
+      structure.rows_[i] = mycols.size();
+      structure.slot_rows_[i] = myslots.size();
 
-      neib_dofs.clear();
-      /// check for nodes
-      if (i < global_dimension_nodes)
-      {
-        /// get neighboring cells for node
-        mesh_->get_elems(ca, i);
-      }
-      else if (i < global_dimension_nodes+global_dimension_add_nodes)
-      {
-        /// check for additional nodes at edges
-        /// get neighboring cells for node
-        VMesh::Edge::index_type ii(i-global_dimension_nodes);
-        mesh_->get_elems(ca,ii);
-      }
-      else
-      {
-        // There is some functionality implemented for higher order basis functions,
-        // but it seems not to be accessible, entirely implemented nor validated.
-        algo_->warning("BuildFEMatrix only supports linear basis functions.");
-      }
-
-      for(size_t j = 0; j < ca.size(); j++)
-      {
-        /// get neighboring nodes
-        mesh_->get_nodes(na, ca[j]);
-
-        for(size_t k = 0; k < na.size(); k++)
-        {
-          neib_dofs.push_back(static_cast<index_type>(na[k]));
-        }
-
-        /// check for additional nodes at edges
-        if (global_dimension_add_nodes)
-        {
-          /// get neighboring edges
-          mesh_->get_edges(ea, ca[j]);
-
-          for(size_t k = 0; k < ea.size(); k++)
-            neib_dofs.push_back(global_dimension + ea[k]);
-        }
-      }
+      collect_row(i, ca, elem_dofs, lines);
 
+      neib_dofs = elem_dofs;
       std::sort(neib_dofs.begin(), neib_dofs.end());
+      neib_dofs.erase(std::unique(neib_dofs.begin(), neib_dofs.end()), neib_dofs.end());
+      mycols.insert(mycols.end(), neib_dofs.begin(), neib_dofs.end());
 
-      for (size_t j=0; j<neib_dofs.size(); j++)
+      for (const auto& line : lines)
       {
-        if (j == 0 || neib_dofs[j] != mycols.back())
+        const index_type* dofs = &elem_dofs[line.first*local_dimension];
+        for (index_type c = 0; c < local_dimension; c++)
         {
-          mycols.push_back(neib_dofs[j]);
+          const auto pos = std::lower_bound(neib_dofs.begin(), neib_dofs.end(), dofs[c]) - neib_dofs.begin();
+          myslots.push_back(static_cast<unsigned int>(pos));
         }
       }
+
       if (proc_num == 0)
       {
         cnt++;
@@ -797,6 +847,7 @@ FEMBuilder<T>::parallel(int proc_num)
     }
 
     colidx_[proc_num] = mycols.size();
+    slotidx_[proc_num] = myslots.size();
     success_[proc_num] = true;
   }
   catch (...)
@@ -812,38 +863,35 @@ FEMBuilder<T>::parallel(int proc_num)
   for (int q=0; q<numprocessors_;q++)
   {
     if (!success_[q])
-    {
-      return;
-    }
+      return false;
   }
 
-  std::vector<std::vector<T>> precompute;
-  index_type st = 0;
-
-  if (proc_num == 0)
-    allcols_.reset();
-
   try
   {
     if (proc_num == 0)
     {
-      for(int i=0; i<numprocessors_; i++)
+      index_type st = 0, sst = 0;
+      for (int i=0; i<numprocessors_; i++)
       {
         const index_type ns = colidx_[i];
         colidx_[i] = st;
         st += ns;
+        const index_type nss = slotidx_[i];
+        slotidx_[i] = sst;
+        sst += nss;
       }
 
       colidx_[numprocessors_] = st;
-      allcols_.reset(new index_type[st]);
+      slotidx_[numprocessors_] = sst;
+      structure.rows_[global_dimension] = st;
+      structure.slot_rows_[global_dimension] = sst;
+      structure.columns_.resize(st);
+      structure.slots_.resize(sst);
     }
     success_[proc_num] = true;
   }
   catch (...)
   {
-    if (proc_num == 0)
-      allcols_.reset();
-
     algo_->error("Could not allocate enough memory");
     success_[proc_num] = false;
   }
@@ -855,49 +903,86 @@ FEMBuilder<T>::parallel(int proc_num)
   for (int q=0; q<numprocessors_;q++)
   {
     if (! success_[q])
-      return;
+      return false;
   }
 
-  try
-  {
-    /// updating global column by each of the processors
-    const index_type s = colidx_[proc_num];
-    const size_t n = mycols.size();
+  /// updating global column and slot arrays by each of the processors
+  const index_type s = colidx_[proc_num];
+  std::copy(mycols.begin(), mycols.end(), structure.columns_.begin() + s);
+  for (index_type i = start_gd; i<end_gd; i++)
+    structure.rows_[i] += s;
 
-    for(size_t i=0; i<n; i++)
-      allcols_[i+s] = mycols[i];
+  const index_type ss = slotidx_[proc_num];
+  std::copy(myslots.begin(), myslots.end(), structure.slots_.begin() + ss);
+  for (index_type i = start_gd; i<end_gd; i++)
+    structure.slot_rows_[i] += ss;
 
-    for(index_type i = start_gd; i<end_gd; i++)
-      rows_[i] += s;
+  /// check point
+  barrier_.wait();
 
-    success_[proc_num] = true;
+  if (proc_num == 0)
+  {
+    structure.generation_ = mesh_->generation();
+    structure.num_elems_ = mesh_->num_elems();
+    structure.global_dimension_ = global_dimension;
+    structure.local_dimension_ = local_dimension;
   }
-  catch (...)
+  return true;
+}
+
+// -- callback routine to execute in parallel
+template <typename T>
+void
+FEMBuilder<T>::parallel(int proc_num)
+{
+  success_[proc_num] = true;
+
+  if (proc_num == 0)
   {
-    algo_->error("BuildFEMatrix crashed while setting up row compression");
-    success_[proc_num] = false;
+    try
+    {
+      SCIRUN_TRACE_SCOPE("fem", "setup");
+      success_[proc_num] = setup();
+    }
+    catch (...)
+    {
+      algo_->error("BuildFEMatrix could not setup FE Stiffness computation");
+      success_[proc_num] = false;
+    }
   }
 
-  /// check point
   barrier_.wait();
 
-  // Bail out if one of the processes failed
-  for (auto q=0; q<numprocessors_; q++)
+  // In case one of the threads fails, we should have them fail all
+  for (int q = 0; q < numprocessors_; q++)
   {
     if (!success_[q])
+    {
+      std::ostringstream oss;
+      oss << "FEMBuilder::setup failed in thread " << q;
+      algo_->error(oss.str());
       return;
+    }
   }
 
+  /// distributing dofs among processors
+  const index_type start_gd = (global_dimension * proc_num)/numprocessors_;
+  const index_type end_gd  = (global_dimension * (proc_num+1))/numprocessors_;
+
+  /// creating sparse matrix structure, unless the mesh did not change since
+  /// the last run
+  if (!reuse_structure_ && !build_structure(proc_num, start_gd, end_gd))
+    return;
+
+  const auto& structure = *structure_;
+
   try
   {
-    /// the main thread makes the matrix
+    /// the main thread allocates the matrix, the threads fill it in below
     if (proc_num == 0)
     {
-      rows_[global_dimension] = st;
-      algo_->remark("Creating fematrix on main thread.");
-      fematrix_ = boost::make_shared<matrix_type<T>>(global_dimension, global_dimension, rows_.get(), allcols_.get(), st);
-      rows_.reset();
-      allcols_.reset();
+      fematrix_ = boost::make_shared<matrix_type<T>>(global_dimension, global_dimension);
+      fematrix_->resizeNonZeros(structure.columns_.size());
     }
     success_[proc_num] = true;
   }
@@ -919,11 +1004,19 @@ FEMBuilder<T>::parallel(int proc_num)
 
   try
   {
-    /// zeroing in parallel
-    const auto ns = colidx_[proc_num];
-    const auto ne = colidx_[proc_num+1];
-    auto a = &(fematrix_->valuePtr()[ns]), ae=&(fematrix_->valuePtr()[ne]);
-    while (a<ae) *a++=0.0;
+    SCIRUN_TRACE_SCOPE("fem", "assembly");
+    /// copying the structure of and zeroing the rows of this thread
+    const auto ns = structure.rows_[start_gd];
+    const auto ne = structure.rows_[end_gd];
+    /// entry end_gd is the first row of the next thread, so only the last
+    /// thread writes the final row pointer
+    std::copy(structure.rows_.begin() + start_gd, structure.rows_.begin() + end_gd,
+      fematrix_->outerIndexPtr() + start_gd);
+    if (proc_num == numprocessors_ - 1)
+      fematrix_->outerIndexPtr()[global_dimension] = structure.rows_[global_dimension];
+    std::copy(structure.columns_.begin() + ns, structure.columns_.begin() + ne,
+      fematrix_->innerIndexPtr() + ns);
+    std::fill(fematrix_->valuePtr() + ns, fematrix_->valuePtr() + ne, T(0));
 
     std::vector<VMesh::coords_type> ni_points;
     std::vector<double> ni_weights;
@@ -934,97 +1027,30 @@ FEMBuilder<T>::parallel(int proc_num)
     std::vector<T> lsml; ///< line of local stiffnes matrix
     lsml.resize(local_dimension);
 
+    std::vector<std::vector<T>> precompute;
+    VMesh::Elem::array_type ca;
+    std::vector<index_type> elem_dofs;
+    std::vector<std::pair<size_t, size_t>> lines;
+    const bool regular = mesh_->is_regularmesh();
+
     /// loop over system dofs for this thread
-    cnt = 0;
-    size_gd = end_gd-start_gd;
-    for (VMesh::Node::index_type i = start_gd; i<end_gd; ++i)
+    int cnt = 0;
+    const size_type size_gd = end_gd-start_gd;
+    const auto updateFrequency = 2*size_gd / 100;
+    for (index_type i = start_gd; i<end_gd; ++i)
     {
-      if (i < global_dimension_nodes)
-      {
-        /// check for nodes
-        /// get neighboring cells for node
-        mesh_->get_elems(ca,i);
-      }
-      else if (i < global_dimension_nodes + global_dimension_add_nodes)
-      {
-        /// check for additional nodes at edges
-        /// get neighboring cells for additional nodes
-        VMesh::Edge::index_type ii(i-global_dimension_nodes);
-        mesh_->get_elems(ca,ii);
-      }
-      else
-      {
-        // There is some functionality implemented for higher order basis functions,
-        // but it seems not to be accessible, entirely implemented nor validated.
-        algo_->warning("BuildFEMatrix only supports linear basis functions.");
-      }
-
-      /// loop over elements attributed elements
+      collect_row(i, ca, elem_dofs, lines);
 
-      if (mesh_->is_regularmesh())
+      /// loop over the lines of the attributed elements that belong to this dof
+      auto row_values = fematrix_->valuePtr() + structure.rows_[i];
+      const unsigned int* slots = structure.slots_.data() + structure.slot_rows_[i];
+      for (const auto& line : lines)
       {
-        for (size_t j = 0; j < ca.size(); j++)
-        {
-          mesh_->get_nodes(na, ca[j]); ///< get neighboring nodes
-          neib_dofs.resize(na.size());
-          for(size_t k = 0; k < na.size(); k++)
-          {
-            neib_dofs[k] = na[k]; // Must cast to (int) for SGI compiler :-(
-          }
-
-          for(size_t k = 0; k < na.size(); k++)
-          {
-            if (na[k] == i)
-            {
-              build_local_matrix_regular(ca[j], k , lsml, ni_points, ni_weights, ni_derivatives,precompute);
-              add_lcl_gbl(i, neib_dofs, lsml);
-            }
-          }
-        }
-      }
-      else
-      {
-        for (size_t j = 0; j < ca.size(); j++)
-        {
-          neib_dofs.clear();
-          mesh_->get_nodes(na, ca[j]); ///< get neighboring nodes
-          for(size_t k = 0; k < na.size(); k++)
-          {
-            neib_dofs.push_back(na[k]); // Must cast to (int) for SGI compiler :-(
-          }
-          /// check for additional nodes at edges
-          if (global_dimension_add_nodes)
-          {
-            mesh_->get_edges(ea, ca[j]); ///< get neighboring edges
-            for(size_t k = 0; k < ea.size(); k++)
-            {
-              neib_dofs.push_back(global_dimension + ea[k]);
-            }
-          }
-
-          ASSERT(static_cast<int>(neib_dofs.size()) == local_dimension);
-
-          for(size_t k = 0; k < na.size(); k++)
-          {
-            if (na[k] == i)
-            {
-              build_local_matrix(ca[j], k , lsml, ni_points, ni_weights, ni_derivatives);
-              add_lcl_gbl(i, neib_dofs, lsml);
-            }
-          }
-
-          if (global_dimension_add_nodes)
-          {
-            for (size_t k = 0; k < ea.size(); k++)
-            {
-              if (global_dimension + static_cast<int>(ea[k]) == i)
-              {
-                build_local_matrix(ca[j], k+na.size(), lsml, ni_points, ni_weights, ni_derivatives);
-                add_lcl_gbl(i, neib_dofs, lsml);
-              }
-            }
-          }
-        }
+        if (regular)
+          build_local_matrix_regular(ca[line.first], line.second, lsml, ni_points, ni_weights, ni_derivatives, precompute);
+        else
+          build_local_matrix(ca[line.first], line.second, lsml, ni_points, ni_weights, ni_derivatives);
+        add_lcl_gbl(row_values, slots, lsml);
       }
 
       if (proc_num == 0)
@@ -1096,7 +1122,7 @@ BuildFEMatrixAlgoImpl<T>::run(FieldHandle input, DenseMatrixHandle ctable, matri
     }
   }
 
-  FEMBuilder<T> builder(algo_);
+  FEMBuilder<T> builder(algo_, structure_);
 
   if (algo_->get(BuildFEMatrixAlgo::GenerateBasis).toBool())
   {
@@ -1226,7 +1252,7 @@ AlgorithmOutput BuildFEMatrixAlgo::run(const AlgorithmInput& input) const
   if (field && field->vfield() && field->vfield()->is_complex_double())
 	{
 		matrix_pointer_type<complex> stiffness;
-	  BuildFEMatrixAlgoImpl<complex> impl(this);
+	  BuildFEMatrixAlgoImpl<complex> impl(this, structure_);
 	  if (!impl.run(field, ctable, stiffness))
 	    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.--complex detected	");
 		output[Stiffness_Matrix_Complex] = stiffness;
@@ -1234,7 +1260,7 @@ AlgorithmOutput BuildFEMatrixAlgo::run(const AlgorithmInput& input) const
 	else
 	{
 		matrix_pointer_type<double> stiffness;
-	  BuildFEMatrixAlgoImpl<double> impl(this);
+	  BuildFEMatrixAlgoImpl<double> impl(this, structure_);
 	  if (!impl.run(field, ctable, stiffness))
 	    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.");
 		output[Stiffness_Matrix] = stiffness;
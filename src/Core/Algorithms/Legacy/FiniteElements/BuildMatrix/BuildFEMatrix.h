@@ -39,6 +39,8 @@ namespace SCIRun {
 		namespace Algorithms {
 			namespace FiniteElements {
 
+class FEMatrixStructure;
+
 class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
 {
   public:
@@ -62,6 +64,11 @@ class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
     }
 
     virtual AlgorithmOutput run(const AlgorithmInput &) const override;
+
+  private:
+    // Sparsity pattern of the last matrix, reused as long as the mesh does not
+    // change so that new conductivities only need the numeric assembly pass
+    mutable boost::shared_ptr<FEMatrixStructure> structure_;
 };
 
 }}}}
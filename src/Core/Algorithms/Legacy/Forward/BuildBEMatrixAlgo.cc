@@ -55,17 +55,23 @@ DEALINGS IN THE SOFTWARE.
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <Core/Algorithms/Math/HierarchicalMatrix/HierarchicalMatrix.h>
+#include <Core/Thread/Parallel.h>
+#include <boost/ref.hpp>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms::Forward;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using SCIRun::Core::Algorithms::Math::HierarchicalMatrix;
 
 ALGORITHM_PARAMETER_DEF(Forward, FieldNameList);
 ALGORITHM_PARAMETER_DEF(Forward, FieldTypeList);
 ALGORITHM_PARAMETER_DEF(Forward, BoundaryConditionList);
 ALGORITHM_PARAMETER_DEF(Forward, InsideConductivityList);
 ALGORITHM_PARAMETER_DEF(Forward, OutsideConductivityList);
+ALGORITHM_PARAMETER_DEF(Forward, CrossBlockCompressionTolerance);
 
 void BuildBEMatrixBase::getOmega(
   const Vector& y1,
@@ -495,9 +501,40 @@ double BuildBEMatrixBase::do_radon_g(
   return g2 * aV.length();
 }
 
+void BuildBEMatrixBase::get_radon_weights(DenseMatrix& R_W, double& s, double& r)
+{
+  // Weights and positions of the 7 Radon integration points of a triangle
+  double sqrt15 = sqrt(15.0);
+  R_W.resize(1, 7);
+  R_W(0,0) = 9.0/40.0;
+  R_W(0,1) = (155 + sqrt15) / 1200;
+  R_W(0,2) = R_W(0,1);
+  R_W(0,3) = R_W(0,1);
+  R_W(0,4) = (155 - sqrt15) / 1200;
+  R_W(0,5) = R_W(0,4);
+  R_W(0,6) = R_W(0,4);
+
+  s = (1 - sqrt15) / 7;
+  r = (1 + sqrt15) / 7;
+}
+
 class BuildBEMatrixBaseCompute : public BuildBEMatrixBase
 {
 public:
+  //! Triangle data that every observation node needs, gathered once so the
+  //! node loops can run in parallel without touching the mesh
+  struct BEMTriangle
+  {
+    index_type nodes[3];
+    Vector p1, p2, p3;
+    Vector centroid;
+    double area;
+    DenseMatrix cruse_weights;
+  };
+
+  //! With areas given, also computes the weights of the G integrals
+  static void get_triangles(VMesh* hsurf, std::vector<BEMTriangle>& triangles, const std::vector<double>* areas);
+
   template <class MatrixType>
   static void make_auto_P_compute(VMesh* hsurf, MatrixType& auto_P, double in_cond, double out_cond, double op_cond);
 
@@ -530,6 +567,35 @@ double in_cond, double out_cond, double op_cond, const std::vector<double>& avIn
   BuildBEMatrixBaseCompute::make_auto_G_compute(hsurf, *h_GG_, in_cond, out_cond, op_cond, avInn);
 }
 
+void BuildBEMatrixBaseCompute::get_triangles(VMesh* hsurf, std::vector<BEMTriangle>& triangles, const std::vector<double>* areas)
+{
+  DenseMatrix R_W(1,7);
+  double s, r;
+  get_radon_weights(R_W, s, r);
+
+  VMesh::Node::array_type nodes;
+  VMesh::Face::size_type nfaces;
+  hsurf->size(nfaces);
+  triangles.resize(nfaces);
+
+  for (VMesh::Face::index_type f = 0; f < nfaces; ++f)
+  {
+    BEMTriangle& tri = triangles[f];
+    hsurf->get_nodes(nodes, f);
+    for (int i=0; i<3; ++i) tri.nodes[i] = nodes[i];
+    tri.p1 = Vector(hsurf->get_point(nodes[0]));
+    tri.p2 = Vector(hsurf->get_point(nodes[1]));
+    tri.p3 = Vector(hsurf->get_point(nodes[2]));
+    tri.centroid = (tri.p1 + tri.p2 + tri.p3) / 3.0;
+    if (areas)
+    {
+      tri.area = (*areas)[f];
+      tri.cruse_weights.resize(3, 7);
+      get_cruse_weights(tri.p1, tri.p2, tri.p3, s, r, tri.area, tri.cruse_weights);
+    }
+  }
+}
+
 template <class MatrixType>
 void BuildBEMatrixBaseCompute::make_auto_G_compute(VMesh* hsurf, MatrixType& auto_G,
   double in_cond, double out_cond, double op_cond, const std::vector<double>& avInn)
@@ -537,66 +603,42 @@ void BuildBEMatrixBaseCompute::make_auto_G_compute(VMesh* hsurf, MatrixType& aut
   //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
-
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
   DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
+  double s, r;
+  get_radon_weights(R_W, s, r);
 
-  double area;
+  std::vector<BEMTriangle> triangles;
+  get_triangles(hsurf, triangles, &avInn);
 
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
-
-
-  hsurf->begin(fi); hsurf->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf->get_nodes(nodes, *fi);
-    Vector p1(hsurf->get_point(nodes[0]));
-    Vector p2(hsurf->get_point(nodes[1]));
-    Vector p3(hsurf->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-    hsurf->begin(ni); hsurf->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf->get_point(ppi));
-
-      if (ppi == nodes[0])       bem_sing(p1, p2, p3, 0, g_values, s, r, R_W);
-      else if (ppi == nodes[1])       bem_sing(p1, p2, p3, 1, g_values, s, r, R_W);
-      else if (ppi == nodes[2])       bem_sing(p1, p2, p3, 2, g_values, s, r, R_W);
-      else
-      {
-        get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
+  //! every thread fills the rows of its own range of nodes
+  Parallel::ForRange(0, numNodes(hsurf), [&](size_t begin, size_t end)
+  {
+    DenseMatrix g_coef(1, 7);
+    DenseMatrix temp(1,7);
+    DenseMatrix g_values(3, 1);
+
+    for (const auto& tri : triangles)
+    { //! find contributions from every triangle
+      for (index_type ppi = begin; ppi < static_cast<index_type>(end); ++ppi)
+      { //! for every node
+        if (ppi == tri.nodes[0])       bem_sing(tri.p1, tri.p2, tri.p3, 0, g_values, s, r, R_W);
+        else if (ppi == tri.nodes[1])       bem_sing(tri.p1, tri.p2, tri.p3, 1, g_values, s, r, R_W);
+        else if (ppi == tri.nodes[2])       bem_sing(tri.p1, tri.p2, tri.p3, 2, g_values, s, r, R_W);
+        else
+        {
+          Vector op(hsurf->get_point(VMesh::Node::index_type(ppi)));
+          get_g_coef(tri.p1, tri.p2, tri.p3, op, s, r, tri.centroid, g_coef);
 
-        for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
+          for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
 
-        g_values = area * (cruse_weights * temp.transpose());
-      } // else
+          g_values = tri.area * (tri.cruse_weights * temp.transpose());
+        } // else
 
-      for (int i=0; i<3; ++i)
-        auto_G(ppi, nodes[i])+=g_values(i,0)*mult;
+        for (int i=0; i<3; ++i)
+          auto_G(ppi, tri.nodes[i])+=g_values(i,0)*mult;
+      }
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_cross_G_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_GG_)
@@ -618,60 +660,36 @@ void BuildBEMatrixBaseCompute::make_cross_G_compute(VMesh* hsurf1, VMesh* hsurf2
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
-
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
-
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
   DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
+  double s, r;
+  get_radon_weights(R_W, s, r);
 
-  double area;
+  std::vector<BEMTriangle> triangles;
+  get_triangles(hsurf2, triangles, &avInn);
 
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
-
-  hsurf2->begin(fi); hsurf2->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf2->get_nodes(nodes, *fi);
-    Vector p1(hsurf2->get_point(nodes[0]));
-    Vector p2(hsurf2->get_point(nodes[1]));
-    Vector p3(hsurf2->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
+  //! every thread fills the rows of its own range of nodes
+  Parallel::ForRange(0, numNodes(hsurf1), [&](size_t begin, size_t end)
+  {
+    DenseMatrix g_coef(1, 7);
+    DenseMatrix temp(1,7);
+    DenseMatrix g_values(3, 1);
 
-    hsurf1->begin(ni); hsurf1->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf1->get_point(ppi));
-      get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
+    for (const auto& tri : triangles)
+    { //! find contributions from every triangle
+      for (index_type ppi = begin; ppi < static_cast<index_type>(end); ++ppi)
+      { //! for every node
+        Vector op(hsurf1->get_point(VMesh::Node::index_type(ppi)));
+        get_g_coef(tri.p1, tri.p2, tri.p3, op, s, r, tri.centroid, g_coef);
 
-      for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
+        for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
 
-      g_values = area * (cruse_weights * temp.transpose());
+        g_values = tri.area * (tri.cruse_weights * temp.transpose());
 
-      for (int i=0; i<3; ++i)
-        cross_G(ppi, nodes[i])+=g_values(i,0)*mult;
+        for (int i=0; i<3; ++i)
+          cross_G(ppi, tri.nodes[i])+=g_values(i,0)*mult;
+      }
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_cross_P_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_PP_)
@@ -691,32 +709,27 @@ void BuildBEMatrixBaseCompute::make_cross_P_compute(VMesh* hsurf1, VMesh* hsurf2
 {
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-  int i;
-
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
-
-  hsurf1->begin(ni); hsurf1->end(nie);
-  for (; ni != nie; ++ni){ //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf1->get_point(ppi);
+  std::vector<BEMTriangle> triangles;
+  get_triangles(hsurf2, triangles, nullptr);
 
-    hsurf2->begin(fi); hsurf2->end(fie);
-    for (; fi != fie; ++fi){ //! find contributions from every triangle
+  //! every thread fills the rows of its own range of nodes
+  Parallel::ForRange(0, numNodes(hsurf1), [&](size_t begin, size_t end)
+  {
+    DenseMatrix coef(1, 3);
 
-      hsurf2->get_nodes(nodes, *fi);
-      Vector v1 = hsurf2->get_point(nodes[0]) - pp;
-      Vector v2 = hsurf2->get_point(nodes[1]) - pp;
-      Vector v3 = hsurf2->get_point(nodes[2]) - pp;
+    for (index_type ppi = begin; ppi < static_cast<index_type>(end); ++ppi)
+    { //! for every node
+      Vector pp(hsurf1->get_point(VMesh::Node::index_type(ppi)));
 
-      getOmega(v1, v2, v3, coef);
+      for (const auto& tri : triangles)
+      { //! find contributions from every triangle
+        getOmega(tri.p1 - pp, tri.p2 - pp, tri.p3 - pp, coef);
 
-      for (i=0; i<3; ++i)
-        cross_P(ppi, nodes[i])-=coef(0,i)*mult;
+        for (int i=0; i<3; ++i)
+          cross_P(ppi, tri.nodes[i])-=coef(0,i)*mult;
+      }
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_auto_P_allocate(VMesh* hsurf, DenseMatrixHandle &h_PP_)
@@ -741,47 +754,38 @@ template <class MatrixType>
 void BuildBEMatrixBaseCompute::make_auto_P_compute(VMesh* hsurf, MatrixType& auto_P, double in_cond, double out_cond, double op_cond)
 {
   auto nnodes = auto_P.rows();
-  
-  
 
   //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
 
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-
-  unsigned int i;
+  std::vector<BEMTriangle> triangles;
+  get_triangles(hsurf, triangles, nullptr);
 
-  hsurf->begin(ni); hsurf->end(nie);
-
-  for (; ni != nie; ++ni){ //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf->get_point(ppi);
+  //! every thread fills the rows of its own range of nodes
+  Parallel::ForRange(0, nnodes, [&](size_t begin, size_t end)
+  {
+    DenseMatrix coef(1, 3);
 
-    hsurf->begin(fi); hsurf->end(fie);
-    
-    for (; fi != fie; ++fi) { //! find contributions from every triangle
+    for (index_type ppi = begin; ppi < static_cast<index_type>(end); ++ppi)
+    { //! for every node
+      Vector pp(hsurf->get_point(VMesh::Node::index_type(ppi)));
 
-      hsurf->get_nodes(nodes, *fi);
-      if (ppi!=nodes[0] && ppi!=nodes[1] && ppi!=nodes[2]){
-        Vector v1 = hsurf->get_point(nodes[0]) - pp;
-        Vector v2 = hsurf->get_point(nodes[1]) - pp;
-        Vector v3 = hsurf->get_point(nodes[2]) - pp;
-        
-        getOmega(v1, v2, v3, coef);
+      for (const auto& tri : triangles)
+      { //! find contributions from every triangle
+        if (ppi!=tri.nodes[0] && ppi!=tri.nodes[1] && ppi!=tri.nodes[2])
+        {
+          getOmega(tri.p1 - pp, tri.p2 - pp, tri.p3 - pp, coef);
 
-        for (i=0; i<3; ++i)
-          auto_P(ppi, nodes[i])-=coef(0,i)*mult;
+          for (int i=0; i<3; ++i)
+            auto_P(ppi, tri.nodes[i])-=coef(0,i)*mult;
+        }
       }
     }
-  }
+  });
 
   //! accounting for autosolid angle
   auto sumOfRows = auto_P.rowwise().sum().eval();
-  for (i=0; i<nnodes; ++i)
+  for (int i=0; i<nnodes; ++i)
   {
     auto_P(i,i) = out_cond - sumOfRows(i);
   }
@@ -794,6 +798,88 @@ void BuildBEMatrixBase::make_auto_P(VMesh* hsurf, DenseMatrixHandle &h_PP_,
   BuildBEMatrixBaseCompute::make_auto_P_compute(hsurf, *h_PP_, in_cond, out_cond, op_cond);
 }
 
+//! Single entries of a cross P or cross G block, for the compressed assembly.
+//! Entry (i,j) sums the contributions of the triangles around node j of
+//! hsurf2 seen from node i of hsurf1, in the same order as the dense loops.
+class CrossBlockEntries : public BuildBEMatrixBaseCompute
+{
+public:
+  CrossBlockEntries(VMesh* hsurf1, VMesh* hsurf2, double mult, const std::vector<double>* areas) :
+    mult_(mult), single_layer_(areas != nullptr), R_W_(1,7)
+  {
+    get_radon_weights(R_W_, s_, r_);
+    get_triangles(hsurf2, triangles_, areas);
+
+    nodeTriangles_.resize(numNodes(hsurf2));
+    for (size_t f = 0; f < triangles_.size(); ++f)
+      for (int i=0; i<3; ++i)
+        nodeTriangles_[triangles_[f].nodes[i]].push_back(std::make_pair(static_cast<index_type>(f), i));
+
+    observation_.resize(numNodes(hsurf1));
+    for (size_t k = 0; k < observation_.size(); ++k)
+      observation_[k] = hsurf1->get_point(VMesh::Node::index_type(k));
+
+    points_.resize(numNodes(hsurf2));
+    for (size_t k = 0; k < points_.size(); ++k)
+      points_[k] = hsurf2->get_point(VMesh::Node::index_type(k));
+  }
+
+  double operator()(index_type i, index_type j) const
+  {
+    double value = 0.0;
+    const Vector op(observation_[i]);
+    if (single_layer_)
+    {
+      DenseMatrix g_coef(1, 7);
+      for (const auto& corner : nodeTriangles_[j])
+      {
+        const BEMTriangle& tri = triangles_[corner.first];
+        get_g_coef(tri.p1, tri.p2, tri.p3, op, s_, r_, tri.centroid, g_coef);
+        double g = 0.0;
+        for (int k=0; k<7; k++) g += tri.cruse_weights(corner.second, k) * g_coef(0,k) * R_W_(0,k);
+        value += tri.area * g * mult_;
+      }
+    }
+    else
+    {
+      DenseMatrix coef(1, 3);
+      for (const auto& corner : nodeTriangles_[j])
+      {
+        const BEMTriangle& tri = triangles_[corner.first];
+        getOmega(tri.p1 - op, tri.p2 - op, tri.p3 - op, coef);
+        value -= coef(0, corner.second) * mult_;
+      }
+    }
+    return value;
+  }
+
+  const std::vector<Point>& observationPoints() const { return observation_; }
+  const std::vector<Point>& points() const { return points_; }
+
+private:
+  double mult_;
+  bool single_layer_;
+  DenseMatrix R_W_;
+  double s_, r_;
+  std::vector<BEMTriangle> triangles_;
+  std::vector<std::vector<std::pair<index_type, int> > > nodeTriangles_;
+  std::vector<Point> observation_, points_;
+};
+
+HierarchicalMatrixHandle BuildBEMatrixBase::make_cross_P_compressed(VMesh* hsurf1, VMesh* hsurf2,
+  double in_cond, double out_cond, double tolerance)
+{
+  CrossBlockEntries entries(hsurf1, hsurf2, 1/(4*M_PI)*(out_cond - in_cond), nullptr);
+  return boost::make_shared<HierarchicalMatrix>(entries.observationPoints(), entries.points(), boost::cref(entries), tolerance);
+}
+
+HierarchicalMatrixHandle BuildBEMatrixBase::make_cross_G_compressed(VMesh* hsurf1, VMesh* hsurf2,
+  double in_cond, double out_cond, const std::vector<double>& avInn, double tolerance)
+{
+  CrossBlockEntries entries(hsurf1, hsurf2, 1/(4*M_PI)*(out_cond - in_cond), &avInn);
+  return boost::make_shared<HierarchicalMatrix>(entries.observationPoints(), entries.points(), boost::cref(entries), tolerance);
+}
+
 // precalculate triangles area
 void BuildBEMatrixBase::pre_calc_tri_areas(VMesh* hsurf, std::vector<double>& areaV){
 
@@ -943,16 +1029,24 @@ bool BuildBEMatrixBase::compute_nesting(std::vector<int> &nesting, const std::ve
 class SurfaceAndPoints : public BEMAlgoImpl, public BuildBEMatrixBaseCompute
 {
 public:
+  explicit SurfaceAndPoints(double compressionTolerance) : compressionTolerance_(compressionTolerance) {}
   virtual MatrixHandle compute(const bemfield_vector& fields) const override;
+private:
+  double compressionTolerance_;
 };
 
 class SurfaceToSurface : public BEMAlgoImpl, public BuildBEMatrixBaseCompute
 {
 public:
+  explicit SurfaceToSurface(double compressionTolerance) : compressionTolerance_(compressionTolerance) {}
   virtual MatrixHandle compute(const bemfield_vector& fields) const override;
+private:
+  MatrixHandle computeCompressed(const bemfield_vector& fields,
+    const std::vector<int>& sourcefieldindices, const std::vector<int>& measurementfieldindices) const;
+  double compressionTolerance_;
 };
 
-BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields)
+BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields, double compressionTolerance)
 {
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   // Check for special case where the potentials need to be evaluated at the nodes of a lead
@@ -995,7 +1089,7 @@ BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields)
     // If all of the checks above don't flag meets_conditions as false,
     // return a value that indicates the algorithm to use is the surface-to-nodes case
     if ( meets_conditions )
-      return boost::make_shared<SurfaceAndPoints>();
+      return boost::make_shared<SurfaceAndPoints>(compressionTolerance);
   }
 
   //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1020,7 +1114,7 @@ BEMAlgoPtr BEMAlgoImplFactory::create(const bemfield_vector& fields)
   // if all fields are surfaces, there exists a measurement and a source surface, then use the surface-to-surface algorithm... else fail
   if (allsurfaces && hasmeasurementsurf && hassourcesurf)
   {
-    return boost::make_shared<SurfaceToSurface>();
+    return boost::make_shared<SurfaceToSurface>(compressionTolerance);
   }
   else
   {
@@ -1089,6 +1183,9 @@ MatrixHandle SurfaceToSurface::compute(const bemfield_vector& fields) const
     }
   }
 
+  if (compressionTolerance_ > 0)
+    return computeCompressed(fields, sourcefieldindices, measurementfieldindices);
+
   std::vector<int> fieldNodeSize(fields.size());
   std::transform(fields.begin(), fields.end(), fieldNodeSize.begin(), [this](const bemfield& f) { return numNodes(f.field_); } );
   DenseBlockMatrix EE(fieldNodeSize, fieldNodeSize);
@@ -1251,6 +1348,128 @@ MatrixHandle SurfaceToSurface::compute(const bemfield_vector& fields) const
   //MatrixHandle TransferMatrix1 = inv(Pmm - Gms * Gss * Psm) * (Gms * Gss * Pss - Pms);
 }
 
+MatrixHandle SurfaceToSurface::computeCompressed(const bemfield_vector& fields,
+  const std::vector<int>& sourcefieldindices, const std::vector<int>& measurementfieldindices) const
+{
+  // Same math as compute(), but the blocks Pms, Psm and Gms that couple a
+  // measurement surface to a source surface are hierarchical matrices and
+  // never exist as dense matrices. Only their products with the dense
+  // blocks are formed.
+  double op_cond=0.0;
+  const int Nsources = static_cast<int>(sourcefieldindices.size());
+  const int Nmeasurements = static_cast<int>(measurementfieldindices.size());
+
+  std::vector<int> sourceFieldNodeSize, sourceOffset, measurementNodeSize, measurementOffset;
+  int offset = 0;
+  for (int s : sourcefieldindices)
+  {
+    sourceOffset.push_back(offset);
+    sourceFieldNodeSize.push_back(numNodes(fields[s].field_));
+    offset += sourceFieldNodeSize.back();
+  }
+  offset = 0;
+  for (int m : measurementfieldindices)
+  {
+    measurementOffset.push_back(offset);
+    measurementNodeSize.push_back(numNodes(fields[m].field_));
+    offset += measurementNodeSize.back();
+  }
+
+  // Blocks within the measurement surfaces and within the source surfaces stay dense
+  DenseBlockMatrix Pmm(measurementNodeSize, measurementNodeSize);
+  for(int i = 0; i < Nmeasurements; i++)
+  {
+    for(int j = 0; j < Nmeasurements; j++)
+    {
+      const bemfield& fi = fields[measurementfieldindices[i]];
+      const bemfield& fj = fields[measurementfieldindices[j]];
+      auto block = Pmm.blockRef(i,j);
+      if (i == j)
+        make_auto_P_compute(fi.field_->vmesh(), block, fi.insideconductivity, fi.outsideconductivity, op_cond);
+      else
+        make_cross_P_compute(fi.field_->vmesh(), fj.field_->vmesh(), block, fj.insideconductivity, fj.outsideconductivity, op_cond);
+    }
+  }
+
+  DenseBlockMatrix Pss(sourceFieldNodeSize, sourceFieldNodeSize);
+  for(int i = 0; i < Nsources; i++)
+  {
+    for(int j = 0; j < Nsources; j++)
+    {
+      const bemfield& fi = fields[sourcefieldindices[i]];
+      const bemfield& fj = fields[sourcefieldindices[j]];
+      auto block = Pss.blockRef(i,j);
+      if (i == j)
+        make_auto_P_compute(fi.field_->vmesh(), block, fi.insideconductivity, fi.outsideconductivity, op_cond);
+      else
+        make_cross_P_compute(fi.field_->vmesh(), fj.field_->vmesh(), block, fj.insideconductivity, fj.outsideconductivity, op_cond);
+    }
+  }
+
+  // Conductivities of the G blocks are picked as in the dense assembly of EJ
+  DenseBlockMatrix Gss(sourceFieldNodeSize, sourceFieldNodeSize);
+  std::vector<std::vector<HierarchicalMatrixHandle> > Gms(Nmeasurements, std::vector<HierarchicalMatrixHandle>(Nsources));
+  for(int j = 0; j < Nsources; j++)
+  {
+    VMesh* source = fields[sourcefieldindices[j]].field_->vmesh();
+    std::vector<double> triangleareas;
+    pre_calc_tri_areas(source, triangleareas);
+
+    for(int i = 0; i < Nsources; i++)
+    {
+      const bemfield& fi = fields[sourcefieldindices[i]];
+      auto block = Gss.blockRef(i,j);
+      if (i == j)
+        make_auto_G_compute(source, block, fi.insideconductivity, fi.outsideconductivity, op_cond, triangleareas);
+      else
+        make_cross_G_compute(fi.field_->vmesh(), source, block, fields[j].insideconductivity, fields[j].outsideconductivity, op_cond, triangleareas);
+    }
+    for(int i = 0; i < Nmeasurements; i++)
+    {
+      Gms[i][j] = make_cross_G_compressed(fields[measurementfieldindices[i]].field_->vmesh(), source,
+        fields[j].insideconductivity, fields[j].outsideconductivity, triangleareas, compressionTolerance_);
+    }
+  }
+
+  std::vector<std::vector<HierarchicalMatrixHandle> > Pms(Nmeasurements, std::vector<HierarchicalMatrixHandle>(Nsources));
+  std::vector<std::vector<HierarchicalMatrixHandle> > Psm(Nsources, std::vector<HierarchicalMatrixHandle>(Nmeasurements));
+  for(int i = 0; i < Nmeasurements; i++)
+  {
+    for(int j = 0; j < Nsources; j++)
+    {
+      const bemfield& fm = fields[measurementfieldindices[i]];
+      const bemfield& fs = fields[sourcefieldindices[j]];
+      Pms[i][j] = make_cross_P_compressed(fm.field_->vmesh(), fs.field_->vmesh(), fs.insideconductivity, fs.outsideconductivity, compressionTolerance_);
+      Psm[j][i] = make_cross_P_compressed(fs.field_->vmesh(), fm.field_->vmesh(), fm.insideconductivity, fm.outsideconductivity, compressionTolerance_);
+    }
+  }
+
+  // Y = Gms*iGss
+  DenseMatrix iGss = Gss.matrix().inverse();
+  DenseMatrix Y = DenseMatrix::Zero(Pmm.matrix().rows(), Pss.matrix().cols());
+  for(int i = 0; i < Nmeasurements; i++)
+    for(int j = 0; j < Nsources; j++)
+      Y.middleRows(measurementOffset[i], measurementNodeSize[i]) +=
+        Gms[i][j]->multiply(DenseMatrix(iGss.middleRows(sourceOffset[j], sourceFieldNodeSize[j])));
+
+  // C = Pmm - Y*Psm, with Y*Psm = (Psm^T * Y^T)^T
+  DenseMatrix C = Pmm.matrix();
+  for(int j = 0; j < Nsources; j++)
+  {
+    DenseMatrix Yt = Y.middleCols(sourceOffset[j], sourceFieldNodeSize[j]).transpose();
+    for(int i = 0; i < Nmeasurements; i++)
+      C.middleCols(measurementOffset[i], measurementNodeSize[i]) -= Psm[j][i]->multiplyTransposed(Yt).transpose();
+  }
+
+  // D = Y*Pss - Pms
+  DenseMatrix D = Y * Pss.matrix();
+  for(int i = 0; i < Nmeasurements; i++)
+    for(int j = 0; j < Nsources; j++)
+      Pms[i][j]->addTo(D, measurementOffset[i], sourceOffset[j], -1.0);
+
+  return boost::make_shared<DenseMatrix>(C.inverse() * D);
+}
+
 
 MatrixHandle SurfaceAndPoints::compute(const bemfield_vector& fields) const
 {
@@ -1310,6 +1529,24 @@ MatrixHandle SurfaceAndPoints::compute(const bemfield_vector& fields) const
   DenseMatrixHandle Gss;
   DenseMatrixHandle Pns;
   DenseMatrixHandle Gns;
+
+  if (compressionTolerance_ > 0)
+  {
+    // P_nodes_surf and G_nodes_surf as hierarchical matrices, applied to the
+    // dense inv( G_surf_surf) * P_surf_surf
+    std::vector<double> area;
+    pre_calc_tri_areas( surface, area );
+    make_auto_P( surface, Pss, 1.0, 0.0, 1.0 );
+    make_auto_G( surface, Gss, 1.0, 0.0, 1.0, area );
+    DenseMatrix GP = Gss->inverse() * *Pss;
+
+    auto Pns_h = make_cross_P_compressed( nodes, surface, 1.0, 0.0, compressionTolerance_ );
+    auto Gns_h = make_cross_G_compressed( nodes, surface, 1.0, 0.0, area, compressionTolerance_ );
+    auto T = boost::make_shared<DenseMatrix>(-Gns_h->multiply(GP));
+    Pns_h->addTo(*T, 0, 0);
+    return T;
+  }
+
   make_auto_P( surface, Pss, 1.0, 0.0, 1.0 );
   make_cross_P( nodes, surface, Pns, 1.0, 0.0, 1.0 );
 
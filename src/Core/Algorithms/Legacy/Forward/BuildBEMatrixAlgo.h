@@ -48,6 +48,10 @@ DEALINGS IN THE SOFTWARE.
 namespace SCIRun {
   namespace Core {
     namespace Algorithms {
+      namespace Math {
+        class HierarchicalMatrix;
+      }
+
       namespace Forward {
 
         ALGORITHM_PARAMETER_DECL(FieldNameList);
@@ -55,8 +59,10 @@ namespace SCIRun {
         ALGORITHM_PARAMETER_DECL(BoundaryConditionList);
         ALGORITHM_PARAMETER_DECL(InsideConductivityList);
         ALGORITHM_PARAMETER_DECL(OutsideConductivityList);
+        ALGORITHM_PARAMETER_DECL(CrossBlockCompressionTolerance);
 
         typedef std::vector<std::string> FieldTypeListType;
+        typedef boost::shared_ptr<Math::HierarchicalMatrix> HierarchicalMatrixHandle;
 
         class SCISHARE BuildBEMatrixBase
         {
@@ -113,6 +119,8 @@ namespace SCIRun {
             const Geometry::Vector&,
             const Geometry::Vector& );
 
+          static void get_radon_weights( Datatypes::DenseMatrix&, double&, double& );
+
         public:
           static void make_cross_G( VMesh*,
             VMesh*,
@@ -154,6 +162,22 @@ namespace SCIRun {
           static void make_cross_P_allocate( VMesh*,
             VMesh*, Datatypes::DenseMatrixHandle&);
 
+          /// Cross blocks between two different surfaces as hierarchical
+          /// matrices, with far apart groups of nodes coupled through low rank
+          /// blocks. tolerance is the relative accuracy of those blocks.
+          static HierarchicalMatrixHandle make_cross_P_compressed( VMesh*,
+            VMesh*,
+            double,
+            double,
+            double );
+
+          static HierarchicalMatrixHandle make_cross_G_compressed( VMesh*,
+            VMesh*,
+            double,
+            double,
+            const std::vector<double>&,
+            double );
+
           static void pre_calc_tri_areas(VMesh*, std::vector<double>&);
 
           static int compute_parent(const std::vector<VMesh*> &meshes, int index);
@@ -226,7 +250,9 @@ namespace SCIRun {
         class SCISHARE BEMAlgoImplFactory
         {
         public:
-          static BEMAlgoPtr create(const bemfield_vector& fields);
+          /// A positive compressionTolerance assembles the blocks that couple
+          /// different surfaces as hierarchical matrices instead of dense ones.
+          static BEMAlgoPtr create(const bemfield_vector& fields, double compressionTolerance = 0.0);
         };
 
       }}}}
@@ -0,0 +1,238 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Legacy/Forward/BuildBEMatrixAlgo.h>
+#include <Core/Algorithms/Math/HierarchicalMatrix/HierarchicalMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Forward;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  // Latitude/longitude sphere, triangles oriented outward
+  FieldHandle sphere(double radius, int rings, int segments)
+  {
+    FieldInformation fi(TRISURFMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+
+    std::vector<Point> points;
+    points.push_back(Point(0, 0, radius));
+    for (int r = 1; r < rings; ++r)
+    {
+      const double theta = M_PI * r / rings;
+      for (int s = 0; s < segments; ++s)
+      {
+        const double phi = 2 * M_PI * s / segments + 0.3 * r;
+        points.push_back(Point(radius * std::sin(theta) * std::cos(phi), radius * std::sin(theta) * std::sin(phi), radius * std::cos(theta)));
+      }
+    }
+    points.push_back(Point(0, 0, -radius));
+    for (const auto& p : points)
+      mesh->add_point(p);
+
+    auto addTriangle = [&](VMesh::index_type a, VMesh::index_type b, VMesh::index_type c)
+    {
+      const Vector centroid = (Vector(points[a]) + Vector(points[b]) + Vector(points[c])) / 3.0;
+      if (Dot(Cross(points[b] - points[a], points[c] - points[a]), centroid) < 0)
+        std::swap(b, c);
+      VMesh::Node::array_type nodes(3);
+      nodes[0] = a; nodes[1] = b; nodes[2] = c;
+      mesh->add_elem(nodes);
+    };
+    auto ring = [segments](int r, int s) { return static_cast<VMesh::index_type>(1 + (r - 1) * segments + (s % segments)); };
+
+    const VMesh::index_type south = static_cast<VMesh::index_type>(points.size() - 1);
+    for (int s = 0; s < segments; ++s)
+    {
+      addTriangle(0, ring(1, s), ring(1, s + 1));
+      for (int r = 1; r + 1 < rings; ++r)
+      {
+        addTriangle(ring(r, s), ring(r + 1, s), ring(r + 1, s + 1));
+        addTriangle(ring(r, s), ring(r + 1, s + 1), ring(r, s + 1));
+      }
+      addTriangle(south, ring(rings - 1, s + 1), ring(rings - 1, s));
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  FieldHandle pointsInside(double radius, int count)
+  {
+    FieldInformation fi(POINTCLOUDMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    for (int i = 0; i < count; ++i)
+    {
+      const double r = radius * (0.2 + 0.8 * (i % 7) / 7.0);
+      const double theta = 0.37 + 2.3 * i, phi = 1.1 * i;
+      field->vmesh()->add_point(Point(r * std::sin(theta) * std::cos(phi), r * std::sin(theta) * std::sin(phi), r * std::cos(theta)));
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  // Torso-like outer measurement surface around a heart-like source surface
+  bemfield_vector twoSurfaceModel(int detail = 1)
+  {
+    bemfield outer(sphere(1.0, 8 * detail, 12 * detail));
+    outer.surface = true;
+    outer.insideconductivity = 1.0;
+    outer.outsideconductivity = 0.0;
+    outer.set_measurement_neumann();
+
+    bemfield inner(sphere(0.4, 6 * detail, 8 * detail));
+    inner.surface = true;
+    inner.insideconductivity = 0.0;
+    inner.outsideconductivity = 1.0;
+    inner.set_source_dirichlet();
+
+    return { outer, inner };
+  }
+
+  bemfield_vector surfaceAndPointsModel(int detail = 1)
+  {
+    bemfield surface(sphere(1.0, 8 * detail, 12 * detail));
+    surface.surface = true;
+    bemfield points(pointsInside(0.6, 60 * detail));
+    return { surface, points };
+  }
+
+  DenseMatrix transferMatrix(const bemfield_vector& fields, double compressionTolerance = 0.0)
+  {
+    auto algo = BEMAlgoImplFactory::create(fields, compressionTolerance);
+    EXPECT_TRUE(algo != nullptr);
+    return *castMatrix::toDense(algo->compute(fields));
+  }
+
+  // Reference values printed by the serial assembly this algorithm
+  // replaced, on the same models.
+  struct Fingerprint
+  {
+    Eigen::Index rows, cols;
+    double norm, sum, first, last, middle;
+  };
+
+  void expectMatches(const Fingerprint& expected, const DenseMatrix& T)
+  {
+    ASSERT_EQ(expected.rows, T.rows());
+    ASSERT_EQ(expected.cols, T.cols());
+    const double tol = 1e-10 * expected.norm;
+    EXPECT_NEAR(expected.norm, T.norm(), tol);
+    EXPECT_NEAR(expected.sum, T.sum(), tol);
+    EXPECT_NEAR(expected.first, T(0, 0), tol);
+    EXPECT_NEAR(expected.last, T(T.rows() - 1, T.cols() - 1), tol);
+    EXPECT_NEAR(expected.middle, T(T.rows() / 2, T.cols() / 3), tol);
+  }
+
+  struct CoreLimit
+  {
+    explicit CoreLimit(unsigned int max) { Parallel::SetMaximumCores(max); }
+    ~CoreLimit() { Parallel::SetMaximumCores(0); }
+  };
+}
+
+TEST(BuildBEMatrixAlgoTests, SurfaceToSurfaceMatchesSerialAssembly)
+{
+  auto fields = twoSurfaceModel();
+  const DenseMatrix T = transferMatrix(fields);
+  expectMatches({ 86, 42, 2.7746265540163635, -85.999999999999986, 0.084641891242121223, 0.084641891242115005, 0.051688403984889011 }, T);
+
+  CoreLimit serial(1);
+  EXPECT_EQ(T, transferMatrix(fields));
+}
+
+TEST(BuildBEMatrixAlgoTests, SurfaceAndPointsMatchesSerialAssembly)
+{
+  auto fields = surfaceAndPointsModel();
+  const DenseMatrix T = transferMatrix(fields);
+  expectMatches({ 60, 86, 1.0628260101022797, 60.000000000000071, 0.015554354825721973, 0.015492385108633031, 0.020373577598433515 }, T);
+
+  CoreLimit serial(1);
+  EXPECT_EQ(T, transferMatrix(fields));
+}
+
+TEST(BuildBEMatrixAlgoTests, CompressedCrossBlocksMatchDense)
+{
+  for (double tolerance : { 1e-4, 1e-8 })
+  {
+    auto fields = twoSurfaceModel(2);
+    const DenseMatrix dense = transferMatrix(fields);
+    const DenseMatrix compressed = transferMatrix(fields, tolerance);
+    EXPECT_LT((compressed - dense).norm(), 10 * tolerance * dense.norm()) << tolerance;
+
+    auto pointFields = surfaceAndPointsModel(2);
+    const DenseMatrix densePoints = transferMatrix(pointFields);
+    const DenseMatrix compressedPoints = transferMatrix(pointFields, tolerance);
+    EXPECT_LT((compressedPoints - densePoints).norm(), 10 * tolerance * densePoints.norm()) << tolerance;
+  }
+}
+
+TEST(BuildBEMatrixAlgoTests, CompressedCrossBlocksMatchDenseKernels)
+{
+  auto fields = twoSurfaceModel(2);
+  VMesh* outer = fields[0].field_->vmesh();
+  VMesh* inner = fields[1].field_->vmesh();
+  std::vector<double> area;
+  BuildBEMatrixBase::pre_calc_tri_areas(inner, area);
+
+  DenseMatrixHandle P, G;
+  BuildBEMatrixBase::make_cross_P(outer, inner, P, 1.0, 0.0, 1.0);
+  BuildBEMatrixBase::make_cross_G(outer, inner, G, 1.0, 0.0, 1.0, area);
+
+  const double tolerance = 1e-4;
+  auto Ph = BuildBEMatrixBase::make_cross_P_compressed(outer, inner, 1.0, 0.0, tolerance);
+  auto Gh = BuildBEMatrixBase::make_cross_G_compressed(outer, inner, 1.0, 0.0, area, tolerance);
+  EXPECT_GT(Ph->numLowRankBlocks(), 0);
+  EXPECT_LT(Ph->storedEntries(), P->rows() * P->cols());
+  EXPECT_GT(Gh->numLowRankBlocks(), 0);
+  EXPECT_LT(Gh->storedEntries(), G->rows() * G->cols());
+
+  DenseMatrix Pc = DenseMatrix::Zero(P->rows(), P->cols());
+  Ph->addTo(Pc, 0, 0);
+  DenseMatrix Gc = DenseMatrix::Zero(G->rows(), G->cols());
+  Gh->addTo(Gc, 0, 0);
+  EXPECT_LT((Pc - *P).norm(), 10 * tolerance * P->norm());
+  EXPECT_LT((Gc - *G).norm(), 10 * tolerance * G->norm());
+
+  const DenseMatrix x = DenseMatrix::Identity(P->cols(), P->cols());
+  EXPECT_LT((Ph->multiply(x) - *P).norm(), 10 * tolerance * P->norm());
+}
@@ -0,0 +1,348 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Legacy/Inverse/TikhonovSweep.h>
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithStandardTikhonovImpl.h>
+#include <Core/Algorithms/Legacy/Inverse/TikhonovAlgoAbstractBase.h>
+#include <Core/Algorithms/Math/HierarchicalMatrix/HierarchicalMatrix.h>
+#include <boost/random.hpp>
+#include <chrono>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Inverse;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  DenseMatrix randomMatrix(int rows, int cols, int seed)
+  {
+    boost::mt19937 rng(seed);
+    boost::normal_distribution<double> dist;
+    boost::variate_generator<boost::mt19937&, boost::normal_distribution<double> > normal(rng, dist);
+    DenseMatrix m(rows, cols);
+    for (int i = 0; i < rows; ++i)
+      for (int j = 0; j < cols; ++j)
+        m(i, j) = normal();
+    return m;
+  }
+
+  // forward matrix with singular values 10^(-4 i / rank), like a smoothing lead field
+  DenseMatrix decayingForwardMatrix(int rows, int cols, int seed)
+  {
+    const int rank = std::min(rows, cols);
+    DenseMatrix U = randomMatrix(rows, rank, seed).householderQr().householderQ() * DenseMatrix::Identity(rows, rank);
+    DenseMatrix V = randomMatrix(cols, rank, seed + 1).householderQr().householderQ() * DenseMatrix::Identity(cols, rank);
+    DenseMatrix S = DenseMatrix::Zero(rank, rank);
+    for (int i = 0; i < rank; ++i)
+      S(i, i) = std::pow(10.0, -4.0 * i / rank);
+    return U * S * V.transpose();
+  }
+
+  std::vector<double> logLambdas(double lambdaMin, double lambdaMax, int nLambda)
+  {
+    std::vector<double> lambdas(nLambda);
+    for (int j = 0; j < nLambda; ++j)
+      lambdas[j] = lambdaMin * std::pow(lambdaMax / lambdaMin, j / (nLambda - 1.0));
+    return lambdas;
+  }
+
+  // solution of the weighted normal equations (A^T C^T C A + lambda^2 R^T R) x = A^T C^T C y
+  DenseMatrix normalEquationsSolution(const DenseMatrix& A, const DenseMatrix& y, const DenseMatrix& R, const DenseMatrix& C, double lambda)
+  {
+    DenseMatrix CA = C * A;
+    DenseMatrix G = CA.transpose() * CA + lambda * lambda * R.transpose() * R;
+    return G.lu().solve(CA.transpose() * (C * y));
+  }
+}
+
+TEST(TikhonovSweepTests, LcurveMatchesSolvingForEachLambda)
+{
+  DenseMatrix A = randomMatrix(40, 60, 1);
+  DenseMatrix y = randomMatrix(40, 5, 2);
+  DenseMatrix empty;
+  SolveInverseProblemWithStandardTikhonovImpl standard(A, y, empty, empty, TikhonovAlgoAbstractBase::automatic,
+    TikhonovAlgoAbstractBase::solution_constrained, TikhonovAlgoAbstractBase::residual_constrained);
+  const TikhonovImpl& impl = standard;
+
+  TikhonovSweep sweep(A, y, empty, empty);
+  auto lambdas = logLambdas(1e-3, 10, 30);
+  std::vector<double> rho, eta;
+  sweep.computeLcurve(lambdas, rho, eta);
+
+  ASSERT_EQ(lambdas.size(), rho.size());
+  ASSERT_EQ(lambdas.size(), eta.size());
+  for (size_t j = 0; j < lambdas.size(); ++j)
+  {
+    DenseMatrix x = impl.computeInverseSolution(lambdas[j], false);
+    EXPECT_NEAR((A * x - y).norm(), rho[j], 1e-8 * (1 + rho[j]));
+    EXPECT_NEAR(x.norm(), eta[j], 1e-8 * (1 + eta[j]));
+    EXPECT_LT((sweep.computeInverseSolution(lambdas[j]) - x).norm(), 1e-8 * (1 + x.norm()));
+  }
+}
+
+TEST(TikhonovSweepTests, WeightedProblemMatchesNormalEquations)
+{
+  DenseMatrix A = randomMatrix(50, 30, 3);
+  DenseMatrix y = randomMatrix(50, 3, 4);
+  DenseMatrix R = DenseMatrix::Identity(30, 30) + 0.1 * randomMatrix(30, 30, 5);
+  DenseMatrix C = DenseMatrix::Identity(50, 50) + 0.1 * randomMatrix(50, 50, 6);
+
+  TikhonovSweep sweep(A, y, R, C);
+  auto lambdas = logLambdas(1e-2, 1, 5);
+  std::vector<double> rho, eta;
+  sweep.computeLcurve(lambdas, rho, eta);
+
+  for (size_t j = 0; j < lambdas.size(); ++j)
+  {
+    DenseMatrix expected = normalEquationsSolution(A, y, R, C, lambdas[j]);
+    DenseMatrix x = sweep.computeInverseSolution(lambdas[j]);
+    EXPECT_LT((x - expected).norm(), 1e-8 * expected.norm());
+    EXPECT_NEAR((C * (A * expected - y)).norm(), rho[j], 1e-8 * rho[j]);
+    EXPECT_NEAR((R * expected).norm(), eta[j], 1e-8 * eta[j]);
+  }
+}
+
+TEST(TikhonovSweepTests, SquaredWeightingsKeepTheirNorms)
+{
+  DenseMatrix A = randomMatrix(50, 30, 13);
+  DenseMatrix y = randomMatrix(50, 3, 14);
+  DenseMatrix R = DenseMatrix::Identity(30, 30) + 0.1 * randomMatrix(30, 30, 15);
+  DenseMatrix C = DenseMatrix::Identity(50, 50) + 0.1 * randomMatrix(50, 50, 16);
+  DenseMatrix squaredR = R.transpose() * R;
+  DenseMatrix squaredC = C.transpose() * C;
+
+  TikhonovSweep sweep(A, y, R, C, 0, true, true);
+  auto lambdas = logLambdas(1e-2, 1, 5);
+  std::vector<double> rho, eta;
+  sweep.computeLcurve(lambdas, rho, eta);
+
+  for (size_t j = 0; j < lambdas.size(); ++j)
+  {
+    DenseMatrix expected = normalEquationsSolution(A, y, R, C, lambdas[j]);
+    EXPECT_LT((sweep.computeInverseSolution(lambdas[j]) - expected).norm(), 1e-8 * expected.norm());
+    EXPECT_NEAR((squaredC * (A * expected - y)).norm(), rho[j], 1e-8 * rho[j]);
+    EXPECT_NEAR((squaredR * expected).norm(), eta[j], 1e-8 * eta[j]);
+  }
+}
+
+TEST(TikhonovSweepTests, PrecomputedSVDIsReused)
+{
+  DenseMatrix A = randomMatrix(40, 25, 17);
+  DenseMatrix y = randomMatrix(40, 4, 18);
+  DenseMatrix empty;
+  Eigen::JacobiSVD<DenseMatrix::EigenBase> svd(A, Eigen::ComputeFullU | Eigen::ComputeFullV);
+  DenseMatrix U = svd.matrixU();
+  DenseMatrix V = svd.matrixV();
+  DenseMatrix column = svd.singularValues();
+  DenseMatrix diagonal = DenseMatrix::Zero(25, 25);
+  diagonal.diagonal() = svd.singularValues();
+
+  TikhonovSweep factored(A, y, empty, empty);
+  auto fromColumn = TikhonovSweep::fromSVD(U, column, V, y);
+  auto fromDiagonal = TikhonovSweep::fromSVD(U, diagonal, V, y);
+  EXPECT_EQ(25, fromColumn.rank());
+  EXPECT_EQ(25, fromDiagonal.rank());
+
+  auto lambdas = logLambdas(1e-2, 1, 5);
+  std::vector<double> rho, eta, rhoPrecomputed, etaPrecomputed;
+  factored.computeLcurve(lambdas, rho, eta);
+  fromColumn.computeLcurve(lambdas, rhoPrecomputed, etaPrecomputed);
+  for (size_t j = 0; j < lambdas.size(); ++j)
+  {
+    EXPECT_NEAR(rho[j], rhoPrecomputed[j], 1e-8 * rho[j]);
+    EXPECT_NEAR(eta[j], etaPrecomputed[j], 1e-8 * eta[j]);
+    DenseMatrix expected = factored.computeInverseSolution(lambdas[j]);
+    EXPECT_LT((fromColumn.computeInverseSolution(lambdas[j]) - expected).norm(), 1e-8 * expected.norm());
+    EXPECT_LT((fromDiagonal.computeInverseSolution(lambdas[j]) - expected).norm(), 1e-8 * expected.norm());
+  }
+}
+
+TEST(TikhonovSweepTests, AlgorithmSolvesWithTheSweepThatPickedLambda)
+{
+  DenseMatrix A = decayingForwardMatrix(40, 60, 19);
+  DenseMatrix y = A * randomMatrix(60, 3, 20) + 1e-3 * randomMatrix(40, 3, 21);
+
+  AlgorithmInput input;
+  input[TikhonovAlgoAbstractBase::ForwardMatrix] = boost::make_shared<DenseMatrix>(A);
+  input[TikhonovAlgoAbstractBase::MeasuredPotentials] = boost::make_shared<DenseMatrix>(y);
+  input[TikhonovAlgoAbstractBase::WeightingInSourceSpace] = boost::make_shared<DenseMatrix>(DenseMatrix::Identity(60, 60));
+  input[TikhonovAlgoAbstractBase::WeightingInSensorSpace] = boost::make_shared<DenseMatrix>(DenseMatrix::Identity(40, 40));
+
+  auto solve = [&input](const std::string& sweepOption)
+  {
+    TikhonovAlgoAbstractBase algo;
+    algo.set(Parameters::TikhonovImplementation, std::string("standardTikhonov"));
+    algo.setOption(Parameters::LambdaSweepFactorization, sweepOption);
+    algo.set(Parameters::LambdaNum, 50);
+    return algo.run(input);
+  };
+
+  auto perLambda = solve("none");
+  auto swept = solve("svd");
+  EXPECT_EQ(perLambda.get<DenseMatrix>(TikhonovAlgoAbstractBase::Lambda_Index)->coeff(0, 0),
+    swept.get<DenseMatrix>(TikhonovAlgoAbstractBase::Lambda_Index)->coeff(0, 0));
+
+  DenseMatrix curve = *perLambda.get<DenseMatrix>(TikhonovAlgoAbstractBase::LambdaArray);
+  DenseMatrix sweptCurve = *swept.get<DenseMatrix>(TikhonovAlgoAbstractBase::LambdaArray);
+  EXPECT_LT((curve - sweptCurve).norm(), 1e-8 * curve.norm());
+
+  DenseMatrix expected = *perLambda.get<DenseMatrix>(TikhonovAlgoAbstractBase::InverseSolution);
+  DenseMatrix x = *swept.get<DenseMatrix>(TikhonovAlgoAbstractBase::InverseSolution);
+  EXPECT_LT((x - expected).norm(), 1e-8 * expected.norm());
+}
+
+TEST(TikhonovSweepTests, TimeFramesAreSolvedAsOneBatch)
+{
+  DenseMatrix A = randomMatrix(30, 45, 7);
+  DenseMatrix y = randomMatrix(30, 1, 8);
+  DenseMatrix frames = randomMatrix(30, 200, 9);
+  DenseMatrix empty;
+
+  TikhonovSweep sweep(A, y, empty, empty);
+  DenseMatrix batch = sweep.computeInverseSolution(0.1, frames);
+  ASSERT_EQ(45, batch.rows());
+  ASSERT_EQ(200, batch.cols());
+  for (int t = 0; t < frames.cols(); t += 37)
+  {
+    DenseMatrix frame = frames.col(t);
+    DenseMatrix expected = normalEquationsSolution(A, frame, DenseMatrix::Identity(45, 45), DenseMatrix::Identity(30, 30), 0.1);
+    EXPECT_LT((DenseMatrix(batch.col(t)) - expected).norm(), 1e-8 * expected.norm());
+  }
+}
+
+TEST(TikhonovSweepTests, RandomizedTruncationFollowsFullLcurve)
+{
+  DenseMatrix A = decayingForwardMatrix(200, 400, 10);
+  DenseMatrix y = A * randomMatrix(400, 2, 11) + 1e-3 * randomMatrix(200, 2, 12);
+  DenseMatrix empty;
+
+  TikhonovSweep full(A, y, empty, empty);
+  TikhonovSweep truncated(A, y, empty, empty, 120);
+  EXPECT_EQ(200, full.rank());
+  EXPECT_EQ(120, truncated.rank());
+  for (int i = 0; i < 20; ++i)
+    EXPECT_NEAR(full.singularValues()[i], truncated.singularValues()[i], 1e-8);
+
+  // lambdas above the discarded singular values see nearly the same curve
+  auto lambdas = logLambdas(1e-2, 1, 20);
+  std::vector<double> rhoFull, etaFull, rhoTruncated, etaTruncated;
+  full.computeLcurve(lambdas, rhoFull, etaFull);
+  truncated.computeLcurve(lambdas, rhoTruncated, etaTruncated);
+  for (size_t j = 0; j < lambdas.size(); ++j)
+  {
+    EXPECT_NEAR(rhoFull[j], rhoTruncated[j], 2e-2 * rhoFull[j]);
+    EXPECT_NEAR(etaFull[j], etaTruncated[j], 1e-2 * etaFull[j]);
+  }
+}
+
+TEST(TikhonovSweepTests, LinearOperatorMatchesDenseMatrix)
+{
+  DenseMatrix A = randomMatrix(40, 25, 15);
+  DenseMatrix y = randomMatrix(40, 4, 16);
+  DenseMatrix R = DenseMatrix::Identity(25, 25) + 0.1 * randomMatrix(25, 25, 17);
+  DenseMatrix C = DenseMatrix::Identity(40, 40) + 0.1 * randomMatrix(40, 40, 18);
+
+  // without a truncation the range finder spans the whole range, so the operator gives the exact sweep
+  TikhonovSweep dense(A, y, R, C);
+  TikhonovSweep products(DenseLinearOperator(A), y, R, C);
+  EXPECT_EQ(dense.rank(), products.rank());
+  for (double lambda : { 1e-2, 1e-1, 1.0 })
+  {
+    DenseMatrix expected = dense.computeInverseSolution(lambda);
+    EXPECT_LT((products.computeInverseSolution(lambda) - expected).norm(), 1e-8 * expected.norm());
+  }
+}
+
+TEST(TikhonovSweepTests, HierarchicalForwardMatrixIsNeverFormed)
+{
+  // sensors on a box around a separated cloud of sources, with a smooth single layer like kernel
+  boost::mt19937 rng(19);
+  boost::uniform_real<double> range(-0.5, 0.5);
+  boost::variate_generator<boost::mt19937&, boost::uniform_real<double> > uniform(rng, range);
+  std::vector<Point> sensors, sources;
+  for (int i = 0; i < 150; ++i)
+    sensors.push_back(Point(3 * uniform(), 3 * uniform(), 3.5 + uniform()));
+  for (int j = 0; j < 300; ++j)
+    sources.push_back(Point(uniform(), uniform(), uniform()));
+  auto kernel = [&](SCIRun::index_type i, SCIRun::index_type j) { return 1.0 / ((sensors[i] - sources[j]).length() + 0.05); };
+
+  DenseMatrix A(sensors.size(), sources.size());
+  for (size_t i = 0; i < sensors.size(); ++i)
+    for (size_t j = 0; j < sources.size(); ++j)
+      A(i, j) = kernel(i, j);
+  HierarchicalMatrix H(sensors, sources, kernel, 1e-8);
+  ASSERT_GT(H.numLowRankBlocks(), 0);
+
+  DenseMatrix y = A * randomMatrix(300, 3, 20);
+  DenseMatrix empty;
+  TikhonovSweep dense(A, y, empty, empty, 30);
+  TikhonovSweep compressed(H, y, empty, empty, 30);
+
+  auto lambdas = logLambdas(1e-4, 1, 10);
+  std::vector<double> rhoDense, etaDense, rhoCompressed, etaCompressed;
+  dense.computeLcurve(lambdas, rhoDense, etaDense);
+  compressed.computeLcurve(lambdas, rhoCompressed, etaCompressed);
+  // the data lies in the range of A, so the residuals are compared against the data
+  for (size_t j = 0; j < lambdas.size(); ++j)
+  {
+    EXPECT_NEAR(rhoDense[j], rhoCompressed[j], 1e-6 * y.norm());
+    EXPECT_NEAR(etaDense[j], etaCompressed[j], 1e-5 * etaDense[j]);
+  }
+}
+
+TEST(TikhonovSweepTests, DISABLED_LcurveBenchmark)
+{
+  DenseMatrix A = randomMatrix(500, 3000, 13);
+  DenseMatrix y = randomMatrix(500, 200, 14);
+  DenseMatrix empty;
+  auto lambdas = logLambdas(1e-6, 1, 100);
+
+  auto start = std::chrono::steady_clock::now();
+  SolveInverseProblemWithStandardTikhonovImpl standard(A, y, empty, empty, TikhonovAlgoAbstractBase::automatic,
+    TikhonovAlgoAbstractBase::solution_constrained, TikhonovAlgoAbstractBase::residual_constrained);
+  const TikhonovImpl& impl = standard;
+  for (auto lambda : lambdas)
+  {
+    DenseMatrix x = impl.computeInverseSolution(lambda, false);
+    (A * x - y).norm();
+  }
+  auto loop = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  TikhonovSweep sweep(A, y, empty, empty);
+  std::vector<double> rho, eta;
+  sweep.computeLcurve(lambdas, rho, eta);
+  auto swept = std::chrono::steady_clock::now() - start;
+
+  std::cout << "solve per lambda: " << std::chrono::duration<double>(loop).count() << " s, "
+    << "shared factorization: " << std::chrono::duration<double>(swept).count() << " s" << std::endl;
+}
@@ -30,6 +30,7 @@
 //    Date       : September 06th, 2017 (last update)
 
 #include <boost/bind.hpp>
+#include <memory>
 #include <boost/lexical_cast.hpp>
 
 // Tikhonov specific headers
@@ -38,6 +39,7 @@
 #include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithStandardTikhonovImpl.h>
 #include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTikhonovSVD_impl.h>
 #include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTSVD_impl.h>
+#include <Core/Algorithms/Legacy/Inverse/TikhonovSweep.h>
 
 // Datatypes
 #include <Core/Datatypes/Matrix.h>
@@ -89,6 +91,8 @@ ALGORITHM_PARAMETER_DEF( Inverse, LambdaMax);
 ALGORITHM_PARAMETER_DEF( Inverse, LambdaNum);
 ALGORITHM_PARAMETER_DEF( Inverse, LambdaResolution);
 ALGORITHM_PARAMETER_DEF( Inverse, LambdaSliderValue);
+ALGORITHM_PARAMETER_DEF( Inverse, LambdaSweepFactorization);
+ALGORITHM_PARAMETER_DEF( Inverse, LambdaSweepRank);
 //ALGORITHM_PARAMETER_DEF( Inverse, LambdaCorner);
 //ALGORITHM_PARAMETER_DEF( Inverse, LCurveText);
 ALGORITHM_PARAMETER_DEF( Inverse, regularizationSolutionSubcase);
@@ -105,6 +109,8 @@ TikhonovAlgoAbstractBase::TikhonovAlgoAbstractBase()
 	addParameter(Parameters::LambdaNum,200);
 	addParameter(Parameters::LambdaResolution,1e-6);
 	addParameter(Parameters::LambdaSliderValue,0);
+	addOption(Parameters::LambdaSweepFactorization, "none", "none|svd|randomized");
+	addParameter(Parameters::LambdaSweepRank,100);
 	addParameter(Parameters::regularizationSolutionSubcase,solution_constrained);
 	addParameter(Parameters::regularizationResidualSubcase,residual_constrained);
 }
@@ -177,6 +183,26 @@ bool TikhonovAlgoAbstractBase::checkInputMatrixSizes( const AlgorithmInput & inp
   return true;
 }
 
+namespace
+{
+  // the lambda sweep works with R and C themselves; squared weightings R^T R are factored back by Cholesky
+  DenseMatrix sweepWeighting(MatrixHandle weighting, bool squared)
+  {
+    if (!weighting)
+      return DenseMatrix();
+
+    auto dense = castMatrix::toDense(weighting);
+    if (!squared)
+      return *dense;
+
+    auto LLTweighting = dense->llt();
+    if (LLTweighting.info() != Eigen::Success)
+      THROW_ALGORITHM_INPUT_ERROR_SIMPLE("Squared regularization matrix is not positive definite.");
+    DenseMatrix::EigenBase R = LLTweighting.matrixU();
+    return R;
+  }
+}
+
 AlgorithmOutput TikhonovAlgoAbstractBase::run(const AlgorithmInput & input) const
 {
 	auto forwardMatrix = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::ForwardMatrix));
@@ -232,6 +258,32 @@ AlgorithmOutput TikhonovAlgoAbstractBase::run(const AlgorithmInput & input) cons
 		THROW_ALGORITHM_PROCESSING_ERROR("Not a valid Tikhonov Implementation selection");
 	}
 
+  // the sweep applies Tikhonov filter factors, which do not describe the truncated SVD
+  std::unique_ptr<TikhonovSweep> sweep;
+  auto sweepOption = getOption(Parameters::LambdaSweepFactorization);
+  if (sweepOption != "none" && implOption != "TSVD")
+  {
+    auto matrixU = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::matrixU));
+    auto singularValues = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::singularValues));
+    auto matrixV = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::matrixV));
+
+    // a precomputed SVD describes A alone, so it only stands in for the factorization without weightings
+    if (implOption == "TikhonovSVD" && matrixU && singularValues && matrixV && !sourceWeighting && !sensorWeighting)
+    {
+      sweep.reset(new TikhonovSweep(TikhonovSweep::fromSVD(*matrixU, *singularValues, *matrixV, *measuredData)));
+    }
+    else
+    {
+      // factor once; the L-curve and the final solution both come from this factorization
+      const int truncatedRank = sweepOption == "randomized" ? get(Parameters::LambdaSweepRank).toInt() : 0;
+      const bool squaredSource = get(Parameters::regularizationSolutionSubcase).toInt() == solution_constrained_squared;
+      const bool squaredSensor = get(Parameters::regularizationResidualSubcase).toInt() == residual_constrained_squared;
+      DenseMatrix R = sweepWeighting(sourceWeighting, squaredSource);
+      DenseMatrix C = sweepWeighting(sensorWeighting, squaredSensor);
+      sweep.reset(new TikhonovSweep(*forwardMatrix, *measuredData, R, C, truncatedRank, squaredSource, squaredSensor));
+    }
+  }
+
   double lambda = 0;
   int lambda_index = 0;
   AlgorithmOutput output;
@@ -253,7 +305,7 @@ AlgorithmOutput TikhonovAlgoAbstractBase::run(const AlgorithmInput & input) cons
   }
   else if (RegularizationMethod_gotten == "lcurve")
   {
-    lambda = computeLcurve( *algoImpl, input,  lambdamatrix, lambda_index);
+    lambda = computeLcurve( *algoImpl, input,  lambdamatrix, lambda_index, sweep.get());
   }
 	else
 	{
@@ -261,7 +313,7 @@ AlgorithmOutput TikhonovAlgoAbstractBase::run(const AlgorithmInput & input) cons
 	}
 
   // compute final inverse solution
-	auto solution = algoImpl->computeInverseSolution(lambda, true);
+	auto solution = sweep ? sweep->computeInverseSolution(lambda) : algoImpl->computeInverseSolution(lambda, true);
 
 	// Set outputs
 
@@ -273,7 +325,8 @@ AlgorithmOutput TikhonovAlgoAbstractBase::run(const AlgorithmInput & input) cons
 	return output;
 }
 
-double TikhonovAlgoAbstractBase::computeLcurve( const SCIRun::Core::Algorithms::Inverse::TikhonovImpl& algoImpl, const AlgorithmInput & input , DenseMatrixHandle& lambdamatrix, int& lambda_index) const
+double TikhonovAlgoAbstractBase::computeLcurve( const SCIRun::Core::Algorithms::Inverse::TikhonovImpl& algoImpl, const AlgorithmInput & input , DenseMatrixHandle& lambdamatrix, int& lambda_index,
+  const TikhonovSweep* sweep) const
 {
 	// get inputs
 	auto forwardMatrix = input.get<Matrix>(TikhonovAlgoAbstractBase::ForwardMatrix);
@@ -299,47 +352,60 @@ double TikhonovAlgoAbstractBase::computeLcurve( const SCIRun::Core::Algorithms::
 
   lambdaArray[0] = lambdaMin;
 
-  // for all lambdas
-  for (int j = 0; j < nLambda; j++)
+  if (sweep)
   {
-    solution = algoImpl.computeInverseSolution( lambdaArray[j], false);
-    lambdamatrix->put(j,0,lambdaArray[j]);
-
-    // if using source regularization matrix, apply it to compute Rx (for the eta computations)
-    if (sourceWeighting)
+    sweep->computeLcurve(lambdaArray, rho, eta);
+    for (int j = 0; j < nLambda; j++)
     {
-      if (solution.nrows() == sourceWeighting->ncols()) // check that regularization matrix and solution match sizes
+      lambdamatrix->put(j,0,lambdaArray[j]);
+      lambdamatrix->put(j,1,rho[j]);
+      lambdamatrix->put(j,2,eta[j]);
+    }
+  }
+  else
+  {
+    // otherwise solve again for each lambda
+    for (int j = 0; j < nLambda; j++)
+    {
+      solution = algoImpl.computeInverseSolution( lambdaArray[j], false);
+      lambdamatrix->put(j,0,lambdaArray[j]);
+
+      // if using source regularization matrix, apply it to compute Rx (for the eta computations)
+      if (sourceWeighting)
       {
-        auto sw = castMatrix::toDense(sourceWeighting);
-        Rx = (*sw) * solution;
+        if (solution.nrows() == sourceWeighting->ncols()) // check that regularization matrix and solution match sizes
+        {
+          auto sw = castMatrix::toDense(sourceWeighting);
+          Rx = (*sw) * solution;
+        }
+        else
+        {
+          BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage(" Solution weighting matrix unexpectedly does not fit to compute the weighted solution norm. "));
+        }
       }
       else
+        Rx = solution;
+
+      auto forward = castMatrix::toDense(forwardMatrix);
+      auto Ax = (*forward) * solution;
+      auto measured = castMatrix::toDense(measuredData);
+      auto residualSolution = Ax - (*measured);
+
+      // if using source regularization matrix, apply it to compute Rx (for the eta computations)
+      if (sensorWeighting)
       {
-        BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage(" Solution weighting matrix unexpectedly does not fit to compute the weighted solution norm. "));
+        auto sw = castMatrix::toDense(sensorWeighting);
+        CAx = (*sw) * residualSolution;
       }
-    }
-    else
-      Rx = solution;
-
-    auto forward = castMatrix::toDense(forwardMatrix);
-    auto Ax = (*forward) * solution;
-    auto measured = castMatrix::toDense(measuredData);
-    auto residualSolution = Ax - (*measured);
+      else
+        CAx = residualSolution;
 
-    // if using source regularization matrix, apply it to compute Rx (for the eta computations)
-    if (sensorWeighting)
-    {
-      auto sw = castMatrix::toDense(sensorWeighting);
-      CAx = (*sw) * residualSolution;
+      // compute rho and eta. Using Frobenious norm when using matrices
+      rho[j] = CAx.norm();
+      eta[j] = Rx.norm();
+      lambdamatrix->put(j,1,rho[j]);
+      lambdamatrix->put(j,2,eta[j]);
     }
-    else
-      CAx = residualSolution;
-
-    // compute rho and eta. Using Frobenious norm when using matrices
-    rho[j] = CAx.norm();
-    eta[j] = Rx.norm();
-    lambdamatrix->put(j,1,rho[j]);
-    lambdamatrix->put(j,2,eta[j]);
   }
 
   // Find corner in L-curve
@@ -41,6 +41,7 @@ namespace Core {
 namespace Algorithms {
 namespace Inverse {
 
+	class TikhonovSweep;
 
 	ALGORITHM_PARAMETER_DECL(TikhonovImplementation);
 	ALGORITHM_PARAMETER_DECL(RegularizationMethod);
@@ -53,6 +54,8 @@ namespace Inverse {
 	ALGORITHM_PARAMETER_DECL(LambdaNum);
 	ALGORITHM_PARAMETER_DECL(LambdaResolution);
 	ALGORITHM_PARAMETER_DECL(LambdaSliderValue);
+	ALGORITHM_PARAMETER_DECL(LambdaSweepFactorization);
+	ALGORITHM_PARAMETER_DECL(LambdaSweepRank);
 	//ALGORITHM_PARAMETER_DECL(LambdaCorner);
 	//ALGORITHM_PARAMETER_DECL(LCurveText);
 
@@ -96,7 +99,9 @@ namespace Inverse {
 		virtual AlgorithmOutput run(const AlgorithmInput &) const override;
 
 		static double FindCorner( const std::vector<double>& rho, const std::vector<double>& eta, const std::vector<double>& lambdaArray, const int nLambda,int& lambda_index );
-    double computeLcurve( const SCIRun::Core::Algorithms::Inverse::TikhonovImpl& algoImpl, const AlgorithmInput & input,  SCIRun::Core::Datatypes::DenseMatrixHandle& lambdamatrix, int& lambda_index ) const;
+    /// With a sweep, rho and eta come from its factorization; otherwise the problem is solved again for each lambda.
+    double computeLcurve( const SCIRun::Core::Algorithms::Inverse::TikhonovImpl& algoImpl, const AlgorithmInput & input,  SCIRun::Core::Datatypes::DenseMatrixHandle& lambdamatrix, int& lambda_index,
+      const TikhonovSweep* sweep = nullptr ) const;
 
 		bool checkInputMatrixSizes( const AlgorithmInput & input ) const;
 
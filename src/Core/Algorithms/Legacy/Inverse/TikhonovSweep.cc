@@ -0,0 +1,310 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+//    File       : TikhonovSweep.cc
+//    Date       : October 18th, 2026 (last update)
+
+#include <random>
+#include <Core/Algorithms/Legacy/Inverse/TikhonovSweep.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Utils/Exception.h>
+
+// EIGEN LIBRARY
+#include <Eigen/QR>
+#include <Eigen/SVD>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Inverse;
+using namespace SCIRun::Core::Algorithms::Math;
+
+namespace
+{
+  typedef DenseMatrix::EigenBase EigenMatrix;
+
+  // extra columns sampled by the randomized range finder, and the number of power iterations
+  // that sharpen it when the singular values decay slowly
+  const int RandomizedOversampling = 10;
+  const int RandomizedPowerIterations = 2;
+
+  DenseMatrix orthonormalColumns(const DenseMatrix& m)
+  {
+    Eigen::HouseholderQR<EigenMatrix> qr(m);
+    return qr.householderQ() * EigenMatrix::Identity(m.rows(), m.cols());
+  }
+
+  // C A R^-1 from the products of A; empty weightings stand for the identity
+  class WeightedOperator : public LinearOperator
+  {
+  public:
+    WeightedOperator(const LinearOperator& forward, const DenseMatrix& sensorWeighting, const DenseMatrix& sourceInverse) :
+      forward_(forward), sensorWeighting_(sensorWeighting), sourceInverse_(sourceInverse) {}
+
+    size_type rows() const override { return sensorWeighting_.size() > 0 ? sensorWeighting_.rows() : forward_.rows(); }
+    size_type cols() const override { return forward_.cols(); }
+
+    DenseMatrix multiply(const DenseMatrix& x) const override
+    {
+      DenseMatrix y = forward_.multiply(sourceInverse_.size() > 0 ? DenseMatrix(sourceInverse_ * x) : x);
+      return sensorWeighting_.size() > 0 ? DenseMatrix(sensorWeighting_ * y) : y;
+    }
+
+    DenseMatrix multiplyTransposed(const DenseMatrix& x) const override
+    {
+      DenseMatrix y = forward_.multiplyTransposed(sensorWeighting_.size() > 0 ? DenseMatrix(sensorWeighting_.transpose() * x) : x);
+      return sourceInverse_.size() > 0 ? DenseMatrix(sourceInverse_.transpose() * y) : y;
+    }
+
+  private:
+    const LinearOperator& forward_;
+    const DenseMatrix& sensorWeighting_;
+    const DenseMatrix& sourceInverse_;
+  };
+}
+
+TikhonovSweep::TikhonovSweep( const DenseMatrix& forwardMatrix, const DenseMatrix& measuredData,
+  const DenseMatrix& sourceWeighting, const DenseMatrix& sensorWeighting, int truncatedRank,
+  bool squaredSolutionNorm, bool squaredResidualNorm ) :
+  sensorWeighting_(sensorWeighting), residualOutsideRange_(0), weightedDataNorm_(0)
+{
+  // move the residual weighting into the operator: C A
+  DenseMatrix weightedForward = sensorWeighting_.size() > 0 ? DenseMatrix(sensorWeighting_ * forwardMatrix) : forwardMatrix;
+
+  // bring the problem into standard form with z = R x
+  DenseMatrix sourceInverse = invertSourceWeighting(sourceWeighting, forwardMatrix.cols());
+  if (sourceInverse.size() > 0)
+    weightedForward = weightedForward * sourceInverse;
+
+  const int maxRank = std::min(weightedForward.rows(), weightedForward.cols());
+  if (truncatedRank > 0 && truncatedRank < maxRank)
+    computeRandomizedSVD(DenseLinearOperator(weightedForward), truncatedRank);
+  else
+    computeFullSVD(weightedForward);
+
+  projectData(sourceWeighting, sourceInverse, measuredData, squaredSolutionNorm, squaredResidualNorm);
+}
+
+TikhonovSweep::TikhonovSweep( const LinearOperator& forwardOperator, const DenseMatrix& measuredData,
+  const DenseMatrix& sourceWeighting, const DenseMatrix& sensorWeighting, int truncatedRank,
+  bool squaredSolutionNorm, bool squaredResidualNorm ) :
+  sensorWeighting_(sensorWeighting), residualOutsideRange_(0), weightedDataNorm_(0)
+{
+  if (sensorWeighting_.size() > 0 && sensorWeighting_.cols() != forwardOperator.rows())
+    THROW_ALGORITHM_INPUT_ERROR_SIMPLE("Data Residual Weighting Matrix must have the same number of rows as the Forward Matrix !");
+
+  DenseMatrix sourceInverse = invertSourceWeighting(sourceWeighting, forwardOperator.cols());
+  WeightedOperator weightedForward(forwardOperator, sensorWeighting_, sourceInverse);
+
+  const int maxRank = std::min(weightedForward.rows(), weightedForward.cols());
+  computeRandomizedSVD(weightedForward, truncatedRank > 0 && truncatedRank < maxRank ? truncatedRank : maxRank);
+
+  projectData(sourceWeighting, sourceInverse, measuredData, squaredSolutionNorm, squaredResidualNorm);
+}
+
+TikhonovSweep TikhonovSweep::fromSVD( const DenseMatrix& matrixU, const DenseMatrix& singularValues,
+  const DenseMatrix& matrixV, const DenseMatrix& measuredData )
+{
+  DenseColumnMatrix values = singularValues.cols() == 1 ? DenseColumnMatrix(singularValues.col(0)) : DenseColumnMatrix(singularValues.diagonal());
+  const int rank = std::min<int>(values.nrows(), std::min(matrixU.cols(), matrixV.cols()));
+  if (matrixU.rows() != measuredData.rows())
+    THROW_ALGORITHM_INPUT_ERROR_SIMPLE("Input matrix dimensions must agree.");
+
+  TikhonovSweep sweep;
+  sweep.matrixU_ = matrixU.leftCols(rank);
+  sweep.singularValues_ = values.head(rank);
+  sweep.sourceBasis_ = matrixV.leftCols(rank);
+  sweep.projectData(DenseMatrix(), DenseMatrix(), measuredData, false, false);
+  return sweep;
+}
+
+DenseMatrix TikhonovSweep::invertSourceWeighting( const DenseMatrix& sourceWeighting, int N )
+{
+  if (sourceWeighting.size() == 0)
+    return DenseMatrix();
+
+  if (sourceWeighting.rows() != N || sourceWeighting.cols() != N)
+    THROW_ALGORITHM_INPUT_ERROR_SIMPLE("A lambda sweep needs a square solution regularization matrix with as many rows as columns in the Forward Matrix.");
+
+  auto LUsource = sourceWeighting.fullPivLu();
+  if (!LUsource.isInvertible())
+    THROW_ALGORITHM_INPUT_ERROR_SIMPLE("Regularization matrix in the source space is not invertible.");
+
+  return LUsource.inverse();
+}
+
+void TikhonovSweep::projectData( const DenseMatrix& sourceWeighting, const DenseMatrix& sourceInverse,
+  const DenseMatrix& measuredData, bool squaredSolutionNorm, bool squaredResidualNorm )
+{
+  // R^T R R^-1 V = R^T V, taken before the basis is mapped back to source space
+  DenseMatrix squaredSourceBasis;
+  if (squaredSolutionNorm && sourceWeighting.size() > 0)
+    squaredSourceBasis = sourceWeighting.transpose() * sourceBasis_;
+
+  if (sourceInverse.size() > 0)
+    sourceBasis_ = sourceInverse * sourceBasis_;
+
+  // project every time frame at once
+  DenseMatrix weightedData = sensorWeighting_.size() > 0 ? DenseMatrix(sensorWeighting_ * measuredData) : measuredData;
+  projectedData_ = matrixU_.transpose() * weightedData;
+  projectedDataNorms_.resize(projectedData_.rows());
+  for (int i = 0; i < projectedData_.rows(); ++i)
+    projectedDataNorms_[i] = projectedData_.row(i).squaredNorm();
+  residualOutsideRange_ = (weightedData - matrixU_ * projectedData_).squaredNorm();
+
+  if (squaredSourceBasis.size() == 0 && !(squaredResidualNorm && sensorWeighting_.size() > 0))
+    return;
+
+  // the squared norms couple the singular directions through U^T C C^T U and V^T R R^T V
+  const DenseMatrix dataGram = projectedData_ * projectedData_.transpose();
+  if (squaredSourceBasis.size() > 0)
+    solutionGram_ = (squaredSourceBasis.transpose() * squaredSourceBasis).cwiseProduct(dataGram);
+
+  if (squaredResidualNorm && sensorWeighting_.size() > 0)
+  {
+    // C^T C A R^-1 V = C^T U S, so C^T C (A x - y) = C^T U diag(g) U^T C y - C^T C y
+    const DenseMatrix squaredSensorBasis = sensorWeighting_.transpose() * matrixU_;
+    const DenseMatrix squaredData = sensorWeighting_.transpose() * weightedData;
+    residualGram_ = (squaredSensorBasis.transpose() * squaredSensorBasis).cwiseProduct(dataGram);
+    residualCross_ = (squaredSensorBasis.transpose() * squaredData).cwiseProduct(projectedData_).rowwise().sum();
+    weightedDataNorm_ = squaredData.squaredNorm();
+  }
+}
+
+void TikhonovSweep::computeFullSVD( const DenseMatrix& weightedForward )
+{
+  Eigen::BDCSVD<EigenMatrix> svd(weightedForward, Eigen::ComputeThinU | Eigen::ComputeThinV);
+  matrixU_ = svd.matrixU();
+  singularValues_ = svd.singularValues();
+  sourceBasis_ = svd.matrixV();
+}
+
+void TikhonovSweep::computeRandomizedSVD( const LinearOperator& weightedForward, int truncatedRank )
+{
+  const int M = weightedForward.rows();
+  const int N = weightedForward.cols();
+  const int samples = std::min(truncatedRank + RandomizedOversampling, std::min(M, N));
+
+  // fixed seed, so that repeated executions pick the same lambda
+  std::mt19937 generator(5489u);
+  std::normal_distribution<double> normal;
+  DenseMatrix omega(N, samples);
+  for (int i = 0; i < N; ++i)
+    for (int j = 0; j < samples; ++j)
+      omega(i, j) = normal(generator);
+
+  DenseMatrix Q = orthonormalColumns(weightedForward.multiply(omega));
+  for (int it = 0; it < RandomizedPowerIterations; ++it)
+  {
+    DenseMatrix Z = orthonormalColumns(weightedForward.multiplyTransposed(Q));
+    Q = orthonormalColumns(weightedForward.multiply(Z));
+  }
+
+  DenseMatrix B = weightedForward.multiplyTransposed(Q).transpose();
+  Eigen::BDCSVD<EigenMatrix> svd(B, Eigen::ComputeThinU | Eigen::ComputeThinV);
+  matrixU_ = Q * svd.matrixU().leftCols(truncatedRank);
+  singularValues_ = svd.singularValues().head(truncatedRank);
+  sourceBasis_ = svd.matrixV().leftCols(truncatedRank);
+}
+
+Eigen::VectorXd TikhonovSweep::filterFactors( double lambda ) const
+{
+  Eigen::VectorXd factors(rank());
+  for (int i = 0; i < rank(); ++i)
+  {
+    const double singVal = singularValues_[i];
+    const double denominator = singVal * singVal + lambda * lambda;
+    factors[i] = denominator > 0 ? singVal / denominator : 0.0;
+  }
+  return factors;
+}
+
+void TikhonovSweep::computeLcurve( const std::vector<double>& lambdaArray, std::vector<double>& rho, std::vector<double>& eta ) const
+{
+  const size_t nLambda = lambdaArray.size();
+  rho.assign(nLambda, 0.0);
+  eta.assign(nLambda, 0.0);
+
+  Parallel::ForRange(0, nLambda, [&](size_t begin, size_t end)
+  {
+    for (size_t j = begin; j < end; ++j)
+    {
+      // x = R^-1 V diag(f) U^T C y and C A x = U diag(g) U^T C y
+      const Eigen::VectorXd solutionFactors = filterFactors(lambdaArray[j]);
+      const Eigen::VectorXd dataFactors = solutionFactors.cwiseProduct(singularValues_);
+
+      double residual = residualOutsideRange_;
+      double solution = 0;
+      for (int i = 0; i < rank(); ++i)
+      {
+        const double residualFactor = 1 - dataFactors[i];
+        residual += residualFactor * residualFactor * projectedDataNorms_[i];
+        solution += solutionFactors[i] * solutionFactors[i] * projectedDataNorms_[i];
+      }
+
+      if (solutionGram_.size() > 0)
+        solution = solutionFactors.dot(solutionGram_ * solutionFactors);
+      if (residualGram_.size() > 0)
+        residual = dataFactors.dot(residualGram_ * dataFactors) - 2 * dataFactors.dot(residualCross_) + weightedDataNorm_;
+
+      rho[j] = std::sqrt(std::max(residual, 0.0));
+      eta[j] = std::sqrt(std::max(solution, 0.0));
+    }
+  });
+}
+
+DenseMatrix TikhonovSweep::solveFromProjection( double lambda, const DenseMatrix& projection ) const
+{
+  const Eigen::VectorXd factors = filterFactors(lambda);
+  DenseMatrix solution(sourceBasis_.rows(), projection.cols());
+
+  // time frames are independent, so blocks of them are filtered and mapped back in parallel
+  Parallel::ForRange(0, projection.cols(), [&](size_t begin, size_t end)
+  {
+    const int frames = static_cast<int>(end - begin);
+    solution.middleCols(begin, frames).noalias() = sourceBasis_ * (factors.asDiagonal() * projection.middleCols(begin, frames));
+  });
+  return solution;
+}
+
+DenseMatrix TikhonovSweep::computeInverseSolution( double lambda ) const
+{
+  return solveFromProjection(lambda, projectedData_);
+}
+
+DenseMatrix TikhonovSweep::computeInverseSolution( double lambda, const DenseMatrix& data ) const
+{
+  const int M = sensorWeighting_.size() > 0 ? sensorWeighting_.cols() : matrixU_.rows();
+  if (data.rows() != M)
+    THROW_ALGORITHM_INPUT_ERROR_SIMPLE("Input matrix dimensions must agree.");
+
+  if (sensorWeighting_.size() > 0)
+    return solveFromProjection(lambda, matrixU_.transpose() * (sensorWeighting_ * data));
+  return solveFromProjection(lambda, matrixU_.transpose() * data);
+}
@@ -0,0 +1,125 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+//    File       : TikhonovSweep.h
+//    Date       : October 18th, 2026 (last update)
+
+#ifndef BioPSE_TikhonovSweep_H__
+#define BioPSE_TikhonovSweep_H__
+
+#include <vector>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Algorithms/Math/HierarchicalMatrix/LinearOperator.h>
+#include <Core/Algorithms/Legacy/Inverse/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Inverse {
+
+	/// Evaluates the Tikhonov problem
+	///
+	///     min_x || C (A x - y) ||^2 + lambda^2 || R x ||^2
+	///
+	/// for many lambdas from a single factorization. C A R^-1 = U S V^T is computed once, after which
+	/// every lambda only needs the filter factors s / (s^2 + lambda^2): the residual and solution norms
+	/// of the L-curve cost O(rank) per lambda and are evaluated in parallel. All time frames of y are
+	/// projected onto U with one product, so long time series go through the same operator at once.
+	///
+	/// An empty weighting matrix stands for the identity. R has to be square and invertible.
+	/// If truncatedRank is positive, only that many singular triplets are computed, with a randomized
+	/// range finder (Halko, Martinsson & Tropp, 2011) instead of a full SVD.
+	///
+	/// The range finder only multiplies with A and A^T, so the forward matrix can also be given as a
+	/// LinearOperator, e.g. a HierarchicalMatrix, that is never formed densely.
+	///
+	/// When the weightings came in squared form, the solvers report eta = ||R^T R x|| and
+	/// rho = ||C^T C (A x - y)||; squaredSolutionNorm and squaredResidualNorm measure the L-curve the
+	/// same way, at O(rank^2) per lambda.
+	class SCISHARE TikhonovSweep
+	{
+	public:
+		TikhonovSweep( const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix, const SCIRun::Core::Datatypes::DenseMatrix& measuredData,
+			const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting, int truncatedRank = 0,
+			bool squaredSolutionNorm = false, bool squaredResidualNorm = false );
+
+		/// Always factors with the range finder; a truncatedRank of zero keeps every singular triplet.
+		TikhonovSweep( const SCIRun::Core::Algorithms::Math::LinearOperator& forwardOperator, const SCIRun::Core::Datatypes::DenseMatrix& measuredData,
+			const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting, int truncatedRank = 0,
+			bool squaredSolutionNorm = false, bool squaredResidualNorm = false );
+
+		/// Reuses a precomputed SVD A = U S V^T of the unweighted problem. The singular values may be a column
+		/// or the diagonal of a matrix; U and V may hold more vectors than there are singular values.
+		static TikhonovSweep fromSVD( const SCIRun::Core::Datatypes::DenseMatrix& matrixU, const SCIRun::Core::Datatypes::DenseMatrix& singularValues,
+			const SCIRun::Core::Datatypes::DenseMatrix& matrixV, const SCIRun::Core::Datatypes::DenseMatrix& measuredData );
+
+		/// Fills rho = ||C (A x - y)|| and eta = ||R x|| (Frobenius norms over all time frames) for every lambda.
+		void computeLcurve( const std::vector<double>& lambdaArray, std::vector<double>& rho, std::vector<double>& eta ) const;
+
+		/// Regularized solution for the measured data the sweep was built with; blocks of time frames are solved in parallel.
+		SCIRun::Core::Datatypes::DenseMatrix computeInverseSolution( double lambda ) const;
+
+		/// Regularized solution for another block of time frames, reusing the factorization.
+		SCIRun::Core::Datatypes::DenseMatrix computeInverseSolution( double lambda, const SCIRun::Core::Datatypes::DenseMatrix& data ) const;
+
+		int rank() const { return static_cast<int>(singularValues_.nrows()); }
+		const SCIRun::Core::Datatypes::DenseColumnMatrix& singularValues() const { return singularValues_; }
+
+	private:
+		TikhonovSweep() : residualOutsideRange_(0), weightedDataNorm_(0) {}
+
+		static SCIRun::Core::Datatypes::DenseMatrix invertSourceWeighting( const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting, int N );
+		void computeFullSVD( const SCIRun::Core::Datatypes::DenseMatrix& weightedForward );
+		void computeRandomizedSVD( const SCIRun::Core::Algorithms::Math::LinearOperator& weightedForward, int truncatedRank );
+		void projectData( const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting, const SCIRun::Core::Datatypes::DenseMatrix& sourceInverse,
+			const SCIRun::Core::Datatypes::DenseMatrix& measuredData, bool squaredSolutionNorm, bool squaredResidualNorm );
+		Eigen::VectorXd filterFactors( double lambda ) const;
+		SCIRun::Core::Datatypes::DenseMatrix solveFromProjection( double lambda, const SCIRun::Core::Datatypes::DenseMatrix& projection ) const;
+
+		SCIRun::Core::Datatypes::DenseMatrix sensorWeighting_;
+		SCIRun::Core::Datatypes::DenseMatrix matrixU_;
+		SCIRun::Core::Datatypes::DenseColumnMatrix singularValues_;
+		// R^-1 V, so that solutions come out in source space directly
+		SCIRun::Core::Datatypes::DenseMatrix sourceBasis_;
+
+		// U^T C y, the squared norm of each of its rows, and the part of ||C y||^2 outside the range of U
+		SCIRun::Core::Datatypes::DenseMatrix projectedData_;
+		std::vector<double> projectedDataNorms_;
+		double residualOutsideRange_;
+
+		// squared norms only: eta^2 = f^T solutionGram_ f, rho^2 = g^T residualGram_ g - 2 g^T residualCross_ + ||C^T C y||^2
+		// with the filter factors f = s / (s^2 + lambda^2) and g = s f
+		SCIRun::Core::Datatypes::DenseMatrix solutionGram_;
+		SCIRun::Core::Datatypes::DenseMatrix residualGram_;
+		SCIRun::Core::Datatypes::DenseColumnMatrix residualCross_;
+		double weightedDataNorm_;
+	};
+
+}}}}
+
+#endif
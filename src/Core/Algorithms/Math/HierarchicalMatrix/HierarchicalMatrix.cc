@@ -0,0 +1,372 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Algorithms/Math/HierarchicalMatrix/HierarchicalMatrix.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+HierarchicalMatrix::HierarchicalMatrix(const std::vector<Point>& rowPoints,
+  const std::vector<Point>& colPoints,
+  const EntryFunction& entry,
+  double tolerance,
+  double eta,
+  size_type leafSize)
+{
+  buildClusters(rowPoints, rowIndex_, rowClusters_, leafSize);
+  buildClusters(colPoints, colIndex_, colClusters_, leafSize);
+  if (rowClusters_.empty() || colClusters_.empty())
+    return;
+
+  std::vector<bool> admissible;
+  partition(0, 0, eta, admissible);
+
+  Parallel::ForRange(0, blocks_.size(), [&](size_t begin, size_t end)
+  {
+    for (size_t b = begin; b < end; ++b)
+    {
+      if (!admissible[b] || !approximate(blocks_[b], entry, tolerance))
+        fillDense(blocks_[b], entry);
+    }
+  }, 1);
+}
+
+void HierarchicalMatrix::buildClusters(const std::vector<Point>& points, std::vector<index_type>& index,
+  std::vector<Cluster>& clusters, size_type leafSize)
+{
+  const index_type n = static_cast<index_type>(points.size());
+  index.resize(n);
+  for (index_type i = 0; i < n; ++i)
+    index[i] = i;
+  clusters.clear();
+  if (n > 0)
+    buildCluster(points, index, clusters, 0, n, std::max<size_type>(leafSize, 1));
+}
+
+index_type HierarchicalMatrix::buildCluster(const std::vector<Point>& points, std::vector<index_type>& index,
+  std::vector<Cluster>& clusters, index_type begin, index_type end, size_type leafSize)
+{
+  Cluster cluster;
+  cluster.begin_ = begin;
+  cluster.end_ = end;
+  cluster.min_ = cluster.max_ = points[index[begin]];
+  for (index_type i = begin + 1; i < end; ++i)
+  {
+    cluster.min_ = Min(cluster.min_, points[index[i]]);
+    cluster.max_ = Max(cluster.max_, points[index[i]]);
+  }
+  cluster.child_[0] = cluster.child_[1] = -1;
+
+  const index_type id = static_cast<index_type>(clusters.size());
+  clusters.push_back(cluster);
+  if (end - begin <= leafSize)
+    return id;
+
+  const Vector extent = cluster.max_ - cluster.min_;
+  int axis = 0;
+  if (extent[1] > extent[axis]) axis = 1;
+  if (extent[2] > extent[axis]) axis = 2;
+
+  const index_type mid = begin + (end - begin) / 2;
+  std::nth_element(index.begin() + begin, index.begin() + mid, index.begin() + end,
+    [&points, axis](index_type a, index_type b) { return points[a][axis] < points[b][axis]; });
+
+  const index_type first = buildCluster(points, index, clusters, begin, mid, leafSize);
+  const index_type second = buildCluster(points, index, clusters, mid, end, leafSize);
+  clusters[id].child_[0] = first;
+  clusters[id].child_[1] = second;
+  return id;
+}
+
+void HierarchicalMatrix::partition(index_type rowCluster, index_type colCluster, double eta, std::vector<bool>& admissible)
+{
+  const Cluster& r = rowClusters_[rowCluster];
+  const Cluster& c = colClusters_[colCluster];
+
+  double dist2 = 0.0;
+  for (int k = 0; k < 3; ++k)
+  {
+    const double gap = std::max(0.0, std::max(r.min_[k] - c.max_[k], c.min_[k] - r.max_[k]));
+    dist2 += gap * gap;
+  }
+  const double diameter = std::min((r.max_ - r.min_).length(), (c.max_ - c.min_).length());
+
+  const bool rowLeaf = r.child_[0] < 0;
+  const bool colLeaf = c.child_[0] < 0;
+  const bool far = dist2 > 0.0 && diameter * diameter <= eta * eta * dist2;
+
+  if (far || (rowLeaf && colLeaf))
+  {
+    Block block;
+    block.rowBegin_ = r.begin_;
+    block.rowEnd_ = r.end_;
+    block.colBegin_ = c.begin_;
+    block.colEnd_ = c.end_;
+    block.lowRank_ = false;
+    blocks_.push_back(block);
+    admissible.push_back(far);
+    return;
+  }
+
+  if (rowLeaf)
+  {
+    for (int j = 0; j < 2; ++j) partition(rowCluster, c.child_[j], eta, admissible);
+  }
+  else if (colLeaf)
+  {
+    for (int i = 0; i < 2; ++i) partition(r.child_[i], colCluster, eta, admissible);
+  }
+  else
+  {
+    for (int i = 0; i < 2; ++i)
+      for (int j = 0; j < 2; ++j)
+        partition(r.child_[i], c.child_[j], eta, admissible);
+  }
+}
+
+void HierarchicalMatrix::fillDense(Block& block, const EntryFunction& entry) const
+{
+  const index_type m = block.rowEnd_ - block.rowBegin_;
+  const index_type n = block.colEnd_ - block.colBegin_;
+  block.lowRank_ = false;
+  block.u_.resize(m, n);
+  block.v_.resize(0, 0);
+  for (index_type j = 0; j < n; ++j)
+    for (index_type i = 0; i < m; ++i)
+      block.u_(i, j) = entry(rowIndex_[block.rowBegin_ + i], colIndex_[block.colBegin_ + j]);
+}
+
+bool HierarchicalMatrix::approximate(Block& block, const EntryFunction& entry, double tolerance) const
+{
+  // Adaptive cross approximation with partial pivoting: every step takes one
+  // row and one column of the remainder A - U*V^T and stops once the new
+  // rank one term is small against the estimated norm of U*V^T. A block
+  // that needs more than half its full rank is cheaper to keep dense.
+  const index_type m = block.rowEnd_ - block.rowBegin_;
+  const index_type n = block.colEnd_ - block.colBegin_;
+  const index_type maxRank = std::max<index_type>(1, std::min(m, n) / 2);
+
+  std::vector<Eigen::VectorXd> us, vs;
+  std::vector<bool> usedRow(m, false);
+  Eigen::VectorXd row(n), col(m);
+  double norm2 = 0.0;
+  index_type pivotRow = 0;
+  bool converged = false;
+
+  while (static_cast<index_type>(us.size()) < maxRank)
+  {
+    usedRow[pivotRow] = true;
+    const index_type globalRow = rowIndex_[block.rowBegin_ + pivotRow];
+    for (index_type j = 0; j < n; ++j)
+      row[j] = entry(globalRow, colIndex_[block.colBegin_ + j]);
+    for (size_t l = 0; l < us.size(); ++l)
+      row -= us[l][pivotRow] * vs[l];
+
+    Eigen::VectorXd::Index pivotCol;
+    const double pivot = row.cwiseAbs().maxCoeff(&pivotCol);
+    if (pivot == 0.0)
+    {
+      // This row is already reproduced exactly, try the next unused one
+      pivotRow = std::find(usedRow.begin(), usedRow.end(), false) - usedRow.begin();
+      if (pivotRow == m)
+      {
+        converged = true;
+        break;
+      }
+      continue;
+    }
+
+    Eigen::VectorXd v = row / row[pivotCol];
+    const index_type globalCol = colIndex_[block.colBegin_ + pivotCol];
+    for (index_type i = 0; i < m; ++i)
+      col[i] = entry(rowIndex_[block.rowBegin_ + i], globalCol);
+    for (size_t l = 0; l < us.size(); ++l)
+      col -= vs[l][pivotCol] * us[l];
+
+    const double uu = col.squaredNorm();
+    const double vv = v.squaredNorm();
+    double mixed = 0.0;
+    for (size_t l = 0; l < us.size(); ++l)
+      mixed += us[l].dot(col) * vs[l].dot(v);
+    norm2 += uu * vv + 2.0 * mixed;
+
+    us.push_back(col);
+    vs.push_back(v);
+
+    if (std::sqrt(uu * vv) <= tolerance * std::sqrt(std::fabs(norm2)))
+    {
+      converged = true;
+      break;
+    }
+
+    double best = -1.0;
+    pivotRow = m;
+    for (index_type i = 0; i < m; ++i)
+    {
+      if (!usedRow[i] && std::fabs(col[i]) > best)
+      {
+        best = std::fabs(col[i]);
+        pivotRow = i;
+      }
+    }
+    if (pivotRow == m)
+    {
+      converged = true;
+      break;
+    }
+  }
+
+  if (!converged)
+    return false;
+
+  const index_type rank = static_cast<index_type>(us.size());
+  block.lowRank_ = true;
+  block.u_.resize(m, rank);
+  block.v_.resize(n, rank);
+  for (index_type l = 0; l < rank; ++l)
+  {
+    block.u_.col(l) = us[l];
+    block.v_.col(l) = vs[l];
+  }
+  return true;
+}
+
+void HierarchicalMatrix::apply(const DenseMatrix& x, DenseMatrix& y, bool transposed) const
+{
+  const std::vector<index_type>& inIndex = transposed ? rowIndex_ : colIndex_;
+  const std::vector<index_type>& outIndex = transposed ? colIndex_ : rowIndex_;
+  const index_type k = static_cast<index_type>(x.cols());
+
+  // Work in cluster order, so that every block reads and writes contiguous rows
+  Eigen::MatrixXd xp(inIndex.size(), k);
+  for (size_t p = 0; p < inIndex.size(); ++p)
+    xp.row(p) = x.row(inIndex[p]);
+  Eigen::MatrixXd yp = Eigen::MatrixXd::Zero(outIndex.size(), k);
+
+  auto applyBlock = [transposed](const Block& b, const Eigen::MatrixXd& in, Eigen::MatrixXd& out, index_type c0, index_type nc)
+  {
+    const index_type inBegin = transposed ? b.rowBegin_ : b.colBegin_;
+    const index_type inSize = transposed ? b.rowEnd_ - b.rowBegin_ : b.colEnd_ - b.colBegin_;
+    const index_type outBegin = transposed ? b.colBegin_ : b.rowBegin_;
+    const index_type outSize = transposed ? b.colEnd_ - b.colBegin_ : b.rowEnd_ - b.rowBegin_;
+    auto xin = in.block(inBegin, c0, inSize, nc);
+    auto yout = out.block(outBegin, c0, outSize, nc);
+    if (b.lowRank_)
+    {
+      if (transposed)
+        yout.noalias() += b.v_ * (b.u_.transpose() * xin);
+      else
+        yout.noalias() += b.u_ * (b.v_.transpose() * xin);
+    }
+    else
+    {
+      if (transposed)
+        yout.noalias() += b.u_.transpose() * xin;
+      else
+        yout.noalias() += b.u_ * xin;
+    }
+  };
+
+  if (k > 1)
+  {
+    // Several right hand sides: threads own disjoint columns of the result
+    Parallel::ForRange(0, k, [&](size_t c0, size_t c1)
+    {
+      for (const auto& b : blocks_)
+        applyBlock(b, xp, yp, c0, c1 - c0);
+    }, 1);
+  }
+  else
+  {
+    // One right hand side: threads take disjoint sets of blocks and add up
+    // their partial products at the end
+    std::mutex lock;
+    Parallel::ForRange(0, blocks_.size(), [&](size_t b0, size_t b1)
+    {
+      Eigen::MatrixXd partial = Eigen::MatrixXd::Zero(yp.rows(), k);
+      for (size_t b = b0; b < b1; ++b)
+        applyBlock(blocks_[b], xp, partial, 0, k);
+      std::lock_guard<std::mutex> guard(lock);
+      yp += partial;
+    });
+  }
+
+  y.resize(outIndex.size(), k);
+  for (size_t p = 0; p < outIndex.size(); ++p)
+    y.row(outIndex[p]) = yp.row(p);
+}
+
+DenseMatrix HierarchicalMatrix::multiply(const DenseMatrix& x) const
+{
+  DenseMatrix y;
+  apply(x, y, false);
+  return y;
+}
+
+DenseMatrix HierarchicalMatrix::multiplyTransposed(const DenseMatrix& x) const
+{
+  DenseMatrix y;
+  apply(x, y, true);
+  return y;
+}
+
+void HierarchicalMatrix::addTo(DenseMatrix& target, index_type rowOffset, index_type colOffset, double scale) const
+{
+  Parallel::ForRange(0, blocks_.size(), [&](size_t b0, size_t b1)
+  {
+    for (size_t b = b0; b < b1; ++b)
+    {
+      const Block& block = blocks_[b];
+      const Eigen::MatrixXd dense = block.lowRank_ ? Eigen::MatrixXd(block.u_ * block.v_.transpose()) : block.u_;
+      // Blocks tile the matrix, so no two threads write the same entry
+      for (index_type j = 0; j < dense.cols(); ++j)
+        for (index_type i = 0; i < dense.rows(); ++i)
+          target(rowOffset + rowIndex_[block.rowBegin_ + i], colOffset + colIndex_[block.colBegin_ + j]) += scale * dense(i, j);
+    }
+  }, 1);
+}
+
+size_type HierarchicalMatrix::storedEntries() const
+{
+  size_type entries = 0;
+  for (const auto& b : blocks_)
+    entries += b.u_.size() + b.v_.size();
+  return entries;
+}
+
+size_type HierarchicalMatrix::numLowRankBlocks() const
+{
+  return static_cast<size_type>(std::count_if(blocks_.begin(), blocks_.end(), [](const Block& b) { return b.lowRank_; }));
+}
@@ -0,0 +1,118 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORITHMS_MATH_HIERARCHICALMATRIX_HIERARCHICALMATRIX_H
+#define CORE_ALGORITHMS_MATH_HIERARCHICALMATRIX_HIERARCHICALMATRIX_H
+
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Algorithms/Math/HierarchicalMatrix/LinearOperator.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Data sparse representation of a matrix whose rows and columns belong to
+  /// points in space and whose entries vary smoothly with the distance between
+  /// them, as do the blocks of boundary element matrices.
+  ///
+  /// Rows and columns are sorted into cluster trees of bounding boxes. A pair
+  /// of clusters is far apart when the smaller box diameter is at most
+  /// eta times the distance between the boxes. The block of such a pair is
+  /// approximated by a low rank product U*V^T that adaptive cross
+  /// approximation builds from a few of its rows and columns, so most
+  /// entries are never evaluated. All other blocks are stored dense.
+  class SCISHARE HierarchicalMatrix : public LinearOperator, boost::noncopyable
+  {
+  public:
+    /// Entry (i, j) of the matrix, with i and j in the original numbering.
+    /// Called concurrently from several threads, and only while the
+    /// constructor runs.
+    using EntryFunction = boost::function<double(index_type, index_type)>;
+
+    /// tolerance is the relative accuracy, in the Frobenius norm, of every
+    /// low rank block.
+    HierarchicalMatrix(const std::vector<Geometry::Point>& rowPoints,
+      const std::vector<Geometry::Point>& colPoints,
+      const EntryFunction& entry,
+      double tolerance,
+      double eta = 2.0,
+      size_type leafSize = 32);
+
+    size_type rows() const override { return static_cast<size_type>(rowIndex_.size()); }
+    size_type cols() const override { return static_cast<size_type>(colIndex_.size()); }
+
+    Datatypes::DenseMatrix multiply(const Datatypes::DenseMatrix& x) const override;
+    Datatypes::DenseMatrix multiplyTransposed(const Datatypes::DenseMatrix& x) const override;
+
+    /// Add scale * this to the block of target that starts at (rowOffset, colOffset).
+    void addTo(Datatypes::DenseMatrix& target, index_type rowOffset, index_type colOffset, double scale = 1.0) const;
+
+    /// Number of doubles stored, rows()*cols() for a dense matrix.
+    size_type storedEntries() const;
+    size_type numLowRankBlocks() const;
+
+  private:
+    struct Cluster
+    {
+      index_type begin_, end_;
+      Geometry::Point min_, max_;
+      index_type child_[2];
+    };
+
+    /// Rows and columns are ranges in cluster order. A dense block keeps its
+    /// entries in u_, a low rank block is u_ * v_^T.
+    struct Block
+    {
+      index_type rowBegin_, rowEnd_, colBegin_, colEnd_;
+      bool lowRank_;
+      Eigen::MatrixXd u_, v_;
+    };
+
+    static void buildClusters(const std::vector<Geometry::Point>& points, std::vector<index_type>& index,
+      std::vector<Cluster>& clusters, size_type leafSize);
+    static index_type buildCluster(const std::vector<Geometry::Point>& points, std::vector<index_type>& index,
+      std::vector<Cluster>& clusters, index_type begin, index_type end, size_type leafSize);
+    void partition(index_type rowCluster, index_type colCluster, double eta, std::vector<bool>& admissible);
+    void fillDense(Block& block, const EntryFunction& entry) const;
+    bool approximate(Block& block, const EntryFunction& entry, double tolerance) const;
+    void apply(const Datatypes::DenseMatrix& x, Datatypes::DenseMatrix& y, bool transposed) const;
+
+    std::vector<index_type> rowIndex_, colIndex_;
+    std::vector<Cluster> rowClusters_, colClusters_;
+    std::vector<Block> blocks_;
+  };
+
+}}}}
+
+#endif
@@ -0,0 +1,76 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_ALGORITHMS_MATH_HIERARCHICALMATRIX_LINEAROPERATOR_H
+#define CORE_ALGORITHMS_MATH_HIERARCHICALMATRIX_LINEAROPERATOR_H
+
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// A matrix that is only available through its products, such as a
+  /// compressed boundary element block. Solvers that need nothing but
+  /// products with the matrix and its transpose take one of these, so they
+  /// work the same on dense and on data sparse matrices.
+  class SCISHARE LinearOperator
+  {
+  public:
+    virtual ~LinearOperator() {}
+
+    virtual size_type rows() const = 0;
+    virtual size_type cols() const = 0;
+
+    /// this * x, for every column of x
+    virtual Datatypes::DenseMatrix multiply(const Datatypes::DenseMatrix& x) const = 0;
+    /// this^T * x, for every column of x
+    virtual Datatypes::DenseMatrix multiplyTransposed(const Datatypes::DenseMatrix& x) const = 0;
+  };
+
+  /// Products with a dense matrix, which has to outlive the operator.
+  class SCISHARE DenseLinearOperator : public LinearOperator
+  {
+  public:
+    explicit DenseLinearOperator(const Datatypes::DenseMatrix& matrix) : matrix_(matrix) {}
+
+    size_type rows() const override { return matrix_.rows(); }
+    size_type cols() const override { return matrix_.cols(); }
+
+    Datatypes::DenseMatrix multiply(const Datatypes::DenseMatrix& x) const override { return matrix_ * x; }
+    Datatypes::DenseMatrix multiplyTransposed(const Datatypes::DenseMatrix& x) const override { return matrix_.transpose() * x; }
+
+  private:
+    const Datatypes::DenseMatrix& matrix_;
+  };
+
+}}}}
+
+#endif
@@ -33,12 +33,14 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Logging/Trace.h>
 
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Math;
@@ -48,7 +50,7 @@ SolveLinearSystemAlgo::SolveLinearSystemAlgo()
 {
   // For solver
   addOption(Variables::Method,"cg","jacobi|cg|bicg|minres");
-  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi");
+  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi|ILU0|AMG");
 
   addParameter(Variables::TargetError, 1e-5);
   addParameter(Variables::MaxIterations, 500);
@@ -79,15 +81,26 @@ public:
             DenseColumnMatrixHandle x0, DenseColumnMatrixHandle& x,
             DenseColumnMatrixHandle& convergence) const;
 protected:
+  void setup_preconditioner(const SparseRowMatrix& a) const;
+  void run_solver(SolverInputs& matrices) const;
+
+  // z = M^-1 r, with M either the diagonal scaling in diag or preconditioner_
+  void precondition(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& diag,
+    const ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z) const;
+
   const AlgorithmBase* algo_;
   std::string pre_conditioner_;
   DenseColumnMatrixHandle convergence_;
+  // Set up in the first run() for the preconditioners that need more than a diagonal
+  mutable boost::shared_ptr<ParallelPreconditioner> preconditioner_;
 };
 
 SolveLinearSystemParallelAlgo::SolveLinearSystemParallelAlgo(const AlgorithmBase* base) : algo_(base),
   pre_conditioner_(base->getOption(Variables::Preconditioner)),
   convergence_(new DenseColumnMatrix(base->get(Variables::MaxIterations).toInt()))
 {
+  // Entries past the last iteration stay zero, so the iteration count can be read back
+  convergence_->setZero();
 }
 
 bool
@@ -109,20 +122,52 @@ SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHan
 
   convergence = convergence_;
 
+  setup_preconditioner(*a);
+
   // Set intermediate solution handle
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   algo->set_handle("solution", x);
   algo->set_handle("convergence", convergence);
 #endif
 
+  run_solver(matrices);
+
+  return (true);
+}
+
+void SolveLinearSystemParallelAlgo::setup_preconditioner(const SparseRowMatrix& a) const
+{
+  // Kept across calls to run(), so solving several right hand sides with
+  // the same matrix factors it only once
+  if (preconditioner_)
+    return;
+
+  SCIRUN_TRACE_SCOPE("solver", "preconditioner setup", pre_conditioner_);
+  if (pre_conditioner_ == "ILU0")
+    preconditioner_ = boost::make_shared<IncompleteLUPreconditioner>(a);
+  else if (pre_conditioner_ == "AMG")
+    preconditioner_ = boost::make_shared<SmoothedAggregationAMGPreconditioner>(a);
+  if (preconditioner_)
+    algo_->remark("Preconditioner: " + preconditioner_->describe());
+}
+
+void SolveLinearSystemParallelAlgo::run_solver(SolverInputs& matrices) const
+{
   if(!start_parallel(matrices))
   {
     const std::string msg = "Encountered an error while running parallel linear algebra";
     algo_->error(msg);
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << SCIRun::Core::ErrorMessage(msg));
   }
+}
 
-  return (true);
+void SolveLinearSystemParallelAlgo::precondition(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& diag,
+  const ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z) const
+{
+  if (preconditioner_)
+    preconditioner_->apply(PLA, r, z);
+  else
+    PLA.mult(r, diag, z);
 }
 
 //------------------------------------------------------------------
@@ -138,7 +183,7 @@ class SolveLinearSystemCGAlgo : public SolveLinearSystemParallelAlgo
 bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 {
   ParallelLinearAlgebra::ParallelMatrix A;
-  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, DIAG, R, Z, P;
+  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, DIAG, R, Z, P, Q;
 
   double tolerance =     algo_->get(Variables::TargetError).toDouble();
   int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
@@ -170,7 +215,8 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
        !PLA.new_vector(DIAG) ||
        !PLA.new_vector(R) ||
        !PLA.new_vector(Z) ||
-       !PLA.new_vector(P))
+       !PLA.new_vector(P) ||
+       !PLA.new_vector(Q))
   {
     if (PLA.first())
     {
@@ -229,11 +275,15 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
 
   double bkden = 0.0;
 
+  precondition(PLA,DIAG,R,Z);
+  double bknum = PLA.dot(Z,R);
+
   int cnt = 0;
   double log_target = log(tolerance);
   double log_orig =  log(orig);
   double log_scale = log_orig - log_target;
 
+  SCIRUN_TRACE_SCOPE("solver", "CG iterations");
   while (niter < max_iter)
   {
     if (error <= tolerance)
@@ -256,9 +306,6 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       return true;
     }
 
-    PLA.mult(R,DIAG,Z);
-    double bknum = PLA.dot(Z,R);
-
     if (niter == 0)
     {
       PLA.copy(Z,P);
@@ -268,16 +315,27 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       double bk = bknum/bkden;
       PLA.scale_add(bk,P,Z,P);
     }
-    PLA.mult(A,P,Z);
+    double akden = PLA.mult_dot(A,P,Q);
     bkden = bknum;
 
-    double akden = PLA.dot(Z,P);
     double ak=bknum/akden;
 
-    PLA.scale_add(ak,P,X,X);
-    PLA.scale_add(-ak,Z,R,R);
+    double rnorm;
+    if (preconditioner_)
+    {
+      PLA.scale_add(ak,P,X,X);
+      rnorm = PLA.scale_add_norm(-ak,Q,R,R);
+      preconditioner_->apply(PLA,R,Z);
+      bknum = PLA.dot(Z,R);
+    }
+    else
+    {
+      // Updates X and R, applies the diagonal preconditioner for the next
+      // step and forms both of its inner products in a single pass
+      PLA.cg_update(ak,P,Q,DIAG,X,R,Z,bknum,rnorm);
+    }
 
-    error = PLA.norm(R)/bnorm;
+    error = rnorm/bnorm;
     if (error < xmin)
     {
       PLA.copy(X,XMIN);
@@ -314,7 +372,8 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
     if (cnt == 20)
     {
       cnt = 0;
-      algo_->update_progress((log_orig-log(error))/log_scale);
+      if (PLA.first())
+        algo_->update_progress((log_orig-log(error))/log_scale);
     }
   }
 
@@ -443,6 +502,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   double log_orig =  log(orig);
   double log_scale = log_orig - log_target;
 
+  SCIRUN_TRACE_SCOPE("solver", "BiCG iterations");
   while (niter < max_iter)
   {
     if (error <= tolerance)
@@ -499,10 +559,9 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     double ak=bknum/akden;
 
     PLA.scale_add(ak,P,X,X);
-    PLA.scale_add(-ak,Z,R,R);
+    error = PLA.scale_add_norm(-ak,Z,R,R)/bnorm;
 
     PLA.scale_add(-ak,Z1,R1,R1);
-    error = PLA.norm(R)/bnorm;
 
     if (error < xmin) { PLA.copy(X,XMIN); xmin = error; }
     if (PLA.first()) (*convergence_)[niter] = xmin;
@@ -534,7 +593,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     if (cnt == 20)
     {
       cnt = 0;
-      algo_->update_progress((log_orig-log(error))/log_scale);
+      if (PLA.first())
+        algo_->update_progress((log_orig-log(error))/log_scale);
     }
   }
 
@@ -654,9 +714,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   }
 
   PLA.copy(R,VOLD);
-  PLA.copy(R,V);
-
-  PLA.mult(DIAG,V,V);
+  precondition(PLA,DIAG,R,V);
 
   double beta1   = sqrt(PLA.dot(V,VOLD));
   double snprod  = beta1;
@@ -673,7 +731,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(VOLD,VOLDER);
   PLA.copy(V,VOLD);
 
-  PLA.mult(DIAG,V,V);
+  precondition(PLA,DIAG,VOLD,V);
 
   double betaold = beta1;
   double beta = sqrt(PLA.dot(VOLD,V));
@@ -706,6 +764,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 
   double delta = 0.0;
 
+  SCIRUN_TRACE_SCOPE("solver", "MINRES iterations");
   while (niter < max_iter)
   {
     if (error <= tolerance)
@@ -734,7 +793,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     PLA.copy(VOLD,VOLDER);
     PLA.copy(V,VOLD);
 
-    PLA.mult(DIAG,V,V);
+    precondition(PLA,DIAG,VOLD,V);
 
     betaold = beta;
     beta = sqrt(PLA.dot(VOLD,V));
@@ -885,7 +944,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     if (ucnt == 20)
     {
       ucnt = 0;
-      algo_->update_progress((log_orig-log(error))/log_scale);
+      if (PLA.first())
+        algo_->update_progress((log_orig-log(error))/log_scale);
     }
   }
 
@@ -994,6 +1054,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   double log_orig =  log(orig);
   double log_scale = log_orig - log_target;
 
+  SCIRUN_TRACE_SCOPE("solver", "Jacobi iterations");
   while (niter < max_iter)
   {
     if (error <= tolerance)
@@ -1008,7 +1069,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 #endif
       }
       PLA.wait();
-      algo_->update_progress(1);
+      if (PLA.first())
+        algo_->update_progress(1);
       return (true);
     }
 
@@ -1048,7 +1110,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     if (cnt == 20)
     {
       cnt = 0;
-      algo_->update_progress((log_orig-log(error))/log_scale);
+      if (PLA.first())
+        algo_->update_progress((log_orig-log(error))/log_scale);
     }
   }
 
@@ -1063,7 +1126,278 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   }
   PLA.wait();
 
-  algo_->update_progress(1);
+  if (PLA.first())
+    algo_->update_progress(1);
+  return (true);
+}
+
+//------------------------------------------------------------------
+// Block CG for several right hand sides that share one matrix
+//
+// All columns advance together, so every sweep over A serves the whole
+// block (a sparse times dense product instead of one SpMV per column) and
+// the preconditioner is set up once. Columns that reach the tolerance are
+// deflated out of the block, which restarts the iteration for the rest.
+
+class SolveLinearSystemBlockCGAlgo : public SolveLinearSystemParallelAlgo
+{
+public:
+  explicit SolveLinearSystemBlockCGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+
+  bool run(SparseRowMatrixHandle a, const DenseMatrix& b, DenseMatrixHandle x0, DenseMatrixHandle& x) const;
+  virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const;
+
+private:
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Block;
+
+  // y = A*x for the first k columns of the rows owned by PLA
+  void mult(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelMatrix& A,
+    const Block& x, Block& y, Eigen::Index k) const;
+  void precondition_block(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& diag,
+    ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z, Eigen::Index k) const;
+  // Sums the per-thread contributions; every thread gets the same result
+  Eigen::MatrixXd reduce(ParallelLinearAlgebra& PLA, const Eigen::MatrixXd& local, int& buffer) const;
+
+  mutable Block B_, X_, R_, Z_, P_, Q_;
+  mutable std::vector<Eigen::MatrixXd> partials_[2];
+};
+
+bool SolveLinearSystemBlockCGAlgo::run(SparseRowMatrixHandle a, const DenseMatrix& b, DenseMatrixHandle x0, DenseMatrixHandle& x) const
+{
+  const Eigen::Index n = b.rows(), s = b.cols();
+  B_ = b;
+  if (x0)
+    X_ = *x0;
+  else
+    X_ = Block::Zero(n, s);
+  R_.resize(n, s);
+  Z_.resize(n, s);
+  P_.resize(n, s);
+  Q_.resize(n, s);
+
+  // The vector interface of ParallelLinearAlgebra only carries the scratch
+  // columns used to hand single columns to the preconditioner.
+  SolverInputs matrices;
+  matrices.A = a;
+  matrices.b = boost::make_shared<DenseColumnMatrix>(n);
+  matrices.x0 = matrices.b;
+  matrices.x = boost::make_shared<DenseColumnMatrix>(n);
+
+  setup_preconditioner(*a);
+  run_solver(matrices);
+
+  x = boost::make_shared<DenseMatrix>(X_);
+  return true;
+}
+
+void SolveLinearSystemBlockCGAlgo::mult(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelMatrix& A,
+  const Block& x, Block& y, Eigen::Index k) const
+{
+  PLA.wait();
+
+  const Eigen::Index s = x.cols();
+  const double* xdata = x.data();
+  double* ydata = y.data();
+
+  for (size_t i = PLA.start(); i < PLA.end(); i++)
+  {
+    double* yi = ydata + i*s;
+    for (Eigen::Index j = 0; j < k; j++) yi[j] = 0.0;
+    for (SCIRun::index_type kk = A.rows_[i]; kk < A.rows_[i+1]; kk++)
+    {
+      const double a = A.data_[kk];
+      const double* xc = xdata + A.columns_[kk]*s;
+      for (Eigen::Index j = 0; j < k; j++) yi[j] += a*xc[j];
+    }
+  }
+}
+
+void SolveLinearSystemBlockCGAlgo::precondition_block(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& diag,
+  ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z, Eigen::Index k) const
+{
+  const size_t start = PLA.start(), end = PLA.end();
+  if (!preconditioner_)
+  {
+    for (size_t i = start; i < end; i++)
+      Z_.row(i).head(k) = diag.data_[i] * R_.row(i).head(k);
+    return;
+  }
+
+  for (Eigen::Index j = 0; j < k; j++)
+  {
+    for (size_t i = start; i < end; i++) r.data_[i] = R_(i,j);
+    preconditioner_->apply(PLA, r, z);
+    for (size_t i = start; i < end; i++) Z_(i,j) = z.data_[i];
+  }
+}
+
+Eigen::MatrixXd SolveLinearSystemBlockCGAlgo::reduce(ParallelLinearAlgebra& PLA, const Eigen::MatrixXd& local, int& buffer) const
+{
+  // Alternating buffers, as in ParallelLinearAlgebra, so one barrier per reduction suffices
+  auto& partials = partials_[buffer];
+  buffer = 1 - buffer;
+  partials[PLA.proc()] = local;
+  PLA.wait();
+
+  Eigen::MatrixXd sum = partials[0];
+  for (int p = 1; p < PLA.nproc(); p++) sum += partials[p];
+  return sum;
+}
+
+bool
+SolveLinearSystemBlockCGAlgo::
+parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
+{
+  ParallelLinearAlgebra::ParallelMatrix A;
+  ParallelLinearAlgebra::ParallelVector R, Z, DIAG;
+
+  double tolerance = algo_->get(Variables::TargetError).toDouble();
+  int    max_iter =  algo_->get(Variables::MaxIterations).toInt();
+  int    niter = 0;
+
+  if ( !PLA.add_matrix(matrices.A,A) ||
+       !PLA.add_vector(matrices.b,R) ||
+       !PLA.add_vector(matrices.x,Z) ||
+       !PLA.new_vector(DIAG))
+  {
+    if (PLA.first())
+      algo_->error("Could not allocate enough memory for algorithm");
+    PLA.wait();
+    return (false);
+  }
+
+  if (PLA.first())
+  {
+    partials_[0].resize(PLA.nproc());
+    partials_[1].resize(PLA.nproc());
+  }
+
+  if (pre_conditioner_ == "Jacobi")
+  {
+    PLA.absdiag(A,DIAG);
+    double max = PLA.max(DIAG);
+    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
+  }
+  else
+  {
+    PLA.ones(DIAG);
+  }
+
+  const size_t start = PLA.start();
+  const Eigen::Index rows = PLA.end() - start;
+  const Eigen::Index s = B_.cols();
+  int buffer = 0;
+
+  // Every thread makes the same deflation decisions from the same reduced
+  // values, so each keeps its own copy of the column bookkeeping.
+  std::vector<Eigen::Index> columns(s);
+  for (Eigen::Index j = 0; j < s; j++) columns[j] = j;
+
+  Eigen::VectorXd bnorm = reduce(PLA, B_.middleRows(start,rows).colwise().squaredNorm().transpose(), buffer).col(0).cwiseSqrt();
+  for (Eigen::Index j = 0; j < s; j++)
+    if (bnorm[j] == 0.0) bnorm[j] = 1.0;
+
+  Eigen::Index k = s;
+  double error = 0.0;
+  SCIRUN_TRACE_SCOPE("solver", "block CG iterations");
+  while (k > 0)
+  {
+    // (Re)start on the active columns: R = B - A*X, P = Z = M^-1 R
+    mult(PLA,A,X_,R_,k);
+    R_.block(start,0,rows,k) = B_.block(start,0,rows,k) - R_.block(start,0,rows,k);
+    precondition_block(PLA,DIAG,R,Z,k);
+    P_.block(start,0,rows,k) = Z_.block(start,0,rows,k);
+
+    Eigen::MatrixXd local(k,k+1);
+    local.leftCols(k).noalias() = Z_.block(start,0,rows,k).transpose() * R_.block(start,0,rows,k);
+    local.col(k) = R_.block(start,0,rows,k).colwise().squaredNorm().transpose();
+    Eigen::MatrixXd reduced = reduce(PLA,local,buffer);
+    Eigen::MatrixXd ZtR = reduced.leftCols(k);
+    Eigen::VectorXd residual = reduced.col(k).cwiseSqrt();
+
+    for (;;)
+    {
+      error = 0.0;
+      bool converged = false;
+      for (Eigen::Index j = 0; j < k; j++)
+      {
+        const double e = residual[j]/bnorm[columns[j]];
+        error = std::max(error, e);
+        converged = converged || e <= tolerance;
+      }
+      if (converged || niter >= max_iter)
+        break;
+
+      // Q = A*P, alpha = (P'Q)^-1 Z'R
+      mult(PLA,A,P_,Q_,k);
+      Eigen::MatrixXd PtQ = reduce(PLA,
+        (P_.block(start,0,rows,k).transpose() * Q_.block(start,0,rows,k)).eval(), buffer);
+      Eigen::MatrixXd alpha = PtQ.ldlt().solve(ZtR);
+
+      X_.block(start,0,rows,k).noalias() += P_.block(start,0,rows,k) * alpha;
+      R_.block(start,0,rows,k).noalias() -= Q_.block(start,0,rows,k) * alpha;
+      precondition_block(PLA,DIAG,R,Z,k);
+
+      local.leftCols(k).noalias() = Z_.block(start,0,rows,k).transpose() * R_.block(start,0,rows,k);
+      local.col(k) = R_.block(start,0,rows,k).colwise().squaredNorm().transpose();
+      reduced = reduce(PLA,local,buffer);
+      residual = reduced.col(k).cwiseSqrt();
+
+      // beta = (Z'R)_old^-1 (Z'R)_new, P = Z + P*beta
+      Eigen::MatrixXd beta = ZtR.ldlt().solve(reduced.leftCols(k));
+      ZtR = reduced.leftCols(k);
+      P_.block(start,0,rows,k) = Z_.block(start,0,rows,k) + P_.block(start,0,rows,k) * beta;
+
+      if (PLA.first())
+        (*convergence_)[niter] = error;
+      niter++;
+      if (niter % 20 == 0 && PLA.first())
+        algo_->update_progress(static_cast<double>(s - k) / s);
+    }
+
+    if (niter >= max_iter)
+      break;
+
+    // Deflate: move the converged columns behind the active ones
+    Eigen::Index j = 0;
+    while (j < k)
+    {
+      if (residual[j]/bnorm[columns[j]] <= tolerance)
+      {
+        k--;
+        if (j != k)
+        {
+          X_.block(start,j,rows,1).swap(X_.block(start,k,rows,1));
+          B_.block(start,j,rows,1).swap(B_.block(start,k,rows,1));
+          std::swap(columns[j], columns[k]);
+          std::swap(residual[j], residual[k]);
+        }
+      }
+      else
+      {
+        j++;
+      }
+    }
+  }
+
+  // Undo the deflation permutation on this thread's rows
+  Block solution(rows, s);
+  for (Eigen::Index j = 0; j < s; j++)
+    solution.col(columns[j]) = X_.block(start,j,rows,1);
+  PLA.wait();
+  X_.middleRows(start,rows) = solution;
+  PLA.wait();
+
+  if (PLA.first())
+  {
+    std::ostringstream ostr;
+    if (k == 0)
+      ostr << "Block solver converged for " << s << " right hand sides after " << niter << " iterations";
+    else
+      ostr << "Block solver stopped after " << niter << " iterations with " << k << " of " << s << " right hand sides above tolerance. Error was " << error;
+    algo_->remark(ostr.str());
+  }
+
   return (true);
 }
 
@@ -1146,6 +1480,12 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   }
 
   std::string method = getOption(Variables::Method);
+  std::string preconditioner = getOption(Variables::Preconditioner);
+
+  if (method == "bicg" && (preconditioner == "ILU0" || preconditioner == "AMG"))
+  {
+    THROW_ALGORITHM_INPUT_ERROR("The " + preconditioner + " preconditioner is only available for the cg and minres methods");
+  }
 
   DenseColumnMatrixHandle conv;
   if (method == "cg")
@@ -1183,6 +1523,9 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   else
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Unknown solver method"));
 
+  if (get(Variables::BuildConvergence).toBool())
+    convergence = conv;
+
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   if (get_bool("build_convergence"))
   {
@@ -1200,9 +1543,100 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   return true;
 }
 
+bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
+                           DenseMatrixHandle b,
+                           DenseMatrixHandle x0,
+                           DenseMatrixHandle& x) const
+{
+  ScopedAlgorithmStatusReporter ssr(this, "SolveLinearSystem");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(A, "No matrix A is given");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(b, "No matrix b is given");
+
+  double tolerance = get(Variables::TargetError).toDouble();
+  int maxIterations = get(Variables::MaxIterations).toInt();
+  ENSURE_POSITIVE_DOUBLE(tolerance, "Tolerance out of range!");
+  ENSURE_POSITIVE_INT(maxIterations, "Max iterations out of range!");
+
+  if (A->nrows() != A->ncols())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A is not square");
+  }
+
+  if (A->nrows() != b->nrows())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A and b do not have the same number of rows");
+  }
+
+  if (x0 && (x0->nrows() != b->nrows() || x0->ncols() != b->ncols()))
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix x0 and b need to have the same dimensions");
+  }
+
+  std::string method = getOption(Variables::Method);
+  std::string preconditioner = getOption(Variables::Preconditioner);
+
+  if (method == "bicg" && (preconditioner == "ILU0" || preconditioner == "AMG"))
+  {
+    THROW_ALGORITHM_INPUT_ERROR("The " + preconditioner + " preconditioner is only available for the cg and minres methods");
+  }
+
+  if (method == "cg")
+  {
+    SolveLinearSystemBlockCGAlgo algo(this);
+    if (!algo.run(A,*b,x0,x))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Block Conjugate Gradient method failed"));
+    }
+    return true;
+  }
+
+  // One solver object for all columns, so its preconditioner is built once
+  boost::shared_ptr<SolveLinearSystemParallelAlgo> algo;
+  if (method == "bicg")
+    algo = boost::make_shared<SolveLinearSystemBICGAlgo>(this);
+  else if (method == "jacobi")
+    algo = boost::make_shared<SolveLinearSystemJACOBIAlgo>(this);
+  else if (method == "minres")
+    algo = boost::make_shared<SolveLinearSystemMINRESAlgo>(this);
+  else
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Unknown solver method"));
+
+  x = boost::make_shared<DenseMatrix>(b->nrows(), b->ncols());
+  for (size_t j = 0; j < b->ncols(); j++)
+  {
+    auto bj = boost::make_shared<DenseColumnMatrix>(b->col(j));
+    auto x0j = boost::make_shared<DenseColumnMatrix>(b->nrows());
+    if (x0)
+      *x0j = x0->col(j);
+    else
+      x0j->setZero();
+    DenseColumnMatrixHandle xj, conv;
+    if (!algo->run(A,bj,x0j,xj,conv))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Linear solver failed on right hand side " + std::to_string(j)));
+    }
+    x->col(j) = *xj;
+  }
+  return true;
+}
+
 AlgorithmOutput SolveLinearSystemAlgo::run(const AlgorithmInput& input) const
 {
   auto lhs = input.get<SparseRowMatrix>(Variables::LHS);
+
+  auto rhsBlock = input.get<DenseMatrix>(Variables::RHS);
+  if (rhsBlock && rhsBlock->ncols() > 1)
+  {
+    DenseMatrixHandle solution;
+    if (!run(lhs, rhsBlock, DenseMatrixHandle(), solution))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("SolveLinearSystem Algo returned false--need to improve error conditions so it throws before returning."));
+    }
+    AlgorithmOutput output;
+    output[Variables::Solution] = solution;
+    return output;
+  }
+
   auto rhs = input.get<DenseColumnMatrix>(Variables::RHS);
 
   DenseColumnMatrixHandle solution;
@@ -61,6 +61,14 @@ class SCISHARE SolveLinearSystemAlgo : public AlgorithmBase
              Datatypes::DenseColumnMatrixHandle x0, 
              Datatypes::DenseColumnMatrixHandle& x) const;
 
+    /// Solves A*x = b for every column of b. The cg method runs a block
+    /// conjugate gradient that shares each matrix product across all columns;
+    /// the other methods solve the columns one after another.
+    bool run(Datatypes::SparseRowMatrixHandle A,
+             Datatypes::DenseMatrixHandle b,
+             Datatypes::DenseMatrixHandle x0,
+             Datatypes::DenseMatrixHandle& x) const;
+
     AlgorithmOutput run(const AlgorithmInput& input) const;
 };
 
@@ -40,6 +40,7 @@
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/VectorKernels.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Thread/Parallel.h>
 
@@ -386,76 +387,12 @@ void ParallelLinearAlgebra::absthreshold_invert(const ParallelVector& a, Paralle
 
 void ParallelLinearAlgebra::scale_add(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
 {
-  double* a_ptr = a.data_+start_;
-  double* b_ptr = b.data_+start_;
-  double* r_ptr = r.data_+start_;
-
-  size_t j=0;
-  for (; j<local_size16_; j+=16)
-  {
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-  }
-
-  for (; j<local_size_; j++)
-  {
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-  }
+  VectorKernels::scaleAdd(s, a.data_+start_, b.data_+start_, r.data_+start_, local_size_);
 }
 
 double ParallelLinearAlgebra::dot(const ParallelVector& a, const ParallelVector& b)
 {
-  double* a_ptr = a.data_+start_;
-  double* b_ptr = b.data_+start_;
-
-  double val = 0.0;
-  size_t j=0;
-  for (; j<local_size16_; j+=16)
-  {
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-  }
-
-  for (; j<local_size_; j++)
-  {
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-  }
-
-  return(reduce_sum(val));
+  return(reduce_sum(VectorKernels::dot(a.data_+start_, b.data_+start_, local_size_)));
 }
 
 void ParallelLinearAlgebra::zeros(ParallelVector& a)
@@ -530,40 +467,25 @@ void ParallelLinearAlgebra::ones(ParallelVector& a)
 
 double ParallelLinearAlgebra::norm(const ParallelVector& a)
 {
-  double* a_ptr = a.data_+start_;
-
-  double val = 0.0;
-  size_t j=0;
+  const double* a_ptr = a.data_+start_;
+  return(sqrt(reduce_sum(VectorKernels::dot(a_ptr, a_ptr, local_size_))));
+}
 
-  for (; j<local_size16_; j+=16)
-  {
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-  }
+double ParallelLinearAlgebra::scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
+{
+  return(sqrt(reduce_sum(VectorKernels::scaleAddNorm2(s, a.data_+start_, b.data_+start_, r.data_+start_, local_size_))));
+}
 
-  for (; j<local_size_; j++)
-  {
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-  }
+void ParallelLinearAlgebra::cg_update(double ak, const ParallelVector& p, const ParallelVector& q, const ParallelVector& diag,
+  ParallelVector& x, ParallelVector& r, ParallelVector& z, double& rz, double& rnorm)
+{
+  double local_rz, local_rr;
+  VectorKernels::cgUpdate(ak, p.data_+start_, q.data_+start_, diag.data_+start_,
+    x.data_+start_, r.data_+start_, z.data_+start_, local_size_, local_rz, local_rr);
 
-  return(sqrt(reduce_sum(val)));
+  double rr;
+  reduce_sum2(local_rz, local_rr, rz, rr);
+  rnorm = sqrt(rr);
 }
 
 /// @todo: refactor to use algorithm
@@ -649,6 +571,13 @@ void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const ParallelVector&
   }
 }
 
+double ParallelLinearAlgebra::mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r)
+{
+  wait();
+
+  return(reduce_sum(VectorKernels::multDot(a.rows_, a.columns_, a.data_, b.data_, r.data_, start_, end_)));
+}
+
 void ParallelLinearAlgebra::mult_trans(ParallelMatrix& a, ParallelVector& b, ParallelVector& r)
 {
   wait();
@@ -749,6 +678,21 @@ double ParallelLinearAlgebra::reduce_max(double val)
   return (ret);
 }
 
+void ParallelLinearAlgebra::reduce_sum2(double val1, double val2, double& sum1, double& sum2)
+{
+  int buffer = reduce_buffer_;
+  reduce_[buffer][2*proc_] = val1;
+  reduce_[buffer][2*proc_+1] = val2;
+  if (reduce_buffer_)
+    reduce_buffer_ = 0;
+  else
+    reduce_buffer_ = 1;
+  wait();
+
+  sum1 = 0.0; sum2 = 0.0;
+  for (int j=0; j<nproc_;j++) { sum1 += reduce_[buffer][2*j]; sum2 += reduce_[buffer][2*j+1]; }
+}
+
 /// @todo: std::min_element
 double ParallelLinearAlgebra::reduce_min(double val)
 {
@@ -805,8 +749,8 @@ ParallelLinearAlgebraSharedData::ParallelLinearAlgebraSharedData(const SolverInp
   imatrices_(inputs),
   barrier_("Parallel Linear Algebra", numProcs),
   numProcs_(numProcs),
-  reduce1_(numProcs),
-  reduce2_(numProcs)
+  reduce1_(2*numProcs),
+  reduce2_(2*numProcs)
 {
   if (inputs.b->nrows() != size_
     || inputs.x->nrows() != size_
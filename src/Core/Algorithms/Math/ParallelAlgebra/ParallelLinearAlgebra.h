@@ -104,7 +104,7 @@ namespace Math {
     SolverInputs imatrices_;
     SCIRun::Core::Thread::Barrier barrier_;
     int numProcs_;
-    /// classes for communication
+    /// classes for communication, two slots per thread so paired sums share one barrier
     std::vector<double> reduce1_;
     std::vector<double> reduce2_;
   };
@@ -160,6 +160,8 @@ public:
 
   // r = s*a + b;
   void scale_add(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
+  // r = s*a + b; returns norm(r)
+  double scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
 
   void add(const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
 
@@ -184,6 +186,13 @@ public:
   double max(const ParallelVector& a);
 
   void mult(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
+  // r = a*b; returns dot(b,r)
+  double mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
+
+  // Fused update of a preconditioned CG step, one reduction for both sums:
+  // x += ak*p; r -= ak*q; z = diag*r; rz = dot(z,r); rnorm = norm(r)
+  void cg_update(double ak, const ParallelVector& p, const ParallelVector& q, const ParallelVector& diag,
+    ParallelVector& x, ParallelVector& r, ParallelVector& z, double& rz, double& rnorm);
   
   void absdiag(const ParallelMatrix& a, ParallelVector& r);
   
@@ -191,6 +200,9 @@ public:
     
   int  proc() { return proc_; }
   int  nproc() { return nproc_; }
+  // rows [start, end) owned by this thread
+  size_t start() { return start_; }
+  size_t end() { return end_; }
     
   bool first() { return proc_ == 0; }
   void wait();
@@ -199,6 +211,7 @@ private:
   double reduce_sum(double val);
   double reduce_min(double val);
   double reduce_max(double val);
+  void reduce_sum2(double val1, double val2, double& sum1, double& sum2);
     
   ParallelLinearAlgebraSharedData& data_;
   
@@ -0,0 +1,539 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <cmath>
+#include <sstream>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun;
+
+namespace
+{
+  // Wavefronts smaller than this are not worth a barrier of their own.
+  const size_t MinParallelLevelSize = 256;
+
+  // Same split of [0,n) over the threads as ParallelLinearAlgebra uses.
+  void localRange(size_t n, int proc, int nproc, size_t& begin, size_t& end)
+  {
+    const size_t local = n / nproc;
+    begin = proc * local;
+    end = (proc == nproc - 1) ? n : begin + local;
+  }
+
+  LevelSchedule buildSchedule(const std::vector<size_t>& level, size_t numLevels)
+  {
+    LevelSchedule schedule;
+    schedule.numLevels = numLevels;
+
+    std::vector<size_t> start(numLevels + 1, 0);
+    for (size_t i = 0; i < level.size(); ++i)
+      start[level[i] + 1]++;
+    for (size_t l = 0; l < numLevels; ++l)
+      start[l + 1] += start[l];
+
+    schedule.rows.resize(level.size());
+    std::vector<size_t> fill(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < level.size(); ++i)
+      schedule.rows[fill[level[i]]++] = static_cast<index_type>(i);
+
+    for (size_t l = 0; l < numLevels; ++l)
+    {
+      const bool serial = start[l + 1] - start[l] < MinParallelLevelSize;
+      if (!serial || schedule.groupSerial.empty() || !schedule.groupSerial.back())
+      {
+        schedule.groupStart.push_back(start[l]);
+        schedule.groupSerial.push_back(serial);
+      }
+    }
+    schedule.groupStart.push_back(level.size());
+    return schedule;
+  }
+
+  template <class RowOp>
+  void sweep(ParallelLinearAlgebra& PLA, const LevelSchedule& schedule, RowOp op)
+  {
+    for (size_t g = 0; g < schedule.numGroups(); ++g)
+    {
+      const size_t groupBegin = schedule.groupStart[g];
+      const size_t groupEnd = schedule.groupStart[g + 1];
+      if (schedule.groupSerial[g])
+      {
+        if (PLA.first())
+          for (size_t k = groupBegin; k < groupEnd; ++k)
+            op(schedule.rows[k]);
+      }
+      else
+      {
+        size_t begin, end;
+        localRange(groupEnd - groupBegin, PLA.proc(), PLA.nproc(), begin, end);
+        for (size_t k = groupBegin + begin; k < groupBegin + end; ++k)
+          op(schedule.rows[k]);
+      }
+      PLA.wait();
+    }
+  }
+}
+
+IncompleteLUPreconditioner::IncompleteLUPreconditioner(const SparseRowMatrix& A)
+{
+  const index_type n = A.nrows();
+  rows_.reserve(n + 1);
+  rows_.push_back(0);
+  columns_.reserve(A.nonZeros());
+  values_.reserve(A.nonZeros());
+  diagonal_.assign(n, -1);
+
+  for (index_type i = 0; i < n; ++i)
+  {
+    for (SparseRowMatrix::InnerIterator it(A, i); it; ++it)
+    {
+      if (it.col() == i)
+        diagonal_[i] = columns_.size();
+      columns_.push_back(it.col());
+      values_.push_back(it.value());
+    }
+    rows_.push_back(columns_.size());
+    if (diagonal_[i] < 0)
+      THROW_ALGORITHM_INPUT_ERROR_SIMPLE("ILU(0) preconditioner needs a diagonal entry in every row of the matrix");
+  }
+
+  // A row depends on the rows named by its strictly lower (forward sweep)
+  // or strictly upper (backward sweep) entries.
+  std::vector<size_t> level(n, 0);
+  size_t numLevels = 0;
+  for (index_type i = 0; i < n; ++i)
+  {
+    size_t l = 0;
+    for (index_type k = rows_[i]; k < diagonal_[i]; ++k)
+      l = std::max(l, level[columns_[k]] + 1);
+    level[i] = l;
+    numLevels = std::max(numLevels, l + 1);
+  }
+  lower_ = buildSchedule(level, numLevels);
+
+  numLevels = 0;
+  for (index_type i = n - 1; i >= 0; --i)
+  {
+    size_t l = 0;
+    for (index_type k = diagonal_[i] + 1; k < rows_[i + 1]; ++k)
+      l = std::max(l, level[columns_[k]] + 1);
+    level[i] = l;
+    numLevels = std::max(numLevels, l + 1);
+  }
+  upper_ = buildSchedule(level, numLevels);
+
+  // Elimination of a row only reads rows of earlier forward levels, so the
+  // factorization follows the same wavefronts as the forward solve.
+  for (size_t g = 0; g < lower_.numGroups(); ++g)
+  {
+    const index_type* groupRows = &lower_.rows[0] + lower_.groupStart[g];
+    const size_t count = lower_.groupStart[g + 1] - lower_.groupStart[g];
+    if (lower_.groupSerial[g])
+    {
+      for (size_t k = 0; k < count; ++k)
+        factorRow(groupRows[k]);
+    }
+    else
+    {
+      Parallel::ForRange(0, count, [this, groupRows](size_t begin, size_t end)
+      {
+        for (size_t k = begin; k < end; ++k)
+          factorRow(groupRows[k]);
+      });
+    }
+  }
+}
+
+void IncompleteLUPreconditioner::factorRow(index_type i)
+{
+  const index_type rowEnd = rows_[i + 1];
+  const double original = values_[diagonal_[i]];
+
+  for (index_type ik = rows_[i]; ik < diagonal_[i]; ++ik)
+  {
+    const index_type k = columns_[ik];
+    const double lik = (values_[ik] /= values_[diagonal_[k]]);
+
+    // a_ij -= l_ik * u_kj, for the j > k present in both rows
+    index_type ij = ik + 1;
+    index_type kj = diagonal_[k] + 1;
+    const index_type kEnd = rows_[k + 1];
+    while (ij < rowEnd && kj < kEnd)
+    {
+      if (columns_[ij] < columns_[kj])
+        ++ij;
+      else if (columns_[ij] > columns_[kj])
+        ++kj;
+      else
+        values_[ij++] -= lik * values_[kj++];
+    }
+  }
+
+  // Dropping fill can wipe out a pivot; fall back to the unfactored diagonal.
+  double& pivot = values_[diagonal_[i]];
+  if (!(std::abs(pivot) > 1e-12 * std::abs(original)))
+    pivot = original != 0.0 ? original : 1.0;
+}
+
+void IncompleteLUPreconditioner::forwardRow(index_type i, const double* r, double* z) const
+{
+  double s = r[i];
+  for (index_type k = rows_[i]; k < diagonal_[i]; ++k)
+    s -= values_[k] * z[columns_[k]];
+  z[i] = s;
+}
+
+void IncompleteLUPreconditioner::backwardRow(index_type i, double* z) const
+{
+  double s = z[i];
+  for (index_type k = diagonal_[i] + 1; k < rows_[i + 1]; ++k)
+    s -= values_[k] * z[columns_[k]];
+  z[i] = s / values_[diagonal_[i]];
+}
+
+void IncompleteLUPreconditioner::apply(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z)
+{
+  const double* rdata = r.data_;
+  double* zdata = z.data_;
+
+  PLA.wait();
+  sweep(PLA, lower_, [this, rdata, zdata](index_type i) { forwardRow(i, rdata, zdata); });
+  sweep(PLA, upper_, [this, zdata](index_type i) { backwardRow(i, zdata); });
+}
+
+std::string IncompleteLUPreconditioner::describe() const
+{
+  std::ostringstream ostr;
+  ostr << "ILU(0) with " << lower_.numLevels << " forward and " << upper_.numLevels
+    << " backward levels in " << lower_.numGroups() << " and " << upper_.numGroups() << " synchronized groups";
+  return ostr.str();
+}
+
+const size_t SmoothedAggregationAMGPreconditioner::MaxCoarseSize;
+const size_t SmoothedAggregationAMGPreconditioner::MaxLevels;
+const int SmoothedAggregationAMGPreconditioner::CoarseSweeps;
+
+namespace
+{
+  typedef Eigen::SparseMatrix<double, Eigen::RowMajor, index_type> CSR;
+
+  // Strength threshold for aggregation on the finest level,
+  // a_ij^2 >= theta^2 |a_ii a_jj|. Coarse operators spread their couplings
+  // over wider stencils, so theta is halved on every coarser level.
+  const double StrengthThreshold = 0.08;
+
+  std::vector<double> inverseDiagonal(const CSR& A)
+  {
+    std::vector<double> inv(A.rows(), 0.0);
+    for (index_type i = 0; i < A.outerSize(); ++i)
+      for (CSR::InnerIterator it(A, i); it; ++it)
+        if (it.col() == i && it.value() != 0.0)
+          inv[i] = 1.0 / it.value();
+    return inv;
+  }
+
+  // Largest eigenvalue of D^-1 A by power iteration.
+  double spectralRadius(const CSR& A, const std::vector<double>& invDiag)
+  {
+    const index_type n = A.rows();
+    Eigen::VectorXd v(n), w(n);
+    for (index_type i = 0; i < n; ++i)
+      v[i] = 1.0 + 0.1 * (i % 7);
+    v.normalize();
+
+    double rho = 0.0;
+    for (int iter = 0; iter < 20; ++iter)
+    {
+      w = A * v;
+      for (index_type i = 0; i < n; ++i)
+        w[i] *= invDiag[i];
+      rho = w.norm();
+      if (rho == 0.0)
+        break;
+      v = w / rho;
+    }
+    return rho;
+  }
+
+  // Standard three pass greedy aggregation over the strong connections.
+  index_type aggregate(const CSR& A, double theta, std::vector<index_type>& agg)
+  {
+    const index_type n = A.rows();
+    std::vector<double> diag(n, 0.0);
+    for (index_type i = 0; i < n; ++i)
+      for (CSR::InnerIterator it(A, i); it; ++it)
+        if (it.col() == i)
+          diag[i] = std::abs(it.value());
+
+    auto strong = [&diag, theta](index_type i, index_type j, double aij)
+    {
+      return i != j && aij*aij >= theta*theta*diag[i]*diag[j];
+    };
+
+    agg.assign(n, -1);
+    index_type count = 0;
+
+    // 1: seed an aggregate at every node whose strong neighbourhood is still free
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] >= 0)
+        continue;
+      bool free = true;
+      for (CSR::InnerIterator it(A, i); it && free; ++it)
+        if (strong(i, it.col(), it.value()) && agg[it.col()] >= 0)
+          free = false;
+      if (!free)
+        continue;
+      agg[i] = count;
+      for (CSR::InnerIterator it(A, i); it; ++it)
+        if (strong(i, it.col(), it.value()))
+          agg[it.col()] = count;
+      ++count;
+    }
+
+    // 2: attach leftovers to the aggregate of their strongest seeded neighbour
+    std::vector<index_type> seeded(agg);
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (seeded[i] >= 0)
+        continue;
+      double best = 0.0;
+      for (CSR::InnerIterator it(A, i); it; ++it)
+        if (strong(i, it.col(), it.value()) && seeded[it.col()] >= 0 && std::abs(it.value()) > best)
+        {
+          best = std::abs(it.value());
+          agg[i] = seeded[it.col()];
+        }
+    }
+
+    // 3: whatever is left forms aggregates with its free strong neighbours
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] >= 0)
+        continue;
+      agg[i] = count;
+      for (CSR::InnerIterator it(A, i); it; ++it)
+        if (strong(i, it.col(), it.value()) && agg[it.col()] < 0)
+          agg[it.col()] = count;
+      ++count;
+    }
+    return count;
+  }
+
+  void multiplyRows(const CSR& A, const double* x, double* y, size_t begin, size_t end)
+  {
+    const index_type* rows = A.outerIndexPtr();
+    const index_type* columns = A.innerIndexPtr();
+    const double* values = A.valuePtr();
+    for (size_t i = begin; i < end; ++i)
+    {
+      double s = 0.0;
+      for (index_type k = rows[i]; k < rows[i + 1]; ++k)
+        s += values[k] * x[columns[k]];
+      y[i] = s;
+    }
+  }
+
+  void residualRows(const CSR& A, const double* b, const double* x, double* t, size_t begin, size_t end)
+  {
+    multiplyRows(A, x, t, begin, end);
+    for (size_t i = begin; i < end; ++i)
+      t[i] = b[i] - t[i];
+  }
+}
+
+SmoothedAggregationAMGPreconditioner::SmoothedAggregationAMGPreconditioner(const SparseRowMatrix& A) :
+  directCoarseSolve_(false)
+{
+  CSR current = static_cast<const SparseRowMatrix::EigenBase&>(A);
+  current.makeCompressed();
+
+  while (true)
+  {
+    levels_.push_back(Level());
+    Level& level = levels_.back();
+    level.A.swap(current);
+    const index_type n = level.A.rows();
+    level.invDiag = inverseDiagonal(level.A);
+    level.x.resize(n);
+    level.b.resize(n);
+    level.t.resize(n);
+
+    const double rho = spectralRadius(level.A, level.invDiag);
+    level.omega = rho > 0.0 ? 4.0 / (3.0 * rho) : 1.0;
+
+    if (static_cast<size_t>(n) <= MaxCoarseSize || levels_.size() == MaxLevels)
+      break;
+
+    std::vector<index_type> agg;
+    const double theta = StrengthThreshold * std::pow(0.5, static_cast<double>(levels_.size() - 1));
+    const index_type numAggregates = aggregate(level.A, theta, agg);
+    // No strong couplings left to exploit; this level becomes the coarsest
+    if (numAggregates == n)
+      break;
+
+    std::vector<double> aggregateSize(numAggregates, 0.0);
+    for (index_type i = 0; i < n; ++i)
+      aggregateSize[agg[i]] += 1.0;
+
+    std::vector<Eigen::Triplet<double, index_type>> entries;
+    entries.reserve(n);
+    for (index_type i = 0; i < n; ++i)
+      entries.emplace_back(i, agg[i], 1.0 / std::sqrt(aggregateSize[agg[i]]));
+    CSR tentative(n, numAggregates);
+    tentative.setFromTriplets(entries.begin(), entries.end());
+
+    // P = (I - omega D^-1 A) T
+    CSR smoothed = level.A * tentative;
+    for (index_type i = 0; i < smoothed.outerSize(); ++i)
+      for (CSR::InnerIterator it(smoothed, i); it; ++it)
+        it.valueRef() *= level.omega * level.invDiag[i];
+    level.P = tentative - smoothed;
+    level.P.makeCompressed();
+    level.R = level.P.transpose();
+    level.R.makeCompressed();
+
+    CSR AP = level.A * level.P;
+    current = level.R * AP;
+    current.makeCompressed();
+  }
+
+  // A stalled or level capped hierarchy can end far above MaxCoarseSize,
+  // where a dense factorization would not even fit in memory
+  const Level& coarsest = levels_.back();
+  directCoarseSolve_ = static_cast<size_t>(coarsest.A.rows()) <= MaxCoarseSize;
+  if (directCoarseSolve_)
+    coarseSolver_.compute(Eigen::MatrixXd(coarsest.A));
+}
+
+void SmoothedAggregationAMGPreconditioner::cycle(ParallelLinearAlgebra& PLA, size_t l, const double* b, double* x)
+{
+  Level& level = levels_[l];
+
+  if (l + 1 == levels_.size())
+  {
+    PLA.wait();
+    if (directCoarseSolve_)
+    {
+      if (PLA.first())
+      {
+        const index_type n = level.A.rows();
+        Eigen::Map<Eigen::VectorXd>(x, n) = coarseSolver_.solve(Eigen::Map<const Eigen::VectorXd>(b, n));
+      }
+    }
+    else
+    {
+      // A fixed number of Jacobi sweeps from zero is a polynomial in D^-1 A
+      // times D^-1, so the cycle stays symmetric
+      size_t begin, end;
+      localRange(level.A.rows(), PLA.proc(), PLA.nproc(), begin, end);
+      double* t = &level.t[0];
+      for (size_t i = begin; i < end; ++i)
+        x[i] = level.omega * level.invDiag[i] * b[i];
+      for (int sweep = 1; sweep < CoarseSweeps; ++sweep)
+      {
+        PLA.wait();
+        residualRows(level.A, b, x, t, begin, end);
+        PLA.wait();
+        for (size_t i = begin; i < end; ++i)
+          x[i] += level.omega * level.invDiag[i] * t[i];
+      }
+    }
+    PLA.wait();
+    return;
+  }
+
+  Level& coarse = levels_[l + 1];
+  size_t begin, end, coarseBegin, coarseEnd;
+  localRange(level.A.rows(), PLA.proc(), PLA.nproc(), begin, end);
+  localRange(coarse.A.rows(), PLA.proc(), PLA.nproc(), coarseBegin, coarseEnd);
+  double* t = &level.t[0];
+
+  // Pre-smoothing from a zero guess
+  for (size_t i = begin; i < end; ++i)
+    x[i] = level.omega * level.invDiag[i] * b[i];
+  PLA.wait();
+
+  residualRows(level.A, b, x, t, begin, end);
+  PLA.wait();
+
+  multiplyRows(level.R, t, &coarse.b[0], coarseBegin, coarseEnd);
+  cycle(PLA, l + 1, &coarse.b[0], &coarse.x[0]);
+  PLA.wait();
+
+  // Coarse grid correction
+  const index_type* rows = level.P.outerIndexPtr();
+  const index_type* columns = level.P.innerIndexPtr();
+  const double* values = level.P.valuePtr();
+  for (size_t i = begin; i < end; ++i)
+  {
+    double s = 0.0;
+    for (index_type k = rows[i]; k < rows[i + 1]; ++k)
+      s += values[k] * coarse.x[columns[k]];
+    x[i] += s;
+  }
+  PLA.wait();
+
+  // Post-smoothing, the adjoint of the pre-smoother so the cycle stays symmetric
+  residualRows(level.A, b, x, t, begin, end);
+  PLA.wait();
+  for (size_t i = begin; i < end; ++i)
+    x[i] += level.omega * level.invDiag[i] * t[i];
+}
+
+void SmoothedAggregationAMGPreconditioner::apply(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z)
+{
+  PLA.wait();
+  cycle(PLA, 0, r.data_, z.data_);
+  PLA.wait();
+}
+
+std::string SmoothedAggregationAMGPreconditioner::describe() const
+{
+  double nnz = 0.0;
+  std::ostringstream sizes;
+  for (const auto& level : levels_)
+  {
+    sizes << " " << level.A.rows();
+    nnz += level.A.nonZeros();
+  }
+  std::ostringstream ostr;
+  ostr << "smoothed aggregation AMG with " << levels_.size() << " levels of size" << sizes.str()
+    << ", operator complexity " << nnz / levels_.front().A.nonZeros()
+    << (directCoarseSolve_ ? ", direct coarse solve" : ", Jacobi coarse solve");
+  return ostr.str();
+}
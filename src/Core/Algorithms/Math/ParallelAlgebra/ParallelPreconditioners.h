@@ -0,0 +1,146 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONERS_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONERS_H
+
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Preconditioner applied from inside ParallelLinearAlgebraBase::parallel().
+  /// Setup happens once, single threaded, in the constructor; apply() is a
+  /// collective call that every solver thread makes with the same arguments.
+  class SCISHARE ParallelPreconditioner : boost::noncopyable
+  {
+  public:
+    virtual ~ParallelPreconditioner() {}
+
+    /// z = M^-1 r. r and z must be different vectors.
+    virtual void apply(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& r,
+      ParallelLinearAlgebra::ParallelVector& z) = 0;
+
+    /// One-line summary for the solver log.
+    virtual std::string describe() const = 0;
+  };
+
+  /// Rows of a triangular sweep grouped into wavefronts that can be processed
+  /// concurrently. Wavefronts too small to be worth a barrier are merged into
+  /// runs that the first thread processes on its own.
+  struct SCISHARE LevelSchedule
+  {
+    std::vector<index_type> rows;
+    std::vector<size_t> groupStart;
+    std::vector<bool> groupSerial;
+    size_t numLevels = 0;
+
+    size_t numGroups() const { return groupSerial.size(); }
+  };
+
+  /// ILU(0): incomplete LU restricted to the sparsity pattern of A. For a
+  /// symmetric matrix this is the IC(0) factor stored in LDL^T form.
+  /// Factorization and both triangular solves are level scheduled.
+  class SCISHARE IncompleteLUPreconditioner : public ParallelPreconditioner
+  {
+  public:
+    explicit IncompleteLUPreconditioner(const Datatypes::SparseRowMatrix& A);
+
+    virtual void apply(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& r,
+      ParallelLinearAlgebra::ParallelVector& z) override;
+    virtual std::string describe() const override;
+
+    const LevelSchedule& lowerSchedule() const { return lower_; }
+    const LevelSchedule& upperSchedule() const { return upper_; }
+
+  private:
+    void factorRow(index_type i);
+    void forwardRow(index_type i, const double* r, double* z) const;
+    void backwardRow(index_type i, double* z) const;
+
+    std::vector<index_type> rows_;
+    std::vector<index_type> columns_;
+    std::vector<double> values_;
+    std::vector<index_type> diagonal_;
+    LevelSchedule lower_;
+    LevelSchedule upper_;
+  };
+
+  /// Smoothed aggregation algebraic multigrid, applied as one symmetric
+  /// V(1,1) cycle with damped Jacobi smoothing. The coarsest level is solved
+  /// by dense LU when it is small enough, and by CoarseSweeps Jacobi sweeps
+  /// when coarsening stalled above MaxCoarseSize.
+  class SCISHARE SmoothedAggregationAMGPreconditioner : public ParallelPreconditioner
+  {
+  public:
+    explicit SmoothedAggregationAMGPreconditioner(const Datatypes::SparseRowMatrix& A);
+
+    virtual void apply(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& r,
+      ParallelLinearAlgebra::ParallelVector& z) override;
+    virtual std::string describe() const override;
+
+    size_t numLevels() const { return levels_.size(); }
+    size_t levelSize(size_t level) const { return levels_[level].A.rows(); }
+    bool directCoarseSolve() const { return directCoarseSolve_; }
+
+    static const size_t MaxCoarseSize = 400;
+    static const size_t MaxLevels = 10;
+    static const int CoarseSweeps = 4;
+
+  private:
+    typedef Eigen::SparseMatrix<double, Eigen::RowMajor, index_type> CSR;
+
+    struct Level
+    {
+      CSR A;
+      CSR P;
+      CSR R;
+      std::vector<double> invDiag;
+      double omega;
+      std::vector<double> x, b, t;
+    };
+
+    void cycle(ParallelLinearAlgebra& PLA, size_t level, const double* b, double* x);
+
+    std::vector<Level> levels_;
+    bool directCoarseSolve_;
+    Eigen::PartialPivLU<Eigen::MatrixXd> coarseSolver_;
+  };
+
+}}}}
+
+#endif
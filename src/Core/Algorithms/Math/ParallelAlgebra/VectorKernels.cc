@@ -0,0 +1,382 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <atomic>
+#include <Core/Algorithms/Math/ParallelAlgebra/VectorKernels.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SCIRUN_VECTOR_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms::Math::VectorKernels;
+
+namespace
+{
+  // Four independent accumulators so the scalar loops are not serialized on
+  // the latency of a single add chain.
+
+  double dotScalar(const double* a, const double* b, size_t n)
+  {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+      s0 += a[i]*b[i];
+      s1 += a[i+1]*b[i+1];
+      s2 += a[i+2]*b[i+2];
+      s3 += a[i+3]*b[i+3];
+    }
+    for (; i < n; ++i)
+      s0 += a[i]*b[i];
+    return (s0 + s1) + (s2 + s3);
+  }
+
+  void scaleAddScalar(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      r[i] = s*a[i] + b[i];
+  }
+
+  double scaleAddNorm2Scalar(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    double s0 = 0.0, s1 = 0.0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+      const double v0 = s*a[i] + b[i];
+      const double v1 = s*a[i+1] + b[i+1];
+      r[i] = v0;
+      r[i+1] = v1;
+      s0 += v0*v0;
+      s1 += v1*v1;
+    }
+    for (; i < n; ++i)
+    {
+      const double v = s*a[i] + b[i];
+      r[i] = v;
+      s0 += v*v;
+    }
+    return s0 + s1;
+  }
+
+  void cgUpdateScalar(double ak, const double* p, const double* q, const double* diag,
+    double* x, double* r, double* z, size_t n, double& rz, double& rr)
+  {
+    double sz = 0.0, sr = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+      x[i] += ak*p[i];
+      const double ri = r[i] - ak*q[i];
+      const double zi = diag[i]*ri;
+      r[i] = ri;
+      z[i] = zi;
+      sz += zi*ri;
+      sr += ri*ri;
+    }
+    rz = sz;
+    rr = sr;
+  }
+
+#ifdef SCIRUN_VECTOR_KERNELS_X86
+
+  __attribute__((target("avx2,fma")))
+  double horizontalSum(__m256d v)
+  {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+  }
+
+  __attribute__((target("avx2,fma")))
+  double dotAVX2(const double* a, const double* b, size_t n)
+  {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+      s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+      s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+    }
+    double sum = horizontalSum(_mm256_add_pd(s0, s1));
+    for (; i < n; ++i)
+      sum += a[i]*b[i];
+    return sum;
+  }
+
+  __attribute__((target("avx2,fma")))
+  void scaleAddAVX2(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    const __m256d vs = _mm256_set1_pd(s);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+      _mm256_storeu_pd(r + i, _mm256_fmadd_pd(vs, _mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    for (; i < n; ++i)
+      r[i] = s*a[i] + b[i];
+  }
+
+  __attribute__((target("avx2,fma")))
+  double scaleAddNorm2AVX2(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    const __m256d vs = _mm256_set1_pd(s);
+    __m256d acc = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+      const __m256d v = _mm256_fmadd_pd(vs, _mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+      _mm256_storeu_pd(r + i, v);
+      acc = _mm256_fmadd_pd(v, v, acc);
+    }
+    double sum = horizontalSum(acc);
+    for (; i < n; ++i)
+    {
+      const double v = s*a[i] + b[i];
+      r[i] = v;
+      sum += v*v;
+    }
+    return sum;
+  }
+
+  __attribute__((target("avx2,fma")))
+  void cgUpdateAVX2(double ak, const double* p, const double* q, const double* diag,
+    double* x, double* r, double* z, size_t n, double& rz, double& rr)
+  {
+    const __m256d vak = _mm256_set1_pd(ak);
+    __m256d accz = _mm256_setzero_pd(), accr = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+      _mm256_storeu_pd(x + i, _mm256_fmadd_pd(vak, _mm256_loadu_pd(p + i), _mm256_loadu_pd(x + i)));
+      const __m256d ri = _mm256_fnmadd_pd(vak, _mm256_loadu_pd(q + i), _mm256_loadu_pd(r + i));
+      const __m256d zi = _mm256_mul_pd(_mm256_loadu_pd(diag + i), ri);
+      _mm256_storeu_pd(r + i, ri);
+      _mm256_storeu_pd(z + i, zi);
+      accz = _mm256_fmadd_pd(zi, ri, accz);
+      accr = _mm256_fmadd_pd(ri, ri, accr);
+    }
+    double sz = 0.0, sr = 0.0;
+    cgUpdateScalar(ak, p + i, q + i, diag + i, x + i, r + i, z + i, n - i, sz, sr);
+    rz = horizontalSum(accz) + sz;
+    rr = horizontalSum(accr) + sr;
+  }
+
+  __attribute__((target("avx512f")))
+  double dotAVX512(const double* a, const double* b, size_t n)
+  {
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+      s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+      s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), s1);
+    }
+    double sum = _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+    for (; i < n; ++i)
+      sum += a[i]*b[i];
+    return sum;
+  }
+
+  __attribute__((target("avx512f")))
+  void scaleAddAVX512(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    const __m512d vs = _mm512_set1_pd(s);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+      _mm512_storeu_pd(r + i, _mm512_fmadd_pd(vs, _mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    for (; i < n; ++i)
+      r[i] = s*a[i] + b[i];
+  }
+
+  __attribute__((target("avx512f")))
+  double scaleAddNorm2AVX512(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    const __m512d vs = _mm512_set1_pd(s);
+    __m512d acc = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+      const __m512d v = _mm512_fmadd_pd(vs, _mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+      _mm512_storeu_pd(r + i, v);
+      acc = _mm512_fmadd_pd(v, v, acc);
+    }
+    double sum = _mm512_reduce_add_pd(acc);
+    for (; i < n; ++i)
+    {
+      const double v = s*a[i] + b[i];
+      r[i] = v;
+      sum += v*v;
+    }
+    return sum;
+  }
+
+  __attribute__((target("avx512f")))
+  void cgUpdateAVX512(double ak, const double* p, const double* q, const double* diag,
+    double* x, double* r, double* z, size_t n, double& rz, double& rr)
+  {
+    const __m512d vak = _mm512_set1_pd(ak);
+    __m512d accz = _mm512_setzero_pd(), accr = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+      _mm512_storeu_pd(x + i, _mm512_fmadd_pd(vak, _mm512_loadu_pd(p + i), _mm512_loadu_pd(x + i)));
+      const __m512d ri = _mm512_fnmadd_pd(vak, _mm512_loadu_pd(q + i), _mm512_loadu_pd(r + i));
+      const __m512d zi = _mm512_mul_pd(_mm512_loadu_pd(diag + i), ri);
+      _mm512_storeu_pd(r + i, ri);
+      _mm512_storeu_pd(z + i, zi);
+      accz = _mm512_fmadd_pd(zi, ri, accz);
+      accr = _mm512_fmadd_pd(ri, ri, accr);
+    }
+    double sz = 0.0, sr = 0.0;
+    cgUpdateScalar(ak, p + i, q + i, diag + i, x + i, r + i, z + i, n - i, sz, sr);
+    rz = _mm512_reduce_add_pd(accz) + sz;
+    rr = _mm512_reduce_add_pd(accr) + sr;
+  }
+
+#endif
+
+  struct KernelTable
+  {
+    double (*dot)(const double*, const double*, size_t);
+    void (*scaleAdd)(double, const double*, const double*, double*, size_t);
+    double (*scaleAddNorm2)(double, const double*, const double*, double*, size_t);
+    void (*cgUpdate)(double, const double*, const double*, const double*, double*, double*, double*, size_t, double&, double&);
+  };
+
+  const KernelTable tables[] =
+  {
+    { dotScalar, scaleAddScalar, scaleAddNorm2Scalar, cgUpdateScalar },
+#ifdef SCIRUN_VECTOR_KERNELS_X86
+    { dotAVX2, scaleAddAVX2, scaleAddNorm2AVX2, cgUpdateAVX2 },
+    { dotAVX512, scaleAddAVX512, scaleAddNorm2AVX512, cgUpdateAVX512 },
+#endif
+  };
+
+  InstructionSet detect()
+  {
+#ifdef SCIRUN_VECTOR_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+      return InstructionSet::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return InstructionSet::AVX2;
+#endif
+    return InstructionSet::SCALAR;
+  }
+
+  std::atomic<const KernelTable*>& activeTable()
+  {
+    static std::atomic<const KernelTable*> active(&tables[static_cast<int>(detectedInstructionSet())]);
+    return active;
+  }
+
+  const KernelTable& kernels()
+  {
+    return *activeTable().load(std::memory_order_relaxed);
+  }
+}
+
+InstructionSet VectorKernels::detectedInstructionSet()
+{
+  static const InstructionSet detected = detect();
+  return detected;
+}
+
+InstructionSet VectorKernels::activeInstructionSet()
+{
+  return static_cast<InstructionSet>(&kernels() - tables);
+}
+
+void VectorKernels::selectInstructionSet(InstructionSet set)
+{
+  if (static_cast<int>(set) > static_cast<int>(detectedInstructionSet()))
+    set = detectedInstructionSet();
+  activeTable().store(&tables[static_cast<int>(set)]);
+}
+
+const char* VectorKernels::instructionSetName(InstructionSet set)
+{
+  switch (set)
+  {
+  case InstructionSet::AVX2:
+    return "AVX2";
+  case InstructionSet::AVX512:
+    return "AVX-512";
+  default:
+    return "scalar";
+  }
+}
+
+double VectorKernels::dot(const double* a, const double* b, size_t n)
+{
+  return kernels().dot(a, b, n);
+}
+
+void VectorKernels::scaleAdd(double s, const double* a, const double* b, double* r, size_t n)
+{
+  kernels().scaleAdd(s, a, b, r, n);
+}
+
+double VectorKernels::scaleAddNorm2(double s, const double* a, const double* b, double* r, size_t n)
+{
+  return kernels().scaleAddNorm2(s, a, b, r, n);
+}
+
+void VectorKernels::cgUpdate(double ak, const double* p, const double* q, const double* diag,
+  double* x, double* r, double* z, size_t n, double& rz, double& rr)
+{
+  kernels().cgUpdate(ak, p, q, diag, x, r, z, n, rz, rr);
+}
+
+double VectorKernels::multDot(const index_type* rows, const index_type* columns, const double* values,
+  const double* x, double* y, size_t begin, size_t end)
+{
+  // Row lengths of FE stiffness matrices are short, so the gathers a SIMD
+  // row product needs cost more than they save; the gain here comes from
+  // forming the dot product while y[i] is still in a register.
+  double sum = 0.0;
+  for (size_t i = begin; i < end; ++i)
+  {
+    const index_type next = rows[i + 1];
+    double s0 = 0.0, s1 = 0.0;
+    index_type j = rows[i];
+    for (; j + 2 <= next; j += 2)
+    {
+      s0 += values[j]*x[columns[j]];
+      s1 += values[j + 1]*x[columns[j + 1]];
+    }
+    if (j < next)
+      s0 += values[j]*x[columns[j]];
+    const double yi = s0 + s1;
+    y[i] = yi;
+    sum += x[i]*yi;
+  }
+  return sum;
+}
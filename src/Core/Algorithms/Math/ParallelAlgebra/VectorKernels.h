@@ -0,0 +1,76 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_VECTORKERNELS_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_VECTORKERNELS_H
+
+#include <cstddef>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Inner loops of ParallelLinearAlgebra. Each kernel works on one thread's
+  /// contiguous slice; reductions return the local partial result only.
+  /// The x86 builds carry AVX2 and AVX-512 variants that are picked once at
+  /// runtime from the CPU feature flags, other builds use the scalar loops.
+  namespace VectorKernels
+  {
+    enum class InstructionSet { SCALAR, AVX2, AVX512 };
+
+    /// Widest instruction set supported by both this build and this CPU.
+    SCISHARE InstructionSet detectedInstructionSet();
+    SCISHARE InstructionSet activeInstructionSet();
+    /// Requests wider than detectedInstructionSet() are clamped; used by tests and benchmarks.
+    SCISHARE void selectInstructionSet(InstructionSet set);
+    SCISHARE const char* instructionSetName(InstructionSet set);
+
+    /// sum(a[i]*b[i])
+    SCISHARE double dot(const double* a, const double* b, size_t n);
+    /// r[i] = s*a[i] + b[i]; r may alias a or b.
+    SCISHARE void scaleAdd(double s, const double* a, const double* b, double* r, size_t n);
+    /// r[i] = s*a[i] + b[i], returns sum(r[i]*r[i]).
+    SCISHARE double scaleAddNorm2(double s, const double* a, const double* b, double* r, size_t n);
+
+    /// Update step of a preconditioned CG iteration in a single pass:
+    ///   x += ak*p;  r -= ak*q;  z = diag*r;  rz = sum(z*r);  rr = sum(r*r)
+    SCISHARE void cgUpdate(double ak, const double* p, const double* q, const double* diag,
+      double* x, double* r, double* z, size_t n, double& rz, double& rr);
+
+    /// CSR product y = A*x over rows [begin, end), returns sum(x[i]*y[i]) over those rows.
+    SCISHARE double multDot(const index_type* rows, const index_type* columns, const double* values,
+      const double* x, double* y, size_t begin, size_t end);
+  }
+
+}}}}
+
+#endif
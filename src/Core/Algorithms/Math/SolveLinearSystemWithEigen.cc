@@ -33,6 +33,7 @@
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Logging/Trace.h>
 #include <Eigen/Sparse>
 
 using namespace SCIRun;
@@ -58,7 +59,10 @@ namespace
     typename ColumnMatrixType::EigenBase solveWithEigen(const MatrixType& lhs)
     {
       SolverType<typename MatrixType::EigenBase> solver;
-      solver.compute(lhs);
+      {
+        SCIRUN_TRACE_SCOPE("solver", "preconditioner setup");
+        solver.compute(lhs);
+      }
 
       if (solver.info() != Eigen::Success)
         BOOST_THROW_EXCEPTION(AlgorithmInputException()
@@ -67,6 +71,7 @@ namespace
 
       solver.setTolerance(tolerance_);
       solver.setMaxIterations(maxIterations_);
+      SCIRUN_TRACE_SCOPE("solver", "solve");
       auto solution = solver.solve(*rhs_).eval();
       tolerance_ = solver.error();
       maxIterations_ = solver.iterations();
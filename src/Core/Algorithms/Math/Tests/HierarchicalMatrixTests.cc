@@ -0,0 +1,125 @@
+  /*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Math/HierarchicalMatrix/HierarchicalMatrix.h>
+#include <boost/random.hpp>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun;
+
+namespace
+{
+  std::vector<Point> randomPoints(int n, const Point& center, double size, int seed)
+  {
+    boost::mt19937 rng(seed);
+    boost::uniform_real<double> range(-0.5 * size, 0.5 * size);
+    boost::variate_generator<boost::mt19937&, boost::uniform_real<double> > uniform(rng, range);
+    std::vector<Point> points;
+    for (int i = 0; i < n; ++i)
+      points.push_back(center + Vector(uniform(), uniform(), uniform()));
+    return points;
+  }
+
+  // Smooth single layer like kernel, shifted so coinciding points stay finite
+  struct Kernel
+  {
+    const std::vector<Point>& rows;
+    const std::vector<Point>& cols;
+    double operator()(index_type i, index_type j) const
+    {
+      return 1.0 / ((rows[i] - cols[j]).length() + 0.05);
+    }
+  };
+
+  DenseMatrix denseKernel(const std::vector<Point>& rows, const std::vector<Point>& cols)
+  {
+    Kernel kernel = { rows, cols };
+    DenseMatrix A(rows.size(), cols.size());
+    for (size_t i = 0; i < rows.size(); ++i)
+      for (size_t j = 0; j < cols.size(); ++j)
+        A(i, j) = kernel(i, j);
+    return A;
+  }
+
+  double relativeError(const DenseMatrix& a, const DenseMatrix& b)
+  {
+    return (a - b).norm() / b.norm();
+  }
+}
+
+TEST(HierarchicalMatrixTests, SeparatedClustersCompress)
+{
+  auto rows = randomPoints(600, Point(0, 0, 0), 1.0, 1);
+  auto cols = randomPoints(500, Point(3, 0, 0), 1.0, 2);
+  Kernel kernel = { rows, cols };
+  HierarchicalMatrix H(rows, cols, kernel, 1e-6);
+  auto A = denseKernel(rows, cols);
+
+  EXPECT_EQ(600, H.rows());
+  EXPECT_EQ(500, H.cols());
+  EXPECT_GT(H.numLowRankBlocks(), 0);
+  EXPECT_LT(H.storedEntries(), A.size() / 5);
+
+  DenseMatrix x = DenseMatrix::Random(500, 1);
+  EXPECT_LT(relativeError(H.multiply(x), A * x), 1e-5);
+
+  DenseMatrix X = DenseMatrix::Random(500, 7);
+  EXPECT_LT(relativeError(H.multiply(X), A * X), 1e-5);
+
+  DenseMatrix Z = DenseMatrix::Random(600, 3);
+  EXPECT_LT(relativeError(H.multiplyTransposed(Z), A.transpose() * Z), 1e-5);
+}
+
+TEST(HierarchicalMatrixTests, OverlappingClustersMatchDense)
+{
+  auto points = randomPoints(800, Point(0, 0, 0), 2.0, 3);
+  Kernel kernel = { points, points };
+  HierarchicalMatrix H(points, points, kernel, 1e-8, 1.0, 16);
+  auto A = denseKernel(points, points);
+
+  DenseMatrix x = DenseMatrix::Random(800, 1);
+  EXPECT_LT(relativeError(H.multiply(x), A * x), 1e-6);
+
+  DenseMatrix B = DenseMatrix::Zero(810, 805);
+  H.addTo(B, 10, 5, 2.0);
+  EXPECT_LT(relativeError(B.block(10, 5, 800, 800), 2.0 * A), 1e-6);
+  EXPECT_EQ(0.0, B.block(0, 0, 10, 805).norm());
+}
+
+TEST(HierarchicalMatrixTests, ZeroMatrixHasRankZeroBlocks)
+{
+  auto rows = randomPoints(200, Point(0, 0, 0), 1.0, 4);
+  auto cols = randomPoints(200, Point(5, 0, 0), 1.0, 5);
+  HierarchicalMatrix H(rows, cols, [](index_type, index_type) { return 0.0; }, 1e-6);
+
+  DenseMatrix x = DenseMatrix::Random(200, 2);
+  EXPECT_EQ(0.0, H.multiply(x).norm());
+}
@@ -31,6 +31,7 @@
 
 #include <fstream>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/VectorKernels.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
@@ -976,3 +977,147 @@ TEST(ParallelArithmeticTests, CanComputeDotProductMulti)
   EXPECT_EQ(-9 , v23);
   EXPECT_EQ(9 , v13);
 }
+
+TEST(ParallelArithmeticTests, CanComputeFusedMatrixVectorProductAndDot)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(),1);
+  ParallelLinearAlgebra pla(data,0);
+
+  ParallelLinearAlgebra::ParallelMatrix m1;
+  auto mat1 = matrix1();
+  pla.add_matrix(mat1,m1);
+
+  ParallelLinearAlgebra::ParallelVector v1, r;
+  auto vec1 = vector1();
+  pla.add_vector(vec1,v1);
+  pla.new_vector(r);
+
+  EXPECT_EQ(-5, pla.mult_dot(m1,v1,r));
+  EXPECT_EQ(1, r.data_[0]);
+  EXPECT_EQ(-4, r.data_[1]);
+  EXPECT_EQ(-2, r.data_[size-1]);
+
+  ParallelLinearAlgebra::ParallelVector v3;
+  auto vec3 = vector3();
+  pla.add_vector(vec3,v3);
+
+  EXPECT_DOUBLE_EQ(sqrt(174.0), pla.scale_add_norm(2,v1,v3,r));
+  EXPECT_EQ(5, r.data_[1]);
+  EXPECT_EQ(-9, r.data_[size-1]);
+}
+
+struct cgUpdateMult
+{
+  cgUpdateMult(ParallelLinearAlgebraSharedData& data, int proc,
+    DenseColumnMatrixHandle p, DenseColumnMatrixHandle q, DenseColumnMatrixHandle x, DenseColumnMatrixHandle r) :
+    data_(data), proc_(proc), p_(p), q_(q), x_(x), r_(r), rz_(0), rnorm_(0) {}
+
+  ParallelLinearAlgebraSharedData& data_;
+  int proc_;
+  DenseColumnMatrixHandle p_, q_, x_, r_;
+  double rz_;
+  double rnorm_;
+
+  void operator()()
+  {
+    ParallelLinearAlgebra pla(data_, proc_);
+    ParallelLinearAlgebra::ParallelVector p, q, x, r, diag, z;
+    pla.add_vector(p_, p);
+    pla.add_vector(q_, q);
+    pla.add_vector(x_, x);
+    pla.add_vector(r_, r);
+    pla.new_vector(diag);
+    pla.new_vector(z);
+    pla.ones(diag);
+    pla.scale(0.5, diag, diag);
+    pla.cg_update(2, p, q, diag, x, r, z, rz_, rnorm_);
+  }
+};
+
+TEST(ParallelArithmeticTests, CanComputeFusedCGUpdateMulti)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(), 2);
+
+  auto p = vector1();
+  auto q = vector3();
+  auto x = vector2();
+  auto r = vector1();
+  // x += 2*p; r -= 2*q; z = 0.5*r
+  DenseColumnMatrix expectedX = *x + 2 * *p;
+  DenseColumnMatrix expectedR = *r - 2 * *q;
+  {
+    cgUpdateMult c0(data, 0, p, q, x, r);
+    cgUpdateMult c1(data, 1, p, q, x, r);
+
+    boost::thread t1 = boost::thread(boost::ref(c0));
+    boost::thread t2 = boost::thread(boost::ref(c1));
+    t1.join();
+    t2.join();
+
+    const double rr = expectedR.squaredNorm();
+    EXPECT_DOUBLE_EQ(0.5*rr, c0.rz_);
+    EXPECT_DOUBLE_EQ(sqrt(rr), c0.rnorm_);
+    EXPECT_DOUBLE_EQ(c0.rnorm_, c1.rnorm_);
+  }
+  EXPECT_EQ(expectedX, *x);
+  EXPECT_EQ(expectedR, *r);
+}
+
+TEST(VectorKernelTests, EveryAvailableInstructionSetMatchesReferenceLoops)
+{
+  using namespace VectorKernels;
+  const InstructionSet original = activeInstructionSet();
+
+  // Odd lengths exercise the scalar tails after the vector loops.
+  for (size_t n : { 1, 7, 37, 1003 })
+  {
+    std::vector<double> a(n), b(n), d(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      a[i] = 0.25 * (i % 13) - 1.0;
+      b[i] = 1.0 / (i + 1.0);
+      d[i] = 0.5 + (i % 3);
+    }
+
+    double dotRef = 0, normRef = 0, rzRef = 0, rrRef = 0;
+    std::vector<double> addRef(n), xRef(b), rRef(a);
+    for (size_t i = 0; i < n; ++i)
+    {
+      dotRef += a[i]*b[i];
+      addRef[i] = 3*a[i] + b[i];
+      normRef += addRef[i]*addRef[i];
+      xRef[i] += 0.5*a[i];
+      rRef[i] -= 0.5*b[i];
+      rzRef += d[i]*rRef[i]*rRef[i];
+      rrRef += rRef[i]*rRef[i];
+    }
+
+    for (int set = 0; set <= static_cast<int>(detectedInstructionSet()); ++set)
+    {
+      selectInstructionSet(static_cast<InstructionSet>(set));
+      SCOPED_TRACE(instructionSetName(activeInstructionSet()));
+      ASSERT_EQ(set, static_cast<int>(activeInstructionSet()));
+
+      EXPECT_NEAR(dotRef, dot(&a[0], &b[0], n), 1e-12);
+
+      std::vector<double> r(n);
+      EXPECT_NEAR(normRef, scaleAddNorm2(3, &a[0], &b[0], &r[0], n), 1e-10);
+      for (size_t i = 0; i < n; ++i)
+        EXPECT_DOUBLE_EQ(addRef[i], r[i]);
+
+      std::vector<double> x(b), res(a), z(n);
+      double rz, rr;
+      cgUpdate(0.5, &a[0], &b[0], &d[0], &x[0], &res[0], &z[0], n, rz, rr);
+      EXPECT_NEAR(rzRef, rz, 1e-10);
+      EXPECT_NEAR(rrRef, rr, 1e-10);
+      for (size_t i = 0; i < n; ++i)
+      {
+        EXPECT_DOUBLE_EQ(xRef[i], x[i]);
+        EXPECT_DOUBLE_EQ(rRef[i], res[i]);
+        EXPECT_DOUBLE_EQ(d[i]*rRef[i], z[i]);
+      }
+    }
+  }
+
+  selectInstructionSet(original);
+}
@@ -0,0 +1,301 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun;
+
+namespace
+{
+  typedef Eigen::Triplet<double> T;
+
+  SparseRowMatrixHandle tridiagonal(int n)
+  {
+    std::vector<T> entries;
+    for (int i = 0; i < n; ++i)
+    {
+      entries.emplace_back(i, i, 2.5);
+      if (i > 0) entries.emplace_back(i, i - 1, -1.0);
+      if (i < n - 1) entries.emplace_back(i, i + 1, -1.0);
+    }
+    auto m = boost::make_shared<SparseRowMatrix>(n, n);
+    m->setFromTriplets(entries.begin(), entries.end());
+    return m;
+  }
+
+  // Finite volume stiffness matrix of an n^3 grid with a poorly conducting
+  // shell and a strongly conducting core, the kind of conductivity contrast
+  // that stalls diagonally preconditioned CG on head models.
+  SparseRowMatrixHandle heterogeneousStiffness(int n)
+  {
+    auto index = [n](int i, int j, int k) { return (k*n + j)*n + i; };
+    auto sigma = [n](int i, int j, int k)
+    {
+      const double c = 0.5*(n - 1);
+      const double r = std::sqrt((i - c)*(i - c) + (j - c)*(j - c) + (k - c)*(k - c)) / c;
+      if (r < 0.35) return 10.0;
+      if (r > 0.7 && r < 0.85) return 0.0125;
+      return 1.0;
+    };
+
+    std::vector<T> entries;
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          const int row = index(i, j, k);
+          const double s = sigma(i, j, k);
+          double diag = 0.0;
+          const int offsets[6][3] = { {1,0,0}, {-1,0,0}, {0,1,0}, {0,-1,0}, {0,0,1}, {0,0,-1} };
+          for (const auto& o : offsets)
+          {
+            const int ni = i + o[0], nj = j + o[1], nk = k + o[2];
+            if (ni < 0 || nj < 0 || nk < 0 || ni >= n || nj >= n || nk >= n)
+            {
+              diag += s;
+              continue;
+            }
+            const double sn = sigma(ni, nj, nk);
+            const double face = 2.0*s*sn/(s + sn);
+            entries.emplace_back(row, index(ni, nj, nk), -face);
+            diag += face;
+          }
+          entries.emplace_back(row, row, diag);
+        }
+    auto m = boost::make_shared<SparseRowMatrix>(n*n*n, n*n*n);
+    m->setFromTriplets(entries.begin(), entries.end());
+    return m;
+  }
+
+  DenseColumnMatrixHandle smoothVector(size_t n)
+  {
+    auto v = boost::make_shared<DenseColumnMatrix>(n);
+    for (size_t i = 0; i < n; ++i)
+      (*v)[i] = std::sin(0.01*i) + 0.5*std::cos(0.37*i);
+    return v;
+  }
+
+  // Applies a preconditioner to b from inside a gang of solver threads.
+  class ApplyPreconditioner : public ParallelLinearAlgebraBase
+  {
+  public:
+    explicit ApplyPreconditioner(ParallelPreconditioner& pc) : pc_(pc) {}
+
+    virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const override
+    {
+      ParallelLinearAlgebra::ParallelVector b, z;
+      if (!PLA.add_vector(matrices.b, b) || !PLA.add_vector(matrices.x, z))
+        return false;
+      pc_.apply(PLA, b, z);
+      return true;
+    }
+
+    DenseColumnMatrix run(SparseRowMatrixHandle A, DenseColumnMatrixHandle b, int nproc)
+    {
+      SolverInputs inputs;
+      inputs.A = A;
+      inputs.b = b;
+      inputs.x0 = b;
+      inputs.x = boost::make_shared<DenseColumnMatrix>(b->nrows());
+      EXPECT_TRUE(start_parallel(inputs, nproc));
+      return *inputs.x;
+    }
+
+  private:
+    ParallelPreconditioner& pc_;
+  };
+
+  int iterationsUsed(const DenseColumnMatrix& convergence)
+  {
+    int n = 0;
+    while (n < convergence.nrows() && convergence[n] != 0.0)
+      ++n;
+    return n;
+  }
+}
+
+TEST(ParallelPreconditionerTests, ILU0LevelsFollowTheSparsityPattern)
+{
+  auto diagonal = boost::make_shared<SparseRowMatrix>(1000, 1000);
+  diagonal->setIdentity();
+  IncompleteLUPreconditioner identity(*diagonal);
+  EXPECT_EQ(1, identity.lowerSchedule().numLevels);
+  EXPECT_EQ(1, identity.lowerSchedule().numGroups());
+  EXPECT_FALSE(identity.lowerSchedule().groupSerial[0]);
+
+  IncompleteLUPreconditioner chain(*tridiagonal(1000));
+  EXPECT_EQ(1000, chain.lowerSchedule().numLevels);
+  EXPECT_EQ(1000, chain.upperSchedule().numLevels);
+  EXPECT_EQ(1, chain.lowerSchedule().numGroups());
+  EXPECT_TRUE(chain.lowerSchedule().groupSerial[0]);
+}
+
+TEST(ParallelPreconditionerTests, ILU0IsExactForTridiagonalMatrices)
+{
+  auto A = tridiagonal(2000);
+  auto b = smoothVector(2000);
+  IncompleteLUPreconditioner ilu(*A);
+
+  for (int nproc : { 1, 4 })
+  {
+    auto z = ApplyPreconditioner(ilu).run(A, b, nproc);
+    DenseColumnMatrix residual = *b - *A * z;
+    EXPECT_LT(residual.norm(), 1e-10 * b->norm()) << nproc;
+  }
+}
+
+TEST(ParallelPreconditionerTests, ILU0HandlesWavefrontsInParallel)
+{
+  auto A = heterogeneousStiffness(20);
+  auto b = smoothVector(A->nrows());
+  IncompleteLUPreconditioner ilu(*A);
+  EXPECT_LT(ilu.lowerSchedule().numLevels, 100);
+
+  auto serial = ApplyPreconditioner(ilu).run(A, b, 1);
+  auto threaded = ApplyPreconditioner(ilu).run(A, b, 4);
+  EXPECT_LT((serial - threaded).norm(), 1e-12 * serial.norm());
+}
+
+TEST(ParallelPreconditionerTests, AMGBuildsHierarchyAndIsSymmetric)
+{
+  auto A = heterogeneousStiffness(20);
+  SmoothedAggregationAMGPreconditioner amg(*A);
+  ASSERT_GE(amg.numLevels(), 2);
+  for (size_t l = 1; l < amg.numLevels(); ++l)
+    EXPECT_LT(amg.levelSize(l), amg.levelSize(l - 1) / 2);
+  EXPECT_LE(amg.levelSize(amg.numLevels() - 1), SmoothedAggregationAMGPreconditioner::MaxCoarseSize);
+
+  auto u = smoothVector(A->nrows());
+  auto v = boost::make_shared<DenseColumnMatrix>(A->nrows());
+  for (int i = 0; i < v->nrows(); ++i)
+    (*v)[i] = (i % 5) - 2.0;
+
+  auto Mu = ApplyPreconditioner(amg).run(A, u, 3);
+  auto Mv = ApplyPreconditioner(amg).run(A, v, 3);
+  EXPECT_NEAR(u->dot(Mv), v->dot(Mu), 1e-10 * std::abs(u->dot(Mv)));
+
+  // One cycle should already remove most of the error.
+  DenseColumnMatrix residual = *u - *A * Mu;
+  EXPECT_LT(residual.norm(), 0.5 * u->norm());
+}
+
+// Off-diagonals far below the strength threshold leave nothing to
+// aggregate, so the finest level is also the coarsest, and far too large
+// to factor densely.
+TEST(ParallelPreconditionerTests, AMGFallsBackToJacobiWhenAggregationStalls)
+{
+  const int n = 5000;
+  std::vector<T> entries;
+  for (int i = 0; i < n; ++i)
+  {
+    entries.emplace_back(i, i, 1.0 + 0.5 * (i % 3));
+    if (i > 0) entries.emplace_back(i, i - 1, -0.01);
+    if (i < n - 1) entries.emplace_back(i, i + 1, -0.01);
+  }
+  auto A = boost::make_shared<SparseRowMatrix>(n, n);
+  A->setFromTriplets(entries.begin(), entries.end());
+
+  SmoothedAggregationAMGPreconditioner amg(*A);
+  EXPECT_EQ(1, amg.numLevels());
+  EXPECT_FALSE(amg.directCoarseSolve());
+
+  auto u = smoothVector(n);
+  auto v = boost::make_shared<DenseColumnMatrix>(n);
+  for (int i = 0; i < n; ++i)
+    (*v)[i] = (i % 5) - 2.0;
+
+  auto Mu = ApplyPreconditioner(amg).run(A, u, 3);
+  auto Mv = ApplyPreconditioner(amg).run(A, v, 3);
+  EXPECT_NEAR(u->dot(Mv), v->dot(Mu), 1e-10 * std::abs(u->dot(Mv)));
+  EXPECT_EQ(Mu, ApplyPreconditioner(amg).run(A, u, 1));
+
+  DenseColumnMatrix residual = *u - *A * Mu;
+  EXPECT_LT(residual.norm(), 0.5 * u->norm());
+
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Method, "cg");
+  algo.setOption(Variables::Preconditioner, "AMG");
+  algo.set(Variables::TargetError, 1e-10);
+  algo.setUpdaterFunc([](double) {});
+  DenseColumnMatrixHandle x, convergence;
+  ASSERT_TRUE(algo.run(A, u, DenseColumnMatrixHandle(), x, convergence));
+  EXPECT_LT((*u - *A * *x).norm(), 1e-8 * u->norm());
+  EXPECT_LT(iterationsUsed(*convergence), 20);
+}
+
+TEST(ParallelPreconditionerTests, BiCGRejectsFactorizationPreconditioners)
+{
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Method, "bicg");
+  algo.setOption(Variables::Preconditioner, "ILU0");
+  DenseColumnMatrixHandle x;
+  EXPECT_THROW(algo.run(tridiagonal(10), smoothVector(10), DenseColumnMatrixHandle(), x), AlgorithmInputException);
+}
+
+// Iterations to tolerance of each preconditioner on a high contrast
+// conductivity problem: stronger preconditioners must need fewer.
+TEST(ParallelPreconditionerTests, PreconditionersReduceIterationsOnHighContrastProblem)
+{
+  auto A = heterogeneousStiffness(30);
+  auto b = smoothVector(A->nrows());
+
+  for (const std::string method : { "cg", "minres" })
+  {
+    std::map<std::string, int> iterations;
+    for (const std::string preconditioner : { "Jacobi", "ILU0", "AMG" })
+    {
+      SolveLinearSystemAlgo algo;
+      algo.setOption(Variables::Method, method);
+      algo.setOption(Variables::Preconditioner, preconditioner);
+      algo.set(Variables::MaxIterations, 3000);
+      algo.set(Variables::TargetError, 1e-8);
+      algo.setUpdaterFunc([](double) {});
+
+      DenseColumnMatrixHandle x, convergence;
+      ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x, convergence));
+
+      DenseColumnMatrix residual = *b - *A * *x;
+      EXPECT_LT(residual.norm(), 1e-6 * b->norm()) << method << "/" << preconditioner;
+      iterations[preconditioner] = iterationsUsed(*convergence);
+      EXPECT_LT(iterations[preconditioner], 3000) << method << "/" << preconditioner;
+    }
+    EXPECT_LT(iterations["ILU0"], iterations["Jacobi"]) << method;
+    EXPECT_LT(iterations["AMG"], iterations["ILU0"]) << method;
+    EXPECT_LE(2 * iterations["AMG"], iterations["Jacobi"]) << method;
+  }
+}
@@ -0,0 +1,200 @@
+  /*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun;
+
+namespace
+{
+  // 5-point Laplacian with a Robin boundary, symmetric positive definite
+  SparseRowMatrixHandle laplacian2D(int n)
+  {
+    std::vector<Eigen::Triplet<double>> entries;
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < n; ++i)
+      {
+        const int row = j*n + i;
+        entries.emplace_back(row, row, 4.1);
+        if (i > 0) entries.emplace_back(row, row - 1, -1.0);
+        if (i < n - 1) entries.emplace_back(row, row + 1, -1.0);
+        if (j > 0) entries.emplace_back(row, row - n, -1.0);
+        if (j < n - 1) entries.emplace_back(row, row + n, -1.0);
+      }
+    auto m = boost::make_shared<SparseRowMatrix>(n*n, n*n);
+    m->setFromTriplets(entries.begin(), entries.end());
+    return m;
+  }
+
+  // Columns of very different scale, plus a zero column
+  DenseMatrixHandle rightHandSides(int rows, int columns)
+  {
+    auto b = boost::make_shared<DenseMatrix>(rows, columns);
+    for (int j = 0; j < columns; ++j)
+      for (int i = 0; i < rows; ++i)
+        (*b)(i, j) = j == 1 ? 0.0 : std::pow(10.0, j - 2) * std::sin(0.05*(j + 1)*i + j);
+    return b;
+  }
+
+  void expectBlockMatchesColumnSolves(const std::string& method, const std::string& preconditioner)
+  {
+    auto A = laplacian2D(30);
+    auto b = rightHandSides(A->nrows(), 5);
+
+    SolveLinearSystemAlgo algo;
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.set(Variables::MaxIterations, 2000);
+    algo.set(Variables::TargetError, 1e-10);
+    algo.setUpdaterFunc([](double) {});
+
+    DenseMatrixHandle x;
+    ASSERT_TRUE(algo.run(A, b, DenseMatrixHandle(), x));
+    ASSERT_TRUE(x != nullptr);
+    ASSERT_EQ(b->nrows(), x->nrows());
+    ASSERT_EQ(b->ncols(), x->ncols());
+
+    for (size_t j = 0; j < b->ncols(); ++j)
+    {
+      auto bj = boost::make_shared<DenseColumnMatrix>(b->col(j));
+      DenseColumnMatrixHandle xj;
+      ASSERT_TRUE(algo.run(A, bj, DenseColumnMatrixHandle(), xj));
+
+      const double scale = std::max(bj->norm(), 1e-300);
+      EXPECT_LT((*A * x->col(j) - b->col(j)).norm() / scale, 1e-8) << "column " << j;
+      EXPECT_LT((x->col(j) - *xj).norm(), 1e-6 * std::max(xj->norm(), 1.0)) << "column " << j;
+    }
+    EXPECT_EQ(0.0, x->col(1).norm());
+  }
+
+  class PreconditionerRemarkCounter : public Core::Logging::LegacyLoggerInterface
+  {
+  public:
+    PreconditionerRemarkCounter() : count(0) {}
+    void error(const std::string&) const override {}
+    bool errorReported() const override { return false; }
+    void setErrorFlag(bool) override {}
+    void warning(const std::string&) const override {}
+    void remark(const std::string& msg) const override
+    {
+      if (msg.find("Preconditioner:") == 0)
+        ++count;
+    }
+    void status(const std::string&) const override {}
+
+    mutable int count;
+  };
+}
+
+TEST(SolveLinearSystemBlockTests, BlockCGMatchesColumnSolves)
+{
+  expectBlockMatchesColumnSolves("cg", "None");
+}
+
+TEST(SolveLinearSystemBlockTests, BlockCGMatchesColumnSolvesWithJacobi)
+{
+  expectBlockMatchesColumnSolves("cg", "Jacobi");
+}
+
+TEST(SolveLinearSystemBlockTests, BlockCGMatchesColumnSolvesWithILU0)
+{
+  expectBlockMatchesColumnSolves("cg", "ILU0");
+}
+
+TEST(SolveLinearSystemBlockTests, BlockCGMatchesColumnSolvesWithAMG)
+{
+  expectBlockMatchesColumnSolves("cg", "AMG");
+}
+
+TEST(SolveLinearSystemBlockTests, OtherMethodsSolveColumnByColumn)
+{
+  expectBlockMatchesColumnSolves("minres", "Jacobi");
+}
+
+TEST(SolveLinearSystemBlockTests, OtherMethodsSolveColumnByColumnWithILU0)
+{
+  expectBlockMatchesColumnSolves("minres", "ILU0");
+}
+
+TEST(SolveLinearSystemBlockTests, ColumnByColumnSolvesBuildThePreconditionerOnce)
+{
+  auto A = laplacian2D(20);
+  auto b = rightHandSides(A->nrows(), 4);
+
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Method, "minres");
+  algo.setOption(Variables::Preconditioner, "AMG");
+  algo.set(Variables::TargetError, 1e-10);
+  algo.setUpdaterFunc([](double) {});
+  auto counter = boost::make_shared<PreconditionerRemarkCounter>();
+  algo.setLogger(counter);
+
+  DenseMatrixHandle x;
+  ASSERT_TRUE(algo.run(A, b, DenseMatrixHandle(), x));
+  EXPECT_EQ(1, counter->count);
+}
+
+TEST(SolveLinearSystemBlockTests, UsesInitialGuess)
+{
+  auto A = laplacian2D(20);
+  auto b = rightHandSides(A->nrows(), 3);
+
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Method, "cg");
+  algo.set(Variables::TargetError, 1e-10);
+  algo.setUpdaterFunc([](double) {});
+
+  DenseMatrixHandle x;
+  ASSERT_TRUE(algo.run(A, b, DenseMatrixHandle(), x));
+
+  // Restarting from the solution must not move it
+  DenseMatrixHandle again;
+  ASSERT_TRUE(algo.run(A, b, x, again));
+  EXPECT_LT((*again - *x).norm(), 1e-12 * x->norm());
+}
+
+TEST(SolveLinearSystemBlockTests, RejectsMismatchedInitialGuess)
+{
+  auto A = laplacian2D(10);
+  auto b = rightHandSides(A->nrows(), 3);
+  auto x0 = boost::make_shared<DenseMatrix>(A->nrows(), 2);
+
+  SolveLinearSystemAlgo algo;
+  DenseMatrixHandle x;
+  EXPECT_THROW(algo.run(A, b, x0, x), AlgorithmInputException);
+}
@@ -35,9 +35,11 @@
 #include <Core/Algorithms/Factory/HardCodedAlgorithmFactory.h>
 #include <Dataflow/State/SimpleMapModuleState.h>
 #include <Dataflow/Network/ModuleReexecutionStrategies.h>
+#include <Dataflow/Network/ModuleOutputCache.h>
 #include <Dataflow/Engine/Scheduler/DesktopExecutionStrategyFactory.h>
 #include <Core/Command/GlobalCommandBuilderFromCommandLine.h>
 #include <Core/Logging/Log.h>
+#include <Core/Logging/Trace.h>
 #include <Core/Logging/ApplicationHelper.h>
 #include <Core/IEPlugin/IEPluginInit.h>
 #include <Core/Utils/Exception.h>
@@ -46,6 +48,7 @@
 #include <Core/Python/PythonInterpreter.h>
 #include <Core/Application/Preferences/Preferences.h>
 #include <Dataflow/Serialization/Network/XMLSerializer.h>
+#include <Dataflow/Serialization/Network/BinarySerializer.h>
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
 #include <boost/algorithm/string.hpp>
 #include <Core/Thread/Parallel.h>
@@ -101,6 +104,15 @@ void Application::shutdown()
     logInfo("Application shutdown called with null internals");
   try
   {
+    auto traceFile = private_ && private_->parameters_ ? private_->parameters_->developerParameters()->traceFile() : boost::none;
+    if (traceFile)
+    {
+      TraceRecorder::Instance().stop();
+      if (TraceRecorder::Instance().writeChromeTrace(*traceFile))
+        logInfo("Wrote execution trace to {}", *traceFile);
+      else
+        logError("Could not write execution trace to {}", *traceFile);
+    }
     private_.reset();
   }
   catch (std::exception& e)
@@ -160,6 +172,17 @@ void Application::readCommandLine(int argc, const char* argv[])
     auto maxCoresOption = private_->parameters_->developerParameters()->maxCores();
     if (maxCoresOption)
       Thread::Parallel::SetMaximumCores(*maxCoresOption);
+
+    auto outputCacheOption = private_->parameters_->developerParameters()->outputCacheDirectory();
+    if (outputCacheOption)
+    {
+      auto sizeMB = private_->parameters_->developerParameters()->outputCacheSizeMB().get_value_or(4096);
+      Dataflow::Networks::ModuleOutputCache::Instance().enable(*outputCacheOption, static_cast<boost::uint64_t>(sizeMB) << 20,
+        VersionInfo::GIT_VERSION_TAG + "-" + VersionInfo::GIT_COMMIT_SHA);
+    }
+
+    if (private_->parameters_->developerParameters()->traceFile())
+      TraceRecorder::Instance().start();
       
     LogSettings::Instance().setVerbose(parameters()->verboseMode());
   }
@@ -342,12 +365,16 @@ bool Application::get_user_name( std::string& user_name ) const
 std::string SaveFileCommandHelper::saveImpl(const std::string& filename)
 {
   auto fileNameWithExtension = filename;
-  if (!boost::algorithm::ends_with(fileNameWithExtension, ".srn5"))
+  const bool binary = BinarySerializer::is_binary_filename(fileNameWithExtension);
+  if (!binary && !boost::algorithm::ends_with(fileNameWithExtension, ".srn5"))
     fileNameWithExtension += ".srn5";
 
   auto file = Application::Instance().controller()->saveNetwork();
 
-  if (!XMLSerializer::save_xml(*file, fileNameWithExtension, "networkFile"))
+  const bool saved = binary
+    ? BinarySerializer::save_binary(*file, fileNameWithExtension)
+    : XMLSerializer::save_xml(*file, fileNameWithExtension, "networkFile");
+  if (!saved)
     return "";
 
   return fileNameWithExtension;
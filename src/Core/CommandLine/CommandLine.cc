@@ -68,6 +68,9 @@ public:
       //("frameInitLimit", po::value<int>(), "ViewScene frame init limit--increase if renderer fails")
       ("guiExpandFactor", po::value<double>(), "Expansion factor for high resolution displays")
       ("max-cores", po::value<unsigned int>(), "Limit the number of cores used by multithreaded algorithms")
+      ("output-cache", po::value<std::string>(), "Directory for caching expensive module outputs across sessions")
+      ("output-cache-size", po::value<unsigned int>(), "Output cache size limit in megabytes (default 4096)")
+      ("trace-file", po::value<std::string>(), "Record wall-clock trace of execution and write it as Chrome trace JSON on exit")
       ("list-modules", "print list of available modules")
       ;
 
@@ -117,9 +120,13 @@ public:
     const boost::optional<int>& frameInitLimit,
     const boost::optional<int>& regressionTimeout,
     const boost::optional<unsigned int>& maxCores,
-    const boost::optional<double>& guiExpandFactor
+    const boost::optional<double>& guiExpandFactor,
+    const boost::optional<std::string>& outputCacheDirectory,
+    const boost::optional<unsigned int>& outputCacheSizeMB,
+    const boost::optional<std::string>& traceFile
     ) : threadMode_(threadMode), reexecuteMode_(reexecuteMode), frameInitLimit_(frameInitLimit),
-    regressionTimeout_(regressionTimeout), maxCores_(maxCores), guiExpandFactor_(guiExpandFactor)
+    regressionTimeout_(regressionTimeout), maxCores_(maxCores), guiExpandFactor_(guiExpandFactor),
+    outputCacheDirectory_(outputCacheDirectory), outputCacheSizeMB_(outputCacheSizeMB), traceFile_(traceFile)
   {}
   boost::optional<int> regressionTimeoutSeconds() const override
   {
@@ -145,11 +152,26 @@ public:
   {
     return guiExpandFactor_;
   }
+  boost::optional<std::string> outputCacheDirectory() const override
+  {
+    return outputCacheDirectory_;
+  }
+  boost::optional<unsigned int> outputCacheSizeMB() const override
+  {
+    return outputCacheSizeMB_;
+  }
+  boost::optional<std::string> traceFile() const override
+  {
+    return traceFile_;
+  }
 private:
   boost::optional<std::string> threadMode_, reexecuteMode_;
   boost::optional<int> frameInitLimit_, regressionTimeout_;
   boost::optional<unsigned int> maxCores_;
   boost::optional<double> guiExpandFactor_;
+  boost::optional<std::string> outputCacheDirectory_;
+  boost::optional<unsigned int> outputCacheSizeMB_;
+  boost::optional<std::string> traceFile_;
 };
 
 class ApplicationParametersImpl : public ApplicationParameters
@@ -342,7 +364,10 @@ ApplicationParametersHandle CommandLineParser::parse(int argc, const char* argv[
         parseOptionalArg<int>(parsed, "frameInitLimit"),
         parseOptionalArg<int>(parsed, "regression"),
         parseOptionalArg<unsigned int>(parsed, "max-cores"),
-        parseOptionalArg<double>(parsed, "guiExpandFactor")
+        parseOptionalArg<double>(parsed, "guiExpandFactor"),
+        parseOptionalArg<std::string>(parsed, "output-cache"),
+        parseOptionalArg<unsigned int>(parsed, "output-cache-size"),
+        parseOptionalArg<std::string>(parsed, "trace-file")
       ),
       ApplicationParametersImpl::Flags(
         parsed.count("help") != 0,
@@ -57,6 +57,11 @@ TEST(ScirunCommandLineSpecTest, CanReadBasicOptions)
     "  --guiExpandFactor arg   Expansion factor for high resolution displays\n"
     "  --max-cores arg         Limit the number of cores used by multithreaded \n"
     "                          algorithms\n"
+    "  --output-cache arg      Directory for caching expensive module outputs across\n"
+    "                          sessions\n"
+    "  --output-cache-size arg Output cache size limit in megabytes (default 4096)\n"
+    "  --trace-file arg        Record wall-clock trace of execution and write it as \n"
+    "                          Chrome trace JSON on exit\n"
     "  --list-modules          print list of available modules\n";
 
   EXPECT_EQ(expectedHelp, parser.describe());
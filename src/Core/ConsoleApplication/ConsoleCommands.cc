@@ -31,6 +31,7 @@ DEALINGS IN THE SOFTWARE.
 #include <Dataflow/Engine/Controller/NetworkEditorController.h>
 #include <Core/Application/Application.h>
 #include <Dataflow/Serialization/Network/XMLSerializer.h>
+#include <Dataflow/Serialization/Network/BinarySerializer.h>
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
 #include <Dataflow/Network/Module.h>
 #include <Core/Logging/ConsoleLogger.h>
@@ -84,7 +85,7 @@ bool LoadFileCommandConsole::execute()
   }
   try
   {
-    auto openedFile = XMLSerializer::load_xml<NetworkFile>(filename);
+    auto openedFile = BinarySerializer::load_binary_or_xml<NetworkFile>(filename);
 
     if (openedFile)
     {
@@ -52,6 +52,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTableBuilder.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
@@ -60,6 +61,7 @@
 
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/ConditionVariable.h>
+#include <Core/Thread/Parallel.h>
 #include <boost/unordered_map.hpp>
 #include <boost/thread.hpp>
 
@@ -2757,9 +2759,7 @@ protected:
     }
   };
 
-  using face_ht = boost::unordered_map<PFace, typename Face::index_type, FaceHash>;
   using face_nt = boost::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = boost::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
   using edge_nt = boost::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
 
   typedef std::vector<PFaceCell> face_ct;
@@ -2775,15 +2775,6 @@ protected:
   edge_ct edges_;
   edge_nt edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 index_type combind_index, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
-
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
   {
@@ -3213,107 +3204,92 @@ HexVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
 template <class Basis>
 void
-HexVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             typename Node::index_type n4,
-                             index_type combined_index,
-                             face_ht &table) const
+HexVolMesh<Basis>::compute_faces()
 {
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
-
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
-
+  typedef MeshTableEntry<4> entry_type;
+  const size_t num_cells = cells_.size() >> 3;
 
-  typename face_ht::iterator iter = table.find(f);
-
-  if (iter == table.end())
+  // 6 faces -- each is entered CCW from outside looking in
+  std::vector<entry_type> entries(num_cells * 6);
+  Core::Thread::Parallel::ForRange(0, num_cells, [this, &entries](size_t begin, size_t end)
   {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
+    static const int face_nodes[6][4] = { {0, 1, 2, 3}, {7, 6, 5, 4}, {0, 4, 5, 1},
+                                          {2, 6, 7, 3}, {3, 7, 4, 0}, {1, 5, 6, 2} };
+    for (size_t c = begin; c < end; ++c)
     {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      const under_type* arr = &cells_[c * 8];
+      for (int f = 0; f < 6; f++)
+      {
+        index_type n1 = arr[face_nodes[f][0]];
+        index_type n2 = arr[face_nodes[f][1]];
+        index_type n3 = arr[face_nodes[f][2]];
+        index_type n4 = arr[face_nodes[f][3]];
+        entry_type& entry = entries[c * 6 + f];
+        entry.code = static_cast<index_type>((c << 3) + f);
+
+        // Degenerate faces are dropped by the sort. Otherwise the key is
+        // the orientation independent form PFaceNode compares with.
+        if (!(order_face_nodes(n1, n2, n3, n4)))
+        {
+          entry.nodes[0] = -1;
+          continue;
+        }
+        entry.nodes[0] = n1;
+        if (n3 == n4)
+        {
+          entry.nodes[1] = std::min(n2, n3);
+          entry.nodes[2] = entry.nodes[3] = std::max(n2, n3);
+        }
+        else
+        {
+          entry.nodes[1] = std::min(n2, n4);
+          entry.nodes[2] = n3;
+          entry.nodes[3] = std::max(n2, n4);
+        }
+      }
     }
-  }
-}
-
-template <class Basis>
-void
-HexVolMesh<Basis>::compute_faces()
-{
-  face_table_.clear();
+  });
 
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(8);
+  std::vector<index_type> runs;
+  MeshTableBuilder::sort_unique(entries, static_cast<index_type>(points_.size()), runs);
+  const size_t num_faces = runs.size() - 1;
 
-  face_ht table;
-
-  while (ci != cie)
+  // The first cell of a run owns the face, the first other cell in the run
+  // is its neighbor. Any further cells make the mesh illegal and are ignored.
+  faces_.clear();
+  faces_.resize(num_faces);
+  std::vector<unsigned char> boundary(num_faces, 0);
+  Core::Thread::Parallel::ForRange(0, num_faces, [&](size_t begin, size_t end)
   {
-    get_nodes(arr, *ci);
-    // 6 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], arr[3], cell_index, table);
-    hash_face(arr[7], arr[6], arr[5], arr[4], cell_index + 1, table);
-    hash_face(arr[0], arr[4], arr[5], arr[1], cell_index + 2, table);
-    hash_face(arr[2], arr[6], arr[7], arr[3], cell_index + 3, table);
-    hash_face(arr[3], arr[7], arr[4], arr[0], cell_index + 4, table);
-    hash_face(arr[1], arr[5], arr[6], arr[2], cell_index + 5, table);
-
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-  boundary_faces_.resize(cells_.size()>>3);
-
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
+    for (size_t u = begin; u < end; ++u)
+    {
+      const index_type first = entries[runs[u]].code;
+      faces_[u].cells_[0] = first;
+      for (index_type i = runs[u] + 1; i < runs[u + 1]; ++i)
+      {
+        if ((entries[i].code >> 3) != (first >> 3))
+        {
+          faces_[u].cells_[1] = entries[i].code;
+          break;
+        }
+      }
+      boundary[u] = (faces_[u].cells_[1] == MESH_NO_NEIGHBOR);
+    }
+  });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  boundary_faces_.assign(num_cells, 0);
+  face_table_.clear();
+  face_table_.reserve(num_faces);
+  for (size_t u = 0; u < num_faces; ++u)
   {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2],pface.nodes_[3])] = uidx;
-
-    if (pface.cells_[1] == -1)
+    const entry_type& entry = entries[runs[u]];
+    face_table_[PFaceNode(entry.nodes[0], entry.nodes[1], entry.nodes[2], entry.nodes[3])] = u;
+    if (boundary[u])
     {
-      index_type cell = (pface.cells_[0]) >> 3;
-      index_type face = (pface.cells_[0]) & 0x7;
+      index_type cell = (faces_[u].cells_[0]) >> 3;
+      index_type face = (faces_[u].cells_[0]) & 0x7;
       boundary_faces_[cell] |= 1 << face;
     }
-
-    ++ht_iter; uidx++;
   }
 
   synchronize_lock_.lock();
@@ -3321,73 +3297,58 @@ HexVolMesh<Basis>::compute_faces()
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-HexVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 HexVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<4;
-    hash_edge(arr[0], arr[1], cell_index  , table);
-    hash_edge(arr[1], arr[2], cell_index+1, table);
-    hash_edge(arr[2], arr[3], cell_index+2, table);
-    hash_edge(arr[3], arr[0], cell_index+3, table);
-
-    hash_edge(arr[4], arr[5], cell_index+4, table);
-    hash_edge(arr[5], arr[6], cell_index+5, table);
-    hash_edge(arr[6], arr[7], cell_index+6, table);
-    hash_edge(arr[7], arr[4], cell_index+7, table);
+  typedef MeshTableEntry<2> entry_type;
+  const size_t num_cells = cells_.size() >> 3;
 
-    hash_edge(arr[0], arr[4], cell_index+8, table);
-    hash_edge(arr[5], arr[1], cell_index+9, table);
-    hash_edge(arr[2], arr[6], cell_index+10,table);
-    hash_edge(arr[7], arr[3], cell_index+11,table);
-    ++ci;
-  }
-
-  // dump edges into the edges_ container.
+  std::vector<entry_type> entries(num_cells * 12);
+  Core::Thread::Parallel::ForRange(0, num_cells, [this, &entries](size_t begin, size_t end)
+  {
+    static const int edge_nodes[12][2] = { {0, 1}, {1, 2}, {2, 3}, {3, 0},
+                                           {4, 5}, {5, 6}, {6, 7}, {7, 4},
+                                           {0, 4}, {5, 1}, {2, 6}, {7, 3} };
+    for (size_t c = begin; c < end; ++c)
+    {
+      const under_type* arr = &cells_[c * 8];
+      for (int e = 0; e < 12; e++)
+      {
+        const index_type n1 = arr[edge_nodes[e][0]];
+        const index_type n2 = arr[edge_nodes[e][1]];
+        entry_type& entry = entries[c * 12 + e];
+        // Degenerate edges are dropped by the sort
+        entry.nodes[0] = (n1 == n2) ? -1 : std::min(n1, n2);
+        entry.nodes[1] = std::max(n1, n2);
+        entry.code = static_cast<index_type>((c << 4) + e);
+      }
+    }
+  });
 
-  edges_.resize(table.size());
+  std::vector<index_type> runs;
+  MeshTableBuilder::sort_unique(entries, static_cast<index_type>(points_.size()), runs);
+  const size_t num_edges = runs.size() - 1;
 
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
+  edges_.clear();
+  edges_.resize(num_edges);
+  Core::Thread::Parallel::ForRange(0, num_edges, [&](size_t begin, size_t end)
+  {
+    for (size_t u = begin; u < end; ++u)
+    {
+      std::vector<index_type>& cells = edges_[u].cells_;
+      cells.resize(runs[u + 1] - runs[u]);
+      for (index_type i = runs[u]; i < runs[u + 1]; ++i)
+        cells[i - runs[u]] = entries[i].code;
+    }
+  });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  edge_table_.clear();
+  edge_table_.reserve(num_edges);
+  for (size_t u = 0; u < num_edges; ++u)
   {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
+    const entry_type& entry = entries[runs[u]];
+    edge_table_[PEdgeNode(entry.nodes[0], entry.nodes[1])] = u;
   }
 
   synchronize_lock_.lock();
@@ -3395,6 +3356,7 @@ HexVolMesh<Basis>::compute_edges()
   synchronize_lock_.unlock();
 }
 
+
 template <class Basis>
 bool
 HexVolMesh<Basis>::synchronize(mask_type sync)
@@ -3678,13 +3640,8 @@ template <class Basis>
 void
 HexVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  MeshTableBuilder::node_neighbors(cells_, 1, static_cast<index_type>(points_.size()),
+                                   node_neighbors_);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -82,7 +82,13 @@ public:
     BOUNDING_BOX_E = 1 << 12,
     FIND_CLOSEST_NODE_E		= 1 << 13,
     FIND_CLOSEST_ELEM_E		= 1 << 14,
-    FIND_CLOSEST_E = FIND_CLOSEST_NODE_E | FIND_CLOSEST_ELEM_E
+    FIND_CLOSEST_E = FIND_CLOSEST_NODE_E | FIND_CLOSEST_ELEM_E,
+    /// Build a k-d tree (nodes) or bounding volume hierarchy (elements)
+    /// instead of a search grid for the closest point searches. Meshes
+    /// without tree support ignore these and fall back to the grid.
+    NODE_LOCATE_TREE_E = 1 << 15,
+    ELEM_LOCATE_TREE_E = 1 << 16,
+    LOCATE_TREE_E = NODE_LOCATE_TREE_E | ELEM_LOCATE_TREE_E
   };
 
   virtual bool synchronize(mask_type) { return false; }
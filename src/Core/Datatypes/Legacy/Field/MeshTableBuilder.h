@@ -0,0 +1,239 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_DATATYPES_MESHTABLEBUILDER_H
+#define CORE_DATATYPES_MESHTABLEBUILDER_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace SCIRun {
+
+/// Sort key used to build the edge, face and node tables of the
+/// unstructured meshes. nodes holds the canonical (sorted) node indices of
+/// the entity, code the combined cell/local index it was generated from.
+template <size_t K>
+struct MeshTableEntry
+{
+  index_type nodes[K];
+  index_type code;
+
+  bool same_key(const MeshTableEntry& e) const
+  {
+    for (size_t k = 0; k < K; ++k)
+      if (nodes[k] != e.nodes[k]) return false;
+    return true;
+  }
+
+  bool operator<(const MeshTableEntry& e) const
+  {
+    for (size_t k = 0; k < K; ++k)
+      if (nodes[k] != e.nodes[k]) return nodes[k] < e.nodes[k];
+    return code < e.code;
+  }
+};
+
+/// Replaces the single threaded hash map insertion previously used by
+/// compute_edges/compute_faces: every element emits one entry per edge/face
+/// into a flat array, which is bucketed by its first node, sorted per bucket
+/// and split into runs of equal keys, all in parallel.
+class MeshTableBuilder
+{
+  public:
+    /// Sorts entries by key and code and returns in runs the offset of every
+    /// run of equal keys, followed by the total number of entries. Entries
+    /// whose first node is negative are removed. num_nodes bounds the node
+    /// indices and is used to pick the buckets.
+    template <size_t K>
+    static void sort_unique(std::vector<MeshTableEntry<K> >& entries,
+                            index_type num_nodes,
+                            std::vector<index_type>& runs);
+
+    /// Fills neighbors[n] with corner/divisor for every position corner at
+    /// which corners holds node n, in ascending order.
+    template <class CORNERS, class T>
+    static void node_neighbors(const CORNERS& corners, index_type divisor,
+                               index_type num_nodes,
+                               std::vector<std::vector<T> >& neighbors);
+};
+
+
+template <size_t K>
+void
+MeshTableBuilder::sort_unique(std::vector<MeshTableEntry<K> >& entries,
+                              index_type num_nodes,
+                              std::vector<index_type>& runs)
+{
+  using Core::Thread::Parallel;
+  typedef MeshTableEntry<K> entry_type;
+
+  const size_t size = entries.size();
+  const size_t cores = std::max(1u, Parallel::NumCores());
+
+  // Small tables are not worth the bucket pass.
+  const size_t num_chunks = (size < 8192) ? 1 : cores;
+  const size_t num_buckets = (size < 8192 || num_nodes < 2) ? 1 :
+    std::min<size_t>(cores * 64, static_cast<size_t>(num_nodes));
+  const size_t chunk_size = (size + num_chunks - 1) / num_chunks;
+
+  auto bucket_of = [num_nodes, num_buckets](index_type node) -> size_t
+  {
+    if (num_buckets == 1) return 0;
+    size_t b = static_cast<size_t>(node) * num_buckets / static_cast<size_t>(num_nodes);
+    return std::min(b, num_buckets - 1);
+  };
+
+  // Histogram of bucket sizes per chunk, stored bucket major so the prefix
+  // sum directly gives every chunk its scatter offset within each bucket.
+  std::vector<size_t> offsets(num_buckets * num_chunks + 1, 0);
+  Parallel::ForRange(0, num_chunks, [&](size_t cbegin, size_t cend)
+  {
+    for (size_t c = cbegin; c < cend; ++c)
+    {
+      const size_t end = std::min(size, (c + 1) * chunk_size);
+      for (size_t i = c * chunk_size; i < end; ++i)
+      {
+        if (entries[i].nodes[0] >= 0)
+          offsets[bucket_of(entries[i].nodes[0]) * num_chunks + c]++;
+      }
+    }
+  }, 1);
+
+  size_t total = 0;
+  for (size_t j = 0; j < num_buckets * num_chunks; ++j)
+  {
+    const size_t count = offsets[j];
+    offsets[j] = total;
+    total += count;
+  }
+  offsets.back() = total;
+
+  std::vector<entry_type> sorted(total);
+  Parallel::ForRange(0, num_chunks, [&](size_t cbegin, size_t cend)
+  {
+    std::vector<size_t> next(num_buckets);
+    for (size_t c = cbegin; c < cend; ++c)
+    {
+      for (size_t b = 0; b < num_buckets; ++b)
+        next[b] = offsets[b * num_chunks + c];
+      const size_t end = std::min(size, (c + 1) * chunk_size);
+      for (size_t i = c * chunk_size; i < end; ++i)
+      {
+        if (entries[i].nodes[0] >= 0)
+          sorted[next[bucket_of(entries[i].nodes[0])]++] = entries[i];
+      }
+    }
+  }, 1);
+
+  // Sort every bucket and count its runs. As the buckets split on the first
+  // node, no run of equal keys crosses a bucket boundary.
+  std::vector<index_type> bucket_runs(num_buckets + 1, 0);
+  Parallel::ForRange(0, num_buckets, [&](size_t bbegin, size_t bend)
+  {
+    for (size_t b = bbegin; b < bend; ++b)
+    {
+      const size_t first = offsets[b * num_chunks];
+      const size_t last = offsets[(b + 1) * num_chunks];
+      std::sort(sorted.begin() + first, sorted.begin() + last);
+      index_type count = 0;
+      for (size_t i = first; i < last; ++i)
+        if (i == first || !sorted[i].same_key(sorted[i - 1])) count++;
+      bucket_runs[b] = count;
+    }
+  }, 1);
+
+  index_type num_runs = 0;
+  for (size_t b = 0; b < num_buckets; ++b)
+  {
+    const index_type count = bucket_runs[b];
+    bucket_runs[b] = num_runs;
+    num_runs += count;
+  }
+
+  runs.resize(num_runs + 1);
+  Parallel::ForRange(0, num_buckets, [&](size_t bbegin, size_t bend)
+  {
+    for (size_t b = bbegin; b < bend; ++b)
+    {
+      const size_t first = offsets[b * num_chunks];
+      const size_t last = offsets[(b + 1) * num_chunks];
+      index_type r = bucket_runs[b];
+      for (size_t i = first; i < last; ++i)
+        if (i == first || !sorted[i].same_key(sorted[i - 1]))
+          runs[r++] = static_cast<index_type>(i);
+    }
+  }, 1);
+  runs[num_runs] = static_cast<index_type>(total);
+
+  entries.swap(sorted);
+}
+
+
+template <class CORNERS, class T>
+void
+MeshTableBuilder::node_neighbors(const CORNERS& corners, index_type divisor,
+                                 index_type num_nodes,
+                                 std::vector<std::vector<T> >& neighbors)
+{
+  using Core::Thread::Parallel;
+  typedef MeshTableEntry<1> entry_type;
+
+  const size_t size = corners.size();
+  std::vector<entry_type> entries(size);
+  Parallel::ForRange(0, size, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      entries[i].nodes[0] = static_cast<index_type>(corners[i]);
+      entries[i].code = static_cast<index_type>(i);
+    }
+  });
+
+  std::vector<index_type> runs;
+  sort_unique(entries, num_nodes, runs);
+
+  neighbors.clear();
+  neighbors.resize(num_nodes);
+  Parallel::ForRange(0, runs.size() - 1, [&](size_t begin, size_t end)
+  {
+    for (size_t r = begin; r < end; ++r)
+    {
+      std::vector<T>& n = neighbors[entries[runs[r]].nodes[0]];
+      n.resize(runs[r + 1] - runs[r]);
+      for (index_type i = runs[r]; i < runs[r + 1]; ++i)
+        n[i - runs[r]] = static_cast<T>(entries[i].code / divisor);
+    }
+  });
+}
+
+} // end namespace SCIRun
+
+#endif
@@ -52,6 +52,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTableBuilder.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 
 #include <Core/Utils/Legacy/CheckSum.h>
@@ -60,6 +61,7 @@
 #include <boost/unordered_map.hpp>
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/ConditionVariable.h>
+#include <Core/Thread/Parallel.h>
 
 #include <set>
 
@@ -2498,15 +2500,6 @@ protected:
   std::vector<PEdge>            edges_;
   edge_ht                  edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Cell::index_type ci, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
-
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
   {
@@ -2888,99 +2881,101 @@ PrismVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
 template <class Basis>
 void
-PrismVolMesh<Basis>::hash_face(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Node::index_type n3,
-			       typename Node::index_type n4,
-			       index_type combined_index,
-			       face_ht &table) const
+PrismVolMesh<Basis>::compute_faces()
 {
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
-
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
+  typedef MeshTableEntry<4> entry_type;
+  const size_t num_cells = cells_.size() / 6;
 
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
+  // 5 faces -- each is entered CCW from outside looking in
+  static const int face_nodes[5][4] = { {0, 1, 2, -1}, {5, 4, 3, -1}, {1, 4, 5, 2},
+                                        {2, 5, 3, 0}, {0, 3, 4, 1} };
+  auto ordered_face = [this](size_t c, int f, PFace& face) -> bool
   {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index >> 3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
+    const under_type* arr = &cells_[c * 6];
+    typename Node::index_type n[4];
+    for (int k = 0; k < 4; k++)
     {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << " and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
+      if (face_nodes[f][k] < 0) n[k] = PRISM_DUMMY_NODE_INDEX;
+      else n[k] = arr[face_nodes[f][k]];
     }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
-    }
-  }
-}
-
-template <class Basis>
-void
-PrismVolMesh<Basis>::compute_faces()
-{
-  face_table_.clear();
+    if (!(order_face_nodes(n[0], n[1], n[2], n[3]))) return (false);
+    face = PFace(n[0], n[1], n[2], n[3]);
+    return (true);
+  };
 
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(6);
-  while (ci != cie)
+  std::vector<entry_type> entries(num_cells * 5);
+  Core::Thread::Parallel::ForRange(0, num_cells, [&](size_t begin, size_t end)
   {
-    get_nodes(arr, *ci);
-    // 5 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], PRISM_DUMMY_NODE_INDEX, cell_index, face_table_);
-    hash_face(arr[5], arr[4], arr[3], PRISM_DUMMY_NODE_INDEX, cell_index + 1, face_table_);
-    hash_face(arr[1], arr[4], arr[5], arr[2], cell_index + 2, face_table_);
-    hash_face(arr[2], arr[5], arr[3], arr[0], cell_index + 3, face_table_);
-    hash_face(arr[0], arr[3], arr[4], arr[1], cell_index + 4, face_table_);
-
-    ++ci;
-  }
+    PFace face;
+    for (size_t c = begin; c < end; ++c)
+    {
+      for (int f = 0; f < 5; f++)
+      {
+        entry_type& entry = entries[c * 5 + f];
+        entry.code = static_cast<index_type>((c << 3) + f);
 
-  // dump edges into the edges_ container.
-  faces_.resize(face_table_.size());
-  typename std::vector<PFace>::iterator f_iter = faces_.begin();
-  typename face_ht::iterator ht_iter = face_table_.begin();
+        // Degenerate faces are dropped by the sort. Otherwise the key is
+        // the orientation independent form PFace compares with.
+        if (!ordered_face(c, f, face))
+        {
+          entry.nodes[0] = -1;
+          continue;
+        }
+        entry.nodes[0] = face.nodes_[0];
+        if (face.nodes_[2] == face.nodes_[3])
+        {
+          entry.nodes[1] = std::min(face.nodes_[1], face.nodes_[2]);
+          entry.nodes[2] = entry.nodes[3] = std::max(face.nodes_[1], face.nodes_[2]);
+        }
+        else
+        {
+          entry.nodes[1] = std::min(face.nodes_[1], face.nodes_[3]);
+          entry.nodes[2] = face.nodes_[2];
+          entry.nodes[3] = std::max(face.nodes_[1], face.nodes_[3]);
+        }
+      }
+    }
+  });
 
-  boundary_faces_.resize(cells_.size() /6);
+  std::vector<index_type> runs;
+  MeshTableBuilder::sort_unique(entries, static_cast<index_type>(points_.size()), runs);
+  const size_t num_faces = runs.size() - 1;
 
-  index_type i = 0;
-  while (ht_iter != face_table_.end())
+  // The face keeps the node order of the first cell of its run, the first
+  // other cell in the run is its neighbor. Any further cells make the mesh
+  // illegal and are ignored.
+  faces_.clear();
+  faces_.resize(num_faces);
+  Core::Thread::Parallel::ForRange(0, num_faces, [&](size_t begin, size_t end)
   {
-    *f_iter = (*ht_iter).first;
-    (*ht_iter).second = i;
+    for (size_t u = begin; u < end; ++u)
+    {
+      const index_type first = entries[runs[u]].code;
+      ordered_face(first >> 3, first & 0x7, faces_[u]);
+      faces_[u].cells_[0] = first;
+      for (index_type i = runs[u] + 1; i < runs[u + 1]; ++i)
+      {
+        if ((entries[i].code >> 3) != (first >> 3))
+        {
+          faces_[u].cells_[1] = entries[i].code;
+          break;
+        }
+      }
+    }
+  });
 
-    if ((*f_iter).cells_[1] == -1)
+  boundary_faces_.assign(num_cells, 0);
+  face_table_.clear();
+  face_table_.reserve(num_faces);
+  for (size_t u = 0; u < num_faces; ++u)
+  {
+    face_table_[faces_[u]] = u;
+    if (faces_[u].cells_[1] == -1)
     {
-      index_type cell = ((*f_iter).cells_[0]) >> 3;
-      index_type face = ((*f_iter).cells_[0]) & 0x7;
+      index_type cell = (faces_[u].cells_[0]) >> 3;
+      index_type face = (faces_[u].cells_[0]) & 0x7;
       boundary_faces_[cell] |= 1 << face;
     }
-    ++f_iter; ++ht_iter; i++;
   }
 
   synchronize_lock_.lock();
@@ -2988,66 +2983,58 @@ PrismVolMesh<Basis>::compute_faces()
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Cell::index_type ci,
-			       edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(ci); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(ci); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 PrismVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    hash_edge(arr[0], arr[1], *ci, edge_table_);
-    hash_edge(arr[1], arr[2], *ci, edge_table_);
-    hash_edge(arr[2], arr[0], *ci, edge_table_);
-
-    hash_edge(arr[3], arr[4], *ci, edge_table_);
-    hash_edge(arr[4], arr[5], *ci, edge_table_);
-    hash_edge(arr[5], arr[3], *ci, edge_table_);
+  typedef MeshTableEntry<2> entry_type;
+  const size_t num_cells = cells_.size() / 6;
 
-    hash_edge(arr[0], arr[3], *ci, edge_table_);
-    hash_edge(arr[4], arr[1], *ci, edge_table_);
-    hash_edge(arr[2], arr[5], *ci, edge_table_);
-    ++ci;
-  }
+  std::vector<entry_type> entries(num_cells * 9);
+  Core::Thread::Parallel::ForRange(0, num_cells, [this, &entries](size_t begin, size_t end)
+  {
+    static const int edge_nodes[9][2] = { {0, 1}, {1, 2}, {2, 0},
+                                          {3, 4}, {4, 5}, {5, 3},
+                                          {0, 3}, {4, 1}, {2, 5} };
+    for (size_t c = begin; c < end; ++c)
+    {
+      const under_type* arr = &cells_[c * 6];
+      for (int e = 0; e < 9; e++)
+      {
+        const index_type n1 = arr[edge_nodes[e][0]];
+        const index_type n2 = arr[edge_nodes[e][1]];
+        entry_type& entry = entries[c * 9 + e];
+        // Degenerate edges are dropped by the sort
+        entry.nodes[0] = (n1 == n2) ? -1 : std::min(n1, n2);
+        entry.nodes[1] = std::max(n1, n2);
+        entry.code = static_cast<index_type>((c << 4) + e);
+      }
+    }
+  });
 
-  // dump edges into the edges_ container.
+  std::vector<index_type> runs;
+  MeshTableBuilder::sort_unique(entries, static_cast<index_type>(points_.size()), runs);
+  const size_t num_edges = runs.size() - 1;
 
-  edges_.resize(edge_table_.size());
+  edges_.clear();
+  edges_.resize(num_edges);
+  Core::Thread::Parallel::ForRange(0, num_edges, [&](size_t begin, size_t end)
+  {
+    for (size_t u = begin; u < end; ++u)
+    {
+      PEdge& edge = edges_[u];
+      edge.nodes_[0] = entries[runs[u]].nodes[0];
+      edge.nodes_[1] = entries[runs[u]].nodes[1];
+      edge.cells_.resize(runs[u + 1] - runs[u]);
+      for (index_type i = runs[u]; i < runs[u + 1]; ++i)
+        edge.cells_[i - runs[u]] = entries[i].code >> 4;
+    }
+  });
 
-  typename std::vector<PEdge>::iterator e_iter = edges_.begin();
-  typename edge_ht::iterator ht_iter = edge_table_.begin();
-  while (ht_iter != edge_table_.end()) {
-    *e_iter = (*ht_iter).first;
-    (*ht_iter).second = static_cast<typename Edge::index_type>(
-                                                      e_iter - edges_.begin());
-    ++e_iter; ++ht_iter;
-  }
+  edge_table_.clear();
+  edge_table_.reserve(num_edges);
+  for (size_t u = 0; u < num_edges; ++u)
+    edge_table_[edges_[u]] = static_cast<typename Edge::index_type>(u);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
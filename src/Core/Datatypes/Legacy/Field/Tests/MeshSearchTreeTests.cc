@@ -0,0 +1,175 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  // Triangulated height field z = 0.3 sin(x) cos(y) on an n x n grid with
+  // refined triangles in one corner, so the elements vary in size.
+  FieldHandle bumpySurface(int n)
+  {
+    FieldInformation fi(TRISURFMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+
+    for (int j = 0; j <= n; ++j)
+      for (int i = 0; i <= n; ++i)
+      {
+        const double x = (i < n / 4) ? 0.25 * i : i - 0.75 * (n / 4);
+        const double y = j;
+        mesh->add_point(Point(x, y, 0.3 * std::sin(x) * std::cos(y)));
+      }
+
+    VMesh::Node::array_type nodes(3);
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < n; ++i)
+      {
+        const index_type a = j * (n + 1) + i;
+        nodes[0] = a; nodes[1] = a + 1; nodes[2] = a + n + 2;
+        mesh->add_elem(nodes);
+        nodes[0] = a; nodes[1] = a + n + 2; nodes[2] = a + n + 1;
+        mesh->add_elem(nodes);
+      }
+    return field;
+  }
+
+  std::vector<Point> queryPoints(int count, double extent)
+  {
+    std::vector<Point> points;
+    unsigned int seed = 12345;
+    auto next = [&seed]() { seed = seed * 1103515245u + 12345u; return ((seed >> 8) & 0xffff) / 65535.0; };
+    for (int k = 0; k < count; ++k)
+      points.push_back(Point(extent * (1.2 * next() - 0.1), extent * (1.2 * next() - 0.1), 2.0 * next() - 1.0));
+    return points;
+  }
+}
+
+TEST(MeshSearchTreeTest, TriSurfClosestElemTreeMatchesSearchGrid)
+{
+  const int n = 24;
+  FieldHandle gridField = bumpySurface(n);
+  FieldHandle treeField = bumpySurface(n);
+  VMesh* gridMesh = gridField->vmesh();
+  VMesh* treeMesh = treeField->vmesh();
+  gridMesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+  treeMesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E | Mesh::ELEM_LOCATE_TREE_E);
+
+  const std::vector<Point> points = queryPoints(500, n);
+  std::vector<double> dist;
+  std::vector<Point> result;
+  std::vector<VMesh::coords_type> coords;
+  std::vector<VMesh::Elem::index_type> elems;
+  treeMesh->mfind_closest_elem(dist, result, coords, elems, points);
+  ASSERT_EQ(points.size(), elems.size());
+
+  for (size_t k = 0; k < points.size(); ++k)
+  {
+    double gdist;
+    Point gresult;
+    VMesh::coords_type gcoords;
+    VMesh::Elem::index_type gelem;
+    ASSERT_TRUE(gridMesh->find_closest_elem(gdist, gresult, gcoords, gelem, points[k]));
+    ASSERT_GE(elems[k], 0);
+    EXPECT_NEAR(gdist, dist[k], 1e-10);
+    EXPECT_NEAR(0.0, (gresult - result[k]).length(), 1e-6);
+  }
+}
+
+TEST(MeshSearchTreeTest, TriSurfClosestElemsAndMaxDistWithTree)
+{
+  const int n = 8;
+  FieldHandle field = bumpySurface(n);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E | Mesh::ELEM_LOCATE_TREE_E);
+
+  // Above a grid node away from the refined corner all six triangles
+  // sharing the node are equally close.
+  const Point node(n - 2 - 0.75 * (n / 4), 3, 0.3 * std::sin(n - 2 - 0.75 * (n / 4)) * std::cos(3.0));
+  double dist;
+  Point result;
+  VMesh::Elem::array_type elems;
+  ASSERT_TRUE(mesh->find_closest_elems(dist, result, elems, node + Vector(0, 0, 1e-12)));
+  EXPECT_EQ(6u, elems.size());
+
+  VMesh::Elem::index_type elem;
+  VMesh::coords_type coords;
+  EXPECT_FALSE(mesh->find_closest_elem(dist, result, coords, elem, Point(n / 2, n / 2, 5.0), 1.0));
+  EXPECT_TRUE(mesh->find_closest_elem(dist, result, coords, elem, Point(n / 2, n / 2, 5.0), 6.0));
+}
+
+TEST(MeshSearchTreeTest, ClosestNodeTreeMatchesSearchGrid)
+{
+  const int n = 24;
+  FieldHandle gridField = bumpySurface(n);
+  FieldHandle treeField = bumpySurface(n);
+  VMesh* gridMesh = gridField->vmesh();
+  VMesh* treeMesh = treeField->vmesh();
+  gridMesh->synchronize(Mesh::FIND_CLOSEST_NODE_E);
+  treeMesh->synchronize(Mesh::FIND_CLOSEST_NODE_E | Mesh::NODE_LOCATE_TREE_E);
+
+  const std::vector<Point> points = queryPoints(500, n);
+  std::vector<double> dist;
+  std::vector<Point> result;
+  std::vector<VMesh::Node::index_type> nodes;
+  treeMesh->mfind_closest_node(dist, result, nodes, points, 1.5);
+
+  for (size_t k = 0; k < points.size(); ++k)
+  {
+    double gdist;
+    Point gresult;
+    VMesh::Node::index_type gnode;
+    if (gridMesh->find_closest_node(gdist, gresult, gnode, points[k], 1.5))
+    {
+      ASSERT_GE(nodes[k], 0);
+      EXPECT_NEAR(gdist, dist[k], 1e-12);
+    }
+    else
+    {
+      EXPECT_EQ(-1, nodes[k]);
+    }
+
+    std::vector<VMesh::Node::index_type> gnear, tnear;
+    gridMesh->find_closest_nodes(gnear, points[k], 1.5);
+    treeMesh->find_closest_nodes(tnear, points[k], 1.5);
+    std::sort(gnear.begin(), gnear.end());
+    std::sort(tnear.begin(), tnear.end());
+    EXPECT_EQ(gnear, tnear);
+  }
+}
@@ -32,8 +32,14 @@
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
 
 #include <gtest/gtest.h>
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -69,4 +75,196 @@ TEST(TetVolMeshTest, CheckMeshIteratorTetVolMesh)
   
 }
 
+namespace
+{
+  // n x n x n cubes, each split into the 6 tets of the Freudenthal
+  // triangulation, so neighboring cubes share their diagonals.
+  FieldHandle tetGrid(int n)
+  {
+    FieldInformation fi(TETVOLMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    VMesh* mesh = field->vmesh();
+
+    for (int k = 0; k <= n; ++k)
+      for (int j = 0; j <= n; ++j)
+        for (int i = 0; i <= n; ++i)
+          mesh->add_point(Point(i, j, k));
+
+    auto node = [n](int i, int j, int k) { return static_cast<index_type>((k * (n + 1) + j) * (n + 1) + i); };
+    const int axes[6][3] = { {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0} };
+    VMesh::Node::array_type nodes(4);
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+          for (int t = 0; t < 6; ++t)
+          {
+            int v[3] = { i, j, k };
+            nodes[0] = node(v[0], v[1], v[2]);
+            for (int a = 0; a < 3; ++a)
+            {
+              v[axes[t][a]]++;
+              nodes[a + 1] = node(v[0], v[1], v[2]);
+            }
+            mesh->add_elem(nodes);
+          }
+    return field;
+  }
+
+  const int gridSize = 4;
+  const size_type gridNodes = (gridSize + 1) * (gridSize + 1) * (gridSize + 1);
+  const size_type gridTets = 6 * gridSize * gridSize * gridSize;
+  const size_type gridEdges = 3 * gridSize * (gridSize + 1) * (gridSize + 1) +
+    3 * gridSize * gridSize * (gridSize + 1) + gridSize * gridSize * gridSize;
+  // Euler characteristic of a ball: V - E + F - T = 1
+  const size_type gridFaces = 1 - gridNodes + gridEdges + gridTets;
+}
+
+TEST(TetVolMeshTest, EdgeAndFaceTablesMatchGridTopology)
+{
+  FieldHandle field = tetGrid(gridSize);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::EDGES_E | Mesh::FACES_E);
+
+  EXPECT_EQ(gridEdges, mesh->num_edges());
+  EXPECT_EQ(gridFaces, mesh->num_faces());
+
+  size_type boundary = 0;
+  VMesh::Elem::array_type elems;
+  for (VMesh::Face::index_type f = 0; f < mesh->num_faces(); ++f)
+  {
+    mesh->get_elems(elems, f);
+    ASSERT_GE(elems.size(), 1u);
+    ASSERT_LE(elems.size(), 2u);
+    if (elems.size() == 1) boundary++;
+  }
+  EXPECT_EQ(12 * gridSize * gridSize, boundary);
+}
+
+TEST(TetVolMeshTest, CellFacesAndEdgesAreFoundThroughTheTables)
+{
+  FieldHandle field = tetGrid(gridSize);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::EDGES_E | Mesh::FACES_E);
+
+  VMesh::Face::array_type faces;
+  VMesh::Edge::array_type edges;
+  VMesh::Node::array_type cellNodes, nodes;
+  VMesh::Elem::array_type elems;
+  auto inCell = [&cellNodes](VMesh::Node::index_type n)
+  {
+    return std::find(cellNodes.begin(), cellNodes.end(), n) != cellNodes.end();
+  };
+
+  for (VMesh::Elem::index_type c = 0; c < mesh->num_elems(); ++c)
+  {
+    mesh->get_nodes(cellNodes, c);
+
+    mesh->get_faces(faces, c);
+    ASSERT_EQ(4u, faces.size());
+    for (size_t f = 0; f < faces.size(); ++f)
+    {
+      mesh->get_nodes(nodes, faces[f]);
+      ASSERT_EQ(3u, nodes.size());
+      EXPECT_TRUE(std::all_of(nodes.begin(), nodes.end(), inCell));
+      mesh->get_elems(elems, faces[f]);
+      EXPECT_NE(elems.end(), std::find(elems.begin(), elems.end(), c));
+    }
 
+    mesh->get_edges(edges, c);
+    ASSERT_EQ(6u, edges.size());
+    for (size_t e = 0; e < edges.size(); ++e)
+    {
+      mesh->get_nodes(nodes, edges[e]);
+      ASSERT_EQ(2u, nodes.size());
+      EXPECT_TRUE(std::all_of(nodes.begin(), nodes.end(), inCell));
+    }
+    std::sort(edges.begin(), edges.end());
+    EXPECT_EQ(edges.end(), std::adjacent_find(edges.begin(), edges.end()));
+  }
+}
+
+TEST(TetVolMeshTest, NodeNeighborsAreSortedAndComplete)
+{
+  FieldHandle field = tetGrid(gridSize);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+
+  size_type total = 0;
+  VMesh::Elem::array_type elems;
+  VMesh::Node::array_type nodes;
+  for (VMesh::Node::index_type n = 0; n < mesh->num_nodes(); ++n)
+  {
+    mesh->get_elems(elems, n);
+    ASSERT_FALSE(elems.empty());
+    EXPECT_TRUE(std::is_sorted(elems.begin(), elems.end()));
+    for (size_t i = 0; i < elems.size(); ++i)
+    {
+      mesh->get_nodes(nodes, elems[i]);
+      EXPECT_NE(nodes.end(), std::find(nodes.begin(), nodes.end(), n));
+    }
+    total += elems.size();
+  }
+  EXPECT_EQ(4 * gridTets, total);
+}
+
+namespace
+{
+  // The hash map construction compute_faces used before it was replaced by
+  // the parallel sort: one table to pair up the cells of every face, then
+  // the face numbering and node lookup table built from it.
+  typedef std::array<index_type, 3> FaceKey;
+  struct FaceKeyHash
+  {
+    size_t operator()(const FaceKey& f) const { return boost::hash_range(f.begin(), f.end()); }
+  };
+
+  size_t hashMapFaces(VMesh* mesh)
+  {
+    boost::unordered_map<FaceKey, std::pair<index_type, index_type>, FaceKeyHash> table;
+    const int faceNodes[4][3] = { {0, 2, 1}, {1, 2, 3}, {0, 1, 3}, {0, 3, 2} };
+    VMesh::Node::array_type nodes;
+    for (VMesh::Elem::index_type c = 0; c < mesh->num_elems(); ++c)
+    {
+      mesh->get_nodes(nodes, c);
+      for (int f = 0; f < 4; ++f)
+      {
+        FaceKey key = {{ nodes[faceNodes[f][0]], nodes[faceNodes[f][1]], nodes[faceNodes[f][2]] }};
+        std::sort(key.begin(), key.end());
+        auto it = table.find(key);
+        if (it == table.end())
+          table[key] = std::make_pair(static_cast<index_type>(c << 2) + f, index_type(-1));
+        else if (it->second.second == -1)
+          it->second.second = static_cast<index_type>(c << 2) + f;
+      }
+    }
+
+    // Number the faces in table order and build the node lookup table
+    std::vector<std::pair<index_type, index_type> > faces(table.size());
+    boost::unordered_map<FaceKey, index_type, FaceKeyHash> lookup;
+    index_type u = 0;
+    for (auto it = table.begin(); it != table.end(); ++it, ++u)
+    {
+      faces[u] = it->second;
+      lookup[it->first] = u;
+    }
+    return lookup.size();
+  }
+}
+
+TEST(TetVolMeshTest, DISABLED_SortedFaceTableVersusHashMapBenchmark)
+{
+  FieldHandle field = tetGrid(40);
+  VMesh* mesh = field->vmesh();
+
+  auto start = std::chrono::steady_clock::now();
+  const size_t hashed = hashMapFaces(mesh);
+  const std::chrono::duration<double> hashTime = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  mesh->synchronize(Mesh::FACES_E);
+  const std::chrono::duration<double> sortTime = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(hashed, mesh->num_faces());
+  std::cout << mesh->num_elems() << " tets, " << hashed << " faces: hash map "
+    << hashTime.count() << " s, parallel sort " << sortTime.count() << " s" << std::endl;
+}
@@ -38,6 +38,7 @@
 #include <Core/Persistent/PersistentSTL.h>
 
 #include <Core/GeometryPrimitives/SearchGridT.h>
+#include <Core/GeometryPrimitives/SearchTree.h>
 #include <Core/GeometryPrimitives/BBox.h>
 #include <Core/GeometryPrimitives/CompGeom.h>
 #include <Core/GeometryPrimitives/Point.h>
@@ -52,6 +53,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTableBuilder.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 #include <Core/Math/MiscMath.h>
@@ -62,6 +64,7 @@
 #include <boost/unordered_map.hpp>
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/ConditionVariable.h>
+#include <Core/Thread/Parallel.h>
 
 #include <set>
 
@@ -323,7 +326,7 @@ public:
         if (sync_ & Mesh::BOUNDING_BOX_E) mesh_->compute_bounding_box();
 
         // These depend on the bounding box being synchronized
-        if (sync_ & (Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E))
+        if (sync_ & (Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E|Mesh::NODE_LOCATE_TREE_E))
         {
           {
             Core::Thread::UniqueLock lock(mesh_->synchronize_lock_.get());
@@ -332,6 +335,7 @@ public:
           }
           if (sync_ & Mesh::NODE_LOCATE_E) mesh_->compute_node_grid();
           if (sync_ & Mesh::ELEM_LOCATE_E) mesh_->compute_elem_grid();
+          if (sync_ & Mesh::NODE_LOCATE_TREE_E) mesh_->compute_node_tree();
         }
 
         mesh_->synchronize_lock_.lock();
@@ -915,6 +919,18 @@ public:
       }
     }
 
+    if (synchronized_ & Mesh::NODE_LOCATE_TREE_E)
+    {
+      index_type idx;
+      double dist;
+      if (!node_tree_->closest(idx, dist, p, maxdist)) return (false);
+
+      result = points_[idx];
+      node = INDEX(idx);
+      pdist = sqrt(dist);
+      return (true);
+    }
+
     ASSERTMSG(synchronized_ & Mesh::NODE_LOCATE_E,
 	      "TetVolMesh::find_closest_node requires synchronize(NODE_LOCATE_E).");
 
@@ -1004,6 +1020,15 @@ public:
   {
     nodes.clear();
 
+    if (synchronized_ & Mesh::NODE_LOCATE_TREE_E)
+    {
+      std::vector<index_type> idx;
+      std::vector<double> dist;
+      node_tree_->within(idx, dist, p, maxdist*maxdist);
+      for (size_t j = 0; j < idx.size(); j++) nodes.push_back(idx[j]);
+      return (nodes.size() > 0);
+    }
+
     ASSERTMSG(synchronized_ & Mesh::NODE_LOCATE_E,
         "TetVolMesh::find_closest_node requires synchronize(NODE_LOCATE_E).")
 
@@ -1076,6 +1101,19 @@ public:
     nodes.clear();
     distances.clear();
 
+    if (synchronized_ & Mesh::NODE_LOCATE_TREE_E)
+    {
+      std::vector<index_type> idx;
+      std::vector<double> dist;
+      node_tree_->within(idx, dist, p, maxdist*maxdist);
+      for (size_t j = 0; j < idx.size(); j++)
+      {
+        nodes.push_back(idx[j]);
+        distances.push_back(dist[j]);
+      }
+      return (nodes.size() > 0);
+    }
+
     ASSERTMSG(synchronized_ & Mesh::NODE_LOCATE_E,
         "TetVolMesh::find_closest_node requires synchronize(NODE_LOCATE_E).")
 
@@ -1624,6 +1662,7 @@ protected:
     PEdgeNode e05(cells_[off + 2], cells_[off + 3]);
     typename Node::index_type n1,n2;
 
+    array.resize(6);
     n1 = cells_[off    ]; n2 = cells_[off + 1];
     size_t i = 0;
     typedef typename ARRAY::value_type T;
@@ -1662,6 +1701,7 @@ protected:
       PEdge e(n1,n2);
       array[i++] = (static_cast<T>((*(edge_table_.find(e))).second));
     }
+    array.resize(i);
   }
 
   template<class ARRAY, class INDEX>
@@ -2263,6 +2303,7 @@ protected:
   void compute_faces();
   void compute_node_grid();
   void compute_elem_grid();
+  void compute_node_tree();
   void compute_bounding_box();
 
   void insert_elem_into_grid(typename Elem::index_type ci);
@@ -2550,9 +2591,7 @@ protected:
     }
   };
 
-  using face_ht = boost::unordered_map<PFace, typename Face::index_type, FaceHash>;
   using face_nt = boost::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = boost::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
   using edge_nt = boost::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
 
   typedef std::vector<PFaceCell> face_ct;
@@ -2574,11 +2613,6 @@ protected:
 			  typename Cell::index_type ci,
 			  bool table_only = false);
 
-  inline void hash_edge(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        index_type combined_index,
-                        edge_ht& table);
-
   inline void add_edge(typename Node::index_type n1,
                         typename Node::index_type n2,
                         index_type combined_index);
@@ -2588,10 +2622,6 @@ protected:
                           typename Node::index_type n3,
                           typename Cell::index_type ci,
                           bool table_only = false);
-  inline void hash_face(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        typename Node::index_type n3,
-                        index_type ci, face_ht& table);
   inline void add_face(typename Node::index_type n1,
                        typename Node::index_type n2,
                        typename Node::index_type n3,
@@ -2607,6 +2637,8 @@ protected:
   ///  then search just those tets that overlap that grid cell.
   boost::shared_ptr<SearchGridT<index_type> >  node_grid_;
   boost::shared_ptr<SearchGridT<index_type> >  elem_grid_;
+  /// k-d tree alternative to node_grid_ for the closest node searches.
+  boost::shared_ptr<PointKDTree>  node_tree_;
 
   // Lock and Condition Variable for hand shaking
   mutable Core::Thread::Mutex                 synchronize_lock_;
@@ -2901,6 +2933,7 @@ TetVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
   if (node_grid_) { node_grid_->transform(t); }
   if (elem_grid_) { elem_grid_->transform(t); }
+  if (node_tree_) { node_tree_.reset(new PointKDTree(points_)); }
 
   synchronize_lock_.unlock();
 }
@@ -2951,101 +2984,74 @@ TetVolMesh<Basis>::remove_face(typename Node::index_type n1,
 
 template <class Basis>
 void
-TetVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             index_type combined_index,
-                             face_ht& table)
+TetVolMesh<Basis>::compute_faces()
 {
-  PFace f(n1, n2, n3);
+  typedef MeshTableEntry<3> entry_type;
+  const size_t num_cells = cells_.size() >> 2;
 
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
+  // 4 faces -- each is entered CCW from outside looking in
+  std::vector<entry_type> entries(num_cells * 4);
+  Core::Thread::Parallel::ForRange(0, num_cells, [this, &entries](size_t begin, size_t end)
   {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
+    static const int face_nodes[4][3] = { {0, 2, 1}, {1, 2, 3}, {0, 1, 3}, {0, 3, 2} };
+    for (size_t c = begin; c < end; ++c)
     {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << ", #" << (f.cells_[1]>>2) << ", and #"
-           << (combined_index>>2) << " are illegally adjacent." << std::endl;
-           */
-    }
-    else if ((f.cells_[0]>>2) == (combined_index>>2))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << " and #" << (combined_index>>2)
-           << " are the same." << std::endl;*/
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      const under_type* arr = &cells_[c * 4];
+      for (int f = 0; f < 4; f++)
+      {
+        PFaceNode face(arr[face_nodes[f][0]], arr[face_nodes[f][1]], arr[face_nodes[f][2]]);
+        entry_type& entry = entries[c * 4 + f];
+        std::copy(face.nodes_, face.nodes_ + 3, entry.nodes);
+        entry.code = static_cast<index_type>((c << 2) + f);
+      }
     }
-  }
-}
-
-template <class Basis>
-void
-TetVolMesh<Basis>::compute_faces()
-{
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(4);
+  });
 
-  face_ht table;
+  std::vector<index_type> runs;
+  MeshTableBuilder::sort_unique(entries, static_cast<index_type>(points_.size()), runs);
+  const size_t num_faces = runs.size() - 1;
 
-  while (ci != cie)
+  // The first cell of a run owns the face, the first other cell in the run
+  // is its neighbor. Any further cells make the mesh illegal and are ignored.
+  faces_.clear();
+  faces_.resize(num_faces);
+  std::vector<unsigned char> boundary(num_faces, 0);
+  Core::Thread::Parallel::ForRange(0, num_faces, [&](size_t begin, size_t end)
   {
-    get_nodes(arr, *ci);
-    // 4 faces -- each is entered CCW from outside looking in
-
-    index_type cell_index = (*ci)<<2;
-    hash_face(arr[0], arr[2], arr[1], cell_index, table);
-    hash_face(arr[1], arr[2], arr[3], cell_index + 1, table);
-    hash_face(arr[0], arr[1], arr[3], cell_index + 2, table);
-    hash_face(arr[0], arr[3], arr[2], cell_index + 3, table);
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
-
-  boundary_faces_.resize(cells_.size() >> 2);
+    for (size_t u = begin; u < end; ++u)
+    {
+      const index_type first = entries[runs[u]].code;
+      faces_[u].cells_[0] = first;
+      for (index_type i = runs[u] + 1; i < runs[u + 1]; ++i)
+      {
+        if ((entries[i].code >> 2) != (first >> 2))
+        {
+          faces_[u].cells_[1] = entries[i].code;
+          break;
+        }
+      }
+      boundary[u] = (faces_[u].cells_[1] == MESH_NO_NEIGHBOR);
+    }
+  });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  boundary_faces_.assign(num_cells, 0);
+  face_table_.clear();
+  face_table_.reserve(num_faces);
+  for (size_t u = 0; u < num_faces; ++u)
   {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2])] = uidx;
-
-    if (pface.cells_[1] == -1)
+    const entry_type& entry = entries[runs[u]];
+    face_table_[PFaceNode(entry.nodes[0], entry.nodes[1], entry.nodes[2])] = u;
+    if (boundary[u])
     {
-      index_type cell = (pface.cells_[0]) >> 2;
-      index_type face = (pface.cells_[0]) & 0x3;
+      index_type cell = (faces_[u].cells_[0]) >> 2;
+      index_type face = (faces_[u].cells_[0]) & 0x3;
       boundary_faces_[cell] |= 1 << face;
     }
-    ++ht_iter; uidx++;
   }
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::FACES_E;
   synchronize_lock_.unlock();
-
-
 }
 
 
@@ -3083,65 +3089,56 @@ TetVolMesh<Basis>::add_face(typename Node::index_type n1,
   }
 }
 
-template <class Basis>
-void
-TetVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht& table)
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 TetVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
+  typedef MeshTableEntry<2> entry_type;
+  const size_t num_cells = cells_.size() >> 2;
 
-  typename Node::array_type arr;
-  while (ci != cie)
+  std::vector<entry_type> entries(num_cells * 6);
+  Core::Thread::Parallel::ForRange(0, num_cells, [this, &entries](size_t begin, size_t end)
   {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<3;
-    hash_edge(arr[0], arr[1], cell_index  ,table);
-    hash_edge(arr[1], arr[2], cell_index+1,table);
-    hash_edge(arr[2], arr[0], cell_index+2,table);
-    hash_edge(arr[3], arr[0], cell_index+3,table);
-    hash_edge(arr[3], arr[1], cell_index+4,table);
-    hash_edge(arr[3], arr[2], cell_index+5,table);
-    ++ci;
-  }
+    static const int edge_nodes[6][2] = { {0, 1}, {1, 2}, {2, 0}, {3, 0}, {3, 1}, {3, 2} };
+    for (size_t c = begin; c < end; ++c)
+    {
+      const under_type* arr = &cells_[c * 4];
+      for (int e = 0; e < 6; e++)
+      {
+        const index_type n1 = arr[edge_nodes[e][0]];
+        const index_type n2 = arr[edge_nodes[e][1]];
+        entry_type& entry = entries[c * 6 + e];
+        // Degenerate edges are dropped by the sort
+        entry.nodes[0] = (n1 == n2) ? -1 : std::min(n1, n2);
+        entry.nodes[1] = std::max(n1, n2);
+        entry.code = static_cast<index_type>((c << 3) + e);
+      }
+    }
+  });
 
-  edges_.resize(table.size());
+  std::vector<index_type> runs;
+  MeshTableBuilder::sort_unique(entries, static_cast<index_type>(points_.size()), runs);
+  const size_t num_edges = runs.size() - 1;
 
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
+  edges_.clear();
+  edges_.resize(num_edges);
+  Core::Thread::Parallel::ForRange(0, num_edges, [&](size_t begin, size_t end)
+  {
+    for (size_t u = begin; u < end; ++u)
+    {
+      std::vector<index_type>& cells = edges_[u].cells_;
+      cells.resize(runs[u + 1] - runs[u]);
+      for (index_type i = runs[u]; i < runs[u + 1]; ++i)
+        cells[i - runs[u]] = entries[i].code;
+    }
+  });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  edge_table_.clear();
+  edge_table_.reserve(num_edges);
+  for (size_t u = 0; u < num_edges; ++u)
   {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
+    const entry_type& entry = entries[runs[u]];
+    edge_table_[PEdgeNode(entry.nodes[0], entry.nodes[1])] = u;
   }
 
   synchronize_lock_.lock();
@@ -3149,6 +3146,7 @@ TetVolMesh<Basis>::compute_edges()
   synchronize_lock_.unlock();
 }
 
+
 template <class Basis>
 void
 TetVolMesh<Basis>::add_edge(typename Node::index_type n1,
@@ -3178,18 +3176,24 @@ TetVolMesh<Basis>::synchronize(mask_type sync)
   if (sync & (Mesh::ELEM_NEIGHBORS_E|Mesh::DELEMS_E))
   { sync |= Mesh::FACES_E; sync &= ~(Mesh::ELEM_NEIGHBORS_E|Mesh::DELEMS_E); }
 
+  // Only the node search has a tree version in this mesh
   if (sync & Mesh::FIND_CLOSEST_NODE_E)
-  { sync |= NODE_LOCATE_E; sync &=  ~(Mesh::FIND_CLOSEST_NODE_E); }
+  {
+    if (!(sync & Mesh::NODE_LOCATE_TREE_E)) sync |= NODE_LOCATE_E;
+    sync &=  ~(Mesh::FIND_CLOSEST_NODE_E);
+  }
 
   if (sync & Mesh::FIND_CLOSEST_ELEM_E)
   { sync |= ELEM_LOCATE_E|FACES_E; sync &=  ~(Mesh::FIND_CLOSEST_ELEM_E); }
 
-  if (sync & (Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E)) sync |= Mesh::BOUNDING_BOX_E;
+  if (sync & (Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E|Mesh::NODE_LOCATE_TREE_E))
+    sync |= Mesh::BOUNDING_BOX_E;
 
   // Filter out the only tables available
   sync &= (Mesh::EDGES_E|Mesh::FACES_E|
            Mesh::NODE_NEIGHBORS_E|Mesh::BOUNDING_BOX_E|
-           Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E);
+           Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E|
+           Mesh::NODE_LOCATE_TREE_E);
 
   Core::Thread::UniqueLock lock(synchronize_lock_.get());
 
@@ -3280,6 +3284,20 @@ TetVolMesh<Basis>::synchronize(mask_type sync)
     boost::thread syncthread(syncclass);
   }
 
+  if (sync == Mesh::NODE_LOCATE_TREE_E)
+  {
+    Synchronize Synchronize(this,sync);
+    synchronize_lock_.unlock();
+    Synchronize.run();
+    synchronize_lock_.lock();
+  }
+  else if (sync & Mesh::NODE_LOCATE_TREE_E)
+  {
+    mask_type tosync = Mesh::NODE_LOCATE_TREE_E;
+    Synchronize syncclass(this,tosync);
+    boost::thread syncthread(syncclass);
+  }
+
   // Wait until threads are done
   while ((synchronized_ & sync) != sync)
   {
@@ -3316,6 +3334,7 @@ TetVolMesh<Basis>::clear_synchronization()
 
   node_grid_.reset();
   elem_grid_.reset();
+  node_tree_.reset();
 
   synchronize_lock_.unlock();
 
@@ -3672,13 +3691,8 @@ template <class Basis>
 void
 TetVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  MeshTableBuilder::node_neighbors(cells_, 1, static_cast<index_type>(points_.size()),
+                                   node_neighbors_);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3841,6 +3855,17 @@ TetVolMesh<Basis>::compute_node_grid()
   synchronize_lock_.unlock();
 }
 
+template <class Basis>
+void
+TetVolMesh<Basis>::compute_node_tree()
+{
+  node_tree_.reset(new PointKDTree(points_));
+
+  synchronize_lock_.lock();
+  synchronized_ |= Mesh::NODE_LOCATE_TREE_E;
+  synchronize_lock_.unlock();
+}
+
 template <class Basis>
 void
 TetVolMesh<Basis>::compute_bounding_box()
@@ -4003,6 +4028,7 @@ TetVolMesh<Basis>::delete_cells(std::set<index_type> &to_delete)
   }
 
   synchronized_ &= ~Mesh::LOCATE_E;
+  synchronized_ &= ~Mesh::NODE_LOCATE_TREE_E;
   synchronized_ &= ~Mesh::NODE_NEIGHBORS_E;
   if (synchronized_ & Mesh::FACES_E)
   {
@@ -4030,6 +4056,7 @@ TetVolMesh<Basis>::delete_nodes(std::set<index_type> &to_delete)
     points_.erase(pit);
   }
   synchronized_ &= ~Mesh::LOCATE_E;
+  synchronized_ &= ~Mesh::NODE_LOCATE_TREE_E;
   synchronized_ &= ~Mesh::NODE_NEIGHBORS_E;
   if (synchronized_ & Mesh::FACES_E)
   {
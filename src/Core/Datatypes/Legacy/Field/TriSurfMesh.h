@@ -42,6 +42,7 @@
 #include <Core/GeometryPrimitives/CompGeom.h>
 #include <Core/Containers/StackVector.h>
 #include <Core/GeometryPrimitives/SearchGridT.h>
+#include <Core/GeometryPrimitives/SearchTree.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
 #include <Core/Basis/Locate.h>
@@ -52,10 +53,12 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
+#include <Core/Datatypes/Legacy/Field/MeshTableBuilder.h>
 #include <Core/Datatypes/Legacy/Base/Types.h>
 
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/ConditionVariable.h>
+#include <Core/Thread/Parallel.h>
 #include <boost/thread.hpp>
 #include <boost/unordered_map.hpp>
 
@@ -259,7 +262,7 @@ public:
         if (sync_ & Mesh::BOUNDING_BOX_E) mesh_->compute_bounding_box();
 
         // These depend on the bounding box being synchronized
-        if (sync_ & (Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E))
+        if (sync_ & (Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E|Mesh::LOCATE_TREE_E))
         {
           {
             Core::Thread::UniqueLock lock(mesh_->synchronize_lock_.get());
@@ -274,6 +277,14 @@ public:
           {
             mesh_->compute_elem_grid();
           }
+          if (sync_ & Mesh::NODE_LOCATE_TREE_E)
+          {
+            mesh_->compute_node_tree();
+          }
+          if (sync_ & Mesh::ELEM_LOCATE_TREE_E)
+          {
+            mesh_->compute_elem_tree();
+          }
         }
 
         mesh_->synchronize_lock_.lock();
@@ -782,6 +793,18 @@ public:
       }
     }
 
+    if (synchronized_ & Mesh::NODE_LOCATE_TREE_E)
+    {
+      index_type idx;
+      double dist;
+      if (!node_tree_->closest(idx, dist, p, maxdist)) return (false);
+
+      result = points_[idx];
+      node = INDEX(idx);
+      pdist = sqrt(dist);
+      return (true);
+    }
+
     ASSERTMSG(synchronized_ & Mesh::NODE_LOCATE_E,
         "TriSurfMesh::find_closest_node requires synchronize(NODE_LOCATE_E).")
 
@@ -874,6 +897,15 @@ public:
   {
     nodes.clear();
 
+    if (synchronized_ & Mesh::NODE_LOCATE_TREE_E)
+    {
+      std::vector<index_type> idx;
+      std::vector<double> dist;
+      node_tree_->within(idx, dist, p, maxdist*maxdist);
+      for (size_t j = 0; j < idx.size(); j++) nodes.push_back(idx[j]);
+      return (nodes.size() > 0);
+    }
+
     ASSERTMSG(synchronized_ & Mesh::NODE_LOCATE_E,
         "TriSurfMesh::find_closest_node requires synchronize(NODE_LOCATE_E).")
 
@@ -945,6 +977,19 @@ public:
     nodes.clear();
     distances.clear();
 
+    if (synchronized_ & Mesh::NODE_LOCATE_TREE_E)
+    {
+      std::vector<index_type> idx;
+      std::vector<double> dist;
+      node_tree_->within(idx, dist, p, maxdist*maxdist);
+      for (size_t j = 0; j < idx.size(); j++)
+      {
+        nodes.push_back(idx[j]);
+        distances.push_back(dist[j]);
+      }
+      return (nodes.size() > 0);
+    }
+
     ASSERTMSG(synchronized_ & Mesh::NODE_LOCATE_E,
         "TriSurfMesh::find_closest_node requires synchronize(NODE_LOCATE_E).")
 
@@ -1056,6 +1101,48 @@ public:
       }
     }
 
+    if (synchronized_ & Mesh::ELEM_LOCATE_TREE_E)
+    {
+      double dmin = maxdist;
+      double dmean = maxdist;
+      bool found_one = false;
+      bool done = false;
+
+      // Candidates within epsilon_ of the best one still compete on the
+      // perturbed distance, so the search bound trails dmin by epsilon_.
+      double bound = maxdist;
+      auto visit = [&](index_type elem, double& bound2)
+      {
+        if (done) return;
+        if (closest_elem_candidate(elem, p, dmin, dmean, found_one,
+                                   result, face))
+        {
+          done = true;
+          bound2 = -1.0;
+          return;
+        }
+        if (found_one) bound2 = std::min(maxdist, dmin + epsilon_);
+      };
+      elem_tree_->closest(p, bound, visit);
+
+      if (done)
+      {
+        pdist = sqrt(dmean);
+
+        ElemData ed(*this,face);
+        basis_.get_coords(coords,result,ed);
+        return (true);
+      }
+
+      if (!found_one) return (false);
+
+      ElemData ed(*this,face);
+      basis_.get_coords(coords,result,ed);
+
+      pdist = sqrt(dmin);
+      return (true);
+    }
+
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
         "TriSurfMesh::find_closest_elem requires synchronize(ELEM_LOCATE_E).")
 
@@ -1088,7 +1175,6 @@ public:
     double dmean = maxdist;
     bool found = true;
     bool found_one = false;
-    double perturb= epsilon_*100; //value to move to find new point.
 
     do
     {
@@ -1114,92 +1200,15 @@ public:
 
                 while (it != eit)
                 {
-                  Core::Geometry::Point r, r_pert;
-                  index_type idx = (*it) * 3;
-                  
-                  closest_point_on_tri(r, p, points_[faces_[idx]], points_[faces_[idx+1]], points_[faces_[idx+2]]);
-                  double dtmp = (p - r).length2();
-                  
-                  
-                  //test triangle size for scaling
-                  Core::Geometry::Vector v1= Core::Geometry::Vector(points_[faces_[idx+1]]-points_[faces_[idx  ]]); v1.normalize();
-                  Core::Geometry::Vector v2= Core::Geometry::Vector(points_[faces_[idx+2]]-points_[faces_[idx  ]]); v2.normalize();
-                  
-                  Core::Geometry::Vector n=Cross(v1,v2); n.normalize();
-                  Core::Geometry::Vector pr=Core::Geometry::Vector(r-p); pr.normalize();
-                  
-                  if (std::abs(Dot(pr,n))>1-perturb)
+                  if (closest_elem_candidate(*it, p, dmin, dmean, found_one,
+                                             result, face))
                   {
-                    r_pert=r;
-                  }
-                  else
-                  {
-                      
-                    Core::Geometry::Vector pp=Cross(n,pr); pp.normalize();
-                    Core::Geometry::Vector vect=Cross(pp,n); vect.normalize();
-                    
-                    r_pert=Core::Geometry::Point(r+vect*perturb);
-                  }
-                  
-                  double dtmp2=(p-r_pert).length2();
+                    pdist = sqrt(dmean);
 
-                  //check for closest face and check within precision
-                  if (dtmp-dmin <= epsilon_)
-                  {
-                    if (dtmp-dmin < - epsilon_)
-                    {
-                      found_one = true;
-                      result = r;
-                      face = INDEX(*it);
-                      dmin = dtmp;
-                      dmean =dtmp2;
-                      
-                      if (dmin < epsilon2_)
-                      {
-                        
-                        pdist = sqrt(dmin);
-                        pdist = sqrt(dmean);
-                            
-                        ElemData ed(*this,face);
-                        basis_.get_coords(coords,result,ed);
-                        return (true);
-                      }
-                    }
-                    else if (dtmp2-dmean < - epsilon_ )
-                    {
-                      found_one = true;
-                      result = r;
-                      face = INDEX(*it);
-                      if (dmin>=dtmp) dmin=dtmp;
-                      dmean =dtmp2;
-                    }
-                    else if (dtmp<dmin  && std::abs(dtmp2-dmean) < epsilon_ )
-                    {
-                      found_one = true;
-                      result = r;
-                      face = INDEX(*it);
-                      dmin = dtmp;
-                      dmean =dtmp2;
-                      if (dmin < epsilon2_)
-                      {
-                        
-                        pdist = sqrt(dmin);
-                        pdist = sqrt(dmean);
-                        
-                        ElemData ed(*this,face);
-                        basis_.get_coords(coords,result,ed);
-                      }
-                    }
-                    else if (dtmp2 < dmean && dtmp-dmin > - epsilon_)
-                    {
-                      found_one = true;
-                      result = r;
-                      face = INDEX(*it);
-                      dmean =dtmp2;
-                    }
+                    ElemData ed(*this,face);
+                    basis_.get_coords(coords,result,ed);
+                    return (true);
                   }
-                  
-
                   ++it;
                 }
               }
@@ -1279,6 +1288,39 @@ public:
     /// If there are no nodes we cannot find the closest one
     if (sz == 0) return (false);
 
+    if (synchronized_ & Mesh::ELEM_LOCATE_TREE_E)
+    {
+      double dmin = DBL_MAX;
+      double bound = DBL_MAX;
+      auto visit = [&](index_type elem, double& bound2)
+      {
+        Core::Geometry::Point rtmp;
+        index_type idx = elem * 3;
+        closest_point_on_tri(rtmp, p,
+                             points_[faces_[idx  ]],
+                             points_[faces_[idx+1]],
+                             points_[faces_[idx+2]]);
+        const double dtmp = (p - rtmp).length2();
+
+        if (dtmp < dmin - epsilon2_)
+        {
+          elems.clear();
+          result = rtmp;
+          elems.push_back(typename ARRAY::value_type(elem));
+          dmin = dtmp;
+          bound2 = dmin + epsilon2_;
+        }
+        else if (dtmp < dmin + epsilon2_)
+        {
+          elems.push_back(typename ARRAY::value_type(elem));
+        }
+      };
+      elem_tree_->closest(p, bound, visit);
+
+      pdist = sqrt(dmin);
+      return (true);
+    }
+
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
         "TriSurfMesh::find_closest_elems requires synchronize(ELEM_LOCATE_E).")
 
@@ -2006,11 +2048,17 @@ protected:
   void compute_edges();
   // Fixes bug #887 (gforge)
   void compute_edges_bugfix();
+  void compute_edge_tables(bool with_edge_on_node);
   void compute_edge_neighbors();
 
   void compute_node_grid();
   void compute_elem_grid();
+  void compute_node_tree();
+  void compute_elem_tree();
   void compute_bounding_box();
+  // Tree builders that leave synchronized_ alone, for use under the lock.
+  void build_node_tree();
+  void build_elem_tree();
 
   /// Used to recompute data for individual cells.
   void insert_elem_into_grid(typename Elem::index_type ci);
@@ -2023,6 +2071,83 @@ protected:
 
   bool inside3_p(index_type face_times_three, const Core::Geometry::Point &p) const;
 
+  /// Test triangle elem as a candidate in find_closest_elem. Of triangles
+  /// within epsilon_ of each other the one whose closest point lies further
+  /// inside (the perturbed distance dmean) wins. Returns true if p lies on
+  /// the triangle and the search can stop.
+  template <class INDEX>
+  bool closest_elem_candidate(index_type elem, const Core::Geometry::Point &p,
+                              double &dmin, double &dmean, bool &found_one,
+                              Core::Geometry::Point &result, INDEX &face) const
+  {
+    const double perturb = epsilon_*100; //value to move to find new point.
+    const index_type idx = elem * 3;
+
+    Core::Geometry::Point r, r_pert;
+    closest_point_on_tri(r, p, points_[faces_[idx]], points_[faces_[idx+1]], points_[faces_[idx+2]]);
+    const double dtmp = (p - r).length2();
+
+    //test triangle size for scaling
+    Core::Geometry::Vector v1= Core::Geometry::Vector(points_[faces_[idx+1]]-points_[faces_[idx  ]]); v1.normalize();
+    Core::Geometry::Vector v2= Core::Geometry::Vector(points_[faces_[idx+2]]-points_[faces_[idx  ]]); v2.normalize();
+
+    Core::Geometry::Vector n=Cross(v1,v2); n.normalize();
+    Core::Geometry::Vector pr=Core::Geometry::Vector(r-p); pr.normalize();
+
+    if (std::abs(Dot(pr,n))>1-perturb)
+    {
+      r_pert=r;
+    }
+    else
+    {
+      Core::Geometry::Vector pp=Cross(n,pr); pp.normalize();
+      Core::Geometry::Vector vect=Cross(pp,n); vect.normalize();
+
+      r_pert=Core::Geometry::Point(r+vect*perturb);
+    }
+
+    const double dtmp2=(p-r_pert).length2();
+
+    //check for closest face and check within precision
+    if (dtmp-dmin <= epsilon_)
+    {
+      if (dtmp-dmin < - epsilon_)
+      {
+        found_one = true;
+        result = r;
+        face = INDEX(elem);
+        dmin = dtmp;
+        dmean =dtmp2;
+
+        if (dmin < epsilon2_) return (true);
+      }
+      else if (dtmp2-dmean < - epsilon_ )
+      {
+        found_one = true;
+        result = r;
+        face = INDEX(elem);
+        if (dmin>=dtmp) dmin=dtmp;
+        dmean =dtmp2;
+      }
+      else if (dtmp<dmin  && std::abs(dtmp2-dmean) < epsilon_ )
+      {
+        found_one = true;
+        result = r;
+        face = INDEX(elem);
+        dmin = dtmp;
+        dmean =dtmp2;
+      }
+      else if (dtmp2 < dmean && dtmp-dmin > - epsilon_)
+      {
+        found_one = true;
+        result = r;
+        face = INDEX(elem);
+        dmean =dtmp2;
+      }
+    }
+    return (false);
+  }
+
   static index_type next(index_type i) { return ((i%3)==2) ? (i-2) : (i+1); }
   static index_type prev(index_type i) { return ((i%3)==0) ? (i+2) : (i-1); }
 
@@ -2038,6 +2163,8 @@ protected:
 
   boost::shared_ptr<SearchGridT<index_type> > node_grid_; // Lookup table for nodes
   boost::shared_ptr<SearchGridT<index_type> > elem_grid_; // Lookup table for elements
+  boost::shared_ptr<PointKDTree> node_tree_;              // Tree for nodes
+  boost::shared_ptr<BoundingVolumeHierarchy> elem_tree_;  // Tree for elements
 
   // Lock and Condition Variable for hand shaking
   mutable Core::Thread::Mutex         synchronize_lock_;
@@ -2066,7 +2193,6 @@ protected:
   };
 
   using EdgeMapType = boost::unordered_map<std::pair<index_type, index_type>, index_type, edgehash>;
-  using EdgeMapType2 = boost::unordered_map<std::pair<index_type, index_type>, std::vector<index_type>, edgehash>;
 };
 
 
@@ -2264,6 +2390,9 @@ TriSurfMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
   if (node_grid_) { node_grid_->transform(t); }
   if (elem_grid_) { elem_grid_->transform(t); }
+  // The trees split on the point coordinates and need to be rebuilt
+  if (node_tree_) { build_node_tree(); }
+  if (elem_tree_) { build_elem_tree(); }
 
   synchronize_lock_.unlock();
 }
@@ -2419,20 +2548,29 @@ TriSurfMesh<Basis>::synchronize(mask_type sync)
   if (sync & (Mesh::DELEMS_E))
   { sync |= Mesh::EDGES_E; sync &= ~(Mesh::DELEMS_E); }
 
+  // With a tree requested the closest searches use the tree, not the grid
   if (sync & Mesh::FIND_CLOSEST_NODE_E)
-  { sync |= NODE_LOCATE_E; sync &=  ~(Mesh::FIND_CLOSEST_NODE_E); }
+  {
+    if (!(sync & Mesh::NODE_LOCATE_TREE_E)) sync |= NODE_LOCATE_E;
+    sync &=  ~(Mesh::FIND_CLOSEST_NODE_E);
+  }
 
   if (sync & Mesh::FIND_CLOSEST_ELEM_E)
-  { sync |= ELEM_LOCATE_E; sync &=  ~(Mesh::FIND_CLOSEST_ELEM_E); }
+  {
+    if (!(sync & Mesh::ELEM_LOCATE_TREE_E)) sync |= ELEM_LOCATE_E;
+    sync &=  ~(Mesh::FIND_CLOSEST_ELEM_E);
+  }
 
-  if (sync & (Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E)) sync |= Mesh::BOUNDING_BOX_E;
+  if (sync & (Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E|Mesh::LOCATE_TREE_E))
+    sync |= Mesh::BOUNDING_BOX_E;
   if (sync & Mesh::ELEM_NEIGHBORS_E) sync |= Mesh::EDGES_E;
 
   // Filter out the only tables available
   sync &= (Mesh::EDGES_E|Mesh::NORMALS_E|
            Mesh::NODE_NEIGHBORS_E|Mesh::BOUNDING_BOX_E|
            Mesh::ELEM_NEIGHBORS_E|
-           Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E);
+           Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E|
+           Mesh::NODE_LOCATE_TREE_E|Mesh::ELEM_LOCATE_TREE_E);
 
   Core::Thread::UniqueLock lock(synchronize_lock_.get());
 
@@ -2537,6 +2675,34 @@ TriSurfMesh<Basis>::synchronize(mask_type sync)
     boost::thread syncthread(syncclass);
   }
 
+  if (sync == Mesh::NODE_LOCATE_TREE_E)
+  {
+    Synchronize Synchronize(this,sync);
+    synchronize_lock_.unlock();
+    Synchronize.run();
+    synchronize_lock_.lock();
+  }
+  else if (sync & Mesh::NODE_LOCATE_TREE_E)
+  {
+    mask_type tosync = Mesh::NODE_LOCATE_TREE_E;
+    Synchronize syncclass(this,tosync);
+    boost::thread syncthread(syncclass);
+  }
+
+  if (sync == Mesh::ELEM_LOCATE_TREE_E)
+  {
+    Synchronize Synchronize(this,sync);
+    synchronize_lock_.unlock();
+    Synchronize.run();
+    synchronize_lock_.lock();
+  }
+  else if (sync & Mesh::ELEM_LOCATE_TREE_E)
+  {
+    mask_type tosync = Mesh::ELEM_LOCATE_TREE_E;
+    Synchronize syncclass(this,tosync);
+    boost::thread syncthread(syncclass);
+  }
+
   // Wait until threads are done
   while ((synchronized_ & sync) != sync)
   {
@@ -2569,6 +2735,8 @@ TriSurfMesh<Basis>::clear_synchronization()
   edges_.clear();
   node_grid_.reset();
   elem_grid_.reset();
+  node_tree_.reset();
+  elem_tree_.reset();
 
   synchronize_lock_.unlock();
   return (true);
@@ -2702,6 +2870,7 @@ TriSurfMesh<Basis>::insert_node(typename Face::index_type face, const Core::Geom
   if (!do_neighbors) synchronized_ &= ~Mesh::NODE_NEIGHBORS_E;
   synchronized_ &= ~(Mesh::EDGES_E);
   if (!do_normals) synchronized_ &= ~Mesh::NORMALS_E;
+  synchronized_ &= ~Mesh::LOCATE_TREE_E;
 
   synchronize_lock_.unlock();
 }
@@ -2804,6 +2973,7 @@ TriSurfMesh<Basis>::insert_node_in_edge_aux(typename Face::array_type &tris,
   synchronized_ &= ~Mesh::NODE_NEIGHBORS_E;
   synchronized_ &= ~(Mesh::EDGES_E);
   synchronized_ &= ~Mesh::NORMALS_E;
+  synchronized_ &= ~Mesh::LOCATE_TREE_E;
 
   for (size_t i = 0; i < tris.size(); i++)
   {
@@ -2871,6 +3041,7 @@ TriSurfMesh<Basis>::insert_node_in_face_aux(typename Face::array_type &tris,
   synchronized_ &= ~Mesh::NODE_NEIGHBORS_E;
   synchronized_ &= ~(Mesh::EDGES_E);
   synchronized_ &= ~Mesh::NORMALS_E;
+  synchronized_ &= ~Mesh::LOCATE_TREE_E;
 
   for (size_t i = 0; i < tris.size(); i++)
   {
@@ -3163,6 +3334,7 @@ TriSurfMesh<Basis>::bisect_element(const typename Face::index_type face)
   if (!do_neighbors) synchronized_ &= ~Mesh::NODE_NEIGHBORS_E;
   synchronized_ &= ~(Mesh::EDGES_E);
   if (!do_normals) synchronized_ &= ~Mesh::NORMALS_E;
+  synchronized_ &= ~Mesh::LOCATE_TREE_E;
 
   synchronize_lock_.unlock();
 }
@@ -3172,13 +3344,8 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  size_type nfaces = static_cast<size_type>(faces_.size());
-  for (index_type f = 0; f < nfaces; ++f)
-  {
-    node_neighbors_[faces_[f]].push_back(f/3);
-  }
+  MeshTableBuilder::node_neighbors(faces_, 3, static_cast<index_type>(points_.size()),
+                                   node_neighbors_);
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
   synchronize_lock_.unlock();
@@ -3189,43 +3356,7 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_edges()
 {
-  EdgeMapType2 edge_map;
-
-  size_type num_faces = static_cast<index_type>(faces_.size())/3;
-  for (index_type i=0; i < num_faces; i++)
-  {
-    index_type n0 = faces_[3*i];
-    index_type n1 = faces_[3*i+1];
-    index_type n2 = faces_[3*i+2];
-
-    if (n0 > n1) edge_map[std::pair<index_type, index_type>(n1,n0)].push_back(i<<2);
-    else  edge_map[std::pair<index_type, index_type>(n0,n1)].push_back(i<<2);
-
-    if (n1 > n2) edge_map[std::pair<index_type, index_type>(n2,n1)].push_back((i<<2)+1);
-    else  edge_map[std::pair<index_type, index_type>(n1,n2)].push_back((i<<2)+1);
-
-    if (n2 > n0) edge_map[std::pair<index_type, index_type>(n0,n2)].push_back((i<<2)+2);
-    else  edge_map[std::pair<index_type, index_type>(n2,n0)].push_back((i<<2)+2);
-  }
-
-  typename EdgeMapType2::iterator itr;
-  edges_.clear();
-  edges_.resize(edge_map.size());
-  halfedge_to_edge_.resize(faces_.size());
-
-  size_t k=0;
-  for (itr = edge_map.begin(); itr != edge_map.end(); ++itr)
-  {
-    const std::vector<index_type >& hedges = (*itr).second;
-    for (size_t j=0; j<hedges.size(); j++)
-    {
-      index_type h = hedges[j];
-      edges_[k].push_back(h);
-      halfedge_to_edge_[(h>>2)*3 + (h&0x3)] = k;
-
-    }
-    k++;
-  }
+  compute_edge_tables(false);
 
   synchronize_lock_.lock();
   synchronized_ |= (Mesh::EDGES_E);
@@ -3237,50 +3368,70 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_edges_bugfix()
 {
-  EdgeMapType2 edge_map;
+  compute_edge_tables(true);
 
-  size_type num_faces = static_cast<index_type>(faces_.size())/3;
-  for (index_type i=0; i < num_faces; i++)
-  {
-    index_type n0 = faces_[3*i];
-    index_type n1 = faces_[3*i+1];
-    index_type n2 = faces_[3*i+2];
+  synchronize_lock_.lock();
+  synchronized_ |= (Mesh::EDGES_E);
+  synchronize_lock_.unlock();
+}
 
-    if (n0 > n1) edge_map[std::pair<index_type, index_type>(n1,n0)].push_back(i<<2);
-    else  edge_map[std::pair<index_type, index_type>(n0,n1)].push_back(i<<2);
+template <class Basis>
+void
+TriSurfMesh<Basis>::compute_edge_tables(bool with_edge_on_node)
+{
+  typedef MeshTableEntry<2> entry_type;
+  const size_t num_faces = faces_.size() / 3;
 
-    if (n1 > n2) edge_map[std::pair<index_type, index_type>(n2,n1)].push_back((i<<2)+1);
-    else  edge_map[std::pair<index_type, index_type>(n1,n2)].push_back((i<<2)+1);
+  std::vector<entry_type> entries(num_faces * 3);
+  Core::Thread::Parallel::ForRange(0, num_faces, [this, &entries](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      for (size_t j = 0; j < 3; ++j)
+      {
+        const index_type n0 = faces_[3 * i + j];
+        const index_type n1 = faces_[3 * i + (j + 1) % 3];
+        entry_type& entry = entries[3 * i + j];
+        entry.nodes[0] = std::min(n0, n1);
+        entry.nodes[1] = std::max(n0, n1);
+        entry.code = static_cast<index_type>((i << 2) + j);
+      }
+    }
+  });
 
-    if (n2 > n0) edge_map[std::pair<index_type, index_type>(n0,n2)].push_back((i<<2)+2);
-    else  edge_map[std::pair<index_type, index_type>(n2,n0)].push_back((i<<2)+2);
-  }
+  std::vector<index_type> runs;
+  MeshTableBuilder::sort_unique(entries, static_cast<index_type>(points_.size()), runs);
+  const size_t num_edges = runs.size() - 1;
 
-  typename EdgeMapType2::iterator itr;
   edges_.clear();
-  edges_.resize(edge_map.size());
+  edges_.resize(num_edges);
   halfedge_to_edge_.resize(faces_.size());
-  edge_on_node_.clear();
-  edge_on_node_.resize(points_.size());
+  Core::Thread::Parallel::ForRange(0, num_edges, [&](size_t begin, size_t end)
+  {
+    for (size_t k = begin; k < end; ++k)
+    {
+      std::vector<index_type>& hedges = edges_[k];
+      hedges.resize(runs[k + 1] - runs[k]);
+      for (index_type j = runs[k]; j < runs[k + 1]; ++j)
+      {
+        const index_type h = entries[j].code;
+        hedges[j - runs[k]] = h;
+        halfedge_to_edge_[(h>>2)*3 + (h&0x3)] = k;
+      }
+    }
+  });
 
-  size_t k=0;
-  for (itr = edge_map.begin(); itr != edge_map.end(); ++itr)
+  if (with_edge_on_node)
   {
-    const std::vector<index_type >& hedges = (*itr).second;
-    for (size_t j=0; j<hedges.size(); j++)
+    std::vector<index_type> edge_nodes(2 * num_edges);
+    for (size_t k = 0; k < num_edges; ++k)
     {
-      index_type h = hedges[j];
-      edges_[k].push_back(h);
-      halfedge_to_edge_[(h>>2)*3 + (h&0x3)] = k;
+      edge_nodes[2 * k] = entries[runs[k]].nodes[0];
+      edge_nodes[2 * k + 1] = entries[runs[k]].nodes[1];
     }
-    edge_on_node_[(*itr).first.first].push_back(k);
-    edge_on_node_[(*itr).first.second].push_back(k);
-    k++;
+    MeshTableBuilder::node_neighbors(edge_nodes, 2, static_cast<index_type>(points_.size()),
+                                     edge_on_node_);
   }
-
-  synchronize_lock_.lock();
-  synchronized_ |= (Mesh::EDGES_E);
-  synchronize_lock_.unlock();
 }
 
 template <class Basis>
@@ -3351,6 +3502,7 @@ TriSurfMesh<Basis>::swap_shared_edge(typename Face::index_type f1,
   synchronized_ &= ~Mesh::ELEM_NEIGHBORS_E;
   synchronized_ &= ~Mesh::NODE_NEIGHBORS_E;
   synchronized_ &= ~Mesh::NORMALS_E;
+  synchronized_ &= ~Mesh::LOCATE_TREE_E;
   synchronize_lock_.unlock();
 
   return true;
@@ -3396,6 +3548,7 @@ TriSurfMesh<Basis>::remove_orphan_nodes()
   synchronized_ &= ~Mesh::ELEM_NEIGHBORS_E;
   synchronized_ &= ~Mesh::NODE_NEIGHBORS_E;
   synchronized_ &= ~Mesh::NORMALS_E;
+  synchronized_ &= ~Mesh::LOCATE_TREE_E;
   return rval;
 }
 
@@ -3417,6 +3570,7 @@ TriSurfMesh<Basis>::remove_face(typename Face::index_type f)
   synchronized_ &= ~Mesh::ELEM_NEIGHBORS_E;
   synchronized_ &= ~Mesh::NODE_NEIGHBORS_E;
   synchronized_ &= ~Mesh::NORMALS_E;
+  synchronized_ &= ~Mesh::LOCATE_TREE_E;
   synchronize_lock_.unlock();
 
   return rval;
@@ -3436,6 +3590,7 @@ TriSurfMesh<Basis>::add_triangle(typename Node::index_type a,
   synchronized_ &= ~Mesh::ELEM_NEIGHBORS_E;
   synchronized_ &= ~Mesh::NODE_NEIGHBORS_E;
   synchronized_ &= ~Mesh::NORMALS_E;
+  synchronized_ &= ~Mesh::LOCATE_TREE_E;
   synchronize_lock_.unlock();
   return static_cast<typename Elem::index_type>((static_cast<index_type>(faces_.size()) / 3) - 1);
 }
@@ -3708,6 +3863,56 @@ TriSurfMesh<Basis>::compute_node_grid()
 }
 
 
+template <class Basis>
+void
+TriSurfMesh<Basis>::build_node_tree()
+{
+  node_tree_.reset(new PointKDTree(points_));
+}
+
+
+template <class Basis>
+void
+TriSurfMesh<Basis>::build_elem_tree()
+{
+  typename Elem::size_type esz;  size(esz);
+
+  std::vector<Core::Geometry::BBox> boxes(esz);
+  for (index_type i = 0; i < esz; i++)
+  {
+    const index_type idx = i * 3;
+    boxes[i].extend(points_[faces_[idx]]);
+    boxes[i].extend(points_[faces_[idx+1]]);
+    boxes[i].extend(points_[faces_[idx+2]]);
+  }
+  elem_tree_.reset(new BoundingVolumeHierarchy(boxes));
+}
+
+
+template <class Basis>
+void
+TriSurfMesh<Basis>::compute_node_tree()
+{
+  build_node_tree();
+
+  synchronize_lock_.lock();
+  synchronized_ |= Mesh::NODE_LOCATE_TREE_E;
+  synchronize_lock_.unlock();
+}
+
+
+template <class Basis>
+void
+TriSurfMesh<Basis>::compute_elem_tree()
+{
+  build_elem_tree();
+
+  synchronize_lock_.lock();
+  synchronized_ |= Mesh::ELEM_LOCATE_TREE_E;
+  synchronize_lock_.unlock();
+}
+
+
 template <class Basis>
 void
 TriSurfMesh<Basis>::compute_bounding_box()
@@ -31,9 +31,11 @@
 
 #include <Core/GeometryPrimitives/Transform.h>
 #include <Core/GeometryPrimitives/BBox.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 
 void 
 VMesh::size(Node::size_type& size) const
@@ -585,6 +587,64 @@ VMesh::find_closest_elem(double&, Point&, VMesh::coords_type&,
   ASSERTFAIL("VMesh interface: find_closest_elem(dist,Point,coords,Elem::index_type,Point,maxdist) has not been implemented");
 }
 
+void
+VMesh::mfind_closest_node(std::vector<double>& dist,
+                          std::vector<Point>& result,
+                          std::vector<VMesh::Node::index_type>& idx,
+                          const std::vector<Point>& points,
+                          double maxdist) const
+{
+  const size_t num_points = points.size();
+  dist.resize(num_points);
+  result.resize(num_points);
+  idx.resize(num_points);
+
+  const size_t grain = num_points / Parallel::NumCores() + 1;
+  Parallel::ForRange(0, num_points, [&](size_t begin, size_t end)
+  {
+    VMesh::Node::index_type guess = -1;
+    for (size_t k = begin; k < end; ++k)
+    {
+      VMesh::Node::index_type i = guess;
+      const bool found = (maxdist < 0.0) ?
+        find_closest_node(dist[k], result[k], i, points[k]) :
+        find_closest_node(dist[k], result[k], i, points[k], maxdist);
+      if (found) guess = i; else i = -1;
+      idx[k] = i;
+    }
+  }, grain);
+}
+
+void
+VMesh::mfind_closest_elem(std::vector<double>& dist,
+                          std::vector<Point>& result,
+                          std::vector<VMesh::coords_type>& coords,
+                          std::vector<VMesh::Elem::index_type>& idx,
+                          const std::vector<Point>& points,
+                          double maxdist) const
+{
+  const size_t num_points = points.size();
+  dist.resize(num_points);
+  result.resize(num_points);
+  coords.resize(num_points);
+  idx.resize(num_points);
+
+  const size_t grain = num_points / Parallel::NumCores() + 1;
+  Parallel::ForRange(0, num_points, [&](size_t begin, size_t end)
+  {
+    VMesh::Elem::index_type guess = -1;
+    for (size_t k = begin; k < end; ++k)
+    {
+      VMesh::Elem::index_type i = guess;
+      const bool found = (maxdist < 0.0) ?
+        find_closest_elem(dist[k], result[k], coords[k], i, points[k]) :
+        find_closest_elem(dist[k], result[k], coords[k], i, points[k], maxdist);
+      if (found) guess = i; else i = -1;
+      idx[k] = i;
+    }
+  }, grain);
+}
+
 bool 
 VMesh::find_closest_elems(double&, Point&, VMesh::Elem::array_type&, 
                           const Point&) const
@@ -243,7 +243,8 @@ public:
     num_edges_per_elem_(0),
     num_faces_per_elem_(0),
     num_nodes_per_face_(0),
-    num_edges_per_face_(0)
+    num_edges_per_face_(0),
+    generation_(0)
   {
     /// This call is only made in DEBUG mode, to keep a record of all the
     /// objects that are being allocated and freed.
@@ -696,6 +697,24 @@ public:
   }
 
 
+  /// Vectorized versions of find_closest_node and find_closest_elem. The
+  /// points are split over the available cores and within each chunk the
+  /// previous answer is the initial guess for the next point. Points without
+  /// a node or element within maxdist get index -1; a negative maxdist
+  /// means no limit. The mesh needs to be synchronized for the search first.
+  virtual void mfind_closest_node(std::vector<double>& dist,
+                                  std::vector<Core::Geometry::Point>& result,
+                                  std::vector<VMesh::Node::index_type>& i,
+                                  const std::vector<Core::Geometry::Point>& points,
+                                  double maxdist = -1.0) const;
+
+  virtual void mfind_closest_elem(std::vector<double>& dist,
+                                  std::vector<Core::Geometry::Point>& result,
+                                  std::vector<VMesh::coords_type>& coords,
+                                  std::vector<VMesh::Elem::index_type>& i,
+                                  const std::vector<Core::Geometry::Point>& points,
+                                  double maxdist = -1.0) const;
+
   /// @todo: Need to reformulate this one, closest element can have multiple
   // intersection points
   virtual bool find_closest_elems(double& dist,
@@ -97,9 +97,8 @@ public:
 
     element_size_ = basis_->domain_size();
 
-#ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-    generation_ = mesh_->generation;
-#endif
+    // Every mesh object gets a unique id, which serves as its generation number
+    generation_ = mesh_->id();
 
     unit_vertices_.resize(num_nodes_per_elem_);
     for (size_t k=0; k < num_nodes_per_elem_; k++)
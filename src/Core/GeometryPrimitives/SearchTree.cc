@@ -0,0 +1,341 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/GeometryPrimitives/SearchTree.h>
+
+#include <algorithm>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  const int NUM_BINS = 16;
+  /// Ranges this small are always leaves.
+  const BoundingVolumeHierarchy::size_type MIN_LEAF_SIZE = 2;
+  /// Ranges larger than this are split even when the heuristic prefers a leaf.
+  const BoundingVolumeHierarchy::size_type MAX_LEAF_SIZE = 16;
+  /// Ranges of the k-d tree this small are searched linearly.
+  const PointKDTree::size_type KD_LEAF_SIZE = 8;
+
+  inline double half_area(const double* mn, const double* mx)
+  {
+    const double dx = mx[0]-mn[0], dy = mx[1]-mn[1], dz = mx[2]-mn[2];
+    return (dx*dy + dy*dz + dz*dx);
+  }
+
+  struct Bin
+  {
+    Bin() : count(0)
+    {
+      for (int k = 0; k < 3; ++k) { mn[k] = DBL_MAX; mx[k] = -DBL_MAX; }
+    }
+    void extend(const BBox& b)
+    {
+      const Point bmin = b.get_min(), bmax = b.get_max();
+      for (int k = 0; k < 3; ++k)
+      {
+        mn[k] = std::min(mn[k], bmin[k]);
+        mx[k] = std::max(mx[k], bmax[k]);
+      }
+    }
+    void extend(const Bin& b)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        mn[k] = std::min(mn[k], b.mn[k]);
+        mx[k] = std::max(mx[k], b.mx[k]);
+      }
+      count += b.count;
+    }
+    double area() const { return (count > 0 ? half_area(mn, mx) : 0.0); }
+
+    double mn[3], mx[3];
+    BoundingVolumeHierarchy::size_type count;
+  };
+}
+
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(const std::vector<BBox>& boxes)
+{
+  const size_type num = static_cast<size_type>(boxes.size());
+  if (num == 0) return;
+
+  std::vector<Point> centers(boxes.size());
+  prims_.resize(boxes.size());
+  for (size_type i = 0; i < num; ++i)
+  {
+    centers[i] = boxes[i].center();
+    prims_[i] = i;
+  }
+
+  // A binary tree with leaves of at least one primitive.
+  nodes_.reserve(2*boxes.size());
+  build(0, num, 0, boxes, centers);
+}
+
+
+BoundingVolumeHierarchy::index_type
+BoundingVolumeHierarchy::build(index_type begin, index_type end, int depth,
+                               const std::vector<BBox>& boxes,
+                               const std::vector<Point>& centers)
+{
+  const index_type node = static_cast<index_type>(nodes_.size());
+  nodes_.push_back(TreeNode());
+
+  // Bounds of the primitives and of their centers.
+  Bin bounds;
+  double cmin[3] = { DBL_MAX, DBL_MAX, DBL_MAX };
+  double cmax[3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+  for (index_type i = begin; i < end; ++i)
+  {
+    bounds.extend(boxes[prims_[i]]);
+    const Point& c = centers[prims_[i]];
+    for (int k = 0; k < 3; ++k)
+    {
+      cmin[k] = std::min(cmin[k], c[k]);
+      cmax[k] = std::max(cmax[k], c[k]);
+    }
+  }
+  for (int k = 0; k < 3; ++k)
+  {
+    nodes_[node].min_[k] = bounds.mn[k];
+    nodes_[node].max_[k] = bounds.mx[k];
+  }
+
+  const size_type num = end - begin;
+  nodes_[node].first_ = begin;
+  nodes_[node].count_ = num;
+  if (num <= MIN_LEAF_SIZE || depth >= MAX_DEPTH - 1) return (node);
+
+  // Evaluate the surface area heuristic at the bin boundaries of every axis.
+  int best_axis = -1, best_split = 0;
+  double best_cost = DBL_MAX;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    const double extent = cmax[axis] - cmin[axis];
+    if (extent <= 0.0) continue;
+    const double scale = NUM_BINS / extent;
+
+    Bin bins[NUM_BINS];
+    for (index_type i = begin; i < end; ++i)
+    {
+      const int b = std::min(NUM_BINS - 1,
+        static_cast<int>((centers[prims_[i]][axis] - cmin[axis]) * scale));
+      bins[b].extend(boxes[prims_[i]]);
+      bins[b].count++;
+    }
+
+    double right_cost[NUM_BINS];
+    Bin right;
+    for (int b = NUM_BINS - 1; b > 0; --b)
+    {
+      right.extend(bins[b]);
+      right_cost[b] = right.area() * right.count;
+    }
+
+    Bin left;
+    for (int b = 0; b < NUM_BINS - 1; ++b)
+    {
+      left.extend(bins[b]);
+      const double cost = left.area() * left.count + right_cost[b+1];
+      if (cost < best_cost)
+      {
+        best_cost = cost;
+        best_axis = axis;
+        best_split = b;
+      }
+    }
+  }
+
+  // Splitting costs a traversal step plus the expected number of primitive
+  // tests in the children, a leaf costs testing all of its primitives.
+  const double area = half_area(bounds.mn, bounds.mx);
+  const bool prefer_leaf = best_axis < 0 || area <= 0.0 || 1.0 + best_cost/area >= num;
+  if (prefer_leaf && num <= MAX_LEAF_SIZE) return (node);
+
+  index_type mid;
+  if (best_axis >= 0)
+  {
+    const double scale = NUM_BINS / (cmax[best_axis] - cmin[best_axis]);
+    const double lo = cmin[best_axis];
+    mid = std::partition(prims_.begin() + begin, prims_.begin() + end,
+      [&](index_type i)
+      {
+        return (std::min(NUM_BINS - 1, static_cast<int>((centers[i][best_axis] - lo) * scale)) <= best_split);
+      }) - prims_.begin();
+  }
+  else
+  {
+    mid = begin;
+  }
+
+  // All centers coincide or end up on one side: split the range in half.
+  if (mid == begin || mid == end) mid = begin + num/2;
+
+  nodes_[node].count_ = 0;
+  build(begin, mid, depth + 1, boxes, centers);
+  const index_type second = build(mid, end, depth + 1, boxes, centers);
+  nodes_[node].first_ = second;
+  return (node);
+}
+
+
+PointKDTree::PointKDTree(const std::vector<Point>& points) :
+  points_(points),
+  index_(points.size()),
+  axis_(points.size(), 0)
+{
+  for (size_t i = 0; i < index_.size(); ++i) index_[i] = static_cast<index_type>(i);
+  build(0, static_cast<index_type>(points_.size()));
+
+  std::vector<Point> ordered(points_.size());
+  for (size_t i = 0; i < index_.size(); ++i) ordered[i] = points[index_[i]];
+  points_.swap(ordered);
+}
+
+
+void
+PointKDTree::build(index_type begin, index_type end)
+{
+  if (end - begin <= KD_LEAF_SIZE) return;
+
+  // Split along the axis with the largest extent.
+  double mn[3] = { DBL_MAX, DBL_MAX, DBL_MAX };
+  double mx[3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+  for (index_type i = begin; i < end; ++i)
+  {
+    const Point& q = points_[index_[i]];
+    for (int k = 0; k < 3; ++k)
+    {
+      mn[k] = std::min(mn[k], q[k]);
+      mx[k] = std::max(mx[k], q[k]);
+    }
+  }
+  int axis = 0;
+  if (mx[1]-mn[1] > mx[axis]-mn[axis]) axis = 1;
+  if (mx[2]-mn[2] > mx[axis]-mn[axis]) axis = 2;
+
+  const index_type mid = begin + (end - begin)/2;
+  std::nth_element(index_.begin() + begin, index_.begin() + mid, index_.begin() + end,
+    [&](index_type a, index_type b)
+    {
+      const double ca = points_[a][axis], cb = points_[b][axis];
+      return (ca < cb || (ca == cb && a < b));
+    });
+  axis_[mid] = static_cast<unsigned char>(axis);
+
+  build(begin, mid);
+  build(mid + 1, end);
+}
+
+
+bool
+PointKDTree::closest(index_type& idx, double& dist2, const Point& p, double maxdist2) const
+{
+  idx = -1;
+  dist2 = maxdist2;
+  closest(0, static_cast<index_type>(points_.size()), p, idx, dist2);
+  return (idx >= 0);
+}
+
+
+void
+PointKDTree::closest(index_type begin, index_type end, const Point& p,
+                     index_type& idx, double& dist2) const
+{
+  auto test = [&](index_type i)
+  {
+    const double d2 = (points_[i] - p).length2();
+    if (d2 < dist2 || (d2 == dist2 && idx >= 0 && index_[i] < idx))
+    {
+      dist2 = d2;
+      idx = index_[i];
+    }
+  };
+
+  if (end - begin <= KD_LEAF_SIZE)
+  {
+    for (index_type i = begin; i < end; ++i) test(i);
+    return;
+  }
+
+  const index_type mid = begin + (end - begin)/2;
+  test(mid);
+
+  const int axis = axis_[mid];
+  const double diff = p[axis] - points_[mid][axis];
+  if (diff < 0.0)
+  {
+    closest(begin, mid, p, idx, dist2);
+    if (diff*diff <= dist2) closest(mid + 1, end, p, idx, dist2);
+  }
+  else
+  {
+    closest(mid + 1, end, p, idx, dist2);
+    if (diff*diff <= dist2) closest(begin, mid, p, idx, dist2);
+  }
+}
+
+
+void
+PointKDTree::within(std::vector<index_type>& idx, std::vector<double>& dist2,
+                    const Point& p, double maxdist2) const
+{
+  within(0, static_cast<index_type>(points_.size()), p, maxdist2, idx, dist2);
+}
+
+
+void
+PointKDTree::within(index_type begin, index_type end, const Point& p, double maxdist2,
+                    std::vector<index_type>& idx, std::vector<double>& dist2) const
+{
+  auto test = [&](index_type i)
+  {
+    const double d2 = (points_[i] - p).length2();
+    if (d2 < maxdist2)
+    {
+      idx.push_back(index_[i]);
+      dist2.push_back(d2);
+    }
+  };
+
+  if (end - begin <= KD_LEAF_SIZE)
+  {
+    for (index_type i = begin; i < end; ++i) test(i);
+    return;
+  }
+
+  const index_type mid = begin + (end - begin)/2;
+  test(mid);
+
+  const int axis = axis_[mid];
+  const double diff = p[axis] - points_[mid][axis];
+  if (diff < 0.0 || diff*diff < maxdist2) within(begin, mid, p, maxdist2, idx, dist2);
+  if (diff >= 0.0 || diff*diff < maxdist2) within(mid + 1, end, p, maxdist2, idx, dist2);
+}
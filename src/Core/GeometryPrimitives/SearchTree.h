@@ -0,0 +1,185 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef CORE_GEOMETRYPRIMITIVES_SEARCHTREE_H
+#define CORE_GEOMETRYPRIMITIVES_SEARCHTREE_H 1
+
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+
+#include <cfloat>
+#include <utility>
+#include <vector>
+
+#include <Core/GeometryPrimitives/share.h>
+
+namespace SCIRun {
+
+/// Bounding volume hierarchy over a set of primitives that are given by their
+/// bounding boxes. The tree is built top down and every node is split where
+/// the binned surface area heuristic is cheapest, so regions with small
+/// elements get deep subtrees and regions with large elements shallow ones.
+/// Unlike SearchGridT the cost of a query does not depend on how well one
+/// bin size fits all of the elements.
+class SCISHARE BoundingVolumeHierarchy
+{
+  public:
+    typedef SCIRun::index_type index_type;
+    typedef SCIRun::size_type  size_type;
+
+    /// Deepest level of the tree, nodes at this level become leaves.
+    static const int MAX_DEPTH = 64;
+
+    /// boxes[i] bounds primitive i.
+    explicit BoundingVolumeHierarchy(const std::vector<Core::Geometry::BBox>& boxes);
+
+    inline size_type num_primitives() const
+      { return static_cast<size_type>(prims_.size()); }
+    inline size_type num_tree_nodes() const
+      { return static_cast<size_type>(nodes_.size()); }
+
+    /// Nearest neighbor traversal. Subtrees are visited closest box first and
+    /// skipped once their box is further away from p than bound2, a squared
+    /// distance. visit(i, bound2) tests primitive i and lowers bound2 when it
+    /// finds something closer.
+    template <class VISITOR>
+    void closest(const Core::Geometry::Point& p, double& bound2, VISITOR& visit) const;
+
+  private:
+    struct TreeNode
+    {
+      double min_[3];
+      double max_[3];
+      /// Leaf: first entry in prims_. Interior node: index of the second
+      /// child, the first one directly follows its parent.
+      index_type first_;
+      /// Number of primitives in a leaf, 0 for an interior node.
+      size_type  count_;
+    };
+
+    index_type build(index_type begin, index_type end, int depth,
+                     const std::vector<Core::Geometry::BBox>& boxes,
+                     const std::vector<Core::Geometry::Point>& centers);
+
+    static inline double distance2(const TreeNode& n, const Core::Geometry::Point& p)
+    {
+      double d2 = 0.0;
+      for (int k = 0; k < 3; ++k)
+      {
+        const double v = p[k];
+        if (v < n.min_[k]) d2 += (n.min_[k]-v)*(n.min_[k]-v);
+        else if (v > n.max_[k]) d2 += (v-n.max_[k])*(v-n.max_[k]);
+      }
+      return (d2);
+    }
+
+    std::vector<TreeNode>   nodes_;
+    std::vector<index_type> prims_;
+};
+
+
+template <class VISITOR>
+void
+BoundingVolumeHierarchy::closest(const Core::Geometry::Point& p, double& bound2, VISITOR& visit) const
+{
+  if (nodes_.empty()) return;
+
+  // Every level pushes at most one far child, so the depth bounds the stack.
+  std::pair<index_type, double> stack[MAX_DEPTH + 1];
+  int top = 0;
+
+  index_type n = 0;
+  double d2 = distance2(nodes_[0], p);
+  for (;;)
+  {
+    if (d2 <= bound2)
+    {
+      const TreeNode& node = nodes_[n];
+      if (node.count_ > 0)
+      {
+        const index_type end = node.first_ + node.count_;
+        for (index_type k = node.first_; k < end; ++k) visit(prims_[k], bound2);
+      }
+      else
+      {
+        index_type nearc = n + 1, farc = node.first_;
+        double dnear = distance2(nodes_[nearc], p);
+        double dfar = distance2(nodes_[farc], p);
+        if (dfar < dnear) { std::swap(nearc, farc); std::swap(dnear, dfar); }
+        stack[top++] = std::make_pair(farc, dfar);
+        n = nearc; d2 = dnear;
+        continue;
+      }
+    }
+    if (top == 0) break;
+    --top;
+    n = stack[top].first;
+    d2 = stack[top].second;
+  }
+}
+
+
+/// k-d tree over a point set, for closest point and radius queries. The tree
+/// is implicit: the points are stored in tree order and the median of every
+/// range is the node that splits it.
+class SCISHARE PointKDTree
+{
+  public:
+    typedef SCIRun::index_type index_type;
+    typedef SCIRun::size_type  size_type;
+
+    explicit PointKDTree(const std::vector<Core::Geometry::Point>& points);
+
+    inline size_type size() const
+      { return static_cast<size_type>(points_.size()); }
+
+    /// Find the point closest to p that is closer than sqrt(maxdist2). Of
+    /// points at the same distance the one with the lowest index is returned.
+    bool closest(index_type& idx, double& dist2,
+                 const Core::Geometry::Point& p, double maxdist2 = DBL_MAX) const;
+
+    /// Append all points closer than sqrt(maxdist2) to p.
+    void within(std::vector<index_type>& idx, std::vector<double>& dist2,
+                const Core::Geometry::Point& p, double maxdist2) const;
+
+  private:
+    void build(index_type begin, index_type end);
+    void closest(index_type begin, index_type end, const Core::Geometry::Point& p,
+                 index_type& idx, double& dist2) const;
+    void within(index_type begin, index_type end, const Core::Geometry::Point& p,
+                double maxdist2, std::vector<index_type>& idx, std::vector<double>& dist2) const;
+
+    std::vector<Core::Geometry::Point> points_; ///< Points in tree order
+    std::vector<index_type>            index_;  ///< Original index of every point
+    std::vector<unsigned char>         axis_;   ///< Split axis of every median
+};
+
+} // End namespace SCIRun
+
+#endif
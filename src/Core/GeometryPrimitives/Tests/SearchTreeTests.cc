@@ -0,0 +1,179 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/GeometryPrimitives/SearchTree.h>
+#include <boost/random.hpp>
+#include <algorithm>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  // Clustered points: most of them in a small ball, the rest spread over a
+  // much larger box, like the very uneven element sizes of a scalp surface.
+  std::vector<Point> clusteredPoints(size_t n, unsigned seed)
+  {
+    boost::mt19937 rng(seed);
+    boost::uniform_real<> unit(0.0, 1.0);
+    std::vector<Point> points(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double scale = (i % 4 == 0) ? 100.0 : 1.0;
+      points[i] = Point(scale*unit(rng), scale*unit(rng), scale*unit(rng));
+    }
+    return points;
+  }
+
+  double boxDistance2(const BBox& b, const Point& p)
+  {
+    double d2 = 0;
+    for (int k = 0; k < 3; ++k)
+    {
+      const double v = std::max(0.0, std::max(b.get_min()[k] - p[k], p[k] - b.get_max()[k]));
+      d2 += v*v;
+    }
+    return d2;
+  }
+}
+
+TEST(PointKDTreeTests, ClosestMatchesLinearSearch)
+{
+  auto points = clusteredPoints(5000, 1);
+  PointKDTree tree(points);
+  EXPECT_EQ(5000, tree.size());
+
+  for (const auto& q : clusteredPoints(500, 2))
+  {
+    index_type expected = -1;
+    double best = DBL_MAX;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      const double d2 = (points[i] - q).length2();
+      if (d2 < best) { best = d2; expected = static_cast<index_type>(i); }
+    }
+
+    index_type idx;
+    double dist2;
+    ASSERT_TRUE(tree.closest(idx, dist2, q));
+    EXPECT_EQ(expected, idx);
+    EXPECT_EQ(best, dist2);
+  }
+}
+
+TEST(PointKDTreeTests, ClosestHonorsMaximumDistance)
+{
+  std::vector<Point> points = { Point(0,0,0), Point(10,0,0) };
+  PointKDTree tree(points);
+  index_type idx;
+  double dist2;
+  EXPECT_FALSE(tree.closest(idx, dist2, Point(5,5,0), 1.0));
+  EXPECT_TRUE(tree.closest(idx, dist2, Point(9,0,0), 4.0));
+  EXPECT_EQ(1, idx);
+}
+
+TEST(PointKDTreeTests, DuplicatePointsReturnLowestIndex)
+{
+  std::vector<Point> points(20, Point(1,1,1));
+  PointKDTree tree(points);
+  index_type idx;
+  double dist2;
+  ASSERT_TRUE(tree.closest(idx, dist2, Point(0,0,0)));
+  EXPECT_EQ(0, idx);
+}
+
+TEST(PointKDTreeTests, WithinMatchesLinearSearch)
+{
+  auto points = clusteredPoints(3000, 3);
+  PointKDTree tree(points);
+  const double r2 = 0.04;
+
+  for (const auto& q : clusteredPoints(100, 4))
+  {
+    std::vector<index_type> expected;
+    for (size_t i = 0; i < points.size(); ++i)
+      if ((points[i] - q).length2() < r2) expected.push_back(static_cast<index_type>(i));
+
+    std::vector<index_type> idx;
+    std::vector<double> dist2;
+    tree.within(idx, dist2, q, r2);
+    ASSERT_EQ(idx.size(), dist2.size());
+    std::sort(idx.begin(), idx.end());
+    EXPECT_EQ(expected, idx);
+  }
+}
+
+TEST(BoundingVolumeHierarchyTests, ClosestBoxMatchesLinearSearch)
+{
+  // Boxes of very different sizes.
+  auto corners = clusteredPoints(4000, 5);
+  std::vector<BBox> boxes;
+  for (size_t i = 0; i < corners.size(); ++i)
+  {
+    const double size = (i % 7 == 0) ? 5.0 : 0.01;
+    boxes.push_back(BBox(corners[i], corners[i] + Vector(size, size/2, size/3)));
+  }
+  BoundingVolumeHierarchy bvh(boxes);
+  EXPECT_EQ(4000, bvh.num_primitives());
+  EXPECT_LT(bvh.num_tree_nodes(), 8000);
+
+  for (const auto& q : clusteredPoints(300, 6))
+  {
+    double expected = DBL_MAX;
+    for (const auto& b : boxes) expected = std::min(expected, boxDistance2(b, q));
+
+    double bound2 = DBL_MAX;
+    size_t visited = 0;
+    auto visit = [&](index_type i, double& bound)
+    {
+      ++visited;
+      bound = std::min(bound, boxDistance2(boxes[i], q));
+    };
+    bvh.closest(q, bound2, visit);
+    EXPECT_EQ(expected, bound2);
+    EXPECT_LT(visited, boxes.size());
+  }
+}
+
+TEST(BoundingVolumeHierarchyTests, EmptyAndIdenticalBoxes)
+{
+  BoundingVolumeHierarchy empty((std::vector<BBox>()));
+  double bound2 = DBL_MAX;
+  auto never = [](index_type, double&) { FAIL(); };
+  empty.closest(Point(0,0,0), bound2, never);
+
+  std::vector<BBox> same(100, BBox(Point(0,0,0), Point(1,1,1)));
+  BoundingVolumeHierarchy bvh(same);
+  std::vector<int> seen(same.size(), 0);
+  bound2 = DBL_MAX;
+  auto count = [&](index_type i, double&) { seen[i]++; };
+  bvh.closest(Point(0.5,0.5,0.5), bound2, count);
+  EXPECT_EQ(std::vector<int>(same.size(), 1), seen);
+}
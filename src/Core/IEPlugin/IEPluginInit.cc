@@ -40,6 +40,7 @@
 #include <Core/IEPlugin/TetVolField_Plugin.h>
 #include <Core/IEPlugin/CARPMesh_Plugin.h>
 #include <Core/IEPlugin/CARPFiber_Plugin.h>
+#include <Core/IEPlugin/MappedFile_Plugin.h>
 #include <Core/ImportExport/Field/FieldIEPlugin.h>
 #include <Core/ImportExport/Matrix/MatrixIEPlugin.h>
 #include <Core/IEPlugin/IEPluginInit.h>
@@ -93,4 +94,7 @@ void IEPluginManager::Initialize()
   static FieldIEPluginLegacyAdapter TetVolFieldVtk_plugin("TetVolFieldToVtk", "*.vtk", "", nullptr, TetVolFieldToVtk_writer);
   static FieldIEPluginLegacyAdapter TriSurfFieldSTLASCII_plugin("TriSurfFieldSTL[ASCII]", "*.stl", "", TriSurfFieldSTLASCII_reader, TriSurfFieldSTLASCII_writer);
   static FieldIEPluginLegacyAdapter TriSurfFieldSTLBinary_plugin("TriSurfFieldSTL[Binary]", "*.stl", "", TriSurfFieldSTLBinary_reader, TriSurfFieldSTLBinary_writer);
+
+  static FieldIEPluginLegacyAdapter MappedField_plugin("SCIRunMappedField", "*.mfld", "*.mfld", MappedField_reader, MappedField_writer);
+  static MatrixIEPluginLegacyAdapter MappedMatrix_plugin("SCIRunMappedMatrix", "*.mmat", "*.mmat", MappedMatrix_reader, MappedMatrix_writer);
 }
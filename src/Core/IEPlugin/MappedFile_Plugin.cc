@@ -0,0 +1,353 @@
+/*
+  For more information, please see: http://software.sci.utah.edu
+
+  The MIT License
+
+  Copyright (c) 2015 Scientific Computing and Imaging Institute,
+  University of Utah.
+
+
+  Permission is hereby granted, free of charge, to any person obtaining a
+  copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+  DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/IEPlugin/MappedFile_Plugin.h>
+#include <Core/Persistent/MappedArrayFile.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/GeometryPrimitives/Tensor.h>
+#include <Core/Logging/LoggerInterface.h>
+
+#include <boost/lexical_cast.hpp>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  // metadata is a list of "key value" lines
+  std::map<std::string, std::string> parseMetadata(const std::string& metadata)
+  {
+    std::map<std::string, std::string> result;
+    std::istringstream lines(metadata);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+      auto space = line.find(' ');
+      if (space != std::string::npos)
+        result[line.substr(0, space)] = line.substr(space + 1);
+    }
+    return result;
+  }
+
+  size_t sizeOfFieldData(const FieldInformation& fi)
+  {
+    if (fi.is_double()) return sizeof(double);
+    if (fi.is_float()) return sizeof(float);
+    if (fi.is_longlong()) return sizeof(long long);
+    if (fi.is_unsigned_longlong()) return sizeof(unsigned long long);
+    if (fi.is_long()) return sizeof(long);
+    if (fi.is_unsigned_long()) return sizeof(unsigned long);
+    if (fi.is_int()) return sizeof(int);
+    if (fi.is_unsigned_int()) return sizeof(unsigned int);
+    if (fi.is_short()) return sizeof(short);
+    if (fi.is_unsigned_short()) return sizeof(unsigned short);
+    if (fi.is_char()) return sizeof(char);
+    if (fi.is_unsigned_char()) return sizeof(unsigned char);
+    if (fi.is_vector()) return sizeof(Vector);
+    if (fi.is_tensor()) return sizeof(Tensor);
+    return 0;
+  }
+}
+
+FieldHandle SCIRun::MappedField_reader(LoggerHandle pr, const char *filename)
+{
+  try
+  {
+    MappedArrayFile file(filename);
+    auto metadata = parseMetadata(file.metadata());
+    if (metadata["object"] != "field")
+    {
+      if (pr) pr->error("File does not contain a field: " + std::string(filename));
+      return nullptr;
+    }
+
+    FieldInformation fi(metadata["mesh"], metadata["meshbasis"], metadata["databasis"], metadata["data"]);
+    FieldHandle field = CreateField(fi);
+    if (!field)
+    {
+      if (pr) pr->error("Could not create a field of the stored type.");
+      return nullptr;
+    }
+    VMesh* mesh = field->vmesh();
+    VField* vfield = field->vfield();
+
+    size_t numNodes = 0;
+    const Point* points = file.get<Point>("points", numNodes);
+    mesh->resize_nodes(numNodes);
+    if (numNodes > 0)
+      std::memcpy(mesh->get_points_pointer(), points, numNodes * sizeof(Point));
+
+    if (file.has("elements"))
+    {
+      size_t count = 0;
+      const VMesh::index_type* elems = file.get<VMesh::index_type>("elements", count);
+      const size_t nodesPerElem = mesh->num_nodes_per_elem();
+      if (count % nodesPerElem != 0)
+      {
+        if (pr) pr->error("Element array does not hold a whole number of elements.");
+        return nullptr;
+      }
+      for (size_t i = 0; i < count; ++i)
+      {
+        if (elems[i] < 0 || static_cast<size_t>(elems[i]) >= numNodes)
+        {
+          if (pr) pr->error("Element array refers to a node that does not exist.");
+          return nullptr;
+        }
+      }
+      mesh->resize_elems(count / nodesPerElem);
+      if (count > 0)
+        std::memcpy(mesh->get_elems_pointer(), elems, count * sizeof(VMesh::index_type));
+    }
+
+    vfield->resize_values();
+    if (file.has("values"))
+    {
+      const size_t valueSize = sizeOfFieldData(fi);
+      size_t count = 0;
+      const void* values = file.get_raw("values", valueSize, count);
+      if (count != static_cast<size_t>(vfield->num_values()))
+      {
+        if (pr) pr->error("Number of values does not match the mesh.");
+        return nullptr;
+      }
+      if (count > 0)
+        std::memcpy(vfield->fdata_pointer(), values, count * valueSize);
+    }
+
+    return field;
+  }
+  catch (std::exception& e)
+  {
+    if (pr) pr->error(std::string("Could not read mapped field file: ") + e.what());
+    return nullptr;
+  }
+}
+
+bool SCIRun::MappedField_writer(LoggerHandle pr, FieldHandle fh, const char *filename)
+{
+  if (!fh)
+  {
+    if (pr) pr->error("No field to write.");
+    return false;
+  }
+
+  FieldInformation fi(fh);
+  const size_t valueSize = sizeOfFieldData(fi);
+  if (!fi.is_unstructuredmesh() || !fi.is_linearmesh() || fi.is_nonlineardata() || (!fi.is_nodata() && valueSize == 0))
+  {
+    if (pr) pr->error("Mapped field files support unstructured meshes with linear elements and constant or linear data.");
+    return false;
+  }
+
+  VMesh* mesh = fh->vmesh();
+  VField* field = fh->vfield();
+
+  std::ostringstream metadata;
+  metadata << "object field\n"
+    << "mesh " << fi.get_mesh_type() << "\n"
+    << "meshbasis " << fi.get_mesh_basis_type() << "\n"
+    << "databasis " << fi.get_basis_type() << "\n"
+    << "data " << fi.get_data_type() << "\n";
+
+  MappedArrayFileWriter writer(metadata.str());
+  writer.add("points", mesh->get_points_pointer(), mesh->num_nodes());
+  if (!fi.is_pointcloudmesh())
+  {
+    const VMesh::index_type* elems = mesh->get_elems_pointer();
+    if (!elems && mesh->num_elems() > 0)
+    {
+      if (pr) pr->error("Mapped field files do not support " + fi.get_mesh_type() + " yet.");
+      return false;
+    }
+    writer.add("elements", elems, mesh->num_elems() * mesh->num_nodes_per_elem());
+  }
+  if (!fi.is_nodata())
+    writer.add_raw("values", field->fdata_pointer(), valueSize, field->num_values());
+
+  if (!writer.write(filename))
+  {
+    if (pr) pr->error("Could not write file: " + std::string(filename));
+    return false;
+  }
+  return true;
+}
+
+MatrixHandle SCIRun::MappedMatrix_reader(LoggerHandle pr, const char *filename)
+{
+  try
+  {
+    MappedArrayFile file(filename);
+    auto metadata = parseMetadata(file.metadata());
+    if (metadata["object"] != "matrix")
+    {
+      if (pr) pr->error("File does not contain a matrix: " + std::string(filename));
+      return nullptr;
+    }
+    const auto type = metadata["type"];
+    const auto rows = boost::lexical_cast<size_t>(metadata["rows"]);
+    const auto cols = boost::lexical_cast<size_t>(metadata["columns"]);
+
+    size_t count = 0;
+    const double* values = file.get<double>("values", count);
+
+    if (type == "dense" || type == "column")
+    {
+      if (count != rows * cols || (type == "column" && cols != 1))
+      {
+        if (pr) pr->error("Number of values does not match the matrix size.");
+        return nullptr;
+      }
+      if (type == "column")
+      {
+        auto column = boost::make_shared<DenseColumnMatrix>(rows);
+        if (count > 0) std::memcpy(column->data(), values, count * sizeof(double));
+        return column;
+      }
+      auto dense = boost::make_shared<DenseMatrix>(rows, cols);
+      if (count > 0) std::memcpy(dense->data(), values, count * sizeof(double));
+      return dense;
+    }
+
+    if (type == "sparse")
+    {
+      size_t numRows = 0, numColumns = 0;
+      const index_type* rowStart = file.get<index_type>("rows", numRows);
+      const index_type* columns = file.get<index_type>("columns", numColumns);
+      if (numRows != rows + 1 || numColumns != count || static_cast<size_t>(rowStart[rows]) != count)
+      {
+        if (pr) pr->error("Sparse matrix arrays do not match the matrix size.");
+        return nullptr;
+      }
+      for (size_t r = 0; r < rows; ++r)
+      {
+        if (rowStart[r] > rowStart[r + 1])
+        {
+          if (pr) pr->error("Sparse matrix row array is not sorted.");
+          return nullptr;
+        }
+      }
+      for (size_t j = 0; j < count; ++j)
+      {
+        if (columns[j] < 0 || static_cast<size_t>(columns[j]) >= cols)
+        {
+          if (pr) pr->error("Sparse matrix column index out of bounds.");
+          return nullptr;
+        }
+      }
+
+      // fill the compressed storage directly instead of going through triplets
+      auto sparse = boost::make_shared<SparseRowMatrix>(rows, cols);
+      sparse->resizeNonZeros(count);
+      std::memcpy(sparse->outerIndexPtr(), rowStart, (rows + 1) * sizeof(index_type));
+      if (count > 0)
+      {
+        std::memcpy(sparse->innerIndexPtr(), columns, count * sizeof(index_type));
+        std::memcpy(sparse->valuePtr(), values, count * sizeof(double));
+      }
+      return sparse;
+    }
+
+    if (pr) pr->error("Unknown matrix type in mapped matrix file: " + type);
+    return nullptr;
+  }
+  catch (std::exception& e)
+  {
+    if (pr) pr->error(std::string("Could not read mapped matrix file: ") + e.what());
+    return nullptr;
+  }
+}
+
+bool SCIRun::MappedMatrix_writer(LoggerHandle pr, MatrixHandle mh, const char *filename)
+{
+  if (!mh)
+  {
+    if (pr) pr->error("No matrix to write.");
+    return false;
+  }
+
+  std::ostringstream metadata;
+  metadata << "object matrix\n" << "rows " << mh->nrows() << "\n" << "columns " << mh->ncols() << "\n";
+
+  bool written = false;
+  if (matrixIs::sparse(mh))
+  {
+    auto sparse = castMatrix::toSparse(mh);
+    if (!sparse->isCompressed())
+    {
+      sparse = boost::make_shared<SparseRowMatrix>(*sparse);
+      sparse->makeCompressed();
+    }
+    metadata << "type sparse\n";
+    MappedArrayFileWriter writer(metadata.str());
+    writer.add("rows", sparse->outerIndexPtr(), sparse->nrows() + 1);
+    writer.add("columns", sparse->innerIndexPtr(), sparse->nonZeros());
+    writer.add("values", sparse->valuePtr(), sparse->nonZeros());
+    written = writer.write(filename);
+  }
+  else if (matrixIs::column(mh))
+  {
+    auto column = castMatrix::toColumn(mh);
+    metadata << "type column\n";
+    MappedArrayFileWriter writer(metadata.str());
+    writer.add("values", column->data(), column->nrows());
+    written = writer.write(filename);
+  }
+  else if (matrixIs::dense(mh))
+  {
+    auto dense = castMatrix::toDense(mh);
+    metadata << "type dense\n";
+    MappedArrayFileWriter writer(metadata.str());
+    writer.add("values", dense->data(), dense->nrows() * dense->ncols());
+    written = writer.write(filename);
+  }
+  else
+  {
+    if (pr) pr->error("Mapped matrix files support dense, column and sparse row matrices.");
+    return false;
+  }
+
+  if (!written)
+  {
+    if (pr) pr->error("Could not write file: " + std::string(filename));
+    return false;
+  }
+  return true;
+}
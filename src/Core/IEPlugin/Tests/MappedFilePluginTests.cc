@@ -0,0 +1,224 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Core/IEPlugin/MappedFile_Plugin.h>
+#include <Core/Persistent/MappedArrayFile.h>
+#include <Core/Persistent/Persistent.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Testing/Utils/SCIRunUnitTests.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+#include <chrono>
+#include <fstream>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  std::string outputFile(const std::string& name)
+  {
+    return (TestResources::rootDir() / "TransientOutput" / name).string();
+  }
+
+  void expectSameMesh(FieldHandle expected, FieldHandle actual)
+  {
+    VMesh* e = expected->vmesh();
+    VMesh* a = actual->vmesh();
+    ASSERT_EQ(e->num_nodes(), a->num_nodes());
+    ASSERT_EQ(e->num_elems(), a->num_elems());
+    for (VMesh::Node::index_type i(0); i < e->num_nodes(); ++i)
+    {
+      Point pe, pa;
+      e->get_point(pe, i);
+      a->get_point(pa, i);
+      EXPECT_EQ(pe, pa);
+    }
+    for (VMesh::Elem::index_type i(0); i < e->num_elems(); ++i)
+    {
+      VMesh::Node::array_type ne, na;
+      e->get_nodes(ne, i);
+      a->get_nodes(na, i);
+      EXPECT_EQ(ne, na);
+    }
+  }
+}
+
+TEST(MappedFilePluginTests, TetVolFieldRoundTrip)
+{
+  FieldHandle field = CubeTetVolLinearBasis(DOUBLE_E);
+  VField* vfield = field->vfield();
+  for (VMesh::index_type i = 0; i < vfield->num_values(); ++i)
+    vfield->set_value(0.5 * i, i);
+
+  const std::string file = outputFile("cube.mfld");
+  ASSERT_TRUE(MappedField_writer(nullptr, field, file.c_str()));
+  FieldHandle read = MappedField_reader(nullptr, file.c_str());
+  ASSERT_TRUE(read != nullptr);
+
+  EXPECT_EQ(FieldInformation(field).get_field_type_id(), FieldInformation(read).get_field_type_id());
+  expectSameMesh(field, read);
+  ASSERT_EQ(vfield->num_values(), read->vfield()->num_values());
+  for (VMesh::index_type i = 0; i < vfield->num_values(); ++i)
+  {
+    double value;
+    read->vfield()->get_value(value, i);
+    EXPECT_EQ(0.5 * i, value);
+  }
+}
+
+TEST(MappedFilePluginTests, TriSurfVectorFieldRoundTrip)
+{
+  FieldHandle field = CubeTriSurfConstantBasis(VECTOR_E);
+  VField* vfield = field->vfield();
+  for (VMesh::index_type i = 0; i < vfield->num_values(); ++i)
+    vfield->set_value(Vector(i, -i, 2 * i), i);
+
+  const std::string file = outputFile("cube_vectors.mfld");
+  ASSERT_TRUE(MappedField_writer(nullptr, field, file.c_str()));
+  FieldHandle read = MappedField_reader(nullptr, file.c_str());
+  ASSERT_TRUE(read != nullptr);
+
+  expectSameMesh(field, read);
+  for (VMesh::index_type i = 0; i < vfield->num_values(); ++i)
+  {
+    Vector value;
+    read->vfield()->get_value(value, i);
+    EXPECT_EQ(Vector(i, -i, 2 * i), value);
+  }
+}
+
+TEST(MappedFilePluginTests, LatVolIsRejected)
+{
+  EXPECT_FALSE(MappedField_writer(nullptr, CreateEmptyLatVol(), outputFile("latvol.mfld").c_str()));
+}
+
+TEST(MappedFilePluginTests, DenseMatrixRoundTrip)
+{
+  MatrixHandle m = boost::make_shared<DenseMatrix>(DenseMatrix::Random(7, 5));
+  const std::string file = outputFile("dense.mmat");
+  ASSERT_TRUE(MappedMatrix_writer(nullptr, m, file.c_str()));
+  auto read = MappedMatrix_reader(nullptr, file.c_str());
+  ASSERT_TRUE(matrixIs::dense(read));
+  EXPECT_EQ(*castMatrix::toDense(m), *castMatrix::toDense(read));
+}
+
+TEST(MappedFilePluginTests, ColumnMatrixRoundTrip)
+{
+  auto column = boost::make_shared<DenseColumnMatrix>(4);
+  *column << 1, 2, 3, 4;
+  const std::string file = outputFile("column.mmat");
+  ASSERT_TRUE(MappedMatrix_writer(nullptr, column, file.c_str()));
+  auto read = MappedMatrix_reader(nullptr, file.c_str());
+  ASSERT_TRUE(matrixIs::column(read));
+  EXPECT_EQ(*column, *castMatrix::toColumn(read));
+}
+
+TEST(MappedFilePluginTests, SparseMatrixRoundTrip)
+{
+  DenseMatrix dense(DenseMatrix::Zero(6, 8));
+  dense(0, 1) = 1; dense(2, 7) = -3; dense(3, 3) = 4.5; dense(5, 0) = 2;
+  MatrixHandle sparse = toSparseHandle(dense);
+  const std::string file = outputFile("sparse.mmat");
+  ASSERT_TRUE(MappedMatrix_writer(nullptr, sparse, file.c_str()));
+  auto read = MappedMatrix_reader(nullptr, file.c_str());
+  ASSERT_TRUE(matrixIs::sparse(read));
+  EXPECT_EQ(4, castMatrix::toSparse(read)->nonZeros());
+  EXPECT_EQ(dense, *makeDense(*castMatrix::toSparse(read)));
+}
+
+TEST(MappedFilePluginTests, OtherFilesAreRejected)
+{
+  const std::string file = outputFile("not_mapped.mmat");
+  {
+    std::ofstream out(file.c_str());
+    out << "1 2 3\n4 5 6\n";
+  }
+  EXPECT_FALSE(MappedMatrix_reader(nullptr, file.c_str()));
+  EXPECT_FALSE(MappedField_reader(nullptr, file.c_str()));
+  EXPECT_THROW(MappedArrayFile mapped(file), std::exception);
+}
+
+TEST(MappedFilePluginTests, DISABLED_ReadBenchmark)
+{
+  const int n = 100;
+  FieldInformation fi("TetVolMesh", 1, 1, "double");
+  FieldHandle field = CreateField(fi);
+  VMesh* mesh = field->vmesh();
+  for (int k = 0; k < n; ++k)
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < n; ++i)
+        mesh->add_point(Point(i, j, k));
+  VMesh::Node::array_type tet(4);
+  for (int k = 0; k + 1 < n; ++k)
+    for (int j = 0; j + 1 < n; ++j)
+      for (int i = 0; i + 1 < n; ++i)
+        for (int t = 0; t < 5; ++t)
+        {
+          const int node = i + n * (j + n * k);
+          tet[0] = node; tet[1] = node + 1; tet[2] = node + n; tet[3] = node + n * n + t % 2;
+          mesh->add_elem(tet);
+        }
+  field->vfield()->resize_values();
+
+  const std::string pioFile = outputFile("benchmark.fld");
+  const std::string mappedFile = outputFile("benchmark.mfld");
+  {
+    PiostreamPtr stream = auto_ostream(pioFile, "Binary");
+    Pio(*stream, field);
+  }
+  ASSERT_TRUE(MappedField_writer(nullptr, field, mappedFile.c_str()));
+
+  auto start = std::chrono::steady_clock::now();
+  FieldHandle pioField;
+  {
+    PiostreamPtr stream = auto_istream(pioFile);
+    Pio(*stream, pioField);
+  }
+  auto pio = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  FieldHandle mappedField = MappedField_reader(nullptr, mappedFile.c_str());
+  auto mapped = std::chrono::steady_clock::now() - start;
+
+  ASSERT_TRUE(pioField != nullptr);
+  ASSERT_TRUE(mappedField != nullptr);
+  EXPECT_EQ(pioField->vmesh()->num_elems(), mappedField->vmesh()->num_elems());
+  std::cout << "BinaryPiostream: " << std::chrono::duration<double>(pio).count() << " s, "
+    << "mapped: " << std::chrono::duration<double>(mapped).count() << " s" << std::endl;
+}
@@ -36,17 +36,33 @@ using namespace SCIRun::Core::Logging;
 
 LegacyLoggerInterface::~LegacyLoggerInterface() {}
 
-ScopedTimeRemarker::ScopedTimeRemarker(LegacyLoggerInterface* log, const std::string& label) : log_(log), label_(label)
+namespace
+{
+  double secondsSince(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+ScopedTimeRemarker::ScopedTimeRemarker(LegacyLoggerInterface* log, const std::string& label) : log_(log), label_(label),
+  start_(std::chrono::steady_clock::now())
+#ifndef SCIRUN_DISABLE_TRACING
+  , trace_("timer", label)
+#endif
 {}
 
 ScopedTimeRemarker::~ScopedTimeRemarker()
 {
   std::ostringstream perf;
-  perf << label_ <<  " took " << timer_.elapsed() << " seconds." << std::endl;
+  perf << label_ <<  " took " << secondsSince(start_) << " seconds." << std::endl;
   log_->status(perf.str());
 }
 
-ScopedTimeLogger::ScopedTimeLogger(const std::string& label, bool shouldLog): label_(label), shouldLog_(shouldLog)
+ScopedTimeLogger::ScopedTimeLogger(const std::string& label, bool shouldLog): label_(label), shouldLog_(shouldLog),
+  start_(std::chrono::steady_clock::now())
+#ifndef SCIRUN_DISABLE_TRACING
+  , trace_("timer", label)
+#endif
 {
   if (shouldLog_)
     LOG_DEBUG("{} starting.", label_);
@@ -54,7 +70,7 @@ ScopedTimeLogger::ScopedTimeLogger(const std::string& label, bool shouldLog): la
 
 ScopedTimeLogger::~ScopedTimeLogger()
 {
-  auto time = timer_.elapsed();
+  auto time = secondsSince(start_);
   if (shouldLog_)
     LOG_DEBUG("{} took {} seconds.", label_, time);
 }
@@ -31,8 +31,9 @@
 #define CORE_LOGGING_SCOPEDTIMEREMARKER_H
 
 #include <string>
-#include <boost/timer.hpp>
+#include <chrono>
 #include <Core/Logging/LoggerFwd.h>
+#include <Core/Logging/Trace.h>
 #include <Core/Logging/share.h>
 
 namespace SCIRun
@@ -41,6 +42,7 @@ namespace SCIRun
   {
     namespace Logging
     {
+      /// Both report wall-clock time and also show up as "timer" spans when tracing is on.
       class SCISHARE ScopedTimeRemarker
       {
       public:
@@ -49,7 +51,10 @@ namespace SCIRun
       private:
         LegacyLoggerInterface* log_;
         std::string label_;
-        boost::timer timer_;
+        std::chrono::steady_clock::time_point start_;
+#ifndef SCIRUN_DISABLE_TRACING
+        ScopedTrace trace_;
+#endif
       };
 
       class SCISHARE ScopedTimeLogger
@@ -60,7 +65,10 @@ namespace SCIRun
       private:
         std::string label_;
         bool shouldLog_;
-        boost::timer timer_;
+        std::chrono::steady_clock::time_point start_;
+#ifndef SCIRUN_DISABLE_TRACING
+        ScopedTrace trace_;
+#endif
       };
     }
   }
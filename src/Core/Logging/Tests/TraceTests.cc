@@ -0,0 +1,137 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Core/Logging/Trace.h>
+#include <sstream>
+#include <set>
+#include <thread>
+
+using namespace SCIRun::Core::Logging;
+
+TEST(TraceTests, NothingRecordedWhileStopped)
+{
+  TraceRecorder::Instance().clear();
+  {
+    SCIRUN_TRACE_SCOPE("test", "ignored");
+  }
+  EXPECT_TRUE(TraceRecorder::Instance().events().empty());
+}
+
+// The rest check recorded spans, which SCIRUN_TRACE_SCOPE does not emit when tracing is compiled out.
+#ifndef SCIRUN_DISABLE_TRACING
+
+namespace
+{
+  struct TracingScope
+  {
+    TracingScope() { TraceRecorder::Instance().clear(); TraceRecorder::Instance().start(); }
+    ~TracingScope() { TraceRecorder::Instance().stop(); TraceRecorder::Instance().clear(); }
+  };
+}
+
+TEST(TraceTests, NestedScopesAreContained)
+{
+  TracingScope tracing;
+  {
+    SCIRUN_TRACE_SCOPE("test", "outer");
+    {
+      SCIRUN_TRACE_SCOPE("test", "inner", "some detail");
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+  }
+
+  auto events = TraceRecorder::Instance().events();
+  ASSERT_EQ(2, events.size());
+  const auto& outer = events[0];
+  const auto& inner = events[1];
+  EXPECT_EQ("outer", outer.name);
+  EXPECT_EQ("inner", inner.name);
+  EXPECT_EQ("some detail", inner.detail);
+  EXPECT_GE(inner.duration, 2000000);
+  EXPECT_LE(outer.start, inner.start);
+  EXPECT_GE(outer.start + outer.duration, inner.start + inner.duration);
+  EXPECT_EQ(outer.thread, inner.thread);
+}
+
+TEST(TraceTests, ThreadsGetSeparateBuffers)
+{
+  TracingScope tracing;
+  const int numThreads = 4, perThread = 100;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t)
+    threads.emplace_back([]() { for (int i = 0; i < perThread; ++i) { SCIRUN_TRACE_SCOPE("test", std::string("work")); } });
+  for (auto& t : threads)
+    t.join();
+
+  auto events = TraceRecorder::Instance().events();
+  ASSERT_EQ(numThreads * perThread, events.size());
+  std::set<int> tids;
+  for (const auto& e : events)
+    tids.insert(e.thread);
+  EXPECT_EQ(numThreads, tids.size());
+}
+
+TEST(TraceTests, RingBufferKeepsNewestEvents)
+{
+  TracingScope tracing;
+  std::thread worker([]()
+  {
+    for (size_t i = 0; i < TraceRecorder::EventsPerThread + 10; ++i)
+    {
+      SCIRUN_TRACE_SCOPE("test", std::to_string(i));
+    }
+  });
+  worker.join();
+
+  auto events = TraceRecorder::Instance().events();
+  ASSERT_EQ(TraceRecorder::EventsPerThread, events.size());
+  EXPECT_EQ("10", events.front().name);
+  EXPECT_EQ(std::to_string(TraceRecorder::EventsPerThread + 9), events.back().name);
+}
+
+TEST(TraceTests, WritesChromeTraceEvents)
+{
+  TracingScope tracing;
+  {
+    SCIRUN_TRACE_SCOPE("module", std::string("ReadField:3"));
+    SCIRUN_TRACE_SCOPE("port", "send", "Field \"out\"");
+  }
+
+  std::ostringstream json;
+  TraceRecorder::Instance().writeChromeTrace(json);
+  auto str = json.str();
+
+  EXPECT_EQ(0, str.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, str.find("\"name\":\"ReadField:3\",\"cat\":\"module\",\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, str.find("\"args\":{\"detail\":\"Field \\\"out\\\"\"}"));
+  EXPECT_NE(std::string::npos, str.find("\"ph\":\"M\""));
+  EXPECT_EQ("]}\n", str.substr(str.size() - 3));
+}
+
+#endif
@@ -0,0 +1,248 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Core/Logging/Trace.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+using namespace SCIRun::Core::Logging;
+
+CORE_SINGLETON_IMPLEMENTATION(TraceRecorder)
+
+const size_t TraceRecorder::EventsPerThread;
+
+struct TraceRecorder::ThreadBuffer
+{
+  explicit ThreadBuffer(int id) : thread(id) {}
+  std::mutex lock;
+  std::vector<TraceEvent> ring;
+  size_t written{ 0 };
+  const int thread;
+};
+
+TraceRecorder::TraceRecorder() : epoch_(std::chrono::steady_clock::now())
+{
+}
+
+void TraceRecorder::start()
+{
+  enabled_ = true;
+}
+
+void TraceRecorder::stop()
+{
+  enabled_ = false;
+}
+
+void TraceRecorder::clear()
+{
+  std::lock_guard<std::mutex> g(registryLock_);
+  for (auto& buffer : buffers_)
+  {
+    std::lock_guard<std::mutex> b(buffer->lock);
+    buffer->ring.clear();
+    buffer->written = 0;
+  }
+}
+
+long long TraceRecorder::now() const
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count();
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::localBuffer()
+{
+  // Buffers outlive their threads so spans from finished workers still get written.
+  thread_local ThreadBuffer* buffer = nullptr;
+  if (!buffer)
+  {
+    std::lock_guard<std::mutex> g(registryLock_);
+    buffers_.push_back(std::make_shared<ThreadBuffer>(static_cast<int>(buffers_.size())));
+    buffer = buffers_.back().get();
+  }
+  return *buffer;
+}
+
+void TraceRecorder::record(const char* category, const std::string& name, const std::string& detail, long long start, long long end)
+{
+  auto& buffer = localBuffer();
+  // only contended while events() is copying this buffer
+  std::lock_guard<std::mutex> g(buffer.lock);
+  if (buffer.ring.size() < EventsPerThread)
+    buffer.ring.push_back({ category, name, detail, start, end - start, buffer.thread });
+  else
+  {
+    auto& event = buffer.ring[buffer.written % EventsPerThread];
+    event.category = category;
+    event.name = name;
+    event.detail = detail;
+    event.start = start;
+    event.duration = end - start;
+  }
+  ++buffer.written;
+}
+
+std::vector<TraceEvent> TraceRecorder::events() const
+{
+  std::vector<TraceEvent> all;
+  {
+    std::lock_guard<std::mutex> g(registryLock_);
+    for (const auto& buffer : buffers_)
+    {
+      std::lock_guard<std::mutex> b(buffer->lock);
+      // once the ring has wrapped, its oldest event is the next one to be overwritten
+      const auto oldest = buffer->ring.begin() + (buffer->ring.size() < EventsPerThread ? 0 : buffer->written % EventsPerThread);
+      all.insert(all.end(), oldest, buffer->ring.end());
+      all.insert(all.end(), buffer->ring.begin(), oldest);
+    }
+  }
+  // each ring is already in order, so stable_sort keeps events with equal timestamps in recording order
+  std::stable_sort(all.begin(), all.end(), [](const TraceEvent& a, const TraceEvent& b) { return a.start < b.start; });
+  return all;
+}
+
+namespace
+{
+  void writeJsonString(std::ostream& out, const std::string& str)
+  {
+    out << '"';
+    for (auto c : str)
+    {
+      switch (c)
+      {
+      case '"': out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\n': out << "\\n"; break;
+      case '\t': out << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+          out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+        else
+          out << c;
+      }
+    }
+    out << '"';
+  }
+
+  // trace-event timestamps are microseconds; keep the nanosecond digits as a fraction
+  void writeMicroseconds(std::ostream& out, long long nanoseconds)
+  {
+    out << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+  }
+}
+
+void TraceRecorder::writeChromeTrace(std::ostream& out) const
+{
+  const auto all = events();
+  int threads;
+  {
+    std::lock_guard<std::mutex> g(registryLock_);
+    threads = static_cast<int>(buffers_.size());
+  }
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (int t = 0; t < threads; ++t)
+  {
+    if (!first)
+      out << ',';
+    first = false;
+    out << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+      << ",\"args\":{\"name\":\"thread " << t << "\"}}";
+  }
+  for (const auto& event : all)
+  {
+    if (!first)
+      out << ',';
+    first = false;
+    out << "\n{\"name\":";
+    writeJsonString(out, event.name);
+    out << ",\"cat\":";
+    writeJsonString(out, event.category ? event.category : "");
+    out << ",\"ph\":\"X\",\"ts\":";
+    writeMicroseconds(out, event.start);
+    out << ",\"dur\":";
+    writeMicroseconds(out, event.duration);
+    out << ",\"pid\":1,\"tid\":" << event.thread;
+    if (!event.detail.empty())
+    {
+      out << ",\"args\":{\"detail\":";
+      writeJsonString(out, event.detail);
+      out << '}';
+    }
+    out << '}';
+  }
+  out << "\n]}\n";
+}
+
+bool TraceRecorder::writeChromeTrace(const std::string& filename) const
+{
+  std::ofstream out(filename);
+  if (!out)
+    return false;
+  writeChromeTrace(out);
+  return static_cast<bool>(out);
+}
+
+ScopedTrace::ScopedTrace(const char* category, const char* name) :
+  category_(category), staticName_(name), start_(0), active_(TraceRecorder::Instance().enabled())
+{
+  if (active_)
+    start_ = TraceRecorder::Instance().now();
+}
+
+ScopedTrace::ScopedTrace(const char* category, const std::string& name) :
+  category_(category), staticName_(nullptr), start_(0), active_(TraceRecorder::Instance().enabled())
+{
+  if (active_)
+  {
+    name_ = name;
+    start_ = TraceRecorder::Instance().now();
+  }
+}
+
+ScopedTrace::ScopedTrace(const char* category, const char* name, const std::string& detail) :
+  category_(category), staticName_(name), start_(0), active_(TraceRecorder::Instance().enabled())
+{
+  if (active_)
+  {
+    detail_ = detail;
+    start_ = TraceRecorder::Instance().now();
+  }
+}
+
+ScopedTrace::~ScopedTrace()
+{
+  if (active_)
+  {
+    auto& recorder = TraceRecorder::Instance();
+    recorder.record(category_, staticName_ ? std::string(staticName_) : name_, detail_, start_, recorder.now());
+  }
+}
@@ -0,0 +1,123 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// @todo Documentation Core/Logging/Trace.h
+
+#ifndef CORE_LOGGING_TRACE_H
+#define CORE_LOGGING_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <Core/Utils/Singleton.h>
+#include <Core/Logging/share.h>
+
+namespace SCIRun
+{
+  namespace Core
+  {
+    namespace Logging
+    {
+      /// One completed span. Times are steady-clock nanoseconds since the recorder started.
+      struct SCISHARE TraceEvent
+      {
+        const char* category;
+        std::string name;
+        std::string detail;
+        long long start;
+        long long duration;
+        int thread;
+      };
+
+      /// Collects wall-clock spans from any thread into per-thread ring buffers and
+      /// writes them out in the Chrome trace-event format (chrome://tracing, Perfetto).
+      /// Recording is off until start() is called; while off, a trace point costs one
+      /// relaxed atomic load.
+      class SCISHARE TraceRecorder final
+      {
+        CORE_SINGLETON(TraceRecorder)
+      public:
+        TraceRecorder();
+        void start();
+        void stop();
+        void clear();
+        bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+        long long now() const;
+        void record(const char* category, const std::string& name, const std::string& detail, long long start, long long end);
+
+        /// Oldest events are overwritten once a thread has recorded this many.
+        static const size_t EventsPerThread = 1 << 15;
+
+        std::vector<TraceEvent> events() const;
+        void writeChromeTrace(std::ostream& out) const;
+        bool writeChromeTrace(const std::string& filename) const;
+      private:
+        struct ThreadBuffer;
+        ThreadBuffer& localBuffer();
+
+        std::atomic<bool> enabled_{ false };
+        const std::chrono::steady_clock::time_point epoch_;
+        mutable std::mutex registryLock_;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+      };
+
+      class SCISHARE ScopedTrace
+      {
+      public:
+        ScopedTrace(const char* category, const char* name);
+        ScopedTrace(const char* category, const std::string& name);
+        ScopedTrace(const char* category, const char* name, const std::string& detail);
+        ~ScopedTrace();
+        ScopedTrace(const ScopedTrace&) = delete;
+        ScopedTrace& operator=(const ScopedTrace&) = delete;
+      private:
+        const char* category_;
+        const char* staticName_;
+        std::string name_, detail_;
+        long long start_;
+        bool active_;
+      };
+    }
+  }
+}
+
+#define SCIRUN_TRACE_CONCAT_IMPL(a, b) a##b
+#define SCIRUN_TRACE_CONCAT(a, b) SCIRUN_TRACE_CONCAT_IMPL(a, b)
+
+#ifndef SCIRUN_DISABLE_TRACING
+#define SCIRUN_TRACE_SCOPE(...) SCIRun::Core::Logging::ScopedTrace SCIRUN_TRACE_CONCAT(scirunTrace_, __LINE__)(__VA_ARGS__)
+#else
+#define SCIRUN_TRACE_SCOPE(...)
+#endif
+
+#endif
@@ -183,6 +183,9 @@ class SCISHARE NewArrayMathEngine : public Parser, public ArrayMathInterpreter
     // Run the expressions in parallel
     bool run();
 
+    // Whether the last run used the fused kernel instead of the interpreter
+    bool ran_fused_kernel() const { return (mprogram_ && mprogram_->has_fused_kernel()); }
+
     // Extract handles to the results
     bool get_field(const std::string& name, FieldHandle& field);
     bool get_matrix(const std::string& name, Core::Datatypes::MatrixHandle& matrix);
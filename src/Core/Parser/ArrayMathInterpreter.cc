@@ -1188,6 +1188,15 @@ ArrayMathInterpreter::translate(ParserProgramHandle& pprogram,
     }
   }
 
+  // Replace the sequential functions by a fused kernel if possible, the
+  // functions above remain as the fallback
+  mprogram->set_fused_kernel(ArrayMathFusedKernelHandle());
+  if (use_fused_kernel_)
+  {
+    ArrayMathFusedKernelHandle kernel(new ArrayMathFusedKernel(buffer_size));
+    if (kernel->compile(pprogram,*mprogram)) mprogram->set_fused_kernel(kernel);
+  }
+
   return (true);
 }
 
@@ -1512,6 +1521,12 @@ ArrayMathProgram::run_single(size_t& error_line)
 bool
 ArrayMathProgram::run_sequential(size_t& error_line)
 {  
+  if (fused_kernel_)
+  {
+    fused_kernel_->run(array_size_);
+    return (true);
+  }
+
   error_line_.resize(num_proc_,0);
   success_.resize(num_proc_,true);
   
@@ -39,6 +39,7 @@
 #include <Core/Containers/StackBasedVector.h>
 
 #include <Core/Parser/Parser.h>
+#include <Core/Parser/ArrayMathKernel.h>
 
 #include <boost/function.hpp>
 #include <boost/variant.hpp>
@@ -418,6 +419,11 @@ class SCISHARE ArrayMathProgramSource {
     
     void set_parser_program(ParserProgramHandle handle) { pprogram_ = handle; }      
     ParserProgramHandle get_parser_program() { return (pprogram_); }
+
+    // If set, the sequential part of the program is run by the fused kernel
+    // instead of by the list of sequential functions
+    void set_fused_kernel(ArrayMathFusedKernelHandle kernel) { fused_kernel_ = kernel; }
+    bool has_fused_kernel() const { return (fused_kernel_ != 0); }
                             
   private:    
   
@@ -447,6 +453,8 @@ class SCISHARE ArrayMathProgramSource {
     std::vector<std::vector<ArrayMathProgramCodePtr> > sequential_functions_;
     
     ParserProgramHandle pprogram_;
+
+    ArrayMathFusedKernelHandle fused_kernel_;
     
     // For parallel code
   private:
@@ -462,6 +470,8 @@ class SCISHARE ArrayMathProgramSource {
 class SCISHARE ArrayMathInterpreter {
 
   public:
+    ArrayMathInterpreter() : use_fused_kernel_(true) {}
+
     // The interpreter Creates executable code from the parsed code
     // The first step is setting the data sources and sinks
 
@@ -546,6 +556,12 @@ class SCISHARE ArrayMathInterpreter {
     bool translate(ParserProgramHandle& pprogram,
                    ArrayMathProgramHandle& mprogram,
                    std::string& error);
+
+    // By default translate compiles the sequential part of the program into
+    // a fused kernel when all its functions support it. Switching this off
+    // forces the interpreter to be used.
+    void set_use_fused_kernel(bool use) { use_fused_kernel_ = use; }
+    bool get_use_fused_kernel() const { return (use_fused_kernel_); }
   
   
     //------------------------------------------------------------------------
@@ -557,7 +573,9 @@ class SCISHARE ArrayMathInterpreter {
     // Step 4: Run the code
   
     bool run(ArrayMathProgramHandle& mprogram,std::string& error);
-    
+
+  private:
+    bool use_fused_kernel_;
 };
 
 }
@@ -0,0 +1,464 @@
+//  
+//  For more information, please see: http://software.sci.utah.edu
+//  
+//  The MIT License
+//  
+//  Copyright (c) 2015 Scientific Computing and Imaging Institute,
+//  University of Utah.
+//  
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//  
+//  The above copyright notice and this permission notice shall be included
+//  in all copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//  
+
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+
+#include <Core/Parser/ArrayMathKernel.h>
+#include <Core/Parser/ArrayMathInterpreter.h>
+
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace {
+
+// Scalar functions that can be fused. These need to produce exactly the
+// same values as their counterparts in ArrayMathFunctionScalar.cc
+
+double abs_s(double x) { return (x < 0 ? -x : x); }
+double exp_s(double x) { return (::exp(x)); }
+double sqrt_s(double x) { return (::sqrt(x)); }
+double log_s(double x) { return (::log(x)); }
+double sin_s(double x) { return (::sin(x)); }
+double cos_s(double x) { return (::cos(x)); }
+double tan_s(double x) { return (::tan(x)); }
+double sinh_s(double x) { return (::sinh(x)); }
+double cosh_s(double x) { return (::cosh(x)); }
+double asin_s(double x) { return (::asin(x)); }
+double acos_s(double x) { return (::acos(x)); }
+double atan_s(double x) { return (::atan(x)); }
+double floor_s(double x) { return (::floor(x)); }
+double ceil_s(double x) { return (::ceil(x)); }
+
+double pow_ss(double x, double y) { return (::pow(x,y)); }
+double atan2_ss(double x, double y) { return (::atan2(x,y)); }
+double le_ss(double x, double y) { return (x <= y ? 1.0 : 0.0); }
+double ge_ss(double x, double y) { return (x >= y ? 1.0 : 0.0); }
+double ls_ss(double x, double y) { return (x < y ? 1.0 : 0.0); }
+double gt_ss(double x, double y) { return (x > y ? 1.0 : 0.0); }
+double eq_ss(double x, double y) { return (x == y ? 1.0 : 0.0); }
+double neq_ss(double x, double y) { return (x != y ? 1.0 : 0.0); }
+double and_ss(double x, double y) { return (x && y); }
+double or_ss(double x, double y) { return (x || y); }
+double min_ss(double x, double y) { return (x < y ? x : y); }
+double max_ss(double x, double y) { return (x > y ? x : y); }
+
+struct UnaryFunction { const char* id; double (*function)(double); };
+struct BinaryFunction { const char* id; double (*function)(double,double); };
+
+const UnaryFunction unary_functions[] = {
+  { "abs$S", abs_s }, { "norm$S", abs_s },
+  { "exp$S", exp_s }, { "sqrt$S", sqrt_s },
+  { "log$S", log_s }, { "ln$S", log_s },
+  { "sin$S", sin_s }, { "cos$S", cos_s }, { "tan$S", tan_s },
+  { "sinh$S", sinh_s }, { "cosh$S", cosh_s },
+  { "asin$S", asin_s }, { "acos$S", acos_s }, { "atan$S", atan_s },
+  { "floor$S", floor_s }, { "ceil$S", ceil_s }
+};
+
+const BinaryFunction binary_functions[] = {
+  { "pow$S:S", pow_ss }, { "atan2$S:S", atan2_ss },
+  { "le$S:S", le_ss }, { "ge$S:S", ge_ss }, { "ls$S:S", ls_ss }, { "gt$S:S", gt_ss },
+  { "eq$S:S", eq_ss }, { "neq$S:S", neq_ss }, { "and$S:S", and_ss }, { "or$S:S", or_ss },
+  { "min$S:S", min_ss }, { "max$S:S", max_ss }
+};
+
+}
+
+ArrayMathFusedKernel::ArrayMathFusedKernel(size_type block_size) :
+  block_size_(block_size), num_registers_(0)
+{
+}
+
+bool
+ArrayMathFusedKernel::compile(ParserProgramHandle& pprogram,
+                              ArrayMathProgram& mprogram)
+{
+  prologue_.clear();
+  instructions_.clear();
+  staged_registers_.clear();
+
+  size_t num_sequential_functions = pprogram->num_sequential_functions();
+  if (num_sequential_functions == 0) return (false);
+
+  // Each sequential variable gets a register of block_size_ values, inputs
+  // that are not sequential get additional registers when they are staged
+  num_registers_ = static_cast<int>(pprogram->num_sequential_variables());
+
+  ParserScriptFunctionHandle fhandle;
+  for (size_t j=0; j<num_sequential_functions; j++)
+  {
+    pprogram->get_sequential_function(j,fhandle);
+    if (!(add_function(fhandle,mprogram)))
+    {
+      prologue_.clear();
+      instructions_.clear();
+      return (false);
+    }
+  }
+
+  return (true);
+}
+
+int
+ArrayMathFusedKernel::input_register(ParserScriptVariableHandle& ihandle,
+                                     ArrayMathProgram& mprogram)
+{
+  if (ihandle->get_type() != "S") return (-1);
+
+  int inum = ihandle->get_var_number();
+  int flags = ihandle->get_flags() &
+    (SCRIPT_SEQUENTIAL_VAR_E|SCRIPT_SINGLE_VAR_E|SCRIPT_CONST_VAR_E);
+
+  if (flags == SCRIPT_SEQUENTIAL_VAR_E) return (inum);
+
+  // Input is computed before the sequential part of the program is run,
+  // hence it only needs to be copied into a register once
+  std::pair<int,int> key(flags,inum);
+  std::map<std::pair<int,int>,int>::iterator it = staged_registers_.find(key);
+  if (it != staged_registers_.end()) return ((*it).second);
+
+  if (flags & SCRIPT_SEQUENTIAL_VAR_E)
+  {
+    Instruction ins(COPY_BUFFER_E);
+    ins.data_ = mprogram.get_sequential_variable(inum,0)->get_data();
+    ins.out_[0] = num_registers_;
+    prologue_.push_back(ins);
+  }
+  else if (flags & SCRIPT_SINGLE_VAR_E)
+  {
+    Instruction ins(FILL_E);
+    ins.data_ = mprogram.get_single_variable(inum)->get_data();
+    ins.out_[0] = num_registers_;
+    prologue_.push_back(ins);
+  }
+  else if (flags & SCRIPT_CONST_VAR_E)
+  {
+    Instruction ins(FILL_E);
+    ins.data_ = mprogram.get_const_variable(inum)->get_data();
+    ins.out_[0] = num_registers_;
+    prologue_.push_back(ins);
+  }
+  else
+  {
+    return (-1);
+  }
+
+  staged_registers_[key] = num_registers_;
+  return (num_registers_++);
+}
+
+void
+ArrayMathFusedKernel::add_center(OpCode op, VMesh* vmesh, int component, int reg)
+{
+  // Share one call to get_center between the x, y and z coordinates. As
+  // sources have no inputs they can be moved to the first one that is used
+  for (size_t j=0; j<instructions_.size(); j++)
+  {
+    Instruction& ins = instructions_[j];
+    if (ins.op_ == op && ins.vmesh_ == vmesh && ins.out_[component] < 0)
+    {
+      ins.out_[component] = reg;
+      return;
+    }
+  }
+
+  Instruction ins(op);
+  ins.vmesh_ = vmesh;
+  ins.out_[component] = reg;
+  instructions_.push_back(ins);
+}
+
+bool
+ArrayMathFusedKernel::add_function(ParserScriptFunctionHandle& fhandle,
+                                   ArrayMathProgram& mprogram)
+{
+  const std::string id = fhandle->get_function()->get_function_id();
+  ParserScriptVariableHandle ohandle = fhandle->get_output_var();
+  ArrayMathProgramSource ps;
+
+  size_t num_input_vars = fhandle->num_input_vars();
+  if (num_input_vars > 2) return (false);
+
+  ParserScriptVariableHandle ihandle[2];
+  for (size_t i=0; i<num_input_vars; i++)
+    ihandle[i] = fhandle->get_input_var(i);
+
+  // Sinks
+  if (id == "to_fielddata$S" || id == "to_double_array$S")
+  {
+    Instruction ins(id == "to_fielddata$S" ? TO_FIELD_DATA_E : TO_DOUBLE_ARRAY_E);
+    if (!(mprogram.find_sink(ohandle->get_name(),ps))) return (false);
+    if (ins.op_ == TO_FIELD_DATA_E)
+    {
+      if (!(ps.is_vfield()) || !(ps.get_vfield()->is_scalar())) return (false);
+      ins.vfield_ = ps.get_vfield();
+    }
+    else
+    {
+      if (!(ps.is_double_array())) return (false);
+      ins.array_ = ps.get_double_array();
+    }
+    if ((ins.in_[0] = input_register(ihandle[0],mprogram)) < 0) return (false);
+    instructions_.push_back(ins);
+    return (true);
+  }
+
+  // All other functions produce a sequential scalar
+  if (ohandle->get_type() != "S") return (false);
+  int flags = ohandle->get_flags();
+  if (!(flags & SCRIPT_SEQUENTIAL_VAR_E) || (flags & SCRIPT_CONST_VAR_E)) return (false);
+  int onum = ohandle->get_var_number();
+
+  // Sources
+  if (id == "get_scalar$FD")
+  {
+    if (!(mprogram.find_source(ihandle[0]->get_name(),ps))) return (false);
+    if (!(ps.is_vfield()) || !(ps.get_vfield()->is_scalar())) return (false);
+    Instruction ins(FIELD_DATA_E);
+    ins.vfield_ = ps.get_vfield();
+    ins.out_[0] = onum;
+    instructions_.push_back(ins);
+    return (true);
+  }
+
+  if (id == "get_scalar$AD")
+  {
+    if (!(mprogram.find_source(ihandle[0]->get_name(),ps))) return (false);
+    if (!(ps.is_double_array())) return (false);
+    Instruction ins(DOUBLE_ARRAY_E);
+    ins.array_ = ps.get_double_array();
+    ins.out_[0] = onum;
+    instructions_.push_back(ins);
+    return (true);
+  }
+
+  if (id == "index$")
+  {
+    Instruction ins(INDEX_E);
+    ins.out_[0] = onum;
+    instructions_.push_back(ins);
+    return (true);
+  }
+
+  const std::string coords[] = { "x", "y", "z" };
+  for (int c=0; c<3; c++)
+  {
+    bool node = (id == "get_node_"+coords[c]+"$FM");
+    bool elem = (id == "get_element_"+coords[c]+"$FM");
+    if (node || elem)
+    {
+      if (!(mprogram.find_source(ihandle[0]->get_name(),ps))) return (false);
+      if (!(ps.is_vmesh())) return (false);
+      add_center(node ? NODE_CENTER_E : ELEM_CENTER_E, ps.get_vmesh(), c, onum);
+      return (true);
+    }
+  }
+
+  if (id == "seq$S")
+  {
+    // The value is the same for every element, set the register once
+    int iflags = ihandle[0]->get_flags();
+    if ((iflags & SCRIPT_SEQUENTIAL_VAR_E) || ihandle[0]->get_type() != "S") return (false);
+    int inum = ihandle[0]->get_var_number();
+    Instruction ins(FILL_E);
+    if (iflags & SCRIPT_SINGLE_VAR_E)
+      ins.data_ = mprogram.get_single_variable(inum)->get_data();
+    else
+      ins.data_ = mprogram.get_const_variable(inum)->get_data();
+    ins.out_[0] = onum;
+    prologue_.push_back(ins);
+    return (true);
+  }
+
+  // Arithmetic
+  Instruction ins(ADD_E);
+  if (id == "add$S:S") ins.op_ = ADD_E;
+  else if (id == "sub$S:S") ins.op_ = SUB_E;
+  else if (id == "mult$S:S") ins.op_ = MULT_E;
+  else if (id == "div$S:S") ins.op_ = DIV_E;
+  else if (id == "neg$S") ins.op_ = NEG_E;
+  else
+  {
+    for (size_t k=0; k<sizeof(unary_functions)/sizeof(UnaryFunction); k++)
+    {
+      if (id == unary_functions[k].id)
+      {
+        ins.op_ = UNARY_E;
+        ins.unary_ = unary_functions[k].function;
+      }
+    }
+    for (size_t k=0; k<sizeof(binary_functions)/sizeof(BinaryFunction); k++)
+    {
+      if (id == binary_functions[k].id)
+      {
+        ins.op_ = BINARY_E;
+        ins.binary_ = binary_functions[k].function;
+      }
+    }
+    if (!(ins.unary_) && !(ins.binary_)) return (false);
+  }
+
+  size_t num_args = (ins.op_ == NEG_E || ins.op_ == UNARY_E) ? 1 : 2;
+  if (num_input_vars != num_args) return (false);
+  for (size_t i=0; i<num_args; i++)
+  {
+    if ((ins.in_[i] = input_register(ihandle[i],mprogram)) < 0) return (false);
+  }
+  ins.out_[0] = onum;
+  instructions_.push_back(ins);
+
+  return (true);
+}
+
+void
+ArrayMathFusedKernel::run(size_type array_size) const
+{
+  if (array_size <= 0) return;
+
+  // Hand out whole blocks, a few per thread so threads can balance the load
+  size_type num_blocks = (array_size+block_size_-1)/block_size_;
+  size_type blocks_per_chunk = std::max<size_type>(1,
+    num_blocks/(8*static_cast<size_type>(Parallel::NumCores())));
+
+  Parallel::ForRange(0, static_cast<size_t>(array_size),
+    [this](size_t start, size_t end)
+    {
+      run_range(static_cast<index_type>(start),static_cast<index_type>(end));
+    }, static_cast<size_t>(blocks_per_chunk*block_size_));
+}
+
+void
+ArrayMathFusedKernel::run_range(index_type start, index_type end) const
+{
+  std::vector<double> registers(static_cast<size_t>(num_registers_*block_size_));
+  double* regs = registers.empty() ? 0 : &(registers[0]);
+
+  for (size_t j=0; j<prologue_.size(); j++)
+    run_instruction(prologue_[j],start,block_size_,regs);
+
+  for (index_type offset = start; offset < end; offset += block_size_)
+  {
+    size_type size = std::min<size_type>(block_size_,end-offset);
+    for (size_t j=0; j<instructions_.size(); j++)
+      run_instruction(instructions_[j],offset,size,regs);
+  }
+}
+
+void
+ArrayMathFusedKernel::run_instruction(const Instruction& ins,
+                                      index_type offset,
+                                      size_type size,
+                                      double* registers) const
+{
+  double* out = (ins.out_[0] < 0) ? 0 : registers + ins.out_[0]*block_size_;
+  const double* in0 = (ins.in_[0] < 0) ? 0 : registers + ins.in_[0]*block_size_;
+  const double* in1 = (ins.in_[1] < 0) ? 0 : registers + ins.in_[1]*block_size_;
+
+  switch (ins.op_)
+  {
+    case FILL_E:
+    {
+      const double val = *(ins.data_);
+      for (size_type i=0; i<size; i++) out[i] = val;
+      break;
+    }
+    case COPY_BUFFER_E:
+      for (size_type i=0; i<size; i++) out[i] = ins.data_[i];
+      break;
+    case FIELD_DATA_E:
+      // One virtual call for the whole block
+      ins.vfield_->get_values(out,size,offset);
+      break;
+    case DOUBLE_ARRAY_E:
+    {
+      const double* data = &((*ins.array_)[0]) + offset;
+      for (size_type i=0; i<size; i++) out[i] = data[i];
+      break;
+    }
+    case INDEX_E:
+      for (size_type i=0; i<size; i++) out[i] = static_cast<double>(offset+i);
+      break;
+    case NODE_CENTER_E:
+    case ELEM_CENTER_E:
+    {
+      double* x = out;
+      double* y = (ins.out_[1] < 0) ? 0 : registers + ins.out_[1]*block_size_;
+      double* z = (ins.out_[2] < 0) ? 0 : registers + ins.out_[2]*block_size_;
+      Point p;
+      for (size_type i=0; i<size; i++)
+      {
+        if (ins.op_ == NODE_CENTER_E)
+          ins.vmesh_->get_center(p,VMesh::Node::index_type(offset+i));
+        else
+          ins.vmesh_->get_center(p,VMesh::Elem::index_type(offset+i));
+        if (x) x[i] = p.x();
+        if (y) y[i] = p.y();
+        if (z) z[i] = p.z();
+      }
+      break;
+    }
+    case ADD_E:
+      for (size_type i=0; i<size; i++) out[i] = in0[i] + in1[i];
+      break;
+    case SUB_E:
+      for (size_type i=0; i<size; i++) out[i] = in0[i] - in1[i];
+      break;
+    case MULT_E:
+      for (size_type i=0; i<size; i++) out[i] = in0[i] * in1[i];
+      break;
+    case DIV_E:
+      for (size_type i=0; i<size; i++) out[i] = in0[i] / in1[i];
+      break;
+    case NEG_E:
+      for (size_type i=0; i<size; i++) out[i] = -in0[i];
+      break;
+    case UNARY_E:
+      for (size_type i=0; i<size; i++) out[i] = ins.unary_(in0[i]);
+      break;
+    case BINARY_E:
+      for (size_type i=0; i<size; i++) out[i] = ins.binary_(in0[i],in1[i]);
+      break;
+    case TO_FIELD_DATA_E:
+      ins.vfield_->set_values(in0,size,offset);
+      break;
+    case TO_DOUBLE_ARRAY_E:
+    {
+      double* data = &((*ins.array_)[0]) + offset;
+      for (size_type i=0; i<size; i++) data[i] = in0[i];
+      break;
+    }
+  }
+}
@@ -0,0 +1,142 @@
+//  
+//  For more information, please see: http://software.sci.utah.edu
+//  
+//  The MIT License
+//  
+//  Copyright (c) 2015 Scientific Computing and Imaging Institute,
+//  University of Utah.
+//  
+//  
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//  
+//  The above copyright notice and this permission notice shall be included
+//  in all copies or substantial portions of the Software.
+//  
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//  
+
+#ifndef CORE_PARSER_ARRAYMATHKERNEL_H
+#define CORE_PARSER_ARRAYMATHKERNEL_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Datatypes/Legacy/Field/FieldFwd.h>
+
+#include <Core/Parser/Parser.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Include files needed for Windows
+#include <Core/Parser/share.h>
+
+namespace SCIRun {
+
+class ArrayMathProgram;
+
+//-----------------------------------------------------------------------------
+// Fused kernel for the sequential part of an ArrayMathProgram.
+// The interpreter runs every function of the program as a separate call
+// through a boost::function, and reads and writes field data one value at
+// a time through the virtual VField/VMesh interface. When all the sequential
+// functions of a program are simple scalar operations, this kernel compiles
+// them into one flat list of instructions that is executed block by block on
+// thread local registers: field data is moved in bulk, the x, y and z
+// coordinates of a node or element are computed with a single call to the
+// mesh and the arithmetic runs as tight loops the compiler can vectorize.
+// Programs that use anything else are left to the interpreter.
+
+class SCISHARE ArrayMathFusedKernel : boost::noncopyable {
+  public:
+    explicit ArrayMathFusedKernel(size_type block_size);
+
+    // Translate the sequential functions of the parser program, using the
+    // sources, sinks and buffers that were set up in mprogram. Returns false
+    // if the program contains a function that cannot be fused.
+    bool compile(ParserProgramHandle& pprogram, ArrayMathProgram& mprogram);
+
+    // Run the kernel over [0, array_size)
+    void run(size_type array_size) const;
+
+    size_t num_instructions() const { return (instructions_.size()); }
+
+  private:
+    enum OpCode {
+      // Executed once per range of blocks, to set up registers that do not
+      // change during the run
+      FILL_E,
+      COPY_BUFFER_E,
+      // Sources
+      FIELD_DATA_E,
+      DOUBLE_ARRAY_E,
+      INDEX_E,
+      NODE_CENTER_E,
+      ELEM_CENTER_E,
+      // Arithmetic
+      ADD_E,
+      SUB_E,
+      MULT_E,
+      DIV_E,
+      NEG_E,
+      UNARY_E,
+      BINARY_E,
+      // Sinks
+      TO_FIELD_DATA_E,
+      TO_DOUBLE_ARRAY_E
+    };
+
+    struct Instruction {
+      Instruction(OpCode op) :
+        op_(op), unary_(0), binary_(0), data_(0), vfield_(0), vmesh_(0), array_(0)
+      { out_[0] = out_[1] = out_[2] = -1; in_[0] = in_[1] = -1; }
+
+      OpCode op_;
+      // Registers written and read by the instruction, -1 if not used
+      int out_[3];
+      int in_[2];
+      double (*unary_)(double);
+      double (*binary_)(double,double);
+      // Data the instruction works on
+      const double* data_;
+      VField* vfield_;
+      VMesh* vmesh_;
+      std::vector<double>* array_;
+    };
+
+    bool add_function(ParserScriptFunctionHandle& fhandle, ArrayMathProgram& mprogram);
+    int input_register(ParserScriptVariableHandle& ihandle, ArrayMathProgram& mprogram);
+    void add_center(OpCode op, VMesh* vmesh, int component, int reg);
+
+    void run_range(index_type start, index_type end) const;
+    void run_instruction(const Instruction& ins, index_type offset,
+                         size_type size, double* registers) const;
+
+    size_type block_size_;
+    int num_registers_;
+    std::vector<Instruction> prologue_;
+    std::vector<Instruction> instructions_;
+
+    // Registers holding copies of single, const and constant sequential
+    // inputs, indexed by the flags and number of the variable
+    std::map<std::pair<int,int>,int> staged_registers_;
+};
+
+typedef boost::shared_ptr<ArrayMathFusedKernel> ArrayMathFusedKernelHandle;
+
+}
+
+#endif
@@ -33,6 +33,8 @@
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Parser/ArrayMathEngine.h>
+#include <algorithm>
+#include <chrono>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Geometry;
@@ -91,6 +93,22 @@ protected:
     EXPECT_EQ(expectedMin, min);
     EXPECT_EQ(expectedMax, max);
   }
+  void runExpression(FieldHandle field, const std::string& function, bool useFusedKernel,
+    std::vector<double>& values, bool& ranFusedKernel)
+  {
+    NewArrayMathEngine engine;
+    engine.set_use_fused_kernel(useFusedKernel);
+    setupEngine(engine, field);
+
+    ASSERT_TRUE(engine.add_expressions(function));
+    ASSERT_TRUE(engine.run());
+    ranFusedKernel = engine.ran_fused_kernel();
+
+    FieldHandle ofield;
+    engine.get_field("RESULT",ofield);
+    ASSERT_THAT(ofield, NotNull());
+    ofield->vfield()->get_values(values);
+  }
   void testBadParseFunction(const std::string& function)
   {
     FieldHandle field(CreateEmptyLatVol(3,3,3));
@@ -1577,6 +1595,75 @@ TEST_F(BasicParserTests, CreateFieldData_fracanisotropy)
 
 */
 
+namespace
+{
+  const char* fusableExpressions[] =
+  {
+    "RESULT = 1;",
+    "RESULT = X + Y + Z;",
+    "RESULT = 1/Y + 2*X - Z;",
+    "RESULT = sin(X)*cos(Y) + Z*Z;",
+    "RESULT = sqrt(X*X + Y*Y + Z*Z);",
+    "RESULT = (X+1)*(Y-2)/(Z+3) - 4*X;",
+    "RESULT = abs(X-Y) + exp(-Z*Z) - log(2+X);",
+    "RESULT = pow(X,2) + atan2(Y,Z) + floor(3*X) + ceil(3*Y);",
+    "RESULT = INDEX/SIZE + (X > 0) + (Y <= Z) + max(X,Y) - min(Y,Z);"
+  };
+}
+
+TEST_F(BasicParserTests, FusedKernelMatchesInterpreter)
+{
+  FieldHandle field(CreateEmptyLatVol(6,7,8));
+
+  for (auto function : fusableExpressions)
+  {
+    std::vector<double> interpreted, fused;
+    bool ranFusedKernel;
+    runExpression(field, function, false, interpreted, ranFusedKernel);
+    EXPECT_FALSE(ranFusedKernel);
+    runExpression(field, function, true, fused, ranFusedKernel);
+    EXPECT_TRUE(ranFusedKernel) << function;
+
+    ASSERT_EQ(6*7*8, static_cast<int>(fused.size()));
+    EXPECT_EQ(interpreted, fused) << function;
+  }
+}
+
+TEST_F(BasicParserTests, UnsupportedFunctionsFallBackToInterpreter)
+{
+  FieldHandle field(CreateEmptyLatVol());
+
+  std::vector<double> values;
+  bool ranFusedKernel;
+  runExpression(field, "RESULT = select(X > 0, X, Y) + round(Z);", true, values, ranFusedKernel);
+  EXPECT_FALSE(ranFusedKernel);
+
+  ASSERT_FALSE(values.empty());
+  EXPECT_EQ(-1, *std::min_element(values.begin(), values.end()));
+  EXPECT_EQ(2, *std::max_element(values.begin(), values.end()));
+}
+
+TEST_F(BasicParserTests, DISABLED_FusedKernelVersusInterpreterBenchmark)
+{
+  FieldHandle field(CreateEmptyLatVol(150,150,150));
+
+  for (auto function : fusableExpressions)
+  {
+    double seconds[2];
+    for (int fused = 0; fused < 2; ++fused)
+    {
+      std::vector<double> values;
+      bool ranFusedKernel;
+      auto start = std::chrono::steady_clock::now();
+      runExpression(field, function, fused == 1, values, ranFusedKernel);
+      const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+      seconds[fused] = time.count();
+    }
+    std::cout << function << "  interpreter: " << seconds[0]
+      << " s  fused: " << seconds[1] << " s" << std::endl;
+  }
+}
+
 TEST(FieldHashTests, TestShiftingZero)
 {
   // copied from TetVolMesh.h, failing compilation on GCC 6.2.
@@ -0,0 +1,299 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+ *  BlockCompressedFile.cc: byte stream stored as independently deflated
+ *  blocks followed by a block index
+ */
+
+#include <Core/Persistent/BlockCompressedFile.h>
+#include <Core/Thread/Parallel.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace SCIRun;
+using namespace SCIRun::BlockCompressed;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  const char MAGIC[8] = { 'S', 'C', 'I', 'B', 'C', 'Z', 'I', 'X' };
+  const boost::uint32_t VERSION = 1;
+  const boost::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  // Stored after the index, so a reader finds everything from the end of
+  // the file without knowing how long the header in front of the blocks is.
+  struct Footer
+  {
+    boost::uint64_t index_offset;
+    boost::uint64_t num_blocks;
+    boost::uint64_t block_size;
+    boost::uint64_t raw_size;
+    boost::uint32_t version;
+    boost::uint32_t byte_order;
+    char magic[8];
+  };
+
+  bool seekFile(FILE* fp, boost::int64_t offset, int whence)
+  {
+#ifdef _WIN32
+    return _fseeki64(fp, offset, whence) == 0;
+#else
+    return fseeko(fp, offset, whence) == 0;
+#endif
+  }
+
+  boost::int64_t tellFile(FILE* fp)
+  {
+#ifdef _WIN32
+    return _ftelli64(fp);
+#else
+    return ftello(fp);
+#endif
+  }
+
+  size_t batchSize()
+  {
+    return std::max(1u, Parallel::NumCores());
+  }
+}
+
+BlockCompressedWriter::BlockCompressedWriter(FILE* fp, size_t blockSize, int level)
+  : fp_(fp), block_size_(std::max<size_t>(blockSize, 1)), level_(level),
+    batch_size_(batchSize()), file_offset_(0), raw_size_(0), finished_(false)
+{
+  if (fp_)
+  {
+    const boost::int64_t offset = tellFile(fp_);
+    if (offset < 0)
+      fp_ = 0;
+    else
+      file_offset_ = offset;
+  }
+}
+
+bool BlockCompressedWriter::write(const void* data, size_t size)
+{
+  if (!fp_ || finished_)
+    return false;
+
+  const char* in = static_cast<const char*>(data);
+  while (size > 0)
+  {
+    if (pending_.empty() || pending_.back().size() == block_size_)
+    {
+      if (pending_.size() == batch_size_ && !flushBatch())
+        return false;
+      pending_.push_back(std::vector<char>());
+      pending_.back().reserve(block_size_);
+    }
+    std::vector<char>& block = pending_.back();
+    const size_t n = std::min(size, block_size_ - block.size());
+    block.insert(block.end(), in, in + n);
+    in += n;
+    size -= n;
+    raw_size_ += n;
+  }
+  return true;
+}
+
+bool BlockCompressedWriter::flushBatch()
+{
+  if (pending_.empty())
+    return true;
+
+  const size_t count = pending_.size();
+  std::vector<std::vector<char> > compressed(count);
+  std::vector<char> ok(count, 0);
+  Parallel::ForRange(0, count, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      const std::vector<char>& raw = pending_[i];
+      uLongf length = compressBound(static_cast<uLong>(raw.size()));
+      compressed[i].resize(length);
+      ok[i] = compress2(reinterpret_cast<Bytef*>(&compressed[i][0]), &length,
+        reinterpret_cast<const Bytef*>(raw.data()), static_cast<uLong>(raw.size()), level_) == Z_OK;
+      compressed[i].resize(length);
+    }
+  }, 1);
+
+  // Blocks are written in order, so the compressed stream stays contiguous.
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (!ok[i] || fwrite(compressed[i].data(), 1, compressed[i].size(), fp_) != compressed[i].size())
+      return false;
+    IndexEntry entry;
+    entry.offset = file_offset_;
+    entry.compressed_size = static_cast<boost::uint32_t>(compressed[i].size());
+    entry.raw_size = static_cast<boost::uint32_t>(pending_[i].size());
+    index_.push_back(entry);
+    file_offset_ += compressed[i].size();
+  }
+  pending_.clear();
+  return true;
+}
+
+bool BlockCompressedWriter::finish()
+{
+  if (!fp_ || finished_)
+    return false;
+  finished_ = true;
+
+  if (!flushBatch())
+    return false;
+
+  Footer footer;
+  footer.index_offset = file_offset_;
+  footer.num_blocks = index_.size();
+  footer.block_size = block_size_;
+  footer.raw_size = raw_size_;
+  footer.version = VERSION;
+  footer.byte_order = BYTE_ORDER_MARK;
+  memcpy(footer.magic, MAGIC, sizeof(MAGIC));
+
+  if (!index_.empty() &&
+      fwrite(&index_[0], sizeof(IndexEntry), index_.size(), fp_) != index_.size())
+    return false;
+  return fwrite(&footer, sizeof(footer), 1, fp_) == 1 && fflush(fp_) == 0;
+}
+
+BlockCompressedReader::BlockCompressedReader(FILE* fp)
+  : fp_(fp), valid_(false), block_size_(0), batch_size_(batchSize()),
+    raw_size_(0), position_(0), cache_first_(0)
+{
+  Footer footer;
+  if (!fp_ || !seekFile(fp_, -static_cast<boost::int64_t>(sizeof(footer)), SEEK_END))
+    return;
+  const boost::int64_t footerOffset = tellFile(fp_);
+  if (fread(&footer, sizeof(footer), 1, fp_) != 1 ||
+      memcmp(footer.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      footer.version != VERSION || footer.byte_order != BYTE_ORDER_MARK ||
+      footer.block_size == 0 || footer.block_size > 0xffffffffu)
+    return;
+
+  // Every block is full except the last one.
+  const boost::uint64_t n = footer.num_blocks;
+  if (footer.raw_size > n * footer.block_size ||
+      (n > 0 && footer.raw_size <= (n - 1) * footer.block_size) ||
+      footer.index_offset + n * sizeof(IndexEntry) != static_cast<boost::uint64_t>(footerOffset))
+    return;
+
+  index_.resize(n);
+  if (n > 0 && (!seekFile(fp_, footer.index_offset, SEEK_SET) ||
+      fread(&index_[0], sizeof(IndexEntry), n, fp_) != n))
+    return;
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    const IndexEntry& entry = index_[i];
+    const boost::uint64_t expected = std::min<boost::uint64_t>(footer.block_size,
+      footer.raw_size - i * footer.block_size);
+    if (entry.raw_size != expected ||
+        (i > 0 && entry.offset != index_[i - 1].offset + index_[i - 1].compressed_size))
+      return;
+  }
+  if (n > 0 && index_.back().offset + index_.back().compressed_size > footer.index_offset)
+    return;
+
+  block_size_ = static_cast<size_t>(footer.block_size);
+  raw_size_ = footer.raw_size;
+  valid_ = true;
+}
+
+bool BlockCompressedReader::seek(boost::uint64_t offset)
+{
+  if (!valid_ || offset > raw_size_)
+    return false;
+  position_ = offset;
+  return true;
+}
+
+size_t BlockCompressedReader::read(void* data, size_t size)
+{
+  if (!valid_)
+    return 0;
+
+  char* out = static_cast<char*>(data);
+  size_t done = 0;
+  while (done < size && position_ < raw_size_)
+  {
+    const size_t block = static_cast<size_t>(position_ / block_size_);
+    if (block < cache_first_ || block >= cache_first_ + cache_.size())
+    {
+      if (!loadBatch(block))
+        break;
+    }
+    const std::vector<char>& raw = cache_[block - cache_first_];
+    const size_t within = static_cast<size_t>(position_ - static_cast<boost::uint64_t>(block) * block_size_);
+    const size_t n = std::min(size - done, raw.size() - within);
+    memcpy(out + done, &raw[within], n);
+    done += n;
+    position_ += n;
+  }
+  return done;
+}
+
+bool BlockCompressedReader::loadBatch(size_t firstBlock)
+{
+  const size_t last = std::min(index_.size(), firstBlock + batch_size_);
+  const boost::uint64_t begin = index_[firstBlock].offset;
+  const boost::uint64_t end = index_[last - 1].offset + index_[last - 1].compressed_size;
+
+  // The batch is read with one call and inflated concurrently.
+  std::vector<char> compressed(static_cast<size_t>(end - begin));
+  cache_.clear();
+  if (!seekFile(fp_, begin, SEEK_SET) ||
+      fread(compressed.data(), 1, compressed.size(), fp_) != compressed.size())
+    return false;
+
+  const size_t count = last - firstBlock;
+  std::vector<std::vector<char> > blocks(count);
+  std::vector<char> ok(count, 0);
+  Parallel::ForRange(0, count, [&](size_t b, size_t e)
+  {
+    for (size_t i = b; i < e; ++i)
+    {
+      const IndexEntry& entry = index_[firstBlock + i];
+      uLongf length = entry.raw_size;
+      blocks[i].resize(length);
+      ok[i] = uncompress(reinterpret_cast<Bytef*>(&blocks[i][0]), &length,
+        reinterpret_cast<const Bytef*>(&compressed[entry.offset - begin]), entry.compressed_size) == Z_OK &&
+        length == entry.raw_size;
+    }
+  }, 1);
+
+  if (std::find(ok.begin(), ok.end(), 0) != ok.end())
+    return false;
+  cache_.swap(blocks);
+  cache_first_ = firstBlock;
+  return true;
+}
@@ -0,0 +1,125 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+ *  BlockCompressedFile.h: byte stream stored as independently deflated
+ *  blocks followed by a block index
+ *
+ *  Because no block depends on another, batches of blocks are compressed and
+ *  decompressed concurrently, and a reader can seek to any uncompressed offset
+ *  by inflating only the block that contains it.
+ */
+
+#ifndef CORE_PERSISTENT_BLOCKCOMPRESSEDFILE_H
+#define CORE_PERSISTENT_BLOCKCOMPRESSEDFILE_H 1
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <cstdio>
+#include <vector>
+
+#include <Core/Persistent/share.h>
+
+namespace SCIRun {
+
+namespace BlockCompressed
+{
+  struct IndexEntry
+  {
+    boost::uint64_t offset;
+    boost::uint32_t compressed_size;
+    boost::uint32_t raw_size;
+  };
+
+  static const size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+}
+
+class SCISHARE BlockCompressedWriter : boost::noncopyable
+{
+public:
+  /// Appends to fp from its current position; the caller keeps ownership.
+  /// level is the zlib compression level (1 = fastest, 9 = smallest).
+  explicit BlockCompressedWriter(FILE* fp,
+    size_t blockSize = BlockCompressed::DEFAULT_BLOCK_SIZE, int level = 1);
+
+  bool write(const void* data, size_t size);
+  /// Writes the remaining blocks, the index and the footer.
+  /// Must be called once before the file is closed.
+  bool finish();
+
+  boost::uint64_t size() const { return raw_size_; }
+
+private:
+  bool flushBatch();
+
+  FILE* fp_;
+  size_t block_size_;
+  int level_;
+  size_t batch_size_;
+  boost::uint64_t file_offset_;
+  boost::uint64_t raw_size_;
+  bool finished_;
+  std::vector<std::vector<char> > pending_;
+  std::vector<BlockCompressed::IndexEntry> index_;
+};
+
+class SCISHARE BlockCompressedReader : boost::noncopyable
+{
+public:
+  /// Reads the footer and index of the block stream that ends at the end of
+  /// fp; the caller keeps ownership. Check valid() before reading.
+  explicit BlockCompressedReader(FILE* fp);
+
+  bool valid() const { return valid_; }
+  boost::uint64_t size() const { return raw_size_; }
+  size_t num_blocks() const { return index_.size(); }
+  boost::uint64_t tell() const { return position_; }
+
+  /// Moves to an uncompressed offset; fails past the end of the stream.
+  bool seek(boost::uint64_t offset);
+  /// Returns the number of bytes read, which is less than size only at the
+  /// end of the stream or on a corrupt block.
+  size_t read(void* data, size_t size);
+
+private:
+  bool loadBatch(size_t firstBlock);
+
+  FILE* fp_;
+  bool valid_;
+  size_t block_size_;
+  size_t batch_size_;
+  boost::uint64_t raw_size_;
+  boost::uint64_t position_;
+  std::vector<BlockCompressed::IndexEntry> index_;
+  size_t cache_first_;
+  std::vector<std::vector<char> > cache_;
+};
+
+} // End namespace SCIRun
+
+#endif
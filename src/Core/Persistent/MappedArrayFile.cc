@@ -0,0 +1,214 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+ *  MappedArrayFile.cc: versioned container of aligned binary arrays that is
+ *  read through a memory mapping
+ */
+
+#include <Core/Persistent/MappedArrayFile.h>
+#include <Core/Utils/Exception.h>
+
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <map>
+
+using namespace SCIRun;
+using namespace boost::interprocess;
+
+namespace
+{
+  const char MAGIC[8] = { 'S', 'C', 'I', 'A', 'R', 'R', 'A', 'Y' };
+  const boost::uint32_t BYTE_ORDER_MARK = 0x01020304;
+  const size_t NAME_LENGTH = 48;
+
+  struct FileHeader
+  {
+    char magic[8];
+    boost::uint32_t version;
+    boost::uint32_t byte_order;
+    boost::uint64_t num_arrays;
+    boost::uint64_t metadata_size;
+  };
+
+  struct ArrayEntry
+  {
+    char name[NAME_LENGTH];
+    boost::uint64_t element_size;
+    boost::uint64_t count;
+    boost::uint64_t offset;
+  };
+
+  boost::uint64_t align(boost::uint64_t offset)
+  {
+    const boost::uint64_t a = MappedArrayFile::ALIGNMENT;
+    return (offset + a - 1) / a * a;
+  }
+}
+
+MappedArrayFileWriter::MappedArrayFileWriter(const std::string& metadata) : metadata_(metadata)
+{
+}
+
+void MappedArrayFileWriter::add_raw(const std::string& name, const void* data, size_t elementSize, size_t count)
+{
+  if (name.empty() || name.size() >= NAME_LENGTH)
+    THROW_INVALID_ARGUMENT("Mapped array name must have between 1 and 47 characters: " + name);
+  Entry entry = { name, data, elementSize, count };
+  entries_.push_back(entry);
+}
+
+bool MappedArrayFileWriter::write(const std::string& filename) const
+{
+  FileHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = MappedArrayFile::VERSION;
+  header.byte_order = BYTE_ORDER_MARK;
+  header.num_arrays = entries_.size();
+  header.metadata_size = metadata_.size();
+
+  // the table is written up front, so all offsets are known before any data
+  std::vector<ArrayEntry> table(entries_.size());
+  boost::uint64_t offset = sizeof(FileHeader) + table.size() * sizeof(ArrayEntry) + metadata_.size();
+  for (size_t i = 0; i < entries_.size(); ++i)
+  {
+    std::memset(&table[i], 0, sizeof(ArrayEntry));
+    std::strncpy(table[i].name, entries_[i].name.c_str(), NAME_LENGTH - 1);
+    table[i].element_size = entries_[i].element_size;
+    table[i].count = entries_[i].count;
+    table[i].offset = offset = align(offset);
+    offset += entries_[i].element_size * entries_[i].count;
+  }
+
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out) return false;
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+  if (!table.empty())
+    out.write(reinterpret_cast<const char*>(&table[0]), table.size() * sizeof(ArrayEntry));
+  out.write(metadata_.data(), metadata_.size());
+
+  const char padding[MappedArrayFile::ALIGNMENT] = { 0 };
+  boost::uint64_t position = sizeof(FileHeader) + table.size() * sizeof(ArrayEntry) + metadata_.size();
+  for (size_t i = 0; i < entries_.size(); ++i)
+  {
+    out.write(padding, table[i].offset - position);
+    const boost::uint64_t bytes = table[i].element_size * table[i].count;
+    if (bytes > 0)
+      out.write(static_cast<const char*>(entries_[i].data), bytes);
+    position = table[i].offset + bytes;
+  }
+
+  return static_cast<bool>(out);
+}
+
+class MappedArrayFile::Impl
+{
+public:
+  explicit Impl(const std::string& filename) :
+    file_(filename.c_str(), read_only), region_(file_, read_only)
+  {
+    const char* base = static_cast<const char*>(region_.get_address());
+    const boost::uint64_t size = region_.get_size();
+
+    if (size < sizeof(FileHeader))
+      THROW_INVALID_ARGUMENT("File is too small to be a mapped array file: " + filename);
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(FileHeader));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+      THROW_INVALID_ARGUMENT("Not a mapped array file: " + filename);
+    if (header.version > VERSION)
+      THROW_INVALID_ARGUMENT("Mapped array file was written by a newer version: " + filename);
+    if (header.byte_order != BYTE_ORDER_MARK)
+      THROW_INVALID_ARGUMENT("Mapped array file was written with a different byte order: " + filename);
+
+    const boost::uint64_t tableEnd = sizeof(FileHeader) + header.num_arrays * sizeof(ArrayEntry);
+    if (header.num_arrays > size / sizeof(ArrayEntry) || tableEnd + header.metadata_size > size)
+      THROW_INVALID_ARGUMENT("Mapped array file header is corrupt: " + filename);
+    metadata_.assign(base + tableEnd, header.metadata_size);
+
+    for (boost::uint64_t i = 0; i < header.num_arrays; ++i)
+    {
+      ArrayEntry entry;
+      std::memcpy(&entry, base + sizeof(FileHeader) + i * sizeof(ArrayEntry), sizeof(ArrayEntry));
+      entry.name[NAME_LENGTH - 1] = '\0';
+      const bool overflow = entry.element_size != 0 && entry.count > size / entry.element_size;
+      if (overflow || entry.offset % ALIGNMENT != 0 || entry.offset > size || entry.element_size * entry.count > size - entry.offset)
+        THROW_INVALID_ARGUMENT("Mapped array file table is corrupt: " + filename);
+      arrays_[entry.name] = entry;
+    }
+  }
+
+  file_mapping file_;
+  mapped_region region_;
+  std::string metadata_;
+  std::map<std::string, ArrayEntry> arrays_;
+};
+
+MappedArrayFile::MappedArrayFile(const std::string& filename)
+{
+  try
+  {
+    impl_.reset(new Impl(filename));
+  }
+  catch (interprocess_exception& e)
+  {
+    THROW_INVALID_ARGUMENT("Could not map file " + filename + ": " + e.what());
+  }
+}
+
+MappedArrayFile::~MappedArrayFile()
+{
+}
+
+const std::string& MappedArrayFile::metadata() const
+{
+  return impl_->metadata_;
+}
+
+bool MappedArrayFile::has(const std::string& name) const
+{
+  return impl_->arrays_.find(name) != impl_->arrays_.end();
+}
+
+const void* MappedArrayFile::get_raw(const std::string& name, size_t elementSize, size_t& count) const
+{
+  auto it = impl_->arrays_.find(name);
+  if (it == impl_->arrays_.end())
+    THROW_INVALID_ARGUMENT("Mapped array file has no array named " + name);
+  if (it->second.element_size != elementSize)
+    THROW_INVALID_ARGUMENT("Array " + name + " was stored with a different element size");
+
+  count = static_cast<size_t>(it->second.count);
+  if (count == 0) return nullptr;
+  return static_cast<const char*>(impl_->region_.get_address()) + it->second.offset;
+}
@@ -0,0 +1,103 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+ *  MappedArrayFile.h: versioned container of aligned binary arrays that is
+ *  read through a memory mapping
+ *
+ *  A file holds a short text metadata block and a table of named arrays.
+ *  Every array starts on a 64 byte boundary, so it can be used in place
+ *  (or copied with a single memcpy) instead of being deserialized element
+ *  by element as with a Piostream.
+ */
+
+#ifndef CORE_PERSISTENT_MAPPEDARRAYFILE_H
+#define CORE_PERSISTENT_MAPPEDARRAYFILE_H 1
+
+#include <boost/noncopyable.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Core/Persistent/share.h>
+
+namespace SCIRun {
+
+class SCISHARE MappedArrayFileWriter
+{
+public:
+  explicit MappedArrayFileWriter(const std::string& metadata);
+
+  /// The data is not copied: it has to stay valid until write() is called.
+  template <class T>
+  void add(const std::string& name, const T* data, size_t count)
+  { add_raw(name, data, sizeof(T), count); }
+  void add_raw(const std::string& name, const void* data, size_t elementSize, size_t count);
+
+  bool write(const std::string& filename) const;
+
+private:
+  struct Entry
+  {
+    std::string name;
+    const void* data;
+    size_t element_size;
+    size_t count;
+  };
+  std::string metadata_;
+  std::vector<Entry> entries_;
+};
+
+class SCISHARE MappedArrayFile : boost::noncopyable
+{
+public:
+  static const unsigned int VERSION = 1;
+  static const size_t ALIGNMENT = 64;
+
+  /// Maps the file read only; throws if it is not a valid container.
+  explicit MappedArrayFile(const std::string& filename);
+  ~MappedArrayFile();
+
+  const std::string& metadata() const;
+  bool has(const std::string& name) const;
+
+  /// Pointer into the mapping, valid as long as this object lives.
+  /// Throws if the array is missing or was stored with another element size.
+  template <class T>
+  const T* get(const std::string& name, size_t& count) const
+  { return static_cast<const T*>(get_raw(name, sizeof(T), count)); }
+  const void* get_raw(const std::string& name, size_t elementSize, size_t& count) const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // End namespace SCIRun
+
+#endif
@@ -455,6 +455,10 @@ auto_istream(const std::string& filename, LoggerHandle pr)
   {
     return PiostreamPtr(new TextPiostream(filename, Piostream::Read, pr));
   }
+  else if (m1 == 'B' && m2 == 'C' && m3 == 'Z')
+  {
+    return PiostreamPtr(new BlockCompressedPiostream(filename, Piostream::Read, version, pr));
+  }
 
   if (pr) pr->error(filename + " is an unknown type!");
   else std::cerr << filename << " is an unknown type!" << std::endl;
@@ -470,6 +474,7 @@ auto_ostream(const std::string& filename, const std::string& type, LoggerHandle
   //     Binary:  Return a BinaryPiostream 
   //     Fast:    Return FastPiostream
   //     Text:    Return a TextPiostream
+  //     Compressed: Return a BlockCompressedPiostream
   //     Default: Return BinaryPiostream 
   // NOTE: Binary will never return BinarySwap so we always write
   //       out the endianness of the machine we are on
@@ -486,6 +491,10 @@ auto_ostream(const std::string& filename, const std::string& type, LoggerHandle
   {
     stream = new FastPiostream(filename, Piostream::Write, pr);
   }
+  else if (type == "Compressed")
+  {
+    stream = new BlockCompressedPiostream(filename, Piostream::Write, -1, pr);
+  }
   else
   {
     stream = new BinaryPiostream(filename, Piostream::Write, -1, pr);
@@ -556,6 +565,9 @@ Piostream::readHeader( LoggerHandle pr,
   bool is_binary = false;
   if (hdr[4] == 'B' && hdr[5] == 'I' && hdr[6] == 'N' && hdr[7] == '\n')
     is_binary = true;
+  // Block compressed files carry the same endianness flag.
+  if (hdr[4] == 'B' && hdr[5] == 'C' && hdr[6] == 'Z' && hdr[7] == '\n')
+    is_binary = true;
   if(version > 1 && is_binary) 
   {
     // can only be BIG or LIT
@@ -694,6 +706,18 @@ Persistent::find_derived( const std::string& classname,
   return PersistentTypeIDPtr();
 }
 
+PersistentTypeIDPtr
+Persistent::find_class(const std::string& classname)
+{
+  initialize();
+  Guard g(persistent_mutex_->get());
+
+  auto iter = persistent_table_->find(classname);
+  if (iter == persistent_table_->end())
+    return PersistentTypeIDPtr();
+  return iter->second;
+}
+
 void
 Persistent::add_class(const std::string& type, 
                       const std::string& parent,
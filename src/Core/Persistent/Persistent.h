@@ -206,6 +206,8 @@ class SCISHARE Persistent {
     static PersistentTypeIDPtr find_derived( const std::string& classname, 
                                         const std::string& basename );
     static bool is_base_of(const std::string& parent, const std::string& type);
+    // The registered type id of classname, or null.
+    static PersistentTypeIDPtr find_class(const std::string& classname);
   
     static void add_class(const std::string& type, 
                           const std::string& parent,
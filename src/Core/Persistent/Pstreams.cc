@@ -43,6 +43,7 @@
 ///
 
 #include <Core/Persistent/Pstreams.h>
+#include <Core/Persistent/BlockCompressedFile.h>
 #include <Core/Logging/LoggerInterface.h>
 #include <Core/Utils/Legacy/StringUtil.h>
 
@@ -56,6 +57,7 @@
 #include <stdio.h>
 #include <fstream>
 #include <iostream>
+#include <vector>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -2061,4 +2063,268 @@ FastPiostream::block_io(void *data, size_t s, size_t nmemb)
 }
 
 
+////
+// BlockCompressedPiostream -- writes the version 2 binary layout through
+// a BlockCompressedWriter, so only the machine's endianness is supported
+BlockCompressedPiostream::BlockCompressedPiostream(const std::string& filename,
+                                                   Direction dir, const int& v,
+                                                   LoggerHandle pr)
+  : Piostream(dir, v, filename, pr),
+    fp_(0)
+{
+  if (v == -1) // No version given so use PERSISTENT_VERSION.
+    version_ = PERSISTENT_VERSION;
+  else
+    version_ = v;
+
+  if (version() < 2)
+  {
+    reporter_->error("Compressed files require Pio version 2 or later.");
+    err = true;
+    return;
+  }
+
+  if (dir == Read)
+  {
+    fp_ = fopen(filename.c_str(), "rb");
+    if (!fp_)
+    {
+      reporter_->error("Error opening file: " + filename + " for reading.");
+      err = true;
+      return;
+    }
+
+    char hdr[16];
+    if (fread(hdr, 1, 16, fp_) != 16 ||
+        !readHeader(reporter_, filename, hdr, "BCZ", version_, file_endian))
+    {
+      reporter_->error("Header read failed.");
+      err = true;
+      return;
+    }
+    if (strncmp(hdr + 12, endianness(), 4) != 0)
+    {
+      reporter_->error("Compressed file " + filename +
+                       " was written with a different endianness.");
+      err = true;
+      return;
+    }
+
+    reader_.reset(new BlockCompressedReader(fp_));
+    if (!reader_->valid())
+    {
+      reporter_->error("Compressed file " + filename + " has a corrupt block index.");
+      err = true;
+      return;
+    }
+  }
+  else
+  {
+    fp_ = fopen(filename.c_str(), "wb");
+    if (!fp_)
+    {
+      reporter_->error("Error opening file '" + filename + "' for writing.");
+      err = true;
+      return;
+    }
+
+    // write out 16 bytes, but we need 17 for \0
+    char hdr[17];
+    sprintf(hdr, "SCI\nBCZ\n%03d\n%s", version_, endianness());
+    if (fwrite(hdr, 1, 16, fp_) != 16)
+    {
+      reporter_->error("Header write failed.");
+      err = true;
+      return;
+    }
+    writer_.reset(new BlockCompressedWriter(fp_));
+  }
+}
+
+
+BlockCompressedPiostream::~BlockCompressedPiostream()
+{
+  // The index is written last; without it the file cannot be read.
+  if (writer_ && !writer_->finish())
+    reporter_->error("BlockCompressedPiostream error writing block index.");
+  writer_.reset();
+  reader_.reset();
+  if (fp_) fclose(fp_);
+}
+
+
+void
+BlockCompressedPiostream::reset_post_header()
+{
+  if (! reading() || !reader_) return;
+
+  // Block offsets do not include the header.
+  reader_->seek(0);
+}
+
+
+const char *
+BlockCompressedPiostream::endianness()
+{
+  return "LIT\n";
+}
+
+
+bool
+BlockCompressedPiostream::transfer(void* data, size_t size)
+{
+  if (dir == Read)
+    return reader_ && reader_->read(data, size) == size;
+  return writer_ && writer_->write(data, size);
+}
+
+
+template <class T>
+inline void
+BlockCompressedPiostream::gen_io(T& data, const char *iotype)
+{
+  if (err) return;
+  if (!transfer(&data, sizeof(data)))
+  {
+    err = true;
+    reporter_->error(std::string("BlockCompressedPiostream error ") +
+                     (dir == Read ? "reading " : "writing ") + iotype + ".");
+  }
+}
+
+
+void
+BlockCompressedPiostream::io(char& data)
+{
+  gen_io(data, "char");
+}
+
+
+void
+BlockCompressedPiostream::io(signed char& data)
+{
+  gen_io(data, "signed char");
+}
+
+
+void
+BlockCompressedPiostream::io(unsigned char& data)
+{
+  gen_io(data, "unsigned char");
+}
+
+
+void
+BlockCompressedPiostream::io(short& data)
+{
+  gen_io(data, "short");
+}
+
+
+void
+BlockCompressedPiostream::io(unsigned short& data)
+{
+  gen_io(data, "unsigned short");
+}
+
+
+void
+BlockCompressedPiostream::io(int& data)
+{
+  gen_io(data, "int");
+}
+
+
+void
+BlockCompressedPiostream::io(unsigned int& data)
+{
+  gen_io(data, "unsigned int");
+}
+
+
+void
+BlockCompressedPiostream::io(long& data)
+{
+  // 32 bits, as in BinaryPiostream
+  int tmp = data;
+  gen_io(tmp, "long");
+  data = tmp;
+}
+
+
+void
+BlockCompressedPiostream::io(unsigned long& data)
+{
+  // 32 bits, as in BinaryPiostream
+  unsigned int tmp = data;
+  gen_io(tmp, "unsigned long");
+  data = tmp;
+}
+
+
+void
+BlockCompressedPiostream::io(long long& data)
+{
+  gen_io(data, "long long");
+}
+
+
+void
+BlockCompressedPiostream::io(unsigned long long& data)
+{
+  gen_io(data, "unsigned long long");
+}
+
+
+void
+BlockCompressedPiostream::io(double& data)
+{
+  gen_io(data, "double");
+}
+
+
+void
+BlockCompressedPiostream::io(float& data)
+{
+  gen_io(data, "float");
+}
+
+
+void
+BlockCompressedPiostream::io(std::string& data)
+{
+  if (err) return;
+  unsigned int chars = 0;
+  if (dir == Write)
+  {
+    const char* p = data.c_str();
+    chars = static_cast<int>(strlen(p)) + 1;
+    io(chars);
+    if (!transfer(const_cast<char*>(p), chars)) err = true;
+  }
+  else
+  {
+    io(chars);
+    if (err) return;
+    std::vector<char> buf(chars + 1, 0);
+    if (!transfer(&buf[0], chars)) err = true;
+    data = std::string(&buf[0]);
+  }
+}
+
+
+bool
+BlockCompressedPiostream::block_io(void *data, size_t s, size_t nmemb)
+{
+  if (err) { return false; }
+  if (!transfer(data, s * nmemb))
+  {
+    err = true;
+    reporter_->error(std::string("BlockCompressedPiostream error ") +
+                     (dir == Read ? "reading" : "writing") + " block io.");
+  }
+  return true;
+}
+
+
 } // End namespace SCIRun
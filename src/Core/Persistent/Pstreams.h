@@ -45,6 +45,7 @@
 #include <Core/Persistent/Persistent.h>
 #include <cstdio>
 #include <iosfwd>
+#include <memory>
 
 #include <Core/Persistent/share.h>
 
@@ -197,6 +198,49 @@ public:
 };
 
 
+class BlockCompressedReader;
+class BlockCompressedWriter;
+
+/// Binary stream with the layout of a version 2 BinaryPiostream, written
+/// as independently deflated blocks that are compressed and decompressed
+/// on all cores. Like BinaryPiostream it writes the machine's endianness,
+/// but it cannot read files with the other one.
+class SCISHARE BlockCompressedPiostream : public Piostream {
+private:
+  FILE* fp_;
+  std::unique_ptr<BlockCompressedReader> reader_;
+  std::unique_ptr<BlockCompressedWriter> writer_;
+
+  bool transfer(void*, size_t);
+  template <class T> void gen_io(T&, const char *);
+protected:
+  virtual const char *endianness();
+  virtual void reset_post_header();
+public:
+  BlockCompressedPiostream(const std::string& filename, Direction dir,
+                           const int& v = -1, Core::Logging::LoggerHandle pr = Core::Logging::LoggerHandle());
+  virtual ~BlockCompressedPiostream();
+
+  virtual void io(char&);
+  virtual void io(signed char&);
+  virtual void io(unsigned char&);
+  virtual void io(short&);
+  virtual void io(unsigned short&);
+  virtual void io(int&);
+  virtual void io(unsigned int&);
+  virtual void io(long&);
+  virtual void io(unsigned long&);
+  virtual void io(long long&);
+  virtual void io(unsigned long long&);
+  virtual void io(double&);
+  virtual void io(float&);
+  virtual void io(std::string& str);
+
+  virtual bool supports_block_io() { return true; }
+  virtual bool block_io(void*, size_t, size_t);
+};
+
+
 } // End namespace SCIRun
 
 
@@ -0,0 +1,231 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+#include <Core/Persistent/BlockCompressedFile.h>
+#include <Core/Persistent/Pstreams.h>
+#include <Testing/Utils/SCIRunUnitTests.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace SCIRun;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  std::string outputFile(const std::string& name)
+  {
+    return (TestResources::rootDir() / "TransientOutput" / name).string();
+  }
+
+  // Compressible, but not trivially so.
+  std::vector<double> sampleData(size_t n)
+  {
+    std::vector<double> data(n);
+    for (size_t i = 0; i < n; ++i)
+      data[i] = static_cast<double>(i % 1000) * 0.5 + static_cast<double>(i / 1000);
+    return data;
+  }
+
+  void writeBlocks(const std::string& filename, const std::vector<double>& data, size_t blockSize)
+  {
+    FILE* fp = fopen(filename.c_str(), "wb");
+    ASSERT_TRUE(fp != nullptr);
+    BlockCompressedWriter writer(fp, blockSize);
+    // Uneven pieces, so writes straddle block boundaries.
+    size_t offset = 0, piece = 1;
+    while (offset < data.size())
+    {
+      const size_t n = std::min(piece, data.size() - offset);
+      EXPECT_TRUE(writer.write(&data[offset], n * sizeof(double)));
+      offset += n;
+      piece = piece * 3 + 1;
+    }
+    EXPECT_TRUE(writer.finish());
+    EXPECT_FALSE(writer.write(&data[0], sizeof(double)));
+    fclose(fp);
+  }
+}
+
+TEST(BlockCompressedFileTests, RoundTripAcrossManyBlocks)
+{
+  const auto data = sampleData(100000);
+  const std::string filename = outputFile("blocks.bcz");
+  writeBlocks(filename, data, 4096);
+
+  FILE* fp = fopen(filename.c_str(), "rb");
+  ASSERT_TRUE(fp != nullptr);
+  BlockCompressedReader reader(fp);
+  ASSERT_TRUE(reader.valid());
+  EXPECT_EQ(data.size() * sizeof(double), reader.size());
+  EXPECT_EQ((data.size() * sizeof(double) + 4095) / 4096, reader.num_blocks());
+
+  std::vector<double> back(data.size());
+  EXPECT_EQ(back.size() * sizeof(double), reader.read(&back[0], back.size() * sizeof(double)));
+  EXPECT_EQ(data, back);
+  double extra;
+  EXPECT_EQ(0u, reader.read(&extra, sizeof(extra)));
+  fclose(fp);
+}
+
+TEST(BlockCompressedFileTests, SeekReadsOnlyTheRequestedRange)
+{
+  const auto data = sampleData(100000);
+  const std::string filename = outputFile("blocks_seek.bcz");
+  writeBlocks(filename, data, 1000);
+
+  FILE* fp = fopen(filename.c_str(), "rb");
+  ASSERT_TRUE(fp != nullptr);
+  BlockCompressedReader reader(fp);
+  ASSERT_TRUE(reader.valid());
+
+  // Backwards, within a block and across block boundaries.
+  const size_t starts[] = { 99990, 12345, 12346, 0, 50000 };
+  for (size_t start : starts)
+  {
+    ASSERT_TRUE(reader.seek(start * sizeof(double)));
+    double values[10];
+    const size_t n = std::min<size_t>(10, data.size() - start);
+    ASSERT_EQ(n * sizeof(double), reader.read(values, n * sizeof(double)));
+    for (size_t i = 0; i < n; ++i)
+      EXPECT_EQ(data[start + i], values[i]);
+    EXPECT_EQ((start + n) * sizeof(double), reader.tell());
+  }
+  EXPECT_FALSE(reader.seek(reader.size() + 1));
+  fclose(fp);
+}
+
+TEST(BlockCompressedFileTests, EmptyStream)
+{
+  const std::string filename = outputFile("blocks_empty.bcz");
+  writeBlocks(filename, std::vector<double>(), 4096);
+
+  FILE* fp = fopen(filename.c_str(), "rb");
+  ASSERT_TRUE(fp != nullptr);
+  BlockCompressedReader reader(fp);
+  ASSERT_TRUE(reader.valid());
+  EXPECT_EQ(0u, reader.size());
+  EXPECT_EQ(0u, reader.num_blocks());
+  fclose(fp);
+}
+
+TEST(BlockCompressedFileTests, CorruptIndexIsRejected)
+{
+  const auto data = sampleData(10000);
+  const std::string filename = outputFile("blocks_corrupt.bcz");
+  writeBlocks(filename, data, 4096);
+
+  FILE* fp = fopen(filename.c_str(), "r+b");
+  ASSERT_TRUE(fp != nullptr);
+  fseek(fp, -1, SEEK_END);
+  fputc('?', fp);
+  fclose(fp);
+
+  fp = fopen(filename.c_str(), "rb");
+  BlockCompressedReader reader(fp);
+  EXPECT_FALSE(reader.valid());
+  double value;
+  EXPECT_EQ(0u, reader.read(&value, sizeof(value)));
+  fclose(fp);
+}
+
+TEST(BlockCompressedFileTests, PiostreamRoundTrip)
+{
+  const std::string filename = outputFile("stream.bcz");
+  auto data = sampleData(300000);
+  {
+    PiostreamPtr stream = auto_ostream(filename, "Compressed");
+    ASSERT_FALSE(stream->error());
+    int i = 42;
+    std::string s = "compressed";
+    double d = 3.5;
+    stream->io(i);
+    stream->io(s);
+    stream->io(d);
+    ASSERT_TRUE(stream->supports_block_io());
+    stream->block_io(&data[0], sizeof(double), data.size());
+    EXPECT_FALSE(stream->error());
+  }
+
+  PiostreamPtr stream = auto_istream(filename);
+  ASSERT_TRUE(stream != nullptr);
+  ASSERT_FALSE(stream->error());
+  EXPECT_TRUE(stream->reading());
+  int i = 0;
+  std::string s;
+  double d = 0;
+  stream->io(i);
+  stream->io(s);
+  stream->io(d);
+  EXPECT_EQ(42, i);
+  EXPECT_EQ("compressed", s);
+  EXPECT_EQ(3.5, d);
+  std::vector<double> back(data.size());
+  stream->block_io(&back[0], sizeof(double), back.size());
+  EXPECT_FALSE(stream->error());
+  EXPECT_EQ(data, back);
+
+  // Reading past the end is an error, as with BinaryPiostream.
+  stream->io(i);
+  EXPECT_TRUE(stream->error());
+}
+
+TEST(BlockCompressedFileTests, DISABLED_ThroughputBenchmark)
+{
+  const auto data = sampleData(64 << 20); // 512 MB
+  const size_t bytes = data.size() * sizeof(double);
+  const std::string formats[] = { "Binary", "Compressed" };
+  for (const auto& format : formats)
+  {
+    const std::string filename = outputFile("throughput_" + format + ".bin");
+    auto start = std::chrono::steady_clock::now();
+    {
+      PiostreamPtr stream = auto_ostream(filename, format);
+      stream->block_io(const_cast<double*>(&data[0]), sizeof(double), data.size());
+    }
+    const double write = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> back(data.size());
+    start = std::chrono::steady_clock::now();
+    {
+      PiostreamPtr stream = auto_istream(filename);
+      stream->block_io(&back[0], sizeof(double), back.size());
+    }
+    const double read = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(data, back);
+
+    FILE* fp = fopen(filename.c_str(), "rb");
+    fseek(fp, 0, SEEK_END);
+    const long fileSize = ftell(fp);
+    fclose(fp);
+    std::cout << format << ": write " << bytes / write / (1 << 20) << " MB/s, read "
+      << bytes / read / (1 << 20) << " MB/s, ratio " << static_cast<double>(bytes) / fileSize << std::endl;
+  }
+}
@@ -0,0 +1,426 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef BUILD_WITH_PYTHON
+#include <Core/Python/PythonDatatypeBuffer.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+
+#include <cstdint>
+#include <cstring>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Python;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  template <class T> const char* bufferFormat();
+  template <> const char* bufferFormat<double>() { return "d"; }
+  template <> const char* bufferFormat<float>() { return "f"; }
+  template <> const char* bufferFormat<char>() { return "b"; }
+  template <> const char* bufferFormat<unsigned char>() { return "B"; }
+  template <> const char* bufferFormat<short>() { return "h"; }
+  template <> const char* bufferFormat<unsigned short>() { return "H"; }
+  template <> const char* bufferFormat<int>() { return "i"; }
+  template <> const char* bufferFormat<unsigned int>() { return "I"; }
+  template <> const char* bufferFormat<long>() { return "l"; }
+  template <> const char* bufferFormat<unsigned long>() { return "L"; }
+  template <> const char* bufferFormat<long long>() { return "q"; }
+  template <> const char* bufferFormat<unsigned long long>() { return "Q"; }
+
+  /// What a view exposes, and the datatype it keeps alive.
+  struct BufferPin
+  {
+    DatatypeHandle owner;
+    void* data;
+    const char* format;
+    Py_ssize_t itemsize;
+    int ndim;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+  };
+
+  struct PyDatatypeBufferObject
+  {
+    PyObject_HEAD
+    BufferPin* pin;
+  };
+
+  int getDatatypeBuffer(PyObject* self, Py_buffer* view, int flags)
+  {
+    if (flags & PyBUF_WRITABLE)
+    {
+      PyErr_SetString(PyExc_BufferError, "SCIRun data is shared between modules and read-only, copy it (e.g. numpy.array) to modify it");
+      view->obj = nullptr;
+      return -1;
+    }
+
+    static double empty = 0.0;
+    const BufferPin* pin = reinterpret_cast<PyDatatypeBufferObject*>(self)->pin;
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = pin->data ? pin->data : &empty;
+    view->len = pin->itemsize * pin->shape[0] * (pin->ndim == 2 ? pin->shape[1] : 1);
+    view->readonly = 1;
+    view->itemsize = pin->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(pin->format) : nullptr;
+    view->ndim = pin->ndim;
+    view->shape = (flags & PyBUF_ND) ? const_cast<Py_ssize_t*>(pin->shape) : nullptr;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? const_cast<Py_ssize_t*>(pin->strides) : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+  }
+
+  void deallocDatatypeBuffer(PyObject* self)
+  {
+    delete reinterpret_cast<PyDatatypeBufferObject*>(self)->pin;
+    PyObject_Del(self);
+  }
+
+  PyTypeObject* datatypeBufferType()
+  {
+    static PyBufferProcs procs = { getDatatypeBuffer, nullptr };
+    static PyTypeObject type = { PyVarObject_HEAD_INIT(nullptr, 0) };
+    static bool ready = false;
+    if (!ready)
+    {
+      type.tp_name = "scirun.DatatypeBuffer";
+      type.tp_basicsize = sizeof(PyDatatypeBufferObject);
+      type.tp_dealloc = deallocDatatypeBuffer;
+      type.tp_as_buffer = &procs;
+      type.tp_flags = Py_TPFLAGS_DEFAULT;
+      type.tp_doc = "Read-only storage of a SCIRun datatype";
+      if (PyType_Ready(&type) < 0)
+        boost::python::throw_error_already_set();
+      ready = true;
+    }
+    return &type;
+  }
+
+  /// Wraps data of a datatype in a memoryview of rows x cols elements of T,
+  /// cols == 0 making it one dimensional.
+  template <class T>
+  boost::python::object makeView(DatatypeHandle owner, const T* data, size_t rows, size_t cols = 0)
+  {
+    auto pin = new BufferPin;
+    pin->owner = owner;
+    pin->data = const_cast<T*>(data);
+    pin->format = bufferFormat<T>();
+    pin->itemsize = sizeof(T);
+    pin->ndim = cols == 0 ? 1 : 2;
+    pin->shape[0] = rows;
+    pin->shape[1] = cols;
+    pin->strides[0] = sizeof(T) * (cols == 0 ? 1 : cols);
+    pin->strides[1] = sizeof(T);
+
+    auto self = PyObject_New(PyDatatypeBufferObject, datatypeBufferType());
+    if (!self)
+    {
+      delete pin;
+      boost::python::throw_error_already_set();
+    }
+    self->pin = pin;
+
+    auto view = PyMemoryView_FromObject(reinterpret_cast<PyObject*>(self));
+    Py_DECREF(self);
+    return boost::python::object(boost::python::handle<>(view));
+  }
+
+  template <class T>
+  bool addFieldDataView(boost::python::dict& dict, FieldHandle field, VField* vfield)
+  {
+    dict["field"] = makeView(field, static_cast<const T*>(vfield->fdata_pointer()), vfield->num_values());
+    return true;
+  }
+
+  /// Follows memoryview and NumPy array bases down to an exported view.
+  const BufferPin* findPin(PyObject* object)
+  {
+    boost::python::object current(boost::python::handle<>(boost::python::borrowed(object)));
+    for (int depth = 0; depth < 16; ++depth)
+    {
+      PyObject* ptr = current.ptr();
+      if (Py_TYPE(ptr) == datatypeBufferType())
+        return reinterpret_cast<PyDatatypeBufferObject*>(ptr)->pin;
+      if (PyMemoryView_Check(ptr))
+      {
+        PyObject* base = PyMemoryView_GET_BUFFER(ptr)->obj;
+        if (!base) return nullptr;
+        current = boost::python::object(boost::python::handle<>(boost::python::borrowed(base)));
+      }
+      else if (PyObject_HasAttrString(ptr, "base"))
+      {
+        boost::python::object base = current.attr("base");
+        if (base.is_none()) return nullptr;
+        current = base;
+      }
+      else
+        return nullptr;
+    }
+    return nullptr;
+  }
+
+  /// RAII for a buffer requested from an arbitrary exporter.
+  class ScopedBuffer
+  {
+  public:
+    explicit ScopedBuffer(PyObject* object) : valid_(false)
+    {
+      if (!PyObject_CheckBuffer(object) || PyBytes_Check(object) || PyByteArray_Check(object))
+        return;
+      if (PyObject_GetBuffer(object, &view_, PyBUF_RECORDS_RO) != 0)
+      {
+        PyErr_Clear();
+        return;
+      }
+      valid_ = true;
+    }
+    ~ScopedBuffer() { if (valid_) PyBuffer_Release(&view_); }
+    ScopedBuffer(const ScopedBuffer&) = delete;
+    ScopedBuffer& operator=(const ScopedBuffer&) = delete;
+
+    /// Numeric buffers of one or two dimensions only
+    bool usable() const
+    {
+      return valid_ && (view_.ndim == 1 || view_.ndim == 2) && !view_.suboffsets &&
+        elementKind() != 0;
+    }
+    const Py_buffer& view() const { return view_; }
+    size_t rows() const { return static_cast<size_t>(view_.shape[0]); }
+    size_t cols() const { return view_.ndim == 2 ? static_cast<size_t>(view_.shape[1]) : 1; }
+
+    /// Format character without the native byte order prefix, 0 if unsupported
+    char elementKind() const
+    {
+      const char* f = view_.format ? view_.format : "B";
+      if (*f == '@' || *f == '=') ++f;
+      if (f[0] == 0 || f[1] != 0) return 0;
+      return std::strchr("bBhHiIlLqQfd?", f[0]) ? f[0] : 0;
+    }
+
+    /// Copies rows() x cols() elements to dest in row-major order
+    template <class T>
+    void copy(T* dest) const
+    {
+      const size_t nr = rows(), nc = cols();
+      const Py_ssize_t s0 = view_.strides[0];
+      const Py_ssize_t s1 = view_.ndim == 2 ? view_.strides[1] : 0;
+      const char kind = elementKind();
+
+      if (kind == *bufferFormat<T>() && s1 == (view_.ndim == 2 ? Py_ssize_t(sizeof(T)) : 0) &&
+          s0 == Py_ssize_t(sizeof(T) * (view_.ndim == 2 ? nc : 1)))
+      {
+        // Contiguous and of the right type: one block copy
+        std::memcpy(dest, view_.buf, nr * nc * sizeof(T));
+        return;
+      }
+
+      const char* base = static_cast<const char*>(view_.buf);
+      for (size_t i = 0; i < nr; ++i)
+        for (size_t j = 0; j < nc; ++j)
+          *dest++ = element<T>(base + i * s0 + j * s1, kind);
+    }
+
+  private:
+    template <class T>
+    static T element(const char* p, char kind)
+    {
+      switch (kind)
+      {
+      case 'b': return static_cast<T>(*reinterpret_cast<const signed char*>(p));
+      case 'B': return static_cast<T>(*reinterpret_cast<const unsigned char*>(p));
+      case '?': return static_cast<T>(*reinterpret_cast<const bool*>(p));
+      case 'h': return static_cast<T>(*reinterpret_cast<const short*>(p));
+      case 'H': return static_cast<T>(*reinterpret_cast<const unsigned short*>(p));
+      case 'i': return static_cast<T>(*reinterpret_cast<const int*>(p));
+      case 'I': return static_cast<T>(*reinterpret_cast<const unsigned int*>(p));
+      case 'l': return static_cast<T>(*reinterpret_cast<const long*>(p));
+      case 'L': return static_cast<T>(*reinterpret_cast<const unsigned long*>(p));
+      case 'q': return static_cast<T>(*reinterpret_cast<const long long*>(p));
+      case 'Q': return static_cast<T>(*reinterpret_cast<const unsigned long long*>(p));
+      case 'f': return static_cast<T>(*reinterpret_cast<const float*>(p));
+      default:  return static_cast<T>(*reinterpret_cast<const double*>(p));
+      }
+    }
+
+    Py_buffer view_;
+    bool valid_;
+  };
+
+  template <class T>
+  bool copyBuffer(const boost::python::object& object, std::vector<T>& values, size_t& nrows, size_t& ncols)
+  {
+    ScopedBuffer buffer(object.ptr());
+    if (!buffer.usable())
+      return false;
+    values.resize(buffer.rows() * buffer.cols());
+    if (!values.empty()) buffer.copy(&values[0]);
+    nrows = buffer.rows();
+    ncols = buffer.cols();
+    return true;
+  }
+}
+
+boost::python::object SCIRun::Core::Python::convertMatrixToPythonBuffer(DenseMatrixHandle matrix)
+{
+  if (!matrix)
+    return {};
+  return makeView(matrix, matrix->data(), matrix->nrows(), matrix->ncols());
+}
+
+boost::python::dict SCIRun::Core::Python::convertMatrixToPythonBuffers(SparseRowMatrixHandle matrix)
+{
+  boost::python::dict dict;
+  if (!matrix)
+    return dict;
+
+  // Only compressed storage is laid out as plain row pointer, column and
+  // value arrays; anything else is compressed into a private copy first.
+  SparseRowMatrixHandle compressed = matrix;
+  if (!matrix->isCompressed())
+  {
+    compressed.reset(matrix->clone());
+    compressed->makeCompressed();
+  }
+
+  dict["nrows"] = compressed->nrows();
+  dict["ncols"] = compressed->ncols();
+  dict["rows"] = makeView(compressed, compressed->outerIndexPtr(), compressed->outerSize() + 1);
+  dict["columns"] = makeView(compressed, compressed->innerIndexPtr(), compressed->nonZeros());
+  dict["values"] = makeView(compressed, compressed->valuePtr(), compressed->nonZeros());
+  return dict;
+}
+
+boost::python::dict SCIRun::Core::Python::convertFieldToPythonBuffers(FieldHandle field)
+{
+  boost::python::dict dict;
+  if (!field)
+    return dict;
+
+  VMesh* mesh = field->vmesh();
+  VField* vfield = field->vfield();
+
+  // Structured meshes compute their nodes and elements, there is no
+  // storage to share.
+  if (mesh->is_unstructuredmesh())
+  {
+    static_assert(sizeof(Point) == 3 * sizeof(double), "Point storage is not three packed doubles");
+    const Point* points = mesh->get_points_pointer();
+    dict["node"] = makeView(field, reinterpret_cast<const double*>(points), mesh->num_nodes(), 3);
+
+    const VMesh::index_type* elems = mesh->get_elems_pointer();
+    dict["element"] = makeView(field, elems, mesh->num_elems(), mesh->num_nodes_per_elem());
+  }
+
+  if (vfield->is_nodata() || !vfield->fdata_pointer())
+    return dict;
+
+  if (vfield->is_vector())
+  {
+    static_assert(sizeof(Vector) == 3 * sizeof(double), "Vector storage is not three packed doubles");
+    auto values = static_cast<const Vector*>(vfield->fdata_pointer());
+    dict["field"] = makeView(field, reinterpret_cast<const double*>(values), vfield->num_values(), 3);
+  }
+  else if (vfield->is_scalar())
+  {
+    if (vfield->is_double()) addFieldDataView<double>(dict, field, vfield);
+    else if (vfield->is_float()) addFieldDataView<float>(dict, field, vfield);
+    else if (vfield->is_char()) addFieldDataView<char>(dict, field, vfield);
+    else if (vfield->is_unsigned_char()) addFieldDataView<unsigned char>(dict, field, vfield);
+    else if (vfield->is_short()) addFieldDataView<short>(dict, field, vfield);
+    else if (vfield->is_unsigned_short()) addFieldDataView<unsigned short>(dict, field, vfield);
+    else if (vfield->is_int()) addFieldDataView<int>(dict, field, vfield);
+    else if (vfield->is_unsigned_int()) addFieldDataView<unsigned int>(dict, field, vfield);
+    else if (vfield->is_long()) addFieldDataView<long>(dict, field, vfield);
+    else if (vfield->is_unsigned_long()) addFieldDataView<unsigned long>(dict, field, vfield);
+    else if (vfield->is_longlong()) addFieldDataView<long long>(dict, field, vfield);
+    else if (vfield->is_unsigned_longlong()) addFieldDataView<unsigned long long>(dict, field, vfield);
+  }
+  return dict;
+}
+
+DatatypeHandle SCIRun::Core::Python::pinnedDatatype(const boost::python::object& object)
+{
+  const BufferPin* pin = findPin(object.ptr());
+  if (!pin)
+    return nullptr;
+
+  // The object may be a slice or reshaped copy of the exported storage.
+  ScopedBuffer buffer(object.ptr());
+  if (!buffer.usable())
+    return nullptr;
+  const Py_buffer& view = buffer.view();
+  if (view.buf != pin->data || view.ndim != pin->ndim || view.itemsize != pin->itemsize)
+    return nullptr;
+  for (int d = 0; d < view.ndim; ++d)
+    if (view.shape[d] != pin->shape[d] || view.strides[d] != pin->strides[d])
+      return nullptr;
+  return pin->owner;
+}
+
+bool SCIRun::Core::Python::copyPythonBuffer(const boost::python::object& object, std::vector<double>& values, size_t& nrows, size_t& ncols)
+{
+  return copyBuffer(object, values, nrows, ncols);
+}
+
+bool SCIRun::Core::Python::copyPythonBuffer(const boost::python::object& object, std::vector<index_type>& values, size_t& nrows, size_t& ncols)
+{
+  return copyBuffer(object, values, nrows, ncols);
+}
+
+bool DenseMatrixBufferExtractor::check() const
+{
+  ScopedBuffer buffer(object_.ptr());
+  return buffer.usable();
+}
+
+DatatypeHandle DenseMatrixBufferExtractor::operator()() const
+{
+  auto pinned = boost::dynamic_pointer_cast<DenseMatrix>(pinnedDatatype(object_));
+  if (pinned)
+    return pinned;
+
+  ScopedBuffer buffer(object_.ptr());
+  if (!buffer.usable())
+    return nullptr;
+
+  auto dense = boost::make_shared<DenseMatrix>(buffer.rows(), buffer.cols());
+  if (dense->size() > 0)
+    buffer.copy(dense->data());
+  return dense;
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef BUILD_WITH_PYTHON
+#ifndef CORE_PYTHON_PYTHONDATATYPEBUFFER_H
+#define CORE_PYTHON_PYTHONDATATYPEBUFFER_H
+
+#include <boost/python.hpp>
+#include <vector>
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Python/PythonDatatypeConverter.h>
+
+#include <Core/Python/share.h>
+
+namespace SCIRun
+{
+  namespace Core
+  {
+    namespace Python
+    {
+      /// Zero-copy views of SCIRun data. The returned memoryviews share the
+      /// storage of the datatype, keep it alive for as long as they (or any
+      /// array built on them, e.g. numpy.asarray(view)) exist, and are
+      /// read-only since datatypes are shared between modules: use
+      /// numpy.array(view) for a private, writable copy.
+      SCISHARE boost::python::object convertMatrixToPythonBuffer(Datatypes::DenseMatrixHandle matrix);
+      /// "rows", "columns" and "values" views plus "nrows" and "ncols"
+      SCISHARE boost::python::dict convertMatrixToPythonBuffers(Datatypes::SparseRowMatrixHandle matrix);
+      /// "node" (n x 3) and "element" views of unstructured meshes, and a
+      /// "field" view of the data values
+      SCISHARE boost::python::dict convertFieldToPythonBuffers(FieldHandle field);
+
+      /// The datatype whose storage object exposes unchanged and in full,
+      /// either directly or through the base of an array made from one of
+      /// the views above. Null for any other object.
+      SCISHARE Datatypes::DatatypeHandle pinnedDatatype(const boost::python::object& object);
+
+      /// Copies a 1-D or 2-D numeric buffer (a NumPy array, memoryview,
+      /// array.array...) into row-major order in a single pass. Returns
+      /// false if object does not export such a buffer.
+      SCISHARE bool copyPythonBuffer(const boost::python::object& object, std::vector<double>& values, size_t& nrows, size_t& ncols);
+      SCISHARE bool copyPythonBuffer(const boost::python::object& object, std::vector<index_type>& values, size_t& nrows, size_t& ncols);
+
+      /// Dense matrices from buffers: views exported above convert back to
+      /// the original matrix, others are copied once.
+      class SCISHARE DenseMatrixBufferExtractor : public DatatypePythonExtractor
+      {
+      public:
+        explicit DenseMatrixBufferExtractor(const boost::python::object& object) : DatatypePythonExtractor(object) {}
+        virtual bool check() const override;
+        virtual Datatypes::DatatypeHandle operator()() const override;
+        virtual std::string label() const override { return "dense matrix"; }
+      };
+    }
+  }
+}
+
+#endif
+#endif
@@ -35,6 +35,7 @@
 #endif
 
 #include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Python/PythonDatatypeBuffer.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/String.h>
@@ -255,7 +256,7 @@ bool SparseRowMatrixExtractor::check() const
 
     boost::python::extract<boost::python::list> value_i_list(values[i]);
     boost::python::extract<size_t> value_i_int(values[i]);
-    if (!value_i_int.check() && !value_i_list.check())
+    if (!value_i_int.check() && !value_i_list.check() && !PyObject_CheckBuffer(boost::python::object(values[i]).ptr()))
       return false;
   }
 
@@ -277,19 +278,30 @@ DatatypeHandle SparseRowMatrixExtractor::operator()() const
   auto values = pyMatlabDict.values();
   size_t nrows, ncols;
 
+  // Views exported by convertMatrixToPythonBuffers come back as the matrix
+  // they were taken from.
+  {
+    auto pinned = boost::dynamic_pointer_cast<SparseRowMatrix>(pinnedDatatype(pyMatlabDict["values"]));
+    if (pinned && pinned == pinnedDatatype(pyMatlabDict["rows"]) && pinned == pinnedDatatype(pyMatlabDict["columns"]))
+      return pinned;
+  }
+
   for (int i = 0; i < length; ++i)
   {
     boost::python::extract<std::string> key_i(keys[i]);
 
     boost::python::extract<boost::python::list> value_i_list(values[i]);
     auto fieldName = key_i();
+    size_t bufferRows, bufferCols;
     if (fieldName == "rows")
     {
-      rows = to_std_vector<index_type>(value_i_list());
+      if (!copyPythonBuffer(values[i], rows, bufferRows, bufferCols))
+        rows = to_std_vector<index_type>(value_i_list());
     }
     else if (fieldName == "columns")
     {
-      columns = to_std_vector<index_type>(value_i_list());
+      if (!copyPythonBuffer(values[i], columns, bufferRows, bufferCols))
+        columns = to_std_vector<index_type>(value_i_list());
     }
     else if (fieldName == "nrows")
     {
@@ -303,7 +315,8 @@ DatatypeHandle SparseRowMatrixExtractor::operator()() const
     }
     else if (fieldName == "values")
     {
-      matrixValues = to_std_vector<double>(value_i_list());
+      if (!copyPythonBuffer(values[i], matrixValues, bufferRows, bufferCols))
+        matrixValues = to_std_vector<double>(value_i_list());
     }
   }
 
@@ -338,7 +351,7 @@ bool FieldExtractor::check() const
 
     boost::python::extract<std::string> value_i_string(values[i]);
     boost::python::extract<boost::python::list> value_i_list(values[i]);
-    if (!value_i_string.check() && !value_i_list.check())
+    if (!value_i_string.check() && !value_i_list.check() && !PyObject_CheckBuffer(boost::python::object(values[i]).ptr()))
       return false;
   }
 
@@ -347,9 +360,11 @@ bool FieldExtractor::check() const
 
 namespace
 {
-  matlabarray getPythonFieldDictionaryValue(const boost::python::extract<std::string>& strExtract, const boost::python::extract<boost::python::list>& listExtract)
+  matlabarray getPythonFieldDictionaryValue(const boost::python::object& object, const boost::python::extract<std::string>& strExtract, const boost::python::extract<boost::python::list>& listExtract)
   {
     matlabarray value;
+    std::vector<double> bufferValues;
+    size_t bufferRows, bufferCols;
     if (strExtract.check())
     {
       value.createstringarray();
@@ -388,6 +403,16 @@ namespace
         }
       }
     }
+    else if (copyPythonBuffer(object, bufferValues, bufferRows, bufferCols))
+    {
+      // Same layout as the list of row lists above, in one copy.
+      if (1 == bufferValues.size())
+        value.createdoublescalar(bufferValues[0]);
+      else if (bufferCols > 1)
+        value.createdoublematrix(bufferValues, { static_cast<int>(bufferCols), static_cast<int>(bufferRows) });
+      else
+        value.createdoublevector(bufferValues);
+    }
     return value;
   }
 }
@@ -405,6 +430,23 @@ DatatypeHandle FieldExtractor::operator()() const
 
   auto keys = pyMatlabDict.keys();
   auto values = pyMatlabDict.values();
+
+  // Views exported by convertFieldToPythonBuffers come back as the field
+  // they were taken from.
+  {
+    DatatypeHandle pinned;
+    bool allPinned = length > 0;
+    for (int i = 0; i < length && allPinned; ++i)
+    {
+      auto owner = pinnedDatatype(values[i]);
+      allPinned = owner && (!pinned || owner == pinned);
+      pinned = owner;
+    }
+    auto field = boost::dynamic_pointer_cast<Field>(pinned);
+    if (allPinned && field)
+      return field;
+  }
+
   ma.createstructarray();
 
   for (int i = 0; i < length; ++i)
@@ -415,7 +457,7 @@ DatatypeHandle FieldExtractor::operator()() const
     boost::python::extract<boost::python::list> value_i_list(values[i]);
     auto fieldName = key_i();
     //std::cout << "setting field " << fieldName << std::endl;
-    ma.setfield(0, fieldName, getPythonFieldDictionaryValue(value_i_string, value_i_list));
+    ma.setfield(0, fieldName, getPythonFieldDictionaryValue(values[i], value_i_string, value_i_list));
   }
 
   FieldHandle field;
@@ -462,6 +504,13 @@ Variable SCIRun::Core::Python::convertPythonObjectToVariable(const boost::python
       return makeVariable("bool", e());
     }
   }
+  {
+    DenseMatrixBufferExtractor e(object);
+    if (e.check())
+    {
+      return makeDatatypeVariable(e);
+    }
+  }
   {
     DenseMatrixExtractor e(object);
     if (e.check())
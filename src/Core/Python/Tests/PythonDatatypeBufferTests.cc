@@ -0,0 +1,149 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+   */
+
+#include <Python.h>
+#include <boost/python.hpp>
+
+#include <gtest/gtest.h>
+#include <Core/Python/PythonDatatypeBuffer.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Python;
+
+class DatatypeBufferTests : public testing::Test
+{
+protected:
+  virtual void SetUp() override
+  {
+    Py_Initialize();
+  }
+
+  static boost::python::object eval(const std::string& code, boost::python::object& locals)
+  {
+    auto main = boost::python::import("__main__");
+    return boost::python::eval(code.c_str(), main.attr("__dict__"), locals);
+  }
+};
+
+TEST_F(DatatypeBufferTests, DenseMatrixViewSharesStorage)
+{
+  auto matrix = boost::make_shared<DenseMatrix>(2, 3);
+  for (int i = 0; i < 6; ++i)
+    matrix->data()[i] = i;
+
+  auto view = convertMatrixToPythonBuffer(matrix);
+  boost::python::dict locals;
+  locals["m"] = view;
+  EXPECT_EQ(2, boost::python::extract<int>(eval("m.ndim", locals))());
+  EXPECT_EQ(5.0, boost::python::extract<double>(eval("m[1, 2]", locals))());
+  EXPECT_TRUE(boost::python::extract<bool>(eval("m.readonly", locals))());
+
+  matrix->data()[5] = 42.0;
+  EXPECT_EQ(42.0, boost::python::extract<double>(eval("m[1, 2]", locals))());
+}
+
+TEST_F(DatatypeBufferTests, ViewKeepsMatrixAlive)
+{
+  boost::python::object view;
+  {
+    auto matrix = boost::make_shared<DenseMatrix>(DenseMatrix::Identity(3, 3));
+    view = convertMatrixToPythonBuffer(matrix);
+  }
+  boost::python::dict locals;
+  locals["m"] = view;
+  EXPECT_EQ(1.0, boost::python::extract<double>(eval("m[2, 2]", locals))());
+}
+
+TEST_F(DatatypeBufferTests, UnchangedViewConvertsBackWithoutCopy)
+{
+  auto matrix = boost::make_shared<DenseMatrix>(DenseMatrix::Identity(4, 2));
+  auto view = convertMatrixToPythonBuffer(matrix);
+
+  DenseMatrixBufferExtractor extractor(view);
+  ASSERT_TRUE(extractor.check());
+  EXPECT_EQ(matrix, extractor());
+}
+
+TEST_F(DatatypeBufferTests, SlicedViewIsCopied)
+{
+  auto matrix = boost::make_shared<DenseMatrix>(3, 2);
+  for (int i = 0; i < 6; ++i)
+    matrix->data()[i] = i;
+  boost::python::dict locals;
+  locals["m"] = convertMatrixToPythonBuffer(matrix);
+  auto sliced = eval("m[1:]", locals);
+
+  EXPECT_FALSE(pinnedDatatype(sliced));
+  DenseMatrixBufferExtractor extractor(sliced);
+  ASSERT_TRUE(extractor.check());
+  auto copy = boost::dynamic_pointer_cast<DenseMatrix>(extractor());
+  ASSERT_TRUE(copy != nullptr);
+  ASSERT_EQ(2, copy->nrows());
+  ASSERT_EQ(2, copy->ncols());
+  EXPECT_EQ(2.0, (*copy)(0, 0));
+  EXPECT_EQ(5.0, (*copy)(1, 1));
+}
+
+TEST_F(DatatypeBufferTests, ConvertsOtherBuffersWithOneCopy)
+{
+  boost::python::dict locals;
+  auto array = eval("__import__('array').array('i', [1, 2, 3])", locals);
+
+  std::vector<double> values;
+  size_t nrows, ncols;
+  ASSERT_TRUE(copyPythonBuffer(array, values, nrows, ncols));
+  EXPECT_EQ(3u, nrows);
+  EXPECT_EQ(1u, ncols);
+  EXPECT_EQ(std::vector<double>({ 1, 2, 3 }), values);
+
+  EXPECT_FALSE(DenseMatrixBufferExtractor(eval("b'abc'", locals)).check());
+  EXPECT_FALSE(DenseMatrixBufferExtractor(eval("[1, 2]", locals)).check());
+}
+
+TEST_F(DatatypeBufferTests, SparseMatrixViews)
+{
+  SparseRowMatrixHandle sparse(new SparseRowMatrix(2, 3));
+  sparse->insert(0, 1) = 2.0;
+  sparse->insert(1, 2) = 3.0;
+  sparse->makeCompressed();
+
+  auto dict = convertMatrixToPythonBuffers(sparse);
+  std::vector<index_type> rows, columns;
+  std::vector<double> values;
+  size_t nrows, ncols;
+  ASSERT_TRUE(copyPythonBuffer(dict["rows"], rows, nrows, ncols));
+  ASSERT_TRUE(copyPythonBuffer(dict["columns"], columns, nrows, ncols));
+  ASSERT_TRUE(copyPythonBuffer(dict["values"], values, nrows, ncols));
+  EXPECT_EQ(std::vector<index_type>({ 0, 1, 2 }), rows);
+  EXPECT_EQ(std::vector<index_type>({ 1, 2 }), columns);
+  EXPECT_EQ(std::vector<double>({ 2, 3 }), values);
+  EXPECT_EQ(sparse, pinnedDatatype(dict["values"]));
+}
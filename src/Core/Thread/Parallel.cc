@@ -29,6 +29,8 @@
 #include <Core/Thread/Parallel.h>
 #include <Core/Logging/Log.h>
 #include <boost/thread/thread.hpp>
+#include <boost/scoped_array.hpp>
+#include <atomic>
 #include <vector>
 #include <iostream>
 
@@ -37,22 +39,95 @@ using namespace SCIRun::Core::Logging;
 
 void Parallel::RunTasks(IndexedTask task, int numProcs)
 {
-  boost::thread_group threads;
+  if (numProcs <= 0)
+    return;
 
-  for (int i = 0; i < capByUserCoreCount(numProcs); ++i)
+  std::vector<ThreadPool::Task> tasks(capByUserCoreCount(numProcs));
+  for (size_t i = 0; i < tasks.size(); ++i)
   {
-    threads.create_thread(boost::bind(task, i));
+    tasks[i] = boost::bind(task, static_cast<int>(i));
   }
 
-  try
+  ThreadPool::instance().runGang(tasks);
+}
+
+namespace
+{
+  // padded so that threads hammering neighbouring slices do not share a cache line
+  struct RangeSlice
+  {
+    std::atomic<size_t> next;
+    size_t end;
+    char padding[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+  };
+}
+
+void Parallel::ForRange(size_t begin, size_t end, RangeTask task, size_t grainSize)
+{
+  if (end <= begin)
+    return;
+
+  const size_t count = end - begin;
+  const size_t cores = std::max(1u, NumCores());
+  if (grainSize == 0)
+    grainSize = std::max<size_t>(1, count / (cores * 8));
+  const size_t numChunks = (count + grainSize - 1) / grainSize;
+  const size_t numThreads = std::min(cores, numChunks);
+
+  if (numThreads == 1)
   {
-    threads.join_all();
+    for (size_t chunk = begin; chunk < end; chunk += grainSize)
+      task(chunk, std::min(chunk + grainSize, end));
+    ThreadPool::instance().recordChunks(numChunks, 0);
+    return;
   }
-  catch (boost::thread_interrupted&)
+
+  boost::scoped_array<RangeSlice> slices(new RangeSlice[numThreads]);
+  const size_t chunksPerThread = numChunks / numThreads;
+  const size_t extraChunks = numChunks % numThreads;
+  size_t sliceBegin = begin;
+  for (size_t i = 0; i < numThreads; ++i)
   {
-    threads.interrupt_all();
-    throw;
+    const size_t chunks = chunksPerThread + (i < extraChunks ? 1 : 0);
+    slices[i].next = sliceBegin;
+    sliceBegin = std::min(end, sliceBegin + chunks * grainSize);
+    slices[i].end = sliceBegin;
   }
+
+  std::atomic<size_t> chunksRun(0), chunksStolen(0);
+  auto worker = [&](int thread)
+  {
+    size_t run = 0, stolen = 0;
+    for (size_t k = 0; k < numThreads; ++k)
+    {
+      auto& slice = slices[(thread + k) % numThreads];
+      for (;;)
+      {
+        const size_t chunk = slice.next.fetch_add(grainSize);
+        if (chunk >= slice.end)
+          break;
+        task(chunk, std::min(chunk + grainSize, slice.end));
+        ++run;
+        if (k > 0)
+          ++stolen;
+      }
+    }
+    chunksRun += run;
+    chunksStolen += stolen;
+  };
+
+  RunTasks(worker, static_cast<int>(numThreads));
+  ThreadPool::instance().recordChunks(chunksRun, chunksStolen);
+}
+
+ParallelStatistics Parallel::Statistics()
+{
+  return ThreadPool::instance().statistics();
+}
+
+void Parallel::ResetStatistics()
+{
+  ThreadPool::instance().resetStatistics();
 }
 
 unsigned int Parallel::NumCores()
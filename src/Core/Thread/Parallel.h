@@ -31,6 +31,7 @@
 
 #include <boost/noncopyable.hpp>
 #include <boost/function.hpp>
+#include <Core/Thread/ThreadPool.h>
 #include <Core/Thread/share.h>
 
 namespace SCIRun
@@ -43,7 +44,19 @@ namespace Thread
   {
   public:
     typedef boost::function<void(int)> IndexedTask;
+    /// Runs task(0..numProcs-1) concurrently on threads of the shared pool.
+    /// Tasks may synchronize with each other (e.g. through a Barrier).
     static void RunTasks(IndexedTask task, int numProcs);
+
+    typedef boost::function<void(size_t, size_t)> RangeTask;
+    /// Splits [begin, end) into chunks of grainSize indices (0 picks a size
+    /// from the core count) and calls task(chunkBegin, chunkEnd) for each.
+    /// Every thread starts on its own slice and steals chunks from the other
+    /// slices once it runs out. Chunks must not depend on each other.
+    static void ForRange(size_t begin, size_t end, RangeTask task, size_t grainSize = 0);
+
+    static ParallelStatistics Statistics();
+    static void ResetStatistics();
     static unsigned int NumCores();
     static void SetMaximumCores(unsigned int max);
   private:
@@ -31,6 +31,9 @@
 #include <fstream>
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/Barrier.h>
+#include <atomic>
+#include <boost/thread/thread.hpp>
 #include <boost/filesystem/path.hpp>
 #include <Testing/Utils/SCIRunUnitTests.h>
 
@@ -52,6 +55,79 @@ TEST(ParallelTests, CanDoubleNumberInParallel)
   EXPECT_EQ(expectedSum * 2, std::accumulate(nums.begin(), nums.end(), 0, std::plus<int>()));
 }
 
+TEST(ParallelTests, TasksInOneCallRunConcurrently)
+{
+  const int size = 8;
+  Barrier barrier("ParallelTests", size);
+  std::vector<int> before(size, 0), after(size, 0);
+
+  Parallel::RunTasks([&](int i) { before[i] = 1; barrier.wait(); after[i] = before[(i + 1) % size]; }, size);
+
+  EXPECT_EQ(size, std::accumulate(after.begin(), after.end(), 0));
+}
+
+TEST(ParallelTests, RunTasksReusesPoolThreads)
+{
+  Parallel::RunTasks([](int) {}, 4);
+  Parallel::ResetStatistics();
+
+  for (int run = 0; run < 100; ++run)
+    Parallel::RunTasks([](int) {}, 4);
+
+  auto stats = Parallel::Statistics();
+  EXPECT_EQ(0, stats.threadsCreated);
+  EXPECT_EQ(100, stats.gangsRun);
+  EXPECT_EQ(400, stats.tasksRun);
+  EXPECT_EQ(300, stats.tasksOnReusedThreads);
+}
+
+TEST(ParallelTests, NestedRunTasksDoNotDeadlock)
+{
+  std::atomic<int> count(0);
+  Parallel::RunTasks([&](int) { Parallel::RunTasks([&](int) { ++count; }, 3); }, 3);
+  EXPECT_EQ(9, count);
+}
+
+TEST(ParallelTests, TaskExceptionIsRethrownOnCaller)
+{
+  EXPECT_THROW(Parallel::RunTasks([](int i) { if (i == 2) throw std::runtime_error("task"); }, 4), std::runtime_error);
+  std::atomic<int> count(0);
+  Parallel::RunTasks([&](int) { ++count; }, 4);
+  EXPECT_EQ(4, count);
+}
+
+TEST(ParallelTests, ForRangeVisitsEveryIndexOnce)
+{
+  const size_t size = 100003;
+  std::vector<int> visits(size, 0);
+
+  Parallel::ForRange(0, size, [&](size_t begin, size_t end) { for (size_t i = begin; i < end; ++i) ++visits[i]; }, 17);
+
+  EXPECT_TRUE(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+}
+
+TEST(ParallelTests, ForRangeStealsFromUnevenSlices)
+{
+  Parallel::ResetStatistics();
+  std::atomic<size_t> sum(0);
+
+  Parallel::ForRange(10, 1010, [&](size_t begin, size_t end)
+  {
+    if (begin < 100)
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(2));
+    for (size_t i = begin; i < end; ++i)
+      sum += i;
+  }, 5);
+
+  EXPECT_EQ(1009 * 1010 / 2 - 9 * 10 / 2, sum);
+  auto stats = Parallel::Statistics();
+  EXPECT_EQ(200, stats.chunksRun);
+  if (Parallel::NumCores() > 1)
+  {
+    EXPECT_GT(stats.chunksStolen, 0);
+  }
+}
+
 /// @todo
 #if 0
 TEST(ParallelTests, CanDoubleNumberWithParallelForEach)
@@ -0,0 +1,293 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#include <Core/Thread/ThreadPool.h>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/make_shared.hpp>
+#include <exception>
+
+namespace SCIRun
+{
+namespace Core
+{
+namespace Thread
+{
+  struct GangState
+  {
+    boost::mutex mutex;
+    boost::condition_variable done;
+    size_t remaining{0};
+    std::exception_ptr error;
+
+    void finish(std::exception_ptr taskError)
+    {
+      boost::lock_guard<boost::mutex> lock(mutex);
+      if (taskError && !error)
+        error = taskError;
+      if (--remaining == 0)
+        done.notify_all();
+    }
+
+    void waitUninterruptibly()
+    {
+      boost::this_thread::disable_interruption noInterrupt;
+      boost::unique_lock<boost::mutex> lock(mutex);
+      while (remaining > 0)
+        done.wait(lock);
+    }
+  };
+
+  typedef boost::shared_ptr<GangState> GangStatePtr;
+
+  class PoolWorker : public boost::noncopyable
+  {
+  public:
+    explicit PoolWorker(ThreadPoolImpl* pool) : pool_(pool)
+    {
+      thread_ = boost::thread([this]() { run(); });
+    }
+
+    void assign(const ThreadPool::Task& task, GangStatePtr gang)
+    {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      task_ = task;
+      current_ = gang;
+      wake_.notify_one();
+    }
+
+    void interrupt(GangStatePtr gang)
+    {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      if (current_ == gang)
+        thread_.interrupt();
+    }
+
+    void stop()
+    {
+      {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        stop_ = true;
+        wake_.notify_one();
+      }
+      thread_.join();
+    }
+
+  private:
+    void run();
+
+    ThreadPoolImpl* pool_;
+    boost::mutex mutex_;
+    boost::condition_variable wake_;
+    ThreadPool::Task task_;
+    GangStatePtr current_;
+    bool stop_{false};
+    boost::thread thread_;
+  };
+
+  class ThreadPoolImpl
+  {
+  public:
+    ~ThreadPoolImpl()
+    {
+      for (auto& worker : workers_)
+        worker->stop();
+    }
+
+    std::vector<PoolWorker*> acquire(size_t count)
+    {
+      std::vector<PoolWorker*> acquired;
+      acquired.reserve(count);
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      while (acquired.size() < count && !idle_.empty())
+      {
+        acquired.push_back(idle_.back());
+        idle_.pop_back();
+      }
+      const size_t reused = acquired.size();
+      while (acquired.size() < count)
+      {
+        workers_.push_back(boost::make_shared<PoolWorker>(this));
+        acquired.push_back(workers_.back().get());
+      }
+      stats_.threadsCreated += count - reused;
+      stats_.tasksOnReusedThreads += reused;
+      stats_.tasksRun += count + 1;
+      ++stats_.gangsRun;
+      return acquired;
+    }
+
+    void release(PoolWorker* worker)
+    {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      idle_.push_back(worker);
+    }
+
+    mutable boost::mutex mutex_;
+    std::vector<boost::shared_ptr<PoolWorker>> workers_;
+    std::vector<PoolWorker*> idle_;
+    ParallelStatistics stats_;
+  };
+
+  void PoolWorker::run()
+  {
+    // Interruption is only meaningful while a task is running; idle workers
+    // must not be cancelled by an interrupt aimed at a gang they already left.
+    boost::this_thread::disable_interruption noInterrupt;
+    for (;;)
+    {
+      ThreadPool::Task task;
+      GangStatePtr gang;
+      {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        while (!stop_ && !task_)
+          wake_.wait(lock);
+        if (!task_)
+          return;
+        task.swap(task_);
+        gang = current_;
+      }
+
+      std::exception_ptr error;
+      {
+        boost::this_thread::restore_interruption allowInterrupt(noInterrupt);
+        try
+        {
+          task();
+        }
+        catch (boost::thread_interrupted&)
+        {
+          // the calling thread rethrows for the whole gang
+        }
+        catch (...)
+        {
+          error = std::current_exception();
+        }
+        {
+          boost::lock_guard<boost::mutex> lock(mutex_);
+          current_.reset();
+        }
+        try
+        {
+          boost::this_thread::interruption_point();
+        }
+        catch (boost::thread_interrupted&)
+        {
+        }
+      }
+
+      pool_->release(this);
+      gang->finish(error);
+    }
+  }
+}}}
+
+using namespace SCIRun::Core::Thread;
+
+ThreadPool& ThreadPool::instance()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+ThreadPool::ThreadPool() : impl_(new ThreadPoolImpl)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+}
+
+void ThreadPool::runGang(const std::vector<Task>& tasks)
+{
+  if (tasks.empty())
+    return;
+
+  auto gang = boost::make_shared<GangState>();
+  gang->remaining = tasks.size() - 1;
+  auto workers = impl_->acquire(tasks.size() - 1);
+  for (size_t i = 1; i < tasks.size(); ++i)
+    workers[i - 1]->assign(tasks[i], gang);
+
+  std::exception_ptr error;
+  try
+  {
+    try
+    {
+      tasks[0]();
+    }
+    catch (boost::thread_interrupted&)
+    {
+      throw;
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+
+    boost::unique_lock<boost::mutex> lock(gang->mutex);
+    while (gang->remaining > 0)
+      gang->done.wait(lock);
+  }
+  catch (boost::thread_interrupted&)
+  {
+    for (auto worker : workers)
+      worker->interrupt(gang);
+    // tasks usually capture the caller's stack, so they must finish before unwinding
+    gang->waitUninterruptibly();
+    throw;
+  }
+
+  if (!error)
+    error = gang->error;
+  if (error)
+    std::rethrow_exception(error);
+}
+
+void ThreadPool::recordChunks(size_t run, size_t stolen)
+{
+  boost::lock_guard<boost::mutex> lock(impl_->mutex_);
+  impl_->stats_.chunksRun += run;
+  impl_->stats_.chunksStolen += stolen;
+}
+
+ParallelStatistics ThreadPool::statistics() const
+{
+  boost::lock_guard<boost::mutex> lock(impl_->mutex_);
+  auto stats = impl_->stats_;
+  stats.idleThreads = impl_->idle_.size();
+  stats.busyThreads = impl_->workers_.size() - impl_->idle_.size();
+  return stats;
+}
+
+void ThreadPool::resetStatistics()
+{
+  boost::lock_guard<boost::mutex> lock(impl_->mutex_);
+  impl_->stats_ = ParallelStatistics();
+}
@@ -0,0 +1,88 @@
+/*
+ For more information, please see: http://software.sci.utah.edu
+
+ The MIT License
+
+ Copyright (c) 2015 Scientific Computing and Imaging Institute,
+ University of Utah.
+
+
+ Permission is hereby granted, free of charge, to any person obtaining a
+ copy of this software and associated documentation files (the "Software"),
+ to deal in the Software without restriction, including without limitation
+ the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ and/or sell copies of the Software, and to permit persons to whom the
+ Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included
+ in all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CORE_THREAD_THREADPOOL_H
+#define CORE_THREAD_THREADPOOL_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+#include <Core/Thread/share.h>
+
+namespace SCIRun
+{
+namespace Core
+{
+namespace Thread
+{
+  /// Snapshot of the shared worker pool counters, for profiling thread reuse.
+  struct SCISHARE ParallelStatistics
+  {
+    size_t threadsCreated{0};
+    size_t idleThreads{0};
+    size_t busyThreads{0};
+    size_t gangsRun{0};
+    size_t tasksRun{0};
+    size_t tasksOnReusedThreads{0};
+    size_t chunksRun{0};
+    size_t chunksStolen{0};
+  };
+
+  class ThreadPoolImpl;
+
+  /// Persistent set of worker threads behind Parallel::RunTasks.
+  ///
+  /// A "gang" of n tasks is guaranteed to run on n distinct threads at the same
+  /// time (the caller runs task 0), since algorithms such as BuildFEMatrix and
+  /// ParallelLinearAlgebra synchronize their tasks with barriers. Workers are
+  /// taken from the idle list and only created when the list runs dry, so
+  /// nested RunTasks calls still get their own threads.
+  class SCISHARE ThreadPool : public boost::noncopyable
+  {
+  public:
+    typedef boost::function<void()> Task;
+
+    static ThreadPool& instance();
+    ~ThreadPool();
+
+    /// Runs all tasks concurrently and returns once every task has finished.
+    /// The first exception thrown by a task is rethrown on the calling thread.
+    void runGang(const std::vector<Task>& tasks);
+
+    void recordChunks(size_t run, size_t stolen);
+    ParallelStatistics statistics() const;
+    void resetStatistics();
+  private:
+    ThreadPool();
+    boost::shared_ptr<ThreadPoolImpl> impl_;
+  };
+
+}}}
+
+#endif
@@ -481,6 +481,7 @@ void NetworkEditorController::loadNetwork(const NetworkFileHandle& xml)
     {
       NetworkXMLConverter conv(moduleFactory_, stateFactory_, algoFactory_, reexFactory_, this);
       theNetwork_ = conv.from_xml_data(xml->network);
+      theNetwork_->executionTimes().load(xml->moduleExecutionTimes.times);
       ModuleCounter modulesDone;
       for (size_t i = 0; i < theNetwork_->nmodules(); ++i)
       {
@@ -557,6 +558,7 @@ void NetworkEditorController::appendToNetwork(const NetworkFileHandle& xml)
       auto originalConnections = theNetwork_->connections();
 
       auto info = conv.appendXmlData(xml->network);
+      theNetwork_->executionTimes().load(remapIdBasedContainer(xml->moduleExecutionTimes.times, info.moduleIdMapping));
       auto startIndex = info.newModuleStartIndex;
       ModuleCounter modulesDone;
       for (size_t i = startIndex; i < theNetwork_->nmodules(); ++i)
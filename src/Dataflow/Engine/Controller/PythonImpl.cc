@@ -49,6 +49,7 @@
 #include <boost/range/adaptors.hpp>
 #include <boost/range/algorithm/copy.hpp>
 #include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Python/PythonDatatypeBuffer.h>
 #include <Core/Python/PythonInterpreter.h>
 
 using namespace SCIRun;
@@ -89,7 +90,7 @@ namespace
   class PyDatatypeDenseMatrix : public PyDatatype
   {
   public:
-    explicit PyDatatypeDenseMatrix(DenseMatrixHandle underlying) : underlying_(underlying), pyMat_(convertMatrixToPython(underlying))
+    explicit PyDatatypeDenseMatrix(DenseMatrixHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -100,18 +101,26 @@ namespace
 
     virtual boost::python::object value() const override
     {
+      // Built on first use only, the list copy is expensive for large matrices.
+      if (pyMat_.is_none())
+        pyMat_ = convertMatrixToPython(underlying_);
       return pyMat_;
     }
 
+    virtual boost::python::object buffer() const override
+    {
+      return convertMatrixToPythonBuffer(underlying_);
+    }
+
   private:
     DenseMatrixHandle underlying_;
-    boost::python::list pyMat_;
+    mutable boost::python::object pyMat_;
   };
 
   class PyDatatypeSparseRowMatrix : public PyDatatype
   {
   public:
-    explicit PyDatatypeSparseRowMatrix(SparseRowMatrixHandle underlying) : underlying_(underlying), pyMat_(convertMatrixToPython(underlying))
+    explicit PyDatatypeSparseRowMatrix(SparseRowMatrixHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -122,18 +131,25 @@ namespace
 
     virtual boost::python::object value() const override
     {
+      if (pyMat_.is_none())
+        pyMat_ = convertMatrixToPython(underlying_);
       return pyMat_;
     }
 
+    virtual boost::python::object buffer() const override
+    {
+      return convertMatrixToPythonBuffers(underlying_);
+    }
+
   private:
     SparseRowMatrixHandle underlying_;
-    boost::python::dict pyMat_;
+    mutable boost::python::object pyMat_;
   };
 
   class PyDatatypeField : public PyDatatype
   {
   public:
-    explicit PyDatatypeField(FieldHandle underlying) : underlying_(underlying), matlabStructure_(convertFieldToPython(underlying))
+    explicit PyDatatypeField(FieldHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -144,12 +160,19 @@ namespace
 
     virtual boost::python::object value() const override
     {
+      if (matlabStructure_.is_none())
+        matlabStructure_ = convertFieldToPython(underlying_);
       return matlabStructure_;
     }
 
+    virtual boost::python::object buffer() const override
+    {
+      return convertFieldToPythonBuffers(underlying_);
+    }
+
   private:
     FieldHandle underlying_;
-    boost::python::dict matlabStructure_;
+    mutable boost::python::object matlabStructure_;
   };
 
   class PyDatatypeFactory
@@ -33,6 +33,7 @@
 #include <Dataflow/Engine/Python/NetworkEditorPythonAPI.h>
 #include <boost/range/adaptors.hpp>
 #include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Logging/Trace.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Dataflow::Networks;
@@ -447,3 +448,23 @@ NetworkEditorPythonAPI::PythonModuleContextApiDisabler::~PythonModuleContextApiD
   if (impl_)
     impl_->setModuleContext(false);
 }
+
+std::string SimplePythonAPI::scirun_start_trace()
+{
+  Core::Logging::TraceRecorder::Instance().clear();
+  Core::Logging::TraceRecorder::Instance().start();
+  return "Tracing started";
+}
+
+std::string SimplePythonAPI::scirun_stop_trace()
+{
+  Core::Logging::TraceRecorder::Instance().stop();
+  return "Tracing stopped";
+}
+
+std::string SimplePythonAPI::scirun_write_trace(const std::string& filename)
+{
+  if (!Core::Logging::TraceRecorder::Instance().writeChromeTrace(filename))
+    return "Could not write trace file " + filename;
+  return "Trace written to " + filename;
+}
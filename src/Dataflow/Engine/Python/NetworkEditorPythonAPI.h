@@ -109,6 +109,10 @@ namespace SCIRun {
     static std::string scirun_quit();
     static std::string scirun_force_quit();
     static boost::python::object scirun_module_ids();
+
+    static std::string scirun_start_trace();
+    static std::string scirun_stop_trace();
+    static std::string scirun_write_trace(const std::string& filename);
   private:
     SimplePythonAPI() = delete;
   };
@@ -76,6 +76,9 @@ namespace SCIRun
     virtual ~PyDatatype() {}
     virtual std::string type() const = 0;
     virtual boost::python::object value() const = 0;
+    /// Zero-copy, read-only view(s) of the underlying storage, None if the
+    /// type has none.
+    virtual boost::python::object buffer() const { return {}; }
   };
 
   class SCISHARE PyPort : public boost::enable_shared_from_this<PyPort>
@@ -67,6 +67,7 @@ BOOST_PYTHON_MODULE(SCIRunPythonAPI)
   boost::python::class_<PyDatatype, boost::shared_ptr<PyDatatype>, boost::noncopyable>("SCIRun::PyDatatype", boost::python::no_init)
     .add_property("type", &PyDatatype::type)
     .add_property("value", &PyDatatype::value)
+    .add_property("buffer", &PyDatatype::buffer)
   ;
 
   //////////////////////////////////////////////////////////////////////////////////////
@@ -102,6 +103,9 @@ BOOST_PYTHON_MODULE(SCIRunPythonAPI)
   boost::python::def("scirun_run_script", &NetworkEditorPythonAPI::runScript);
   boost::python::def("scirun_quit_after_execute", &SimplePythonAPI::scirun_quit);
   boost::python::def("scirun_force_quit", &SimplePythonAPI::scirun_force_quit);
+  boost::python::def("scirun_start_trace", &SimplePythonAPI::scirun_start_trace);
+  boost::python::def("scirun_stop_trace", &SimplePythonAPI::scirun_stop_trace);
+  boost::python::def("scirun_write_trace", &SimplePythonAPI::scirun_write_trace);
 }
 
 #endif
@@ -32,6 +32,7 @@
 #include <Dataflow/Network/ModuleDescription.h>
 #include <Dataflow/Network/NetworkInterface.h>
 #include <Core/Thread/Parallel.h>
+#include <Core/Logging/Trace.h>
 #include <boost/thread.hpp>
 
 using namespace SCIRun::Dataflow::Engine;
@@ -50,6 +51,7 @@ namespace
     {
       waitForStartupInit(*lookup_);
       Guard g(executionLock_->get());
+      SCIRUN_TRACE_SCOPE("scheduler", "execute network");
       /// @todo ESSENTIAL: scoped start/finish signaling
       bounds_.executeStarts_();
       for (int group = order_.minGroup(); group <= order_.maxGroup(); ++group)
@@ -61,7 +63,11 @@ namespace
         std::transform(groupIter.first, groupIter.second, std::back_inserter(tasks),
           [&](const ParallelModuleExecutionOrder::ModulesByGroup::value_type& mod) -> boost::function<void()>
         {
-          return [=]() { lookup_->lookupExecutable(mod.second)->executeWithSignals(); };
+          return [=]()
+          {
+            SCIRUN_TRACE_SCOPE("scheduler", "dispatch", mod.second.id_);
+            lookup_->lookupExecutable(mod.second)->executeWithSignals();
+          };
         });
 
         Parallel::RunTasks([&](int i) { tasks[i](); }, tasks.size());
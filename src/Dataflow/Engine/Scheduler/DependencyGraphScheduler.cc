@@ -0,0 +1,107 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Dataflow/Engine/Scheduler/GraphNetworkAnalyzer.h>
+#include <Dataflow/Engine/Scheduler/DependencyGraphScheduler.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/ModuleExecutionTimes.h>
+#include <numeric>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Engine::NetworkGraph;
+using namespace SCIRun::Dataflow::Networks;
+
+DependencyGraphScheduler::DependencyGraphScheduler(const ModuleFilter& filter) : filter_(filter) {}
+
+ModuleDependencyGraph DependencyGraphScheduler::schedule(const NetworkInterface& network) const
+{
+  NetworkGraphAnalyzer graphAnalyzer(network, filter_, true);
+  const DirectedGraph& g = graphAnalyzer.graph();
+
+  ModuleDependencyGraph dependencies;
+  const int count = graphAnalyzer.moduleCount();
+  dependencies.modules.reserve(count);
+  dependencies.downstream.resize(count);
+  dependencies.upstreamCount.resize(count);
+
+  for (int vertex = 0; vertex < count; ++vertex)
+  {
+    dependencies.modules.push_back(graphAnalyzer.moduleAt(vertex));
+    dependencies.upstreamCount[vertex] = static_cast<int>(in_degree(vertex, g));
+
+    DirectedGraph::out_edge_iterator e, e_end;
+    for (boost::tie(e, e_end) = out_edges(vertex, g); e != e_end; ++e)
+      dependencies.downstream[vertex].push_back(static_cast<int>(target(*e, g)));
+  }
+
+  // Modules that never ran are assumed to cost the average of those that did.
+  std::vector<double> cost(count);
+  auto& times = network.executionTimes();
+  double measuredTotal = 0;
+  int measuredCount = 0;
+  for (int vertex = 0; vertex < count; ++vertex)
+  {
+    auto estimate = times.estimate(dependencies.modules[vertex]);
+    cost[vertex] = estimate ? *estimate : -1;
+    if (estimate)
+    {
+      measuredTotal += *estimate;
+      ++measuredCount;
+    }
+  }
+  const double defaultCost = measuredCount > 0 ? measuredTotal / measuredCount : 1;
+  for (auto& c : cost)
+  {
+    if (c < 0)
+      c = defaultCost;
+  }
+
+  dependencies.criticalPath.resize(count);
+  std::vector<Vertex> reverseOrder(graphAnalyzer.topologicalBegin(), graphAnalyzer.topologicalEnd());
+  for (auto v = reverseOrder.rbegin(); v != reverseOrder.rend(); ++v)
+  {
+    double longestBelow = 0;
+    for (auto down : dependencies.downstream[*v])
+      longestBelow = std::max(longestBelow, dependencies.criticalPath[down]);
+    dependencies.criticalPath[*v] = cost[*v] + longestBelow;
+  }
+
+  return dependencies;
+}
+
+std::ostream& SCIRun::Dataflow::Engine::operator<<(std::ostream& out, const ModuleDependencyGraph& graph)
+{
+  for (size_t vertex = 0; vertex < graph.size(); ++vertex)
+  {
+    out << graph.modules[vertex] << " [" << graph.criticalPath[vertex] << "] <- " << graph.upstreamCount[vertex] << " ->";
+    for (auto down : graph.downstream[vertex])
+      out << " " << graph.modules[down];
+    out << "\n";
+  }
+  return out;
+}
@@ -0,0 +1,68 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef ENGINE_SCHEDULER_DEPENDENCY_GRAPH_SCHEDULER_H
+#define ENGINE_SCHEDULER_DEPENDENCY_GRAPH_SCHEDULER_H
+
+#include <vector>
+#include <Dataflow/Network/ModuleDescription.h>
+#include <Dataflow/Engine/Scheduler/SchedulerInterfaces.h>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// Module dependencies in vertex-index form, as computed by NetworkGraphAnalyzer.
+  /// An executor counts upstreamCount down as modules finish; a module is ready at zero.
+  /// criticalPath is the estimated time from a module's start to the end of the
+  /// slowest path below it, so ready modules with larger values should go first.
+  struct SCISHARE ModuleDependencyGraph
+  {
+    std::vector<Networks::ModuleId> modules;
+    std::vector<std::vector<int>> downstream;
+    std::vector<int> upstreamCount;
+    std::vector<double> criticalPath;
+
+    size_t size() const { return modules.size(); }
+  };
+
+  SCISHARE std::ostream& operator<<(std::ostream& out, const ModuleDependencyGraph& graph);
+
+  class SCISHARE DependencyGraphScheduler : public Scheduler<ModuleDependencyGraph>
+  {
+  public:
+    explicit DependencyGraphScheduler(const Networks::ModuleFilter& filter);
+    virtual ModuleDependencyGraph schedule(const Networks::NetworkInterface& network) const override;
+  private:
+    Networks::ModuleFilter filter_;
+  };
+
+}}}
+
+#endif
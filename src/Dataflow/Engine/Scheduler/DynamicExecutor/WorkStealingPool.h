@@ -0,0 +1,250 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKSTEALINGPOOL_H
+#define ENGINE_SCHEDULER_DYNAMICEXECUTOR_WORKSTEALINGPOOL_H
+
+#include <Core/Thread/Mutex.h>
+#include <Core/Thread/ConditionVariable.h>
+#include <boost/thread/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/make_shared.hpp>
+#include <algorithm>
+#include <vector>
+
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+namespace DynamicExecutor {
+
+  /// Fixed set of worker threads, each with its own queue of work units ordered
+  /// by priority. A worker takes the highest-priority unit of its own queue
+  /// (usually a module whose inputs it just produced), and steals from another
+  /// worker when that worker holds a unit of strictly higher priority or its own
+  /// queue is empty. Idle workers sleep on a condition variable, so nothing polls.
+  class SCISHARE WorkStealingPool : boost::noncopyable
+  {
+  public:
+    /// Called with the index of the worker running the unit, so follow-up
+    /// units can be submitted to that worker's deque.
+    typedef boost::function<void(size_t)> WorkUnit;
+
+    explicit WorkStealingPool(size_t numWorkers) :
+      sleepLock_("workStealingPoolSleep"), workAvailable_("workStealingPool"), queued_(0), stop_(false), nextWorker_(0)
+    {
+      numWorkers = std::max<size_t>(numWorkers, 1);
+      for (size_t i = 0; i < numWorkers; ++i)
+        queues_.push_back(boost::make_shared<WorkerQueue>());
+      for (size_t i = 0; i < numWorkers; ++i)
+        threads_.push_back(boost::make_shared<boost::thread>([this, i]() { run(i); }));
+    }
+
+    ~WorkStealingPool()
+    {
+      {
+        Core::Thread::Guard g(sleepLock_.get());
+        stop_ = true;
+      }
+      workAvailable_.conditionBroadcast();
+      for (auto& thread : threads_)
+        thread->join();
+    }
+
+    size_t size() const { return threads_.size(); }
+
+    /// Queue a unit on the given worker's queue.
+    void submit(size_t worker, const WorkUnit& unit, double priority = 0)
+    {
+      {
+        auto& queue = *queues_[worker % queues_.size()];
+        Core::Thread::Guard g(queue.lock.get());
+        queue.units.push_back(PrioritizedUnit(priority, unit));
+        std::push_heap(queue.units.begin(), queue.units.end(), lowerPriority);
+      }
+      {
+        Core::Thread::Guard g(sleepLock_.get());
+        ++queued_;
+      }
+      workAvailable_.conditionBroadcast();
+    }
+
+    /// Queue a unit from outside the pool, spreading units round-robin.
+    void submit(const WorkUnit& unit, double priority = 0)
+    {
+      size_t worker;
+      {
+        Core::Thread::Guard g(sleepLock_.get());
+        worker = nextWorker_++;
+      }
+      submit(worker, unit, priority);
+    }
+
+    void interrupt(size_t worker)
+    {
+      threads_[worker]->interrupt();
+    }
+
+    size_t steals() const
+    {
+      Core::Thread::Guard g(sleepLock_.get());
+      return steals_;
+    }
+
+  private:
+    typedef std::pair<double, WorkUnit> PrioritizedUnit;
+
+    static bool lowerPriority(const PrioritizedUnit& a, const PrioritizedUnit& b)
+    {
+      return a.first < b.first;
+    }
+
+    struct WorkerQueue
+    {
+      WorkerQueue() : lock("workStealingQueue") {}
+      Core::Thread::Mutex lock;
+      std::vector<PrioritizedUnit> units;
+    };
+
+    bool topPriority(size_t index, double& priority) const
+    {
+      auto& queue = *queues_[index];
+      Core::Thread::Guard g(queue.lock.get());
+      if (queue.units.empty())
+        return false;
+      priority = queue.units.front().first;
+      return true;
+    }
+
+    bool pop(size_t index, WorkUnit& unit)
+    {
+      auto& queue = *queues_[index];
+      Core::Thread::Guard g(queue.lock.get());
+      if (queue.units.empty())
+        return false;
+      std::pop_heap(queue.units.begin(), queue.units.end(), lowerPriority);
+      unit.swap(queue.units.back().second);
+      queue.units.pop_back();
+      return true;
+    }
+
+    /// Picks the queue whose top unit has the highest priority, preferring the
+    /// worker's own queue on ties. The scan is not atomic across queues, so the
+    /// choice is a good guess rather than a strict global order.
+    bool take(size_t worker, WorkUnit& unit, bool& stolen)
+    {
+      double best = 0;
+      bool found = topPriority(worker, best);
+      size_t from = worker;
+      for (size_t k = 1; k < queues_.size(); ++k)
+      {
+        const size_t other = (worker + k) % queues_.size();
+        double priority;
+        if (topPriority(other, priority) && (!found || priority > best))
+        {
+          best = priority;
+          from = other;
+          found = true;
+        }
+      }
+      if (found && pop(from, unit))
+      {
+        stolen = from != worker;
+        return true;
+      }
+      // lost a race for the chosen unit; fall back to anything available
+      for (size_t k = 0; k < queues_.size(); ++k)
+      {
+        if (pop((worker + k) % queues_.size(), unit))
+        {
+          stolen = k > 0;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void run(size_t worker)
+    {
+      // a unit may be interrupted (module interrupt); the pool thread itself is not
+      boost::this_thread::disable_interruption noInterrupt;
+      for (;;)
+      {
+        WorkUnit unit;
+        bool stolen = false;
+        if (take(worker, unit, stolen))
+        {
+          {
+            Core::Thread::Guard g(sleepLock_.get());
+            --queued_;
+            if (stolen)
+              ++steals_;
+          }
+          boost::this_thread::restore_interruption allowInterrupt(noInterrupt);
+          try
+          {
+            unit(worker);
+          }
+          catch (boost::thread_interrupted&)
+          {
+          }
+          try
+          {
+            boost::this_thread::interruption_point();
+          }
+          catch (boost::thread_interrupted&)
+          {
+          }
+          continue;
+        }
+
+        Core::Thread::UniqueLock lock(sleepLock_.get());
+        while (0 == queued_ && !stop_)
+          workAvailable_.wait(lock);
+        if (stop_)
+          return;
+      }
+    }
+
+    std::vector<boost::shared_ptr<WorkerQueue>> queues_;
+    std::vector<boost::shared_ptr<boost::thread>> threads_;
+    mutable Core::Thread::Mutex sleepLock_;
+    Core::Thread::ConditionVariable workAvailable_;
+    long queued_;
+    size_t steals_{0};
+    bool stop_;
+    size_t nextWorker_;
+  };
+
+  typedef boost::shared_ptr<WorkStealingPool> WorkStealingPoolPtr;
+
+}}
+}}
+
+#endif
@@ -32,6 +32,7 @@
 #include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitProducerInterface.h>
 #include <Dataflow/Network/NetworkInterface.h>
 #include <Core/Logging/Log.h>
+#include <Core/Logging/Trace.h>
 #include <Dataflow/Engine/Scheduler/share.h>
 
 namespace SCIRun {
@@ -50,6 +51,7 @@ namespace SCIRun {
           void run()
           {
             //log_->trace_if(shouldLog_, "Module Executor: {}", module_->get_id().id_);
+            SCIRUN_TRACE_SCOPE("scheduler", "dispatch", module_->id().id_);
             auto exec = lookup_->lookupExecutable(module_->id());
             boost::signals2::scoped_connection s(exec->connectExecuteEnds(boost::bind(&ProducerInterface::enqueueReadyModules, boost::ref(*producer_))));
             exec->executeWithSignals();
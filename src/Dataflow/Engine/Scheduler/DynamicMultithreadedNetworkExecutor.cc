@@ -32,6 +32,7 @@
 #include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitProducer.h>
 
 #include <Dataflow/Engine/Scheduler/DynamicMultithreadedNetworkExecutor.h>
+#include <Core/Logging/Trace.h>
 
 using namespace SCIRun::Dataflow::Engine;
 using namespace SCIRun::Dataflow::Networks;
@@ -79,6 +80,7 @@ namespace SCIRun {
           }
 
           ScopedExecutionBoundsSignaller signaller(bounds_, [=]() { return lookup_->errorCode(); });
+          SCIRUN_TRACE_SCOPE("scheduler", "execute network");
 
           waitForStartupInit(*network_);
 
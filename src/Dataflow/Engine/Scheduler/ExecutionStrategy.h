@@ -50,7 +50,8 @@ namespace Engine {
     {
       SERIAL,
       BASIC_PARALLEL,
-      DYNAMIC_PARALLEL
+      DYNAMIC_PARALLEL,
+      WORK_STEALING_PARALLEL
       // next: pausable, then with loops
     };
 
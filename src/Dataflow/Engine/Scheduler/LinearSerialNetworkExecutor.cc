@@ -30,6 +30,7 @@
 #include <Dataflow/Engine/Scheduler/LinearSerialNetworkExecutor.h>
 #include <Dataflow/Network/ModuleInterface.h>
 #include <Dataflow/Network/NetworkInterface.h>
+#include <Core/Logging/Trace.h>
 #include <boost/thread.hpp>
 
 using namespace SCIRun::Dataflow::Engine;
@@ -48,12 +49,14 @@ namespace
     {
       waitForStartupInit(lookup_);
       Guard g(executionLock_->get());
+      SCIRUN_TRACE_SCOPE("scheduler", "execute network");
       bounds_.executeStarts_();
       for (const ModuleId& id : order_)
       {
         ExecutableObject* obj = lookup_.lookupExecutable(id);
         if (obj)
         {
+          SCIRUN_TRACE_SCOPE("scheduler", "dispatch", id.id_);
           obj->executeWithSignals();
         }
       }
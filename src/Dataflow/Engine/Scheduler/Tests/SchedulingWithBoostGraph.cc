@@ -47,6 +47,7 @@
 #include <Dataflow/Engine/Scheduler/BoostGraphParallelScheduler.h>
 #include <Dataflow/Engine/Scheduler/BasicMultithreadedNetworkExecutor.h>
 #include <Dataflow/Engine/Scheduler/BasicParallelExecutionStrategy.h>
+#include <Dataflow/Engine/Scheduler/DependencyGraphScheduler.h>
 #include <Core/Algorithms/Factory/HardCodedAlgorithmFactory.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Logging/Log.h>
@@ -341,6 +342,64 @@ TEST_F(SchedulingWithBoostGraph, ParallelNetworkOrder)
   EXPECT_EQ(expected, ostr.str());
 }
 
+TEST_F(SchedulingWithBoostGraph, DependencyGraphCountsUpstreamModules)
+{
+  setupBasicNetwork();
+
+  DependencyGraphScheduler scheduler(ExecuteAllModules::Instance());
+  auto graph = scheduler.schedule(matrixMathNetwork);
+
+  ASSERT_EQ(9, graph.size());
+  std::map<std::string, int> upstream;
+  std::map<std::string, size_t> downstream;
+  for (size_t vertex = 0; vertex < graph.size(); ++vertex)
+  {
+    upstream[graph.modules[vertex].id_] = graph.upstreamCount[vertex];
+    downstream[graph.modules[vertex].id_] = graph.downstream[vertex].size();
+  }
+
+  EXPECT_EQ(0, upstream["CreateMatrix:0"]);
+  EXPECT_EQ(0, upstream["CreateMatrix:1"]);
+  EXPECT_EQ(1, upstream["EvaluateLinearAlgebraUnary:3"]);
+  EXPECT_EQ(2, upstream["EvaluateLinearAlgebraBinary:5"]);
+  EXPECT_EQ(2, upstream["EvaluateLinearAlgebraBinary:6"]);
+  EXPECT_EQ(1, upstream["ReportMatrixInfo:8"]);
+  EXPECT_EQ(2, downstream["CreateMatrix:0"]);
+  EXPECT_EQ(2, downstream["EvaluateLinearAlgebraBinary:6"]);
+  EXPECT_EQ(0, downstream["ReportMatrixInfo:7"]);
+}
+
+TEST_F(SchedulingWithBoostGraph, DependencyGraphPrioritizesLongestPathToSink)
+{
+  setupBasicNetwork();
+
+  auto& times = matrixMathNetwork.executionTimes();
+  times.record(ModuleId("CreateMatrix:0"), 1);
+  times.record(ModuleId("CreateMatrix:1"), 1);
+  times.record(ModuleId("EvaluateLinearAlgebraUnary:2"), 1);
+  times.record(ModuleId("EvaluateLinearAlgebraUnary:3"), 1);
+  times.record(ModuleId("EvaluateLinearAlgebraUnary:4"), 10);
+  times.record(ModuleId("EvaluateLinearAlgebraUnary:4"), 30);
+  times.record(ModuleId("EvaluateLinearAlgebraBinary:5"), 1);
+  times.record(ModuleId("EvaluateLinearAlgebraBinary:6"), 1);
+  // the two ReportMatrixInfo modules have no history and get the average cost
+
+  DependencyGraphScheduler scheduler(ExecuteAllModules::Instance());
+  auto graph = scheduler.schedule(matrixMathNetwork);
+
+  std::map<std::string, double> criticalPath;
+  for (size_t vertex = 0; vertex < graph.size(); ++vertex)
+    criticalPath[graph.modules[vertex].id_] = graph.criticalPath[vertex];
+
+  const double report = (4 * 1 + 20 + 2 * 1) / 7.0;
+  EXPECT_DOUBLE_EQ(report, criticalPath["ReportMatrixInfo:7"]);
+  EXPECT_DOUBLE_EQ(1 + report, criticalPath["EvaluateLinearAlgebraBinary:6"]);
+  EXPECT_DOUBLE_EQ(22 + report, criticalPath["EvaluateLinearAlgebraUnary:4"]);
+  EXPECT_DOUBLE_EQ(23 + report, criticalPath["CreateMatrix:1"]);
+  EXPECT_DOUBLE_EQ(4 + report, criticalPath["CreateMatrix:0"]);
+  EXPECT_GT(criticalPath["CreateMatrix:1"], criticalPath["CreateMatrix:0"]);
+}
+
 TEST_F(SchedulingWithBoostGraph, ParallelNetworkOrderWithSomeModulesDone)
 {
   setupBasicNetwork();
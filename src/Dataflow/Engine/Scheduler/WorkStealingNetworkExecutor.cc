@@ -0,0 +1,150 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkStealingPool.h>
+#include <Dataflow/Engine/Scheduler/WorkStealingNetworkExecutor.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Core/Logging/Trace.h>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/atomic.hpp>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Engine::DynamicExecutor;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  class WorkStealingRun : public WaitsForStartupInitialization, public boost::enable_shared_from_this<WorkStealingRun>
+  {
+  public:
+    WorkStealingRun(const ExecutionContext& context, const NetworkInterface* network, const ModuleDependencyGraph& graph,
+      WorkStealingPoolPtr pool, Mutex* executionLock) :
+      lookup_(&context.lookup),
+      bounds_(&context.bounds()),
+      network_(network),
+      graph_(graph),
+      pool_(pool),
+      executionLock_(executionLock),
+      upstreamRemaining_(new boost::atomic<int>[graph.size()]),
+      unfinished_(graph.size()),
+      runningLock_("workStealingRun"),
+      allDone_("workStealingRun")
+    {
+      for (size_t vertex = 0; vertex < graph_.size(); ++vertex)
+        upstreamRemaining_[vertex] = graph_.upstreamCount[vertex];
+    }
+
+    void operator()()
+    {
+      Guard g(executionLock_->get());
+
+      boost::signals2::scoped_connection interruptCxn(network_->connectModuleInterrupted([this](const std::string& id) { interruptModule(id); }));
+
+      ScopedExecutionBoundsSignaller signaller(bounds_, [this]() { return lookup_->errorCode(); });
+      SCIRUN_TRACE_SCOPE("scheduler", "execute network");
+
+      waitForStartupInit(*network_);
+
+      auto self = shared_from_this();
+      for (size_t vertex = 0; vertex < graph_.size(); ++vertex)
+      {
+        if (0 == graph_.upstreamCount[vertex])
+          pool_->submit([self, vertex](size_t worker) { self->runModule(vertex, worker); }, graph_.criticalPath[vertex]);
+      }
+
+      UniqueLock lock(runningLock_.get());
+      while (unfinished_ > 0)
+        allDone_.wait(lock);
+    }
+
+  private:
+    void runModule(size_t vertex, size_t worker)
+    {
+      const auto& id = graph_.modules[vertex];
+      SCIRUN_TRACE_SCOPE("scheduler", "dispatch", id.id_);
+      {
+        Guard g(runningLock_.get());
+        runningOn_[id.id_] = worker;
+      }
+
+      lookup_->lookupExecutable(id)->executeWithSignals();
+
+      {
+        // after this, interrupts for this module can no longer reach the worker
+        Guard g(runningLock_.get());
+        runningOn_.erase(id.id_);
+      }
+
+      auto self = shared_from_this();
+      for (auto down : graph_.downstream[vertex])
+      {
+        if (1 == upstreamRemaining_[down].fetch_sub(1))
+          pool_->submit(worker, [self, down](size_t w) { self->runModule(down, w); }, graph_.criticalPath[down]);
+      }
+
+      Guard g(runningLock_.get());
+      if (0 == --unfinished_)
+        allDone_.conditionBroadcast();
+    }
+
+    void interruptModule(const std::string& id) const
+    {
+      Guard g(runningLock_.get());
+      auto running = runningOn_.find(id);
+      if (running != runningOn_.end())
+        pool_->interrupt(running->second);
+    }
+
+    const ExecutableLookup* lookup_;
+    const ExecutionBounds* bounds_;
+    const NetworkInterface* network_;
+    ModuleDependencyGraph graph_;
+    WorkStealingPoolPtr pool_;
+    Mutex* executionLock_;
+    boost::scoped_array<boost::atomic<int>> upstreamRemaining_;
+    size_t unfinished_;
+    std::map<std::string, size_t> runningOn_;
+    mutable Mutex runningLock_;
+    ConditionVariable allDone_;
+  };
+}
+
+WorkStealingNetworkExecutor::WorkStealingNetworkExecutor(const NetworkInterface& network, WorkStealingPoolPtr pool) :
+  network_(network), pool_(pool)
+{
+}
+
+void WorkStealingNetworkExecutor::execute(const ExecutionContext& context, ModuleDependencyGraph order, Mutex& executionLock)
+{
+  LOG_TRACE("WorkStealingNetworkExecutor: executing {} modules on {} workers", order.size(), pool_->size());
+
+  auto run = boost::make_shared<WorkStealingRun>(context, &network_, order, pool_, &executionLock);
+  boost::thread execution([run]() { (*run)(); });
+}
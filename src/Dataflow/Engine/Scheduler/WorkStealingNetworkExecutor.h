@@ -0,0 +1,60 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef ENGINE_SCHEDULER_WORKSTEALINGNETWORKEXECUTOR_H
+#define ENGINE_SCHEDULER_WORKSTEALINGNETWORKEXECUTOR_H
+
+#include <Dataflow/Engine/Scheduler/DependencyGraphScheduler.h>
+#include <Dataflow/Engine/Scheduler/SchedulerInterfaces.h>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+  namespace Engine {
+
+    namespace DynamicExecutor
+    {
+      class WorkStealingPool;
+    }
+
+  /// Runs each module on a bounded worker pool as soon as all of its upstream
+  /// modules have finished, tracked by per-module atomic dependency counters.
+  /// Ready modules are dispatched longest-critical-path first.
+  class SCISHARE WorkStealingNetworkExecutor : public NetworkExecutor<ModuleDependencyGraph>
+  {
+  public:
+    WorkStealingNetworkExecutor(const Networks::NetworkInterface& network, boost::shared_ptr<DynamicExecutor::WorkStealingPool> pool);
+    virtual void execute(const ExecutionContext& context, ModuleDependencyGraph order, Core::Thread::Mutex& executionLock) override;
+  private:
+    const Networks::NetworkInterface& network_;
+    boost::shared_ptr<DynamicExecutor::WorkStealingPool> pool_;
+  };
+
+}}}
+
+#endif
@@ -25,8 +25,11 @@
    DEALINGS IN THE SOFTWARE.
 */
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
+#include <iomanip>
+#include <limits>
 #include <boost/lexical_cast.hpp>
 #include <boost/bind.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -44,8 +47,10 @@
 // ReSharper disable once CppUnusedIncludeDirective
 #include <Dataflow/Network/DataflowInterfaces.h>
 #include <Dataflow/Network/ModuleBuilder.h>
+#include <Dataflow/Network/ModuleOutputCache.h>
 #include <Core/Logging/ConsoleLogger.h>
 #include <Core/Logging/Log.h>
+#include <Core/Logging/Trace.h>
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/Interruptible.h>
 
@@ -192,6 +197,10 @@ namespace SCIRun
         UiToggleFunc uiToggleFunc_;
 
         bool returnCode_{ false };
+        // Outputs sent during an execution whose results go to the output cache.
+        boost::optional<ModuleOutputCache::PortData> sentOutputs_;
+        // needToExecute() answer fixed for the rest of a cached execution.
+        boost::optional<bool> needToExecute_;
       };
     }
   }
@@ -361,6 +370,7 @@ void Module::copyStateToMetadata()
 
 bool Module::executeWithSignals() NOEXCEPT
 {
+  SCIRUN_TRACE_SCOPE("module", id().id_);
   auto starting = "STARTING MODULE: " + id().id_;
 #ifdef BUILD_HEADLESS //TODO: better headless logging
   static Mutex executeLogLock("headlessExecution");
@@ -388,7 +398,7 @@ bool Module::executeWithSignals() NOEXCEPT
   try
   {
     if (!executionDisabled())
-      execute();
+      executeOrLoadCachedOutputs();
 
     impl_->returnCode_ = true;
     getLogger()->setErrorFlag(false);
@@ -594,9 +604,99 @@ void Module::send_output_handle(const PortId& id, DatatypeHandle data)
     THROW_OUT_OF_RANGE("Output port does not exist: " + id.toString());
   }
 
+  if (impl_->sentOutputs_)
+    impl_->sentOutputs_->emplace_back(id, data);
+
   impl_->oports_[id]->sendData(data);
 }
 
+namespace
+{
+  // stateMetaInfo rounds doubles to six digits; a cache key has to tell apart
+  // any two states that can produce different outputs.
+  std::string exactStateDescription(const ModuleStateHandle& state)
+  {
+    if (!state)
+      return std::string();
+    std::ostringstream ostr;
+    ostr << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (const auto& key : state->getKeys())
+      ostr << "[" << key.name() << ", " << state->getValue(key).value() << "]";
+    return ostr.str();
+  }
+
+  class PinnedAnswer
+  {
+  public:
+    PinnedAnswer(boost::optional<bool>& slot, bool value) : slot_(slot) { slot_ = value; }
+    ~PinnedAnswer() { slot_.reset(); }
+  private:
+    boost::optional<bool>& slot_;
+  };
+}
+
+void Module::executeOrLoadCachedOutputs()
+{
+  auto& cache = ModuleOutputCache::Instance();
+  if (!cachesOutputsOnDisk() || !cache.enabled())
+  {
+    execute();
+    return;
+  }
+
+  // Decide once, before touching the disk, whether the module has anything new
+  // to compute. needToExecute() consumes its flags, so the answer is pinned for
+  // the execute() call below; with nothing changed and the last outputs still on
+  // the ports, the module's own guard keeps them and downstream stays put.
+  for (const auto& input : inputPorts())
+    impl_->inputsChanged_ = input->hasChanged() || impl_->inputsChanged_;
+  const auto outputs = outputPorts();
+  const bool outputsHeld = std::all_of(outputs.begin(), outputs.end(), [](const OutputPortHandle& out) { return out->hasData(); });
+  const bool recompute = needToExecute() || !outputsHeld;
+  PinnedAnswer pinned(impl_->needToExecute_, recompute);
+
+  if (!recompute)
+  {
+    execute();
+    return;
+  }
+
+  ModuleOutputCache::PortData inputs;
+  for (const auto& input : inputPorts())
+  {
+    auto data = input->getData();
+    inputs.emplace_back(input->id(), data ? *data : nullptr);
+  }
+  auto key = cache.key(id().id_, exactStateDescription(cstate()), inputs);
+
+  ModuleOutputCache::PortData sent;
+  if (key && cache.load(*key, sent))
+  {
+    for (const auto& output : sent)
+    {
+      if (impl_->oports_.hasPort(output.first))
+        send_output_handle(output.first, output.second);
+    }
+    remark("Outputs loaded from the output cache.");
+    return;
+  }
+
+  impl_->sentOutputs_ = ModuleOutputCache::PortData();
+  try
+  {
+    execute();
+  }
+  catch (...)
+  {
+    impl_->sentOutputs_.reset();
+    throw;
+  }
+  sent.swap(*impl_->sentOutputs_);
+  impl_->sentOutputs_.reset();
+  if (key && !sent.empty() && !errorReported())
+    cache.store(*key, sent);
+}
+
 std::vector<InputPortHandle> Module::findInputPortsWithName(const std::string& name) const
 {
   return impl_->iports_[name];
@@ -840,6 +940,8 @@ ModuleExecutionState& Module::executionState()
 // need to hook up output ports for cached state.
 bool Module::needToExecute() const
 {
+  if (impl_->needToExecute_)
+    return *impl_->needToExecute_;
   static Mutex needToExecuteLock("needToExecute");
   if (impl_->reexecute_)
   {
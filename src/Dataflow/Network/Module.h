@@ -76,6 +76,8 @@ namespace Networks {
     void status(const std::string& msg) const override final { getLogger()->status(msg); }
     bool needToExecute() const override final;
     bool hasDynamicPorts() const override;
+    // Modules with expensive, deterministic execute() opt in with OUTPUTS_CACHED_ON_DISK.
+    virtual bool cachesOutputsOnDisk() const { return false; }
 
     /*** public Dev-interface ****/
     boost::signals2::connection connectExecuteSelfRequest(const ExecutionSelfRequestSignalType::slot_type& subscriber) override final;
@@ -193,6 +195,7 @@ namespace Networks {
     boost::optional<boost::shared_ptr<T>> getOptionalInputAtIndex(const PortId& id);
     template <class T>
     boost::shared_ptr<T> checkInput(Core::Datatypes::DatatypeHandleOption inputOpt, const PortId& id);
+    void executeOrLoadCachedOutputs();
 
     friend class ModuleImpl;
     boost::shared_ptr<class ModuleImpl> impl_;
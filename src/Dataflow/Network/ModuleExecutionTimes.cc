@@ -0,0 +1,110 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Dataflow/Network/ModuleExecutionTimes.h>
+#include <Dataflow/Network/ModuleDescription.h>
+#include <numeric>
+
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Thread;
+
+ModuleExecutionTimes::ModuleExecutionTimes() : lock_("moduleExecutionTimes")
+{
+}
+
+void ModuleExecutionTimes::executionBegins(const ModuleId& id)
+{
+  Guard g(lock_.get());
+  running_[id.id_] = Clock::now();
+}
+
+void ModuleExecutionTimes::executionEnds(const ModuleId& id)
+{
+  double seconds;
+  {
+    Guard g(lock_.get());
+    auto start = running_.find(id.id_);
+    if (start == running_.end())
+      return;
+    seconds = std::chrono::duration<double>(Clock::now() - start->second).count();
+    running_.erase(start);
+  }
+  record(id, seconds);
+}
+
+void ModuleExecutionTimes::record(const ModuleId& id, double seconds)
+{
+  Guard g(lock_.get());
+  auto& runs = history_[id.id_];
+  runs.push_back(seconds);
+  if (runs.size() > HistoryLength)
+    runs.pop_front();
+}
+
+namespace
+{
+  double mean(const std::deque<double>& runs)
+  {
+    return std::accumulate(runs.begin(), runs.end(), 0.0) / runs.size();
+  }
+}
+
+boost::optional<double> ModuleExecutionTimes::estimate(const ModuleId& id) const
+{
+  Guard g(lock_.get());
+  auto runs = history_.find(id.id_);
+  if (runs == history_.end() || runs->second.empty())
+    return boost::none;
+  return mean(runs->second);
+}
+
+ModuleExecutionTimes::EstimateMap ModuleExecutionTimes::estimates() const
+{
+  Guard g(lock_.get());
+  EstimateMap estimates;
+  for (const auto& runs : history_)
+  {
+    if (!runs.second.empty())
+      estimates[runs.first] = mean(runs.second);
+  }
+  return estimates;
+}
+
+void ModuleExecutionTimes::load(const EstimateMap& estimates)
+{
+  Guard g(lock_.get());
+  for (const auto& estimate : estimates)
+    history_[estimate.first] = { estimate.second };
+}
+
+void ModuleExecutionTimes::clear()
+{
+  Guard g(lock_.get());
+  running_.clear();
+  history_.clear();
+}
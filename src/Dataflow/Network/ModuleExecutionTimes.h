@@ -0,0 +1,75 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef DATAFLOW_NETWORK_MODULE_EXECUTION_TIMES_H
+#define DATAFLOW_NETWORK_MODULE_EXECUTION_TIMES_H
+
+#include <map>
+#include <deque>
+#include <chrono>
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+#include <Dataflow/Network/NetworkFwd.h>
+#include <Core/Thread/Mutex.h>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  /// Wall-clock execution time history of the modules in a network, used by
+  /// schedulers to estimate the cost of each module. Saved with the network file.
+  class SCISHARE ModuleExecutionTimes : boost::noncopyable
+  {
+  public:
+    using EstimateMap = std::map<std::string, double>;
+
+    ModuleExecutionTimes();
+
+    void executionBegins(const ModuleId& id);
+    void executionEnds(const ModuleId& id);
+    void record(const ModuleId& id, double seconds);
+
+    /// Mean of the most recent runs, in seconds.
+    boost::optional<double> estimate(const ModuleId& id) const;
+    EstimateMap estimates() const;
+    /// Replaces the history of the given modules with a single sample each.
+    void load(const EstimateMap& estimates);
+    void clear();
+
+    static const size_t HistoryLength = 8;
+  private:
+    using Clock = std::chrono::steady_clock;
+    mutable Core::Thread::Mutex lock_;
+    std::map<std::string, Clock::time_point> running_;
+    std::map<std::string, std::deque<double>> history_;
+  };
+
+}}}
+
+#endif
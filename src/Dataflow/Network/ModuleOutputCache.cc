@@ -0,0 +1,550 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Dataflow/Network/ModuleOutputCache.h>
+#include <Core/Datatypes/Datatype.h>
+#include <Core/Persistent/Persistent.h>
+#include <Core/Logging/Log.h>
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+namespace fs = boost::filesystem;
+
+namespace
+{
+  const std::string ENTRY_EXTENSION = ".cache";
+  const int ENTRY_VERSION = 1;
+
+  /// 128 bit non-cryptographic hash of a byte stream (two MurmurHash3 style
+  /// lanes over 8 byte words).
+  class ContentHasher
+  {
+  public:
+    void update(const void* data, size_t size)
+    {
+      auto bytes = static_cast<const unsigned char*>(data);
+      length_ += size;
+      while (size > 0)
+      {
+        if (pending_ == 0 && size >= 8)
+        {
+          boost::uint64_t word;
+          memcpy(&word, bytes, 8);
+          mix(word);
+          bytes += 8;
+          size -= 8;
+        }
+        else
+        {
+          buffer_[pending_++] = *bytes++;
+          --size;
+          if (pending_ == 8)
+          {
+            boost::uint64_t word;
+            memcpy(&word, buffer_, 8);
+            mix(word);
+            pending_ = 0;
+          }
+        }
+      }
+    }
+
+    void update(const std::string& str)
+    {
+      boost::uint64_t size = str.size();
+      update(&size, sizeof(size));
+      update(str.data(), str.size());
+    }
+
+    std::string digest()
+    {
+      if (pending_ > 0)
+      {
+        boost::uint64_t word = 0;
+        memcpy(&word, buffer_, pending_);
+        mix(word);
+        pending_ = 0;
+      }
+      auto h1 = h1_ ^ length_, h2 = h2_ ^ length_;
+      h1 += h2;
+      h2 += h1;
+      h1 = fmix(h1);
+      h2 = fmix(h2);
+      h1 += h2;
+      h2 += h1;
+      std::ostringstream ostr;
+      ostr << std::hex << std::setfill('0') << std::setw(16) << h1 << std::setw(16) << h2;
+      return ostr.str();
+    }
+
+  private:
+    static boost::uint64_t rotl(boost::uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+    static boost::uint64_t fmix(boost::uint64_t k)
+    {
+      k ^= k >> 33;
+      k *= 0xff51afd7ed558ccdULL;
+      k ^= k >> 33;
+      k *= 0xc4ceb9fe1a85ec53ULL;
+      k ^= k >> 33;
+      return k;
+    }
+    void mix(boost::uint64_t k)
+    {
+      const boost::uint64_t c1 = 0x87c37b91114253d5ULL, c2 = 0x4cf5ad432745937fULL;
+      auto k1 = rotl(k * c1, 31) * c2;
+      h1_ ^= k1;
+      h1_ = (rotl(h1_, 27) + h2_) * 5 + 0x52dce729;
+      auto k2 = rotl(k * c2, 33) * c1;
+      h2_ ^= k2;
+      h2_ = (rotl(h2_, 31) + h1_) * 5 + 0x38495ab5;
+    }
+
+    boost::uint64_t h1_ = 0x9e3779b97f4a7c15ULL, h2_ = 0xc2b2ae3d27d4eb4fULL, length_ = 0;
+    unsigned char buffer_[8];
+    size_t pending_ = 0;
+  };
+
+  /// Write-only stream that feeds everything a datatype serializes into a hash.
+  class HashingPiostream : public Piostream
+  {
+  public:
+    explicit HashingPiostream(ContentHasher& hasher) : Piostream(Write, PERSISTENT_VERSION, "", Core::Logging::LoggerHandle()), hasher_(hasher) {}
+
+    void io(char& d) override { add(d); }
+    void io(signed char& d) override { add(d); }
+    void io(unsigned char& d) override { add(d); }
+    void io(short& d) override { add(d); }
+    void io(unsigned short& d) override { add(d); }
+    void io(int& d) override { add(d); }
+    void io(unsigned int& d) override { add(d); }
+    void io(long& d) override { add(d); }
+    void io(unsigned long& d) override { add(d); }
+    void io(long long& d) override { add(d); }
+    void io(unsigned long long& d) override { add(d); }
+    void io(double& d) override { add(d); }
+    void io(float& d) override { add(d); }
+    void io(std::string& str) override { hasher_.update(str); }
+    bool supports_block_io() override { return true; }
+    bool block_io(void* data, size_t s, size_t nmemb) override
+    {
+      hasher_.update(data, s * nmemb);
+      return true;
+    }
+  private:
+    void reset_post_header() override {}
+    template <class T> void add(const T& d) { hasher_.update(&d, sizeof(d)); }
+    ContentHasher& hasher_;
+  };
+
+  struct ClassNameFound
+  {
+    std::string name;
+  };
+
+  /// Write-only stream that stops at the first class the datatype writes.
+  class ClassNameProbe : public Piostream
+  {
+  public:
+    ClassNameProbe() : Piostream(Write, PERSISTENT_VERSION, "", Core::Logging::LoggerHandle()) {}
+
+    int begin_class(const std::string& name, int) override { throw ClassNameFound{ name }; }
+
+    void io(char&) override {}
+    void io(signed char&) override {}
+    void io(unsigned char&) override {}
+    void io(short&) override {}
+    void io(unsigned short&) override {}
+    void io(int&) override {}
+    void io(unsigned int&) override {}
+    void io(long&) override {}
+    void io(unsigned long&) override {}
+    void io(long long&) override {}
+    void io(unsigned long long&) override {}
+    void io(double&) override {}
+    void io(float&) override {}
+    void io(std::string&) override {}
+  private:
+    void reset_post_header() override {}
+  };
+
+  /// The registered class a datatype writes itself as. Datatypes that do not
+  /// implement io() would be written as nothing and could not be told apart,
+  /// or read back.
+  PersistentTypeIDPtr persistentType(const DatatypeHandle& data)
+  {
+    try
+    {
+      ClassNameProbe probe;
+      data->io(probe);
+    }
+    catch (const ClassNameFound& found)
+    {
+      auto pid = Persistent::find_class(found.name);
+      if (pid && pid->maker)
+        return pid;
+    }
+    return PersistentTypeIDPtr();
+  }
+
+  bool isSerializable(const DatatypeHandle& data)
+  {
+    return !data || persistentType(data);
+  }
+
+  /// Writes the class name ahead of the object, so reading does not depend on
+  /// the whole chain of base classes being registered.
+  void pioDatatype(Piostream& stream, DatatypeHandle& data)
+  {
+    PersistentTypeIDPtr pid;
+    std::string className;
+    if (!stream.reading() && data)
+    {
+      pid = persistentType(data);
+      if (!pid)
+      {
+        stream.flag_error();
+        return;
+      }
+      className = pid->type;
+    }
+    stream.io(className);
+    if (className.empty())
+    {
+      if (stream.reading())
+        data.reset();
+      return;
+    }
+    if (stream.reading())
+    {
+      pid = Persistent::find_class(className);
+      if (!pid || !pid->maker)
+      {
+        stream.flag_error();
+        return;
+      }
+    }
+    PersistentHandle h = data;
+    stream.io(h, *pid);
+    if (stream.reading())
+      data = boost::dynamic_pointer_cast<Datatype>(h);
+  }
+}
+
+ModuleOutputCache& ModuleOutputCache::Instance()
+{
+  static ModuleOutputCache instance;
+  return instance;
+}
+
+ModuleOutputCache::ModuleOutputCache() : lock_("moduleOutputCache"), enabled_(false), maxBytes_(0), useCount_(0)
+{
+}
+
+void ModuleOutputCache::enable(const fs::path& directory, boost::uint64_t maxBytes, const std::string& buildVersion)
+{
+  Guard g(lock_.get());
+  boost::system::error_code ec;
+  fs::create_directories(directory, ec);
+  if (!fs::is_directory(directory, ec))
+  {
+    LOG_DEBUG("Module output cache directory {} is not usable, cache disabled.", directory.string());
+    enabled_ = false;
+    return;
+  }
+
+  directory_ = directory;
+  maxBytes_ = maxBytes;
+  buildVersion_ = buildVersion;
+  entries_.clear();
+  stats_ = ModuleOutputCacheStatistics();
+
+  for (fs::directory_iterator file(directory, ec), end; !ec && file != end; file.increment(ec))
+  {
+    const auto& path = file->path();
+    boost::system::error_code fileError;
+    if (path.extension() != ENTRY_EXTENSION || !fs::is_regular_file(path, fileError))
+      continue;
+    Entry entry{ fs::file_size(path, fileError), fs::last_write_time(path, fileError), 0 };
+    if (!fileError)
+    {
+      entries_[path.stem().string()] = entry;
+      stats_.bytes += entry.size;
+    }
+  }
+  stats_.entries = entries_.size();
+  enabled_ = true;
+  evict();
+}
+
+void ModuleOutputCache::disable()
+{
+  Guard g(lock_.get());
+  enabled_ = false;
+}
+
+bool ModuleOutputCache::enabled() const
+{
+  Guard g(lock_.get());
+  return enabled_;
+}
+
+fs::path ModuleOutputCache::entryPath(const std::string& key) const
+{
+  return directory_ / (key + ENTRY_EXTENSION);
+}
+
+std::string ModuleOutputCache::contentHash(const DatatypeHandle& data) const
+{
+  {
+    Guard g(lock_.get());
+    auto known = contentHashes_.find(data->id());
+    if (known != contentHashes_.end())
+      return known->second;
+  }
+
+  ContentHasher hasher;
+  hasher.update(data->dynamic_type_name());
+  HashingPiostream stream(hasher);
+  auto copy = data;
+  pioDatatype(stream, copy);
+  auto hash = hasher.digest();
+
+  Guard g(lock_.get());
+  if (contentHashes_.size() > 4096)
+    contentHashes_.clear();
+  contentHashes_[data->id()] = hash;
+  return hash;
+}
+
+boost::optional<std::string> ModuleOutputCache::key(const std::string& moduleId, const std::string& state, const PortData& inputs) const
+{
+  ContentHasher hasher;
+  hasher.update(&ENTRY_VERSION, sizeof(ENTRY_VERSION));
+  {
+    Guard g(lock_.get());
+    hasher.update(buildVersion_);
+  }
+  hasher.update(moduleId);
+  hasher.update(state);
+  for (const auto& input : inputs)
+  {
+    hasher.update(input.first.toString());
+    if (!input.second)
+    {
+      hasher.update(std::string("null"));
+      continue;
+    }
+    if (!isSerializable(input.second))
+      return boost::none;
+    hasher.update(contentHash(input.second));
+  }
+  return hasher.digest();
+}
+
+bool ModuleOutputCache::load(const std::string& key, PortData& outputs)
+{
+  fs::path path;
+  {
+    Guard g(lock_.get());
+    if (!enabled_)
+      return false;
+    if (entries_.find(key) == entries_.end())
+    {
+      ++stats_.misses;
+      return false;
+    }
+    path = entryPath(key);
+  }
+
+  PortData loaded;
+  bool ok = false;
+  try
+  {
+    auto stream = auto_istream(path.string());
+    int version = 0, count = 0;
+    if (stream && !stream->error())
+    {
+      stream->io(version);
+      stream->io(count);
+    }
+    ok = stream && !stream->error() && version == ENTRY_VERSION;
+    for (int i = 0; ok && i < count; ++i)
+    {
+      std::string name;
+      int id = 0;
+      DatatypeHandle data;
+      stream->io(name);
+      stream->io(id);
+      pioDatatype(*stream, data);
+      ok = !stream->error();
+      loaded.emplace_back(PortId(id, name), data);
+    }
+  }
+  catch (const std::exception& e)
+  {
+    LOG_DEBUG("Module output cache entry {} could not be read: {}", key, e.what());
+    ok = false;
+  }
+
+  Guard g(lock_.get());
+  auto entry = entries_.find(key);
+  if (!ok)
+  {
+    // Corrupt or written by an incompatible version; drop it.
+    ++stats_.misses;
+    if (entry != entries_.end())
+    {
+      stats_.bytes -= entry->second.size;
+      entries_.erase(entry);
+      stats_.entries = entries_.size();
+    }
+    boost::system::error_code ec;
+    fs::remove(path, ec);
+    return false;
+  }
+
+  ++stats_.hits;
+  if (entry != entries_.end())
+  {
+    // Recency survives the session through the modification time.
+    entry->second.lastUse = std::time(nullptr);
+    entry->second.sequence = ++useCount_;
+    boost::system::error_code ec;
+    fs::last_write_time(path, entry->second.lastUse, ec);
+  }
+  outputs.swap(loaded);
+  LOG_DEBUG("Module output cache hit {}", key);
+  return true;
+}
+
+bool ModuleOutputCache::store(const std::string& key, const PortData& outputs)
+{
+  fs::path path;
+  {
+    Guard g(lock_.get());
+    if (!enabled_)
+      return false;
+    path = entryPath(key);
+  }
+
+  for (const auto& output : outputs)
+    if (!isSerializable(output.second))
+      return false;
+
+  // Written next to the entry and renamed, so readers never see a partial file.
+  auto tempPath = path;
+  tempPath += ".tmp";
+  {
+    auto stream = auto_ostream(tempPath.string(), "Compressed");
+    if (!stream || stream->error())
+      return false;
+    int version = ENTRY_VERSION;
+    int count = static_cast<int>(outputs.size());
+    stream->io(version);
+    stream->io(count);
+    for (const auto& output : outputs)
+    {
+      std::string name = output.first.name;
+      int id = static_cast<int>(output.first.id);
+      auto data = output.second;
+      stream->io(name);
+      stream->io(id);
+      pioDatatype(*stream, data);
+    }
+    if (stream->error())
+    {
+      stream.reset();
+      boost::system::error_code ec;
+      fs::remove(tempPath, ec);
+      return false;
+    }
+  }
+
+  boost::system::error_code ec;
+  fs::rename(tempPath, path, ec);
+  if (ec)
+  {
+    fs::remove(tempPath, ec);
+    return false;
+  }
+  auto size = fs::file_size(path, ec);
+
+  Guard g(lock_.get());
+  auto& entry = entries_[key];
+  stats_.bytes = stats_.bytes - entry.size + size;
+  entry.size = size;
+  entry.lastUse = std::time(nullptr);
+  entry.sequence = ++useCount_;
+  stats_.entries = entries_.size();
+  ++stats_.stores;
+  evict();
+  return true;
+}
+
+void ModuleOutputCache::evict()
+{
+  while (stats_.bytes > maxBytes_ && !entries_.empty())
+  {
+    auto oldest = entries_.begin();
+    for (auto e = entries_.begin(); e != entries_.end(); ++e)
+      if (std::tie(e->second.lastUse, e->second.sequence) < std::tie(oldest->second.lastUse, oldest->second.sequence))
+        oldest = e;
+    boost::system::error_code ec;
+    fs::remove(entryPath(oldest->first), ec);
+    stats_.bytes -= oldest->second.size;
+    entries_.erase(oldest);
+    ++stats_.evictions;
+  }
+  stats_.entries = entries_.size();
+}
+
+ModuleOutputCacheStatistics ModuleOutputCache::statistics() const
+{
+  Guard g(lock_.get());
+  return stats_;
+}
+
+void ModuleOutputCache::clear()
+{
+  Guard g(lock_.get());
+  for (const auto& entry : entries_)
+  {
+    boost::system::error_code ec;
+    fs::remove(entryPath(entry.first), ec);
+  }
+  entries_.clear();
+  contentHashes_.clear();
+  stats_ = ModuleOutputCacheStatistics();
+}
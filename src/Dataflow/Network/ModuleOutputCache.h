@@ -0,0 +1,117 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef DATAFLOW_NETWORK_MODULE_OUTPUT_CACHE_H
+#define DATAFLOW_NETWORK_MODULE_OUTPUT_CACHE_H
+
+#include <map>
+#include <vector>
+#include <ctime>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <Dataflow/Network/ModuleDescription.h>
+#include <Core/Thread/Mutex.h>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  struct SCISHARE ModuleOutputCacheStatistics
+  {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t stores = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    boost::uint64_t bytes = 0;
+  };
+
+  /// Optional on-disk cache of module outputs that outlives the process. Entries
+  /// are keyed by a hash of the module id, its state and the content of its
+  /// inputs, so reopening a network and executing it again can skip expensive
+  /// modules whose inputs did not change. Only modules that opt in with
+  /// OUTPUTS_CACHED_ON_DISK use it, and only when every input and output is a
+  /// registered Persistent type.
+  class SCISHARE ModuleOutputCache : boost::noncopyable
+  {
+  public:
+    using PortData = std::vector<std::pair<PortId, Core::Datatypes::DatatypeHandle>>;
+
+    static ModuleOutputCache& Instance();
+
+    /// Keeps entries in directory, evicting the least recently used ones once
+    /// they take more than maxBytes. Entries left by earlier sessions are reused
+    /// only if they were written by the same buildVersion, which goes into every
+    /// key so that outputs of older algorithm code are never loaded.
+    void enable(const boost::filesystem::path& directory, boost::uint64_t maxBytes, const std::string& buildVersion);
+    void disable();
+    bool enabled() const;
+
+    /// Empty when an input cannot be serialized, so the module has to execute.
+    boost::optional<std::string> key(const std::string& moduleId, const std::string& state, const PortData& inputs) const;
+    bool load(const std::string& key, PortData& outputs);
+    /// Outputs that cannot be serialized are not stored.
+    bool store(const std::string& key, const PortData& outputs);
+
+    ModuleOutputCacheStatistics statistics() const;
+    /// Removes all entries from disk and resets the statistics.
+    void clear();
+
+  private:
+    ModuleOutputCache();
+    boost::filesystem::path entryPath(const std::string& key) const;
+    void evict();
+    std::string contentHash(const Core::Datatypes::DatatypeHandle& data) const;
+
+    struct Entry
+    {
+      boost::uint64_t size;
+      std::time_t lastUse;
+      // Orders uses within the same second.
+      boost::uint64_t sequence;
+    };
+
+    mutable Core::Thread::Mutex lock_;
+    bool enabled_;
+    boost::filesystem::path directory_;
+    boost::uint64_t maxBytes_;
+    std::string buildVersion_;
+    std::map<std::string, Entry> entries_;
+    boost::uint64_t useCount_;
+    ModuleOutputCacheStatistics stats_;
+    // Datatypes are not modified once sent, so their hashes are kept by id.
+    mutable std::map<int, std::string> contentHashes_;
+  };
+
+}}}
+
+#endif
@@ -78,6 +78,8 @@ namespace Modules
 
   #define HAS_DYNAMIC_PORTS public: virtual bool hasDynamicPorts() const override { return true; }
 
+  #define OUTPUTS_CACHED_ON_DISK public: virtual bool cachesOutputsOnDisk() const override { return true; }
+
   #define LEGACY_BIOPSE_MODULE public: virtual std::string legacyPackageName() const override { return "BioPSE"; }
   #define LEGACY_MATLAB_MODULE public: virtual std::string legacyPackageName() const override { return "MatlabInterface"; }
   #define CONVERTED_VERSION_OF_MODULE(modName) public: virtual std::string legacyModuleName() const override { return #modName; }
@@ -63,6 +63,8 @@ ModuleHandle Network::add_module(const ModuleLookupInfo& info)
   if (module)
   {
     module->connectErrorListener(boost::bind(&NetworkInterface::incrementErrorCode, this, _1));
+    module->connectExecuteBegins(boost::bind(&ModuleExecutionTimes::executionBegins, &executionTimes_, _1));
+    module->connectExecuteEnds(boost::bind(&ModuleExecutionTimes::executionEnds, &executionTimes_, _2));
   }
   return module;
 }
@@ -225,6 +227,11 @@ NetworkGlobalSettings& Network::settings()
   return settings_;
 }
 
+ModuleExecutionTimes& Network::executionTimes() const
+{
+  return executionTimes_;
+}
+
 void Network::setModuleExecutionState(ModuleExecutionState::Value state, ModuleFilter filter)
 {
   for (auto module : modules_ | boost::adaptors::filtered(filter))
@@ -252,6 +259,7 @@ void Network::clear()
 {
   connections_.clear();
   modules_.clear();
+  executionTimes_.clear();
 }
 
 bool Network::containsViewScene() const
@@ -36,6 +36,7 @@
 #include <Dataflow/Network/NetworkInterface.h>
 #include <Dataflow/Network/ConnectionId.h>
 #include <Dataflow/Network/NetworkSettings.h>
+#include <Dataflow/Network/ModuleExecutionTimes.h>
 #include <Dataflow/Network/share.h>
 
 namespace SCIRun {
@@ -66,6 +67,7 @@ namespace Networks {
     void incrementErrorCode(const ModuleId& moduleId) override;
     bool containsViewScene() const override;
     NetworkGlobalSettings& settings() override;
+    ModuleExecutionTimes& executionTimes() const override;
     std::string toString() const override;
     void setModuleExecutionState(ModuleExecutionState::Value state, ModuleFilter filter) override;
     std::vector<ModuleExecutionState::Value> moduleExecutionStates() const override;
@@ -80,6 +82,7 @@ namespace Networks {
     Modules modules_;
     int errorCode_;
     NetworkGlobalSettings settings_;
+    mutable ModuleExecutionTimes executionTimes_;
     mutable ModuleInterruptedSignal interruptModule_;
   };
 
@@ -75,6 +75,7 @@ struct Subnetworks;
 struct NetworkFile;
 struct ToolkitFile;
 class NetworkGlobalSettings;
+class ModuleExecutionTimes;
 class NetworkEditorSerializationManager;
 class ConnectionMakerService;
 class NetworkEditorControllerInterface;
@@ -91,6 +91,7 @@ namespace Networks {
     virtual ConnectionDescriptionList connections() const = 0;
     virtual void incrementErrorCode(const ModuleId& moduleId) = 0;
     virtual NetworkGlobalSettings& settings() = 0;
+    virtual ModuleExecutionTimes& executionTimes() const = 0;
     virtual void setModuleExecutionState(ModuleExecutionState::Value state, ModuleFilter filter) = 0;
     virtual std::vector<ModuleExecutionState::Value> moduleExecutionStates() const = 0;
     virtual void setExpandedModuleExecutionState(ModuleExecutionState::Value state, ModuleFilter filter) = 0;
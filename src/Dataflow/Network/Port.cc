@@ -35,6 +35,7 @@
 #include <Dataflow/Network/ModuleDescription.h>
 #include <Dataflow/Network/DataflowInterfaces.h>
 #include <Core/Logging/Log.h>
+#include <Core/Logging/Trace.h>
 
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Datatypes;
@@ -132,6 +133,7 @@ DatatypeHandleOption InputPort::getData() const
   if (0 == nconnections())
     return DatatypeHandleOption();
 
+  SCIRUN_TRACE_SCOPE("port", "receive", portName_);
   sink_->waitForData();
   return sink_->receive();
 }
@@ -214,6 +216,7 @@ OutputPort::~OutputPort()
 
 void OutputPort::sendData(DatatypeHandle data)
 {
+  SCIRUN_TRACE_SCOPE("port", "send", portName_);
   source_->cacheData(data);
 
   if (0 == nconnections())
@@ -33,6 +33,7 @@
 #include <Dataflow/Network/ConnectionId.h>
 #include <Dataflow/Network/ModuleDescription.h>
 #include <Dataflow/Network/NetworkSettings.h>
+#include <Dataflow/Network/ModuleExecutionTimes.h>
 #include <gmock/gmock.h>
 
 namespace SCIRun {
@@ -58,6 +59,7 @@ namespace SCIRun {
           MOCK_CONST_METHOD0(errorCode, int());
           MOCK_METHOD1(incrementErrorCode, void(const ModuleId&));
           MOCK_METHOD0(settings, NetworkGlobalSettings&());
+          MOCK_CONST_METHOD0(executionTimes, ModuleExecutionTimes&());
           MOCK_METHOD2(setModuleExecutionState, void(ModuleExecutionState::Value, ModuleFilter));
           MOCK_METHOD2(setExpandedModuleExecutionState, void(ModuleExecutionState::Value, ModuleFilter));
           MOCK_CONST_METHOD0(moduleExecutionStates, std::vector<ModuleExecutionState::Value>());
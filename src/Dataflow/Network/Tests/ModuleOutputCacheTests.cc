@@ -0,0 +1,347 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Dataflow/Network/ModuleOutputCache.h>
+#include <Dataflow/Network/Module.h>
+#include <Dataflow/Network/ModuleBuilder.h>
+#include <Dataflow/Network/ModuleReexecutionStrategies.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Dataflow/State/SimpleMapModuleState.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/MatrixIO.h>
+#include <boost/filesystem.hpp>
+#include <boost/functional/factory.hpp>
+#include <gtest/gtest.h>
+
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::State;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Datatypes;
+namespace fs = boost::filesystem;
+
+namespace
+{
+  const std::string TEST_BUILD = "test-build";
+
+  DenseMatrixHandle matrix(int rows, int cols, double value)
+  {
+    DenseMatrixHandle m(new DenseMatrix(rows, cols));
+    m->setConstant(value);
+    return m;
+  }
+
+  class StubbedSink : public DatatypeSinkInterface
+  {
+  public:
+    void waitForData() override {}
+    DatatypeHandleOption receive() override { return data_; }
+    DatatypeSinkInterface* clone() const override { return new StubbedSink; }
+    bool hasChanged() const override { auto val = changed_; changed_ = false; return val; }
+    void invalidateProvider() override {}
+    void forceFireDataHasChanged() override {}
+    boost::signals2::connection connectDataHasChanged(const DataHasChangedSignalType::slot_type&) override { return {}; }
+    void setData(DatatypeHandle data) { data_ = data; changed_ = true; }
+  private:
+    DatatypeHandleOption data_;
+    mutable bool changed_ = false;
+  };
+
+  class CapturingSource : public SimpleSource
+  {
+  public:
+    DatatypeHandle data() const { return data_; }
+  };
+
+  const AlgorithmParameterName Scale("Scale");
+
+  // Scales its input matrix by the Scale state value and counts its executions.
+  class ScaleMatrixModule : public Module
+  {
+  public:
+    ScaleMatrixModule() : Module(ModuleLookupInfo("ScaleMatrix", "Testing", "SCIRun"), false, nullptr,
+      boost::make_shared<SimpleMapModuleStateFactory>()) {}
+
+    void setStateDefaults() override
+    {
+      get_state()->setValue(Scale, 1.0);
+    }
+
+    void execute() override
+    {
+      ++executions;
+      auto input = boost::dynamic_pointer_cast<DenseMatrix>(*inputPorts()[0]->getData());
+      DenseMatrixHandle output(new DenseMatrix(get_state()->getValue(Scale).toDouble() * *input));
+      send_output_handle(PortId(0, "Output"), output);
+    }
+
+    int executions = 0;
+
+    OUTPUTS_CACHED_ON_DISK
+  };
+
+  // Like ScaleMatrixModule, but only recomputes when needToExecute() says so,
+  // as BuildFEMatrix and BuildBEMatrix do.
+  class GuardedScaleMatrixModule : public ScaleMatrixModule
+  {
+  public:
+    void execute() override
+    {
+      auto input = boost::dynamic_pointer_cast<DenseMatrix>(*inputPorts()[0]->getData());
+      if (needToExecute())
+      {
+        ++executions;
+        DenseMatrixHandle output(new DenseMatrix(get_state()->getValue(Scale).toDouble() * *input));
+        send_output_handle(PortId(0, "Output"), output);
+      }
+    }
+  };
+
+  template <class ModuleType>
+  ModuleHandle makeScaleMatrixModule(DatatypeHandle input)
+  {
+    ModuleBuilder::use_sink_type(boost::factory<StubbedSink*>());
+    ModuleBuilder::use_source_type(boost::factory<CapturingSource*>());
+    auto module = ModuleBuilder().using_func([]() { return new ModuleType; })
+      .add_input_port(Port::ConstructionParams(PortId(0, "Input"), "Matrix", false))
+      .add_output_port(Port::ConstructionParams(PortId(0, "Output"), "Matrix", false))
+      .setStateDefaults()
+      .build();
+    ModuleBuilder::use_sink_type(ModuleBuilder::SinkMaker());
+    ModuleBuilder::use_source_type(ModuleBuilder::SourceMaker());
+
+    auto iport = module->inputPorts()[0];
+    iport->attach(nullptr);
+    dynamic_cast<StubbedSink*>(iport->sink().get())->setData(input);
+    return module;
+  }
+
+  ModuleHandle makeScaleMatrixModule(DatatypeHandle input)
+  {
+    return makeScaleMatrixModule<ScaleMatrixModule>(input);
+  }
+
+  ModuleHandle makeGuardedScaleMatrixModule(DatatypeHandle input)
+  {
+    auto module = makeScaleMatrixModule<GuardedScaleMatrixModule>(input);
+    auto& m = dynamic_cast<Module&>(*module);
+    m.setReexecutionStrategy(boost::make_shared<DynamicReexecutionStrategy>(
+      boost::make_shared<InputsChangedCheckerImpl>(m),
+      boost::make_shared<StateChangedCheckerImpl>(m),
+      boost::make_shared<OutputPortsCachedCheckerImpl>(m)));
+    return module;
+  }
+
+  DenseMatrixHandle sentOutput(ModuleHandle module)
+  {
+    auto source = boost::dynamic_pointer_cast<CapturingSource>(module->outputPorts()[0]->source());
+    return boost::dynamic_pointer_cast<DenseMatrix>(source->data());
+  }
+
+  class ModuleOutputCacheTests : public ::testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      dir_ = fs::temp_directory_path() / fs::unique_path("scirun_output_cache_%%%%%%%%");
+      ModuleOutputCache::Instance().enable(dir_, 1 << 30, TEST_BUILD);
+      ModuleOutputCache::Instance().clear();
+    }
+    void TearDown() override
+    {
+      ModuleOutputCache::Instance().disable();
+      fs::remove_all(dir_);
+    }
+    fs::path dir_;
+  };
+}
+
+TEST_F(ModuleOutputCacheTests, KeyDependsOnInputContentAndState)
+{
+  auto& cache = ModuleOutputCache::Instance();
+  ModuleOutputCache::PortData inputs { { PortId(0, "Matrix"), matrix(3, 3, 1) } };
+  ModuleOutputCache::PortData sameContent { { PortId(0, "Matrix"), matrix(3, 3, 1) } };
+  ModuleOutputCache::PortData otherContent { { PortId(0, "Matrix"), matrix(3, 3, 2) } };
+
+  auto key = cache.key("BuildFEMatrix:0", "{}", inputs);
+  ASSERT_TRUE(!!key);
+  EXPECT_EQ(*key, *cache.key("BuildFEMatrix:0", "{}", sameContent));
+  EXPECT_NE(*key, *cache.key("BuildFEMatrix:0", "{}", otherContent));
+  EXPECT_NE(*key, *cache.key("BuildFEMatrix:0", "{[Option, 1]}", inputs));
+  EXPECT_NE(*key, *cache.key("BuildFEMatrix:1", "{}", inputs));
+}
+
+TEST_F(ModuleOutputCacheTests, KeyDependsOnBuildVersion)
+{
+  auto& cache = ModuleOutputCache::Instance();
+  ModuleOutputCache::PortData inputs { { PortId(0, "Matrix"), matrix(3, 3, 1) } };
+  auto key = *cache.key("BuildFEMatrix:0", "{}", inputs);
+
+  cache.enable(dir_, 1 << 30, "other-build");
+  EXPECT_NE(key, *cache.key("BuildFEMatrix:0", "{}", inputs));
+  cache.enable(dir_, 1 << 30, TEST_BUILD);
+  EXPECT_EQ(key, *cache.key("BuildFEMatrix:0", "{}", inputs));
+}
+
+TEST_F(ModuleOutputCacheTests, StoredOutputsCanBeLoadedAgain)
+{
+  auto& cache = ModuleOutputCache::Instance();
+  auto key = *cache.key("BuildBEMatrix:0", "{}", { { PortId(0, "Surface"), matrix(2, 2, 5) } });
+
+  ModuleOutputCache::PortData outputs;
+  EXPECT_FALSE(cache.load(key, outputs));
+
+  ASSERT_TRUE(cache.store(key, { { PortId(0, "BEM_Forward_Matrix"), matrix(4, 3, 7) } }));
+  ASSERT_TRUE(cache.load(key, outputs));
+  ASSERT_EQ(1, outputs.size());
+  EXPECT_EQ("BEM_Forward_Matrix", outputs[0].first.name);
+  auto loaded = boost::dynamic_pointer_cast<DenseMatrix>(outputs[0].second);
+  ASSERT_TRUE(!!loaded);
+  EXPECT_EQ(4, loaded->rows());
+  EXPECT_EQ(3, loaded->cols());
+  EXPECT_EQ(7, (*loaded)(3, 2));
+
+  auto stats = cache.statistics();
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(1, stats.misses);
+  EXPECT_EQ(1, stats.stores);
+  EXPECT_EQ(1, stats.entries);
+}
+
+TEST_F(ModuleOutputCacheTests, EntriesSurviveReenabling)
+{
+  auto& cache = ModuleOutputCache::Instance();
+  ASSERT_TRUE(cache.store("abc", { { PortId(0, "Output"), matrix(5, 5, 3) } }));
+
+  cache.enable(dir_, 1 << 30, TEST_BUILD);
+  ModuleOutputCache::PortData outputs;
+  EXPECT_EQ(1, cache.statistics().entries);
+  EXPECT_TRUE(cache.load("abc", outputs));
+}
+
+TEST_F(ModuleOutputCacheTests, LeastRecentlyUsedEntriesAreEvicted)
+{
+  auto& cache = ModuleOutputCache::Instance();
+  ASSERT_TRUE(cache.store("first", { { PortId(0, "Output"), matrix(10, 10, 1) } }));
+  auto entrySize = cache.statistics().bytes;
+
+  cache.enable(dir_, 2 * entrySize + entrySize / 2, TEST_BUILD);
+  ASSERT_TRUE(cache.store("second", { { PortId(0, "Output"), matrix(10, 10, 2) } }));
+  ASSERT_TRUE(cache.store("third", { { PortId(0, "Output"), matrix(10, 10, 3) } }));
+
+  auto stats = cache.statistics();
+  EXPECT_EQ(1, stats.evictions);
+  EXPECT_EQ(2, stats.entries);
+  EXPECT_LE(stats.bytes, 2 * entrySize + entrySize / 2);
+}
+
+TEST_F(ModuleOutputCacheTests, LoadedEntriesAreKeptOverOlderOnes)
+{
+  auto& cache = ModuleOutputCache::Instance();
+  ASSERT_TRUE(cache.store("first", { { PortId(0, "Output"), matrix(10, 10, 1) } }));
+  auto entrySize = cache.statistics().bytes;
+
+  cache.enable(dir_, 2 * entrySize + entrySize / 2, TEST_BUILD);
+  ASSERT_TRUE(cache.store("second", { { PortId(0, "Output"), matrix(10, 10, 2) } }));
+  ModuleOutputCache::PortData outputs;
+  ASSERT_TRUE(cache.load("first", outputs));
+  ASSERT_TRUE(cache.store("third", { { PortId(0, "Output"), matrix(10, 10, 3) } }));
+
+  EXPECT_EQ(1, cache.statistics().evictions);
+  EXPECT_TRUE(cache.load("first", outputs));
+  EXPECT_FALSE(cache.load("second", outputs));
+  EXPECT_TRUE(cache.load("third", outputs));
+  EXPECT_FALSE(fs::exists(dir_ / "second.cache"));
+}
+
+TEST_F(ModuleOutputCacheTests, ModuleLoadsOutputsInsteadOfExecuting)
+{
+  Module::resetIdGenerator();
+  auto input = matrix(3, 3, 2);
+  auto module = makeScaleMatrixModule(input);
+  auto& scale = dynamic_cast<ScaleMatrixModule&>(*module);
+
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(1, scale.executions);
+  EXPECT_EQ(2, (*sentOutput(module))(0, 0));
+
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(1, scale.executions);
+  EXPECT_EQ(2, (*sentOutput(module))(0, 0));
+
+  // a state change beyond the sixth significant digit is a different key
+  module->get_state()->setValue(Scale, 1.0000001);
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(2, scale.executions);
+  EXPECT_DOUBLE_EQ(2.0000002, (*sentOutput(module))(0, 0));
+
+  // the same module in a later session reuses the stored outputs
+  Module::resetIdGenerator();
+  auto reopened = makeScaleMatrixModule(matrix(3, 3, 2));
+  reopened->get_state()->setValue(Scale, 1.0000001);
+  EXPECT_TRUE(reopened->executeWithSignals());
+  EXPECT_EQ(0, dynamic_cast<ScaleMatrixModule&>(*reopened).executions);
+  EXPECT_DOUBLE_EQ(2.0000002, (*sentOutput(reopened))(0, 0));
+
+  auto stats = ModuleOutputCache::Instance().statistics();
+  EXPECT_EQ(2, stats.hits);
+  EXPECT_EQ(2, stats.stores);
+}
+
+TEST_F(ModuleOutputCacheTests, UnchangedGuardedModuleKeepsItsOutputs)
+{
+  Module::resetIdGenerator();
+  auto module = makeGuardedScaleMatrixModule(matrix(3, 3, 2));
+  auto& scale = dynamic_cast<ScaleMatrixModule&>(*module);
+
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(1, scale.executions);
+  auto first = sentOutput(module);
+  ASSERT_TRUE(!!first);
+
+  // nothing changed: the outputs already sent stay, nothing is read from disk
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(1, scale.executions);
+  EXPECT_EQ(first, sentOutput(module));
+  auto stats = ModuleOutputCache::Instance().statistics();
+  EXPECT_EQ(0, stats.hits);
+  EXPECT_EQ(1, stats.stores);
+
+  // with its entry gone, an unchanged run still stores nothing
+  ModuleOutputCache::Instance().clear();
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(1, scale.executions);
+  EXPECT_EQ(first, sentOutput(module));
+  EXPECT_EQ(0, ModuleOutputCache::Instance().statistics().entries);
+
+  // a new input is computed and stored
+  dynamic_cast<StubbedSink*>(module->inputPorts()[0]->sink().get())->setData(matrix(3, 3, 5));
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(2, scale.executions);
+  EXPECT_EQ(5, (*sentOutput(module))(0, 0));
+  EXPECT_EQ(1, ModuleOutputCache::Instance().statistics().entries);
+}
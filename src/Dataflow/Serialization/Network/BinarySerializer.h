@@ -0,0 +1,127 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// @todo Documentation Dataflow/Serialization/Network/BinarySerializer.h
+
+
+#ifndef CORE_SERIALIZATION_NETWORK_BINARY_SERIALIZER_H
+#define CORE_SERIALIZATION_NETWORK_BINARY_SERIALIZER_H
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <Dataflow/Serialization/Network/XMLSerializer.h>
+#include <cstring>
+
+#include <Dataflow/Serialization/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  /// Compact counterpart to XMLSerializer, built on the same serialize() functions.
+  /// Binary archives are tied to the word size and endianness of the writing
+  /// platform; XML remains the interchange format, and convert_network translates
+  /// between the two.
+  namespace BinarySerializer
+  {
+    const char magic[] = "SCIRUNB1";
+    const std::size_t magicLength = sizeof(magic) - 1;
+
+    inline bool has_binary_header(std::istream& istr)
+    {
+      if (!istr.good())
+        return false;
+      const auto start = istr.tellg();
+      char header[magicLength];
+      istr.read(header, magicLength);
+      const bool match = istr.gcount() == static_cast<std::streamsize>(magicLength)
+        && std::memcmp(header, magic, magicLength) == 0;
+      istr.clear();
+      istr.seekg(start);
+      return match;
+    }
+
+    template <class Serializable>
+    bool save_binary(const Serializable& data, std::ostream& ostr)
+    {
+      if (!ostr.good())
+        return false;
+      ostr.write(magic, magicLength);
+      boost::archive::binary_oarchive oa(ostr);
+      oa << data;
+      return true;
+    }
+
+    template <class Serializable>
+    bool save_binary(const Serializable& data, const std::string& filename)
+    {
+      std::ofstream ofs(filename.c_str(), std::ios::binary);
+      if (!ofs)
+        return false;
+      return save_binary(data, ofs);
+    }
+
+    template <class Serializable>
+    boost::shared_ptr<Serializable> load_binary(std::istream& istr)
+    {
+      if (!has_binary_header(istr))
+        return nullptr;
+      istr.ignore(magicLength);
+      boost::archive::binary_iarchive ia(istr);
+      boost::shared_ptr<Serializable> nh(new Serializable);
+      ia >> *nh;
+      return nh;
+    }
+
+    template <class Serializable>
+    boost::shared_ptr<Serializable> load_binary(const std::string& filename)
+    {
+      std::ifstream ifs(filename.c_str(), std::ios::binary);
+      return load_binary<Serializable>(ifs);
+    }
+
+    /// Picks the archive type from the file contents rather than the extension.
+    template <class Serializable>
+    boost::shared_ptr<Serializable> load_binary_or_xml(const std::string& filename)
+    {
+      std::ifstream ifs(filename.c_str(), std::ios::binary);
+      if (has_binary_header(ifs))
+        return load_binary<Serializable>(ifs);
+      return XMLSerializer::load_xml<Serializable>(ifs);
+    }
+
+    inline bool is_binary_filename(const std::string& filename)
+    {
+      const std::string ext = ".srn5b";
+      return filename.size() >= ext.size()
+        && filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0;
+    }
+  }
+}}}
+
+#endif
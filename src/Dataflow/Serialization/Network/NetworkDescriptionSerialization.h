@@ -116,6 +116,13 @@ namespace Networks {
     SubnetworkMap subnets;
   };
 
+  using ModuleExecutionTimesMapXML = std::map<std::string, double>;
+
+  struct SCISHARE ModuleExecutionTimesXML
+  {
+    ModuleExecutionTimesMapXML times;
+  };
+
   class SCISHARE NetworkXML
   {
   public:
@@ -140,6 +147,7 @@ namespace Networks {
     ModuleTags moduleTags;
     DisabledComponents disabledComponents;
     Subnetworks subnetworks;
+    ModuleExecutionTimesXML moduleExecutionTimes;
   private:
     friend class boost::serialization::access;
     template <class Archive>
@@ -167,6 +175,10 @@ namespace Networks {
       {
         ar & boost::serialization::make_nvp("subnetworks", subnetworks.subnets);
       }
+      if (version > 6)
+      {
+        ar & boost::serialization::make_nvp("moduleExecutionTimes", moduleExecutionTimes.times);
+      }
     }
   };
 
@@ -203,6 +215,6 @@ namespace Networks {
 
 }}}
 
-BOOST_CLASS_VERSION(SCIRun::Dataflow::Networks::NetworkFile, 6)
+BOOST_CLASS_VERSION(SCIRun::Dataflow::Networks::NetworkFile, 7)
 
 #endif
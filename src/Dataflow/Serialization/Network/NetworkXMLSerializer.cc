@@ -32,6 +32,7 @@
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
 #include <Dataflow/Network/Network.h> /// @todo: need network factory??
 #include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/ModuleExecutionTimes.h>
 // ReSharper disable once CppUnusedIncludeDirective
 #include <Dataflow/Network/PortInterface.h>
 #include <Dataflow/Serialization/Network/XMLSerializer.h>
@@ -186,6 +187,8 @@ NetworkFileHandle NetworkToXML::to_xml_data(const NetworkHandle& network, Module
     if (connFilter(desc))
       networkXML.connections.push_back(ConnectionDescriptionXML(desc));
   }
+  ModuleExecutionTimesXML executionTimes;
+  auto estimates = network->executionTimes().estimates();
   for (size_t i = 0; i < network->nmodules(); ++i)
   {
     auto module = network->module(i);
@@ -194,11 +197,15 @@ NetworkFileHandle NetworkToXML::to_xml_data(const NetworkHandle& network, Module
       auto state = module->get_state();
       auto stateXML = make_state_xml(state);
       networkXML.modules[module->id()] = ModuleWithState(module->info(), stateXML ? *stateXML : SimpleMapModuleStateXML());
+      auto estimate = estimates.find(module->id().id_);
+      if (estimate != estimates.end())
+        executionTimes.times.insert(*estimate);
     }
   }
 
   auto file(boost::make_shared<NetworkFile>());
   file->network = networkXML;
+  file->moduleExecutionTimes = executionTimes;
   if (nesm_)
   {
     file->modulePositions = *nesm_->dumpModulePositions(modFilter);
@@ -42,6 +42,7 @@
 #include <Dataflow/State/SimpleMapModuleState.h>
 #include <Dataflow/Engine/Controller/NetworkEditorController.h>
 #include <Dataflow/Serialization/Network/XMLSerializer.h>
+#include <Dataflow/Serialization/Network/BinarySerializer.h>
 #include <Dataflow/Engine/Scheduler/DesktopExecutionStrategyFactory.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/Tests/MatrixTestCases.h>
@@ -63,6 +64,8 @@ using namespace SCIRun::Dataflow::State;
 using namespace SCIRun::Core::Algorithms;
 
 #include <boost/assign.hpp>
+#include <boost/filesystem.hpp>
+#include <chrono>
 
 using namespace SCIRun::Dataflow::Networks;
 using namespace boost::assign;
@@ -350,6 +353,125 @@ TEST(SerializeNetworkTest, FullTestWithDynamicPorts)
   EXPECT_NE(net.get(), deserialized.get());
 }
 
+namespace
+{
+  NetworkFile generatedNetworkFile(int numModules)
+  {
+    NetworkFile file;
+    for (int i = 0; i < numModules; ++i)
+    {
+      ModuleLookupInfoXML info;
+      info.module_name_ = "EvaluateLinearAlgebraUnary";
+      info.category_name_ = "Math";
+      info.package_name_ = "SCIRun";
+      SimpleMapModuleStateXML state;
+      state.setValue(Variables::Operator, i % 3);
+      state.setValue(Variables::ScalarValue, i * 0.5);
+      state.setValue(Parameters::TextEntry, TestUtils::matrix1str());
+      const auto id = ModuleId("EvaluateLinearAlgebraUnary", i).id_;
+      file.network.modules[id] = ModuleWithState(info, state);
+      file.modulePositions.modulePositions[id] = { 10.0 * i, -3.0 * i };
+      if (i % 10 == 0)
+        file.moduleNotes.notes[id] = NoteXML("<p>note " + std::to_string(i) + "</p>", 1, "note", 14);
+      if (i > 0)
+      {
+        ConnectionDescriptionXML conn;
+        conn.out_.moduleId_ = ModuleId("EvaluateLinearAlgebraUnary", i - 1);
+        conn.in_.moduleId_ = ModuleId("EvaluateLinearAlgebraUnary", i);
+        conn.out_.portId_ = PortId(0, "Result");
+        conn.in_.portId_ = PortId(0, "InputMatrix");
+        file.network.connections.push_back(conn);
+      }
+    }
+    file.moduleTags.tags["EvaluateLinearAlgebraUnary:0"] = 2;
+    file.disabledComponents.disabledModules.push_back("EvaluateLinearAlgebraUnary:1");
+    return file;
+  }
+
+  std::string toXmlString(const NetworkFile& file)
+  {
+    std::ostringstream ostr;
+    XMLSerializer::save_xml(file, ostr, "networkFile");
+    return ostr.str();
+  }
+
+  template <class Func>
+  double elapsedMilliseconds(Func f)
+  {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+TEST(SerializeNetworkTest, BinaryRoundTripMatchesXml)
+{
+  auto file = generatedNetworkFile(20);
+  const auto xml = toXmlString(file);
+
+  std::stringstream binary;
+  ASSERT_TRUE(BinarySerializer::save_binary(file, binary));
+  EXPECT_TRUE(BinarySerializer::has_binary_header(binary));
+  auto readIn = BinarySerializer::load_binary<NetworkFile>(binary);
+  ASSERT_TRUE(readIn != nullptr);
+
+  EXPECT_EQ(xml, toXmlString(*readIn));
+}
+
+TEST(SerializeNetworkTest, BinaryLoaderRejectsXml)
+{
+  std::stringstream xml(toXmlString(generatedNetworkFile(2)));
+  EXPECT_FALSE(BinarySerializer::has_binary_header(xml));
+  EXPECT_EQ(nullptr, BinarySerializer::load_binary<NetworkFile>(xml));
+}
+
+TEST(SerializeNetworkTest, LoadDetectsFormatFromContents)
+{
+  auto file = generatedNetworkFile(5);
+  const auto xml = toXmlString(file);
+  auto dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  boost::filesystem::create_directories(dir);
+  auto xmlPath = (dir / "net.srn5").string();
+  auto binaryPath = (dir / "net.srn5b").string();
+
+  ASSERT_TRUE(XMLSerializer::save_xml(file, xmlPath, "networkFile"));
+  ASSERT_TRUE(BinarySerializer::save_binary(file, binaryPath));
+
+  auto fromXml = BinarySerializer::load_binary_or_xml<NetworkFile>(xmlPath);
+  auto fromBinary = BinarySerializer::load_binary_or_xml<NetworkFile>(binaryPath);
+  ASSERT_TRUE(fromXml != nullptr);
+  ASSERT_TRUE(fromBinary != nullptr);
+  EXPECT_EQ(xml, toXmlString(*fromXml));
+  EXPECT_EQ(xml, toXmlString(*fromBinary));
+
+  boost::filesystem::remove_all(dir);
+}
+
+TEST(SerializeNetworkTest, LoadTimeLargeNetworkXmlVersusBinary)
+{
+  const int numModules = 2000;
+  auto file = generatedNetworkFile(numModules);
+
+  std::stringstream xml, binary;
+  auto xmlSave = elapsedMilliseconds([&]() { XMLSerializer::save_xml(file, xml, "networkFile"); });
+  auto binarySave = elapsedMilliseconds([&]() { BinarySerializer::save_binary(file, binary); });
+
+  NetworkFileHandle fromXml, fromBinary;
+  auto xmlLoad = elapsedMilliseconds([&]() { fromXml = XMLSerializer::load_xml<NetworkFile>(xml); });
+  auto binaryLoad = elapsedMilliseconds([&]() { fromBinary = BinarySerializer::load_binary<NetworkFile>(binary); });
+
+  ASSERT_TRUE(fromXml != nullptr);
+  ASSERT_TRUE(fromBinary != nullptr);
+  EXPECT_EQ(numModules, fromBinary->network.modules.size());
+  EXPECT_EQ(numModules - 1, fromBinary->network.connections.size());
+  EXPECT_EQ(toXmlString(*fromXml), toXmlString(*fromBinary));
+  EXPECT_LT(binary.str().size(), xml.str().size());
+
+  std::cout << numModules << " modules:"
+    << "\n  xml    " << xml.str().size() << " bytes, save " << xmlSave << " ms, load " << xmlLoad << " ms"
+    << "\n  binary " << binary.str().size() << " bytes, save " << binarySave << " ms, load " << binaryLoad << " ms" << std::endl;
+}
+
 TEST(ToolkitSerializationTest, Experimenting)
 {
   ToolkitFile toolkit;
@@ -0,0 +1,78 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   License for the specific language governing rights and limitations under
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+#include <iostream>
+#include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
+#include <Dataflow/Serialization/Network/BinarySerializer.h>
+
+using namespace SCIRun::Dataflow::Networks;
+
+int printHelp()
+{
+  std::cout << "Usage: convert_network INPUT_FILE OUTPUT_FILE\n"
+    "Input format (.srn5 XML or binary) is detected from the file contents; "
+    "output is binary if OUTPUT_FILE ends in .srn5b, XML otherwise." << std::endl;
+  return 0;
+}
+
+int main(int argc, const char* argv[])
+{
+  if (argc < 3)
+  {
+    return printHelp();
+  }
+
+  std::string input(argv[1]), output(argv[2]);
+
+  NetworkFileHandle file;
+  try
+  {
+    file = BinarySerializer::load_binary_or_xml<NetworkFile>(input);
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Could not read " << input << ": " << e.what() << std::endl;
+    return 1;
+  }
+  if (!file)
+  {
+    std::cerr << "Could not read " << input << std::endl;
+    return 1;
+  }
+
+  const bool saved = BinarySerializer::is_binary_filename(output)
+    ? BinarySerializer::save_binary(*file, output)
+    : XMLSerializer::save_xml(*file, output, "networkFile");
+  if (!saved)
+  {
+    std::cerr << "Could not write " << output << std::endl;
+    return 1;
+  }
+
+  std::cout << "Converted " << file->network.modules.size() << " modules: " << input << " -> " << output << std::endl;
+  return 0;
+}
@@ -2,6 +2,7 @@
 #include <cstring>
 #include <cassert>
 #include <stdexcept>
+#include <algorithm>
 #include "VarBuffer.hpp"
 
 namespace spire {
@@ -56,6 +57,23 @@ void VarBuffer::writeNullTermString(const char* str)
   mSerializer->writeNullTermString(str);
 }
 
+/// Reserves \p numBytes at the current offset and advances past them.
+char* VarBuffer::reserveBytes(size_t numBytes)
+{
+  RENDERER_LOG("VarBuffer reserveBytes (numBytes {})", numBytes);
+  size_t offset = mSerializer->getOffset();
+  if (offset + numBytes > static_cast<size_t>(mBufferSize))
+  {
+    // Grow once to the required size instead of doubling repeatedly.
+    mBufferSize = static_cast<int>(std::max(offset + numBytes, static_cast<size_t>(mBufferSize) * 2));
+    mBuffer.resize(mBufferSize);
+    mSerializer.reset(new spire::BSerialize(getBuffer(), mBufferSize));
+  }
+
+  mSerializer->setOffset(offset + numBytes);
+  return getBuffer() + offset;
+}
+
 void VarBuffer::resize()
 {
   mBufferSize *= 2;
@@ -31,6 +31,11 @@ public:
   /// Writes a null terminated string.
   void writeNullTermString(const char* str);
 
+  /// Reserves \p numBytes at the current write position and returns a
+  /// pointer to them. The caller fills the region in directly (possibly from
+  /// several threads); the pointer is invalidated by the next write.
+  char* reserveBytes(size_t numBytes);
+
   template <typename T>
   void write(const T& val)
   {
@@ -362,7 +362,8 @@ ModuleWidget::ModuleWidget(NetworkEditor* ed, const QString& name, ModuleHandle
 
   setCurrentIndex(buildDisplay(fullWidgetDisplay_.get(), name));
 
-  makeOptionsDialog();
+  if (!networkBeingLoaded_ || isViewScene_ || theModule_->hasDynamicPorts() || dialogFactory().needsStartupNote(name.toStdString()))
+    makeOptionsDialog();
   createPorts(*theModule_);
   addPorts(currentIndex());
 
@@ -421,7 +422,13 @@ void ModuleWidget::setupLogging(ModuleErrorDisplayer* displayer)
   theModule_->setLogger(logger);
   theModule_->setUpdaterFunc(boost::bind(&ModuleWidget::updateProgressBarSignal, this, _1));
   if (theModule_->hasUI())
-    theModule_->setUiToggleFunc([this](bool b){ dockable_->setVisible(b); });
+    theModule_->setUiToggleFunc([this](bool b)
+    {
+      if (b)
+        makeOptionsDialog();
+      if (dockable_)
+        dockable_->setVisible(b);
+    });
 }
 
 void ModuleWidget::setupDisplayWidgets(ModuleWidgetDisplayBase* display, const QString& name)
@@ -993,6 +1000,18 @@ ModuleWidget::NetworkClearingScope::~NetworkClearingScope()
   networkBeingCleared_ = false;
 }
 
+bool ModuleWidget::networkBeingLoaded_(false);
+
+ModuleWidget::NetworkLoadingScope::NetworkLoadingScope()
+{
+  networkBeingLoaded_ = true;
+}
+
+ModuleWidget::NetworkLoadingScope::~NetworkLoadingScope()
+{
+  networkBeingLoaded_ = false;
+}
+
 ModuleWidget::~ModuleWidget()
 {
   disconnect(this, SIGNAL(dynamicPortChanged(const std::string&, bool)), this, SLOT(updateDialogForDynamicPortChange(const std::string&, bool)));
@@ -1142,6 +1161,13 @@ void ModuleWidget::setColorUnselected()
 
 boost::shared_ptr<ModuleDialogFactory> ModuleWidget::dialogFactory_;
 
+ModuleDialogFactory& ModuleWidget::dialogFactory()
+{
+  if (!dialogFactory_)
+    dialogFactory_.reset(new ModuleDialogFactory(nullptr, addWidgetToExecutionDisableList, removeWidgetFromExecutionDisableList));
+  return *dialogFactory_;
+}
+
 double ModuleWidget::highResolutionExpandFactor_ = 1;
 
 void ModuleWidget::makeOptionsDialog()
@@ -1150,10 +1176,7 @@ void ModuleWidget::makeOptionsDialog()
   {
     if (!dialog_)
     {
-      if (!dialogFactory_)
-        dialogFactory_.reset(new ModuleDialogFactory(nullptr, addWidgetToExecutionDisableList, removeWidgetFromExecutionDisableList));
-
-      dialog_ = dialogFactory_->makeDialog(moduleId_, theModule_->get_state());
+      dialog_ = dialogFactory().makeDialog(moduleId_, theModule_->get_state());
       addWidgetToExecutionDisableList(dialog_->getExecuteAction());
       connect(dialog_, SIGNAL(executeActionTriggered()), this, SLOT(executeButtonPushed()));
       connect(dialog_, SIGNAL(executeActionTriggeredViaStateChange()), this, SLOT(executeTriggeredViaStateChange()));
@@ -1198,6 +1221,12 @@ void ModuleWidget::makeOptionsDialog()
         dialog_->adjustToolbar();
 
       dialog_->pull();
+
+      // catch up on signals sent before a deferred dialog existed
+      if (graphicsProxyWidget() && graphicsProxyWidget()->isSelected())
+        dialog_->moduleSelected(true);
+      if (executedOnce_)
+        dialog_->moduleExecuted();
     }
   }
 }
@@ -1250,6 +1279,7 @@ QList<QPoint> ModuleWidget::positions_;
 
 void ModuleWidget::toggleOptionsDialog()
 {
+  makeOptionsDialog();
   if (dialog_)
   {
     if (dockable_->isHidden())
@@ -1360,6 +1390,7 @@ bool ModuleWidget::hasDynamicPorts() const
 
 void ModuleWidget::pinUI()
 {
+  makeOptionsDialog();
   if (dockable_)
   {
     dockable_->setFloating(false);
@@ -1375,6 +1406,7 @@ void ModuleWidget::hideUI()
 
 void ModuleWidget::showUI()
 {
+  makeOptionsDialog();
   if (dockable_)
   {
     dockable_->show();
@@ -165,6 +165,13 @@ public:
     ~NetworkClearingScope();
   };
 
+  /// While in scope, options dialogs of new modules are built on first use instead of up front.
+  struct NetworkLoadingScope
+  {
+    NetworkLoadingScope();
+    ~NetworkLoadingScope();
+  };
+
   QString metadataToString() const;
   QDialog* dialog();
   void collapsePinnedDialog();
@@ -286,6 +293,7 @@ private:
   boost::scoped_ptr<class ModuleActionsMenu> actionsMenu_;
 
   static boost::shared_ptr<class ModuleDialogFactory> dialogFactory_;
+  static class ModuleDialogFactory& dialogFactory();
 	boost::shared_ptr<DialogErrorControl> dialogErrorControl_;
 
   void movePortWidgets(int oldIndex, int newIndex);
@@ -300,6 +308,7 @@ private:
   QHBoxLayout* outputPortLayout_;
   bool deleting_;
   static bool networkBeingCleared_;
+  static bool networkBeingLoaded_;
   const QString defaultBackgroundColor_;
   bool isViewScene_; //TODO: lots of special logic around this case.
 
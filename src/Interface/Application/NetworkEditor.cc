@@ -720,7 +720,7 @@ void NetworkEditor::dropEvent(QDropEvent* event)
     {
       auto file = urls[0].toLocalFile();
       QFileInfo check_file(file);
-      if (check_file.exists() && check_file.isFile() && file.endsWith("srn5"))
+      if (check_file.exists() && check_file.isFile() && (file.endsWith("srn5") || file.endsWith("srn5b")))
       {
         Q_EMIT requestLoadNetwork(file);
         return;
@@ -1455,9 +1455,12 @@ NetworkFileHandle NetworkEditor::saveNetwork() const
 
 void NetworkEditor::loadNetwork(const NetworkFileHandle& xml)
 {
-  fileLoading_ = true;
-  controller_->loadNetwork(xml);
-  fileLoading_ = false;
+  {
+    ModuleWidget::NetworkLoadingScope loading;
+    fileLoading_ = true;
+    controller_->loadNetwork(xml);
+    fileLoading_ = false;
+  }
 
   Q_FOREACH(QGraphicsItem* item, scene_->items())
   {
@@ -1473,9 +1476,12 @@ void NetworkEditor::loadNetwork(const NetworkFileHandle& xml)
 void NetworkEditor::appendToNetwork(const NetworkFileHandle& xml)
 {
   auto originalItems = scene_->items();
-  fileLoading_ = true;
-  controller_->appendToNetwork(xml);
-  fileLoading_ = false;
+  {
+    ModuleWidget::NetworkLoadingScope loading;
+    fileLoading_ = true;
+    controller_->appendToNetwork(xml);
+    fileLoading_ = false;
+  }
 
   Q_FOREACH(QGraphicsItem* item, scene_->items())
   {
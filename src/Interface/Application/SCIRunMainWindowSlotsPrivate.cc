@@ -93,7 +93,7 @@ void SCIRunMainWindow::saveNetwork()
 
 void SCIRunMainWindow::saveNetworkAs()
 {
-  auto filename = QFileDialog::getSaveFileName(this, "Save Network...", latestNetworkDirectory_.path(), "*.srn5");
+  auto filename = QFileDialog::getSaveFileName(this, "Save Network...", latestNetworkDirectory_.path(), "*.srn5;;*.srn5b");
   if (!filename.isEmpty())
     saveNetworkFile(filename);
 }
@@ -102,7 +102,7 @@ void SCIRunMainWindow::loadNetwork()
 {
   if (okToContinue())
   {
-    auto filename = QFileDialog::getOpenFileName(this, "Load Network...", latestNetworkDirectory_.path(), "*.srn5");
+    auto filename = QFileDialog::getOpenFileName(this, "Load Network...", latestNetworkDirectory_.path(), "*.srn5 *.srn5b");
     loadNetworkFile(filename);
   }
 }
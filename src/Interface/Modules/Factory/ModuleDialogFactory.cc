@@ -202,6 +202,12 @@ void ModuleDialogFactory::addDialogsToMakerMap1()
   ;
 }
 
+bool ModuleDialogFactory::needsStartupNote(const std::string& moduleName) const
+{
+  auto entry = dialogMakerMap_.find(moduleName);
+  return entry != dialogMakerMap_.end() && entry->second.needsStartupNote;
+}
+
 ModuleDialogGeneric* ModuleDialogFactory::makeDialog(const std::string& moduleId, ModuleStateHandle state)
 {
   for (const auto& makerPair : dialogMakerMap_)
@@ -209,7 +215,7 @@ ModuleDialogGeneric* ModuleDialogFactory::makeDialog(const std::string& moduleId
     //TODO: match full string name; need to strip module id's number
     auto findIndex = moduleId.find(makerPair.first);
     if (findIndex != std::string::npos && moduleId[makerPair.first.size()] == ':')
-      return makerPair.second(moduleId, state, parentToUse_);
+      return makerPair.second.make(moduleId, state, parentToUse_);
   }
 
   if (moduleId.find("Subnet") != std::string::npos)
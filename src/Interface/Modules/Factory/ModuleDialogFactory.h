@@ -30,6 +30,7 @@
 #define INTERFACE_MODULES_MODULEDIALOGFACTORY_H
 
 #include <QWidget>
+#include <type_traits>
 #include <Interface/Modules/Base/ModuleDialogGeneric.h>
 #include <Dataflow/Network/NetworkFwd.h>
 #include <Interface/Modules/Factory/share.h>
@@ -46,9 +47,17 @@ namespace SCIRun
       ModuleDialogGeneric* makeDialog(const std::string& moduleId, SCIRun::Dataflow::Networks::ModuleStateHandle state);
 
       typedef boost::function<ModuleDialogGeneric*(const std::string&, SCIRun::Dataflow::Networks::ModuleStateHandle, QWidget*)> DialogMaker;
-      typedef std::map<std::string, DialogMaker> DialogMakerMap;
+      struct DialogEntry
+      {
+        DialogMaker make;
+        bool needsStartupNote;
+      };
+      typedef std::map<std::string, DialogEntry> DialogMakerMap;
 
       const DialogMakerMap& getMap() const { return dialogMakerMap_; }
+      // True when the module's dialog writes a note in createStartupNote(), so it
+      // has to exist as soon as the module is placed.
+      bool needsStartupNote(const std::string& moduleName) const;
     private:
       QWidget* parentToUse_;
       DialogMakerMap dialogMakerMap_;
@@ -57,10 +66,14 @@ namespace SCIRun
       void addDialogsToMakerMap2();
       void addDialogsToMakerMapGenerated();
     };
+
+    template <class Dialog>
+    struct OverridesStartupNote : std::integral_constant<bool,
+      !std::is_same<decltype(&Dialog::createStartupNote), void (ModuleDialogGeneric::*)()>::value> {};
   }
 }
 
 #define MODULE_FACTORY_LAMBDA(type) [](const std::string& name,SCIRun::Dataflow::Networks::ModuleStateHandle state,QWidget* parent) { return new type(name, state, parent); }
-#define ADD_MODULE_DIALOG(module, dialog) (#module, MODULE_FACTORY_LAMBDA(dialog))
+#define ADD_MODULE_DIALOG(module, dialog) (#module, SCIRun::Gui::ModuleDialogFactory::DialogEntry{ MODULE_FACTORY_LAMBDA(dialog), SCIRun::Gui::OverridesStartupNote<dialog>::value })
 
 #endif
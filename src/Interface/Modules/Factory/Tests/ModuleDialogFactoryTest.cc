@@ -104,3 +104,14 @@ TEST(ModuleDialogFactoryTests, ModuleTraitHasUIMatchesDialogFactory)
     }
   }
 }
+
+TEST(ModuleDialogFactoryTests, DialogsWithStartupNotesAreFlagged)
+{
+  ModuleDialogFactory factory(nullptr, {}, {});
+
+  EXPECT_TRUE(factory.needsStartupNote("ShowField"));
+  EXPECT_TRUE(factory.needsStartupNote("ShowFieldGlyphs"));
+  EXPECT_TRUE(factory.needsStartupNote("ShowString"));
+  EXPECT_FALSE(factory.needsStartupNote("CreateMatrix"));
+  EXPECT_FALSE(factory.needsStartupNote("NoSuchModule"));
+}
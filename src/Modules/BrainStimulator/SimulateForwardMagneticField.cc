@@ -53,6 +53,7 @@ SimulateForwardMagneticField::SimulateForwardMagneticField() : Module(staticInfo
 
 void SimulateForwardMagneticField::setStateDefaults()
 {
+  setStateDoubleFromAlgo(Parameters::TreecodeOpeningAngle);
 }
 
 void SimulateForwardMagneticField::execute()
@@ -64,6 +65,7 @@ void SimulateForwardMagneticField::execute()
 
   if (needToExecute())
   {
+    setAlgoDoubleFromState(Parameters::TreecodeOpeningAngle);
      auto output = algo().run(make_input((ElectricField, EField)(ConductivityTensor, CondTensor)(DipoleSources, Dipoles)(DetectorLocations, Detectors)));
     sendOutputFromAlgorithm(MagneticField, output);
     sendOutputFromAlgorithm(MagneticFieldMagnitudes, output);
@@ -56,6 +56,7 @@ void SolveBiotSavart::setStateDefaults()
 {
   auto state = get_state();
   setStateIntFromAlgo(Parameters::OutType);
+  setStateDoubleFromAlgo(Parameters::TreecodeOpeningAngle);
 }
 
 void SolveBiotSavart::execute()
@@ -67,6 +68,7 @@ void SolveBiotSavart::execute()
   if (oport_connected(VectorBField) || oport_connected(VectorAField))
   {
     setAlgoIntFromState(Parameters::OutType);
+    setAlgoDoubleFromState(Parameters::TreecodeOpeningAngle);
 
     if (oport_connected(VectorBField) && oport_connected(VectorAField))
     {
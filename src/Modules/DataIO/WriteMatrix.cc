@@ -108,11 +108,17 @@ bool WriteMatrix::useCustomExporter(const std::string& filename) const
   auto ft = cstate()->getValue(Variables::FileTypeName).toString();
   LOG_DEBUG("WriteMatrix with filetype {}", ft);
 
-  filetype_ = (ft == "SCIRun Matrix ASCII") ? "ASCII" : "Binary";
+  if (ft == "SCIRun Matrix ASCII")
+    filetype_ = "ASCII";
+  else if (ft == "SCIRun Matrix Compressed")
+    filetype_ = "Compressed";
+  else
+    filetype_ = "Binary";
 
   return !(ft == "" ||
     ft == "SCIRun Matrix Binary" ||
     ft == "SCIRun Matrix ASCII" ||
+    ft == "SCIRun Matrix Compressed" ||
     ft == defaultFileTypeName());
 }
 
@@ -47,6 +47,7 @@ namespace Fields {
     DEPRECATED_MODULE_REPLACE_WITH("InterfaceWithCleaver2")
 
     HAS_DYNAMIC_PORTS
+    OUTPUTS_CACHED_ON_DISK
     INPUT_PORT_DYNAMIC(0, InputFields, Field);
     OUTPUT_PORT(0, OutputField, Field);
 
@@ -46,6 +46,7 @@ namespace Fields {
     void setStateDefaults() override;
 
     HAS_DYNAMIC_PORTS
+    OUTPUTS_CACHED_ON_DISK
     INPUT_PORT_DYNAMIC(0, InputFields, Field);
     INPUT_PORT(1, SizingField, Field);
     INPUT_PORT(2, BackgroundField, Field);
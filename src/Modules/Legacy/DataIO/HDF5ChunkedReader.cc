@@ -0,0 +1,426 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+///
+///@file  HDF5ChunkedReader.cc
+///
+///@brief Reads hyperslabs of HDF5 datasets chunk by chunk.
+///
+
+#include "HDF5ChunkedReader.h"
+
+#ifdef HAVE_HDF5
+
+#include <Core/Thread/Parallel.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace SCIRun::Core::Thread;
+
+namespace SCIRun {
+
+namespace {
+
+// Datasets that are not chunked are read in slabs of about this size.
+const hsize_t SLAB_BYTES = 4 << 20;
+
+void unshuffle( const std::vector<char> &in, std::vector<char> &out,
+                size_t elem_size )
+{
+  out.resize( in.size() );
+  const size_t n = in.size() / elem_size;
+  for( size_t b=0; b<elem_size; b++ )
+    for( size_t i=0; i<n; i++ )
+      out[i*elem_size + b] = in[b*n + i];
+
+  // Trailing bytes that do not fill an element are not shuffled.
+  std::copy( in.begin() + n*elem_size, in.end(), out.begin() + n*elem_size );
+}
+
+// Copies n[d] elements per dimension from src, starting at src_offset and
+// stepping by src_stride, to consecutive positions of dst at dst_offset.
+// Both buffers are row major with the given extents.
+void scatter( const char *src, const hsize_t *src_dims,
+              const hsize_t *src_offset, const hsize_t *src_stride,
+              char *dst, const hsize_t *dst_dims, const hsize_t *dst_offset,
+              const hsize_t *n, int ndims, size_t elem_size )
+{
+  std::vector<hsize_t> src_pitch( ndims, 1 ), dst_pitch( ndims, 1 );
+  for( int d=ndims-2; d>=0; d-- ) {
+    src_pitch[d] = src_pitch[d+1] * src_dims[d+1];
+    dst_pitch[d] = dst_pitch[d+1] * dst_dims[d+1];
+  }
+
+  const int last = ndims - 1;
+  std::vector<hsize_t> j( ndims, 0 );
+
+  while( true ) {
+    hsize_t s = src_offset[last];
+    hsize_t t = dst_offset[last];
+    for( int d=0; d<last; d++ ) {
+      s += (src_offset[d] + j[d] * src_stride[d]) * src_pitch[d];
+      t += (dst_offset[d] + j[d]) * dst_pitch[d];
+    }
+
+    if( src_stride[last] == 1 )
+      memcpy( dst + t*elem_size, src + s*elem_size, n[last]*elem_size );
+    else
+      for( hsize_t k=0; k<n[last]; k++ )
+        memcpy( dst + (t+k)*elem_size,
+                src + (s + k*src_stride[last])*elem_size, elem_size );
+
+    int d = last - 1;
+    while( d >= 0 && ++j[d] == n[d] ) {
+      j[d] = 0;
+      d--;
+    }
+    if( d < 0 )
+      break;
+  }
+}
+
+} // end anonymous namespace
+
+
+struct HDF5ChunkedReader::Chunk {
+  // First element of the chunk in the dataset.
+  std::vector<hsize_t> origin;
+  // Selection indices that fall into the chunk.
+  std::vector<hsize_t> first;
+  std::vector<hsize_t> count;
+
+  // Either the raw chunk as stored in the file (encoded) or the
+  // selected elements of the chunk, already in the memory type.
+  std::vector<char> buffer;
+  bool encoded;
+  unsigned int filter_mask;
+};
+
+
+HDF5ChunkedReader::HDF5ChunkedReader( hid_t ds_id, hid_t mem_type_id )
+  : ds_id_(ds_id),
+    mem_type_id_(mem_type_id),
+    valid_(false),
+    direct_(false),
+    elem_size_(H5Tget_size(mem_type_id))
+{
+  hid_t file_space_id = H5Dget_space( ds_id_ );
+  if( file_space_id < 0 ) {
+    error_msg_ = "Error opening file space.";
+    return;
+  }
+
+  int ndims = H5Sget_simple_extent_ndims( file_space_id );
+  if( ndims < 1 ) {
+    H5Sclose( file_space_id );
+    error_msg_ = "Only simple data spaces can be read in chunks.";
+    return;
+  }
+
+  dims_.resize( ndims );
+  H5Sget_simple_extent_dims( file_space_id, &dims_[0], NULL );
+  H5Sclose( file_space_id );
+
+  hid_t dcpl_id = H5Dget_create_plist( ds_id_ );
+  if( dcpl_id < 0 ) {
+    error_msg_ = "Error reading the dataset creation properties.";
+    return;
+  }
+
+  chunk_dims_.resize( ndims );
+
+  if( H5Pget_layout( dcpl_id ) == H5D_CHUNKED ) {
+    H5Pget_chunk( dcpl_id, ndims, &chunk_dims_[0] );
+
+#if H5_VERSION_GE(1,10,2)
+    // Raw chunks can only be used as they are when the stored type is
+    // the memory type and every filter can be undone here.
+    hid_t type_id = H5Dget_type( ds_id_ );
+    direct_ = H5Tequal( type_id, mem_type_id_ ) > 0;
+    H5Tclose( type_id );
+
+    int nfilters = H5Pget_nfilters( dcpl_id );
+    for( int i=0; i<nfilters && direct_; i++ ) {
+      unsigned int flags, filter_config;
+      size_t cd_nelmts = 0;
+      H5Z_filter_t filter = H5Pget_filter2( dcpl_id, i, &flags, &cd_nelmts,
+                                            NULL, 0, NULL, &filter_config );
+
+      if( filter == H5Z_FILTER_DEFLATE || filter == H5Z_FILTER_SHUFFLE )
+        filters_.push_back( filter );
+      else
+        direct_ = false;
+    }
+#endif
+  } else {
+    hsize_t row_bytes = elem_size_;
+    for( int d=1; d<ndims; d++ ) {
+      chunk_dims_[d] = dims_[d];
+      row_bytes *= dims_[d];
+    }
+    chunk_dims_[0] = std::max<hsize_t>( 1, SLAB_BYTES / std::max<hsize_t>( row_bytes, 1 ) );
+  }
+
+  H5Pclose( dcpl_id );
+
+  valid_ = (elem_size_ > 0);
+}
+
+
+bool HDF5ChunkedReader::read( const hsize_t *start, const hsize_t *stride,
+                              const hsize_t *count, void *data )
+{
+  if( !valid_ )
+    return false;
+
+  const int ndims = dims_.size();
+
+  for( int d=0; d<ndims; d++ ) {
+    if( count[d] == 0 )
+      return true;
+
+    if( stride[d] == 0 ||
+        start[d] + (count[d]-1) * stride[d] >= dims_[d] ) {
+      error_msg_ = "Can not select data slab requested.";
+      return false;
+    }
+  }
+
+  // Range of chunks spanned by the selection in each dimension.
+  std::vector<hsize_t> lo( ndims ), hi( ndims );
+  for( int d=0; d<ndims; d++ ) {
+    lo[d] = start[d] / chunk_dims_[d];
+    hi[d] = (start[d] + (count[d]-1) * stride[d]) / chunk_dims_[d];
+  }
+
+  // Keep the chunks that hold at least one selected element, which with
+  // large strides is not all of them.
+  std::vector<Chunk> chunks;
+  std::vector<hsize_t> index( lo );
+
+  while( true ) {
+    Chunk chunk;
+    chunk.origin.resize( ndims );
+    chunk.first.resize( ndims );
+    chunk.count.resize( ndims );
+    chunk.encoded = false;
+    chunk.filter_mask = 0;
+
+    bool selected = true;
+
+    for( int d=0; d<ndims; d++ ) {
+      hsize_t origin = index[d] * chunk_dims_[d];
+      hsize_t end = std::min( origin + chunk_dims_[d], dims_[d] );
+
+      hsize_t first = 0;
+      if( origin > start[d] )
+        first = (origin - start[d] + stride[d] - 1) / stride[d];
+
+      hsize_t last = std::min( count[d],
+                               (end - start[d] + stride[d] - 1) / stride[d] );
+
+      if( first >= last )
+        selected = false;
+
+      chunk.origin[d] = origin;
+      chunk.first[d] = first;
+      chunk.count[d] = last - first;
+    }
+
+    if( selected )
+      chunks.push_back( chunk );
+
+    int d = ndims - 1;
+    while( d >= 0 && ++index[d] > hi[d] ) {
+      index[d] = lo[d];
+      d--;
+    }
+    if( d < 0 )
+      break;
+  }
+
+  char *dst = static_cast<char*>( data );
+  std::vector<hsize_t> ones( ndims, 1 ), zeros( ndims, 0 );
+
+  const size_t batch = 2 * std::max( 1u, Parallel::NumCores() );
+
+  for( size_t b=0; b<chunks.size(); b+=batch ) {
+    const size_t e = std::min( chunks.size(), b + batch );
+
+    // The library is only entered from this thread.
+    for( size_t i=b; i<e; i++ )
+      if( !fetch( chunks[i], start, stride ) )
+        return false;
+
+    std::vector<char> ok( e - b, 1 );
+
+    Parallel::ForRange( b, e, [&]( size_t cb, size_t ce ) {
+      for( size_t i=cb; i<ce; i++ ) {
+        Chunk &chunk = chunks[i];
+
+        if( !decode( chunk ) ) {
+          ok[i-b] = 0;
+          continue;
+        }
+
+        if( chunk.encoded ) {
+          // A whole decoded chunk; pick the selected elements from it.
+          std::vector<hsize_t> offset( ndims );
+          for( int d=0; d<ndims; d++ )
+            offset[d] = start[d] + chunk.first[d] * stride[d] - chunk.origin[d];
+
+          scatter( &chunk.buffer[0], &chunk_dims_[0], &offset[0], stride,
+                   dst, count, &chunk.first[0], &chunk.count[0],
+                   ndims, elem_size_ );
+        } else {
+          scatter( &chunk.buffer[0], &chunk.count[0], &zeros[0], &ones[0],
+                   dst, count, &chunk.first[0], &chunk.count[0],
+                   ndims, elem_size_ );
+        }
+
+        std::vector<char>().swap( chunk.buffer );
+      }
+    }, 1 );
+
+    if( std::find( ok.begin(), ok.end(), 0 ) != ok.end() ) {
+      error_msg_ = "Can not decode a chunk of the data slab requested.";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+bool HDF5ChunkedReader::fetch( Chunk &chunk,
+                               const hsize_t *start, const hsize_t *stride )
+{
+  const int ndims = dims_.size();
+
+#if H5_VERSION_GE(1,10,2)
+  hsize_t nbytes = 0;
+  herr_t status = -1;
+
+  // Chunks that were never written have no storage; the library fills
+  // them in with the fill value below.
+  if( direct_ ) {
+    H5E_BEGIN_TRY {
+      status = H5Dget_chunk_storage_size( ds_id_, &chunk.origin[0], &nbytes );
+    } H5E_END_TRY;
+  }
+
+  if( status >= 0 && nbytes > 0 ) {
+    chunk.buffer.resize( nbytes );
+
+    uint32_t filter_mask = 0;
+    if( H5Dread_chunk( ds_id_, H5P_DEFAULT, &chunk.origin[0],
+                       &filter_mask, &chunk.buffer[0] ) < 0 ) {
+      error_msg_ = "Can not read a chunk of the data slab requested.";
+      return false;
+    }
+
+    chunk.encoded = true;
+    chunk.filter_mask = filter_mask;
+    return true;
+  }
+#endif
+
+  // Let the library read and convert the selected part of the chunk.
+  std::vector<hsize_t> file_start( ndims ), block( ndims, 1 );
+  hsize_t n = 1;
+  for( int d=0; d<ndims; d++ ) {
+    file_start[d] = start[d] + chunk.first[d] * stride[d];
+    n *= chunk.count[d];
+  }
+
+  chunk.buffer.resize( n * elem_size_ );
+  chunk.encoded = false;
+
+  hid_t file_space_id = H5Dget_space( ds_id_ );
+  hid_t mem_space_id = H5Screate_simple( ndims, &chunk.count[0], NULL );
+
+  bool ok = file_space_id >= 0 && mem_space_id >= 0 &&
+    H5Sselect_hyperslab( file_space_id, H5S_SELECT_SET, &file_start[0],
+                         stride, &chunk.count[0], &block[0] ) >= 0 &&
+    H5Dread( ds_id_, mem_type_id_, mem_space_id, file_space_id,
+             H5P_DEFAULT, &chunk.buffer[0] ) >= 0;
+
+  if( mem_space_id >= 0 )
+    H5Sclose( mem_space_id );
+  if( file_space_id >= 0 )
+    H5Sclose( file_space_id );
+
+  if( !ok )
+    error_msg_ = "Can not read the data slab requested.";
+
+  return ok;
+}
+
+
+bool HDF5ChunkedReader::decode( Chunk &chunk ) const
+{
+  if( !chunk.encoded )
+    return true;
+
+  hsize_t chunk_bytes = elem_size_;
+  for( size_t d=0; d<chunk_dims_.size(); d++ )
+    chunk_bytes *= chunk_dims_[d];
+
+  std::vector<char> out;
+
+  // Undo the filters in the reverse order, skipping the ones that the
+  // writer did not apply to this chunk.
+  for( int i=filters_.size()-1; i>=0; i-- ) {
+    if( chunk.filter_mask & (1u << i) )
+      continue;
+
+    if( filters_[i] == H5Z_FILTER_DEFLATE ) {
+      out.resize( chunk_bytes );
+      uLongf length = chunk_bytes;
+      if( uncompress( reinterpret_cast<Bytef*>( &out[0] ), &length,
+                      reinterpret_cast<const Bytef*>( &chunk.buffer[0] ),
+                      chunk.buffer.size() ) != Z_OK )
+        return false;
+      out.resize( length );
+    } else {
+      unshuffle( chunk.buffer, out, elem_size_ );
+    }
+
+    chunk.buffer.swap( out );
+  }
+
+  return chunk.buffer.size() == chunk_bytes;
+}
+
+} // end namespace SCIRun
+
+#endif  // HAVE_HDF5
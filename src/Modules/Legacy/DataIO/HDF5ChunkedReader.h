@@ -0,0 +1,103 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2015 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+///
+///@file  HDF5ChunkedReader.h
+///
+///@brief Reads hyperslabs of HDF5 datasets chunk by chunk.
+///
+/// The HDF5 library is not thread safe, so chunks are only fetched from
+/// the file serially.  When a chunked dataset is stored with the native
+/// memory type and only deflate and shuffle filters, the raw chunks are
+/// inflated and unshuffled here on all cores.  Otherwise the library
+/// reads each chunk's part of the selection.  In both cases the values
+/// are scattered straight into the caller's buffer.  Memory use is bounded
+/// by a batch of chunks rather than a second copy of the dataset.
+///
+/// Only the chunks that intersect a selection are touched.  A reader can
+/// therefore be kept open as a lazy view of a large dataset and asked
+/// for one range at a time.  Datasets that are not chunked are walked in
+/// slabs of their slowest dimension.
+///
+
+#ifndef HDF5_CHUNKED_READER_H
+#define HDF5_CHUNKED_READER_H
+
+#include <sci_defs/hdf5_defs.h>
+
+#include <string>
+#include <vector>
+
+#ifdef HAVE_HDF5
+
+#include "hdf5.h"
+
+namespace SCIRun {
+
+class HDF5ChunkedReader {
+public:
+  /// The dataset stays owned by the caller and has to outlive the reader.
+  HDF5ChunkedReader( hid_t ds_id, hid_t mem_type_id );
+
+  bool valid() const { return valid_; }
+  const std::vector<hsize_t>& dims() const { return dims_; }
+  const std::vector<hsize_t>& chunk_dims() const { return chunk_dims_; }
+  /// True when chunks are decoded by the reader instead of the library.
+  bool direct() const { return direct_; }
+
+  /// Reads the elements start + i*stride, i < count, of every dimension
+  /// into data, in row major order with the extents given by count.
+  bool read( const hsize_t *start, const hsize_t *stride,
+             const hsize_t *count, void *data );
+
+  std::string error() const { return error_msg_; }
+
+private:
+  struct Chunk;
+
+  bool fetch( Chunk &chunk, const hsize_t *start, const hsize_t *stride );
+  bool decode( Chunk &chunk ) const;
+
+  hid_t ds_id_;
+  hid_t mem_type_id_;
+  bool valid_;
+  bool direct_;
+  size_t elem_size_;
+  std::vector<hsize_t> dims_;
+  std::vector<hsize_t> chunk_dims_;
+  // Filter ids in the order they were applied when writing.
+  std::vector<H5Z_filter_t> filters_;
+  std::string error_msg_;
+};
+
+} // end namespace SCIRun
+
+#endif  // HAVE_HDF5
+
+#endif  // HDF5_CHUNKED_READER_H
@@ -53,6 +53,7 @@
 
 #ifdef HAVE_HDF5
 #include "hdf5.h"
+#include "HDF5ChunkedReader.h"
 #include "WriteHDF5DumpFile.h"
 #endif
 
@@ -1515,25 +1516,12 @@ NrrdDataHandle ReadHDF5File::readDataset( string filename,
         block[ic]  = 1;
       }
 
-      if( (status = H5Sselect_hyperslab(file_space_id, H5S_SELECT_SET,
-          start, stride, count, block)) < 0 ) {
-        error( "Can not select data slab requested." );
-        delete[] start;
-        delete[] stride;
-        delete[] block;
-        return NULL;
-      }
-
-      hid_t mem_space_id = H5Screate_simple (ndims, count, NULL );
-
-      for( int d=0; d<ndims; d++ ) {
-        start[d] = 0;
-        stride[d] = 1;
-      }
+      // Walk the chunks of the dataset that hold the selection and
+      // decode them in parallel straight into the nrrd's storage.
+      HDF5ChunkedReader reader( ds_id, mem_type_id );
 
-      if( (status = H5Sselect_hyperslab(mem_space_id, H5S_SELECT_SET,
-          start, stride, count, block)) < 0 ) {
-        error( "Can not select memory for the data slab requested." );
+      if( !reader.valid() ) {
+        error( reader.error() );
         delete[] start;
         delete[] stride;
         delete[] block;
@@ -1551,20 +1539,8 @@ NrrdDataHandle ReadHDF5File::readDataset( string filename,
         return NULL;
       }
 
-      if( (status = H5Dread(ds_id, mem_type_id,
-          mem_space_id, file_space_id, H5P_DEFAULT,
-          data)) < 0 ) {
-        error( "Can not read the data slab requested." );
-        delete[] start;
-        delete[] stride;
-        delete[] block;
-        delete[] data;
-        return NULL;
-      }
-
-      /* Terminate access to the data space. */
-      if( (status = H5Sclose(mem_space_id)) < 0 ) {
-        error( "Can not cloase the memory data slab requested." );
+      if( !reader.read( start, stride, count, data ) ) {
+        error( reader.error() );
         delete[] start;
         delete[] stride;
         delete[] block;
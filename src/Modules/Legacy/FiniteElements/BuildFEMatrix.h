@@ -48,6 +48,7 @@ namespace SCIRun {
         {}
 
         void execute() override;
+        OUTPUTS_CACHED_ON_DISK
 
         INPUT_PORT(0, InputField, Field);
         INPUT_PORT(1, Conductivity_Table, Matrix);
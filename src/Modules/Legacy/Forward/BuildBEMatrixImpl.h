@@ -47,7 +47,8 @@ namespace SCIRun {
           const Core::Algorithms::VariableList& bdyConds,
           const Core::Algorithms::VariableList& outside,
           const Core::Algorithms::VariableList& inside,
-          Core::Logging::LegacyLoggerInterface* log);
+          Core::Logging::LegacyLoggerInterface* log,
+          double compressionTolerance = 0.0);
 
         Core::Datatypes::MatrixHandle executeImpl(const FieldList& inputs);
         const std::vector<std::string>& getInputTypes() const { return inputTypes_; }
@@ -57,6 +58,7 @@ namespace SCIRun {
         const Core::Algorithms::VariableList& outside_;
         const Core::Algorithms::VariableList& inside_;
         const Core::Logging::LegacyLoggerInterface* log_;
+        double compressionTolerance_;
         std::vector<std::string> inputTypes_;
       };
 
@@ -75,6 +75,8 @@ void SolveInverseProblemWithTikhonov::setStateDefaults()
 	setStateIntFromAlgo(Parameters::LambdaNum);
 	setStateDoubleFromAlgo(Parameters::LambdaResolution);
 	setStateDoubleFromAlgo(Parameters::LambdaSliderValue);
+	setStateStringFromAlgoOption(Parameters::LambdaSweepFactorization);
+	setStateIntFromAlgo(Parameters::LambdaSweepRank);
 	setStateIntFromAlgo(Parameters::regularizationSolutionSubcase);
 	setStateIntFromAlgo(Parameters::regularizationResidualSubcase);
 }
@@ -106,6 +108,8 @@ void SolveInverseProblemWithTikhonov::execute()
     setAlgoIntFromState(Parameters::LambdaNum);
     setAlgoDoubleFromState(Parameters::LambdaResolution);
     setAlgoDoubleFromState(Parameters::LambdaSliderValue);
+    setAlgoOptionFromState(Parameters::LambdaSweepFactorization);
+    setAlgoIntFromState(Parameters::LambdaSweepRank);
     setAlgoIntFromState(Parameters::regularizationSolutionSubcase);
     setAlgoIntFromState(Parameters::regularizationResidualSubcase);
 
@@ -79,6 +79,8 @@ void SolveInverseProblemWithTikhonovSVD::setStateDefaults()
 	setStateIntFromAlgo(Parameters::LambdaNum);
 	setStateDoubleFromAlgo(Parameters::LambdaResolution);
 	setStateDoubleFromAlgo(Parameters::LambdaSliderValue);
+	setStateStringFromAlgoOption(Parameters::LambdaSweepFactorization);
+	setStateIntFromAlgo(Parameters::LambdaSweepRank);
 }
 
 // execute function
@@ -112,6 +114,8 @@ void SolveInverseProblemWithTikhonovSVD::execute()
 		setAlgoIntFromState(Parameters::LambdaNum);
 		setAlgoDoubleFromState(Parameters::LambdaResolution);
 		setAlgoDoubleFromState(Parameters::LambdaSliderValue);
+		setAlgoOptionFromState(Parameters::LambdaSweepFactorization);
+		setAlgoIntFromState(Parameters::LambdaSweepRank);
 
 		// run
 		auto output = algo().run(
@@ -37,6 +37,9 @@ DEALINGS IN THE SOFTWARE.
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Tensor.h>
 #include <Graphics/Glyphs/GlyphGeom.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <numeric>
 
 using namespace SCIRun;
 using namespace Modules::Visualization;
@@ -96,17 +99,6 @@ public:
     unsigned int approxDiv,
     const std::string& id);
 
-  void addFaceGeom(
-    const std::vector<Point>  &points,
-    const std::vector<Vector> &normals,
-    bool withNormals,
-    uint32_t& iboBufferIndex,
-    spire::VarBuffer* iboBuffer,
-    spire::VarBuffer* vboBuffer,
-    ColorScheme colorScheme,
-    const std::vector<ColorRGB> &face_colors,
-    const RenderState& state);
-
   void renderEdges(
     FieldHandle field,
     boost::optional<ColorMapHandle> colorMap,
@@ -124,6 +116,28 @@ private:
   float nodeTransparencyValue_ = 0.65f;
   std::string moduleId_;
   ModuleStateHandle state_;
+
+  /// Face geometry of the previous execution. When the same mesh comes back
+  /// with the same normal settings, only the colors need recomputing: the
+  /// positions and normals are copied out of the old VBO and the index
+  /// buffer is shared as is. The cache is keyed on the mesh generation, which
+  /// every new or copied mesh gets fresh, and is dropped as soon as another
+  /// mesh comes in or the faces are hidden.
+  struct FaceGeometryCache
+  {
+    int meshGeneration = -1;
+    size_t numFaces = 0;
+    size_t grain = 0;
+    bool withNormals = false;
+    bool invertNormals = false;
+    bool useFaceNormals = false;
+    std::vector<size_t> vertexStart;
+    std::vector<size_t> indexStart;
+    std::shared_ptr<spire::VarBuffer> vbo;
+    size_t vertexFloats = 0;
+    std::shared_ptr<spire::VarBuffer> ibo;
+  };
+  FaceGeometryCache faceCache_;
 };
 }}}}
 
@@ -378,6 +392,10 @@ GeometryHandle GeometryBuilder::buildGeometryObject(
   if (showEdges && dim < 1) { showEdges = false; }
   if (showFaces && dim < 2) { showFaces = false; }
 
+  // Release the buffers of the previous mesh before building new ones
+  if (!showFaces || faceCache_.meshGeneration != field->vmesh()->generation())
+    faceCache_ = FaceGeometryCache();
+
   if (showNodes)
   {
     // Construct node geometry.
@@ -430,6 +448,89 @@ void GeometryBuilder::renderFaces(
 }
 
 
+namespace
+{
+  /// Where the colors of a rendered face come from.
+  enum class FaceColorSource
+  {
+    NONE,   ///< Default color, no color attribute.
+    CELLS,  ///< Cell data: one color per side of the face.
+    FACES,  ///< Face data: one color for the whole face.
+    NODES   ///< Node data: one color per corner.
+  };
+
+  /// Maps the field value at \p idx through the colormap, whatever the value type.
+  template <class INDEX>
+  ColorRGB mapFieldValue(VField* fld, const ColorMap& map, INDEX idx)
+  {
+    if (fld->is_scalar())
+    {
+      double sval;
+      fld->get_value(sval, idx);
+      return map.valueToColor(sval);
+    }
+    if (fld->is_vector())
+    {
+      Vector vval;
+      fld->get_value(vval, idx);
+      return map.valueToColor(vval);
+    }
+    if (fld->is_tensor())
+    {
+      Tensor tval;
+      fld->get_value(tval, idx);
+      return map.valueToColor(tval);
+    }
+    return ColorRGB(1., 1., 1.);
+  }
+
+  /// Quads are drawn as two triangles sharing their 4 vertices, every other
+  /// face as a fan with 3 vertices per triangle.
+  inline size_t faceVertexCount(size_t numNodes)
+  {
+    return numNodes == 4 ? 4 : (numNodes >= 3 ? 3 * (numNodes - 2) : 0);
+  }
+
+  inline size_t faceIndexCount(size_t numNodes)
+  {
+    return numNodes == 4 ? 6 : (numNodes >= 3 ? 3 * (numNodes - 2) : 0);
+  }
+
+  inline float* writeVertexPoint(float* out, const Point& p)
+  {
+    out[0] = static_cast<float>(p.x());
+    out[1] = static_cast<float>(p.y());
+    out[2] = static_cast<float>(p.z());
+    return out + 3;
+  }
+
+  inline float* writeVertexNormal(float* out, const Vector& n)
+  {
+    out[0] = static_cast<float>(n.x());
+    out[1] = static_cast<float>(n.y());
+    out[2] = static_cast<float>(n.z());
+    return out + 3;
+  }
+
+  inline float* writeVertexColor(float* out, const ColorRGB& c)
+  {
+    out[0] = static_cast<float>(c.r());
+    out[1] = static_cast<float>(c.g());
+    out[2] = static_cast<float>(c.b());
+    out[3] = 1.f;
+    return out + 4;
+  }
+
+  /// Nodes and edges are gathered this many at a time, so the scratch arrays
+  /// stay small however large the mesh is.
+  const size_t renderBlockSize = 1 << 16;
+}
+
+// Faces are built in two passes over chunks of faces: the first pass counts
+// the vertices and indices every chunk produces (this is a closed formula for
+// meshes with a fixed face size), the second one writes each chunk's part of
+// the VBO and IBO in place, in parallel. The output is laid out exactly as if
+// the faces had been written one after another.
 void GeometryBuilder::renderFacesLinear(
   FieldHandle field,
   boost::optional<boost::shared_ptr<ColorMap>> colorMap,
@@ -455,11 +556,8 @@ void GeometryBuilder::renderFacesLinear(
   if (withNormals) { mesh->synchronize(Mesh::NORMALS_E); }
 
   bool invertNormals = state_->getValue(ShowField::FaceInvertNormals).toBool();
+  bool useFaceNormals = withNormals && state.get(RenderState::USE_FACE_NORMALS) && mesh->has_normals();
   ColorScheme colorScheme = ColorScheme::COLOR_UNIFORM;
-  std::vector<double> svals;
-  std::vector<Vector> vvals;
-  std::vector<Tensor> tvals;
-  std::vector<ColorRGB> face_colors;
 
   if (fld->basis_order() < 0 || state.get(RenderState::USE_DEFAULT_COLOR))
   {
@@ -474,255 +572,288 @@ void GeometryBuilder::renderFacesLinear(
     colorScheme = ColorScheme::COLOR_IN_SITU;
   }
 
-  // Three 32 bit ints to index into the VBO
-  uint32_t iboSize = static_cast<uint32_t>(mesh->num_faces() * sizeof(uint32_t) * 3);
-  //Seven floats per VBO: Pos (3) XYZ, and Color (4) RGBA
-  uint32_t vboSize = static_cast<uint32_t>(mesh->num_faces() * sizeof(float) * 7);
-
-  // Construct VBO and IBO that will be used to render the faces. Once again,
-  // IBOs are not strictly needed. But, we may be able to optimize this code
-  // somewhat.
-  /// \todo Switch to unique_ptrs and move semantics.
-  std::shared_ptr<spire::VarBuffer> iboBufferSPtr(
-    new spire::VarBuffer(vboSize));
-  std::shared_ptr<spire::VarBuffer> vboBufferSPtr(
-    new spire::VarBuffer(iboSize));
+  // Faces we have no colors for are drawn with the default color.
+  FaceColorSource colorSource = FaceColorSource::NONE;
+  ColorMap* map = 0;
+  if (colorScheme != ColorScheme::COLOR_UNIFORM && colorMap && *colorMap)
+  {
+    map = colorMap->get();
+    if (fld->basis_order() == 0 && mesh->dimensionality() == 3)
+      colorSource = FaceColorSource::CELLS;
+    else if (fld->basis_order() == 0 && mesh->dimensionality() == 2)
+      colorSource = FaceColorSource::FACES;
+    else if (fld->basis_order() == 1)
+      colorSource = FaceColorSource::NODES;
+  }
+  if (colorSource == FaceColorSource::NONE)
+    colorScheme = ColorScheme::COLOR_UNIFORM;
 
-  // Accessing the pointers like this is contrived. We only do this for
-  // speed since we will be using the pointers in a tight inner loop.
-  auto iboBuffer = iboBufferSPtr.get();
-  auto vboBuffer = vboBufferSPtr.get();
+  // Element data (Cells) so two sided faces.
+  const bool doubleSided = colorSource == FaceColorSource::CELLS;
+  if (doubleSided)
+    state.set(RenderState::IS_DOUBLE_SIDED, true);
 
-  uint32_t iboIndex = 0;
-  int64_t numVBOElements = 0;
+  // Vertex layout: Pos (3) XYZ, [Normal (3)], [Color (4) RGBA, [Secondary color (4)]]
+  const size_t geomFloats = withNormals ? 6 : 3;
+  const size_t colorFloats = colorSource == FaceColorSource::NONE ? 0 : (doubleSided ? 8 : 4);
+  const size_t vertexFloats = geomFloats + colorFloats;
 
-  VMesh::Face::iterator fiter, fiterEnd;
-  VMesh::Node::array_type nodes;
+  const size_t faceCount = static_cast<size_t>(numFaces);
+  const size_t grain = std::max<size_t>(1024, faceCount / (Parallel::NumCores() * 8));
+  const size_t numChunks = (faceCount + grain - 1) / grain;
 
-  mesh->begin(fiter);
-  mesh->end(fiterEnd);
+  const bool reuseGeometry = faceCache_.vbo && faceCache_.ibo &&
+    faceCache_.meshGeneration == mesh->generation() &&
+    faceCache_.numFaces == faceCount && faceCache_.grain == grain &&
+    faceCache_.withNormals == withNormals &&
+    faceCache_.invertNormals == invertNormals &&
+    faceCache_.useFaceNormals == useFaceNormals;
 
-  Point idpt;
-  mesh->get_nodes(nodes, *fiter);
-  mesh->get_point(idpt, nodes[0]);
+  // First vertex and first index of every chunk.
+  std::vector<size_t> vertexStart(numChunks + 1, 0);
+  std::vector<size_t> indexStart(numChunks + 1, 0);
 
-  while (fiter != fiterEnd)
+  if (reuseGeometry)
   {
-    interruptible->checkForInterruption();
-
-    mesh->get_nodes(nodes, *fiter);
-
-    std::vector<Point> points(nodes.size());
-    std::vector<Vector> normals(nodes.size());
-
-    for (size_t i = 0; i < nodes.size(); i++)
+    vertexStart = faceCache_.vertexStart;
+    indexStart = faceCache_.indexStart;
+  }
+  else if (!mesh->is_prismvolmesh() && mesh->num_nodes_per_face() >= 3)
+  {
+    const size_t nodesPerFace = mesh->num_nodes_per_face();
+    for (size_t chunk = 0; chunk <= numChunks; ++chunk)
     {
-      mesh->get_point(points[i], nodes[i]);
+      const size_t facesBefore = std::min(chunk * grain, faceCount);
+      vertexStart[chunk] = facesBefore * faceVertexCount(nodesPerFace);
+      indexStart[chunk] = facesBefore * faceIndexCount(nodesPerFace);
     }
-
-    //TODO fix so the withNormals tp be woth lighting is called correctly, and the meshes are fixed.
-    if (withNormals)
+  }
+  else
+  {
+    // Mixed face sizes: count per chunk, then turn the counts into offsets.
+    Parallel::ForRange(0, faceCount, [&](size_t begin, size_t end)
     {
-      bool useFaceNormals = state.get(RenderState::USE_FACE_NORMALS) && mesh->has_normals();
-      if (useFaceNormals)
+      VMesh::Node::array_type nodes;
+      size_t numVertices = 0, numIndices = 0;
+      for (size_t f = begin; f < end; ++f)
       {
-        for (size_t i = 0; i < nodes.size(); i++)
-        {
-          auto norm = normals[i];
-          normals[i] = invertNormals ? -norm : norm;
-          mesh->get_normal(normals[i], nodes[i]);
-        }
+        mesh->get_nodes(nodes, VMesh::Face::index_type(static_cast<VMesh::index_type>(f)));
+        numVertices += faceVertexCount(nodes.size());
+        numIndices += faceIndexCount(nodes.size());
       }
-      else
-      {
-        /// Fix normal of Quads
-        if (points.size() == 4)
-        {
-          Vector edge1 = points[1] - points[0];
-          Vector edge2 = points[2] - points[1];
-          Vector edge3 = points[3] - points[2];
-          Vector edge4 = points[0] - points[3];
+      vertexStart[begin / grain + 1] = numVertices;
+      indexStart[begin / grain + 1] = numIndices;
+    }, grain);
 
-          Vector norm = Cross(edge1, edge2) + Cross(edge2, edge3) + Cross(edge3, edge4) + Cross(edge4, edge1);
+    std::partial_sum(vertexStart.begin(), vertexStart.end(), vertexStart.begin());
+    std::partial_sum(indexStart.begin(), indexStart.end(), indexStart.begin());
+  }
 
-          norm.normalize();
+  interruptible->checkForInterruption();
 
-          for (size_t i = 0; i < nodes.size(); i++)
-          {
-            normals[i] = invertNormals ? -norm : norm;
-          }
-        }
-        /// Fix Normals of Tris
-        else
-        {
-          Vector edge1 = points[1] - points[0];
-          Vector edge2 = points[2] - points[1];
-          Vector norm = Cross(edge1, edge2);
+  const size_t vboBytes = vertexStart[numChunks] * vertexFloats * sizeof(float);
+  const size_t iboBytes = indexStart[numChunks] * sizeof(uint32_t);
 
-          norm.normalize();
+  // Construct VBO and IBO that will be used to render the faces. Both are
+  // reserved up front and filled in place by the chunks below.
+  std::shared_ptr<spire::VarBuffer> vboBufferSPtr(
+    new spire::VarBuffer(static_cast<uint32_t>(vboBytes)));
+  float* vertices = reinterpret_cast<float*>(vboBufferSPtr->reserveBytes(vboBytes));
 
-          for (size_t i = 0; i < nodes.size(); i++)
-          {
-            normals[i] = invertNormals ? -norm : norm;
-          }
-          //For future reference for a try at smoother rendering
-          /*
-          for (size_t i = 0; i < nodes.size(); i++)
-          {
-          mesh->get_normal(normals[i], nodes[i]);
-          }
-          */
-        }
-      }
-    }
-    // Default color single face no matter the element data.
-    if (colorScheme == ColorScheme::COLOR_UNIFORM)
-    {
-      addFaceGeom(points, normals, withNormals, iboIndex, iboBuffer, vboBuffer,
-        colorScheme, face_colors, state);
-    }
-    // Element data (Cells) so two sided faces.
-    else if (fld->basis_order() == 0 && mesh->dimensionality() == 3)
-    {
-      auto map = colorMap.get();
-      //two possible colors.
-      svals.resize(2);
-      vvals.resize(2);
-      tvals.resize(2);
-      face_colors = {{ColorRGB(1.,1.,1.),ColorRGB(1.,1.,1.)}};
+  std::shared_ptr<spire::VarBuffer> iboBufferSPtr;
+  uint32_t* indices = 0;
+  if (reuseGeometry)
+  {
+    iboBufferSPtr = faceCache_.ibo;
+  }
+  else
+  {
+    faceCache_.ibo.reset();
+    iboBufferSPtr.reset(new spire::VarBuffer(static_cast<uint32_t>(iboBytes)));
+    indices = reinterpret_cast<uint32_t*>(iboBufferSPtr->reserveBytes(iboBytes));
+  }
 
-      VMesh::Elem::array_type cells;
-      mesh->get_elems(cells, *fiter);
+  const float* cachedVertices = reuseGeometry ?
+    reinterpret_cast<const float*>(faceCache_.vbo->getBuffer()) : 0;
+  const size_t cachedVertexFloats = faceCache_.vertexFloats;
 
-      if (fld->is_scalar())
-      {
-        fld->get_value(svals[0], cells[0]);
+  Parallel::ForRange(0, faceCount, [&](size_t begin, size_t end)
+  {
+    const size_t chunk = begin / grain;
+    size_t vertexIndex = vertexStart[chunk];
+    float* vertex = vertices + vertexIndex * vertexFloats;
+    uint32_t* index = indices ? indices + indexStart[chunk] : 0;
 
-        if (cells.size() > 1)
-        {
-          fld->get_value(svals[1], cells[1]);
-        }
-        else
-        {
-          svals[1] = svals[0];
-        }
-        face_colors[0] = map->valueToColor(svals[0]);
-        face_colors[1] = map->valueToColor(svals[1]);
-      }
-      else if (fld->is_vector())
+    VMesh::Node::array_type nodes;
+    VMesh::Elem::array_type cells;
+    std::vector<Point> points;
+    std::vector<Vector> normals;
+    std::vector<ColorRGB> nodeColors;
+    ColorRGB faceColors[2];
+
+    // Writes corner k of the current face as the next vertex.
+    auto writeVertex = [&](size_t k)
+    {
+      float* out = vertex;
+      if (reuseGeometry)
       {
-        fld->get_value(vvals[0], cells[0]);
-
-        if (cells.size() > 1)
-        {
-          fld->get_value(vvals[1], cells[1]);
-        }
-        else
-        {
-          svals[1] = svals[0];
-        }
-
-        face_colors[0] = map->valueToColor(vvals[0]);
-        face_colors[1] = map->valueToColor(vvals[1]);
+        std::copy(cachedVertices + vertexIndex * cachedVertexFloats,
+          cachedVertices + vertexIndex * cachedVertexFloats + geomFloats, out);
+        out += geomFloats;
       }
-      else if (fld->is_tensor())
+      else
       {
-        fld->get_value(tvals[0], cells[0]);
-
-        if (cells.size() > 1)
-        {
-          fld->get_value(tvals[1], cells[1]);
-        }
-        else
-        {
-          svals[1] = svals[0];
-        }
+        out = writeVertexPoint(out, points[k]);
+        if (withNormals)
+          out = writeVertexNormal(out, normals[k]);
+      }
 
-        face_colors[0] = map->valueToColor(tvals[0]);
-        face_colors[1] = map->valueToColor(tvals[1]);
+      // Note:  For the double sided case, every corner carries both colors.
+      //        It is a direct translation from old scirun.
+      switch (colorSource)
+      {
+      case FaceColorSource::CELLS:
+        out = writeVertexColor(out, faceColors[0]);
+        writeVertexColor(out, faceColors[1]);
+        break;
+      case FaceColorSource::FACES:
+        writeVertexColor(out, faceColors[0]);
+        break;
+      case FaceColorSource::NODES:
+        writeVertexColor(out, nodeColors[k]);
+        break;
+      case FaceColorSource::NONE:
+        break;
       }
 
-      state.set(RenderState::IS_DOUBLE_SIDED, true);
+      vertex += vertexFloats;
+      ++vertexIndex;
+    };
 
-      addFaceGeom(points, normals, withNormals, iboIndex, iboBuffer, vboBuffer,
-        colorScheme, face_colors, state);
-    }
-    // Element data (faces)
-    else if (fld->basis_order() == 0 && mesh->dimensionality() == 2)
+    for (size_t f = begin; f < end; ++f)
     {
-      auto map = colorMap.get();
-      //one possible color, each node that color.
-      svals.resize(1);
-      vvals.resize(1);
-      tvals.resize(1);
-      face_colors.resize(nodes.size());
-      if (fld->is_scalar())
+      VMesh::Face::index_type face(static_cast<VMesh::index_type>(f));
+      mesh->get_nodes(nodes, face);
+      const size_t numNodes = nodes.size();
+      if (numNodes < 3)
+        continue;
+
+      if (colorSource == FaceColorSource::CELLS)
       {
-        fld->get_value(svals[0], *fiter);
-        face_colors[0] = map->valueToColor(svals[0]);
+        mesh->get_elems(cells, face);
+        faceColors[0] = mapFieldValue(fld, *map, cells[0]);
+        faceColors[1] = cells.size() > 1 ? mapFieldValue(fld, *map, cells[1]) : faceColors[0];
       }
-      else if (fld->is_vector())
+      else if (colorSource == FaceColorSource::FACES)
       {
-        fld->get_value(vvals[0], *fiter);
-        face_colors[0] = map->valueToColor(vvals[0]);
+        faceColors[0] = mapFieldValue(fld, *map, face);
       }
-      else if (fld->is_tensor())
+      else if (colorSource == FaceColorSource::NODES)
       {
-        fld->get_value(tvals[0], *fiter);
-        face_colors[0] = map->valueToColor(tvals[0]);
+        nodeColors.resize(numNodes);
+        for (size_t i = 0; i < numNodes; ++i)
+          nodeColors[i] = mapFieldValue(fld, *map, nodes[i]);
       }
 
-      // Same color at all corners.
-      for (size_t i = 0; i<nodes.size(); ++i)
+      if (!reuseGeometry)
       {
-        face_colors[i] = face_colors[0];
-      }
-
-      addFaceGeom(points, normals, withNormals, iboIndex, iboBuffer, vboBuffer,
-        colorScheme, face_colors,  state);
-    }
+        points.resize(numNodes);
+        for (size_t i = 0; i < numNodes; ++i)
+          mesh->get_point(points[i], nodes[i]);
 
-    // Data at nodes
-    else if (fld->basis_order() == 1)
-    {
-      auto map = colorMap.get();
-      svals.resize(nodes.size());
-      vvals.resize(nodes.size());
-      tvals.resize(nodes.size());
-      face_colors.resize(nodes.size());
-      //node.size() possible colors.
-      if (fld->is_scalar())
-      {
-        for (size_t i = 0; i<nodes.size(); i++)
+        //TODO fix so the withNormals tp be woth lighting is called correctly, and the meshes are fixed.
+        if (withNormals)
         {
-          fld->get_value(svals[i], nodes[i]);
-          face_colors[i] = map->valueToColor(svals[i]);
+          normals.resize(numNodes);
+          if (useFaceNormals)
+          {
+            for (size_t i = 0; i < numNodes; ++i)
+            {
+              mesh->get_normal(normals[i], nodes[i]);
+              if (invertNormals)
+                normals[i] = -normals[i];
+            }
+          }
+          else
+          {
+            Vector norm;
+            /// Fix normal of Quads
+            if (numNodes == 4)
+            {
+              Vector edge1 = points[1] - points[0];
+              Vector edge2 = points[2] - points[1];
+              Vector edge3 = points[3] - points[2];
+              Vector edge4 = points[0] - points[3];
+
+              norm = Cross(edge1, edge2) + Cross(edge2, edge3) + Cross(edge3, edge4) + Cross(edge4, edge1);
+            }
+            /// Fix Normals of Tris
+            else
+            {
+              Vector edge1 = points[1] - points[0];
+              Vector edge2 = points[2] - points[1];
+              norm = Cross(edge1, edge2);
+            }
+
+            norm.normalize();
+            if (invertNormals)
+              norm = -norm;
+            std::fill(normals.begin(), normals.end(), norm);
+          }
         }
       }
-      else if (fld->is_vector())
+
+      const uint32_t first = static_cast<uint32_t>(vertexIndex);
+      if (numNodes == 4)
       {
-        for (size_t i = 0; i<nodes.size(); i++)
+        for (size_t k = 0; k < 4; ++k)
+          writeVertex(k);
+
+        if (index)
         {
-          fld->get_value(vvals[i], nodes[i]);
-          face_colors[i] = map->valueToColor(vvals[i]);
+          *index++ = first;
+          *index++ = first + 1;
+          *index++ = first + 2;
+
+          *index++ = first + 2;
+          *index++ = first + 3;
+          *index++ = first;
         }
       }
-      else if (fld->is_tensor())
+      else
       {
-        for (size_t i = 0; i<nodes.size(); i++)
+        for (size_t i = 2; i < numNodes; ++i)
         {
-          fld->get_value(tvals[i], nodes[i]);
-          face_colors[i] = map->valueToColor(tvals[i]);
+          writeVertex(0);
+          writeVertex(i - 1);
+          writeVertex(i);
         }
-      }
 
-      addFaceGeom(points, normals, withNormals, iboIndex, iboBuffer, vboBuffer,
-        colorScheme, face_colors, state);
+        if (index)
+        {
+          const uint32_t numVertices = static_cast<uint32_t>(faceVertexCount(numNodes));
+          for (uint32_t k = 0; k < numVertices; ++k)
+            *index++ = first + k;
+        }
+      }
     }
+  }, grain);
 
-    ++fiter;
-    ++numVBOElements;
-  }
+  interruptible->checkForInterruption();
+
+  faceCache_.meshGeneration = mesh->generation();
+  faceCache_.numFaces = faceCount;
+  faceCache_.grain = grain;
+  faceCache_.withNormals = withNormals;
+  faceCache_.invertNormals = invertNormals;
+  faceCache_.useFaceNormals = useFaceNormals;
+  faceCache_.vertexStart.swap(vertexStart);
+  faceCache_.indexStart.swap(indexStart);
+  faceCache_.vbo = vboBufferSPtr;
+  faceCache_.vertexFloats = vertexFloats;
+  faceCache_.ibo = iboBufferSPtr;
+
+  int64_t numVBOElements = static_cast<int64_t>(faceCount);
 
   std::stringstream ss;
   ss << invertNormals << static_cast<int>(colorScheme) << faceTransparencyValue_;
@@ -880,328 +1011,6 @@ void GeometryBuilder::renderFacesLinear(
   ///       build up to geometry / tessellation shaders if support is present.
 }
 
-// This function needs to be reorganized.
-// The fact that we are only rendering triangles helps us dramatically and
-// we get rid of the quads renderer pointers. Additionally, we can re-order
-// the triangles in ES and perform different rendering based on the
-// transparency of the triangles.
-void GeometryBuilder::addFaceGeom(
-  const std::vector<Point>  &points,
-  const std::vector<Vector> &normals,
-  bool withNormals,
-  uint32_t& iboIndex,
-  spire::VarBuffer* iboBuffer,
-  spire::VarBuffer* vboBuffer,
-  ColorScheme colorScheme,
-  const std::vector<ColorRGB> &face_colors,
-  const RenderState& state)
-{
-  auto writeVBOPoint = [&vboBuffer](const Point& point)
-  {
-    vboBuffer->write(static_cast<float>(point.x()));
-    vboBuffer->write(static_cast<float>(point.y()));
-    vboBuffer->write(static_cast<float>(point.z()));
-  };
-
-  auto writeVBONormal = [&vboBuffer](const Vector& normal)
-  {
-    vboBuffer->write(static_cast<float>(normal.x()));
-    vboBuffer->write(static_cast<float>(normal.y()));
-    vboBuffer->write(static_cast<float>(normal.z()));
-  };
-
-  auto writeVBOColorValue = [&vboBuffer](ColorRGB value)
-  {
-    vboBuffer->write(static_cast<float>(value.r()));
-    vboBuffer->write(static_cast<float>(value.g()));
-    vboBuffer->write(static_cast<float>(value.b()));
-    vboBuffer->write(static_cast<float>(1.f));
-  };
-
-  auto writeIBOIndex = [&iboBuffer](uint32_t index)
-  {
-    iboBuffer->write(index);
-  };
-
-  bool doubleSided = state.get(RenderState::IS_DOUBLE_SIDED);
-
-  if (colorScheme == ColorScheme::COLOR_UNIFORM)
-  {
-    if (points.size() == 4)
-    {
-      if (withNormals)
-      {
-        writeVBOPoint(points[0]);
-        writeVBONormal(normals[0]);
-
-        writeVBOPoint(points[1]);
-        writeVBONormal(normals[1]);
-
-        writeVBOPoint(points[2]);
-        writeVBONormal(normals[2]);
-
-        writeVBOPoint(points[3]);
-        writeVBONormal(normals[3]);
-      }
-      else
-      {
-        writeVBOPoint(points[0]);
-        writeVBOPoint(points[1]);
-        writeVBOPoint(points[2]);
-        writeVBOPoint(points[3]);
-      }
-      writeIBOIndex(iboIndex);
-      writeIBOIndex(iboIndex + 1);
-      writeIBOIndex(iboIndex + 2);
-
-      writeIBOIndex(iboIndex + 2);
-      writeIBOIndex(iboIndex + 3);
-      writeIBOIndex(iboIndex + 0);
-
-      iboIndex += 4;
-    }
-    else
-    {
-      for (size_t i = 2; i < points.size(); i++)
-      {
-        if (withNormals)
-        {
-          // Render points if we are not rendering spheres.
-          writeVBOPoint(points[0]);
-          writeVBONormal(normals[0]);
-          writeIBOIndex(iboIndex);
-
-          writeVBOPoint(points[i - 1]);
-          writeVBONormal(normals[i - 1]);
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-          writeVBONormal(normals[i]);
-          writeIBOIndex(iboIndex + i);
-        }
-        else
-        {
-          writeVBOPoint(points[0]);
-          writeIBOIndex(iboIndex);
-
-          writeVBOPoint(points[i - 1]);
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-          writeIBOIndex(iboIndex + i);
-        }
-      }
-      iboIndex += points.size();
-    }
-  }
-  else if (colorScheme == ColorScheme::COLOR_MAP)
-  {
-    if (points.size() == 4)
-    {
-      // Note:  For the double sided case, the 0 and 1 indices are not a typo.
-      //        It is a direct translation from old scirun.
-      if (withNormals)
-      {
-        writeVBOPoint(points[0]);
-        writeVBONormal(normals[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[1]);
-        writeVBONormal(normals[1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[2]);
-        writeVBONormal(normals[2]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[2]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[3]);
-        writeVBONormal(normals[3]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[3]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-      }
-      else
-      {
-        writeVBOPoint(points[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[2]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[2]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[3]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[3]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-      }
-      writeIBOIndex(iboIndex);
-      writeIBOIndex(iboIndex + 1);
-      writeIBOIndex(iboIndex + 2);
-
-      writeIBOIndex(iboIndex + 2);
-      writeIBOIndex(iboIndex + 3);
-      writeIBOIndex(iboIndex + 0);
-
-      iboIndex += 4;
-    }
-    else
-    {
-      for (size_t i = 2; i < points.size(); i++)
-      {
-        // Note:  For the double sided case, the 0 and 1 indices are not a typo.
-        //        It is a direct translation from old scirun.
-        if (withNormals)
-        {
-          // Render points if we are not rendering spheres.
-          writeVBOPoint(points[0]);
-          writeVBONormal(normals[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex);
-
-          // Apply misc user settings.
-          writeVBOPoint(points[i - 1]);
-          writeVBONormal(normals[i - 1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i-1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-          writeVBONormal(normals[i]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i);
-        }
-        else
-        {
-          // Render points if we are not rendering spheres.
-          writeVBOPoint(points[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex);
-
-          writeVBOPoint(points[i - 1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i-1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i);
-        }
-      }
-      iboIndex += points.size();
-    }
-  }
-  else if (colorScheme == ColorScheme::COLOR_IN_SITU)
-  {
-    if (points.size() == 4)
-    {
-      if (withNormals)
-      {
-        writeVBOPoint(points[0]);
-        writeVBONormal(normals[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[1]);
-        writeVBONormal(normals[1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[2]);
-        writeVBONormal(normals[2]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[2]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[3]);
-        writeVBONormal(normals[3]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[3]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-      }
-      else
-      {
-        writeVBOPoint(points[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        // Add appropriate uniforms to the pass (in this case, uColor).
-        writeVBOPoint(points[1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[2]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[2]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-
-        writeVBOPoint(points[3]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[3]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-      }
-      writeIBOIndex(iboIndex);
-      writeIBOIndex(iboIndex + 1);
-      writeIBOIndex(iboIndex + 2);
-
-      writeIBOIndex(iboIndex + 2);
-      writeIBOIndex(iboIndex + 3);
-      writeIBOIndex(iboIndex + 0);
-
-      iboIndex += 4;
-    }
-    else
-    {
-      for (size_t i = 2; i < points.size(); i++)
-      {
-        if (withNormals)
-        {
-          writeVBOPoint(points[0]);
-          writeVBONormal(normals[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex);
-
-          writeVBOPoint(points[i - 1]);
-          writeVBONormal(normals[i - 1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i - 1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-          writeVBONormal(normals[i]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i);
-        }
-        else
-        {
-          writeVBOPoint(points[0]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[0]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          iboBuffer->write(iboIndex);
-
-          writeVBOPoint(points[i - 1]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i - 1]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i - 1);
-
-          writeVBOPoint(points[i]);
-        if (!doubleSided) { writeVBOColorValue(face_colors[i]); }
-        else              { writeVBOColorValue(face_colors[0]); writeVBOColorValue(face_colors[1]); }
-          writeIBOIndex(iboIndex + i);
-        }
-      }
-      iboIndex += points.size();
-    }
-  }
-}
-
 void GeometryBuilder::renderNodes(
   FieldHandle field,
   boost::optional<boost::shared_ptr<ColorMap>> colorMap,
@@ -1214,12 +1023,7 @@ void GeometryBuilder::renderNodes(
   VField* fld = field->vfield();
   VMesh*  mesh = field->vmesh();
 
-  double sval;
-  Vector vval;
-  Tensor tval;
-
   ColorScheme colorScheme;
-  ColorRGB node_color;
 
   if (fld->basis_order() < 0 || (fld->basis_order() == 0 && mesh->dimensionality() != 0) || state.get(RenderState::USE_DEFAULT_COLOR_NODES))
     colorScheme = ColorScheme::COLOR_UNIFORM;
@@ -1228,11 +1032,16 @@ void GeometryBuilder::renderNodes(
   else
     colorScheme = ColorScheme::COLOR_IN_SITU;
 
-  mesh->synchronize(Mesh::NODES_E);
+  ColorMap* map = 0;
+  if (colorScheme != ColorScheme::COLOR_UNIFORM)
+  {
+    if (colorMap && *colorMap)
+      map = colorMap->get();
+    else
+      colorScheme = ColorScheme::COLOR_UNIFORM;
+  }
 
-  VMesh::Node::iterator eiter, eiter_end;
-  mesh->begin(eiter);
-  mesh->end(eiter_end);
+  mesh->synchronize(Mesh::NODES_E);
 
   double radius = state_->getValue(ShowField::SphereScaleValue).toDouble();
   double num_strips = static_cast<double>(state_->getValue(ShowField::SphereResolution).toInt());
@@ -1250,44 +1059,43 @@ void GeometryBuilder::renderNodes(
   if (state.get(RenderState::USE_SPHERE))
     primIn = SpireIBO::PRIMITIVE::TRIANGLES;
 
+  // Gather positions and colors in parallel one block at a time, then hand
+  // each block to the glyph builder in node order.
+  const size_t numNodes = static_cast<size_t>(mesh->num_nodes());
+  const size_t blockSize = std::min(numNodes, renderBlockSize);
+  std::vector<Point> points(blockSize);
+  std::vector<ColorRGB> colors(blockSize);
+
   GlyphGeom glyphs;
-  while (eiter != eiter_end)
+  for (size_t first = 0; first < numNodes; first += blockSize)
   {
-    interruptible->checkForInterruption();
-
-    Point p;
-    mesh->get_point(p, *eiter);
-    //coloring options
-    if (colorScheme != ColorScheme::COLOR_UNIFORM)
+    const size_t count = std::min(blockSize, numNodes - first);
+    Parallel::ForRange(0, count, [&](size_t begin, size_t end)
     {
-      ColorMapHandle map = colorMap.get();
-      if (fld->is_scalar())
+      for (size_t i = begin; i < end; ++i)
       {
-        fld->get_value(sval, *eiter);
-        node_color = map->valueToColor(sval);
+        VMesh::Node::index_type node(static_cast<VMesh::index_type>(first + i));
+        mesh->get_point(points[i], node);
+        //coloring options
+        if (map)
+          colors[i] = mapFieldValue(fld, *map, node);
       }
-      else if (fld->is_vector())
+    });
+
+    interruptible->checkForInterruption();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      //accumulate VBO or IBO data
+      if (state.get(RenderState::USE_SPHERE))
       {
-        fld->get_value(vval, *eiter);
-        node_color = map->valueToColor(vval);
+        glyphs.addSphere(points[i], radius, num_strips, colors[i]);
       }
-      else if (fld->is_tensor())
+      else
       {
-        fld->get_value(tval, *eiter);
-        node_color = map->valueToColor(tval);
+        glyphs.addPoint(points[i], colors[i]);
       }
     }
-    //accumulate VBO or IBO data
-    if (state.get(RenderState::USE_SPHERE))
-    {
-      glyphs.addSphere(p, radius, num_strips, node_color);
-    }
-    else
-    {
-      glyphs.addPoint(p, node_color);
-    }
-
-    ++eiter;
   }
 
   glyphs.buildObject(*geom, uniqueNodeID, state.get(RenderState::USE_TRANSPARENT_NODES), nodeTransparencyValue_,
@@ -1306,12 +1114,7 @@ void GeometryBuilder::renderEdges(
   VField* fld = field->vfield();
   VMesh*  mesh = field->vmesh();
 
-  double sval0, sval1;
-  Vector vval0, vval1;
-  Tensor tval0, tval1;
-
   ColorScheme colorScheme;
-  ColorRGB edge_colors[2];
 
   if (fld->basis_order() < 0 ||
     (fld->basis_order() == 0 && mesh->dimensionality() != 0) ||
@@ -1322,11 +1125,16 @@ void GeometryBuilder::renderEdges(
   else
     colorScheme = ColorScheme::COLOR_IN_SITU;
 
-  mesh->synchronize(Mesh::EDGES_E);
+  ColorMap* map = 0;
+  if (colorScheme != ColorScheme::COLOR_UNIFORM)
+  {
+    if (colorMap && *colorMap)
+      map = colorMap->get();
+    else
+      colorScheme = ColorScheme::COLOR_UNIFORM;
+  }
 
-  VMesh::Edge::iterator eiter, eiter_end;
-  mesh->begin(eiter);
-  mesh->end(eiter_end);
+  mesh->synchronize(Mesh::EDGES_E);
 
   double num_strips = static_cast<double>(state_->getValue(ShowField::CylinderResolution).toInt());
   double radius = state_->getValue(ShowField::CylinderRadius).toDouble();
@@ -1343,87 +1151,64 @@ void GeometryBuilder::renderEdges(
   if (state.get(RenderState::USE_CYLINDER))
     primIn = SpireIBO::PRIMITIVE::TRIANGLES;
 
+  // Gather end points and colors in parallel one block at a time, two
+  // entries per edge, then hand each block to the glyph builder in edge order.
+  const size_t numEdges = static_cast<size_t>(mesh->num_edges());
+  const size_t blockSize = std::min(numEdges, renderBlockSize);
+  std::vector<Point> points(2 * blockSize);
+  std::vector<ColorRGB> colors(2 * blockSize);
+  const bool nodeData = fld->basis_order() == 1;
+
   GlyphGeom glyphs;
-  while (eiter != eiter_end)
+  for (size_t first = 0; first < numEdges; first += blockSize)
   {
-    interruptible->checkForInterruption();
-
-    VMesh::Node::array_type nodes;
-    mesh->get_nodes(nodes, *eiter);
-
-    Point p0, p1;
-    mesh->get_point(p0, nodes[0]);
-    mesh->get_point(p1, nodes[1]);
-    //coloring options
-    if (colorScheme != ColorScheme::COLOR_UNIFORM)
+    const size_t count = std::min(blockSize, numEdges - first);
+    Parallel::ForRange(0, count, [&](size_t begin, size_t end)
     {
-      ColorMapHandle map = colorMap.get();
-      if (fld->is_scalar())
+      VMesh::Node::array_type nodes;
+      for (size_t i = begin; i < end; ++i)
       {
-        if (fld->basis_order() == 1)
-        {
-          fld->get_value(sval0, nodes[0]);
-          fld->get_value(sval1, nodes[1]);
-        }
-        else //if (mesh->dimensionality() == 1)
+        VMesh::Edge::index_type edge(static_cast<VMesh::index_type>(first + i));
+        mesh->get_nodes(nodes, edge);
+        mesh->get_point(points[2 * i], nodes[0]);
+        mesh->get_point(points[2 * i + 1], nodes[1]);
+        //coloring options
+        if (map)
         {
-          fld->get_value(sval0, *eiter);
-
-          sval1 = sval0;
+          if (nodeData)
+          {
+            colors[2 * i] = mapFieldValue(fld, *map, nodes[0]);
+            colors[2 * i + 1] = mapFieldValue(fld, *map, nodes[1]);
+          }
+          else //if (mesh->dimensionality() == 1)
+          {
+            colors[2 * i] = colors[2 * i + 1] = mapFieldValue(fld, *map, edge);
+          }
         }
-        edge_colors[0] = map->valueToColor(sval0);
-        edge_colors[1] = map->valueToColor(sval1);
       }
-      else if (fld->is_vector())
-      {
-        if (fld->basis_order() == 1)
-        {
-          fld->get_value(vval0, nodes[0]);
-          fld->get_value(vval1, nodes[1]);
-        }
-        else //if (mesh->dimensionality() == 1)
-        {
-          fld->get_value(vval0, *eiter);
-          vval1 = vval0;
-        }
+    });
 
-        edge_colors[0] = map->valueToColor(vval0);
-        edge_colors[1] = map->valueToColor(vval1);
-      }
-      else if (fld->is_tensor())
+    interruptible->checkForInterruption();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      const Point& p0 = points[2 * i];
+      const Point& p1 = points[2 * i + 1];
+      //accumulate VBO or IBO data
+      if (p0 != p1)
       {
-        if (fld->basis_order() == 1)
+        if (state.get(RenderState::USE_CYLINDER))
         {
-          fld->get_value(tval0, nodes[0]);
-          fld->get_value(tval1, nodes[1]);
+          glyphs.addCylinder(p0, p1, radius, num_strips, colors[2 * i], colors[2 * i + 1]);
+          glyphs.addSphere(p0, radius, num_strips, colors[2 * i]);
+          glyphs.addSphere(p1, radius, num_strips, colors[2 * i + 1]);
         }
-        else //if (mesh->dimensionality() == 1)
+        else
         {
-          fld->get_value(tval0, *eiter);
-          tval1 = tval0;
+          glyphs.addLine(p0, p1, colors[2 * i], colors[2 * i + 1]);
         }
-
-        edge_colors[0] = map->valueToColor(tval0);
-        edge_colors[1] = map->valueToColor(tval1);
       }
     }
-    //accumulate VBO or IBO data
-
-    if (p0 != p1)
-    {
-      if (state.get(RenderState::USE_CYLINDER))
-      {
-        glyphs.addCylinder(p0, p1, radius, num_strips, edge_colors[0], edge_colors[1]);
-        glyphs.addSphere(p0, radius, num_strips, edge_colors[0]);
-        glyphs.addSphere(p1, radius, num_strips, edge_colors[1]);
-      }
-      else
-      {
-        glyphs.addLine(p0, p1, edge_colors[0], edge_colors[1]);
-      }
-    }
-
-    ++eiter;
   }
 
   glyphs.buildObject(*geom, uniqueNodeID, state.get(RenderState::USE_TRANSPARENT_EDGES), edgeTransparencyValue_,
@@ -29,10 +29,12 @@
 #include <Testing/ModuleTestBase/ModuleTestBase.h>
 #include <Modules/Visualization/ShowField.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Utils/Exception.h>
 #include <Core/Logging/Log.h>
 #include <Core/Datatypes/ColorMap.h>
+#include <Graphics/Datatypes/GeometryImpl.h>
 
 using namespace SCIRun::Testing;
 using namespace SCIRun::TestUtils;
@@ -44,6 +46,7 @@ using namespace SCIRun::Modules::Visualization;
 using namespace SCIRun::Core;
 using namespace SCIRun;
 using namespace SCIRun::Core::Logging;
+using namespace SCIRun::Graphics::Datatypes;
 using ::testing::Values;
 using ::testing::Combine;
 using ::testing::Range;
@@ -128,3 +131,71 @@ TEST_F(ShowFieldStateGeometryNameSynchronizationTest, GeometryNameSynchronizesWi
   EXPECT_NE(hash1, addInputShouldBeDifferent);
   EXPECT_NE(inputChangeShouldBeDifferent, hash1);
 }
+
+class ShowFieldFaceGeometryTest : public ModuleTest
+{
+protected:
+  virtual void SetUp()
+  {
+    LogSettings::Instance().setVerbose(false);
+    showField = makeModule("ShowField");
+    showField->setStateDefaults();
+    latVol = CreateEmptyLatVol(5, 5, 5);
+    stubPortNWithThisData(showField, 0, latVol);
+  }
+
+  const SpireVBO* faceVBO(GeometryHandle geom) const
+  {
+    for (const auto& vbo : geom->vbos())
+      if (vbo.name.find("face") != std::string::npos)
+        return &vbo;
+    return nullptr;
+  }
+
+  const SpireIBO* faceIBO(GeometryHandle geom) const
+  {
+    for (const auto& ibo : geom->ibos())
+      if (ibo.name.find("face") != std::string::npos)
+        return &ibo;
+    return nullptr;
+  }
+
+  UseRealModuleStateFactory f;
+  ModuleHandle showField;
+  FieldHandle latVol;
+};
+
+TEST_F(ShowFieldFaceGeometryTest, RecoloringTheSameMeshReusesFaceGeometry)
+{
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create("Rainbow"));
+  showField->execute();
+  auto geom1 = boost::dynamic_pointer_cast<GeometryObjectSpire>(getDataOnThisOutputPort(showField, 0));
+  ASSERT_TRUE(geom1 != nullptr);
+
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create("Grayscale"));
+  showField->execute();
+  auto geom2 = boost::dynamic_pointer_cast<GeometryObjectSpire>(getDataOnThisOutputPort(showField, 0));
+  ASSERT_TRUE(geom2 != nullptr);
+
+  auto vbo1 = faceVBO(geom1), vbo2 = faceVBO(geom2);
+  auto ibo1 = faceIBO(geom1), ibo2 = faceIBO(geom2);
+  ASSERT_TRUE(vbo1 && vbo2 && ibo1 && ibo2);
+
+  // LatVol faces are quads: 4 vertices of Pos (3) and Color (4), 6 indices.
+  const size_t numFaces = latVol->vmesh()->num_faces();
+  const size_t vertexFloats = 7;
+  EXPECT_EQ(numFaces, static_cast<size_t>(vbo1->numElements));
+  EXPECT_EQ(numFaces * 4 * vertexFloats * sizeof(float), vbo1->data->getBufferSize());
+  EXPECT_EQ(numFaces * 6 * sizeof(uint32_t), ibo1->data->getBufferSize());
+
+  // Only the colors change: the index buffer is shared and the positions are identical.
+  EXPECT_EQ(ibo1->data, ibo2->data);
+  ASSERT_EQ(vbo1->data->getBufferSize(), vbo2->data->getBufferSize());
+  auto v1 = reinterpret_cast<const float*>(vbo1->data->getBuffer());
+  auto v2 = reinterpret_cast<const float*>(vbo2->data->getBuffer());
+  for (size_t v = 0; v < numFaces * 4; ++v)
+  {
+    for (size_t k = 0; k < 3; ++k)
+      EXPECT_EQ(v1[v * vertexFloats + k], v2[v * vertexFloats + k]);
+  }
+}